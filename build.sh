@@ -23,7 +23,7 @@ export BUILD_PATH="${BASEPATH}/build/"
 usage()
 {
   echo "Usage:"
-  echo "sh build.sh [-j[n]] [-h] [-v] [-s] [-t] [-u] [-c]"
+  echo "sh build.sh [-j[n]] [-h] [-v] [-s] [-t] [-u] [-c] [-p]"
   echo ""
   echo "Options:"
   echo "    -h Print usage"
@@ -32,6 +32,7 @@ usage()
   echo "    -j[n] Set the number of threads used for building GraphEngine, default is 8"
   echo "    -t Build and execute ut"
   echo "    -c Build ut with coverage tag"
+  echo "    -p Build perf benchmark"
   echo "    -v Display build command"
   echo "to be continued ..."
 }
@@ -45,9 +46,10 @@ checkopts()
   ENABLE_GE_UT="off"
   ENABLE_GE_ST="off"
   ENABLE_GE_COV="off"
+  ENABLE_GE_PERF="off"
   GE_ONLY="on"
   # Process the options
-  while getopts 'ustchj:v' opt
+  while getopts 'ustcphj:v' opt
   do
     OPTARG=$(echo ${OPTARG} | tr '[A-Z]' '[a-z]')
     case "${opt}" in
@@ -67,6 +69,10 @@ checkopts()
         ENABLE_GE_COV="on"
         GE_ONLY="off"
         ;;
+      p)
+        ENABLE_GE_PERF="on"
+        GE_ONLY="off"
+        ;;
       h)
         usage
         exit 0
@@ -117,6 +123,10 @@ build_graphengine()
     CMAKE_ARGS="${CMAKE_ARGS} -DENABLE_GE_ST=ON"
   fi
 
+  if [[ "X$ENABLE_GE_PERF" = "Xon" ]]; then
+    CMAKE_ARGS="${CMAKE_ARGS} -DENABLE_GE_PERF=ON"
+  fi
+
   echo "${CMAKE_ARGS}"
   cmake ${CMAKE_ARGS} ../..
   make ${VERBOSE} -j${THREAD_NUM}
@@ -141,6 +151,10 @@ if [[ "X$ENABLE_GE_ST" = "Xon" ]]; then
     cp ${BUILD_PATH}/graphengine/tests/st/st_resnet50_train ${OUTPUT_PATH}
 fi
 
+if [[ "X$ENABLE_GE_PERF" = "Xon" ]]; then
+    cp ${BUILD_PATH}/graphengine/tests/perf/perf_ge_benchmark ${OUTPUT_PATH}
+fi
+
 if [[ "X$ENABLE_GE_UT" = "Xon" || "X$ENABLE_GE_COV" = "Xon" ]]; then
     cp ${BUILD_PATH}/graphengine/tests/ut/common/graph/ut_libgraph ${OUTPUT_PATH}
     cp ${BUILD_PATH}/graphengine/tests/ut/ge/ut_libge_multiparts_utest ${OUTPUT_PATH}
@@ -38,6 +38,23 @@ const char *const GE_AICPU_FLAG = "ge.aicpuFlag";
 const char *const OPTION_EXEC_EXTERN_PLUGIN_PATH = "ge.soLoadPath";
 const char *const OPTION_EXEC_ENABLE_DUMP = "ge.exec.enableDump";
 const char *const OPTION_EXEC_DUMP_PATH = "ge.exec.dumpPath";
+// Configure whether to dump on host with a background writer instead of by aicpu, its value should be "0" or "1",
+// default value is "0"
+const char *const OPTION_EXEC_DUMP_ASYNC = "ge.exec.dumpAsync";
+// Configure to dump every Nth iteration asynchronously, default value is "1"
+const char *const OPTION_EXEC_DUMP_STEP_INTERVAL = "ge.exec.dumpStepInterval";
+// Configure op names or name scopes ending with '/' to dump asynchronously, separated by ',', default value is ""
+// which means all
+const char *const OPTION_EXEC_DUMP_OP_FILTER = "ge.exec.dumpOpFilter";
+// Configure whether to write an iteration only if its float outputs have NaN or Inf, its value should be "0" or "1",
+// default value is "0"
+const char *const OPTION_EXEC_DUMP_ON_NAN_INF = "ge.exec.dumpOnNanInf";
+// Configure host buffers of iterations being dumped, sampled iterations are dropped when all are in use,
+// default value is "2"
+const char *const OPTION_EXEC_DUMP_BUFFER_NUM = "ge.exec.dumpBufferNum";
+// Configure a file to write spans of build stages to as Chrome trace json when GE is finalized, default value is ""
+// which means tracing is disabled
+const char *const OPTION_BUILD_TRACE_FILE = "ge.buildTraceFile";
 // Hccl flag, if ge.exec.hcclFlag =1, it means load plugin for opskernel, else:ge.exec.hcclFlag =0
 const char *const OPTION_EXEC_HCCL_FLAG = "ge.exec.hcclFlag";
 const char *const OPTION_EXEC_ATOMIC_FLAG = "ge.exec.enable_atomic";
@@ -149,6 +166,64 @@ const std::string HCOM_PARALLEL = "ge.hcomParallel";
 // example: GA|RL, support configure multiple, split by |
 const std::string AUTO_TUNE_MODE = "ge.autoTuneMode";
 
+// Configure thread num of shape inference in ComputeGraph::InferShapeInNeed, nodes of the same topological level
+// are inferred concurrently when it is greater than 1,
+// its value should be int32_t type, default value is "1"
+const std::string INFER_SHAPE_THREAD_NUM = "ge.inferShapeThreadNum";
+
+// Configure thread num of task generation, tasks of nodes are generated by kernel stores concurrently
+// when it is greater than 1, and the generated model is the same as generated serially,
+// its value should be int32_t type, default value is "1"
+const std::string TASK_GEN_THREAD_NUM = "ge.taskGenThreadNum";
+
+// Configure op kernel libs whose GenerateTask can be called for different nodes concurrently, only tasks of nodes
+// of these libs are generated in parallel when TASK_GEN_THREAD_NUM is greater than 1,
+// its value should be lib names split by ",", default value is ""
+const std::string TASK_GEN_THREAD_SAFE_LIBS = "ge.taskGenThreadSafeLibs";
+
+// Configure thread num of origin format inference and transop fusion passes, independent regions of graph
+// are processed concurrently when it is greater than 1, and the optimized graph is the same as optimized serially,
+// its value should be int32_t type, default value is "1"
+const std::string FORMAT_PASS_THREAD_NUM = "ge.formatPassThreadNum";
+
+// Configure thread num of host constant folding, constant nodes of the same topological level
+// are evaluated concurrently when it is greater than 1,
+// its value should be int32_t type, default value is "1"
+const std::string CONSTANT_FOLDING_THREAD_NUM = "ge.constantFoldingThreadNum";
+
+// Configure whether to assign logical streams by estimated op costs,
+// its value should be "0" or "1", default value is "0"
+const std::string STREAM_COST_MODEL = "ge.streamCostModel";
+
+// Configure op costs profiled by a previous run for stream cost model, each line is "<op name or op type> <cost>",
+// its value should be file path, default value is ""
+const std::string STREAM_COST_FILE = "ge.streamCostFile";
+
+// Configure whether to cache models of a dynamic shape graph by bucketed input shapes, inputs are padded to their
+// bucket and outputs are sliced back, its value should be "0" or "1", default value is "0"
+const std::string SHAPE_CACHE_FLAG = "ge.shapeCacheFlag";
+
+// Configure shape buckets, example: "0:0:1,8,32;1:1:128,512" rounds dim 0 of input 0 up to 1, 8 or 32,
+// and dim 1 of input 1 up to 128 or 512, default value is "" which means exact shapes
+const std::string SHAPE_BUCKETS = "ge.shapeBuckets";
+
+// Configure output dims which follow padded input dims, example: "0:0:0:0;1:2:1:1" slices dim 0 of output 0 back
+// to dim 0 of input 0, and dim 2 of output 1 back to dim 1 of input 1. Outputs of padded inputs are refused
+// without it, default value is ""
+const std::string SHAPE_CACHE_OUTPUT_DIMS = "ge.shapeCacheOutputDims";
+
+// Configure device memory limit in MB of models cached for one graph, least recently used ones are unloaded,
+// its value should be int32_t type, default value is "0" which means no limit
+const std::string SHAPE_CACHE_MEM_LIMIT = "ge.shapeCacheMemLimit";
+
+// Configure whether to build the next larger bucket in background after a cache miss,
+// its value should be "0" or "1", default value is "0"
+const std::string SHAPE_CACHE_PRECOMPILE = "ge.shapeCachePrecompile";
+
+// Configure whether to allocate nodes, anchors and tensor descs created by a graph build from a pool, which is
+// released together with the graphs, its value should be "0" or "1", default value is "0"
+const std::string GRAPH_ARENA_FLAG = "ge.graphArenaFlag";
+
 // Configure core type "VectorEngine", default value is "AIcoreEngine"
 const std::string CORE_TYPE = "ge.engineType";
 
@@ -44,6 +44,11 @@ inline bool IsLogEnable(int module_name, int log_level) noexcept {
   return false;
 }
 
+namespace ge {
+// Record the stage as a span of build trace if it is enabled, see common/build_tracer.h
+void TraceBuildStage(const char *stage_name, uint64_t start_us, uint64_t end_us);
+}  // namespace ge
+
 #define GE_TIMESTAMP_START(stage) uint64_t startUsec_##stage = ge::GetCurrentTimestap()
 
 #define GE_TIMESTAMP_END(stage, stage_name)                                           \
@@ -51,6 +56,7 @@ inline bool IsLogEnable(int module_name, int log_level) noexcept {
     uint64_t endUsec_##stage = ge::GetCurrentTimestap();                              \
     GEEVENT("[GEPERFTRACE] The time cost of %s is [%lu] micro second.", (stage_name), \
             (endUsec_##stage - startUsec_##stage));                                   \
+    ge::TraceBuildStage((stage_name), startUsec_##stage, endUsec_##stage);            \
   } while (0);
 
 #define GE_TIMESTAMP_CALLNUM_START(stage)                \
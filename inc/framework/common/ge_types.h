@@ -120,6 +120,53 @@ struct ModelInfo {
   uint8_t reserved[3] = {0};  // 3-byte reserved field
 };
 
+// Statistics of a model group, whose models share one feature map memory and run one at a time
+struct ModelGroupInfo {
+  uint32_t model_num = 0;
+  uint64_t feature_map_size = 0;  // Feature map memory shared by all models
+  uint64_t weight_size = 0;       // Weights of all models packed in one memory
+  uint64_t saved_size = 0;        // Memory saved compared with loading the models separately
+  uint64_t run_count = 0;
+  uint64_t run_time_us = 0;  // Total execution time of all runs
+};
+
+// Options of dynamic batching, which coalesces single requests of a multi-batch model into batches
+struct DynamicBatchOptions {
+  std::vector<uint32_t> batch_sizes;  // Batch sizes the model is compiled with
+  uint64_t max_delay_us = 1000;       // Max time a request waits for other requests to form a batch
+  bool has_batch_shape_input = true;  // Whether the last model input takes the batch size, as multi-batch models do
+};
+
+// Statistics of dynamic batching
+struct DynamicBatchStats {
+  uint64_t request_count = 0;
+  uint64_t batch_count = 0;
+  uint64_t padded_count = 0;      // Samples added to fill compiled batch sizes
+  uint64_t zero_copy_count = 0;   // Batches dispatched on request buffers directly
+  uint64_t avg_latency_us = 0;    // Of recent requests, from submission to completion
+  uint64_t p99_latency_us = 0;
+};
+
+// Options of asynchronous dump, which copies outputs of sampled iterations to host and writes files in background
+struct AsyncDumpOptions {
+  bool enable = false;
+  uint64_t step_interval = 1;           // Dump every Nth iteration
+  std::vector<std::string> op_filters;  // Op names, or name scopes ending with '/', empty means all dumped ops
+  bool nan_inf_only = false;            // Write an iteration only if a float output of it has NaN or Inf
+  uint32_t buffer_num = 2;              // Host buffers of iterations, iterations are dropped when all are in use
+};
+
+// Statistics of asynchronous dump
+struct AsyncDumpStats {
+  uint64_t sampled_count = 0;    // Iterations copied to host buffers
+  uint64_t dropped_count = 0;    // Sampled iterations dropped as no host buffer is free
+  uint64_t written_count = 0;    // Iterations written to files
+  uint64_t skipped_count = 0;    // Iterations not written as no NaN or Inf is found
+  uint64_t written_bytes = 0;
+  uint64_t enqueue_time_us = 0;  // Spent in the executing thread
+  uint64_t write_time_us = 0;    // Spent in the writing thread
+};
+
 // Asynchronous callback interface, implemented by the caller
 class ModelListener {
  public:
@@ -19,7 +19,7 @@
 
 #include <memory>
 #include <string>
-#include <memory>
+#include <vector>
 
 #include "common/fmk_types.h"
 #include "common/helper/om_file_helper.h"
@@ -34,6 +34,8 @@ class ModelHelper {
   ~ModelHelper();
 
   Status SaveToOmModel(const GeModelPtr &ge_model, const SaveParam &save_param, const std::string &output_file);
+  // Serialize the model into om_buffer, which is the same as the content of the file saved by SaveToOmModel
+  Status SaveToOmBuffer(const GeModelPtr &ge_model, std::vector<uint8_t> &om_buffer);
   Status SaveOriginalGraphToOmModel(const ge::Graph &graph, const std::string &output_file);
   Status LoadModel(const ge::ModelData &model_data);
 
@@ -63,6 +65,8 @@ class ModelHelper {
   Status ReleaseLocalModelData() noexcept;
   Status SaveModelPartition(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper, ModelPartitionType type,
                             const uint8_t *data, size_t size);
+  Status SaveToOm(const GeModelPtr &ge_model, const SaveParam &save_param, const std::string &output_file,
+                  std::vector<uint8_t> *om_buffer);
 };
 }  // namespace ge
 #endif  // INC_FRAMEWORK_COMMON_HELPER_MODEL_HELPER_H_
@@ -84,6 +84,9 @@ class OmFileSaveHelper {
 
   Status SaveModelToFile(const char *output_file);
 
+  // Save the model in the same layout as SaveModelToFile, into om_buffer instead of a file
+  Status SaveModelToBuffer(std::vector<uint8_t> &om_buffer);
+
   ModelFileHeader model_header_;
   OmFileContext context_;
 };
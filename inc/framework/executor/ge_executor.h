@@ -17,6 +17,7 @@
 #ifndef INC_FRAMEWORK_EXECUTOR_GE_EXECUTOR_H_
 #define INC_FRAMEWORK_EXECUTOR_GE_EXECUTOR_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -147,9 +148,67 @@ class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GeExecutor {
   ///
   ge::Status GetMemAndWeightSize(const void *model_data, size_t model_size, size_t &mem_size, size_t &weight_size);
 
+  ///
+  /// @ingroup ge
+  /// @brief Load models which never run concurrently into one group sharing feature map and weight memory.
+  ///        Models of the group are run by ExecModel one at a time, and are unloaded by UnloadModelGroup.
+  /// @param [in] models: Offline models to load
+  /// @param [in] mem_limit: Max device memory of the group, 0 for no limit except free device memory
+  /// @param [out] group_id: Model group id
+  /// @param [out] model_ids: Ids of loaded models, in the order of models
+  /// @return SUCCESS handle successfully / others handle failed
+  ///
+  ge::Status LoadModelGroup(const std::vector<ge::ModelData> &models, size_t mem_limit, uint32_t &group_id,
+                            std::vector<uint32_t> &model_ids);
+
+  ge::Status UnloadModelGroup(uint32_t group_id);
+
+  ge::Status GetModelGroupInfo(uint32_t group_id, ge::ModelGroupInfo &info);
+
+  ///
+  /// @ingroup ge
+  /// @brief Enable dynamic batching of a multi-batch model, single requests submitted by DynamicBatchInput
+  ///        are coalesced into batches of the compiled batch sizes.
+  /// @param [in] model_id: Model ID
+  /// @param [in] options: Compiled batch sizes and latency budget
+  /// @return SUCCESS handle successfully / others handle failed
+  ///
+  ge::Status EnableDynamicBatch(uint32_t model_id, const ge::DynamicBatchOptions &options);
+
+  ge::Status DisableDynamicBatch(uint32_t model_id);
+
+  ///
+  /// @ingroup ge
+  /// @brief Submit a request of one sample, done is called with the result when its batch finishes.
+  /// @param [in] model_id: Model ID
+  /// @param [in] inputs: Device buffers of one sample, not including the batch shape input
+  /// @param [in] outputs: Device buffers receiving outputs of the sample
+  /// @param [in] done: Callback of the request
+  /// @return SUCCESS handle successfully / others handle failed
+  ///
+  ge::Status DynamicBatchInput(uint32_t model_id, const std::vector<ge::DataBuffer> &inputs,
+                               const std::vector<ge::DataBuffer> &outputs, std::function<void(ge::Status)> done);
+
+  ge::Status GetDynamicBatchStats(uint32_t model_id, ge::DynamicBatchStats &stats);
+
   static ge::Status LoadSingleOp(const std::string &model_name, const ge::ModelData &model_data, void *stream,
                                  SingleOp **single_op);
 
+  ///
+  /// @ingroup ge
+  /// @brief Index an archive built by GeGenerator::BuildSingleOpModels, single ops are loaded from it by key.
+  ///        Archive data must be kept until the archive is unloaded and the single ops are released.
+  /// @param [in] archive_data: Archive buffer
+  /// @param [out] archive_id: Archive id
+  /// @return SUCCESS handle successfully / others handle failed
+  ///
+  static ge::Status LoadSingleOpArchive(const ge::ModelData &archive_data, uint64_t &archive_id);
+
+  static ge::Status LoadSingleOpFromArchive(const std::string &key, uint64_t archive_id, void *stream,
+                                            SingleOp **single_op);
+
+  static ge::Status UnloadSingleOpArchive(uint64_t archive_id);
+
   static ge::Status ExecuteAsync(SingleOp *executor, const std::vector<DataBuffer> &inputs,
                                  std::vector<DataBuffer> &outputs);
 
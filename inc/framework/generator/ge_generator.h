@@ -28,6 +28,15 @@
 #include "graph/op_desc.h"
 
 namespace ge {
+// A single op to build by GeGenerator::BuildSingleOpModels
+struct SingleOpBuildParam {
+  OpDescPtr op_desc;
+  std::vector<GeTensor> inputs;
+  std::vector<GeTensor> outputs;
+  // Name of model file, or key of model in archive
+  std::string model_name;
+};
+
 class GeGenerator {
  public:
   GeGenerator() = default;
@@ -57,6 +66,17 @@ class GeGenerator {
   Status BuildSingleOpModel(OpDescPtr &op_desc, const std::vector<GeTensor> &inputs,
                             const std::vector<GeTensor> &outputs, const std::string &model_file_name);
 
+  ///
+  /// @ingroup ge
+  /// @brief: Build single OPs in Models. OPs of the same signature are built once, and models are serialized
+  ///         and saved concurrently while the next OPs are being built.
+  /// @param [in] params: OPs to build.
+  /// @param [in] archive_file: save all models into one archive keyed by model name if not empty,
+  ///                           otherwise each model is saved to its own file.
+  /// @return SUCCESS or FAILED
+  ///
+  Status BuildSingleOpModels(std::vector<SingleOpBuildParam> &params, const std::string &archive_file = "");
+
  private:
   class Impl;
 
@@ -70,6 +70,7 @@ using ConstAnchor = const Anchor;
 
 class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY Anchor : public std::enable_shared_from_this<Anchor> {
   friend class AnchorUtils;
+  friend class ComputeGraph;
 
  public:
   using TYPE = const char *;
@@ -20,12 +20,15 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <deque>
 #include "detail/attributes_holder.h"
 #include "graph/anchor.h"
+#include "graph/graph_arena.h"
 #include "graph/node.h"
 #include "graph/op_desc.h"
 #include "graph/range_vistor.h"
@@ -55,8 +58,12 @@ using ConstComputeGraph = const ComputeGraph;
 class OperatorImpl;
 using OperatorImplPtr = std::shared_ptr<OperatorImpl>;
 
+struct TopoSortContext;
+
 class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public AttrHolder {
   friend class GraphUtils;
+  friend class Node;
+  friend class OpDesc;
 
  public:
   template <class T>
@@ -80,7 +87,9 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   Vistor<NodePtr> GetInputNodes() const;
   Vistor<NodePtr> GetOutputNodes() const;
 
+  // Direct nodes are looked up in an index, which is rebuilt on lookup after nodes are changed or any op is renamed.
   NodePtr FindNode(const std::string &name) const;
+  NodePtr FindNodeById(int64_t id) const;
   // Add node
   NodePtr AddNode(NodePtr node);
   NodePtr AddNode(OpDescPtr op);
@@ -94,10 +103,17 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   graphStatus RemoveOutputNode(const NodePtr &node);
   graphStatus RemoveConstInput(const NodePtr &node);
 
+  // Nodes and anchors are allocated from arena if it is set, which defaults to GraphArena::Current().
+  void SetArena(const std::shared_ptr<GraphArena> &arena) { arena_ = arena; }
+  const std::shared_ptr<GraphArena> &GetArena() const { return arena_; }
+
   std::shared_ptr<ComputeGraph> AddSubGraph(std::shared_ptr<ComputeGraph> sub_graph);
   graphStatus RemoveSubGraph(const std::shared_ptr<ComputeGraph> &sub_graph);
 
   graphStatus TopologicalSorting();
+  // Re-sort a sorted graph after local edits, every changed edge must have an end in dirty_nodes. Only direct nodes
+  // in the range spanned by edges pointing backwards are moved, other nodes keep their order.
+  graphStatus IncrementalTopologicalSorting(const std::vector<NodePtr> &dirty_nodes);
   bool IsValid() const;
   void Dump() const;
 
@@ -195,14 +211,16 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   ConstProtoAttrMapHelper GetAttrMap() const override;
 
  private:
-  graphStatus DFSTopologicalSorting(std::vector<NodePtr> &node_vec, std::map<NodePtr, uint32_t> &map_in_edge_num,
-                                    std::vector<NodePtr> &stack);
-  graphStatus BFSTopologicalSorting(std::vector<NodePtr> &node_vec, std::map<NodePtr, uint32_t> &map_in_edge_num,
-                                    std::deque<NodePtr> &stack);
-  graphStatus CollectBreadthOutNode(const NodePtr &node, std::map<NodePtr, uint32_t> &map_in_edge_num,
-                                    std::map<string, NodePtr> &breadth_node_map);
-  graphStatus SortNodes(std::vector<NodePtr> &stack, std::map<NodePtr, uint32_t> &mapInEdgeNum);
-  size_t GetInEdgeSize(const NodePtr &node);
+  NodePtr CreateNode(const OpDescPtr &op);
+  void AddNodeIndex(const NodePtr &node);
+  void InvalidateNodeIndex();
+  void RebuildNodeIndex() const;
+  graphStatus InitTopoSortContext(TopoSortContext &context) const;
+  void DFSTopologicalSorting(TopoSortContext &context, std::vector<uint32_t> &stack, std::vector<NodePtr> &node_vec);
+  void BFSTopologicalSorting(TopoSortContext &context, std::vector<uint32_t> &stack_input,
+                             std::vector<NodePtr> &node_vec);
+  graphStatus InferShapeInLevels(const std::vector<NodePtr> &infer_nodes, uint32_t thread_num, size_t &inferred_num);
+  graphStatus SortNodes(const TopoSortContext &context, std::vector<uint32_t> &stack);
   size_t GetOutEdgeSize(const NodePtr &node);
   graphStatus RemoveExtraOutEdge(const NodePtr &node);
   bool GraphMembersAreEqual(const ComputeGraph &r_graph) const;
@@ -216,6 +234,25 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   friend class GraphDebugImp;
   friend class OnnxUtils;
   std::vector<NodePtr> nodes_;
+  // Index of nodes_ by name and id, the first node of a name or id is indexed as a scan finds it. Ids are
+  // reassigned without the graph knowing, so an id entry is checked against its op on lookup. A copied graph
+  // starts with an invalid index.
+  struct NodeIndex {
+    NodeIndex() = default;
+    NodeIndex(const NodeIndex &) {}
+    NodeIndex &operator=(const NodeIndex &) {
+      is_valid = false;
+      names.clear();
+      ids.clear();
+      return *this;
+    }
+    std::mutex mutex;
+    std::unordered_map<std::string, NodePtr> names;
+    std::unordered_map<int64_t, NodePtr> ids;
+    bool is_valid = false;
+    uint64_t name_version = 0;
+  };
+  mutable NodeIndex node_index_;
   std::vector<NodePtr> input_nodes_;
   std::vector<std::shared_ptr<ComputeGraph>> sub_graph_;
   std::string name_;
@@ -236,6 +273,7 @@ class ComputeGraph : public std::enable_shared_from_this<ComputeGraph>, public A
   uint64_t session_id_ = 0;
   uint32_t graph_id_ = 0;
   ge::Format data_format_ = ge::FORMAT_ND;
+  std::shared_ptr<GraphArena> arena_;
 };
 }  // namespace ge
 
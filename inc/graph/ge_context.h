@@ -30,6 +30,9 @@ class GEContext {
   uint64_t TraceId();
   void Init();
   void SetCtxDeviceId(uint32_t device_id);
+  /// Get thread num of origin format inference and format passes configured by option ge.formatPassThreadNum
+  /// @return thread num, 1 if not configured
+  uint32_t FormatPassThreadNum();
 
  private:
   uint64_t session_id_ = 0;
@@ -0,0 +1,177 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef INC_GRAPH_GRAPH_ARENA_H_
+#define INC_GRAPH_GRAPH_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ge {
+#ifdef HOST_VISIBILITY
+#define GE_FUNC_HOST_VISIBILITY __attribute__((visibility("default")))
+#else
+#define GE_FUNC_HOST_VISIBILITY
+#endif
+#ifdef DEV_VISIBILITY
+#define GE_FUNC_DEV_VISIBILITY __attribute__((visibility("default")))
+#else
+#define GE_FUNC_DEV_VISIBILITY
+#endif
+
+///
+/// Pool of small graph objects (nodes, anchors, tensor descs) and their shared_ptr control blocks.
+/// Each thread carves memory from its own chunk without locking. Freed blocks are not reused, chunks are
+/// released together when the arena and every object allocated from it are gone.
+///
+class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GraphArena {
+ public:
+  explicit GraphArena(size_t chunk_size = kDefaultChunkSize);
+  ~GraphArena();
+
+  GraphArena(const GraphArena &) = delete;
+  GraphArena &operator=(const GraphArena &) = delete;
+
+  // nullptr if out of memory
+  void *Allocate(size_t size);
+  void Deallocate(void *ptr, size_t size);
+
+  // Number of Allocate calls
+  uint64_t GetAllocCount() const;
+  // Number of chunks and blocks over the pooled size, which are the only heap allocations
+  uint64_t GetChunkCount() const;
+  size_t GetUsedSize() const;
+
+  // Arena set by GraphArenaScope on the current thread, nullptr if none.
+  static const std::shared_ptr<GraphArena> &Current();
+
+  static const size_t kDefaultChunkSize = 1024 * 1024;
+
+ private:
+  friend class GraphArenaScope;
+  static std::shared_ptr<GraphArena> &MutableCurrent();
+
+  uint8_t *NewChunk();
+
+  // Unique in the process, chunks of threads are looked up by it.
+  uint64_t id_;
+  size_t chunk_size_;
+  // Guards chunks_ only, which is taken once per chunk.
+  mutable std::mutex mutex_;
+  std::vector<uint8_t *> chunks_;
+  std::atomic<uint64_t> alloc_count_;
+  std::atomic<uint64_t> large_count_;
+  std::atomic<size_t> used_size_;
+};
+
+///
+/// Objects created on this thread while the scope is alive come from arena,
+/// including ComputeGraphs, which keep using it for their nodes on any thread.
+///
+class GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY GraphArenaScope {
+ public:
+  explicit GraphArenaScope(const std::shared_ptr<GraphArena> &arena);
+  ~GraphArenaScope();
+
+  GraphArenaScope(const GraphArenaScope &) = delete;
+  GraphArenaScope &operator=(const GraphArenaScope &) = delete;
+
+ private:
+  std::shared_ptr<GraphArena> prev_arena_;
+};
+
+// Every block allocated holds the arena, so that objects may outlive the graph which created them.
+template <typename T>
+class GraphArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit GraphArenaAllocator(const std::shared_ptr<GraphArena> &arena) : arena_(arena) {}
+  template <typename U>
+  GraphArenaAllocator(const GraphArenaAllocator<U> &other) : arena_(other.arena_) {}
+
+  T *allocate(size_t n) {
+    void *ptr = arena_->Allocate(n * sizeof(T));
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(ptr);
+  }
+  void deallocate(T *ptr, size_t n) { arena_->Deallocate(ptr, n * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const GraphArenaAllocator<U> &other) const {
+    return arena_ == other.arena_;
+  }
+  template <typename U>
+  bool operator!=(const GraphArenaAllocator<U> &other) const {
+    return arena_ != other.arena_;
+  }
+
+ private:
+  template <typename U>
+  friend class GraphArenaAllocator;
+  std::shared_ptr<GraphArena> arena_;
+};
+
+// Object and control block in one block of arena, or on heap if arena is nullptr.
+template <typename T, typename... Args>
+std::shared_ptr<T> ArenaMakeShared(const std::shared_ptr<GraphArena> &arena, Args &&... args) {
+  if (arena == nullptr) {
+    return std::shared_ptr<T>(new (std::nothrow) T(std::forward<Args>(args)...));
+  }
+  try {
+    return std::allocate_shared<T>(GraphArenaAllocator<T>(arena), std::forward<Args>(args)...);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+///
+/// For types without public constructors: creator(buffer) constructs the object in buffer with placement new,
+/// or on heap if buffer is nullptr, and the control block is allocated from arena too.
+///
+template <typename T, typename Creator>
+std::shared_ptr<T> ArenaCreate(const std::shared_ptr<GraphArena> &arena, Creator creator) {
+  if (arena == nullptr) {
+    return std::shared_ptr<T>(creator(nullptr));
+  }
+  void *buffer = arena->Allocate(sizeof(T));
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  T *obj = creator(buffer);
+  auto deleter = [arena](T *ptr) {
+    ptr->~T();
+    arena->Deallocate(ptr, sizeof(T));
+  };
+  try {
+    // obj is deleted by deleter if the control block can not be allocated.
+    return std::shared_ptr<T>(obj, deleter, GraphArenaAllocator<T>(arena));
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+}  // namespace ge
+
+#endif  // INC_GRAPH_GRAPH_ARENA_H_
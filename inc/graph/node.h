@@ -31,6 +31,7 @@
 
 namespace ge {
 class ComputeGraph;
+class GraphArena;
 
 using ComputeGraphPtr = std::shared_ptr<ComputeGraph>;
 
@@ -179,6 +180,8 @@ class Node : public std::enable_shared_from_this<Node> {
   NodePtr GetOrigNode(void) { return orig_node_; }
 
  private:
+  // Arena of the owner graph, nullptr if anchors are allocated from heap.
+  std::shared_ptr<GraphArena> GetArena() const;
   bool NodeMembersAreEqual(const Node &r_node) const;
   bool NodeAttrsAreEqual(const Node &r_node) const;
   bool NodeInConnectsAreEqual(const Node &r_node) const;
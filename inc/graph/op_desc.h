@@ -246,6 +246,11 @@ class OpDesc : public std::enable_shared_from_this<OpDesc>, public AttrHolder {
   std::function<graphStatus(Operator &)> verifier_func_ = nullptr;
   string op_kernel_lib_name_;
   string engine_name_;
+  // Version of names of all ops, changed by every rename, for graphs to know their name indexes are stale
+  static uint64_t GetNameVersion();
+  static void UpdateNameVersion();
+  friend class ComputeGraph;
+  friend class Node;
   friend class OpDescUtils;
   friend class ModelSerializeImp;
   friend class AttrUtils;
@@ -107,7 +107,8 @@ std::size_t Buffer::GetSize() const {
 
 void Buffer::ClearBuffer() {
   if (buffer_ != nullptr) {
-    buffer_->clear();
+    // Release the memory as well, clear() of string keeps its capacity
+    std::string().swap(*buffer_);
   }
 }
 }  // namespace ge
@@ -16,7 +16,14 @@
 
 #include "graph/compute_graph.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <deque>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
 
 #include "./format_refiner.h"
 #include "./ge_context.h"
@@ -26,6 +33,8 @@
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "ge/ge_api_types.h"
+#include "graph/ge_local_context.h"
+#include "graph/operator_factory_impl.h"
 #include "graph/shape_refiner.h"
 #include "proto/ge_ir.pb.h"
 #include "utils/ge_ir_utils.h"
@@ -38,11 +47,59 @@
 namespace ge {
 namespace {
 const size_t OUTPUT_PARAM_SIZE = 2;
+const uint32_t kMaxInferShapeThreadNum = 64;
+// Levels narrower than this are inferred on the calling thread
+const size_t kMinParallelInferLevelSize = 4;
+const uint32_t kInvalidTopoIndex = UINT32_MAX;
+
+bool IsNextIterationType(const string &type) { return (type == NEXTITERATION) || (type == REFNEXTITERATION); }
+
+uint32_t GetInferShapeThreadNum() {
+  string thread_num_str;
+  if (ge::GetContext().GetOption(ge::INFER_SHAPE_THREAD_NUM, thread_num_str) != GRAPH_SUCCESS ||
+      thread_num_str.empty()) {
+    return 1;
+  }
+  const int base = 10;
+  int64_t thread_num = std::strtol(thread_num_str.c_str(), nullptr, base);
+  if (thread_num <= 1) {
+    return 1;
+  }
+  return static_cast<uint32_t>(std::min<int64_t>(thread_num, kMaxInferShapeThreadNum));
+}
+
+// A node without infer func may stop InferShapeInNeed, so it can not be inferred ahead of time
+bool HasInferFunc(const NodePtr &node) {
+  auto op_desc = node->GetOpDesc();
+  return op_desc->GetInferFunc() != nullptr || OperatorFactoryImpl::GetInferShapeFunc(op_desc->GetType()) != nullptr;
+}
+
+graphStatus VerifyAndInferShape(const NodePtr &node) {
+  if (node->Verify() != GRAPH_SUCCESS) {
+    GELOGE(GRAPH_FAILED, "Verifying %s failed.", node->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  return node->InferShapeAndType();
+}
+
+graphStatus UpdatePeerInputDesc(const NodePtr &node) {
+  for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+    GE_CHECK_NOTNULL(out_anchor->GetOwnerNode()->GetOpDesc());
+    auto output_tensor = out_anchor->GetOwnerNode()->GetOpDesc()->GetOutputDesc(out_anchor->GetIdx());
+    ge::TensorUtils::SetRealDimCnt(output_tensor, output_tensor.GetShape().GetDims().size());
+    (void)out_anchor->GetOwnerNode()->GetOpDesc()->UpdateOutputDesc(out_anchor->GetIdx(), output_tensor);
+    for (const auto &peer_anchor : out_anchor->GetPeerInDataAnchors()) {
+      (void)peer_anchor->GetOwnerNode()->GetOpDesc()->UpdateInputDesc(peer_anchor->GetIdx(), output_tensor);
+    }
+  }
+  return GRAPH_SUCCESS;
+}
 }  // namespace
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY ComputeGraph::ComputeGraph(const std::string &name)
     : nodes_(), input_nodes_(), sub_graph_(), name_(name), is_valid_flag_(false), need_iteration_(false) {
   attrs_.InitDefault();
+  arena_ = GraphArena::Current();
 }
 ComputeGraph::~ComputeGraph() {}
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY string ComputeGraph::GetName() const { return name_; }
@@ -85,17 +142,65 @@ ComputeGraph::Vistor<NodePtr> ComputeGraph::GetOutputNodes() const {
   return Vistor<NodePtr>(shared_from_this(), result);
 }
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY NodePtr ComputeGraph::FindNode(const std::string &name) const {
+  std::lock_guard<std::mutex> lock(node_index_.mutex);
+  if (!node_index_.is_valid || node_index_.name_version != OpDesc::GetNameVersion()) {
+    RebuildNodeIndex();
+  }
+  auto iter = node_index_.names.find(name);
+  return (iter == node_index_.names.end()) ? nullptr : iter->second;
+}
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY NodePtr ComputeGraph::FindNodeById(int64_t id) const {
+  std::lock_guard<std::mutex> lock(node_index_.mutex);
+  if (!node_index_.is_valid) {
+    RebuildNodeIndex();
+  }
+  auto iter = node_index_.ids.find(id);
+  if (iter != node_index_.ids.end() && iter->second->GetOpDesc()->GetId() == id) {
+    return iter->second;
+  }
+  // The id may be set after the index is built
   for (const auto &node : nodes_) {
-    if (node == nullptr) {
-      continue;
-    }
-    if (node->GetName() == name) {
+    if (node != nullptr && node->GetOpDesc() != nullptr && node->GetOpDesc()->GetId() == id) {
       return node;
     }
   }
   return nullptr;
 }
 
+void ComputeGraph::AddNodeIndex(const NodePtr &node) {
+  std::lock_guard<std::mutex> lock(node_index_.mutex);
+  if (node_index_.is_valid) {
+    // Appended, so a node of the same name or id ahead of it is kept
+    (void)node_index_.names.emplace(node->GetOpDesc()->GetName(), node);
+    (void)node_index_.ids.emplace(node->GetOpDesc()->GetId(), node);
+  }
+}
+
+void ComputeGraph::InvalidateNodeIndex() {
+  std::lock_guard<std::mutex> lock(node_index_.mutex);
+  node_index_.is_valid = false;
+  node_index_.names.clear();
+  node_index_.ids.clear();
+}
+
+void ComputeGraph::RebuildNodeIndex() const {
+  // Taken ahead, so a rename during the rebuild is seen by the next lookup
+  node_index_.name_version = OpDesc::GetNameVersion();
+  node_index_.names.clear();
+  node_index_.ids.clear();
+  node_index_.names.reserve(nodes_.size());
+  node_index_.ids.reserve(nodes_.size());
+  for (const auto &node : nodes_) {
+    if (node == nullptr || node->GetOpDesc() == nullptr) {
+      continue;
+    }
+    (void)node_index_.names.emplace(node->GetOpDesc()->GetName(), node);
+    (void)node_index_.ids.emplace(node->GetOpDesc()->GetId(), node);
+  }
+  node_index_.is_valid = true;
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ComputeGraph::GraphAttrsAreEqual(
   const ComputeGraph &r_graph) const {
   // ProtoMsgOwner <::google::protobuf::Message> is temporarily ignored
@@ -214,16 +319,24 @@ NodePtr ComputeGraph::AddNodeFront(NodePtr node) {
   } else {
     (void)nodes_.insert(nodes_.begin(), node);
   }
+  InvalidateNodeIndex();
   return node;
 }
 
+NodePtr ComputeGraph::CreateNode(const OpDescPtr &op) {
+  ComputeGraphPtr owner_graph = shared_from_this();
+  return ArenaCreate<Node>(arena_, [&op, &owner_graph](void *buffer) {
+    return (buffer == nullptr) ? new (std::nothrow) Node(op, owner_graph) : new (buffer) Node(op, owner_graph);
+  });
+}
+
 NodePtr ComputeGraph::AddNodeFront(const OpDescPtr &op) {
   if (op == nullptr) {
     GELOGE(GRAPH_FAILED, "The OpDesc ptr should be not null.");
     return nullptr;
   }
   op->SetId(nodes_.size());
-  NodePtr node_ptr = shared_ptr<Node>(new (std::nothrow) Node(op, shared_from_this()));
+  NodePtr node_ptr = CreateNode(op);
   GE_IF_BOOL_EXEC(node_ptr == nullptr, GELOGE(GRAPH_FAILED, "node_ptr is NULL!!!"); return nullptr);
   GE_IF_BOOL_EXEC(node_ptr->Init() != GRAPH_SUCCESS, GELOGE(GRAPH_FAILED, "node init fail."); return nullptr);
   return AddNodeFront(node_ptr);
@@ -236,6 +349,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY NodePtr ComputeGraph::AddNode(Nod
   }
   node->GetOpDesc()->SetId((int64_t)GetDirectNodesSize());
   nodes_.push_back(node);
+  AddNodeIndex(node);
   return node;
 }
 
@@ -245,7 +359,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY NodePtr ComputeGraph::AddNode(OpD
     return nullptr;
   }
   op->SetId(GetDirectNodesSize());
-  NodePtr node_ptr = shared_ptr<Node>(new (std::nothrow) Node(op, shared_from_this()));
+  NodePtr node_ptr = CreateNode(op);
   GE_IF_BOOL_EXEC(node_ptr == nullptr, GELOGE(GRAPH_FAILED, "node_ptr is NULL!!!"); return nullptr);
   GE_IF_BOOL_EXEC(node_ptr->Init() != GRAPH_SUCCESS, GELOGE(GRAPH_FAILED, "node init fail."); return nullptr);
   return AddNode(node_ptr);
@@ -304,6 +418,7 @@ graphStatus ComputeGraph::RemoveConstInput(const NodePtr &node) {
         auto iter = find(nodes_.begin(), nodes_.end(), out_anchor->GetOwnerNode());
         if (iter != nodes_.end()) {
           (void)nodes_.erase(iter);
+          InvalidateNodeIndex();
         }
       }
     }
@@ -334,6 +449,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::RemoveN
   auto iter = find(nodes_.begin(), nodes_.end(), node);
   if (iter != nodes_.end()) {
     (void)nodes_.erase(iter);
+    InvalidateNodeIndex();
     return GRAPH_SUCCESS;
   }
   return GRAPH_FAILED;
@@ -430,6 +546,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::InsertE
     }
   }
   nodes_.clear();
+  InvalidateNodeIndex();
   for (size_t i = 0; i < node_vec.size(); ++i) {
     NodePtr node = node_vec[i];
     if (node == nullptr || node->GetOpDesc() == nullptr) {
@@ -442,117 +559,171 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::InsertE
   return GRAPH_SUCCESS;
 }
 
-graphStatus ComputeGraph::DFSTopologicalSorting(std::vector<NodePtr> &node_vec,
-                                                std::map<NodePtr, uint32_t> &map_in_edge_num,
-                                                std::vector<NodePtr> &stack) {
-  GELOGI("Runing_Dfs_Sort");
-  // Record the number of non data nodes but no input nodes
-  GE_CHK_BOOL_EXEC(SortNodes(stack, map_in_edge_num) == GRAPH_SUCCESS, return GRAPH_FAILED, "sort nodes failed");
+// Nodes to sort in dense arrays, the successors of the i-th node are successors[offsets[i], offsets[i + 1]).
+struct TopoSortContext {
+  std::vector<NodePtr> nodes;
+  std::vector<uint32_t> in_edge_num;
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> successors;
+  // Nodes are indexed by op id, which is unique and less than the node number in most graphs, the others by address.
+  std::vector<uint32_t> id_to_index;
+  std::unordered_map<const Node *, uint32_t> other_nodes;
+
+  uint32_t GetIndex(const Node *node, int64_t id) const {
+    if (id >= 0 && static_cast<uint64_t>(id) < id_to_index.size()) {
+      uint32_t index = id_to_index[id];
+      if (index != kInvalidTopoIndex && nodes[index].get() == node) {
+        return index;
+      }
+    }
+    auto iter = other_nodes.find(node);
+    return (iter == other_nodes.end()) ? kInvalidTopoIndex : iter->second;
+  }
+};
 
-  // Only data nodes here
-  while (!stack.empty()) {
-    NodePtr node = stack.back();
-    stack.pop_back();
-    node_vec.push_back(node);
-    GE_CHECK_NOTNULL(node->GetOpDesc());
-    GELOGD("node_vec.push_back %s", node->GetOpDesc()->GetName().c_str());
-    for (const auto &anchor : node->GetAllOutDataAnchors()) {
+graphStatus ComputeGraph::InitTopoSortContext(TopoSortContext &context) const {
+  for (const auto &node : GetAllNodes()) {
+    GE_IF_BOOL_EXEC(node == nullptr || node->GetOpDesc() == nullptr, continue);
+    context.nodes.push_back(node);
+  }
+  size_t node_num = context.nodes.size();
+  if (node_num >= kInvalidTopoIndex) {
+    GELOGE(GRAPH_FAILED, "Too many nodes %zu to sort.", node_num);
+    return GRAPH_FAILED;
+  }
+  context.id_to_index.assign(node_num, kInvalidTopoIndex);
+  std::vector<bool> is_next_iteration(node_num, false);
+  for (uint32_t i = 0; i < node_num; ++i) {
+    const auto &op_desc = context.nodes[i]->op_;
+    int64_t id = op_desc->GetId();
+    if (id >= 0 && static_cast<uint64_t>(id) < node_num && context.id_to_index[id] == kInvalidTopoIndex) {
+      context.id_to_index[id] = i;
+    } else {
+      (void)context.other_nodes.emplace(context.nodes[i].get(), i);
+    }
+    is_next_iteration[i] = IsNextIterationType(op_desc->GetType());
+  }
+  auto get_index = [&context](const NodePtr &node) {
+    return (node == nullptr || node->op_ == nullptr) ? kInvalidTopoIndex
+                                                     : context.GetIndex(node.get(), node->op_->GetId());
+  };
+
+  context.in_edge_num.assign(node_num, 0);
+  for (uint32_t i = 0; i < node_num; ++i) {
+    const auto &node = context.nodes[i];
+    size_t in_edge_size = 0;
+    for (const auto &anchor : node->in_data_anchors_) {
       GE_CHECK_NOTNULL(anchor);
-      for (const auto &peer_in_anchor : anchor->GetPeerInDataAnchors()) {
-        GE_CHECK_NOTNULL(peer_in_anchor);
-        auto iter = map_in_edge_num.find(peer_in_anchor->GetOwnerNode());
-        if (iter != map_in_edge_num.end() && --iter->second == 0) {
-          stack.push_back(peer_in_anchor->GetOwnerNode());
-        }
+      in_edge_size += anchor->peer_anchors_.size();
+      // Break flow control data loop.
+      AnchorPtr peer_anchor = anchor->peer_anchors_.empty() ? nullptr : anchor->peer_anchors_.front().lock();
+      NodePtr out_node = (peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode();
+      if (out_node == nullptr || peer_anchor == out_node->out_control_anchor_) {
+        continue;
       }
-      for (const auto &peer_in_anchor : anchor->GetPeerInControlAnchors()) {
-        GE_CHECK_NOTNULL(peer_in_anchor);
-        auto iter = map_in_edge_num.find(peer_in_anchor->GetOwnerNode());
-        if (iter != map_in_edge_num.end() && --iter->second == 0) {
-          stack.push_back(peer_in_anchor->GetOwnerNode());
+      uint32_t out_index = get_index(out_node);
+      if ((out_index != kInvalidTopoIndex) ? is_next_iteration[out_index] : IsNextIterationType(out_node->GetType())) {
+        in_edge_size -= 1;
+      }
+    }
+    if (node->in_control_anchor_ != nullptr) {
+      in_edge_size += node->in_control_anchor_->peer_anchors_.size();
+    }
+    context.in_edge_num[i] = static_cast<uint32_t>(in_edge_size);
+  }
+
+  // Successors of a data anchor are visited in the order of its peer in data anchors then peer in control anchors
+  context.offsets.assign(node_num + 1, 0);
+  for (uint32_t i = 0; i < node_num; ++i) {
+    context.offsets[i] = static_cast<uint32_t>(context.successors.size());
+    const auto &node = context.nodes[i];
+    for (const auto &anchor : node->out_data_anchors_) {
+      GE_CHECK_NOTNULL(anchor);
+      for (bool visit_control : {false, true}) {
+        for (const auto &peer : anchor->peer_anchors_) {
+          AnchorPtr peer_anchor = peer.lock();
+          NodePtr peer_node = (peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode();
+          if (peer_node == nullptr || (peer_anchor == peer_node->in_control_anchor_) != visit_control) {
+            continue;
+          }
+          uint32_t peer_index = get_index(peer_node);
+          if (peer_index != kInvalidTopoIndex) {
+            context.successors.push_back(peer_index);
+          }
         }
       }
     }
-    GE_IF_BOOL_EXEC(
-      node->GetOutControlAnchor() != nullptr, for (AnchorPtr peer_in_anchor
-                                                   : node->GetOutControlAnchor()->GetPeerAnchors()) {
-        GE_CHECK_NOTNULL(peer_in_anchor);
-        auto iter = map_in_edge_num.find(peer_in_anchor->GetOwnerNode());
-        if (iter != map_in_edge_num.end() && --iter->second == 0) {
-          stack.push_back(peer_in_anchor->GetOwnerNode());
+    if (node->out_control_anchor_ != nullptr) {
+      for (const auto &peer : node->out_control_anchor_->peer_anchors_) {
+        AnchorPtr peer_anchor = peer.lock();
+        GE_CHECK_NOTNULL(peer_anchor);
+        uint32_t peer_index = get_index(peer_anchor->GetOwnerNode());
+        if (peer_index != kInvalidTopoIndex) {
+          context.successors.push_back(peer_index);
         }
-      })
+      }
+    }
   }
-
+  context.offsets[node_num] = static_cast<uint32_t>(context.successors.size());
   return GRAPH_SUCCESS;
 }
 
-graphStatus ComputeGraph::BFSTopologicalSorting(std::vector<NodePtr> &node_vec,
-                                                std::map<NodePtr, uint32_t> &map_in_edge_num,
-                                                std::deque<NodePtr> &stack) {
-  GELOGI("Runing_Bfs_Sort");
-  std::vector<NodePtr> stack_input;
-  std::map<string, NodePtr> breadth_node_map;
-  // Record the number of non data nodes but no input nodes
-  GE_CHK_BOOL_EXEC(SortNodes(stack_input, map_in_edge_num) == GRAPH_SUCCESS, return GRAPH_FAILED, "sort nodes failed");
+void ComputeGraph::DFSTopologicalSorting(TopoSortContext &context, std::vector<uint32_t> &stack,
+                                         std::vector<NodePtr> &node_vec) {
+  GELOGI("Runing_Dfs_Sort");
+  // Only data nodes here
+  while (!stack.empty()) {
+    uint32_t index = stack.back();
+    stack.pop_back();
+    node_vec.push_back(context.nodes[index]);
+    for (uint32_t i = context.offsets[index]; i < context.offsets[index + 1]; ++i) {
+      uint32_t successor = context.successors[i];
+      if (--context.in_edge_num[successor] == 0) {
+        stack.push_back(successor);
+      }
+    }
+  }
+}
 
+void ComputeGraph::BFSTopologicalSorting(TopoSortContext &context, std::vector<uint32_t> &stack_input,
+                                         std::vector<NodePtr> &node_vec) {
+  GELOGI("Runing_Bfs_Sort");
+  std::deque<uint32_t> stack;
+  std::vector<std::pair<std::string, uint32_t>> breadth_nodes;
   // Only data nodes here
   while (!stack_input.empty() || !stack.empty()) {
-    NodePtr node = nullptr;
+    uint32_t index = 0;
     if (!stack.empty()) {
-      node = stack.back();
+      index = stack.back();
       stack.pop_back();
     } else {
-      node = stack_input.back();
+      index = stack_input.back();
       stack_input.pop_back();
     }
-    node_vec.push_back(node);
-    GE_CHECK_NOTNULL(node->GetOpDesc());
-    GELOGD("node_vec.push_back %s", node->GetOpDesc()->GetName().c_str());
-
-    CollectBreadthOutNode(node, map_in_edge_num, breadth_node_map);
+    node_vec.push_back(context.nodes[index]);
 
-    for (const auto &name_node : breadth_node_map) {
-      (void)stack.push_front(name_node.second);
-    }
-    breadth_node_map.clear();
-  }
-
-  return GRAPH_SUCCESS;
-}
-
-graphStatus ComputeGraph::CollectBreadthOutNode(const NodePtr &node, std::map<NodePtr, uint32_t> &map_in_edge_num,
-                                                std::map<string, NodePtr> &breadth_node_map) {
-  for (const auto &anchor : node->GetAllOutDataAnchors()) {
-    for (const auto &peer_in_anchor : anchor->GetPeerInDataAnchors()) {
-      auto iter = map_in_edge_num.find(peer_in_anchor->GetOwnerNode());
-      if (iter != map_in_edge_num.end() && 0 == --iter->second) {
-        (void)breadth_node_map.emplace(peer_in_anchor->GetOwnerNode()->GetName(), peer_in_anchor->GetOwnerNode());
+    for (uint32_t i = context.offsets[index]; i < context.offsets[index + 1]; ++i) {
+      uint32_t successor = context.successors[i];
+      if (--context.in_edge_num[successor] == 0) {
+        breadth_nodes.emplace_back(context.nodes[successor]->GetName(), successor);
       }
     }
-
-    for (const auto &peer_in_anchor : anchor->GetPeerInControlAnchors()) {
-      auto iter = map_in_edge_num.find(peer_in_anchor->GetOwnerNode());
-      if (iter != map_in_edge_num.end() && 0 == --iter->second) {
-        (void)breadth_node_map.emplace(peer_in_anchor->GetOwnerNode()->GetName(), peer_in_anchor->GetOwnerNode());
-      }
+    // Nodes become ready by the same node are visited in the order of their names
+    if (breadth_nodes.size() > 1) {
+      std::stable_sort(breadth_nodes.begin(), breadth_nodes.end(),
+                       [](const std::pair<std::string, uint32_t> &lhs, const std::pair<std::string, uint32_t> &rhs) {
+                         return lhs.first < rhs.first;
+                       });
     }
+    for (const auto &name_node : breadth_nodes) {
+      stack.push_front(name_node.second);
+    }
+    breadth_nodes.clear();
   }
-
-  GE_IF_BOOL_EXEC(
-    node->GetOutControlAnchor() != nullptr, for (AnchorPtr peer_in_anchor
-                                                 : node->GetOutControlAnchor()->GetPeerAnchors()) {
-      auto iter = map_in_edge_num.find(peer_in_anchor->GetOwnerNode());
-      if (iter != map_in_edge_num.end() && 0 == --iter->second) {
-        (void)breadth_node_map.emplace(peer_in_anchor->GetOwnerNode()->GetName(), peer_in_anchor->GetOwnerNode());
-      }
-    })
-  return GRAPH_SUCCESS;
 }
 
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::TopologicalSorting() {
   std::vector<NodePtr> node_vec;
-  std::map<NodePtr, uint32_t> map_in_edge_num;
   bool use_BFS = false;
   string run_mode;
   const int base = 10;
@@ -564,16 +735,18 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::Topolog
     GELOGW("Get OPTION_GRAPH_RUN_MODE failed, use BFSTopologicalSorting by default.");
   }
 
+  TopoSortContext context;
+  if (InitTopoSortContext(context) != GRAPH_SUCCESS) {
+    GELOGE(GRAPH_FAILED, "init topo sort context failed");
+    return GRAPH_FAILED;
+  }
+  std::vector<uint32_t> stack;
+  GE_CHK_BOOL_EXEC(SortNodes(context, stack) == GRAPH_SUCCESS, return GRAPH_FAILED, "sort nodes failed");
+  node_vec.reserve(context.nodes.size());
   if (use_BFS) {
-    std::deque<NodePtr> stack;
-    if (BFSTopologicalSorting(node_vec, map_in_edge_num, stack) != GRAPH_SUCCESS) {
-      return GRAPH_FAILED;
-    }
+    BFSTopologicalSorting(context, stack, node_vec);
   } else {
-    std::vector<NodePtr> stack;
-    if (DFSTopologicalSorting(node_vec, map_in_edge_num, stack) != GRAPH_SUCCESS) {
-      return GRAPH_FAILED;
-    }
+    DFSTopologicalSorting(context, stack, node_vec);
   }
 
   // If they are not equal, there is a closed loop
@@ -593,6 +766,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::Topolog
   }
 
   nodes_.clear();
+  InvalidateNodeIndex();
   for (size_t i = 0; i < node_vec.size(); i++) {
     NodePtr node = node_vec[i];   // [node: should not be null]
     node->GetOpDesc()->SetId(i);  // [node->GetOpDesc(): should not be null]
@@ -602,9 +776,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::Topolog
   return GRAPH_SUCCESS;
 }
 
-graphStatus ComputeGraph::SortNodes(std::vector<NodePtr> &stack, std::map<NodePtr, uint32_t> &map_in_edge_num) {
-  // Record the number of non data nodes but no input nodes
-  uint32_t spec_node_size = 0;
+graphStatus ComputeGraph::SortNodes(const TopoSortContext &context, std::vector<uint32_t> &stack) {
   bool verify_isolated = false;
   string run_mode;
   const int base = 10;
@@ -614,76 +786,206 @@ graphStatus ComputeGraph::SortNodes(std::vector<NodePtr> &stack, std::map<NodePt
       verify_isolated = true;
     }
   }
-  for (const auto &node : GetAllNodes()) {
-    GE_IF_BOOL_EXEC(node->GetOpDesc() == nullptr, continue);
-    map_in_edge_num[node] = static_cast<uint32_t>(GetInEdgeSize(node));
-    if (map_in_edge_num[node] == 0) {
-      if ((node->GetOpDesc()->GetType() != kDataType) && (node->GetOpDesc()->GetType() != kAippDataType) &&
-          (node->GetOpDesc()->GetType() != kInputType) && (node->GetOpDesc()->GetType() != kAnnDataType)) {
-        // At present, can only judge the isolated point without input and output.
-        // It is impossible to judge the situation with multiple output nodes.
-        if (verify_isolated && GetOutEdgeSize(node) == 0) {
-          GELOGE(GRAPH_FAILED, "May has isolated nodes in graph, node name: %s.", node->GetName().c_str());
-          return GRAPH_FAILED;
-        }
-        (void)stack.insert(stack.begin(), node);
-        spec_node_size++;
-        continue;
+  // Non data nodes without input are popped after data nodes, both in reverse order in stack
+  std::vector<uint32_t> spec_nodes;
+  std::vector<uint32_t> data_nodes;
+  for (uint32_t i = 0; i < context.nodes.size(); ++i) {
+    if (context.in_edge_num[i] != 0) {
+      continue;
+    }
+    const auto &node = context.nodes[i];
+    string type = node->GetOpDesc()->GetType();
+    if ((type != kDataType) && (type != kAippDataType) && (type != kInputType) && (type != kAnnDataType)) {
+      // At present, can only judge the isolated point without input and output.
+      // It is impossible to judge the situation with multiple output nodes.
+      if (verify_isolated && GetOutEdgeSize(node) == 0) {
+        GELOGE(GRAPH_FAILED, "May has isolated nodes in graph, node name: %s.", node->GetName().c_str());
+        return GRAPH_FAILED;
       }
-      // Need to insert the data nodes in reverse order
-      (void)stack.insert(stack.begin() + spec_node_size, node);
+      spec_nodes.push_back(i);
+      continue;
     }
+    data_nodes.push_back(i);
   }
+  stack.assign(spec_nodes.rbegin(), spec_nodes.rend());
+  stack.insert(stack.end(), data_nodes.rbegin(), data_nodes.rend());
 
   /// Make sure the inputs order matches with user-designated
   /// 1. Get the index of two input nodes in the user-inputs-order(inputs_order_)
   /// 2. Compare two indices, if not match, swap the positions of two inputs
   /// *: Remind: stack is reverse-order
+  if (inputs_order_.empty()) {
+    return GRAPH_SUCCESS;
+  }
+  std::unordered_map<std::string, size_t> input_order_index;
+  for (size_t i = 0; i < inputs_order_.size(); ++i) {
+    (void)input_order_index.emplace(inputs_order_[i], i);
+  }
+  // Positions in stack and order indices of nodes found in 'inputs_order_', the others are skipped
+  std::vector<std::pair<size_t, size_t>> ordered_nodes;
   for (size_t i = 0; i < stack.size(); ++i) {
-    //[stack: should not be null]
-    for (size_t j = i + 1; j < stack.size(); ++j) {
-      // If not found in 'inputs_order_', skip it
-      auto it_i = std::find(inputs_order_.begin(), inputs_order_.end(), stack[i]->GetName());
-      GE_IF_BOOL_EXEC(it_i == inputs_order_.end(), continue);
-      auto it_j = std::find(inputs_order_.begin(), inputs_order_.end(), stack[j]->GetName());
-      GE_IF_BOOL_EXEC(it_j == inputs_order_.end(), continue);
-
+    auto iter = input_order_index.find(context.nodes[stack[i]]->GetName());
+    if (iter != input_order_index.end()) {
+      ordered_nodes.emplace_back(i, iter->second);
+    }
+  }
+  for (size_t i = 0; i < ordered_nodes.size(); ++i) {
+    for (size_t j = i + 1; j < ordered_nodes.size(); ++j) {
       // Compare index, swap them if it should be
-      auto inx_i = it_i - inputs_order_.begin();
-      auto inx_j = it_j - inputs_order_.begin();
-      GE_IF_BOOL_EXEC(inx_i < inx_j, std::swap(stack[i], stack[j]));
+      if (ordered_nodes[i].second < ordered_nodes[j].second) {
+        std::swap(stack[ordered_nodes[i].first], stack[ordered_nodes[j].first]);
+        std::swap(ordered_nodes[i].second, ordered_nodes[j].second);
+      }
     }
   }
-
   return GRAPH_SUCCESS;
 }
-size_t ComputeGraph::GetInEdgeSize(const NodePtr &node) {
-  size_t in_edge_size = 0;
-  if (node == nullptr) {
-    return in_edge_size;
-  }
-  for (const auto &anchor : node->GetAllInDataAnchors()) {
-    in_edge_size = in_edge_size + anchor->GetPeerAnchors().size();
-    // Break flow control data loop.
-    OutDataAnchorPtr out_anchor = anchor->GetPeerOutAnchor();
-    if ((out_anchor != nullptr) && (out_anchor->GetOwnerNode() != nullptr)) {
-      NodePtr out_node = out_anchor->GetOwnerNode();
-      if (out_node == nullptr) {
-        GELOGW("out node is nullptr");
-        continue;
+
+GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
+ComputeGraph::IncrementalTopologicalSorting(const std::vector<NodePtr> &dirty_nodes) {
+  // Subgraph nodes are sorted together with direct nodes
+  if (!sub_graph_.empty()) {
+    return TopologicalSorting();
+  }
+  // Op ids are the same as positions after sorting and appending nodes, so that positions of peer nodes are found
+  // without a map. Removing or moving nodes breaks it, and the graph is sorted fully then.
+  const int64_t node_num = static_cast<int64_t>(nodes_.size());
+  auto get_position = [this, node_num](const NodePtr &node) -> int64_t {
+    if (node == nullptr || node->op_ == nullptr) {
+      return -1;
+    }
+    int64_t id = node->op_->GetId();
+    return (id >= 0 && id < node_num && nodes_[id] == node) ? id : -1;
+  };
+  std::vector<int64_t> peers;
+  auto collect_successors = [&peers, &get_position](const Node &node) {
+    peers.clear();
+    // Break flow control data loop, as TopologicalSorting does not count these edges
+    bool is_next_iteration = IsNextIterationType(node.op_->GetType());
+    for (const auto &anchor : node.out_data_anchors_) {
+      GE_IF_BOOL_EXEC(anchor == nullptr, continue);
+      for (const auto &peer : anchor->peer_anchors_) {
+        AnchorPtr peer_anchor = peer.lock();
+        NodePtr peer_node = (peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode();
+        if (peer_node == nullptr || (is_next_iteration && peer_anchor != peer_node->in_control_anchor_)) {
+          continue;
+        }
+        peers.push_back(get_position(peer_node));
       }
-      if ((out_node->GetType() == NEXTITERATION) || (out_node->GetType() == REFNEXTITERATION)) {
-        GE_IF_BOOL_EXEC(in_edge_size == 0, GELOGE(GRAPH_FAILED, "If [in_edge_size = 0], the result will be reversed");
-                        return in_edge_size);
-        in_edge_size -= 1;
+    }
+    if (node.out_control_anchor_ != nullptr) {
+      for (const auto &peer : node.out_control_anchor_->peer_anchors_) {
+        AnchorPtr peer_anchor = peer.lock();
+        peers.push_back(get_position((peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode()));
+      }
+    }
+  };
+  auto collect_predecessors = [&peers, &get_position](const Node &node) {
+    peers.clear();
+    for (const auto &anchor : node.in_data_anchors_) {
+      GE_IF_BOOL_EXEC(anchor == nullptr, continue);
+      for (const auto &peer : anchor->peer_anchors_) {
+        AnchorPtr peer_anchor = peer.lock();
+        NodePtr peer_node = (peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode();
+        if (peer_node == nullptr || IsNextIterationType(peer_node->op_->GetType())) {
+          continue;
+        }
+        peers.push_back(get_position(peer_node));
+      }
+    }
+    if (node.in_control_anchor_ != nullptr) {
+      for (const auto &peer : node.in_control_anchor_->peer_anchors_) {
+        AnchorPtr peer_anchor = peer.lock();
+        peers.push_back(get_position((peer_anchor == nullptr) ? nullptr : peer_anchor->GetOwnerNode()));
+      }
+    }
+  };
+
+  // Only edges of dirty nodes may point backwards, nodes between their heads and tails need to be moved
+  int64_t low = node_num;
+  int64_t high = -1;
+  for (const auto &node : dirty_nodes) {
+    int64_t position = get_position(node);
+    if (position < 0) {
+      GELOGD("Node of graph %s is not in its sorted position, sort the graph fully.", name_.c_str());
+      return TopologicalSorting();
+    }
+    collect_successors(*node);
+    for (int64_t peer : peers) {
+      GE_IF_BOOL_EXEC(peer < 0, return TopologicalSorting());
+      if (peer <= position) {
+        low = std::min(low, peer);
+        high = std::max(high, position);
+      }
+    }
+    collect_predecessors(*node);
+    for (int64_t peer : peers) {
+      GE_IF_BOOL_EXEC(peer < 0, return TopologicalSorting());
+      if (peer >= position) {
+        low = std::min(low, position);
+        high = std::max(high, peer);
+      }
+    }
+  }
+  if (high < 0) {
+    is_valid_flag_ = true;
+    return GRAPH_SUCCESS;
+  }
+
+  // Kahn sorting of the range, ready nodes are taken in their current order to keep the range stable
+  size_t range_size = static_cast<size_t>(high - low + 1);
+  std::vector<uint32_t> in_edge_num(range_size, 0);
+  std::vector<uint32_t> offsets(range_size + 1, 0);
+  std::vector<uint32_t> range_successors;
+  for (size_t i = 0; i < range_size; ++i) {
+    offsets[i] = static_cast<uint32_t>(range_successors.size());
+    collect_successors(*nodes_[low + i]);
+    for (int64_t position : peers) {
+      if (position < low) {
+        // Unsorted peer or an edge of clean nodes pointing backwards
+        GELOGD("Graph %s is not sorted except for the dirty nodes, sort it fully.", name_.c_str());
+        return TopologicalSorting();
+      }
+      if (position <= high) {
+        range_successors.push_back(static_cast<uint32_t>(position - low));
+        ++in_edge_num[position - low];
       }
     }
   }
-  if (node->GetInControlAnchor() != nullptr) {
-    in_edge_size = in_edge_size + node->GetInControlAnchor()->GetPeerAnchors().size();
+  offsets[range_size] = static_cast<uint32_t>(range_successors.size());
+  std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+  for (size_t i = 0; i < range_size; ++i) {
+    if (in_edge_num[i] == 0) {
+      ready.push(static_cast<uint32_t>(i));
+    }
   }
-  return in_edge_size;
+  std::vector<NodePtr> node_vec;
+  node_vec.reserve(range_size);
+  while (!ready.empty()) {
+    uint32_t index = ready.top();
+    ready.pop();
+    node_vec.push_back(nodes_[low + index]);
+    for (uint32_t i = offsets[index]; i < offsets[index + 1]; ++i) {
+      if (--in_edge_num[range_successors[i]] == 0) {
+        ready.push(range_successors[i]);
+      }
+    }
+  }
+  if (node_vec.size() != range_size) {
+    GE_LOGE("Failed to do incremental topo sorting total %zu, itered %zu, exist closed loop between %s and %s.",
+            range_size, node_vec.size(), nodes_[low]->GetName().c_str(), nodes_[high]->GetName().c_str());
+    return GRAPH_FAILED;
+  }
+  GELOGD("Incremental topo sorting of graph %s moved nodes in range [%ld, %ld].", name_.c_str(), low, high);
+  for (size_t i = 0; i < range_size; ++i) {
+    nodes_[low + i] = node_vec[i];
+    node_vec[i]->op_->SetId(low + static_cast<int64_t>(i));
+  }
+  InvalidateNodeIndex();
+  is_valid_flag_ = true;
+  return GRAPH_SUCCESS;
 }
+
 size_t ComputeGraph::GetOutEdgeSize(const NodePtr &node) {
   size_t out_edge_size = 0;
   if (node == nullptr) {
@@ -852,36 +1154,137 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::InferOr
   return ge::FormatRefiner::InferOrigineFormat(shared_from_this());
 }
 
+///
+/// Infer the leading nodes which all own an infer func level by level. Nodes of one level only depend on nodes of
+/// lower levels, so they are inferred concurrently, while the peer input descs are updated afterwards in node order
+/// to keep the result identical to the serial inference.
+/// @param [in] infer_nodes: nodes need infer, in topological order
+/// @param [in] thread_num: max worker num of one level
+/// @param [out] inferred_num: num of leading nodes that have been inferred
+///
+graphStatus ComputeGraph::InferShapeInLevels(const std::vector<NodePtr> &infer_nodes, uint32_t thread_num,
+                                             size_t &inferred_num) {
+  inferred_num = 0;
+  std::unordered_map<Node *, size_t> node_indexes;
+  for (size_t i = 0; i < infer_nodes.size(); ++i) {
+    node_indexes[infer_nodes[i].get()] = i;
+  }
+
+  // The level of a node is one higher than the highest level of its inferred producers
+  std::unordered_map<Node *, size_t> node_levels;
+  std::vector<std::vector<size_t>> levels;
+  size_t parallel_num = 0;
+  for (; parallel_num < infer_nodes.size(); ++parallel_num) {
+    const auto &node = infer_nodes[parallel_num];
+    if (!HasInferFunc(node)) {
+      break;
+    }
+    size_t level = 0;
+    bool is_ordered = true;
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+      if (peer_out_anchor == nullptr || peer_out_anchor->GetOwnerNode() == nullptr) {
+        continue;
+      }
+      Node *in_node = peer_out_anchor->GetOwnerNode().get();
+      auto index_iter = node_indexes.find(in_node);
+      if (index_iter != node_indexes.end() && index_iter->second > parallel_num) {
+        is_ordered = false;
+        break;
+      }
+      auto level_iter = node_levels.find(in_node);
+      if (level_iter != node_levels.end()) {
+        level = std::max(level, level_iter->second + 1);
+      }
+    }
+    if (!is_ordered) {
+      GELOGW("Node %s is ahead of its producer, infer the rest nodes serially.", node->GetName().c_str());
+      break;
+    }
+    node_levels[node.get()] = level;
+    if (level >= levels.size()) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(parallel_num);
+  }
+
+  GEThreadLocalContext context = GetThreadLocalContext();
+  std::vector<graphStatus> infer_status(parallel_num, GRAPH_SUCCESS);
+  for (size_t level = 0; level < levels.size(); ++level) {
+    auto start_time = std::chrono::steady_clock::now();
+    const auto &level_nodes = levels[level];
+    size_t worker_num = 1;
+    if (level_nodes.size() >= kMinParallelInferLevelSize) {
+      worker_num = std::min(static_cast<size_t>(thread_num), level_nodes.size());
+    }
+    std::atomic<size_t> next_pos(0);
+    auto infer_level = [&]() {
+      for (size_t pos = next_pos++; pos < level_nodes.size(); pos = next_pos++) {
+        size_t node_index = level_nodes[pos];
+        infer_status[node_index] = VerifyAndInferShape(infer_nodes[node_index]);
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < worker_num; ++i) {
+      workers.emplace_back([&context, &infer_level]() {
+        GetThreadLocalContext() = context;
+        infer_level();
+      });
+    }
+    infer_level();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+
+    // Nodes of a level are kept in node order, merge them as the serial inference does
+    for (size_t node_index : level_nodes) {
+      const auto &node = infer_nodes[node_index];
+      GE_CHK_BOOL_EXEC(infer_status[node_index] == GRAPH_SUCCESS, return GRAPH_FAILED, "Inferring %s failed.",
+                       node->GetName().c_str());
+      GE_CHK_STATUS_RET(UpdatePeerInputDesc(node), "Update peer input desc of %s failed.", node->GetName().c_str());
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+    GELOGI("[GEPERFTRACE] InferShapeInNeed level %zu: %zu nodes, %zu workers, time cost %ld micro second.", level,
+           level_nodes.size(), worker_num, static_cast<int64_t>(cost.count()));
+  }
+  inferred_num = parallel_num;
+  GEEVENT("InferShapeInNeed inferred %zu of %zu nodes in %zu levels with %u threads.", parallel_num,
+          infer_nodes.size(), levels.size(), thread_num);
+  return GRAPH_SUCCESS;
+}
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus ComputeGraph::InferShapeInNeed() {
   GE_CHK_BOOL_ONLY_LOG(TopologicalSorting() == GRAPH_SUCCESS, "Verifying failed.");
+  std::vector<NodePtr> infer_nodes;
   for (const auto &node_ptr : GetAllNodes()) {
     GE_CHECK_NOTNULL(node_ptr);
     auto op_desc = node_ptr->GetOpDesc();
     bool is_need_infer = false;
     (void)ge::AttrUtils::GetBool(op_desc, NEED_INFER, is_need_infer);
     if (is_need_infer) {
-      GE_CHK_BOOL_EXEC(node_ptr->Verify() == GRAPH_SUCCESS, return GRAPH_FAILED, "Verifying %s failed.",
-                       node_ptr->GetName().c_str());
-
-      graphStatus status = node_ptr->InferShapeAndType();
-      GE_CHK_BOOL_EXEC_INFO(node_ptr->GetType() == kDataType || GRAPH_PARAM_INVALID != status, break,
-                            "Op %s does not have the IMPLEMT_INFERFUNC definition,"
-                            " and subsequent operators no longer perform shape inference.",
-                            node_ptr->GetName().c_str());
-      GE_CHK_BOOL_EXEC(status == GRAPH_SUCCESS, return GRAPH_FAILED, "Inferring %s failed.",
-                       node_ptr->GetName().c_str());
-
-      for (const auto &out_anchor : node_ptr->GetAllOutDataAnchors()) {
-        GE_CHECK_NOTNULL(out_anchor->GetOwnerNode()->GetOpDesc());
-        auto output_tensor = out_anchor->GetOwnerNode()->GetOpDesc()->GetOutputDesc(out_anchor->GetIdx());
-        ge::TensorUtils::SetRealDimCnt(output_tensor, output_tensor.GetShape().GetDims().size());
-        (void)out_anchor->GetOwnerNode()->GetOpDesc()->UpdateOutputDesc(out_anchor->GetIdx(), output_tensor);
-        for (const auto &peer_anchor : out_anchor->GetPeerInDataAnchors()) {
-          (void)peer_anchor->GetOwnerNode()->GetOpDesc()->UpdateInputDesc(peer_anchor->GetIdx(), output_tensor);
-        }
-      }
+      infer_nodes.push_back(node_ptr);
     }
   }
+
+  size_t inferred_num = 0;
+  uint32_t thread_num = GetInferShapeThreadNum();
+  if (thread_num > 1) {
+    GE_CHK_BOOL_EXEC(InferShapeInLevels(infer_nodes, thread_num, inferred_num) == GRAPH_SUCCESS,
+                     return GRAPH_FAILED, "Infer shape in levels failed.");
+  }
+
+  for (size_t i = inferred_num; i < infer_nodes.size(); ++i) {
+    const auto &node_ptr = infer_nodes[i];
+    graphStatus status = VerifyAndInferShape(node_ptr);
+    GE_CHK_BOOL_EXEC_INFO(node_ptr->GetType() == kDataType || GRAPH_PARAM_INVALID != status, break,
+                          "Op %s does not have the IMPLEMT_INFERFUNC definition,"
+                          " and subsequent operators no longer perform shape inference.",
+                          node_ptr->GetName().c_str());
+    GE_CHK_BOOL_EXEC(status == GRAPH_SUCCESS, return GRAPH_FAILED, "Inferring %s failed.",
+                     node_ptr->GetName().c_str());
+    GE_CHK_STATUS_RET(UpdatePeerInputDesc(node_ptr), "Update peer input desc of %s failed.",
+                      node_ptr->GetName().c_str());
+  }
   return GRAPH_SUCCESS;
 }
 
@@ -16,13 +16,19 @@
 
 #include "graph/format_refiner.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "./compute_graph.h"
+#include "./ge_context.h"
 #include "./ge_error_codes.h"
 #include "./graph/ge_tensor.h"
 #include "./operator.h"
@@ -31,6 +37,8 @@
 #include "debug/ge_op_types.h"
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
+#include "ge/ge_api_types.h"
+#include "graph/ge_local_context.h"
 #include "utils/node_utils.h"
 #include "utils/op_desc_utils.h"
 #include "utils/tensor_utils.h"
@@ -42,6 +50,128 @@ static const std::unordered_set<string> kChangeDimNodes = {RESHAPE, PERMUTE, EXP
 static bool net_format_is_nd = true;
 static Format g_user_set_format = FORMAT_ND;
 static bool is_first_infer = true;
+// 4 means dims num, formats of change dim nodes with less dims are not inferred
+const size_t kChangeDimNodeMinDimNum = 4;
+
+// Same conditions as BackInferProcess and ForwardInferProcess to set origin format of a tensor
+bool IsFormatInferable(const NodePtr &node, const ConstGeTensorDescPtr &tensor_desc) {
+  if (tensor_desc == nullptr || tensor_desc->GetOriginFormat() != FORMAT_ND) {
+    return false;
+  }
+  auto dim_num = tensor_desc->GetShape().GetDimNum();
+  if (dim_num == 0) {
+    return false;
+  }
+  return (kChangeDimNodes.count(node->GetType()) == 0) || (dim_num >= kChangeDimNodeMinDimNum);
+}
+
+size_t FindRegionRoot(std::vector<size_t> &parents, size_t index) {
+  while (parents[index] != index) {
+    parents[index] = parents[parents[index]];
+    index = parents[index];
+  }
+  return index;
+}
+
+///
+/// Split nodes into regions that never touch the same node. Only anchor points, data nodes and nodes with an
+/// inferable tensor are processed, and processing a node reads or writes tensors of the peers of all its data edges,
+/// so both ends of every data edge of such a node are kept in one region. Anchor points and data nodes of a region
+/// are kept in the order they are processed serially, and regions are ordered by their first node.
+///
+void GetFormatRegions(const ComputeGraphPtr &graph, const std::vector<NodePtr> &anchor_points,
+                      const std::vector<NodePtr> &data_nodes, std::vector<std::vector<NodePtr>> &region_anchor_points,
+                      std::vector<std::vector<NodePtr>> &region_data_nodes) {
+  auto all_nodes = graph->GetAllNodes();
+  std::unordered_map<const Node *, size_t> node_indexes;
+  node_indexes.reserve(all_nodes.size());
+  for (size_t i = 0; i < all_nodes.size(); ++i) {
+    node_indexes[all_nodes.at(i).get()] = i;
+  }
+
+  std::vector<bool> is_processed(all_nodes.size(), false);
+  auto mark_processed = [&node_indexes, &is_processed](const std::vector<NodePtr> &nodes) {
+    for (const auto &node : nodes) {
+      auto iter = node_indexes.find(node.get());
+      if (iter != node_indexes.end()) {
+        is_processed[iter->second] = true;
+      }
+    }
+  };
+  mark_processed(anchor_points);
+  mark_processed(data_nodes);
+  for (size_t i = 0; i < all_nodes.size(); ++i) {
+    const auto &node = all_nodes.at(i);
+    const auto &op_desc = node->GetOpDesc();
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      if (IsFormatInferable(node, op_desc->GetInputDescPtr(in_anchor->GetIdx()))) {
+        is_processed[i] = true;
+      }
+    }
+    for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+      if (IsFormatInferable(node, op_desc->GetOutputDescPtr(out_anchor->GetIdx()))) {
+        is_processed[i] = true;
+      }
+    }
+  }
+
+  std::vector<size_t> parents(all_nodes.size());
+  for (size_t i = 0; i < parents.size(); ++i) {
+    parents[i] = i;
+  }
+  for (size_t i = 0; i < all_nodes.size(); ++i) {
+    const auto &node = all_nodes.at(i);
+    for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+      for (const auto &peer_in_anchor : out_anchor->GetPeerInDataAnchors()) {
+        auto iter = node_indexes.find(peer_in_anchor->GetOwnerNode().get());
+        if (iter == node_indexes.end() || (!is_processed[i] && !is_processed[iter->second])) {
+          continue;
+        }
+        size_t src_root = FindRegionRoot(parents, i);
+        size_t dst_root = FindRegionRoot(parents, iter->second);
+        if (src_root != dst_root) {
+          parents[std::max(src_root, dst_root)] = std::min(src_root, dst_root);
+        }
+      }
+    }
+  }
+
+  // Roots are the smallest node index of regions, so regions are numbered in order of their first node
+  std::vector<size_t> region_ids(all_nodes.size(), SIZE_MAX);
+  size_t region_num = 0;
+  for (size_t i = 0; i < all_nodes.size(); ++i) {
+    size_t root = FindRegionRoot(parents, i);
+    if (region_ids[root] == SIZE_MAX) {
+      region_ids[root] = region_num++;
+    }
+  }
+  region_anchor_points.assign(region_num, std::vector<NodePtr>());
+  region_data_nodes.assign(region_num, std::vector<NodePtr>());
+  for (const auto &node : anchor_points) {
+    auto iter = node_indexes.find(node.get());
+    if (iter != node_indexes.end()) {
+      region_anchor_points[region_ids[FindRegionRoot(parents, iter->second)]].push_back(node);
+    }
+  }
+  for (const auto &node : data_nodes) {
+    auto iter = node_indexes.find(node.get());
+    if (iter != node_indexes.end()) {
+      region_data_nodes[region_ids[FindRegionRoot(parents, iter->second)]].push_back(node);
+    }
+  }
+  // Regions of neither anchor points nor data nodes have nothing to infer
+  size_t kept_num = 0;
+  for (size_t region = 0; region < region_num; ++region) {
+    if (region_anchor_points[region].empty() && region_data_nodes[region].empty()) {
+      continue;
+    }
+    region_anchor_points[kept_num].swap(region_anchor_points[region]);
+    region_data_nodes[kept_num].swap(region_data_nodes[region]);
+    kept_num++;
+  }
+  region_anchor_points.resize(kept_num);
+  region_data_nodes.resize(kept_num);
+}
 }  // namespace
 
 graphStatus FormatRefiner::RefreshConstantOutProcess(const OpDescPtr &op_desc) {
@@ -84,21 +214,27 @@ graphStatus FormatRefiner::GetAnchorPoints(const ge::ComputeGraphPtr &graph, std
     // get all input desc format
     bool node_is_all_nd = false;
     for (uint32_t i = 0; i < static_cast<uint32_t>(op_desc->GetInputsSize()); i++) {
-      auto input_desc = op_desc->GetInputDesc(i);
-      // Operator pre-set format but not origin format
-      auto input_format = input_desc.GetFormat();
+      auto input_desc = op_desc->GetInputDescPtr(i);
       // Pre-save data node and default infer fail
       if (node_ptr->GetType() == DATA) {
         data_nodes.push_back(node_ptr);
       }
+      if (input_desc == nullptr) {
+        continue;
+      }
+      // Operator pre-set format but not origin format
+      auto input_format = input_desc->GetFormat();
       if (input_format != FORMAT_ND && input_format != FORMAT_RESERVED) {
         node_is_all_nd = true;
       }
     }
     // Get all output desc format
     for (uint32_t i = 0; i < static_cast<uint32_t>(op_desc->GetOutputsSize()); i++) {
-      GeTensorDesc output_desc = op_desc->GetOutputDesc(i);
-      auto output_format = output_desc.GetFormat();
+      auto output_desc = op_desc->GetOutputDescPtr(i);
+      if (output_desc == nullptr) {
+        continue;
+      }
+      auto output_format = output_desc->GetFormat();
       if (output_format != FORMAT_ND && output_format != FORMAT_RESERVED) {
         node_is_all_nd = true;
       }
@@ -146,11 +282,12 @@ graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::
   for (const auto &in_anchor : node->GetAllInDataAnchors()) {
     GELOGD("Node is [%s] [B]", (node->GetName()).c_str());
     auto in_data_anchor_idx = in_anchor->GetIdx();
-    auto to_be_set_format = (node->GetOpDesc()->GetInputDesc(in_data_anchor_idx)).GetOriginFormat();
-    if (to_be_set_format == FORMAT_ND) {
+    auto input_desc = node->GetOpDesc()->GetInputDescPtr(in_data_anchor_idx);
+    if (input_desc == nullptr || input_desc->GetOriginFormat() == FORMAT_ND) {
       GELOGD("Node [%s] [B], format is ND", (node->GetName()).c_str());
       continue;
     }
+    auto to_be_set_format = input_desc->GetOriginFormat();
     auto peer_out_data_anchor = in_anchor->GetPeerOutAnchor();
     if (peer_out_data_anchor == nullptr) {
       GELOGW("Node[%s] %dth in data anchor's peer_out_anchor is null", (node->GetName()).c_str(), in_data_anchor_idx);
@@ -163,9 +300,9 @@ graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::
     }
     // Check format whether have been set
     int idx = peer_out_data_anchor->GetIdx();
-    auto ge_tensor_desc = peer_out_data_node->GetOpDesc()->GetOutputDesc(idx);
-    if (ge_tensor_desc.GetOriginFormat() == FORMAT_ND) {
-      auto dim_num = ge_tensor_desc.GetShape().GetDimNum();
+    auto ge_tensor_desc = peer_out_data_node->GetOpDesc()->MutableOutputDesc(idx);
+    if (ge_tensor_desc != nullptr && ge_tensor_desc->GetOriginFormat() == FORMAT_ND) {
+      auto dim_num = ge_tensor_desc->GetShape().GetDimNum();
       if (dim_num == 0) {
         GELOGD("node name:%s idx:%d out is scalar. stop back infer!", peer_out_data_node->GetName().c_str(), idx);
         continue;
@@ -181,9 +318,8 @@ graphStatus FormatRefiner::BackInferProcess(std::deque<ge::NodePtr> &nodes, ge::
         continue;
       }
 
-      ge_tensor_desc.SetOriginFormat(to_be_set_format);
-      ge_tensor_desc.SetFormat(to_be_set_format);
-      (void)peer_out_data_node->GetOpDesc()->UpdateOutputDesc(idx, ge_tensor_desc);
+      ge_tensor_desc->SetOriginFormat(to_be_set_format);
+      ge_tensor_desc->SetFormat(to_be_set_format);
 
       // Call operator infer format api (forward) to get out format
       GELOGD("call infer format func[Back]!Node is [%s] ", (peer_out_data_node->GetName()).c_str());
@@ -206,11 +342,12 @@ graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, g
     GELOGD("Node is [%s] [F]", (node->GetName()).c_str());
     GE_IF_BOOL_EXEC(out_data_anchor == nullptr, continue);
     auto out_data_anchor_idx = out_data_anchor->GetIdx();
-    auto to_be_set_format = (node->GetOpDesc()->GetOutputDesc(out_data_anchor_idx)).GetOriginFormat();
-    if (to_be_set_format == FORMAT_ND) {
+    auto output_desc = node->GetOpDesc()->GetOutputDescPtr(out_data_anchor_idx);
+    if (output_desc == nullptr || output_desc->GetOriginFormat() == FORMAT_ND) {
       GELOGD("Node [%s] format is ND.[F]", (node->GetName()).c_str());
       continue;
     }
+    auto to_be_set_format = output_desc->GetOriginFormat();
     for (const auto &peer_in_data_anchor : out_data_anchor->GetPeerInDataAnchors()) {
       if (peer_in_data_anchor == nullptr) {
         GELOGW("Node[%s] some peer_in_anchor is null", (node->GetName()).c_str());
@@ -223,9 +360,9 @@ graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, g
       }
       // Check format whether have been set
       int idx = peer_in_data_anchor->GetIdx();
-      auto ge_tensor_desc = peer_in_data_node->GetOpDesc()->GetInputDesc(idx);
-      if (ge_tensor_desc.GetOriginFormat() == FORMAT_ND) {
-        auto dim_num = ge_tensor_desc.GetShape().GetDimNum();
+      auto ge_tensor_desc = peer_in_data_node->GetOpDesc()->MutableInputDesc(idx);
+      if (ge_tensor_desc != nullptr && ge_tensor_desc->GetOriginFormat() == FORMAT_ND) {
+        auto dim_num = ge_tensor_desc->GetShape().GetDimNum();
         if (dim_num == 0) {
           GELOGI("node name:%s idx:%d in is scalar. stop forward infer!", peer_in_data_node->GetName().c_str(), idx);
           continue;
@@ -239,9 +376,8 @@ graphStatus FormatRefiner::ForwardInferProcess(std::deque<ge::NodePtr> &nodes, g
           GELOGD("Node[%s] is change dim node. do not infer origin format", (peer_in_data_node->GetName()).c_str());
           continue;
         }
-        ge_tensor_desc.SetOriginFormat(to_be_set_format);
-        ge_tensor_desc.SetFormat(to_be_set_format);
-        (void)peer_in_data_node->GetOpDesc()->UpdateInputDesc(idx, ge_tensor_desc);
+        ge_tensor_desc->SetOriginFormat(to_be_set_format);
+        ge_tensor_desc->SetFormat(to_be_set_format);
 
         /// Because netoutput node added before infer format ,so netoutput is end condition
         /// must set netoutput format , because saved result depend on format
@@ -362,6 +498,12 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
   }
   // Refresh origin format of anchor point
   RefreshOriginFormatOfAnchor(anchor_points);
+  uint32_t thread_num = GetContext().FormatPassThreadNum();
+  if (thread_num > 1) {
+    status = InferOrigineFormatInRegions(graph, anchor_points, data_nodes, thread_num);
+    SetInferOrigineFormatFlag(false);
+    return status;
+  }
   // Infer format process
   for (const auto &anchor_node : anchor_points) {
     if (anchor_node == nullptr) {
@@ -384,4 +526,69 @@ graphStatus FormatRefiner::InferOrigineFormat(const ge::ComputeGraphPtr &graph)
   SetInferOrigineFormatFlag(false);
   return status;
 }
+
+graphStatus FormatRefiner::InferOrigineFormatInRegions(const ge::ComputeGraphPtr &graph,
+                                                       const std::vector<ge::NodePtr> &anchor_points,
+                                                       const std::vector<ge::NodePtr> &data_nodes,
+                                                       uint32_t thread_num) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::vector<std::vector<NodePtr>> region_anchor_points;
+  std::vector<std::vector<NodePtr>> region_data_nodes;
+  GetFormatRegions(graph, anchor_points, data_nodes, region_anchor_points, region_data_nodes);
+
+  // Regions share no node, each region is processed as the serial process does
+  auto data_format = graph->GetDataFormat();
+  std::vector<graphStatus> region_status(region_anchor_points.size(), GRAPH_SUCCESS);
+  std::vector<NodePtr> failed_nodes(region_anchor_points.size());
+  std::atomic<size_t> next_region(0);
+  auto process_regions = [&]() {
+    for (size_t region = next_region++; region < region_anchor_points.size(); region = next_region++) {
+      std::unordered_map<ge::NodePtr, bool> node_status;
+      for (const auto &anchor_node : region_anchor_points[region]) {
+        if (anchor_node == nullptr) {
+          continue;
+        }
+        region_status[region] = AnchorProcess(anchor_node, node_status);
+        if (region_status[region] != GRAPH_SUCCESS) {
+          failed_nodes[region] = anchor_node;
+          break;
+        }
+      }
+      if (region_status[region] == GRAPH_SUCCESS && !region_data_nodes[region].empty()) {
+        region_status[region] = DataNodeFormatProcess(region_data_nodes[region], data_format, node_status);
+      }
+    }
+  };
+
+  size_t worker_num = std::min(static_cast<size_t>(thread_num), region_anchor_points.size());
+  GEThreadLocalContext context = GetThreadLocalContext();
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < worker_num; ++i) {
+    workers.emplace_back([&context, &process_regions]() {
+      GetThreadLocalContext() = context;
+      process_regions();
+    });
+  }
+  process_regions();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // Report the failure of the first region, as the serial process stops at it
+  for (size_t region = 0; region < region_status.size(); ++region) {
+    if (region_status[region] == GRAPH_SUCCESS) {
+      continue;
+    }
+    if (failed_nodes[region] != nullptr) {
+      GELOGE(GRAPH_FAILED, "Anchor node [%s] process failed!", failed_nodes[region]->GetName().c_str());
+    }
+    return GRAPH_FAILED;
+  }
+  auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+  GELOGI("[GEPERFTRACE] InferOrigineFormat of %zu regions with %zu workers, time cost %ld micro second.",
+         region_anchor_points.size(), worker_num, static_cast<int64_t>(cost.count()));
+  GEEVENT("InferOrigineFormat processed %zu anchor points in %zu regions with %u threads.", anchor_points.size(),
+          region_anchor_points.size(), thread_num);
+  return GRAPH_SUCCESS;
+}
 }  // namespace ge
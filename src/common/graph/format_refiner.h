@@ -45,6 +45,9 @@ class FormatRefiner {
                                          std::unordered_map<ge::NodePtr, bool> &node_status);
   static graphStatus DataNodeFormatProcess(std::vector<ge::NodePtr> &data_nodes, ge::Format data_format,
                                            std::unordered_map<ge::NodePtr, bool> &node_status);
+  static graphStatus InferOrigineFormatInRegions(const ge::ComputeGraphPtr &graph,
+                                                 const std::vector<ge::NodePtr> &anchor_points,
+                                                 const std::vector<ge::NodePtr> &data_nodes, uint32_t thread_num);
 };
 }  // namespace ge
 #endif  // COMMON_GRAPH_FORMAT_REFINER_H_
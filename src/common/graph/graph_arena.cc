@@ -0,0 +1,150 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "graph/graph_arena.h"
+
+namespace ge {
+namespace {
+const size_t kArenaAlign = 16;
+// Larger blocks are allocated from heap directly.
+const size_t kMaxPooledSize = 512;
+// Arenas a thread keeps its current chunk for, the rest of an evicted chunk is left unused.
+const size_t kThreadChunkNum = 4;
+
+struct ThreadChunk {
+  uint64_t arena_id = 0;
+  uint8_t *cursor = nullptr;
+  size_t left_size = 0;
+};
+
+thread_local ThreadChunk thread_chunks[kThreadChunkNum];
+thread_local size_t next_evicted_chunk = 0;
+
+// Ids of arenas are never reused, so a chunk of a destroyed arena is never found.
+std::atomic<uint64_t> next_arena_id(1);
+
+inline size_t GetBlockSize(size_t size) { return (size + kArenaAlign - 1) / kArenaAlign * kArenaAlign; }
+
+ThreadChunk &GetThreadChunk(uint64_t arena_id) {
+  for (auto &chunk : thread_chunks) {
+    if (chunk.arena_id == arena_id) {
+      return chunk;
+    }
+  }
+  ThreadChunk &chunk = thread_chunks[next_evicted_chunk];
+  next_evicted_chunk = (next_evicted_chunk + 1) % kThreadChunkNum;
+  chunk.arena_id = arena_id;
+  chunk.cursor = nullptr;
+  chunk.left_size = 0;
+  return chunk;
+}
+}  // namespace
+
+GraphArena::GraphArena(size_t chunk_size)
+    : id_(next_arena_id++),
+      chunk_size_(chunk_size < kMaxPooledSize ? kMaxPooledSize : chunk_size),
+      alloc_count_(0),
+      large_count_(0),
+      used_size_(0) {}
+
+GraphArena::~GraphArena() {
+  for (uint8_t *chunk : chunks_) {
+    delete[] chunk;
+  }
+  chunks_.clear();
+}
+
+void *GraphArena::Allocate(size_t size) {
+  if (size == 0) {
+    size = 1;
+  }
+  if (size > kMaxPooledSize) {
+    void *ptr = new (std::nothrow) uint8_t[size];
+    if (ptr != nullptr) {
+      ++alloc_count_;
+      ++large_count_;
+      used_size_ += size;
+    }
+    return ptr;
+  }
+
+  size_t block_size = GetBlockSize(size);
+  ThreadChunk &chunk = GetThreadChunk(id_);
+  if (chunk.left_size < block_size) {
+    uint8_t *new_chunk = NewChunk();
+    if (new_chunk == nullptr) {
+      return nullptr;
+    }
+    chunk.cursor = new_chunk;
+    chunk.left_size = chunk_size_;
+  }
+  void *ptr = chunk.cursor;
+  chunk.cursor += block_size;
+  chunk.left_size -= block_size;
+  ++alloc_count_;
+  used_size_ += block_size;
+  return ptr;
+}
+
+void GraphArena::Deallocate(void *ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size == 0) {
+    size = 1;
+  }
+  if (size > kMaxPooledSize) {
+    delete[] static_cast<uint8_t *>(ptr);
+    used_size_ -= size;
+    return;
+  }
+  // Memory of the block is released with its chunk.
+  used_size_ -= GetBlockSize(size);
+}
+
+uint8_t *GraphArena::NewChunk() {
+  uint8_t *chunk = new (std::nothrow) uint8_t[chunk_size_];
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  chunks_.push_back(chunk);
+  return chunk;
+}
+
+uint64_t GraphArena::GetAllocCount() const { return alloc_count_; }
+
+uint64_t GraphArena::GetChunkCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return chunks_.size() + large_count_;
+}
+
+size_t GraphArena::GetUsedSize() const { return used_size_; }
+
+std::shared_ptr<GraphArena> &GraphArena::MutableCurrent() {
+  static thread_local std::shared_ptr<GraphArena> current_arena;
+  return current_arena;
+}
+
+const std::shared_ptr<GraphArena> &GraphArena::Current() { return MutableCurrent(); }
+
+GraphArenaScope::GraphArenaScope(const std::shared_ptr<GraphArena> &arena) : prev_arena_(GraphArena::MutableCurrent()) {
+  GraphArena::MutableCurrent() = arena;
+}
+
+GraphArenaScope::~GraphArenaScope() { GraphArena::MutableCurrent() = prev_arena_; }
+}  // namespace ge
@@ -24,6 +24,7 @@
 #include "debug/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/detail/model_serialize_imp.h"
+#include "graph/graph_arena.h"
 #include "proto/ge_ir.pb.h"
 #include "utils/graph_utils.h"
 
@@ -202,20 +203,28 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY bool ModelSerializeImp::Unseriali
 }
 
 bool ModelSerializeImp::UnserializeOpDesc(OpDescPtr &op_desc, proto::OpDef &op_def_proto) {
-  op_desc = std::shared_ptr<OpDesc>(new (std::nothrow) OpDesc(protobuf_owner_, &op_def_proto));
+  const std::shared_ptr<GraphArena> &arena = GraphArena::Current();
+  op_desc = ArenaCreate<OpDesc>(arena, [this, &op_def_proto](void *buffer) {
+    return (buffer == nullptr) ? new (std::nothrow) OpDesc(protobuf_owner_, &op_def_proto)
+                               : new (buffer) OpDesc(protobuf_owner_, &op_def_proto);
+  });
   GE_CHK_BOOL_EXEC(op_desc != nullptr, return false, "op_desc is nullptr.");
 
+  auto create_tensor_desc = [this, &arena](proto::TensorDescriptor *desc_proto) {
+    return ArenaCreate<GeTensorDesc>(arena, [this, desc_proto](void *buffer) {
+      return (buffer == nullptr) ? new (std::nothrow) GeTensorDesc(protobuf_owner_, desc_proto)
+                                 : new (buffer) GeTensorDesc(protobuf_owner_, desc_proto);
+    });
+  };
   // Input tensor
   for (auto &input_desc : *op_def_proto.mutable_input_desc()) {
-    std::shared_ptr<GeTensorDesc> temp_value =
-      std::shared_ptr<GeTensorDesc>(new (std::nothrow) GeTensorDesc(protobuf_owner_, &input_desc));
+    std::shared_ptr<GeTensorDesc> temp_value = create_tensor_desc(&input_desc);
     GE_CHK_BOOL_RET_STATUS(temp_value != nullptr, false, "temp_value is nullptr");
     op_desc->inputs_desc_.push_back(temp_value);
   }
   // Output tensor
   for (auto &output_desc : *op_def_proto.mutable_output_desc()) {
-    std::shared_ptr<GeTensorDesc> temp_value =
-      std::shared_ptr<GeTensorDesc>(new (std::nothrow) GeTensorDesc(protobuf_owner_, &output_desc));
+    std::shared_ptr<GeTensorDesc> temp_value = create_tensor_desc(&output_desc);
     GE_CHK_BOOL_RET_STATUS(temp_value != nullptr, false, "temp_value is nullptr");
     op_desc->outputs_desc_.push_back(temp_value);
   }
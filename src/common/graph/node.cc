@@ -20,7 +20,9 @@
 #include "debug/ge_util.h"
 #include "external/graph/operator_factory.h"
 #include "framework/common/debug/ge_log.h"
+#include "graph/compute_graph.h"
 #include "graph/ge_tensor.h"
+#include "graph/graph_arena.h"
 #include "graph/operator_factory_impl.h"
 #include "graph/shape_refiner.h"
 #include "utils/ge_ir_utils.h"
@@ -62,14 +64,20 @@ Node::~Node() {
   }
 }
 
+std::shared_ptr<GraphArena> Node::GetArena() const {
+  auto owner_graph = owner_graph_.lock();
+  return (owner_graph != nullptr) ? owner_graph->GetArena() : nullptr;
+}
+
 graphStatus Node::Init() {
   if (has_init_) {
     return GRAPH_SUCCESS;
   }
   GE_CHK_BOOL_EXEC(op_ != nullptr, return GRAPH_FAILED, "original OpDesc is nullptr");
+  std::shared_ptr<GraphArena> arena = GetArena();
   size_t size = op_->GetInputsSize();
   for (size_t i = 0; i < size; i++) {
-    std::shared_ptr<InDataAnchor> anchor = ComGraphMakeShared<InDataAnchor>(shared_from_this(), i);
+    std::shared_ptr<InDataAnchor> anchor = ArenaMakeShared<InDataAnchor>(arena, shared_from_this(), i);
     if (anchor == nullptr) {
       GELOGE(GRAPH_FAILED, "Current in_data_anchor is null, malloc shared_ptr failed.");
       return GRAPH_FAILED;
@@ -78,15 +86,15 @@ graphStatus Node::Init() {
   }
   size = op_->GetOutputsSize();
   for (size_t i = 0; i < size; i++) {
-    std::shared_ptr<OutDataAnchor> anchor = ComGraphMakeShared<OutDataAnchor>(shared_from_this(), i);
+    std::shared_ptr<OutDataAnchor> anchor = ArenaMakeShared<OutDataAnchor>(arena, shared_from_this(), i);
     if (anchor == nullptr) {
       GELOGE(GRAPH_FAILED, "Current out_data_anchor is null, malloc shared_ptr failed.");
       return GRAPH_FAILED;
     }
     out_data_anchors_.push_back(anchor);
   }
-  in_control_anchor_ = ComGraphMakeShared<InControlAnchor>(shared_from_this(), -1);
-  out_control_anchor_ = ComGraphMakeShared<OutControlAnchor>(shared_from_this(), -1);
+  in_control_anchor_ = ArenaMakeShared<InControlAnchor>(arena, shared_from_this(), -1);
+  out_control_anchor_ = ArenaMakeShared<OutControlAnchor>(arena, shared_from_this(), -1);
   if (in_control_anchor_ == nullptr || out_control_anchor_ == nullptr) {
     GELOGE(GRAPH_FAILED, "Current in_control_anchor or out_control_anchor is null, malloc shared_ptr failed.");
     return GRAPH_FAILED;
@@ -275,7 +283,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus Node::AddLinkFrom(con
     GELOGE(GRAPH_FAILED, "add input desc failed.");
     return GRAPH_FAILED;
   }
-  std::shared_ptr<InDataAnchor> anchor = ComGraphMakeShared<InDataAnchor>(shared_from_this(), in_data_anchors_.size());
+  std::shared_ptr<InDataAnchor> anchor =
+    ArenaMakeShared<InDataAnchor>(GetArena(), shared_from_this(), in_data_anchors_.size());
   if (anchor == nullptr) {
     GELOGE(GRAPH_FAILED, "out_anchor size is:%zu, malloc shared_ptr failed.", out_anchors.size());
     return GRAPH_FAILED;
@@ -304,7 +313,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus Node::AddLinkFrom(con
     GELOGE(GRAPH_FAILED, "add input desc failed.");
     return GRAPH_FAILED;
   }
-  std::shared_ptr<InDataAnchor> anchor = ComGraphMakeShared<InDataAnchor>(shared_from_this(), in_data_anchors_.size());
+  std::shared_ptr<InDataAnchor> anchor =
+    ArenaMakeShared<InDataAnchor>(GetArena(), shared_from_this(), in_data_anchors_.size());
   if (anchor == nullptr) {
     GELOGE(GRAPH_FAILED, "out_anchor size is:%zu, malloc shared_ptr failed.", out_anchors.size());
     return GRAPH_FAILED;
@@ -325,7 +335,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus Node::AddLinkFromForP
     return GRAPH_PARAM_INVALID;
   }
 
-  std::shared_ptr<InDataAnchor> anchor = ComGraphMakeShared<InDataAnchor>(shared_from_this(), in_data_anchors_.size());
+  std::shared_ptr<InDataAnchor> anchor =
+    ArenaMakeShared<InDataAnchor>(GetArena(), shared_from_this(), in_data_anchors_.size());
   if (anchor == nullptr) {
     GELOGE(GRAPH_FAILED, "out_anchor size is:%zu, make anchor failed", out_anchors.size());
     return GRAPH_FAILED;
@@ -353,7 +364,8 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus Node::AddLinkFrom(con
     GELOGE(GRAPH_FAILED, "add input desc failed.");
     return GRAPH_FAILED;
   }
-  std::shared_ptr<InDataAnchor> anchor = ComGraphMakeShared<InDataAnchor>(shared_from_this(), in_data_anchors_.size());
+  std::shared_ptr<InDataAnchor> anchor =
+    ArenaMakeShared<InDataAnchor>(GetArena(), shared_from_this(), in_data_anchors_.size());
   if (anchor == nullptr) {
     GELOGE(GRAPH_FAILED, "out_anchor size is:%zu, malloc shared_ptr failed.", out_anchors.size());
     return GRAPH_FAILED;
@@ -788,7 +800,11 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus Node::UpdateOpDesc(co
   GE_CHK_BOOL_EXEC(op_->GetOutputsSize() == op_desc->GetOutputsSize(), return GRAPH_PARAM_INVALID,
                    "Outputs count expected to be same, orginial OpDesc %zu, Param OpDesc %zu", op_->GetOutputsSize(),
                    op_desc->GetOutputsSize());
+  bool is_renamed = (op_->GetName() != op_desc->GetName());
   op_ = op_desc;
+  if (is_renamed) {
+    OpDesc::UpdateNameVersion();
+  }
   return GRAPH_SUCCESS;
 }
 
@@ -15,12 +15,16 @@
  */
 
 #include "graph/op_desc.h"
+
+#include <atomic>
+
 #include "debug/ge_attr_define.h"
 #include "debug/ge_util.h"
 #include "external/graph/operator.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_attr_value.h"
 #include "graph/ge_tensor.h"
+#include "graph/graph_arena.h"
 #include "graph/operator_factory_impl.h"
 #include "graph/utils/attr_utils.h"
 #include "graph/utils/ge_ir_utils.h"
@@ -165,10 +169,21 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY string OpDesc::GetName() const {
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY void OpDesc::SetName(const std::string &name) {
   auto proto_msg = op_def_.GetProtoMsg();
   if (proto_msg != nullptr) {
-    proto_msg->set_name(name);
+    if (proto_msg->name() != name) {
+      proto_msg->set_name(name);
+      UpdateNameVersion();
+    }
   }
 }
 
+namespace {
+std::atomic<uint64_t> g_name_version(0);
+}  // namespace
+
+uint64_t OpDesc::GetNameVersion() { return g_name_version.load(std::memory_order_acquire); }
+
+void OpDesc::UpdateNameVersion() { (void)g_name_version.fetch_add(1, std::memory_order_acq_rel); }
+
 GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY string OpDesc::GetType() const {
   auto proto_msg = op_def_.GetProtoMsg();
   if (proto_msg != nullptr) {
@@ -208,7 +223,7 @@ graphStatus OpDesc::AddInputDesc(const string &name, const ge::GeTensorDesc &inp
     return ret;
   } else {
     int index = static_cast<int>(inputs_desc_.size());
-    std::shared_ptr<GeTensorDesc> in_desc = ComGraphMakeShared<GeTensorDesc>(input_desc);
+    std::shared_ptr<GeTensorDesc> in_desc = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), input_desc);
     if (in_desc == nullptr) {
       GELOGE(GRAPH_FAILED, "AddInputDesc failed, malloc shared_ptr failed.");
       return GRAPH_FAILED;
@@ -225,7 +240,7 @@ graphStatus OpDesc::AddInputDescForward(const string &name, const unsigned int n
     GE_CHK_BOOL_RET_STATUS((input_name_idx_.find(input_name) == input_name_idx_.end()), GRAPH_FAILED,
                            "Add input tensor_desc is existed. name[%s]", input_name.c_str());
 
-    std::shared_ptr<GeTensorDesc> in_desc = ComGraphMakeShared<GeTensorDesc>(GeTensorDesc());
+    std::shared_ptr<GeTensorDesc> in_desc = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), GeTensorDesc());
     if (in_desc == nullptr) {
       GELOGE(GRAPH_FAILED, "AddInputDescForward failed, malloc shared_ptr failed.");
       return GRAPH_FAILED;
@@ -250,7 +265,7 @@ graphStatus OpDesc::AddOutputDescForward(const string &name, const unsigned int
     GE_CHK_BOOL_RET_STATUS((output_name_idx_.find(output_name) == output_name_idx_.end()), GRAPH_FAILED,
                            "Add output tensor_desc is existed. name[%s]", output_name.c_str());
 
-    std::shared_ptr<GeTensorDesc> in_desc = ComGraphMakeShared<GeTensorDesc>(GeTensorDesc());
+    std::shared_ptr<GeTensorDesc> in_desc = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), GeTensorDesc());
     if (in_desc == nullptr) {
       GELOGE(GRAPH_FAILED, "AddOutputDescForward failed, malloc shared_ptr failed.");
       return GRAPH_FAILED;
@@ -278,7 +293,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
 OpDesc::UpdateInputDesc(uint32_t index, const ge::GeTensorDesc &tensor_Desc) {
   GE_CHK_BOOL_RET_STATUS((index < inputs_desc_.size()), GRAPH_FAILED, "The index is invalid. index[%u]", index);
 
-  inputs_desc_[index] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
+  inputs_desc_[index] = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), tensor_Desc);
   if (inputs_desc_[index] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateInputDesc failed, malloc shared_ptr failed.");
     return GRAPH_FAILED;
@@ -377,7 +392,7 @@ graphStatus OpDesc::UpdateInputDesc(const string &name, const ge::GeTensorDesc &
   }
   GE_IF_BOOL_EXEC(it->second >= inputs_desc_.size(), GELOGE(GRAPH_FAILED, "it->second is invalid.");
                   return GRAPH_FAILED);
-  inputs_desc_[it->second] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
+  inputs_desc_[it->second] = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), tensor_Desc);
   if (inputs_desc_[it->second] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateInputDesc failed, malloc shared_ptr failed.");
     return GRAPH_FAILED;
@@ -493,7 +508,7 @@ graphStatus OpDesc::AddOutputDesc(const string &name, const ge::GeTensorDesc &ou
                          "Add output tensor_Desc is existed. name[%s]", name.c_str());
   int index = static_cast<int>(outputs_desc_.size());
 
-  std::shared_ptr<GeTensorDesc> tensor = ComGraphMakeShared<GeTensorDesc>(output_desc);
+  std::shared_ptr<GeTensorDesc> tensor = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), output_desc);
   if (tensor == nullptr) {
     GELOGE(GRAPH_FAILED, "AddOutputDesc failed, malloc shared_ptr failed.");
     return GRAPH_FAILED;
@@ -507,7 +522,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus
 OpDesc::UpdateOutputDesc(uint32_t index, const ge::GeTensorDesc &tensor_Desc) {
   GE_CHK_BOOL_RET_STATUS((index < outputs_desc_.size()), GRAPH_FAILED, "The index is invalid. index[%u]", index);
 
-  outputs_desc_[index] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
+  outputs_desc_[index] = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), tensor_Desc);
   if (outputs_desc_[index] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateOutputDesc failed, malloc shared_ptr failed.");
     return GRAPH_FAILED;
@@ -523,7 +538,7 @@ graphStatus OpDesc::UpdateOutputDesc(const string &name, const ge::GeTensorDesc
   }
   GE_IF_BOOL_EXEC(it->second >= outputs_desc_.size(), GELOGE(GRAPH_FAILED, "it->second is invalid.");
                   return GRAPH_FAILED);
-  outputs_desc_[it->second] = ComGraphMakeShared<GeTensorDesc>(tensor_Desc);
+  outputs_desc_[it->second] = ArenaMakeShared<GeTensorDesc>(GraphArena::Current(), tensor_Desc);
   if (outputs_desc_[it->second] == nullptr) {
     GELOGE(GRAPH_FAILED, "UpdateOutputDesc failed, malloc shared_ptr failed.");
     return GRAPH_FAILED;
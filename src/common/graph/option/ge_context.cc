@@ -16,14 +16,18 @@
 
 #include "./ge_context.h"
 
+#include <algorithm>
+
 #include "./ge_global_options.h"
 #include "./ge_local_context.h"
 #include "framework/common/debug/ge_log.h"
+#include "ge/ge_api_types.h"
 
 namespace ge {
 namespace {
 const int64_t kMinTrainingTraceJobId = 256;
 const int kDecimal = 10;
+const int64_t kMaxFormatPassThreadNum = 64;
 }  // namespace
 GEContext &GetContext() {
   static GEContext ge_context{};
@@ -87,4 +91,16 @@ uint32_t GEContext::DeviceId() { return device_id_; }
 uint64_t GEContext::TraceId() { return trace_id_; }
 
 void GEContext::SetCtxDeviceId(uint32_t device_id) { device_id_ = device_id; }
+
+uint32_t GEContext::FormatPassThreadNum() {
+  string thread_num_str;
+  if (GetOption(FORMAT_PASS_THREAD_NUM, thread_num_str) != GRAPH_SUCCESS || thread_num_str.empty()) {
+    return 1;
+  }
+  int64_t thread_num = std::strtol(thread_num_str.c_str(), nullptr, kDecimal);
+  if (thread_num <= 1) {
+    return 1;
+  }
+  return static_cast<uint32_t>(std::min<int64_t>(thread_num, kMaxFormatPassThreadNum));
+}
 }  // namespace ge
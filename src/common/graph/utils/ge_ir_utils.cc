@@ -757,12 +757,11 @@ bool OnnxUtils::DecodeNodeLinkImp(const NodeLinkInfo &item, NodePtr &node_ptr) {
   return true;
 }
 
-bool OnnxUtils::DecodeNodeLink(const std::vector<onnx::NodeProto> &node_proto_vector,
-                               const std::map<std::string, NodePtr> &node_map) {
+bool OnnxUtils::DecodeNodeLink(const std::vector<onnx::NodeProto> &node_proto_vector, const ComputeGraphPtr &graph) {
   for (const auto &node_proto : node_proto_vector) {
     const auto &node_name = node_proto.name();
-    auto dst_node = node_map.find(node_name);
-    if ((dst_node == node_map.end()) || (dst_node->second == nullptr)) {
+    auto dst_node = graph->FindNode(node_name);
+    if (dst_node == nullptr) {
       GELOGE(GRAPH_FAILED, "destination node: %s find failed or is nullptr", node_name.c_str());
       return false;
     }
@@ -771,15 +770,10 @@ bool OnnxUtils::DecodeNodeLink(const std::vector<onnx::NodeProto> &node_proto_ve
       std::string input_node_name;
       int32_t index = 0;
       if (ParseNameIndex(input, input_node_name, index)) {
-        auto item = NodeLinkInfo{input_node_name, index, dst_node->second, dst_index, node_proto.name()};
-        auto src_node = node_map.find(input_node_name);
-        if (src_node == node_map.end()) {
-          GELOGE(GRAPH_FAILED, "find src node: %s failed", input_node_name.c_str());
-          return false;
-        }
-        auto node_ptr = src_node->second;
+        auto item = NodeLinkInfo{input_node_name, index, dst_node, dst_index, node_proto.name()};
+        auto node_ptr = graph->FindNode(input_node_name);
         if (node_ptr == nullptr) {
-          GELOGE(GRAPH_FAILED, "src node: %s is nullptr", input_node_name.c_str());
+          GELOGE(GRAPH_FAILED, "find src node: %s failed", input_node_name.c_str());
           return false;
         }
         if (!DecodeNodeLinkImp(item, node_ptr)) {
@@ -976,7 +970,6 @@ bool OnnxUtils::DecodeGraph(int recursion_depth, const onnx::GraphProto &graph_p
   }
   /// 1. Decode all nodes first, node should include input
   /// and output nodes and nodes which represent sub graphs
-  std::map<std::string, NodePtr> node_map;
   std::vector<onnx::NodeProto> node_proto_vector;
   for (const auto &node_proto : graph_proto.node()) {
     // a. nodes represent sub graphs
@@ -1001,13 +994,15 @@ bool OnnxUtils::DecodeGraph(int recursion_depth, const onnx::GraphProto &graph_p
         GELOGE(GRAPH_FAILED, "Decode node desc %s failed ", node_proto.name().c_str());
         return false;
       }
-      auto node = graph->AddNode(op_desc);
-      node_map.insert(std::make_pair(node_proto.name(), node));
+      if (graph->AddNode(op_desc) == nullptr) {
+        GELOGE(GRAPH_FAILED, "Add node %s failed", node_proto.name().c_str());
+        return false;
+      }
     }
   }
   /// We get all nodes in graph here
   /// b.2 For node link
-  if (!DecodeNodeLink(node_proto_vector, node_map)) {
+  if (!DecodeNodeLink(node_proto_vector, graph)) {
     GELOGE(GRAPH_FAILED, "Decode node link failed");
     return false;
   }
@@ -1015,23 +1010,23 @@ bool OnnxUtils::DecodeGraph(int recursion_depth, const onnx::GraphProto &graph_p
   // 2. Add inputs nodes for graph
   for (const auto &input : graph_proto.input()) {
     const auto &input_node_name = input.name();
-    auto input_node_item = node_map.find(input_node_name);
-    if (input_node_item == node_map.end()) {
+    auto input_node = graph->FindNode(input_node_name);
+    if (input_node == nullptr) {
       GELOGE(GRAPH_FAILED, "cannot find graph's input node %s in node_", input_node_name.c_str());
       return false;
     }
-    auto ret = graph->AddInputNode(input_node_item->second);
+    auto ret = graph->AddInputNode(input_node);
     GE_CHK_BOOL_EXEC(ret != nullptr, continue, "Add inputnode failed");
   }
   // 3. Add outputs nodes for graph
   for (const auto &output : graph_proto.output()) {
     const auto &output_node_name = output.name();
-    auto output_node_item = node_map.find(output_node_name);
-    if (output_node_item == node_map.end()) {
+    auto output_node = graph->FindNode(output_node_name);
+    if (output_node == nullptr) {
       GELOGE(GRAPH_FAILED, "cannot find graph's output node %s in node_", output_node_name.c_str());
       return false;
     }
-    auto ret = graph->AddOutputNode(output_node_item->second);
+    auto ret = graph->AddOutputNode(output_node);
     if (ret == nullptr) {
       GELOGW("Add outputnode failed,out put node is %s", output_node_name.c_str());
       continue;
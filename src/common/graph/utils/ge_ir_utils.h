@@ -180,8 +180,7 @@ class OnnxUtils {
 
   static bool DecodeNodeLinkImp(const NodeLinkInfo &item, NodePtr &node_ptr);
 
-  static bool DecodeNodeLink(const std::vector<onnx::NodeProto> &node_proto_vector,
-                             const std::map<std::string, NodePtr> &node_map);
+  static bool DecodeNodeLink(const std::vector<onnx::NodeProto> &node_proto_vector, const ComputeGraphPtr &graph);
 
   static bool DecodeNodeDesc(const onnx::NodeProto *node_proto, OpDescPtr &node);
 
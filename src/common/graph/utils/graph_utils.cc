@@ -206,6 +206,7 @@ GraphUtils::RemoveNodeWithoutRelink(const ComputeGraphPtr &compute_graph, const
   auto iter = find(compute_graph->nodes_.begin(), compute_graph->nodes_.end(), node);
   if (iter != compute_graph->nodes_.end()) {
     compute_graph->nodes_.erase(iter);
+    compute_graph->InvalidateNodeIndex();
     return GRAPH_SUCCESS;
   }
   return GRAPH_FAILED;
@@ -318,6 +319,7 @@ GE_FUNC_DEV_VISIBILITY GE_FUNC_HOST_VISIBILITY graphStatus GraphUtils::RemoveJus
   auto iter = find(compute_graph.nodes_.begin(), compute_graph.nodes_.end(), node);
   if (iter != compute_graph.nodes_.end()) {
     compute_graph.nodes_.erase(iter);
+    compute_graph.InvalidateNodeIndex();
     return GRAPH_SUCCESS;
   }
   return GRAPH_FAILED;
@@ -19,10 +19,13 @@
 #include <fcntl.h>
 #include <securec.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <future>
 #include <vector>
 
+#include "common/thread_pool.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/debug/log.h"
 #include "framework/common/util.h"
@@ -32,6 +35,11 @@ const int kFileOpSuccess = 0;
 const char TEE_PASSCODE_FILE_SUFFIX[] = ".PASSCODE";
 const char TEE_DAVINCI_FILE_SUFFIX[] = ".om";
 const size_t TEE_DAVINCI_FILE_SUFFIX_SIZE = 3;
+// Partitions larger than one chunk are written by several threads, one chunk per write
+const size_t kWriteChunkSize = 64 * 1024 * 1024;
+const uint32_t kWriteThreadNum = 4;
+// Size of one mmWrite, which takes the size in 32 bits
+const size_t kMaxWriteSize = 1024 * 1024 * 1024;
 }  //  namespace
 
 namespace ge {
@@ -70,6 +78,75 @@ Status FileSaver::WriteData(const void *data, uint32_t size, int32_t fd) {
   return SUCCESS;
 }
 
+Status FileSaver::WriteDataAt(const void *data, size_t size, int64_t offset, int32_t fd) {
+  GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(size == 0 || data == nullptr || offset < 0, return PARAM_INVALID);
+
+  if (mmLseek(fd, offset, SEEK_SET) != offset) {
+    GELOGE(FAILED, "Seek to offset %ld failed.", offset);
+    return FAILED;
+  }
+  auto pos = static_cast<uint8_t *>(const_cast<void *>(data));
+  while (size > 0) {
+    uint32_t write_size = static_cast<uint32_t>(std::min<size_t>(size, kMaxWriteSize));
+    mmSsize_t write_count = mmWrite(fd, pos, write_size);
+    // -1: Failed to write to file; - 2: Illegal parameter
+    if (write_count == EN_INVALID_PARAM || write_count == EN_ERROR) {
+      GELOGE(FAILED, "Write data at offset %ld failed. mmpa_errorno = %ld", offset, write_count);
+      return FAILED;
+    }
+    if (write_count == 0) {
+      GELOGE(FAILED, "Write data at offset %ld failed, no data is written.", offset);
+      return FAILED;
+    }
+    pos += write_count;
+    size -= static_cast<size_t>(write_count);
+    offset += write_count;
+  }
+  return SUCCESS;
+}
+
+Status FileSaver::WriteChunkAt(const void *data, size_t size, int64_t offset, const std::string &file_path) {
+  // Each chunk has its own fd, as the file offset of a fd is shared by threads
+  int32_t fd = mmOpen2(file_path.c_str(), O_WRONLY, S_IRUSR | S_IWUSR);
+  if (fd == EN_INVALID_PARAM || fd == EN_ERROR) {
+    GELOGE(FAILED, "Open file to write chunk failed. mmpa_errno = %d", fd);
+    return FAILED;
+  }
+  Status ret = WriteDataAt(data, size, offset, fd);
+  GE_CHK_BOOL_RET_STATUS(mmClose(fd) == EN_OK, FAILED, "Close file failed.");
+  return ret;
+}
+
+Status FileSaver::WritePartitionAt(const ModelPartition &partition, int64_t offset, const std::string &file_path,
+                                   int32_t fd) {
+  if (partition.size <= kWriteChunkSize) {
+    return WriteDataAt(partition.data, partition.size, offset, fd);
+  }
+
+  size_t chunk_num = (partition.size + kWriteChunkSize - 1) / kWriteChunkSize;
+  ThreadPool thread_pool(static_cast<uint32_t>(std::min<size_t>(kWriteThreadNum, chunk_num)));
+  std::vector<std::future<Status>> futures;
+  for (size_t i = 0; i < chunk_num; ++i) {
+    size_t chunk_offset = i * kWriteChunkSize;
+    size_t chunk_size = std::min<size_t>(kWriteChunkSize, partition.size - chunk_offset);
+    std::future<Status> f = thread_pool.commit(WriteChunkAt, partition.data + chunk_offset, chunk_size,
+                                               offset + static_cast<int64_t>(chunk_offset), file_path);
+    if (!f.valid()) {
+      GELOGE(FAILED, "Commit write task of chunk %zu failed.", i);
+      return FAILED;
+    }
+    futures.emplace_back(std::move(f));
+  }
+
+  Status ret = SUCCESS;
+  for (auto &f : futures) {
+    if (f.get() != SUCCESS) {
+      ret = FAILED;
+    }
+  }
+  return ret;
+}
+
 Status FileSaver::SaveWithFileHeader(const std::string &file_path, const ModelFileHeader &file_header, const void *data,
                                      int len) {
   if (data == nullptr || len <= 0) {
@@ -110,19 +187,24 @@ Status FileSaver::SaveWithFileHeader(const std::string &file_path, const ModelFi
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(OpenFile(fd, file_path) != SUCCESS, return FAILED);
   Status ret = SUCCESS;
   do {
-    // Write file header
-    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
-      WriteData(static_cast<const void *>(&file_header), sizeof(ModelFileHeader), fd) != SUCCESS, ret = FAILED; break);
-    // Write model partition table
+    // Write partition data at their offsets first, header and partition table are patched at the end,
+    // so a file which is not completely written never has a valid header
     uint32_t table_size = static_cast<uint32_t>(SIZE_OF_MODEL_PARTITION_TABLE(model_partition_table));
-    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
-      WriteData(static_cast<const void *>(&model_partition_table), table_size, fd) != SUCCESS, ret = FAILED; break);
-    // Write partition data
+    int64_t offset = static_cast<int64_t>(sizeof(ModelFileHeader)) + table_size;
     for (const auto &partition_data : partition_datas) {
-      GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
-        WriteData(static_cast<const void *>(partition_data.data), partition_data.size, fd) != SUCCESS, ret = FAILED;
-        break);
+      GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(WritePartitionAt(partition_data, offset, file_path, fd) != SUCCESS, ret = FAILED; break);
+      offset += partition_data.size;
     }
+    GE_IF_BOOL_EXEC(ret != SUCCESS, break);
+    // Write model partition table
+    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(WriteDataAt(static_cast<const void *>(&model_partition_table), table_size,
+                                               static_cast<int64_t>(sizeof(ModelFileHeader)), fd) != SUCCESS,
+                                   ret = FAILED;
+                                   break);
+    // Write file header
+    GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
+      WriteDataAt(static_cast<const void *>(&file_header), sizeof(ModelFileHeader), 0, fd) != SUCCESS, ret = FAILED;
+      break);
   } while (0);
   // Close file
   GE_CHK_BOOL_RET_STATUS(mmClose(fd) == EN_OK, FAILED, "Close file failed.");
@@ -195,4 +277,21 @@ FileSaver::SaveToFile(const string &file_path, ModelFileHeader &file_header, Mod
                          file_path.c_str(), file_header.length);
   return SUCCESS;
 }
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status FileSaver::SaveToFile(const string &file_path, const void *data,
+                                                                              size_t len) {
+  if (file_path.empty() || data == nullptr || len == 0) {
+    GELOGE(FAILED, "Incorrected input param. file_path.empty() || data == nullptr || len == 0");
+    return FAILED;
+  }
+
+  int32_t fd = 0;
+  GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(OpenFile(fd, file_path) != SUCCESS, return FAILED, "OpenFile FAILED");
+  Status ret = WriteDataAt(data, len, 0, fd);
+  if (ret != SUCCESS) {
+    GELOGE(FAILED, "Save file failed, file_path:%s, len:%zu.", file_path.c_str(), len);
+  }
+  GE_CHK_BOOL_RET_STATUS(mmClose(fd) == EN_OK, FAILED, "Close file failed.");
+  return ret;
+}
 }  //  namespace ge
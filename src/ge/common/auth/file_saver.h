@@ -73,6 +73,13 @@ class FileSaver {
                            ModelPartitionTable &model_partition_table,
                            const std::vector<ModelPartition> &partition_datas);
 
+  /**
+   * @ingroup domi_common
+   * @brief save data to file as it is
+   * @return Status  result
+   */
+  static Status SaveToFile(const string &file_path, const void *data, size_t len);
+
  protected:
   /**
    * @ingroup domi_common
@@ -85,6 +92,29 @@ class FileSaver {
 
   static Status OpenFile(int32_t &fd, const std::string &file_path);
 
+  /**
+   * @ingroup domi_common
+   * @brief write data at offset of file, partial writes are continued until all data is written
+   *        The file offset of fd is moved, so fd must not be written by other threads at the same time
+   * @return Status  result
+   */
+  static Status WriteDataAt(const void *data, size_t size, int64_t offset, int32_t fd);
+
+  /**
+   * @ingroup domi_common
+   * @brief write data at offset of file opened again, so chunks can be written by threads concurrently
+   * @return Status  result
+   */
+  static Status WriteChunkAt(const void *data, size_t size, int64_t offset, const std::string &file_path);
+
+  /**
+   * @ingroup domi_common
+   * @brief write partition at offset of file, large partition is split into chunks written concurrently
+   * @return Status  result
+   */
+  static Status WritePartitionAt(const ModelPartition &partition, int64_t offset, const std::string &file_path,
+                                 int32_t fd);
+
   /**
    * @ingroup domi_common
    * @brief save model to file
@@ -0,0 +1,210 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/build_tracer.h"
+
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+#include "framework/common/debug/ge_log.h"
+#include "mmpa/mmpa_api.h"
+
+namespace ge {
+namespace {
+int32_t GetThreadId() {
+  static thread_local int32_t tid = static_cast<int32_t>(mmGetTid());
+  return tid;
+}
+
+void AppendEscaped(const std::string &str, std::string &json) {
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        json += "\\\"";
+        break;
+      case '\\':
+        json += "\\\\";
+        break;
+      case '\n':
+        json += "\\n";
+        break;
+      case '\t':
+        json += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8] = {0};
+          (void)snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+          json += buf;
+        } else {
+          json += c;
+        }
+        break;
+    }
+  }
+}
+
+void AppendKey(const char *key, std::string &args) {
+  if (!args.empty()) {
+    args += ',';
+  }
+  args += '"';
+  AppendEscaped(key, args);
+  args += "\":";
+}
+}  // namespace
+
+std::atomic<bool> BuildTracer::enabled_(false);
+
+BuildTracer &BuildTracer::Instance() {
+  static BuildTracer instance;
+  return instance;
+}
+
+void BuildTracer::Start(const std::string &file) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    file_ = file;
+  }
+  dropped_num_.store(0, std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+  GELOGI("Build trace started, file: %s.", file.c_str());
+}
+
+Status BuildTracer::Stop() {
+  if (!enabled_.exchange(false)) {
+    return SUCCESS;
+  }
+  std::string file;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file = file_;
+  }
+  if (file.empty()) {
+    return SUCCESS;
+  }
+  return Save(file);
+}
+
+void BuildTracer::AddSpan(const std::string &name, uint64_t start_us, uint64_t end_us, const std::string &args) {
+  TraceEvent event;
+  event.phase = 'X';
+  event.name = name;
+  event.timestamp = start_us;
+  event.duration = (end_us > start_us) ? (end_us - start_us) : 0;
+  event.tid = GetThreadId();
+  event.args = args;
+  AddEvent(std::move(event));
+}
+
+void BuildTracer::AddCounter(const std::string &name, int64_t value) {
+  TraceEvent event;
+  event.phase = 'C';
+  event.name = name;
+  event.timestamp = GetCurrentTimestap();
+  event.tid = GetThreadId();
+  AppendKey("value", event.args);
+  event.args += std::to_string(value);
+  AddEvent(std::move(event));
+}
+
+void BuildTracer::AddEvent(TraceEvent &&event) {
+  if (!IsEnabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (events_.size() >= kMaxEventNum) {
+    dropped_num_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  events_.emplace_back(std::move(event));
+}
+
+void BuildTracer::ToJson(std::string &json) {
+  const std::string pid = std::to_string(getpid());
+  json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"args\":{\"name\":\"GraphEngine\"}}";
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &event : events_) {
+    json += ",{\"name\":\"";
+    AppendEscaped(event.name, json);
+    json += "\",\"cat\":\"ge\",\"ph\":\"";
+    json += event.phase;
+    json += "\",\"ts\":" + std::to_string(event.timestamp);
+    if (event.phase == 'X') {
+      json += ",\"dur\":" + std::to_string(event.duration);
+    }
+    json += ",\"pid\":" + pid + ",\"tid\":" + std::to_string(event.tid);
+    json += ",\"args\":{" + event.args + "}}";
+  }
+  json += "]}\n";
+}
+
+Status BuildTracer::Save(const std::string &file) {
+  std::string json;
+  ToJson(json);
+  std::ofstream ofs(file, std::ios::out | std::ios::trunc);
+  if (!ofs.is_open()) {
+    GELOGE(FAILED, "Open build trace file %s failed.", file.c_str());
+    return FAILED;
+  }
+  ofs << json;
+  ofs.close();
+  if (ofs.fail()) {
+    GELOGE(FAILED, "Write build trace file %s failed.", file.c_str());
+    return FAILED;
+  }
+  GEEVENT("Build trace of %zu events is written to %s, dropped %lu.", GetEventNum(), file.c_str(), GetDroppedNum());
+  return SUCCESS;
+}
+
+void BuildTracer::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  dropped_num_.store(0, std::memory_order_relaxed);
+}
+
+size_t BuildTracer::GetEventNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_.size();
+}
+
+void TraceScope::AddArg(const char *key, int64_t value) {
+  if (!active_) {
+    return;
+  }
+  AppendKey(key, args_);
+  args_ += std::to_string(value);
+}
+
+void TraceScope::AddArg(const char *key, const std::string &value) {
+  if (!active_) {
+    return;
+  }
+  AppendKey(key, args_);
+  args_ += '"';
+  AppendEscaped(value, args_);
+  args_ += '"';
+}
+
+void TraceBuildStage(const char *stage_name, uint64_t start_us, uint64_t end_us) {
+  if (BuildTracer::IsEnabled() && stage_name != nullptr) {
+    BuildTracer::Instance().AddSpan(stage_name, start_us, end_us);
+  }
+}
+}  // namespace ge
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_COMMON_BUILD_TRACER_H_
+#define GE_COMMON_BUILD_TRACER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+#include "framework/common/util.h"
+
+namespace ge {
+struct TraceEvent {
+  // 'X' for a complete span, 'C' for a counter
+  char phase = 'X';
+  std::string name;
+  uint64_t timestamp = 0;
+  uint64_t duration = 0;
+  int32_t tid = 0;
+  // Rendered json members of args, without braces
+  std::string args;
+};
+
+///
+/// @ingroup ge
+/// @brief Tracer of build phases. Spans and counters recorded while enabled are written as Chrome trace json, which
+///        can be opened by chrome://tracing or Perfetto. Nothing is recorded and scopes cost one atomic load when
+///        disabled.
+///
+class BuildTracer {
+ public:
+  static BuildTracer &Instance();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  ///
+  /// @ingroup ge
+  /// @brief start recording, events recorded before are cleared
+  /// @param [in] file file written by Stop, nothing is written if empty
+  ///
+  void Start(const std::string &file);
+
+  // Stop recording and write events to the file given to Start.
+  Status Stop();
+
+  void AddSpan(const std::string &name, uint64_t start_us, uint64_t end_us, const std::string &args = "");
+  void AddCounter(const std::string &name, int64_t value);
+
+  void ToJson(std::string &json);
+  Status Save(const std::string &file);
+  void Clear();
+
+  size_t GetEventNum();
+  uint64_t GetDroppedNum() const { return dropped_num_.load(std::memory_order_relaxed); }
+
+  static const size_t kMaxEventNum = 1000000;
+
+ private:
+  BuildTracer() = default;
+  ~BuildTracer() = default;
+
+  void AddEvent(TraceEvent &&event);
+
+  static std::atomic<bool> enabled_;
+
+  std::mutex mutex_;
+  std::vector<TraceEvent> events_;
+  std::string file_;
+  std::atomic<uint64_t> dropped_num_{0};
+};
+
+///
+/// @ingroup ge
+/// @brief Span from construction to destruction on the calling thread, spans of a thread nest by time
+///
+class TraceScope {
+ public:
+  explicit TraceScope(const char *name) : active_(BuildTracer::IsEnabled()) {
+    if (active_) {
+      name_ = name;
+      start_ = GetCurrentTimestap();
+    }
+  }
+
+  explicit TraceScope(const std::string &name) : active_(BuildTracer::IsEnabled()) {
+    if (active_) {
+      name_ = name;
+      start_ = GetCurrentTimestap();
+    }
+  }
+
+  ~TraceScope() {
+    if (active_) {
+      BuildTracer::Instance().AddSpan(name_, start_, GetCurrentTimestap(), args_);
+    }
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  bool IsActive() const { return active_; }
+
+  // Args are shown with the span
+  void AddArg(const char *key, int64_t value);
+  void AddArg(const char *key, const std::string &value);
+
+ private:
+  bool active_;
+  std::string name_;
+  uint64_t start_ = 0;
+  std::string args_;
+};
+}  // namespace ge
+
+#define GE_TRACE_SCOPE(stage, name) ge::TraceScope trace_scope_##stage(name)
+
+#define GE_TRACE_ARG(stage, key, value)           \
+  do {                                            \
+    if (trace_scope_##stage.IsActive()) {         \
+      trace_scope_##stage.AddArg((key), (value)); \
+    }                                             \
+  } while (0)
+
+#define GE_TRACE_COUNTER(name, value)                          \
+  do {                                                         \
+    if (ge::BuildTracer::IsEnabled()) {                        \
+      ge::BuildTracer::Instance().AddCounter((name), (value)); \
+    }                                                          \
+  } while (0)
+
+#endif  // GE_COMMON_BUILD_TRACER_H_
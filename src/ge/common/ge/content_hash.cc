@@ -0,0 +1,122 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "common/ge/content_hash.h"
+
+#include <cstring>
+
+namespace ge {
+namespace {
+const uint64_t kPrime64First = 11400714785074694791ULL;
+const uint64_t kPrime64Second = 14029467366897019727ULL;
+const uint64_t kPrime64Third = 1609587929392839161ULL;
+const uint64_t kPrime64Fourth = 9650029242287828579ULL;
+const uint64_t kPrime64Fifth = 2870177450012600261ULL;
+const size_t kStripeSize = 32;
+// Seed of the check hash in digest, any value other than 0 works.
+const uint64_t kCheckSeed = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t RotateLeft(uint64_t value, uint32_t bits) { return (value << bits) | (value >> (64 - bits)); }
+
+inline uint64_t Read64(const uint8_t *data) {
+  uint64_t value = 0;
+  (void)memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint32_t Read32(const uint8_t *data) {
+  uint32_t value = 0;
+  (void)memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime64Second;
+  acc = RotateLeft(acc, 31);
+  return acc * kPrime64First;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+  acc ^= Round(0, value);
+  return acc * kPrime64First + kPrime64Fourth;
+}
+}  // namespace
+
+uint64_t ContentHash::Hash64(const uint8_t *data, size_t size, uint64_t seed) {
+  const uint8_t *ptr = data;
+  const uint8_t *end = (data == nullptr) ? data : data + size;
+  if (data == nullptr) {
+    size = 0;
+  }
+
+  uint64_t hash = 0;
+  if (size >= kStripeSize) {
+    uint64_t v1 = seed + kPrime64First + kPrime64Second;
+    uint64_t v2 = seed + kPrime64Second;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - kPrime64First;
+    const uint8_t *limit = end - kStripeSize;
+    do {
+      v1 = Round(v1, Read64(ptr));
+      v2 = Round(v2, Read64(ptr + 8));
+      v3 = Round(v3, Read64(ptr + 16));
+      v4 = Round(v4, Read64(ptr + 24));
+      ptr += kStripeSize;
+    } while (ptr <= limit);
+
+    hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  } else {
+    hash = seed + kPrime64Fifth;
+  }
+  hash += static_cast<uint64_t>(size);
+
+  while (ptr + sizeof(uint64_t) <= end) {
+    hash ^= Round(0, Read64(ptr));
+    hash = RotateLeft(hash, 27) * kPrime64First + kPrime64Fourth;
+    ptr += sizeof(uint64_t);
+  }
+  if (ptr + sizeof(uint32_t) <= end) {
+    hash ^= static_cast<uint64_t>(Read32(ptr)) * kPrime64First;
+    hash = RotateLeft(hash, 23) * kPrime64Second + kPrime64Third;
+    ptr += sizeof(uint32_t);
+  }
+  while (ptr < end) {
+    hash ^= static_cast<uint64_t>(*ptr) * kPrime64Fifth;
+    hash = RotateLeft(hash, 11) * kPrime64First;
+    ++ptr;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime64Second;
+  hash ^= hash >> 29;
+  hash *= kPrime64Third;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+ContentDigest ContentHash::Digest(const uint8_t *data, size_t size) {
+  ContentDigest digest;
+  digest.hash = Hash64(data, size);
+  digest.check = Hash64(data, size, kCheckSeed);
+  digest.size = (data == nullptr) ? 0 : size;
+  return digest;
+}
+}  // namespace ge
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_COMMON_GE_CONTENT_HASH_H_
+#define GE_COMMON_GE_CONTENT_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/fmk_types.h"
+
+namespace ge {
+///
+/// Digest of a buffer content, two 64-bit hashes with independent seeds and the size.
+/// Buffers are regarded as the same if digests are equal, when the content can not be compared directly.
+///
+struct ContentDigest {
+  uint64_t hash = 0;
+  uint64_t check = 0;
+  size_t size = 0;
+
+  bool operator==(const ContentDigest &other) const {
+    return (hash == other.hash) && (check == other.check) && (size == other.size);
+  }
+  bool operator!=(const ContentDigest &other) const { return !(*this == other); }
+};
+
+struct ContentDigestHasher {
+  size_t operator()(const ContentDigest &digest) const { return static_cast<size_t>(digest.hash); }
+};
+
+class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ContentHash {
+ public:
+  ///
+  /// @ingroup ge
+  /// @brief 64-bit xxHash of data, which processes 32 bytes per round.
+  /// @param [in] data: data to hash, may be null only if size is 0.
+  /// @param [in] size: size of data in bytes.
+  /// @param [in] seed: seed of the hash.
+  /// @return hash value
+  ///
+  static uint64_t Hash64(const uint8_t *data, size_t size, uint64_t seed = 0);
+
+  static ContentDigest Digest(const uint8_t *data, size_t size);
+};
+}  // namespace ge
+#endif  // GE_COMMON_GE_CONTENT_HASH_H_
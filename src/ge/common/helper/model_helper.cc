@@ -16,6 +16,8 @@
 
 #include "framework/common/helper/model_helper.h"
 
+#include <sys/resource.h>
+
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/debug/log.h"
@@ -62,7 +64,17 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::SaveToOmMod
     GELOGE(FAILED, "GraphBuilder SaveModel received invalid file name prefix");
     return FAILED;
   }
+  return SaveToOm(ge_model, save_param, output_file, nullptr);
+}
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::SaveToOmBuffer(const GeModelPtr &ge_model,
+                                                                                    std::vector<uint8_t> &om_buffer) {
+  SaveParam save_param;
+  return SaveToOm(ge_model, save_param, "", &om_buffer);
+}
 
+Status ModelHelper::SaveToOm(const GeModelPtr &ge_model, const SaveParam &save_param, const std::string &output_file,
+                             std::vector<uint8_t> *om_buffer) {
   GE_IF_BOOL_EXEC(ge_model == nullptr, GELOGE(FAILED, "Ge_model is nullptr"); return FAILED);
   std::shared_ptr<OmFileSaveHelper> om_file_save_helper = ge::MakeShared<OmFileSaveHelper>();
   GE_CHECK_NOTNULL(om_file_save_helper);
@@ -159,11 +171,19 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::SaveToOmMod
   string model_name = reinterpret_cast<char *>(model_header.name);
   GELOGI("Model name save:%s", model_name.c_str());
 
+  if (om_buffer != nullptr) {
+    return om_file_save_helper->SaveModelToBuffer(*om_buffer);
+  }
   Status ret = om_file_save_helper->SaveModel(save_param, output_file.c_str());
   if (ret != SUCCESS) {
     GELOGE(FAILED, "OmFileSaveHelper SaveModel return fail.");
     return FAILED;
   }
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    GEEVENT("[GEPERFTRACE] The peak RSS after saving model %s is %ld KB, weight size is %zu.", model_name.c_str(),
+            usage.ru_maxrss, ge_model_weight.GetSize());
+  }
   return SUCCESS;
 }
 
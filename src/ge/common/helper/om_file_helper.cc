@@ -214,4 +214,34 @@ Status OmFileSaveHelper::SaveModelToFile(const char *output_file) {
   return SUCCESS;
 #endif
 }
+
+Status OmFileSaveHelper::SaveModelToBuffer(std::vector<uint8_t> &om_buffer) {
+  uint32_t model_data_len = context_.model_data_len_;
+  if (model_data_len == 0) {
+    GELOGE(domi::PARAM_INVALID, "Model data len error! should not be 0");
+    return domi::PARAM_INVALID;
+  }
+
+  ModelPartitionTable *partition_table = GetPartitionTable();
+  if (partition_table == nullptr) {
+    GELOGE(ge::GE_GRAPH_SAVE_FAILED, "SaveModelToBuffer exe failed: partition_table is NULL");
+    return ge::GE_GRAPH_SAVE_FAILED;
+  }
+  uint32_t size_of_table = SIZE_OF_MODEL_PARTITION_TABLE(*partition_table);
+  FMK_UINT32_ADDCHECK(size_of_table, model_data_len)
+  model_header_.length = size_of_table + model_data_len;
+  model_header_.is_encrypt = ModelEncryptType::UNENCRYPTED;
+
+  om_buffer.clear();
+  om_buffer.reserve(sizeof(ModelFileHeader) + model_header_.length);
+  auto header_addr = reinterpret_cast<const uint8_t *>(&model_header_);
+  om_buffer.insert(om_buffer.end(), header_addr, header_addr + sizeof(ModelFileHeader));
+  auto table_addr = reinterpret_cast<const uint8_t *>(partition_table);
+  om_buffer.insert(om_buffer.end(), table_addr, table_addr + size_of_table);
+  for (const auto &partition : context_.partition_datas_) {
+    GE_CHECK_NOTNULL(partition.data);
+    om_buffer.insert(om_buffer.end(), partition.data, partition.data + partition.size);
+  }
+  return SUCCESS;
+}
 }  // namespace ge
@@ -0,0 +1,256 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/profiling/profiling_event_buffer.h"
+
+#include <chrono>
+
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+#include "framework/common/fmk_error_codes.h"
+
+namespace ge {
+namespace {
+// Text of records sent to the sink at once
+const size_t kMaxChunkSize = 64 * 1024;
+
+std::atomic<uint64_t> g_buffer_id(0);
+
+// Ring of the current thread in the buffer it was created for
+struct ThreadRingCache {
+  uint64_t buffer_id = 0;
+  ProfEventRing *ring = nullptr;
+};
+thread_local ThreadRingCache t_ring_cache;
+
+size_t RoundUpPowerOfTwo(size_t size) {
+  size_t power = 1;
+  while (power < size) {
+    power <<= 1;
+  }
+  return power;
+}
+}  // namespace
+
+ProfEventRing::ProfEventRing(size_t capacity) : records_(RoundUpPowerOfTwo(capacity)), head_(0), tail_(0) {
+  mask_ = records_.size() - 1;
+}
+
+bool ProfEventRing::Push(const ProfEventRecord *records, size_t num, uint32_t iteration, uint64_t timestamp) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  size_t tail = tail_.load(std::memory_order_acquire);
+  if (records_.size() - (head - tail) < num) {
+    return false;
+  }
+  for (size_t i = 0; i < num; ++i) {
+    ProfEventRecord &record = records_[(head + i) & mask_];
+    record = records[i];
+    record.iteration = iteration;
+    record.timestamp = timestamp;
+  }
+  head_.store(head + num, std::memory_order_release);
+  return true;
+}
+
+size_t ProfEventRing::Pop(std::vector<ProfEventRecord> &out) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  size_t head = head_.load(std::memory_order_acquire);
+  for (size_t i = tail; i != head; ++i) {
+    out.push_back(records_[i & mask_]);
+  }
+  tail_.store(head, std::memory_order_release);
+  return head - tail;
+}
+
+ProfilingEventBuffer::ProfilingEventBuffer(size_t ring_capacity)
+    : buffer_id_(++g_buffer_id),
+      ring_capacity_(ring_capacity),
+      sample_interval_(1),
+      iteration_(0),
+      recorded_num_(0),
+      dropped_num_(0),
+      sampled_out_num_(0),
+      exported_num_(0),
+      exported_bytes_(0),
+      export_failed_num_(0) {}
+
+ProfilingEventBuffer::~ProfilingEventBuffer() { Stop(); }
+
+uint32_t ProfilingEventBuffer::InternName(const std::string &name) {
+  std::lock_guard<std::mutex> lock(names_mutex_);
+  auto iter = name_ids_.find(name);
+  if (iter != name_ids_.end()) {
+    return iter->second;
+  }
+  uint32_t id = static_cast<uint32_t>(names_.size());
+  names_.push_back(name);
+  name_ids_.emplace(name, id);
+  return id;
+}
+
+Status ProfilingEventBuffer::Start(const Sink &sink, uint32_t interval_ms) {
+  GE_CHK_BOOL_RET_STATUS(sink != nullptr && interval_ms > 0, PARAM_INVALID, "Invalid profiling event sink.");
+  {
+    std::lock_guard<std::mutex> lock(export_mutex_);
+    sink_ = sink;
+  }
+  std::lock_guard<std::mutex> lock(thread_mutex_);
+  if (!is_stopped_) {
+    return SUCCESS;
+  }
+  is_stopped_ = false;
+  thread_ = std::thread(&ProfilingEventBuffer::ExportLoop, this, interval_ms);
+  GELOGI("Profiling event exporter starts, ring capacity %zu, interval %u ms.", ring_capacity_, interval_ms);
+  return SUCCESS;
+}
+
+void ProfilingEventBuffer::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (is_stopped_) {
+      return;
+    }
+    is_stopped_ = true;
+  }
+  cond_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  (void)Export();
+  ProfEventStats stats;
+  GetStats(stats);
+  GELOGI("Profiling event exporter stops, recorded %lu, dropped %lu, sampled out %lu, exported %lu in %lu bytes.",
+         stats.recorded_num, stats.dropped_num, stats.sampled_out_num, stats.exported_num, stats.exported_bytes);
+}
+
+ProfEventRing *ProfilingEventBuffer::GetThreadRing() {
+  if (t_ring_cache.buffer_id == buffer_id_) {
+    return t_ring_cache.ring;
+  }
+  // Ring of an exited thread is taken over by the thread reusing its id
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  auto iter = thread_rings_.find(std::this_thread::get_id());
+  if (iter == thread_rings_.end()) {
+    std::unique_ptr<ProfEventRing> ring(new (std::nothrow) ProfEventRing(ring_capacity_));
+    if (ring == nullptr) {
+      return nullptr;
+    }
+    rings_.push_back(std::move(ring));
+    iter = thread_rings_.emplace(std::this_thread::get_id(), rings_.back().get()).first;
+  }
+  t_ring_cache.buffer_id = buffer_id_;
+  t_ring_cache.ring = iter->second;
+  return t_ring_cache.ring;
+}
+
+void ProfilingEventBuffer::Record(const ProfEventRecord *records, size_t num) {
+  uint32_t iteration = iteration_++;
+  if (iteration % sample_interval_ != 0) {
+    sampled_out_num_++;
+    return;
+  }
+  ProfEventRing *ring = GetThreadRing();
+  if (records == nullptr || num == 0 || ring == nullptr) {
+    return;
+  }
+  uint64_t timestamp = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+  if (!ring->Push(records, num, iteration, timestamp)) {
+    dropped_num_ += num;
+    GELOGD("Profiling events of iteration %u are dropped as the ring is full.", iteration);
+  } else {
+    recorded_num_ += num;
+  }
+  // Wake exporter up before the ring is full
+  if (ring->Size() > ring->Capacity() / 2) {
+    {
+      std::lock_guard<std::mutex> lock(thread_mutex_);
+      export_pending_ = true;
+    }
+    cond_.notify_one();
+  }
+}
+
+Status ProfilingEventBuffer::Flush() { return Export(); }
+
+void ProfilingEventBuffer::ExportLoop(uint32_t interval_ms) {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(thread_mutex_);
+      cond_.wait_for(lock, std::chrono::milliseconds(interval_ms), [this] { return is_stopped_ || export_pending_; });
+      if (is_stopped_) {
+        return;
+      }
+      export_pending_ = false;
+    }
+    (void)Export();
+  }
+}
+
+Status ProfilingEventBuffer::Export() {
+  std::lock_guard<std::mutex> export_lock(export_mutex_);
+  if (sink_ == nullptr) {
+    return SUCCESS;
+  }
+  export_records_.clear();
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto &ring : rings_) {
+      (void)ring->Pop(export_records_);
+    }
+  }
+
+  // Names are interned before records using them are pushed, so they are all found after rings are drained
+  Status ret = SUCCESS;
+  size_t start = 0;
+  while (start < export_records_.size()) {
+    size_t num = 0;
+    export_data_.clear();
+    {
+      std::lock_guard<std::mutex> lock(names_mutex_);
+      for (; start + num < export_records_.size() && export_data_.size() < kMaxChunkSize; ++num) {
+        const ProfEventRecord &record = export_records_[start + num];
+        if (record.op_name_id < names_.size()) {
+          export_data_ += names_[record.op_name_id];
+        }
+        export_data_ += ' ' + std::to_string(record.task_id) + ';';
+      }
+    }
+    start += num;
+    if (sink_(export_data_) != 0) {
+      export_failed_num_++;
+      ret = FAILED;
+      continue;
+    }
+    exported_num_ += num;
+    exported_bytes_ += export_data_.size();
+  }
+  if (ret != SUCCESS) {
+    GELOGW("Export profiling events failed, failed chunks %lu.", export_failed_num_.load());
+  }
+  return ret;
+}
+
+void ProfilingEventBuffer::GetStats(ProfEventStats &stats) const {
+  stats.recorded_num = recorded_num_;
+  stats.dropped_num = dropped_num_;
+  stats.sampled_out_num = sampled_out_num_;
+  stats.exported_num = exported_num_;
+  stats.exported_bytes = exported_bytes_;
+  stats.export_failed_num = export_failed_num_;
+}
+}  // namespace ge
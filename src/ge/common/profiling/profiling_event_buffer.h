@@ -0,0 +1,171 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_COMMON_PROFILING_PROFILING_EVENT_BUFFER_H_
+#define GE_COMMON_PROFILING_PROFILING_EVENT_BUFFER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+
+namespace ge {
+///
+/// @brief Fixed size record of a task executed, names are interned ids of ProfilingEventBuffer
+///
+struct ProfEventRecord {
+  uint64_t timestamp = 0;
+  uint32_t iteration = 0;
+  uint32_t model_id = 0;
+  uint32_t model_name_id = 0;
+  uint32_t op_name_id = 0;
+  uint32_t task_id = 0;
+  uint32_t reserved = 0;
+};
+
+struct ProfEventStats {
+  uint64_t recorded_num = 0;
+  // Records dropped as the ring of the thread is full
+  uint64_t dropped_num = 0;
+  // Iterations skipped by sampling
+  uint64_t sampled_out_num = 0;
+  uint64_t exported_num = 0;
+  uint64_t exported_bytes = 0;
+  uint64_t export_failed_num = 0;
+};
+
+///
+/// @brief Ring of records with a single producer and a single consumer
+///
+class ProfEventRing {
+ public:
+  explicit ProfEventRing(size_t capacity);
+
+  // Push records of one iteration as a whole, returns false if there is no room for them
+  bool Push(const ProfEventRecord *records, size_t num, uint32_t iteration, uint64_t timestamp);
+
+  // Move all records to out, returns number of records popped
+  size_t Pop(std::vector<ProfEventRecord> &out);
+
+  size_t Size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+  size_t Capacity() const { return records_.size(); }
+
+ private:
+  std::vector<ProfEventRecord> records_;
+  size_t mask_;
+  // Written by producer only
+  std::atomic<size_t> head_;
+  // Written by consumer only
+  std::atomic<size_t> tail_;
+};
+
+///
+/// @ingroup ge_profiling
+/// @brief Buffer of profiling events. Each reporting thread writes a ring of its own without lock, and a background
+///        exporter drains all rings and sends records to the sink in bulk, as text of "op_name task_id;" for each.
+///
+class ProfilingEventBuffer {
+ public:
+  // Sink of exported text, returns 0 on success
+  using Sink = std::function<int(const std::string &data)>;
+
+  explicit ProfilingEventBuffer(size_t ring_capacity = kDefaultRingCapacity);
+  ~ProfilingEventBuffer();
+
+  ProfilingEventBuffer(const ProfilingEventBuffer &) = delete;
+  ProfilingEventBuffer &operator=(const ProfilingEventBuffer &) = delete;
+
+  ///
+  /// @ingroup ge_profiling
+  /// @brief intern name, the id is stable in the process and resolved to the name when records are exported
+  /// @param [in] name op or model name
+  /// @return id of name
+  ///
+  uint32_t InternName(const std::string &name);
+
+  // Start exporter thread flushing every interval_ms, records are kept in rings until the sink is set.
+  Status Start(const Sink &sink, uint32_t interval_ms = kDefaultExportIntervalMs);
+
+  // Stop exporter thread after all records are exported.
+  void Stop();
+
+  ///
+  /// @ingroup ge_profiling
+  /// @brief record tasks of one iteration, timestamp and iteration are stamped on each record
+  /// @param [in] records records with names and task ids filled
+  /// @param [in] num number of records
+  ///
+  void Record(const ProfEventRecord *records, size_t num);
+
+  // Export all records in rings on the calling thread.
+  Status Flush();
+
+  // Record one of every interval iterations
+  void SetSampleInterval(uint32_t interval) { sample_interval_ = (interval == 0) ? 1 : interval; }
+
+  void GetStats(ProfEventStats &stats) const;
+
+  static const size_t kDefaultRingCapacity = 16384;
+  static const uint32_t kDefaultExportIntervalMs = 100;
+
+ private:
+  ProfEventRing *GetThreadRing();
+  void ExportLoop(uint32_t interval_ms);
+  Status Export();
+
+  // Identify the buffer in thread local cache, addresses may be reused by buffers created later
+  const uint64_t buffer_id_;
+  const size_t ring_capacity_;
+
+  std::mutex rings_mutex_;
+  std::vector<std::unique_ptr<ProfEventRing>> rings_;
+  std::map<std::thread::id, ProfEventRing *> thread_rings_;
+
+  std::mutex names_mutex_;
+  std::unordered_map<std::string, uint32_t> name_ids_;
+  std::vector<std::string> names_;
+
+  // Held by the consumer of rings
+  std::mutex export_mutex_;
+  Sink sink_;
+  std::vector<ProfEventRecord> export_records_;
+  std::string export_data_;
+
+  std::mutex thread_mutex_;
+  std::condition_variable cond_;
+  std::thread thread_;
+  bool is_stopped_ = true;
+  bool export_pending_ = false;
+
+  std::atomic<uint32_t> sample_interval_;
+  std::atomic<uint32_t> iteration_;
+  std::atomic<uint64_t> recorded_num_;
+  std::atomic<uint64_t> dropped_num_;
+  std::atomic<uint64_t> sampled_out_num_;
+  std::atomic<uint64_t> exported_num_;
+  std::atomic<uint64_t> exported_bytes_;
+  std::atomic<uint64_t> export_failed_num_;
+};
+}  // namespace ge
+#endif  // GE_COMMON_PROFILING_PROFILING_EVENT_BUFFER_H_
@@ -35,6 +35,7 @@ const char *const kEvents = "events";
 const char *const kAiCoreEvents = "ai_core_events";
 const char *const kName = "name";
 const char *const kTraceID = "traceId";
+const char *const kSampleIntervalEnv = "PROFILING_SAMPLE_INTERVAL";
 }  // namespace
 
 namespace ge {
@@ -72,6 +73,11 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ge::Status ProfilingManager::In
       GELOGE(FAILED, "Register profiling engine failed.");
       return FAILED;
     }
+    ret = StartEventExport();
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Start profiling event export failed.");
+      return ret;
+    }
     // profiling startup first time
     ret = StartProfiling(0);
     if (ret != SUCCESS) {
@@ -84,6 +90,39 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ge::Status ProfilingManager::In
   return SUCCESS;
 }
 
+ge::Status ProfilingManager::StartEventExport() {
+  const char *sample_interval = std::getenv(kSampleIntervalEnv);
+  if (sample_interval != nullptr) {
+    char *end = nullptr;
+    unsigned long interval = std::strtoul(sample_interval, &end, 10);
+    if ((end == sample_interval) || (*end != '\0') || (interval == 0) || (interval > UINT32_MAX)) {
+      GELOGE(PARAM_INVALID, "%s %s is invalid, it should be a positive integer.", kSampleIntervalEnv, sample_interval);
+      return PARAM_INVALID;
+    }
+    event_buffer_.SetSampleInterval(static_cast<uint32_t>(interval));
+    GELOGI("Profiling data is reported every %lu runs.", interval);
+  }
+
+  int32_t device_id = device_id_;
+  // Text of many ops is reported at once, in the same format as ReportProfilingData of op_task_id_map
+  return event_buffer_.Start([device_id](const std::string &data) -> int {
+    Msprof::Engine::Reporter *reporter = PluginImpl::GetPluginReporter();
+    if (reporter == nullptr) {
+      GELOGI("Profiling report is nullptr!");
+      return -1;
+    }
+    Msprof::Engine::ReporterData reporter_data{};
+    reporter_data.deviceId = device_id;
+    reporter_data.data = (unsigned char *)data.c_str();
+    reporter_data.dataLen = data.size();
+    if (memcpy_s(reporter_data.tag, MSPROF_ENGINE_MAX_TAG_LEN + 1, "framework", sizeof("framework")) != EOK) {
+      GELOGE(FAILED, "Report data tag memcpy error!");
+      return -1;
+    }
+    return reporter->Report(&reporter_data);
+  });
+}
+
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ge::Status ProfilingManager::InitFromAclCfg(
   const std::string &config) {
 #ifdef DAVINCI_SUPPORT_PROFILING
@@ -246,6 +285,8 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ge::Status ProfilingManager::St
 
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::StopProfiling() {
 #ifdef DAVINCI_SUPPORT_PROFILING
+  // Records in rings are sent before reporter flushes
+  (void)event_buffer_.Flush();
   Msprof::Engine::Reporter *reporter = PluginImpl::GetPluginReporter();
   if (reporter != nullptr) {
     int ret = reporter->Flush();
@@ -300,6 +341,14 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::ReportPr
 #endif
 }
 
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::ReportProfilingData(
+  const std::vector<ProfEventRecord> &task_records) {
+#ifdef DAVINCI_SUPPORT_PROFILING
+  // Only records are copied to the ring of this thread, names and reporter calls are left to the exporter
+  event_buffer_.Record(task_records.data(), task_records.size());
+#endif
+}
+
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::SetProfilingConfig(
   const std::string &profiling_cfg) {
   recv_profiling_config_ = profiling_cfg;
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "common/profiling/profiling_event_buffer.h"
 #include "framework/common/ge_inner_error_codes.h"
 #include "framework/common/ge_types.h"
 #include "external/register/register_types.h"
@@ -47,9 +48,17 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ProfilingManager {
   bool ProfilingOn() const { return is_profiling_; }
   int32_t GetOpTraceIterNum() const { return op_trace_iter_num_; }
   void ReportProfilingData(const std::map<uint32_t, std::string> &op_task_id_map);
+  ///
+  /// @brief report tasks of one run as records, names are interned with InternProfilingName in advance
+  /// @param [in] task_records records of tasks
+  ///
+  void ReportProfilingData(const std::vector<ProfEventRecord> &task_records);
+  uint32_t InternProfilingName(const std::string &name) { return event_buffer_.InternName(name); }
   void SetProfilingConfig(const string &profiling_cfg);
 
  private:
+  ge::Status StartEventExport();
+
   bool is_profiling_ = false;
   bool is_op_trace_ = false;
   bool is_load_ = false;
@@ -61,6 +70,7 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ProfilingManager {
   void *prof_handle = nullptr;
   string recv_profiling_config_;
   string send_profiling_config_;
+  ProfilingEventBuffer event_buffer_;
 };
 
 ///
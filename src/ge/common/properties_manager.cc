@@ -260,4 +260,15 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY std::string PropertiesManager::
   std::lock_guard<std::mutex> lock(dump_mutex_);
   return this->output_path_;
 }
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void PropertiesManager::SetAsyncDumpOptions(
+  const AsyncDumpOptions &options) {
+  std::lock_guard<std::mutex> lock(dump_mutex_);
+  this->async_dump_options_ = options;
+}
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY AsyncDumpOptions PropertiesManager::GetAsyncDumpOptions() {
+  std::lock_guard<std::mutex> lock(dump_mutex_);
+  return this->async_dump_options_;
+}
 }  // namespace ge
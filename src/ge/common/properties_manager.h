@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "framework/common/ge_types.h"
 #include "graph/op_desc.h"
 
 namespace ge {
@@ -91,6 +92,8 @@ class PropertiesManager {
   std::string GetDumpOutputModel();
   void SetDumpOutputPath(const std::string &output_path);
   std::string GetDumpOutputPath();
+  void SetAsyncDumpOptions(const AsyncDumpOptions &options);
+  AsyncDumpOptions GetAsyncDumpOptions();
 
  private:
   // Private construct, destructor
@@ -117,6 +120,7 @@ class PropertiesManager {
   std::string output_mode_;
   std::string output_path_;
   std::map<std::string, std::set<std::string>> model_dump_properties_map_;  // model_dump_layers_map_
+  AsyncDumpOptions async_dump_options_;
   std::mutex dump_mutex_;
 };
 }  // namespace ge
@@ -0,0 +1,179 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/single_op_archive.h"
+
+#include <securec.h>
+
+#include "common/auth/file_saver.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+
+namespace ge {
+namespace {
+const uint32_t kArchiveMagic = 0x5350414f;
+const uint32_t kArchiveVersion = 1;
+// Models are aligned in archive, as model file header and partition table are read in place
+const size_t kModelAlign = 8;
+
+struct ArchiveHead {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t model_num;
+  uint32_t key_num;
+};
+
+struct ArchiveModelHead {
+  uint64_t offset;
+  uint64_t len;
+};
+
+struct ArchiveKeyHead {
+  uint32_t model_index;
+  uint32_t key_len;
+};
+
+size_t AlignSize(size_t size) { return (size + kModelAlign - 1) / kModelAlign * kModelAlign; }
+}  // namespace
+
+size_t SingleOpArchive::AddModel(std::vector<uint8_t> &&model) {
+  models_.emplace_back(std::move(model));
+  return models_.size() - 1;
+}
+
+Status SingleOpArchive::AddKey(const std::string &key, size_t model_index) {
+  if (model_index >= models_.size()) {
+    GELOGE(PARAM_INVALID, "Model index %zu of key %s is out of range %zu.", model_index, key.c_str(), models_.size());
+    return PARAM_INVALID;
+  }
+  if (!added_keys_.insert(key).second) {
+    GELOGE(PARAM_INVALID, "Key %s is added to archive repeatedly.", key.c_str());
+    return PARAM_INVALID;
+  }
+  keys_.emplace_back(key, model_index);
+  return SUCCESS;
+}
+
+Status SingleOpArchive::Save(const std::string &file_path) const {
+  // Layout: ArchiveHead | ArchiveModelHead * model_num | (ArchiveKeyHead, key) * key_num | aligned models
+  size_t total_len = sizeof(ArchiveHead) + sizeof(ArchiveModelHead) * models_.size();
+  for (const auto &key : keys_) {
+    total_len += sizeof(ArchiveKeyHead) + key.first.size();
+  }
+  std::vector<ArchiveModelHead> model_heads(models_.size());
+  for (size_t i = 0; i < models_.size(); ++i) {
+    total_len = AlignSize(total_len);
+    model_heads[i].offset = total_len;
+    model_heads[i].len = models_[i].size();
+    total_len += models_[i].size();
+  }
+
+  std::vector<uint8_t> buffer(total_len, 0);
+  ArchiveHead head{kArchiveMagic, kArchiveVersion, static_cast<uint32_t>(models_.size()),
+                   static_cast<uint32_t>(keys_.size())};
+  size_t offset = 0;
+  auto append = [&buffer, &offset](const void *data, size_t len) -> bool {
+    if (len == 0) {
+      return true;
+    }
+    if (memcpy_s(buffer.data() + offset, buffer.size() - offset, data, len) != EOK) {
+      return false;
+    }
+    offset += len;
+    return true;
+  };
+  GE_CHK_BOOL_RET_STATUS(append(&head, sizeof(head)), FAILED, "Copy archive head failed.");
+  for (const auto &model_head : model_heads) {
+    GE_CHK_BOOL_RET_STATUS(append(&model_head, sizeof(model_head)), FAILED, "Copy archive model head failed.");
+  }
+  for (const auto &key : keys_) {
+    ArchiveKeyHead key_head{static_cast<uint32_t>(key.second), static_cast<uint32_t>(key.first.size())};
+    GE_CHK_BOOL_RET_STATUS(append(&key_head, sizeof(key_head)), FAILED, "Copy archive key head failed.");
+    GE_CHK_BOOL_RET_STATUS(append(key.first.data(), key.first.size()), FAILED, "Copy key %s failed.",
+                           key.first.c_str());
+  }
+  for (size_t i = 0; i < models_.size(); ++i) {
+    offset = model_heads[i].offset;
+    GE_CHK_BOOL_RET_STATUS(append(models_[i].data(), models_[i].size()), FAILED, "Copy model %zu failed.", i);
+  }
+
+  GELOGI("Save %zu single op models of %zu keys to archive %s, size %zu.", models_.size(), keys_.size(),
+         file_path.c_str(), buffer.size());
+  return FileSaver::SaveToFile(file_path, buffer.data(), buffer.size());
+}
+
+Status SingleOpArchive::Load(const uint8_t *data, size_t len) {
+  GE_CHECK_NOTNULL(data);
+  key_models_.clear();
+  if (len < sizeof(ArchiveHead)) {
+    GELOGE(PARAM_INVALID, "Archive length %zu is less than archive head.", len);
+    return PARAM_INVALID;
+  }
+  ArchiveHead head;
+  GE_CHK_BOOL_RET_STATUS(memcpy_s(&head, sizeof(head), data, sizeof(head)) == EOK, FAILED, "Copy head failed.");
+  if (head.magic != kArchiveMagic || head.version != kArchiveVersion) {
+    GELOGE(PARAM_INVALID, "Invalid archive, magic 0x%x, version %u.", head.magic, head.version);
+    return PARAM_INVALID;
+  }
+
+  size_t offset = sizeof(ArchiveHead);
+  if (head.model_num > (len - offset) / sizeof(ArchiveModelHead)) {
+    GELOGE(PARAM_INVALID, "Archive of length %zu is truncated in %u model heads.", len, head.model_num);
+    return PARAM_INVALID;
+  }
+  std::vector<ArchiveModelHead> model_heads(head.model_num);
+  for (auto &model_head : model_heads) {
+    (void)memcpy_s(&model_head, sizeof(model_head), data + offset, sizeof(model_head));
+    offset += sizeof(ArchiveModelHead);
+    if (model_head.offset > len || model_head.len > len - model_head.offset || model_head.len > UINT32_MAX) {
+      GELOGE(PARAM_INVALID, "Model at offset %lu with length %lu is out of archive length %zu.", model_head.offset,
+             model_head.len, len);
+      return PARAM_INVALID;
+    }
+  }
+
+  for (uint32_t i = 0; i < head.key_num; ++i) {
+    ArchiveKeyHead key_head;
+    if (len - offset < sizeof(ArchiveKeyHead)) {
+      GELOGE(PARAM_INVALID, "Archive of length %zu is truncated in key heads.", len);
+      return PARAM_INVALID;
+    }
+    (void)memcpy_s(&key_head, sizeof(key_head), data + offset, sizeof(key_head));
+    offset += sizeof(ArchiveKeyHead);
+    if (len - offset < key_head.key_len || key_head.model_index >= head.model_num) {
+      GELOGE(PARAM_INVALID, "Invalid key of length %u and model index %u.", key_head.key_len, key_head.model_index);
+      return PARAM_INVALID;
+    }
+    std::string key(reinterpret_cast<const char *>(data + offset), key_head.key_len);
+    offset += key_head.key_len;
+    const ArchiveModelHead &model_head = model_heads[key_head.model_index];
+    key_models_[key] = std::make_pair(data + model_head.offset, static_cast<uint32_t>(model_head.len));
+  }
+  GELOGI("Load %u single op models of %zu keys from archive.", head.model_num, key_models_.size());
+  return SUCCESS;
+}
+
+Status SingleOpArchive::FindModel(const std::string &key, ModelData &model_data) const {
+  auto iter = key_models_.find(key);
+  if (iter == key_models_.end()) {
+    GELOGE(PARAM_INVALID, "Can not find single op model of key %s in archive.", key.c_str());
+    return PARAM_INVALID;
+  }
+  model_data.model_data = const_cast<uint8_t *>(iter->second.first);
+  model_data.model_len = iter->second.second;
+  return SUCCESS;
+}
+}  // namespace ge
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_COMMON_SINGLE_OP_ARCHIVE_H_
+#define GE_COMMON_SINGLE_OP_ARCHIVE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "framework/common/fmk_types.h"
+#include "framework/common/ge_inner_error_codes.h"
+#include "framework/common/ge_types.h"
+
+namespace ge {
+///
+/// Archive of single op models. A model is saved once and can be found by any key added for it,
+/// so ops of the same signature share one model. Models are looked up in the archive data without copying,
+/// which lets single ops in a large archive be loaded lazily by key.
+///
+class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY SingleOpArchive {
+ public:
+  SingleOpArchive() = default;
+  ~SingleOpArchive() = default;
+
+  // Add an om model to archive, return the index of the model
+  size_t AddModel(std::vector<uint8_t> &&model);
+  Status AddKey(const std::string &key, size_t model_index);
+  Status Save(const std::string &file_path) const;
+
+  // Index archive data, which must be kept until the archive is not used any more
+  Status Load(const uint8_t *data, size_t len);
+  Status FindModel(const std::string &key, ModelData &model_data) const;
+  size_t GetKeyNum() const { return key_models_.size(); }
+
+ private:
+  std::vector<std::vector<uint8_t>> models_;
+  std::vector<std::pair<std::string, size_t>> keys_;
+  std::unordered_set<std::string> added_keys_;
+  // <key, <model addr, model len>> of loaded archive
+  std::unordered_map<std::string, std::pair<const uint8_t *, uint32_t>> key_models_;
+};
+}  // namespace ge
+
+#endif  // GE_COMMON_SINGLE_OP_ARCHIVE_H_
@@ -16,14 +16,18 @@
 
 #include "engine_manager/dnnengine_manager.h"
 
+#include <securec.h>
 #include <unistd.h>
 #include <cstdio>
 #include <fstream>
+#include <future>
 #include <map>
+#include <sstream>
 #include <utility>
 
 #include "common/debug/log.h"
 #include "common/ge/ge_util.h"
+#include "common/thread_pool.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_context.h"
 #include "init/gelib.h"
@@ -43,6 +47,176 @@ const char *const kCustomOpFlag = "_custom_op_flag";
 }  // namespace
 
 namespace ge {
+namespace {
+// Signatures of fewer ops are computed on the calling thread
+const size_t kMinParallelPlaceNum = 1024;
+const uint32_t kPlaceThreadNum = 4;
+
+struct PlacementGroup {
+  // The op to check, other members share its placement
+  OpDescPtr op_desc;
+  std::vector<size_t> members;
+  bool resolved = false;
+  EnginePlacement placement;
+};
+
+void AppendString(std::ostringstream &oss, const std::string &value) { oss << value.size() << ':' << value; }
+
+void AppendValue(std::ostringstream &oss, int64_t value) { oss << value; }
+
+void AppendValue(std::ostringstream &oss, float value) {
+  uint32_t bits = 0;
+  static_assert(sizeof(bits) == sizeof(value), "float is not 32 bits");
+  (void)memcpy_s(&bits, sizeof(bits), &value, sizeof(value));
+  oss << bits;
+}
+
+void AppendValue(std::ostringstream &oss, bool value) { oss << (value ? 1 : 0); }
+
+void AppendValue(std::ostringstream &oss, const std::string &value) { AppendString(oss, value); }
+
+void AppendValue(std::ostringstream &oss, DataType value) { oss << static_cast<int32_t>(value); }
+
+template <typename T>
+void AppendList(std::ostringstream &oss, const std::vector<T> &values) {
+  oss << '[';
+  for (const auto &value : values) {
+    AppendValue(oss, static_cast<T>(value));
+    oss << ',';
+  }
+  oss << ']';
+}
+
+template <typename T>
+void AppendAttrValue(std::ostringstream &oss, const GeAttrValue &attr_value) {
+  T value;
+  (void)attr_value.GetValue<T>(value);
+  AppendValue(oss, value);
+}
+
+template <typename T>
+void AppendListAttrValue(std::ostringstream &oss, const GeAttrValue &attr_value) {
+  std::vector<T> values;
+  (void)attr_value.GetValue<std::vector<T>>(values);
+  AppendList(oss, values);
+}
+
+// Attrs of tensor, graph, bytes and so on are too costly to compare, ops with them are not grouped
+bool AppendAttr(std::ostringstream &oss, const std::string &name, const GeAttrValue &attr_value) {
+  AppendString(oss, name);
+  oss << '=';
+  switch (attr_value.GetValueType()) {
+    case GeAttrValue::VT_STRING:
+      AppendAttrValue<GeAttrValue::STR>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_FLOAT:
+      AppendAttrValue<GeAttrValue::FLOAT>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_BOOL:
+      AppendAttrValue<GeAttrValue::BOOL>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_INT:
+      AppendAttrValue<GeAttrValue::INT>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_DATA_TYPE:
+      AppendAttrValue<GeAttrValue::DATA_TYPE>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_LIST_STRING:
+      AppendListAttrValue<GeAttrValue::STR>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_LIST_FLOAT:
+      AppendListAttrValue<GeAttrValue::FLOAT>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_LIST_BOOL:
+      AppendListAttrValue<GeAttrValue::BOOL>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_LIST_INT:
+      AppendListAttrValue<GeAttrValue::INT>(oss, attr_value);
+      break;
+    case GeAttrValue::VT_LIST_DATA_TYPE:
+      AppendListAttrValue<GeAttrValue::DATA_TYPE>(oss, attr_value);
+      break;
+    default:
+      return false;
+  }
+  oss << ';';
+  return true;
+}
+
+void AppendTensorDesc(std::ostringstream &oss, const GeTensorDescPtr &tensor_desc) {
+  if (tensor_desc == nullptr) {
+    oss << "null;";
+    return;
+  }
+  oss << static_cast<int32_t>(tensor_desc->GetDataType()) << ',' << static_cast<int32_t>(tensor_desc->GetFormat())
+      << ',' << static_cast<int32_t>(tensor_desc->GetOriginDataType()) << ','
+      << static_cast<int32_t>(tensor_desc->GetOriginFormat()) << ',';
+  AppendList(oss, tensor_desc->GetShape().GetDims());
+  oss << ',';
+  AppendList(oss, tensor_desc->GetOriginShape().GetDims());
+  oss << ';';
+}
+
+///
+/// Ops of the same signature are placed on the same engine. All attrs are part of the signature, including
+/// private ones such as _custom_op_flag which change how check support failure is handled.
+/// @return false if the op can not be grouped with others
+///
+bool GetPlacementSignature(const OpDescPtr &op_desc, const std::string &core_type, std::string &signature) {
+  std::ostringstream oss;
+  AppendString(oss, op_desc->GetType());
+  AppendString(oss, core_type);
+  oss << "|in:";
+  for (const auto &input_desc : op_desc->GetAllInputsDescPtr()) {
+    AppendTensorDesc(oss, input_desc);
+  }
+  oss << "|out:";
+  for (const auto &output_desc : op_desc->GetAllOutputsDescPtr()) {
+    AppendTensorDesc(oss, output_desc);
+  }
+  oss << "|attr:";
+  for (const auto &attr : op_desc->GetAllAttrs()) {
+    if (!AppendAttr(oss, attr.first, attr.second)) {
+      return false;
+    }
+  }
+  signature = oss.str();
+  return true;
+}
+
+Status GetPlacementSignatures(const std::vector<OpDescPtr> &op_descs, const std::string &core_type,
+                              std::vector<std::string> &signatures, std::vector<uint8_t> &groupable) {
+  signatures.assign(op_descs.size(), "");
+  groupable.assign(op_descs.size(), 0);
+  auto get_signatures = [&op_descs, &core_type, &signatures, &groupable](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      groupable[i] = GetPlacementSignature(op_descs[i], core_type, signatures[i]) ? 1 : 0;
+    }
+  };
+  if (op_descs.size() < kMinParallelPlaceNum) {
+    get_signatures(0, op_descs.size());
+    return SUCCESS;
+  }
+
+  ThreadPool thread_pool(kPlaceThreadNum);
+  std::vector<std::future<void>> futures;
+  for (size_t shard = 0; shard < kPlaceThreadNum; ++shard) {
+    size_t begin = op_descs.size() * shard / kPlaceThreadNum;
+    size_t end = op_descs.size() * (shard + 1) / kPlaceThreadNum;
+    std::future<void> f = thread_pool.commit(get_signatures, begin, end);
+    if (!f.valid()) {
+      GELOGE(FAILED, "Commit placement signature task of shard %zu failed.", shard);
+      return FAILED;
+    }
+    futures.emplace_back(std::move(f));
+  }
+  for (auto &f : futures) {
+    f.get();
+  }
+  return SUCCESS;
+}
+}  // namespace
+
 DNNEngineManager::DNNEngineManager() : init_flag_(false) {}
 DNNEngineManager::~DNNEngineManager() {
   engines_attrs_map_.clear();
@@ -165,18 +339,30 @@ std::string DNNEngineManager::GetDNNEngineName(const OpDescPtr &op_desc) const {
     GELOGE(GE_CLI_GE_NOT_INITIALIZED, "DNNEngineManager: op_desc is nullptr");
     return "";
   }
+  std::vector<string> engine_names;
+  (void)GetDNNEngineNames({op_desc}, engine_names);
+  return engine_names.empty() ? "" : engine_names[0];
+}
+
+Status DNNEngineManager::GetDNNEngineNames(const std::vector<OpDescPtr> &op_descs,
+                                           std::vector<string> &engine_names) const {
+  engine_names.assign(op_descs.size(), "");
+  for (const auto &op_desc : op_descs) {
+    GE_CHECK_NOTNULL(op_desc);
+  }
   // Use the OpsKernelManager in GELib to get the opInfos for this opCode
   std::shared_ptr<GELib> instance_ptr = ge::GELib::GetInstance();
   if ((instance_ptr == nullptr) || (!instance_ptr->InitFlag())) {
     GELOGE(GE_CLI_GE_NOT_INITIALIZED, "GetDNNEngineName failed.");
-    return "";
-  }
-  OpsKernelManager &ops_kernel_manager = instance_ptr->OpsKernelManagerObj();
-  std::vector<OpInfo> op_infos = ops_kernel_manager.GetOpsKernelInfo(op_desc->GetType());
-  if (op_infos.empty()) {
-    GELOGI("DNNEngineManager: Can not get op info by op type %s", op_desc->GetType().c_str());
-    return "";
+    return GE_CLI_GE_NOT_INITIALIZED;
   }
+  return PlaceOps(instance_ptr->OpsKernelManagerObj(), op_descs, engine_names);
+}
+
+Status DNNEngineManager::PlaceOps(OpsKernelManager &ops_kernel_manager, const std::vector<OpDescPtr> &op_descs,
+                                  std::vector<string> &engine_names) const {
+  engine_names.assign(op_descs.size(), "");
+  uint64_t start_usec = ge::GetCurrentTimestap();
   string ge_core_type;
   Status ret = ge::GetContext().GetOption(ge::CORE_TYPE, ge_core_type);
   if (ret != SUCCESS) {
@@ -184,50 +370,100 @@ std::string DNNEngineManager::GetDNNEngineName(const OpDescPtr &op_desc) const {
   }
   string exclude_core_Type = (ge_core_type == kVectorEngine) ? kAIcoreEngine : kVectorEngine;
   GELOGD("engine type will exclude: %s", exclude_core_Type.c_str());
+
+  std::vector<string> signatures;
+  std::vector<uint8_t> groupable;
+  GE_CHK_STATUS_RET(GetPlacementSignatures(op_descs, ge_core_type, signatures, groupable),
+                    "Get placement signatures failed.");
+
+  // Group ops of this call by signature, nothing is kept across calls
+  std::vector<PlacementGroup> groups;
+  std::unordered_map<string, size_t> group_indexes;
+  for (size_t i = 0; i < op_descs.size(); ++i) {
+    if (groupable[i] != 0) {
+      auto iter = group_indexes.find(signatures[i]);
+      if (iter != group_indexes.end()) {
+        groups[iter->second].members.emplace_back(i);
+        continue;
+      }
+      group_indexes.emplace(signatures[i], groups.size());
+    }
+    PlacementGroup group;
+    group.op_desc = op_descs[i];
+    group.members.emplace_back(i);
+    groups.emplace_back(std::move(group));
+  }
+
+  ret = SUCCESS;
+  for (auto &group : groups) {
+    group.resolved = PlaceOp(ops_kernel_manager, group.op_desc, exclude_core_Type, group.placement);
+    if (!group.resolved) {
+      GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "Can't find any supported ops kernel and engine of %s and %zu same op(s), "
+             "type is %s", group.op_desc->GetName().c_str(), group.members.size() - 1,
+             group.op_desc->GetType().c_str());
+      ret = GE_GRAPH_ASSIGN_ENGINE_FAILED;
+      continue;
+    }
+    for (size_t i : group.members) {
+      op_descs[i]->SetOpEngineName(group.placement.engine_name);
+      op_descs[i]->SetOpKernelLibName(group.placement.kernel_lib_name);
+      engine_names[i] = group.placement.engine_name;
+      GELOGD("DNNEngineManager:Set OpKernelLibName %s and engine name %s into op_desc %s",
+             group.placement.kernel_lib_name.c_str(), group.placement.engine_name.c_str(),
+             op_descs[i]->GetName().c_str());
+    }
+  }
+  GELOGD("Place %zu ops of %zu signatures, time cost %lu micro second.", op_descs.size(), groups.size(),
+         ge::GetCurrentTimestap() - start_usec);
+  return ret;
+}
+
+bool DNNEngineManager::PlaceOp(OpsKernelManager &ops_kernel_manager, const OpDescPtr &op_desc,
+                               const string &exclude_core_type, EnginePlacement &placement) const {
+  const std::vector<OpInfo> &op_infos = ops_kernel_manager.GetOpsKernelInfo(op_desc->GetType());
+  if (op_infos.empty()) {
+    GELOGI("DNNEngineManager: Can not get op info by op type %s", op_desc->GetType().c_str());
+    return false;
+  }
+  auto &kernel_map = ops_kernel_manager.GetAllOpsKernelInfoStores();
   std::map<std::string, std::string> unsupported_reasons;
   for (const auto &it : op_infos) {
-    if (it.engine == exclude_core_Type) {
+    if (it.engine == exclude_core_type) {
       continue;
     }
-    auto &kernel_map = ops_kernel_manager.GetAllOpsKernelInfoStores();
     auto &kernel_name = it.opKernelLib;
     auto kernel_info_store = kernel_map.find(kernel_name);
-    if (kernel_info_store != kernel_map.end()) {
-      std::string unsupported_reason;
-      // It will be replaced by engine' checksupport
-      if (kernel_info_store->second->CheckSupported(op_desc, unsupported_reason)) {
-        op_desc->SetOpEngineName(it.engine);
-        op_desc->SetOpKernelLibName(kernel_name);
-        GELOGD("DNNEngineManager:Set OpKernelLibName %s and engine name %s into op_desc %s", kernel_name.c_str(),
-               it.engine.c_str(), op_desc->GetName().c_str());
-        return it.engine;
-      } else {
-        bool is_custom_op = false;
-        if ((ge::AttrUtils::GetBool(op_desc, kCustomOpFlag, is_custom_op)) && is_custom_op) {
-          GELOGE(FAILED,
-                 "The custom operator registered by the user does not support the logic function delivered by this "
-                 "network. Check support failed, kernel_name is %s, op type is %s, op name is %s",
-                 kernel_name.c_str(), op_desc->GetType().c_str(), op_desc->GetName().c_str());
-          return "";
-        }
-        unsupported_reasons.emplace(kernel_name, unsupported_reason);
-        GELOGI("DNNEngineManager:Check support failed, kernel_name is %s, op type is %s, op name is %s",
-               kernel_name.c_str(), op_desc->GetType().c_str(), op_desc->GetName().c_str());
-      }
-    } else {
+    if (kernel_info_store == kernel_map.end()) {
       GELOGW(
         "DNNEngineManager:Can not find any supported ops kernel info store by kernel_name %s,"
         "op type is %s, op name is %s",
         kernel_name.c_str(), op_desc->GetType().c_str(), op_desc->GetName().c_str());
+      continue;
+    }
+    std::string unsupported_reason;
+    // It will be replaced by engine' checksupport
+    if (kernel_info_store->second->CheckSupported(op_desc, unsupported_reason)) {
+      placement.engine_name = it.engine;
+      placement.kernel_lib_name = kernel_name;
+      return true;
     }
+    bool is_custom_op = false;
+    if ((ge::AttrUtils::GetBool(op_desc, kCustomOpFlag, is_custom_op)) && is_custom_op) {
+      GELOGE(FAILED,
+             "The custom operator registered by the user does not support the logic function delivered by this "
+             "network. Check support failed, kernel_name is %s, op type is %s, op name is %s",
+             kernel_name.c_str(), op_desc->GetType().c_str(), op_desc->GetName().c_str());
+      return false;
+    }
+    unsupported_reasons.emplace(kernel_name, unsupported_reason);
+    GELOGI("DNNEngineManager:Check support failed, kernel_name is %s, op type is %s, op name is %s",
+           kernel_name.c_str(), op_desc->GetType().c_str(), op_desc->GetName().c_str());
   }
   for (const auto &it : unsupported_reasons) {
     GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "GetDNNEngineName:Op type %s of ops kernel %s is unsupported, reason:%s",
            op_desc->GetType().c_str(), it.first.c_str(), it.second.c_str());
   }
-  GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "Can't find any supported ops kernel and engine of %s, type is %s",
-         op_desc->GetName().c_str(), op_desc->GetType().c_str());
-  return "";
+  return false;
 }
 
 const std::map<std::string, SchedulerConf> &DNNEngineManager::GetSchedulers() const { return schedulers_; }
@@ -33,6 +33,7 @@
 using JsonHandle = void *;
 namespace ge {
 using nlohmann::json;
+class OpsKernelManager;
 
 // Engine configuration
 struct EngineConf {
@@ -55,6 +56,12 @@ struct SchedulerConf {
 
 using DNNEnginePtr = std::shared_ptr<DNNEngine>;
 
+// Engine and ops kernel lib assigned to ops of the same placement signature
+struct EnginePlacement {
+  string engine_name;
+  string kernel_lib_name;
+};
+
 class DNNEngineManager {
  public:
   friend class GELib;
@@ -62,6 +69,13 @@ class DNNEngineManager {
   bool IsEngineRegistered(const std::string &name) const;
   // If can't find appropriate engine name, return "", report error
   string GetDNNEngineName(const OpDescPtr &op_desc) const;
+  ///
+  /// Assign engines for ops in one go, engine_names are in the order of op_descs.
+  /// Ops of this call with the same placement signature (op type, dtype/format/shape of inputs and outputs and
+  /// their origin ones, attrs and core type) are checked once by CheckSupported of the kernel stores.
+  /// If any op can't find appropriate engine, its engine name is "" and failed is returned.
+  ///
+  Status GetDNNEngineNames(const std::vector<OpDescPtr> &op_descs, std::vector<string> &engine_names) const;
   const map<string, SchedulerConf> &GetSchedulers() const;
 
  private:
@@ -74,6 +88,10 @@ class DNNEngineManager {
   Status ParserEngineMessage(const json engines_json, const string &scheduler_mark,
                              map<string, EngineConfPtr> &engines);
   Status CheckJsonFile();
+  Status PlaceOps(OpsKernelManager &ops_kernel_manager, const std::vector<OpDescPtr> &op_descs,
+                  std::vector<string> &engine_names) const;
+  bool PlaceOp(OpsKernelManager &ops_kernel_manager, const OpDescPtr &op_desc, const string &exclude_core_type,
+               EnginePlacement &placement) const;
   PluginManager plugin_mgr_;
   std::map<std::string, DNNEnginePtr> engines_map_;
   std::map<std::string, ge::DNNEngineAttribute> engines_attrs_map_;
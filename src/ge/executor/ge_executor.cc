@@ -460,11 +460,80 @@ Status GeExecutor::GetMemAndWeightSize(const void *model_data, size_t model_size
   return ge::ModelManager::GetModelMemAndWeightSize(model, mem_size, weight_size);
 }
 
+Status GeExecutor::LoadModelGroup(const std::vector<ModelData> &models, size_t mem_limit, uint32_t &group_id,
+                                  std::vector<uint32_t> &model_ids) {
+  if (!is_init_) {
+    GELOGE(GE_EXEC_NOT_INIT, "not inited yet!");
+    return GE_EXEC_NOT_INIT;
+  }
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->LoadModelGroup(group_id, models, mem_limit, model_ids);
+}
+
+Status GeExecutor::UnloadModelGroup(uint32_t group_id) {
+  if (!is_init_) {
+    GELOGE(GE_EXEC_NOT_INIT, "not inited yet!");
+    return GE_EXEC_NOT_INIT;
+  }
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->UnloadModelGroup(group_id);
+}
+
+Status GeExecutor::GetModelGroupInfo(uint32_t group_id, ModelGroupInfo &info) {
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->GetModelGroupInfo(group_id, info);
+}
+
+Status GeExecutor::EnableDynamicBatch(uint32_t model_id, const DynamicBatchOptions &options) {
+  if (!is_init_) {
+    GELOGE(GE_EXEC_NOT_INIT, "not inited yet!");
+    return GE_EXEC_NOT_INIT;
+  }
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->EnableDynamicBatch(model_id, options);
+}
+
+Status GeExecutor::DisableDynamicBatch(uint32_t model_id) {
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->DisableDynamicBatch(model_id);
+}
+
+Status GeExecutor::DynamicBatchInput(uint32_t model_id, const std::vector<DataBuffer> &inputs,
+                                     const std::vector<DataBuffer> &outputs, std::function<void(Status)> done) {
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->DynamicBatchInput(model_id, inputs, outputs, std::move(done));
+}
+
+Status GeExecutor::GetDynamicBatchStats(uint32_t model_id, DynamicBatchStats &stats) {
+  auto model_manager = ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+  return model_manager->GetDynamicBatchStats(model_id, stats);
+}
+
 Status GeExecutor::LoadSingleOp(const std::string &model_name, const ge::ModelData &model_data, void *stream,
                                 SingleOp **single_op) {
   return SingleOpManager::GetInstance().GetOpFromModel(model_name, model_data, stream, single_op);
 }
 
+Status GeExecutor::LoadSingleOpArchive(const ge::ModelData &archive_data, uint64_t &archive_id) {
+  return SingleOpManager::GetInstance().LoadArchive(archive_data, archive_id);
+}
+
+Status GeExecutor::LoadSingleOpFromArchive(const std::string &key, uint64_t archive_id, void *stream,
+                                           SingleOp **single_op) {
+  return SingleOpManager::GetInstance().GetOpFromArchive(key, archive_id, stream, single_op);
+}
+
+Status GeExecutor::UnloadSingleOpArchive(uint64_t archive_id) {
+  return SingleOpManager::GetInstance().UnloadArchive(archive_id);
+}
+
 Status GeExecutor::ExecuteAsync(SingleOp *executor, const std::vector<DataBuffer> &inputs,
                                 std::vector<DataBuffer> &outputs) {
   if (executor == nullptr) {
@@ -15,16 +15,26 @@
  */
 
 #include "generator/ge_generator.h"
+
+#include <algorithm>
+#include <future>
+#include <unordered_map>
+
+#include "common/auth/file_saver.h"
 #include "common/ge/ge_util.h"
 #include "common/ge/plugin_manager.h"
 #include "common/helper/model_helper.h"
 #include "common/helper/om_file_helper.h"
+#include "common/single_op_archive.h"
+#include "common/thread_pool.h"
 #include "common/util.h"
 #include "framework/common/debug/ge_log.h"
 #include "ge/ge_api.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/manager/graph_manager.h"
+#include "graph/model_serialize.h"
 #include "graph/opsproto_manager.h"
+#include "graph/utils/attr_utils.h"
 #include "graph/utils/graph_utils.h"
 #include "model/ge_model.h"
 
@@ -34,7 +44,9 @@ using std::vector;
 
 namespace {
 const char *const kAttrOpType = "op_type";
-}
+// Threads serializing and saving built single op models, while the next op is being built.
+const uint32_t kSingleOpSaveThreadNum = 4;
+}  // namespace
 
 namespace ge {
 static Status AddInputs(const ComputeGraphPtr &graph, const NodePtr &node, const GeTensorDesc &tensor, int32_t index,
@@ -123,6 +135,9 @@ class GeGenerator::Impl {
 
   Status SaveModel(const string &file_name_prefix, vector<GeModelPtr> models);
 
+  Status BuildSingleOp(OpDescPtr &op_desc, const vector<GeTensor> &inputs, const vector<GeTensor> &outputs,
+                       const string &model_name, vector<GeModelPtr> &ge_models);
+
   Status SaveParams(GeModelPtr &ge_model, const string &type, const map<string, GeAttrValue> &attrs,
                     const vector<GeTensor> &inputs, const vector<GeTensor> &outputs);
 
@@ -233,6 +248,16 @@ Status GeGenerator::GenerateOfflineModel(const Graph &graph, const string &file_
  */
 Status GeGenerator::BuildSingleOpModel(OpDescPtr &op_desc, const vector<GeTensor> &inputs,
                                        const vector<GeTensor> &outputs, const string &model_file_name) {
+  GE_CHECK_NOTNULL_EXEC(impl_, return PARAM_INVALID);
+  vector<GeModelPtr> ge_models;
+  GE_CHK_STATUS_RET_NOLOG(impl_->BuildSingleOp(op_desc, inputs, outputs, model_file_name, ge_models));
+  GE_CHK_STATUS_RET_NOLOG(impl_->SaveModel(model_file_name, ge_models));
+  return SUCCESS;
+}
+
+Status GeGenerator::Impl::BuildSingleOp(OpDescPtr &op_desc, const vector<GeTensor> &inputs,
+                                        const vector<GeTensor> &outputs, const string &model_name,
+                                        vector<GeModelPtr> &ge_models) {
   GE_CHECK_NOTNULL_EXEC(op_desc, return PARAM_INVALID);
   if (!inputs.empty() && (inputs.size() != op_desc->GetInputsSize())) {
     GELOGE(PARAM_INVALID, "Tensor size: %zu, Inputs size:%zu", inputs.size(), op_desc->GetInputsSize());
@@ -244,7 +269,7 @@ Status GeGenerator::BuildSingleOpModel(OpDescPtr &op_desc, const vector<GeTensor
   }
 
   // 1. Create ComputeGraph.
-  string name = ge::CurrentTimeInStr() + "_" + model_file_name;
+  string name = ge::CurrentTimeInStr() + "_" + model_name;
   ge::ComputeGraphPtr compute_graph = MakeShared<ComputeGraph>(name);
   if (compute_graph == nullptr) {
     return INTERNAL_ERROR;
@@ -285,16 +310,143 @@ Status GeGenerator::BuildSingleOpModel(OpDescPtr &op_desc, const vector<GeTensor
   GELOGI("ATC parser success.");
 
   GraphId graph_id;
-  vector<GeModelPtr> ge_models;
-  GE_CHECK_NOTNULL_EXEC(impl_, return PARAM_INVALID);
-  GE_CHK_STATUS_RET_NOLOG(impl_->BuildModel(graph, inputs, graph_id, ge_models));
+  GE_CHK_STATUS_RET_NOLOG(BuildModel(graph, inputs, graph_id, ge_models));
 
   if (!ge_models.empty()) {
     map<string, GeAttrValue> op_attrs = op_desc->GetAllAttrs();
-    GE_CHK_STATUS_RET_NOLOG(impl_->SaveParams(ge_models[0], op_desc->GetType(), op_attrs, inputs, outputs));
+    GE_CHK_STATUS_RET_NOLOG(SaveParams(ge_models[0], op_desc->GetType(), op_attrs, inputs, outputs));
   }
+  return SUCCESS;
+}
 
-  GE_CHK_STATUS_RET_NOLOG(impl_->SaveModel(model_file_name, ge_models));
+// Ops which only differ in names are built into the same model, so the name is excluded from signature.
+static Status GetSingleOpSignature(const SingleOpBuildParam &param, string &signature) {
+  GE_CHECK_NOTNULL_EXEC(param.op_desc, return PARAM_INVALID);
+  OpDescPtr op_desc = AttrUtils::CopyOpDesc(param.op_desc);
+  GE_CHECK_NOTNULL_EXEC(op_desc, return INTERNAL_ERROR);
+  op_desc->SetName("");
+
+  OpDescPtr tensor_desc = MakeShared<OpDesc>("", "");
+  GE_CHECK_NOTNULL_EXEC(tensor_desc, return INTERNAL_ERROR);
+  for (const auto &input : param.inputs) {
+    GE_CHK_STATUS_RET_NOLOG(tensor_desc->AddInputDesc(input.GetTensorDesc()));
+  }
+  for (const auto &output : param.outputs) {
+    GE_CHK_STATUS_RET_NOLOG(tensor_desc->AddOutputDesc(output.GetTensorDesc()));
+  }
+
+  ModelSerialize serialize;
+  Buffer op_buffer = serialize.SerializeOpDesc(op_desc);
+  Buffer tensor_buffer = serialize.SerializeOpDesc(tensor_desc);
+  if (op_buffer.GetData() == nullptr || tensor_buffer.GetData() == nullptr) {
+    GELOGE(INTERNAL_ERROR, "Serialize op %s failed.", param.op_desc->GetName().c_str());
+    return INTERNAL_ERROR;
+  }
+
+  signature = std::to_string(op_buffer.GetSize()) + "_" + std::to_string(param.inputs.size()) + "_" +
+              std::to_string(param.outputs.size()) + "_";
+  signature.append(reinterpret_cast<const char *>(op_buffer.GetData()), op_buffer.GetSize());
+  signature.append(reinterpret_cast<const char *>(tensor_buffer.GetData()), tensor_buffer.GetSize());
+  // Const inputs are built into the model.
+  for (const auto &input : param.inputs) {
+    const Buffer data = input.GetData();
+    signature += "_" + std::to_string(data.GetSize()) + "_";
+    if (data.GetData() != nullptr) {
+      signature.append(reinterpret_cast<const char *>(data.GetData()), data.GetSize());
+    }
+  }
+  return SUCCESS;
+}
+
+Status GeGenerator::BuildSingleOpModels(vector<SingleOpBuildParam> &params, const string &archive_file) {
+  GE_CHECK_NOTNULL_EXEC(impl_, return PARAM_INVALID);
+  uint64_t start_usec = GetCurrentTimestap();
+
+  // Group ops of the same signature, each group is built once with its first op.
+  vector<vector<size_t>> groups;
+  std::unordered_map<string, size_t> signature_groups;
+  for (size_t i = 0; i < params.size(); ++i) {
+    string signature;
+    GE_CHK_STATUS_RET(GetSingleOpSignature(params[i], signature), "Get signature of op %zu failed.", i);
+    auto iter = signature_groups.emplace(signature, groups.size());
+    if (iter.second) {
+      groups.emplace_back();
+    }
+    groups[iter.first->second].push_back(i);
+  }
+
+  bool to_archive = !archive_file.empty();
+  vector<vector<uint8_t>> om_buffers(groups.size());
+  vector<std::future<Status>> save_futures;
+  // Declared after the data used by its tasks, so that pending tasks finish before the data is released.
+  ThreadPool save_pool(kSingleOpSaveThreadNum);
+
+  // GraphManager is not thread safe, so ops are built one by one, and the built models are serialized
+  // and saved by save_pool in the meantime.
+  Status ret = SUCCESS;
+  for (size_t group_index = 0; group_index < groups.size(); ++group_index) {
+    SingleOpBuildParam &param = params[groups[group_index].front()];
+    vector<GeModelPtr> ge_models;
+    ret = impl_->BuildSingleOp(param.op_desc, param.inputs, param.outputs, param.model_name, ge_models);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Build single op %s failed.", param.model_name.c_str());
+      break;
+    }
+    if (ge_models.empty()) {
+      GELOGE(FAILED, "Models of single op %s are empty.", param.model_name.c_str());
+      ret = FAILED;
+      break;
+    }
+
+    vector<uint8_t> &om_buffer = om_buffers[group_index];
+    const vector<size_t> &group = groups[group_index];
+    GeModelPtr ge_model = ge_models[0];
+    std::future<Status> f = save_pool.commit([ge_model, &om_buffer, &group, &params, to_archive]() -> Status {
+      ModelHelper model_helper;
+      GE_CHK_STATUS_RET(model_helper.SaveToOmBuffer(ge_model, om_buffer), "Serialize model %s failed.",
+                        ge_model->GetName().c_str());
+      if (to_archive) {
+        return SUCCESS;
+      }
+      for (size_t param_index : group) {
+        const string &model_file = params[param_index].model_name;
+        GE_CHK_STATUS_RET_NOLOG(FileSaver::SaveToFile(model_file, om_buffer.data(), om_buffer.size()));
+      }
+      vector<uint8_t>().swap(om_buffer);
+      return SUCCESS;
+    });
+    if (!f.valid()) {
+      GELOGE(FAILED, "Commit save task of single op %s failed.", param.model_name.c_str());
+      ret = FAILED;
+      break;
+    }
+    save_futures.emplace_back(std::move(f));
+  }
+
+  for (auto &f : save_futures) {
+    Status save_ret = f.get();
+    if (save_ret != SUCCESS && ret == SUCCESS) {
+      ret = save_ret;
+    }
+  }
+  GE_CHK_STATUS_RET(ret, "Build single op models failed.");
+
+  if (to_archive) {
+    SingleOpArchive archive;
+    for (size_t group_index = 0; group_index < groups.size(); ++group_index) {
+      size_t model_index = archive.AddModel(std::move(om_buffers[group_index]));
+      for (size_t param_index : groups[group_index]) {
+        GE_CHK_STATUS_RET_NOLOG(archive.AddKey(params[param_index].model_name, model_index));
+      }
+    }
+    GE_CHK_STATUS_RET(archive.Save(archive_file), "Save single op archive %s failed.", archive_file.c_str());
+  }
+
+  uint64_t end_usec = GetCurrentTimestap();
+  TraceBuildStage("GeGenerator::BuildSingleOpModels", start_usec, end_usec);
+  uint64_t cost_usec = std::max<uint64_t>(end_usec - start_usec, 1);
+  GEEVENT("[GEPERFTRACE] Build %zu single ops into %zu models in [%lu] micro second, %.1f ops per second.",
+          params.size(), groups.size(), cost_usec, static_cast<double>(params.size()) * 1000000 / cost_usec);
   return SUCCESS;
 }
 
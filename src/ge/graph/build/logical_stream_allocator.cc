@@ -15,10 +15,13 @@
  */
 
 #include "graph/build/logical_stream_allocator.h"
+#include <algorithm>
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/fmk_error_codes.h"
 #include "framework/common/types.h"
+#include "ge/ge_api_types.h"
+#include "graph/ge_context.h"
 #include "graph/utils/graph_utils.h"
 #include "graph/debug/ge_attr_define.h"
 
@@ -279,6 +282,253 @@ void AssignByDependencyPass::UpdateReusedSubgraphs() {
   }
 }
 
+Status AssignByCostModelPass::Run(ComputeGraphPtr whole_graph, const vector<SubgraphPtr> &subgraphs,
+                                  Context &context) {
+  if (context.cost_model == nullptr) {
+    return NOT_CHANGED;
+  }
+
+  Status status = InitTasks(subgraphs, *context.cost_model);
+  if (status != SUCCESS) {
+    GELOGW("Subgraphs can not be simulated, skip assigning streams by cost model.");
+    return NOT_CHANGED;
+  }
+
+  vector<int64_t> init_streams;
+  vector<SubgraphPtr> init_reused_subgraphs;
+  SaveStreams(init_streams, init_reused_subgraphs);
+  int64_t init_next_stream = context.next_stream;
+
+  // Assignment of the dependency heuristic, which is the baseline of the cost model.
+  AssignByDependencyPass dependency_pass;
+  GE_CHK_STATUS_RET(dependency_pass.Run(whole_graph, subgraphs, context), "Assign streams by dependency failed.");
+  StreamSimResult dependency_result;
+  GE_CHK_STATUS_RET(Simulate(dependency_result), "Simulate streams assigned by dependency failed.");
+  vector<int64_t> dependency_streams;
+  vector<SubgraphPtr> dependency_reused_subgraphs;
+  SaveStreams(dependency_streams, dependency_reused_subgraphs);
+  int64_t dependency_next_stream = context.next_stream;
+
+  RestoreStreams(init_streams, init_reused_subgraphs);
+  context.next_stream = init_next_stream;
+  AssignByCriticalPath(context);
+  // Subgraphs of skipped or attached engines are left to the dependency heuristic.
+  AssignByDependencyPass remain_pass;
+  GE_CHK_STATUS_RET(remain_pass.Run(whole_graph, subgraphs, context), "Assign remaining streams failed.");
+  StreamSimResult cost_model_result;
+  GE_CHK_STATUS_RET(Simulate(cost_model_result), "Simulate streams assigned by cost model failed.");
+
+  GEEVENT("[GEPERFTRACE] Estimated makespan of stream assignment: by dependency %ld (stream num %ld, event num %ld), "
+          "by cost model %ld (stream num %ld, event num %ld).",
+          dependency_result.makespan, dependency_result.stream_num, dependency_result.event_num,
+          cost_model_result.makespan, cost_model_result.stream_num, cost_model_result.event_num);
+
+  if ((cost_model_result.makespan >= dependency_result.makespan) ||
+      (cost_model_result.event_num > dependency_result.event_num)) {
+    GELOGI("Cost model does not reduce the makespan within the event budget, keep streams assigned by dependency.");
+    RestoreStreams(dependency_streams, dependency_reused_subgraphs);
+    context.next_stream = dependency_next_stream;
+  }
+
+  return SUCCESS;
+}
+
+Status AssignByCostModelPass::InitTasks(const vector<SubgraphPtr> &subgraphs, const StreamCostModel &cost_model) {
+  map<NodePtr, size_t> pld_subgraph_index;
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    for (const auto &item : subgraphs[i]->subgraph_info.GetPld2EndMap()) {
+      pld_subgraph_index.emplace(item.first, i);
+    }
+  }
+
+  size_t subgraph_num = subgraphs.size();
+  vector<vector<size_t>> succs(subgraph_num);
+  vector<size_t> in_degrees(subgraph_num, 0);
+  vector<int64_t> costs(subgraph_num, 0);
+  for (size_t i = 0; i < subgraph_num; ++i) {
+    set<size_t> succ_set;
+    for (const auto &item : subgraphs[i]->subgraph_info.GetEnd2PldMap()) {
+      auto iter = pld_subgraph_index.find(item.second);
+      if (iter != pld_subgraph_index.end() && iter->second != i) {
+        succ_set.emplace(iter->second);
+      }
+    }
+    for (size_t succ : succ_set) {
+      succs[i].emplace_back(succ);
+      ++in_degrees[succ];
+    }
+    costs[i] = cost_model.GetGraphCost(subgraphs[i]->subgraph_info.GetSubGraph());
+  }
+
+  // Subgraphs are indexed in the topological order of their nodes, the smallest ready index goes first,
+  // then the bottom level (length of the longest path to exit) of subgraphs.
+  vector<size_t> topo_order;
+  vector<size_t> degrees = in_degrees;
+  set<size_t> ready_subgraphs;
+  for (size_t i = 0; i < subgraph_num; ++i) {
+    if (degrees[i] == 0) {
+      ready_subgraphs.emplace(i);
+    }
+  }
+  while (!ready_subgraphs.empty()) {
+    size_t index = *ready_subgraphs.begin();
+    ready_subgraphs.erase(ready_subgraphs.begin());
+    topo_order.emplace_back(index);
+    for (size_t succ : succs[index]) {
+      if (--degrees[succ] == 0) {
+        ready_subgraphs.emplace(succ);
+      }
+    }
+  }
+  if (topo_order.size() != subgraph_num) {
+    GELOGW("Subgraphs have cycles, %zu of %zu subgraphs are sorted.", topo_order.size(), subgraph_num);
+    return FAILED;
+  }
+
+  vector<int64_t> bottom_levels(subgraph_num, 0);
+  for (auto iter = topo_order.rbegin(); iter != topo_order.rend(); ++iter) {
+    int64_t succ_level = 0;
+    for (size_t succ : succs[*iter]) {
+      succ_level = std::max(succ_level, bottom_levels[succ]);
+    }
+    bottom_levels[*iter] = costs[*iter] + succ_level;
+  }
+
+  // Nodes are issued in topological order, so is every stream, which the simulation has to follow.
+  vector<size_t> positions(subgraph_num, 0);
+  for (size_t pos = 0; pos < subgraph_num; ++pos) {
+    positions[topo_order[pos]] = pos;
+  }
+  subgraphs_.clear();
+  tasks_.clear();
+  bottom_levels_.clear();
+  for (size_t index : topo_order) {
+    StreamSimTask task;
+    task.name = subgraphs[index]->name;
+    task.cost = costs[index];
+    tasks_.emplace_back(task);
+    subgraphs_.emplace_back(subgraphs[index]);
+    bottom_levels_.emplace_back(bottom_levels[index]);
+  }
+  for (size_t i = 0; i < subgraph_num; ++i) {
+    for (size_t succ : succs[i]) {
+      tasks_[positions[succ]].preds.emplace_back(positions[i]);
+    }
+  }
+  critical_path_length_ = bottom_levels.empty() ? 0 : *std::max_element(bottom_levels.begin(), bottom_levels.end());
+
+  GELOGI("Critical path length of %zu subgraphs is %ld.", subgraph_num, critical_path_length_);
+  return SUCCESS;
+}
+
+void AssignByCostModelPass::AssignByCriticalPath(Context &context) {
+  // <engine name, streams assigned by this pass>
+  map<string, vector<int64_t>> engine_streams;
+  // <stream id, time when the last task issued to the stream finishes>
+  map<int64_t, int64_t> stream_free_times;
+  vector<int64_t> finish_times(tasks_.size(), 0);
+
+  for (size_t i = 0; i < tasks_.size(); ++i) {
+    const SubgraphPtr &subgraph = subgraphs_[i];
+    const StreamSimTask &task = tasks_[i];
+
+    // Earliest start time of the task on stream, and the num of events it needs.
+    auto get_start_time = [&](int64_t stream_id, int64_t &event_num) {
+      int64_t start_time = (stream_id == kInvalidStream) ? 0 : stream_free_times[stream_id];
+      event_num = 0;
+      for (size_t pred : task.preds) {
+        int64_t ready_time = finish_times[pred];
+        int64_t pred_stream = subgraphs_[pred]->stream_id;
+        if ((stream_id != kInvalidStream) && (pred_stream != kInvalidStream) && (pred_stream != stream_id)) {
+          ready_time += StreamMakespanSimulator::kEventCost;
+          ++event_num;
+        }
+        start_time = std::max(start_time, ready_time);
+      }
+      return start_time;
+    };
+
+    bool need_assign = !HasAssignedStream(*subgraph) && !IsEngineSkip(*subgraph) && !IsEngineAttach(*subgraph);
+    int64_t event_num = 0;
+    if (need_assign) {
+      auto &streams = engine_streams[subgraph->engine_conf.id];
+      // Starts which do not delay the critical path are equally good, prefer less events and reusing streams then.
+      // Otherwise prefer the earliest start, then less events.
+      int64_t latest_start = critical_path_length_ - bottom_levels_[i];
+      auto is_better = [latest_start](int64_t start_time, int64_t event_num, int64_t best_start,
+                                      int64_t best_event_num) {
+        bool in_slack = (start_time <= latest_start);
+        bool best_in_slack = (best_start <= latest_start);
+        if (in_slack != best_in_slack) {
+          return in_slack;
+        }
+        if (in_slack) {
+          return event_num < best_event_num;
+        }
+        return (start_time < best_start) || ((start_time == best_start) && (event_num < best_event_num));
+      };
+      int64_t best_stream = kInvalidStream;
+      int64_t best_start = 0;
+      int64_t best_event_num = 0;
+      for (int64_t stream_id : streams) {
+        int64_t start_time = get_start_time(stream_id, event_num);
+        if ((best_stream == kInvalidStream) || is_better(start_time, event_num, best_start, best_event_num)) {
+          best_stream = stream_id;
+          best_start = start_time;
+          best_event_num = event_num;
+        }
+      }
+
+      if (static_cast<int64_t>(streams.size()) < subgraph->max_parallel_num) {
+        int64_t new_stream = context.next_stream;
+        int64_t start_time = get_start_time(new_stream, event_num);
+        bool is_new_better = (best_stream == kInvalidStream) ||
+                             ((best_start > latest_start) && (start_time < best_start));
+        if (is_new_better) {
+          best_stream = new_stream;
+          streams.emplace_back(new_stream);
+          ++context.next_stream;
+          GELOGI("Assign new stream %ld for engine %s by cost model.", new_stream, subgraph->engine_conf.id.c_str());
+        }
+      }
+
+      subgraph->stream_id = best_stream;
+      GELOGI("Subgraph %s (cost %ld) is assigned stream %ld by cost model (engine: %s).", subgraph->name.c_str(),
+             task.cost, best_stream, subgraph->engine_conf.id.c_str());
+    }
+
+    int64_t stream_id = IsEngineSkip(*subgraph) ? kInvalidStream : subgraph->stream_id;
+    finish_times[i] = get_start_time(stream_id, event_num) + task.cost;
+    if (stream_id != kInvalidStream) {
+      stream_free_times[stream_id] = finish_times[i];
+    }
+  }
+}
+
+Status AssignByCostModelPass::Simulate(StreamSimResult &result) {
+  for (size_t i = 0; i < tasks_.size(); ++i) {
+    tasks_[i].stream_id = IsEngineSkip(*subgraphs_[i]) ? kInvalidStream : subgraphs_[i]->stream_id;
+  }
+  return StreamMakespanSimulator::Simulate(tasks_, result);
+}
+
+void AssignByCostModelPass::SaveStreams(vector<int64_t> &streams, vector<SubgraphPtr> &reused_subgraphs) const {
+  streams.clear();
+  reused_subgraphs.clear();
+  for (const SubgraphPtr &subgraph : subgraphs_) {
+    streams.emplace_back(subgraph->stream_id);
+    reused_subgraphs.emplace_back(subgraph->reused_subgraph);
+  }
+}
+
+void AssignByCostModelPass::RestoreStreams(const vector<int64_t> &streams,
+                                           const vector<SubgraphPtr> &reused_subgraphs) {
+  for (size_t i = 0; i < subgraphs_.size(); ++i) {
+    subgraphs_[i]->stream_id = streams[i];
+    subgraphs_[i]->reused_subgraph = reused_subgraphs[i];
+  }
+}
+
 Status NodeStreamUpdatePass::Run(ComputeGraphPtr whole_graph, const vector<SubgraphPtr> &subgraphs, Context &context) {
   // Check if all subgraphs have been assigned a stream.
   for (const SubgraphPtr &subgraph : subgraphs) {
@@ -471,6 +721,23 @@ LogicalStreamAllocator::LogicalStreamAllocator(const map<string, SchedulerConf>
   context_.hcom_parallel = hcom_parallel;
 }
 
+Status LogicalStreamAllocator::InitCostModel() {
+  string cost_model_flag;
+  if ((GetContext().GetOption(STREAM_COST_MODEL, cost_model_flag) != GRAPH_SUCCESS) || (cost_model_flag != "1")) {
+    return SUCCESS;
+  }
+
+  auto cost_model = MakeShared<StreamCostModel>();
+  GE_CHECK_NOTNULL(cost_model);
+  string cost_file;
+  if ((GetContext().GetOption(STREAM_COST_FILE, cost_file) == GRAPH_SUCCESS) && !cost_file.empty()) {
+    GE_CHK_STATUS_RET(cost_model->LoadCostFile(cost_file), "Load stream cost file %s failed.", cost_file.c_str());
+  }
+  context_.cost_model = cost_model;
+  GELOGI("Stream cost model is enabled.");
+  return SUCCESS;
+}
+
 Status LogicalStreamAllocator::Assign(const ComputeGraphPtr &whole_graph, const vector<SubGraphInfoPtr> &subgraph_infos,
                                       int64_t &stream_num) {
   GE_CHECK_NOTNULL(whole_graph);
@@ -485,6 +752,8 @@ Status LogicalStreamAllocator::Assign(const ComputeGraphPtr &whole_graph, const
     }
   }
 
+  GE_CHK_STATUS_RET(InitCostModel(), "Init stream cost model failed.");
+
   vector<SubgraphPtr> subgraphs;
   Status status = ConvertSubgraphs(subgraph_infos, engine_confs, subgraphs);
   if (status != SUCCESS) {
@@ -536,6 +805,7 @@ Status LogicalStreamAllocator::RunPasses(const ComputeGraphPtr &whole_graph, con
   vector<LogicalStreamPassPtr> passes;
   passes.emplace_back(MakeShared<AssignByLabelPass>());
   passes.emplace_back(MakeShared<IndependentStreamPass>());
+  passes.emplace_back(MakeShared<AssignByCostModelPass>());
   passes.emplace_back(MakeShared<AssignByDependencyPass>());
   passes.emplace_back(MakeShared<NodeStreamUpdatePass>());
   passes.emplace_back(MakeShared<AllReduceParallelPass>());
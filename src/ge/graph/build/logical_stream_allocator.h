@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "engine_manager/dnnengine_manager.h"
+#include "graph/build/stream_cost_model.h"
 #include "graph/manager/graph_manager_utils.h"
 
 namespace ge {
@@ -63,6 +64,8 @@ class LogicalStreamPass {
     // Next stream id.
     int64_t next_stream = 0;
     bool hcom_parallel = false;
+    // Cost model of ops, streams are assigned without cost model if it is nullptr.
+    std::shared_ptr<StreamCostModel> cost_model = nullptr;
   };
 
   explicit LogicalStreamPass(const std::string &name);
@@ -134,6 +137,30 @@ class AssignByDependencyPass : public LogicalStreamPass {
   std::vector<std::pair<SubgraphPtr, SubgraphPtr>> reused_subgraphs_;
 };
 
+// Assign streams by estimated op costs, so that parallel branches overlapping in time get different streams.
+// The result of AssignByDependencyPass is kept if the estimated makespan could not be reduced within its event num.
+class AssignByCostModelPass : public LogicalStreamPass {
+ public:
+  STREAM_PASS_DEFAULT_FUNC(AssignByCostModelPass);
+  Status Run(ComputeGraphPtr whole_graph, const std::vector<SubgraphPtr> &subgraphs, Context &context) override;
+
+ private:
+  Status InitTasks(const std::vector<SubgraphPtr> &subgraphs, const StreamCostModel &cost_model);
+  void AssignByCriticalPath(Context &context);
+  Status Simulate(StreamSimResult &result);
+
+  void SaveStreams(std::vector<int64_t> &streams, std::vector<SubgraphPtr> &reused_subgraphs) const;
+  void RestoreStreams(const std::vector<int64_t> &streams, const std::vector<SubgraphPtr> &reused_subgraphs);
+
+  // Subgraphs in topological order, which is the order nodes are issued to streams.
+  std::vector<SubgraphPtr> subgraphs_;
+  // Tasks of subgraphs_, stream ids are filled when simulating.
+  std::vector<StreamSimTask> tasks_;
+  // Length of the longest path from each of subgraphs_ to exit, including its own cost.
+  std::vector<int64_t> bottom_levels_;
+  int64_t critical_path_length_ = 0;
+};
+
 // Update the stream of subgraphs to nodes.
 class NodeStreamUpdatePass : public LogicalStreamPass {
  public:
@@ -180,6 +207,7 @@ class LogicalStreamAllocator {
                           const std::map<std::string, EngineConfPtr> &engine_confs,
                           std::vector<SubgraphPtr> &subgraphs);
   Status RunPasses(const ComputeGraphPtr &whole_graph, const std::vector<SubgraphPtr> &subgraphs, int64_t &stream_num);
+  Status InitCostModel();
 
   const std::map<std::string, SchedulerConf> &scheduler_confs_;
   const std::map<std::string, int> &max_parallel_num_;
@@ -16,6 +16,7 @@
 
 #include "graph/build/memory/block_mem_assigner.h"
 #include <algorithm>
+#include <set>
 #include <sstream>
 
 #include "framework/common/debug/ge_log.h"
@@ -38,6 +39,7 @@ namespace {
 const char *const kAttrNameWorkspaceReuseFlag = "workspace_reuse_flag";
 const char *const kL2FusionDynamicConvergeOp = "l2fusion_dynamic_converge_op";
 const char *const kDisableReuseMemory = "ge.exec.disableReuseMemory";
+const char *const kFusionVirtualOp = "fusion_virtual_op";
 const int kReuseMaxCount = 10;
 }  // namespace
 
@@ -64,6 +66,15 @@ void MemoryBlock::Resize() {
   }
 }
 
+void MemoryBlock::UpdateDataNodeFlag(const NodePtr &node) {
+  GE_IF_BOOL_EXEC(node == nullptr, return);
+  const string &type = node->GetType();
+  if ((type == DATA_TYPE) || (type == ENTER) || (type == REFENTER) || (type == AIPP_DATA_TYPE) ||
+      (type == NEXTITERATION) || (type == REFNEXTITERATION)) {
+    has_data_node_ = true;
+  }
+}
+
 bool MemoryBlock::IsSameLabel(std::string &first_batch_label) {
   if (node_type_index_list_.empty()) {
     return false;
@@ -120,7 +131,11 @@ string MemoryBlock::String() {
 }
 
 BlockMemAssigner::BlockMemAssigner(ge::ComputeGraphPtr compute_graph)
-    : mem_offset_(0), compute_graph_(std::move(compute_graph)) {}
+    : mem_offset_(0),
+      compute_graph_(std::move(compute_graph)),
+      in_place_enabled_(false),
+      in_place_size_(0),
+      virtual_output_size_(0) {}
 
 BlockMemAssigner::~BlockMemAssigner() {
   for (MemoryBlock *memory_block : memory_blocks_) {
@@ -240,6 +255,36 @@ bool CanReuseByStream(const std::unordered_set<int64_t> &reuse_stream, MemoryBlo
   return can_reuse;
 }
 
+// Elementwise ops, whose output can be written over an input of the same shape
+bool IsInPlaceOpType(const string &type) {
+  static const std::set<string> kInPlaceOpTypes = {RELU,  RELU6,  SIGMOID, TANH,    ACTIVATION, ELU,        SELU,
+                                                   ADD,   SUB,    MUL,     REALDIV, MAXIMUM,    MINIMUM,    BIASADD,
+                                                   NEG,   EXP,    LOG,     SQRT,    RSQRT,      RECIPROCAL, SQUARE,
+                                                   FLOOR, SOFTPLUS, SOFTSIGN};
+  return kInPlaceOpTypes.count(type) > 0;
+}
+
+// Memory of these nodes is laid out again by GraphMemoryAssigner, or is shared with other nodes
+bool HasSpecialMemoryLayout(const NodePtr &node) {
+  auto op_desc = node->GetOpDesc();
+  if ((op_desc == nullptr) || (node->GetType() == STREAMMERGE) || op_desc->HasAttr(kFusionVirtualOp) ||
+      op_desc->HasAttr(ATOMIC_ATTR_OUTPUT_INDEX) || op_desc->HasAttr(ATOMIC_ATTR_INPUT_INDEX)) {
+    return true;
+  }
+  bool is_continuous_input = false;
+  bool is_continuous_output = false;
+  bool is_ref = false;
+  (void)ge::AttrUtils::GetBool(op_desc, ATTR_NAME_CONTINUOUS_INPUT, is_continuous_input);
+  (void)ge::AttrUtils::GetBool(op_desc, ATTR_NAME_CONTINUOUS_OUTPUT, is_continuous_output);
+  (void)ge::AttrUtils::GetBool(op_desc, ATTR_NAME_REFERENCE, is_ref);
+  return is_continuous_input || is_continuous_output || is_ref;
+}
+
+bool IsVirtualNode(const NodePtr &node) {
+  return ((node->GetType() == CONCAT) || (node->GetType() == SPLIT) || (node->GetType() == SPLITV)) &&
+         (node->GetOpDesc() != nullptr) && node->GetOpDesc()->HasAttr(kFusionVirtualOp);
+}
+
 MemoryBlock *BlockMemAssigner::ApplyMemory(size_t block_size, size_t real_size, MemoryType mem_type, const NodePtr &n,
                                            uint32_t out_index, const vector<bool> &workspace_reuse_flag) {
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(n == nullptr, return nullptr, "Input parameter n is null.");
@@ -275,15 +320,7 @@ MemoryBlock *BlockMemAssigner::ApplyMemory(size_t block_size, size_t real_size,
         if (is_reuse_memory && map_iter != reusable_streams_map_.end()) {
           for (auto it = reusable_blocks_.begin(); it != reusable_blocks_.end(); ++it) {
             MemoryBlock *reusable_block = *it;
-            bool is_data = false;
-            for (auto node_type : reusable_block->NodeTypeIndexList()) {
-              GE_IF_BOOL_EXEC(node_type.node_ != nullptr, string type = node_type.node_->GetType();
-                              bool flag = (type == DATA_TYPE) || (type == ENTER) || (type == REFENTER) ||
-                                          (type == AIPP_DATA_TYPE) || (type == NEXTITERATION) ||
-                                          (type == REFNEXTITERATION);
-                              GE_IF_BOOL_EXEC(flag, is_data = true; break;););
-            }
-            GE_IF_BOOL_EXEC(is_data == true, continue);
+            GE_IF_BOOL_EXEC(reusable_block->HasDataNode(), continue);
 
             // A node can reuse blocks of the same stream and preorder streams
             if (CanReuseBySize(reusable_block_counts_, *reusable_block, block_size) &&
@@ -329,7 +366,12 @@ MemoryBlock *BlockMemAssigner::ApplyOutMemory(const NodePtr &n, uint32_t index,
     GE_IF_BOOL_EXEC(ge::TensorUtils::GetSize(*output_op_desc, size) != SUCCESS, GELOGI("Get size failed"));
   }
 
-  if (reuse_input) {
+  MemoryBlock *in_place_block = reuse_input ? nullptr : GetInPlaceBlock(n, index, size);
+  if (in_place_block != nullptr) {
+    block = in_place_block;
+    block->AddNodeTypeIndex({n, kOutput, index}, size);
+    reuse_input = true;
+  } else if (reuse_input) {
     auto in_data_anchor = n->GetInDataAnchor(reuse_input_index);
     GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(in_data_anchor == nullptr, return nullptr, "In data anchor is null.");
     auto peer_out_anchor = in_data_anchor->GetPeerOutAnchor();
@@ -427,6 +469,61 @@ bool IsReferencePreviousNodeOutputMemory(const ge::NodePtr &node, uint32_t outpu
   return false;
 }
 
+MemoryBlock *BlockMemAssigner::GetInPlaceBlock(const NodePtr &n, uint32_t index, uint32_t size) {
+  auto op_desc = n->GetOpDesc();
+  if (!in_place_enabled_ || (index != 0) || (op_desc->GetOutputsSize() != 1) || !IsInPlaceOpType(n->GetType()) ||
+      HasSpecialMemoryLayout(n)) {
+    return nullptr;
+  }
+  auto out_desc = op_desc->GetOutputDescPtr(index);
+  auto out_data_anchor = n->GetOutDataAnchor(index);
+  GE_IF_BOOL_EXEC((out_desc == nullptr) || (out_data_anchor == nullptr), return nullptr);
+  for (const auto &peer_in_anchor : out_data_anchor->GetPeerInDataAnchors()) {
+    auto dst_node = peer_in_anchor->GetOwnerNode();
+    if (IsDirectOutputNode(dst_node, peer_in_anchor->GetIdx()) || HasSpecialMemoryLayout(dst_node)) {
+      return nullptr;
+    }
+  }
+
+  int64_t stream_id = op_desc->GetStreamId();
+  for (const auto &in_anchor : n->GetAllInDataAnchors()) {
+    auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+    auto in_desc = op_desc->GetInputDescPtr(static_cast<uint32_t>(in_anchor->GetIdx()));
+    if ((peer_out_anchor == nullptr) || (in_desc == nullptr) ||
+        (in_desc->GetShape().GetDims() != out_desc->GetShape().GetDims()) ||
+        (in_desc->GetDataType() != out_desc->GetDataType()) || (in_desc->GetFormat() != out_desc->GetFormat())) {
+      continue;
+    }
+    // Input is read by this node only, and is not an output of the graph
+    if ((peer_out_anchor->GetPeerInDataAnchors().size() != 1) || IsOutputBlock(in_anchor)) {
+      continue;
+    }
+    auto src_node = peer_out_anchor->GetOwnerNode();
+    if ((src_node->GetOpDesc() == nullptr) || (src_node->GetOpDesc()->GetStreamId() != stream_id) ||
+        HasSpecialMemoryLayout(src_node)) {
+      continue;
+    }
+    auto iter = node_out_blocks_.find(src_node->GetName());
+    if (iter == node_out_blocks_.end()) {
+      continue;
+    }
+    for (MemoryBlock *block : iter->second) {
+      if ((block == nullptr) || block->NodeTypeIndexList().empty()) {
+        continue;
+      }
+      const NodeTypeIndex &last = block->NodeTypeIndexList().back();
+      if ((last.node_ == src_node) && (last.mem_type_ == kOutput) &&
+          (last.index_ == static_cast<uint32_t>(peer_out_anchor->GetIdx())) && (block->ref_count_ == 1) &&
+          (block->stream_id_ == stream_id) && (block->Size() >= size) && !block->HasDataNode()) {
+        GELOGD("Output of %s is written over its input %d in place.", n->GetName().c_str(), in_anchor->GetIdx());
+        in_place_size_ += size;
+        return block;
+      }
+    }
+  }
+  return nullptr;
+}
+
 void BlockMemAssigner::ReleaseMemory(MemoryBlock *to_release, vector<MemoryBlock *> &reusable_memory) {
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(to_release == nullptr, return, "Input parameter to_release is null.");
   GE_CHK_TRUE_EXEC_INFO(to_release->ref_count_ <= 0, return, "Release memory");
@@ -499,6 +596,7 @@ void BlockMemAssigner::AssignMemoryWithReuse(vector<int64_t> &ranges) {
   } else {
     GEEVENT("Reuse memory open");
   }
+  in_place_enabled_ = (ge_disable_reuse_mem_env != "1");
 
   for (const NodePtr &n : compute_graph_->GetDirectNode()) {
     auto node_op_desc = n->GetOpDesc();
@@ -518,6 +616,12 @@ void BlockMemAssigner::AssignMemoryWithReuse(vector<int64_t> &ranges) {
         zero_memory_list_.emplace_back(n, kOutput, i);
         continue;
       }
+      // Outputs of virtual nodes are views of their inputs, laid out by GraphMemoryAssigner
+      if (IsVirtualNode(n)) {
+        zero_memory_list_.emplace_back(n, kOutput, i);
+        virtual_output_size_ += size;
+        continue;
+      }
       MemoryBlock *mem_block = ApplyOutMemory(n, i, ranges);
       if (mem_block != nullptr) {
         node_out_blocks_[n->GetName()].emplace_back(mem_block);
@@ -543,6 +647,8 @@ void BlockMemAssigner::AssignMemoryWithReuse(vector<int64_t> &ranges) {
     }
     ReleaseInputNodeOutMemory(n, node_out_blocks_, reusable_blocks_);
   }
+  GELOGI("Outputs written in place: %ld bytes, outputs of virtual nodes: %ld bytes.", in_place_size_,
+         virtual_output_size_);
 
   GELOGD("Assigned memory blocks:");
   for (auto mem_block : memory_blocks_) {
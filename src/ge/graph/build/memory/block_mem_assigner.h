@@ -48,6 +48,7 @@ class MemoryBlock {
         stream_id_(0),
         deleted_block_(false),
         block_size_(block_size),
+        has_data_node_(false),
         head_offset_(0),
         tail_offset_(0) {}
 
@@ -60,6 +61,7 @@ class MemoryBlock {
   void Init(size_t real_size, MemoryType type, const ge::NodePtr &node, uint32_t out_index) {
     real_size_list_.emplace_back(real_size);
     node_type_index_list_.emplace_back(node, type, out_index);
+    UpdateDataNodeFlag(node);
   }
   size_t Size() const { return block_size_; }
 
@@ -74,6 +76,7 @@ class MemoryBlock {
   void AddNodeTypeIndex(const NodeTypeIndex &node_type_index, size_t real_size) {
     node_type_index_list_.emplace_back(node_type_index);
     real_size_list_.emplace_back(real_size);
+    UpdateDataNodeFlag(node_type_index.node_);
   }
 
   const std::vector<NodeTypeIndex> &NodeTypeIndexList() const { return node_type_index_list_; }
@@ -85,6 +88,9 @@ class MemoryBlock {
 
   bool IsSameLabel(std::string &first_batch_label);
 
+  // Whether memory of data, enter or next iteration nodes is in the block, which must not be reused
+  bool HasDataNode() const { return has_data_node_; }
+
   int ref_count_;
   int64_t stream_id_;
   bool deleted_block_;
@@ -95,6 +101,9 @@ class MemoryBlock {
   size_t head_offset_;
   size_t tail_offset_;
   std::vector<NodeTypeIndex> node_type_index_list_;
+  bool has_data_node_;
+
+  void UpdateDataNodeFlag(const ge::NodePtr &node);
 };
 
 class BlockMemAssigner : public MemAssigner {
@@ -111,6 +120,12 @@ class BlockMemAssigner : public MemAssigner {
 
   size_t GetMemOffset() const { return mem_offset_; }
 
+  // Bytes of outputs written over inputs which die at their nodes
+  int64_t GetInPlaceSize() const { return in_place_size_; }
+
+  // Bytes of outputs of virtual nodes, which need no memory of their own
+  int64_t GetVirtualOutputSize() const { return virtual_output_size_; }
+
   ///
   /// @ingroup domi
   /// @brief   memory size fixed for reuse. get memory range
@@ -200,6 +215,18 @@ class BlockMemAssigner : public MemAssigner {
   ///
   MemoryBlock *ApplyOutMemory(const ge::NodePtr &n, uint32_t index, const std::vector<int64_t> &ranges);
 
+  ///
+  /// @ingroup GE
+  /// @brief Find the block of an input of an elementwise node, which is read by the node only, so the output can
+  ///        be written over the input
+  /// @param [in] n node in compute_graph_
+  /// @param [in] index output node index
+  /// @param [in] size output size
+  /// @return MemoryBlock* block of the input, nullptr if none of the inputs can be written over
+  /// @author
+  ///
+  MemoryBlock *GetInPlaceBlock(const ge::NodePtr &n, uint32_t index, uint32_t size);
+
   ///
   /// @ingroup GE
   /// @brief Traversing the compute_graph_ to apply for memory while considering reuse
@@ -279,6 +306,12 @@ class BlockMemAssigner : public MemAssigner {
 
   // save stream_id and reusable stream_ids
   std::unordered_map<int64_t, std::unordered_set<int64_t>> reusable_streams_map_;
+
+  bool in_place_enabled_;
+
+  int64_t in_place_size_;
+
+  int64_t virtual_output_size_;
 };
 }  // namespace ge
 #endif  // GE_GRAPH_BUILD_MEMORY_BLOCK_MEM_ASSIGNER_H_
@@ -15,8 +15,10 @@
  */
 
 #include "graph/build/memory/graph_mem_assigner.h"
+#include <algorithm>
 #include <cstring>
 #include <set>
+#include "common/build_tracer.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/build/memory/hybrid_mem_assigner.h"
 #include "graph/build/memory/var_mem_assign_util.h"
@@ -26,9 +28,51 @@
 #include "graph/manager/graph_var_manager.h"
 #include "graph/utils/tensor_utils.h"
 #include "graph/utils/type_utils.h"
+#include "omg/omg_inner_types.h"
 
 namespace {
 const int kAllInputAddrIsAtomic = -1;
+const char *const kFusionVirtualOp = "fusion_virtual_op";
+// Data input of split, the others are split_dim of Split, and size_splits and split_dim of SplitV
+const char *const kSplitDataInputName = "x";
+const int kSplitDataInputIndex = 1;
+const int kSplitVDataInputIndex = 0;
+
+// Outputs are contiguous slices of the input if they are split along an axis, and all dims before it are 1
+bool IsOuterAxisSplit(const ge::GeTensorDesc &input_desc, const ge::OpDescPtr &op_desc) {
+  const std::vector<int64_t> input_dims = input_desc.GetShape().GetDims();
+  const auto output_descs = op_desc->GetAllOutputsDescPtr();
+  size_t split_axis = input_dims.size();
+  for (const auto &output_desc : output_descs) {
+    const std::vector<int64_t> output_dims = output_desc->GetShape().GetDims();
+    if ((output_dims.size() != input_dims.size()) || (output_desc->GetFormat() != input_desc.GetFormat()) ||
+        (output_desc->GetDataType() != input_desc.GetDataType())) {
+      return false;
+    }
+    for (size_t i = 0; i < input_dims.size(); ++i) {
+      if (output_dims[i] == input_dims[i]) {
+        continue;
+      }
+      if ((split_axis != input_dims.size()) && (split_axis != i)) {
+        return false;
+      }
+      split_axis = i;
+    }
+  }
+  if (split_axis == input_dims.size()) {
+    return output_descs.size() == 1;
+  }
+  for (size_t i = 0; i < split_axis; ++i) {
+    if (input_dims[i] != 1) {
+      return false;
+    }
+  }
+  int64_t split_dim_sum = 0;
+  for (const auto &output_desc : output_descs) {
+    split_dim_sum += output_desc->GetShape().GetDim(split_axis);
+  }
+  return split_dim_sum == input_dims[split_axis];
+}
 }  // namespace
 namespace ge {
 Status VariableMemoryAssigner::Assign() {
@@ -105,10 +149,14 @@ Status GraphMemoryAssigner::ReAssignMemory(bool is_loop_graph, size_t &mem_offse
 
   GE_CHK_STATUS_RET(ReAssignVirtualConcatMemory(), "ReAssignVirtualConcatMemory Failed!");
 
+  GE_CHK_STATUS_RET(ReAssignVirtualSplitMemory(), "ReAssignVirtualSplitMemory Failed!");
+
   GE_CHK_STATUS_RET(ReAssignMergeMemory(), "ReAssignMergeMemory Failed!");
 
   GE_CHK_STATUS_RET(ReAssignAtomicMemory(is_loop_graph), "ReAssignAtomicMemory Failed!");
 
+  GE_CHK_STATUS_RET(SetAtomicCleanAttrs(), "SetAtomicCleanAttrs Failed!");
+
   mem_offset = memory_offset_[0].mem_offset_;
 
   if (mem_offset > VarManager::Instance(0)->GetGraphMemoryMaxSize()) {
@@ -122,41 +170,21 @@ Status GraphMemoryAssigner::ReAssignMemory(bool is_loop_graph, size_t &mem_offse
 Status GraphMemoryAssigner::ReAssignContinuousMemory(bool is_loop_graph) {
   GELOGI("Begin to reassign continuous memory");
   Status ret;
+  // Continuous input of atomic nodes is assigned at last, so their clean ranges are next to each other
+  vector<NodePtr> deferred_nodes;
   for (auto &node : compute_graph_->GetDirectNode()) {
     // Get the continuous input type of the node, default is false
     bool is_input_continuous = false;
     GE_CHECK_NOTNULL(node->GetOpDesc());
     // If GetBool fail, is_input_continuous is false.
     (void)ge::AttrUtils::GetBool(node->GetOpDesc(), ATTR_NAME_CONTINUOUS_INPUT, is_input_continuous);
-    int64_t mem_clean_start = memory_offset_[0].mem_offset_;
     // Assign continuous input memory
     if (is_input_continuous) {
-      ret = AssignContinuousInputMemory(node);
-      if (ret != ge::SUCCESS) {
-        GELOGE(ret, "Assign continuous input memory failed!");
-        return ret;
-      }
-
-      memory_offset_[0].mem_offset_ += kMemAlignSize;
-
-      // Clean up atomic address, eg, hcom node
-      vector<int32_t> input_indexes;
-      // If GetListInt fail, input_indexes is empty.
-      (void)ge::AttrUtils::GetListInt(node->GetOpDesc(), ATOMIC_ATTR_INPUT_INDEX, input_indexes);
-
-      if (!input_indexes.empty() && input_indexes[0] == kAllInputAddrIsAtomic) {
-        // check whether there is an atomic conflict between the current node and the peer out node
-        if (!CheckInputIsSupportAtomic(node)) {
-          GELOGE(ge::FAILED,
-                 "There is an atomic conflict between the current node and the peer out node, not supported!");
-          return ge::FAILED;
-        } else if (is_loop_graph) {
-          GE_CHK_STATUS_RET(SetLoopGraphAtomicAttr(node, mem_clean_start));
-        } else {
-          int64_t mem_clean_size = memory_offset_[0].mem_offset_ - mem_clean_start;
-          GE_CHK_STATUS_RET(SetAtomicCleanAttr(nullptr, mem_clean_start, mem_clean_size), "SetAtomicCleanAttr failed.");
-        }
+      if (CanDeferContinuousInput(node)) {
+        deferred_nodes.emplace_back(node);
+        continue;
       }
+      GE_CHK_STATUS_RET(ReAssignContinuousInputMemory(node, is_loop_graph));
     }
 
     // Get the reference type of the node, default is false
@@ -187,10 +215,76 @@ Status GraphMemoryAssigner::ReAssignContinuousMemory(bool is_loop_graph) {
     }
   }
 
+  for (auto &node : deferred_nodes) {
+    GE_CHK_STATUS_RET(ReAssignContinuousInputMemory(node, is_loop_graph));
+  }
+
   GELOGI("After reassign continuous memory, memoffset = %zu.", memory_offset_[0].mem_offset_);
   return ge::SUCCESS;
 }
 
+Status GraphMemoryAssigner::ReAssignContinuousInputMemory(const ge::NodePtr &node, bool is_loop_graph) {
+  int64_t mem_clean_start = memory_offset_[0].mem_offset_;
+  Status ret = AssignContinuousInputMemory(node);
+  if (ret != ge::SUCCESS) {
+    GELOGE(ret, "Assign continuous input memory failed!");
+    return ret;
+  }
+
+  memory_offset_[0].mem_offset_ += kMemAlignSize;
+
+  // Clean up atomic address, eg, hcom node
+  vector<int32_t> input_indexes;
+  // If GetListInt fail, input_indexes is empty.
+  (void)ge::AttrUtils::GetListInt(node->GetOpDesc(), ATOMIC_ATTR_INPUT_INDEX, input_indexes);
+
+  if (!input_indexes.empty() && input_indexes[0] == kAllInputAddrIsAtomic) {
+    // check whether there is an atomic conflict between the current node and the peer out node
+    if (!CheckInputIsSupportAtomic(node)) {
+      GELOGE(ge::FAILED, "There is an atomic conflict between the current node and the peer out node, not supported!");
+      return ge::FAILED;
+    }
+    int64_t mem_clean_size = memory_offset_[0].mem_offset_ - mem_clean_start;
+    AddAtomicCleanRange(node, is_loop_graph, mem_clean_start, mem_clean_size);
+  }
+  return ge::SUCCESS;
+}
+
+bool GraphMemoryAssigner::CanDeferContinuousInput(const ge::NodePtr &node) const {
+  auto op_desc = node->GetOpDesc();
+  vector<int32_t> input_indexes;
+  (void)ge::AttrUtils::GetListInt(op_desc, ATOMIC_ATTR_INPUT_INDEX, input_indexes);
+  bool is_ref = false;
+  (void)ge::AttrUtils::GetBool(op_desc, ATTR_NAME_REFERENCE, is_ref);
+  bool is_output_continuous = false;
+  (void)ge::AttrUtils::GetBool(op_desc, ATTR_NAME_CONTINUOUS_OUTPUT, is_output_continuous);
+  if (input_indexes.empty() || (input_indexes[0] != kAllInputAddrIsAtomic) || is_ref || is_output_continuous) {
+    return false;
+  }
+
+  // Offsets of inputs are read by ref and continuous input nodes sharing the inputs
+  for (auto &in_data_anchor : node->GetAllInDataAnchors()) {
+    auto peer_out_data_anchor = in_data_anchor->GetPeerOutAnchor();
+    if (peer_out_data_anchor == nullptr) {
+      continue;
+    }
+    for (auto &peer_in_data_anchor : peer_out_data_anchor->GetPeerInDataAnchors()) {
+      auto reader = peer_in_data_anchor->GetOwnerNode();
+      if ((reader == node) || (reader->GetOpDesc() == nullptr)) {
+        continue;
+      }
+      bool is_reader_ref = false;
+      (void)ge::AttrUtils::GetBool(reader->GetOpDesc(), ATTR_NAME_REFERENCE, is_reader_ref);
+      bool is_reader_input_continuous = false;
+      (void)ge::AttrUtils::GetBool(reader->GetOpDesc(), ATTR_NAME_CONTINUOUS_INPUT, is_reader_input_continuous);
+      if (is_reader_ref || is_reader_input_continuous) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 Status GraphMemoryAssigner::AssignContinuousInputMemory(const ge::NodePtr &node) {
   GELOGI("Current node %s needs continuous input.", node->GetName().c_str());
   for (auto &in_data_anchor : node->GetAllInDataAnchors()) {
@@ -287,7 +381,7 @@ Status GraphMemoryAssigner::ReAssignVirtualConcatMemory() {
     if (n->GetOpDesc()->GetType() == CONCAT) {
       int64_t is_node_virtual;
       GE_IF_BOOL_EXEC(
-        !(ge::AttrUtils::GetInt(n->GetOpDesc(), "fusion_virtual_op", is_node_virtual)),  // Need  to  change
+        !(ge::AttrUtils::GetInt(n->GetOpDesc(), kFusionVirtualOp, is_node_virtual)),  // Need  to  change
         continue;);
       vector<int64_t> output_list = n->GetOpDesc()->GetOutputOffset();
       if (output_list.empty()) {
@@ -358,6 +452,146 @@ Status GraphMemoryAssigner::ReAssignVirtualConcatMemory() {
   return SUCCESS;
 }
 
+Status GraphMemoryAssigner::ReAssignVirtualSplitMemory() {
+  for (const auto &n : compute_graph_->GetAllNodes()) {
+    GE_CHECK_NOTNULL(n->GetOpDesc());
+    int64_t is_node_virtual = 0;
+    if (((n->GetType() != SPLIT) && (n->GetType() != SPLITV)) ||
+        !ge::AttrUtils::GetInt(n->GetOpDesc(), kFusionVirtualOp, is_node_virtual)) {
+      continue;
+    }
+    GE_CHK_STATUS_RET(AssignVirtualSplitMemory(n), "Assign memory of virtual split %s failed.", n->GetName().c_str());
+  }
+
+  GELOGI("After reassign virtual split memory, memoffset = %zu, size of views = %ld.", memory_offset_[0].mem_offset_,
+         virtual_split_size_);
+  GE_TRACE_COUNTER("virtual_split_bytes", virtual_split_size_);
+  return SUCCESS;
+}
+
+Status GraphMemoryAssigner::AssignVirtualSplitMemory(const ge::NodePtr &node) {
+  auto op_desc = node->GetOpDesc();
+  int data_index = op_desc->GetInputIndexByName(kSplitDataInputName);
+  if (data_index < 0) {
+    data_index = (node->GetType() == SPLIT) ? kSplitDataInputIndex : kSplitVDataInputIndex;
+  }
+  InDataAnchorPtr data_anchor = node->GetInDataAnchor(data_index);
+  if ((data_anchor == nullptr) || (data_anchor->GetPeerOutAnchor() == nullptr)) {
+    GELOGE(ge::PARAM_INVALID, "Data input %d of virtual split %s is not connected.", data_index,
+           op_desc->GetName().c_str());
+    return ge::PARAM_INVALID;
+  }
+  auto peer_out_data_anchor = data_anchor->GetPeerOutAnchor();
+  auto peer_op_desc = peer_out_data_anchor->GetOwnerNode()->GetOpDesc();
+  GE_CHECK_NOTNULL(peer_op_desc);
+  const GeTensorDesc &input_desc = op_desc->GetInputDesc(static_cast<uint32_t>(data_anchor->GetIdx()));
+  if (!IsOuterAxisSplit(input_desc, op_desc)) {
+    GELOGE(ge::PARAM_INVALID, "Outputs of virtual split %s are not contiguous slices of its input.",
+           op_desc->GetName().c_str());
+    return ge::PARAM_INVALID;
+  }
+
+  bool is_peer_reference = false;
+  bool is_peer_output_continuous = false;
+  // If GetBool fail, is_peer_reference and is_peer_output_continuous are false.
+  (void)ge::AttrUtils::GetBool(peer_op_desc, ATTR_NAME_REFERENCE, is_peer_reference);
+  (void)ge::AttrUtils::GetBool(peer_op_desc, ATTR_NAME_CONTINUOUS_OUTPUT, is_peer_output_continuous);
+  if (is_peer_reference || is_peer_output_continuous) {
+    GELOGE(ge::PARAM_INVALID,
+           "Current node %s is a virtual split, while the previous node %s requires reference or continuous output. "
+           "There may be conflict between the two. This node is not supported now.",
+           op_desc->GetName().c_str(), peer_op_desc->GetName().c_str());
+    return ge::PARAM_INVALID;
+  }
+  // Readers of the views must not write them or move them
+  for (const auto &out_data_anchor : node->GetAllOutDataAnchors()) {
+    for (const auto &peer_in_data_anchor : out_data_anchor->GetPeerInDataAnchors()) {
+      auto reader_op_desc = peer_in_data_anchor->GetOwnerNode()->GetOpDesc();
+      GE_CHECK_NOTNULL(reader_op_desc);
+      bool is_reader_ref = false;
+      bool is_reader_input_continuous = false;
+      (void)ge::AttrUtils::GetBool(reader_op_desc, ATTR_NAME_REFERENCE, is_reader_ref);
+      (void)ge::AttrUtils::GetBool(reader_op_desc, ATTR_NAME_CONTINUOUS_INPUT, is_reader_input_continuous);
+      if (is_reader_ref || is_reader_input_continuous || reader_op_desc->HasAttr(kFusionVirtualOp)) {
+        GELOGE(ge::PARAM_INVALID,
+               "Current node %s is a virtual split, while the next node %s requires reference, continuous input or "
+               "is virtual. There may be conflict between the two. This node is not supported now.",
+               op_desc->GetName().c_str(), reader_op_desc->GetName().c_str());
+        return ge::PARAM_INVALID;
+      }
+    }
+  }
+
+  int64_t input_offset = static_cast<int64_t>(memory_offset_[0].mem_offset_);
+  // Slices are next to each other by real size, while readers may read up to the size of their input desc
+  vector<int64_t> slice_offsets;
+  vector<int64_t> slice_sizes;
+  int64_t slice_offset = input_offset;
+  for (const auto &out_data_anchor : node->GetAllOutDataAnchors()) {
+    auto output_desc = op_desc->GetOutputDescPtr(static_cast<uint32_t>(out_data_anchor->GetIdx()));
+    GE_CHECK_NOTNULL(output_desc);
+    // Tasks reading the views require their addresses aligned, as memory assigned to any other tensor
+    if (slice_offset % kMemAlignSize != 0) {
+      GELOGE(ge::PARAM_INVALID, "Output %d of virtual split %s is at offset %ld, which is not aligned to %ld.",
+             out_data_anchor->GetIdx(), op_desc->GetName().c_str(), slice_offset - input_offset, kMemAlignSize);
+      return ge::PARAM_INVALID;
+    }
+    int64_t output_mem_size = 0;
+    graphStatus graph_status = TensorUtils::CalcTensorMemSize(output_desc->GetShape(), output_desc->GetFormat(),
+                                                              output_desc->GetDataType(), output_mem_size);
+    if ((graph_status != GRAPH_SUCCESS) || (output_mem_size < 0)) {
+      GELOGE(FAILED, "CalcTensorMemSize of %s output %d failed!", op_desc->GetName().c_str(),
+             out_data_anchor->GetIdx());
+      return FAILED;
+    }
+    uint32_t out_size = 0;
+    if (ge::TensorUtils::GetSize(*output_desc, out_size) != ge::SUCCESS) {
+      GELOGE(FAILED, "GetSize failed.");
+      return FAILED;
+    }
+    slice_offsets.push_back(slice_offset);
+    slice_sizes.push_back(static_cast<int64_t>(out_size));
+    slice_offset += output_mem_size;
+  }
+
+  vector<int64_t> peer_output_list = peer_op_desc->GetOutputOffset();
+  if (peer_out_data_anchor->GetIdx() >= static_cast<int>(peer_output_list.size())) {
+    GELOGE(ge::FAILED, "index : %d is out of range.", peer_out_data_anchor->GetIdx());
+    return ge::FAILED;
+  }
+  uint32_t input_size = 0;
+  if (ge::TensorUtils::GetSize(*(peer_op_desc->GetOutputDescPtr(peer_out_data_anchor->GetIdx())), input_size) !=
+      ge::SUCCESS) {
+    GELOGE(FAILED, "GetSize failed.");
+    return FAILED;
+  }
+
+  vector<int64_t> output_list = op_desc->GetOutputOffset();
+  if (op_desc->GetOutputsSize() > output_list.size()) {
+    GELOGE(ge::FAILED, "The size %zu of node output desc is more than output_list's size %zu.",
+           op_desc->GetOutputsSize(), output_list.size());
+    return ge::FAILED;
+  }
+  peer_output_list.at(peer_out_data_anchor->GetIdx()) = input_offset;
+  peer_op_desc->SetOutputOffset(peer_output_list);
+
+  int64_t view_end = input_offset + static_cast<int64_t>(input_size);
+  size_t slice_index = 0;
+  for (const auto &out_data_anchor : node->GetAllOutDataAnchors()) {
+    output_list[out_data_anchor->GetIdx()] = slice_offsets[slice_index];
+    view_end = std::max(view_end, slice_offsets[slice_index] + slice_sizes[slice_index]);
+    virtual_split_size_ += slice_sizes[slice_index];
+    ++slice_index;
+  }
+  op_desc->SetOutputOffset(output_list);
+
+  memory_offset_[0].mem_offset_ = static_cast<size_t>(view_end);
+  AlignMemOffset(kMemAlignSize);
+  GELOGD("Set virtual split %s input offset to %ld, size %ld.", op_desc->GetName().c_str(), input_offset,
+         view_end - input_offset);
+  return SUCCESS;
+}
+
 Status GraphMemoryAssigner::ReAssignMergeMemory() {
   for (const ge::NodePtr &n : compute_graph_->GetDirectNode()) {
     GE_IF_BOOL_EXEC(n->GetOpDesc() == nullptr, continue);
@@ -436,6 +670,8 @@ Status GraphMemoryAssigner::ReAssignAtomicMemory(bool is_loop_graph) {
   // Atomic op memory start addr
   int64_t atomic_mem_start = static_cast<int64_t>(memory_offset_[0].mem_offset_);
   GELOGI("Begin to reAssign atomic memory, atomic initial address mem_offset = %zu!", memory_offset_[0].mem_offset_);
+  // Outputs never read are out of clean ranges, they are assigned after atomic memory to be cleaned
+  vector<std::pair<NodePtr, vector<int64_t>>> uncleaned_nodes;
 
   for (auto &node : compute_graph_->GetDirectNode()) {
     auto node_op_desc = node->GetOpDesc();
@@ -463,7 +699,8 @@ Status GraphMemoryAssigner::ReAssignAtomicMemory(bool is_loop_graph) {
     int64_t loop_graph_atomic_mem_start = static_cast<int64_t>(memory_offset_[0].mem_offset_);
 
     // Reassign atomic node output memory
-    Status ret = AssignAtomicOutputMemory(node);
+    vector<int64_t> uncleaned_outputs;
+    Status ret = AssignAtomicOutputMemory(node, uncleaned_outputs);
     if (ret != SUCCESS) {
       GELOGE(ret, "Assign atomic output memory failed, node is %s.", node_op_desc->GetName().c_str());
       return ret;
@@ -494,7 +731,11 @@ Status GraphMemoryAssigner::ReAssignAtomicMemory(bool is_loop_graph) {
     /// In networks with loop op, atomic op uses atomic_addr_clean op independently,
     /// so we need to set the attr separately.
     if (is_loop_graph) {
-      GE_CHK_STATUS_RET(SetLoopGraphAtomicAttr(node, loop_graph_atomic_mem_start));
+      int64_t atomic_mem_size = memory_offset_[0].mem_offset_ - loop_graph_atomic_mem_start;
+      AddAtomicCleanRange(node, is_loop_graph, loop_graph_atomic_mem_start, atomic_mem_size);
+      GE_CHK_STATUS_RET(AssignUncleanedOutputMemory(node, uncleaned_outputs));
+    } else if (!uncleaned_outputs.empty()) {
+      uncleaned_nodes.emplace_back(node, uncleaned_outputs);
     }
   }
 
@@ -502,8 +743,9 @@ Status GraphMemoryAssigner::ReAssignAtomicMemory(bool is_loop_graph) {
   if (!is_loop_graph) {
     // Set the address attr of atomic clean operator
     int64_t atomic_mem_size = memory_offset_[0].mem_offset_ - atomic_mem_start;
-    if (atomic_mem_size != 0) {
-      GE_CHK_STATUS_RET(SetAtomicCleanAttr(nullptr, atomic_mem_start, atomic_mem_size), "SetAtomicCleanAttr failed.");
+    AddAtomicCleanRange(nullptr, is_loop_graph, atomic_mem_start, atomic_mem_size);
+    for (auto &uncleaned_node : uncleaned_nodes) {
+      GE_CHK_STATUS_RET(AssignUncleanedOutputMemory(uncleaned_node.first, uncleaned_node.second));
     }
   }
 
@@ -573,7 +815,7 @@ bool GraphMemoryAssigner::CheckInputIsSupportAtomic(const ge::NodePtr &node) {
   return true;
 }
 
-Status GraphMemoryAssigner::AssignAtomicOutputMemory(const ge::NodePtr &node) {
+Status GraphMemoryAssigner::AssignAtomicOutputMemory(const ge::NodePtr &node, vector<int64_t> &uncleaned_outputs) {
   auto op_desc = node->GetOpDesc();
   GE_IF_BOOL_EXEC(op_desc == nullptr, GELOGE(ge::FAILED, "op_desc is null."); return ge::FAILED);
   GELOGD("Begin to assign atomic output memory, node = %s.", op_desc->GetName().c_str());
@@ -626,6 +868,12 @@ Status GraphMemoryAssigner::AssignAtomicOutputMemory(const ge::NodePtr &node) {
       continue;
     }
 
+    // Output never read is not cleaned
+    if (!IsOutputRead(node, output_index)) {
+      uncleaned_outputs.emplace_back(output_index);
+      continue;
+    }
+
     auto output_desc = op_desc->GetAllOutputsDescPtr().at(output_index);
     uint32_t size = 0;
     if (ge::TensorUtils::GetSize(*output_desc, size) != SUCCESS) {
@@ -643,6 +891,48 @@ Status GraphMemoryAssigner::AssignAtomicOutputMemory(const ge::NodePtr &node) {
   return ge::SUCCESS;
 }
 
+Status GraphMemoryAssigner::AssignUncleanedOutputMemory(const ge::NodePtr &node,
+                                                        const vector<int64_t> &uncleaned_outputs) {
+  if (uncleaned_outputs.empty()) {
+    return ge::SUCCESS;
+  }
+  auto op_desc = node->GetOpDesc();
+  GE_CHECK_NOTNULL(op_desc);
+  vector<int64_t> output_list = op_desc->GetOutputOffset();
+  for (auto output_index : uncleaned_outputs) {
+    uint32_t size = 0;
+    if (ge::TensorUtils::GetSize(*(op_desc->GetAllOutputsDescPtr().at(output_index)), size) != SUCCESS) {
+      GELOGI("Get size failed");
+    }
+    GELOGD("[IMAS]Atomic output %ld of %s is never read, offset %zu without clean.", output_index,
+           op_desc->GetName().c_str(), memory_offset_[0].mem_offset_);
+    output_list[output_index] = memory_offset_[0].mem_offset_;
+    memory_offset_[0].mem_offset_ += size;
+    AlignMemOffset(kMemAlignSize);
+    // Cleaned as part of atomic memory before
+    atomic_clean_stat_before_.clean_size += size;
+  }
+  op_desc->SetOutputOffset(output_list);
+  return ge::SUCCESS;
+}
+
+bool GraphMemoryAssigner::IsOutputRead(const ge::NodePtr &node, int64_t output_index) const {
+  auto out_data_anchor = node->GetOutDataAnchor(static_cast<int>(output_index));
+  if ((out_data_anchor != nullptr) && !out_data_anchor->GetPeerInDataAnchors().empty()) {
+    return true;
+  }
+  // Output of graph may be fetched without any peer
+  auto iter = domi::GetContext().out_nodes_map.find(node->GetName());
+  if (iter != domi::GetContext().out_nodes_map.end()) {
+    for (auto index : iter->second) {
+      if (index == output_index) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 Status GraphMemoryAssigner::AssignOrdinaryAtomicWorkspaceMemory(const ge::OpDescPtr &op_desc,
                                                                 map<string, map<int64_t, int64_t>> &workspace_info) {
   GELOGI("Begin to reassign normal atomic memory, node = %s.", op_desc->GetName().c_str());
@@ -805,13 +1095,23 @@ ge::Status GraphMemoryAssigner::UpdateOpInputOffset(const NodePtr &node) const {
   return ge::SUCCESS;
 }
 
-Status GraphMemoryAssigner::SetLoopGraphAtomicAttr(const ge::NodePtr &node, int64_t atomic_mem_start) {
+void GraphMemoryAssigner::AddAtomicCleanRange(const ge::NodePtr &node, bool is_loop_graph, int64_t atomic_mem_start,
+                                              int64_t atomic_mem_size) {
+  if (atomic_mem_size == 0) {
+    return;
+  }
+  atomic_clean_stat_before_.range_num++;
+  atomic_clean_stat_before_.clean_size += atomic_mem_size;
+  if (!is_loop_graph) {
+    atomic_clean_ranges_.push_back({nullptr, atomic_mem_start, atomic_mem_size});
+    return;
+  }
+
   // set the address attr of atomic clean operator for loop graph
-  int64_t atomic_mem_size = memory_offset_[0].mem_offset_ - atomic_mem_start;
   GELOGI("SetLoopGraphAtomicAttr beign, atomic_addr_clean start size is %ld, mem_size is %ld, mem_offset is %zu.",
          atomic_mem_start, atomic_mem_size, memory_offset_[0].mem_offset_);
   const auto &in_control_anchor = node->GetInControlAnchor();
-  if (atomic_mem_size != 0 && in_control_anchor != nullptr) {
+  if (in_control_anchor != nullptr) {
     for (auto &peer_out_control_anchor : in_control_anchor->GetPeerOutControlAnchors()) {
       if (peer_out_control_anchor == nullptr) {
         continue;
@@ -826,23 +1126,63 @@ Status GraphMemoryAssigner::SetLoopGraphAtomicAttr(const ge::NodePtr &node, int6
              peer_out_node_desc->GetType().c_str());
 
       if (peer_out_node_desc->GetType() == ATOMICADDRCLEAN) {
-        GE_CHK_STATUS_EXEC(SetAtomicCleanAttr(peer_out_node, atomic_mem_start, atomic_mem_size),
-                           GELOGE(FAILED, "SetAtomicCleanAttr failed.");
-                           return FAILED);
+        atomic_clean_ranges_.push_back({peer_out_node, atomic_mem_start, atomic_mem_size});
       }
     }
   }
+}
+
+ge::Status GraphMemoryAssigner::SetAtomicCleanAttrs() {
+  // Ranges of a clean op are merged when they are next to each other, so one span is cleaned at once
+  std::stable_sort(atomic_clean_ranges_.begin(), atomic_clean_ranges_.end(),
+                   [](const AtomicCleanRange &lhs, const AtomicCleanRange &rhs) {
+                     if (lhs.clean_node != rhs.clean_node) {
+                       return lhs.clean_node < rhs.clean_node;
+                     }
+                     return lhs.start < rhs.start;
+                   });
+  vector<AtomicCleanRange> spans;
+  for (const auto &range : atomic_clean_ranges_) {
+    if (!spans.empty() && (spans.back().clean_node == range.clean_node) &&
+        (range.start <= spans.back().start + spans.back().size)) {
+      auto &span = spans.back();
+      span.size = std::max(span.size, range.start + range.size - span.start);
+      continue;
+    }
+    spans.emplace_back(range);
+  }
+
+  for (const auto &span : spans) {
+    GE_CHK_STATUS_RET(SetAtomicCleanAttr(span.clean_node, span.start, span.size), "SetAtomicCleanAttr failed.");
+    atomic_clean_stat_after_.range_num++;
+    atomic_clean_stat_after_.clean_size += span.size;
+  }
+  atomic_clean_ranges_.clear();
+
+  GEEVENT("[IMAS]Atomic clean of graph %s: %zu ranges of %ld bytes before layout, %zu ranges of %ld bytes after.",
+          compute_graph_->GetName().c_str(), atomic_clean_stat_before_.range_num, atomic_clean_stat_before_.clean_size,
+          atomic_clean_stat_after_.range_num, atomic_clean_stat_after_.clean_size);
+  GE_TRACE_COUNTER("atomic_clean_ranges", static_cast<int64_t>(atomic_clean_stat_after_.range_num));
+  GE_TRACE_COUNTER("atomic_clean_bytes", atomic_clean_stat_after_.clean_size);
   return SUCCESS;
 }
 
 ge::Status GraphMemoryAssigner::SetAtomicCleanAttr(const NodePtr &n, int64_t atomic_mem_start,
                                                    int64_t atomic_mem_size) {
-  for (ge::NodePtr &node : compute_graph_->GetDirectNode()) {
+  // Clean op of loop graph is given, no need to search the graph
+  vector<NodePtr> clean_nodes;
+  if (n != nullptr) {
+    clean_nodes.emplace_back(n);
+  } else {
+    for (ge::NodePtr &node : compute_graph_->GetDirectNode()) {
+      clean_nodes.emplace_back(node);
+    }
+  }
+  for (ge::NodePtr &node : clean_nodes) {
     auto node_op_desc = node->GetOpDesc();
     GE_IF_BOOL_EXEC(node_op_desc == nullptr, continue);
 
-    if (((n != nullptr) && (node->GetName() == n->GetName())) ||
-        ((n == nullptr) && (node_op_desc->GetType() == ATOMICADDRCLEAN))) {
+    if ((n != nullptr) || (node_op_desc->GetType() == ATOMICADDRCLEAN)) {
       vector<int64_t> workspace_vector = node_op_desc->GetWorkspace();
       vector<int64_t> workspace_byte_vector = node_op_desc->GetWorkspaceBytes();
       workspace_vector.emplace_back(atomic_mem_start);
@@ -38,6 +38,19 @@ struct MemoryOffset {
 
 using MemoryOffsetList = vector<MemoryOffset>;
 
+struct AtomicCleanRange {
+  // Clean op the range is set to, nullptr for every clean op of the graph
+  NodePtr clean_node;
+  int64_t start;
+  int64_t size;
+};
+
+// Memory zeroed by atomic clean ops in one iteration, each range is cleaned separately
+struct AtomicCleanStat {
+  size_t range_num = 0;
+  int64_t clean_size = 0;
+};
+
 class VariableMemoryAssigner {
  public:
   explicit VariableMemoryAssigner(ge::ComputeGraphPtr compute_graph) : compute_graph_(std::move(compute_graph)) {}
@@ -101,6 +114,12 @@ class GraphMemoryAssigner {
 
   ge::Status CheckOffset();
 
+  const AtomicCleanStat &GetAtomicCleanStatBefore() const { return atomic_clean_stat_before_; }
+
+  const AtomicCleanStat &GetAtomicCleanStatAfter() const { return atomic_clean_stat_after_; }
+
+  int64_t GetVirtualSplitSize() const { return virtual_split_size_; }
+
  private:
   ///
   /// @ingroup ge_graph
@@ -109,8 +128,25 @@ class GraphMemoryAssigner {
   ///
   ge::Status ReAssignContinuousMemory(bool is_loop_graph);
 
+  ge::Status ReAssignContinuousInputMemory(const ge::NodePtr &node, bool is_loop_graph);
+
+  ///
+  /// @brief whether continuous input of an atomic node can be assigned after other continuous memory, so that its
+  ///        clean range is next to the atomic memory. Outputs of the node and other readers of its inputs must not
+  ///        depend on the offsets.
+  ///
+  bool CanDeferContinuousInput(const ge::NodePtr &node) const;
+
   ge::Status ReAssignVirtualConcatMemory();
 
+  ///
+  /// @brief outputs of a virtual split node are views of its input, the input is assigned new memory and the
+  ///        outputs are offsets of slices in it, so the split needs neither a copy nor memory of its own
+  ///
+  ge::Status ReAssignVirtualSplitMemory();
+
+  ge::Status AssignVirtualSplitMemory(const ge::NodePtr &node);
+
   ge::Status ReAssignMergeMemory();
 
   ge::Status ReAssignAtomicMemory(bool is_loop_graph);
@@ -128,7 +164,15 @@ class GraphMemoryAssigner {
   ///
   bool CheckInputIsSupportAtomic(const ge::NodePtr &node);
 
-  ge::Status AssignAtomicOutputMemory(const ge::NodePtr &node);
+  ///
+  /// @brief assign atomic outputs which are read by other nodes, outputs never read need no clean
+  /// @param [out] uncleaned_outputs indexes of outputs never read, assigned by AssignUncleanedOutputMemory
+  ///
+  ge::Status AssignAtomicOutputMemory(const ge::NodePtr &node, std::vector<int64_t> &uncleaned_outputs);
+
+  ge::Status AssignUncleanedOutputMemory(const ge::NodePtr &node, const std::vector<int64_t> &uncleaned_outputs);
+
+  bool IsOutputRead(const ge::NodePtr &node, int64_t output_index) const;
 
   ge::Status AssignOrdinaryAtomicWorkspaceMemory(const ge::OpDescPtr &op_desc,
                                                  std::map<std::string, std::map<int64_t, int64_t>> &workspace_info);
@@ -137,11 +181,17 @@ class GraphMemoryAssigner {
                                                std::map<std::string, std::map<int64_t, int64_t>> &workspace_info);
 
   ///
-  /// @brief set loop graph atomic attr
-  /// @param node
+  /// @brief add clean range of an atomic node, ranges are set to clean ops by SetAtomicCleanAttrs
+  /// @param node: atomic node, its clean ops are found by control edges in loop graph
   /// @param atomic_mem_start: atomic op memory start address
   ///
-  ge::Status SetLoopGraphAtomicAttr(const ge::NodePtr &node, int64_t atomic_mem_start);
+  void AddAtomicCleanRange(const ge::NodePtr &node, bool is_loop_graph, int64_t atomic_mem_start,
+                           int64_t atomic_mem_size);
+
+  ///
+  /// @brief merge adjacent clean ranges of the same clean op, and set merged ranges to clean ops
+  ///
+  ge::Status SetAtomicCleanAttrs();
 
   ge::Status SetAtomicCleanAttr(const ge::NodePtr &n, int64_t atomic_mem_start, int64_t atomic_mem_size);
 
@@ -149,6 +199,11 @@ class GraphMemoryAssigner {
 
   MemoryOffsetList memory_offset_;
   ge::ComputeGraphPtr compute_graph_;
+  std::vector<AtomicCleanRange> atomic_clean_ranges_;
+  AtomicCleanStat atomic_clean_stat_before_;
+  AtomicCleanStat atomic_clean_stat_after_;
+  // Bytes of outputs of virtual split nodes, which are views of their inputs
+  int64_t virtual_split_size_ = 0;
 };
 }  // namespace ge
 
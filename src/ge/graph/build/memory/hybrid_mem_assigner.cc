@@ -17,6 +17,7 @@
 #include "graph/build/memory/hybrid_mem_assigner.h"
 #include <utility>
 #include <vector>
+#include "common/build_tracer.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/build/memory/binary_block_mem_assigner.h"
 #include "graph/build/memory/max_block_mem_assigner.h"
@@ -64,6 +65,12 @@ Status HybridMemAssigner::Assign() {
     priority_assigner = std::move(max_assigner);
   }
 
+  GEEVENT("[IMAS]Outputs of graph %s need no memory of their own: %ld bytes written in place, %ld bytes of "
+          "virtual nodes.", compute_graph_->GetName().c_str(), priority_assigner->GetInPlaceSize(),
+          priority_assigner->GetVirtualOutputSize());
+  GE_TRACE_COUNTER("in_place_bytes", priority_assigner->GetInPlaceSize());
+  GE_TRACE_COUNTER("virtual_output_bytes", priority_assigner->GetVirtualOutputSize());
+
   priority_assigner->SetOpMemOffset();
   mem_offset_ = priority_assigner->GetMemOffset();
   return SUCCESS;
@@ -17,6 +17,7 @@
 #include "graph/build/model_builder.h"
 #include <iostream>
 #include <set>
+#include "common/build_tracer.h"
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/anchor.h"
@@ -242,6 +243,7 @@ Status ModelBuilder::SetInputOutputDesc() {
 }
 
 Status ModelBuilder::AssignMemory() {
+  GE_TRACE_SCOPE(AssignMemory, "ModelBuilder::AssignMemory");
   std::unique_ptr<ge::MemoryAssigner> mem_assigner(new (std::nothrow) ge::MemoryAssigner(compute_graph_));
   if (mem_assigner == nullptr) {
     GELOGE(FAILED, "new memory allocator failed.");
@@ -251,6 +253,9 @@ Status ModelBuilder::AssignMemory() {
     GELOGE(FAILED, "memory allocator failed.");
     return FAILED;
   }
+  GE_TRACE_ARG(AssignMemory, "node_num", static_cast<int64_t>(compute_graph_->GetAllNodesSize()));
+  GE_TRACE_ARG(AssignMemory, "mem_offset", static_cast<int64_t>(mem_offset_));
+  GE_TRACE_COUNTER("feature_map_bytes", static_cast<int64_t>(mem_offset_));
   return SUCCESS;
 }
 
@@ -453,6 +458,7 @@ Status ModelBuilder::MergeWeights() {
         return FAILED, "call memcpy_s failed.");
     }
 
+    // Drop the host copy of the weight once it is merged, so that weights are not held twice during build
     weight_data.clear();
   }
 
@@ -533,18 +539,34 @@ Status ModelBuilder::BuildModelForGetTask(ge::Model &model) {
 
   // Assign logical streams.
   StreamAllocator stream_allocator(compute_graph_, subgraphs_);
-  GE_CHK_STATUS_RET(stream_allocator.AssignLogicalStreams(stream_max_parallel_num_, hcom_parallel_),
-                    "Assign logical streams failed.");
+  {
+    GE_TRACE_SCOPE(AssignLogicalStreams, "StreamAllocator::AssignLogicalStreams");
+    GE_CHK_STATUS_RET(stream_allocator.AssignLogicalStreams(stream_max_parallel_num_, hcom_parallel_),
+                      "Assign logical streams failed.");
+  }
 
   GE_CHK_STATUS_RET(AssignMemory(), "Assign Memory Failed!");
 
   // Compile single op in graph build stage
-  GE_CHK_STATUS_RET(CompileSingleOp(), "ATC builder CompileSingleOp() return fail.");
+  {
+    GE_TRACE_SCOPE(CompileSingleOp, "ModelBuilder::CompileSingleOp");
+    GE_CHK_STATUS_RET(CompileSingleOp(), "ATC builder CompileSingleOp() return fail.");
+  }
 
   // Refresh real streams and insert event nodes.
-  GE_CHK_STATUS_RET(stream_allocator.RefreshRealStream(stream_num_, event_num_), "RefreshRealStream failed.");
+  {
+    GE_TRACE_SCOPE(RefreshRealStream, "StreamAllocator::RefreshRealStream");
+    GE_CHK_STATUS_RET(stream_allocator.RefreshRealStream(stream_num_, event_num_), "RefreshRealStream failed.");
+    GE_TRACE_ARG(RefreshRealStream, "stream_num", stream_num_);
+    GE_TRACE_ARG(RefreshRealStream, "event_num", event_num_);
+  }
 
-  GE_CHK_STATUS_RET(MergeWeights(), "MergeWeights Failed!");
+  {
+    GE_TRACE_SCOPE(MergeWeights, "ModelBuilder::MergeWeights");
+    GE_CHK_STATUS_RET(MergeWeights(), "MergeWeights Failed!");
+    GE_TRACE_ARG(MergeWeights, "weight_size", static_cast<int64_t>(weight_offset_));
+    GE_TRACE_COUNTER("weight_bytes", static_cast<int64_t>(weight_offset_));
+  }
   GE_CHK_STATUS_RET(BuildModelDef(model), "BuildModelDef failed!");
 
   SetModelVersion(model);
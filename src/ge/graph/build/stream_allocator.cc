@@ -15,7 +15,9 @@
  */
 
 #include "graph/build/stream_allocator.h"
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/fmk_error_codes.h"
@@ -425,25 +427,14 @@ Status StreamAllocator::InsertOneEventInTwoNodes(const NodePtr &cur_node, const
 
 // Optimize the event in the graph, delete the redundant sync event according to the stream information
 Status StreamAllocator::OptimizeSyncEvents() {
-  map<int64_t, vector<NodePtr>> stream_nodes;
-
-  for (const auto &node : whole_graph_->GetDirectNode()) {
-    GE_CHECK_NOTNULL(node->GetOpDesc());
-    int64_t stream_id = node->GetOpDesc()->GetStreamId();
-    stream_nodes[stream_id].emplace_back(node);
-  }
-
-  Status status = OptimizeBySendEvents(stream_nodes);
+  uint32_t event_num_before = GetValidEventNum();
+  GE_TIMESTAMP_START(OptimizeByVectorClock);
+  Status status = OptimizeByVectorClock();
   if (status != SUCCESS) {
-    GELOGE(status, "OptimizeBySendEvents failed!");
-    return status;
-  }
-
-  status = OptimizeByRecvEvents(stream_nodes);
-  if (status != SUCCESS) {
-    GELOGE(status, "OptimizeByRecvEvents failed!");
+    GELOGE(status, "OptimizeByVectorClock failed!");
     return status;
   }
+  GE_TIMESTAMP_END(OptimizeByVectorClock, "StreamAllocator::OptimizeByVectorClock");
 
   status = OptimizeByStreamActivate();
   if (status != SUCCESS) {
@@ -451,93 +442,114 @@ Status StreamAllocator::OptimizeSyncEvents() {
     return status;
   }
 
+  GEEVENT("OptimizeSyncEvents: %ld streams, %u events before optimization, %u events after optimization.",
+          stream_num_, event_num_before, GetValidEventNum());
   return SUCCESS;
 }
 
-/// Optimization scenario: one stream has multiple send events in one node,
-/// and multiple nodes for recv events on another stream
+/// Remove the sync events whose send node is already known to be finished when the recv node starts.
+/// Nodes are visited once in topological order. Every stream keeps a vector clock, which records for each stream the
+/// position of the last node that is known to be finished. A recv event is redundant if its send node is covered by
+/// the clock of the recv stream, otherwise the clock of the send node is merged into it. The recv events of a node
+/// are visited from the latest send node, so the event of an earlier node on the same stream is covered by the later.
 /// Example:
 /// Stream0            Stream1
 ///   N1 - - - event - > N1
+///   |                  |
+///   |                  v
+///   N2 - - - event - > N2
 ///     \                |
 ///      \               v
-///        - - event - > N2
-Status StreamAllocator::OptimizeBySendEvents(const map<int64_t, vector<NodePtr>> &stream_nodes) {
-  for (const auto &one_pair : stream_nodes) {
-    // The nodes on a stream in order
-    const vector<NodePtr> &nodes = one_pair.second;
-
-    map<NodePtr, uint32_t> send_node_to_event_id;
+///        - - event - > N3    (covered by the event N2 -> N2)
+Status StreamAllocator::OptimizeByVectorClock() {
+  if (stream_num_ <= 0) {
+    return SUCCESS;
+  }
+  size_t stream_num = static_cast<size_t>(stream_num_);
 
-    for (const auto &recv_node_ptr : nodes) {
-      GE_CHECK_NOTNULL(recv_node_ptr);
-      // Get all recv events of the current node, then traverse the event
-      vector<uint32_t> recv_events;
-      GetRecvEventIdList(recv_node_ptr, recv_events);
-
-      for (const auto &event_id : recv_events) {
-        NodePtr send_node_ptr = GetNodeFromSendEventId(event_id);
-        GE_CHECK_NOTNULL(send_node_ptr);
-
-        /// If the record to the stream is found in the map,
-        /// and the recv node is the node, then remove sync event
-        if (send_node_to_event_id.find(send_node_ptr) != send_node_to_event_id.end()) {
-          RmvSendEventId(send_node_ptr, event_id);
-          RmvRecvEventId(recv_node_ptr, event_id);
-          GELOGI("Remove send event %u for node: %s", event_id, send_node_ptr->GetName().c_str());
-          GELOGI("Remove recv event %u for node: %s", event_id, recv_node_ptr->GetName().c_str());
-        } else {
-          send_node_to_event_id[send_node_ptr] = event_id;
-        }
+  // Dense index of the node in topological order, the stream and the position in the stream, indexed by node index
+  vector<NodePtr> nodes;
+  vector<int64_t> node_streams;
+  vector<int64_t> node_positions;
+  std::unordered_map<const Node *, size_t> node_indexes;
+  vector<int64_t> stream_node_num(stream_num, 0);
+  for (const auto &node : whole_graph_->GetDirectNode()) {
+    GE_CHECK_NOTNULL(node->GetOpDesc());
+    int64_t stream_id = node->GetOpDesc()->GetStreamId();
+    int64_t position = -1;
+    if (stream_id != kInvalidStream) {
+      if (stream_id < 0 || stream_id >= stream_num_) {
+        GELOGE(FAILED, "OptimizeByVectorClock: stream id %ld of node %s is out of range %ld.", stream_id,
+               node->GetName().c_str(), stream_num_);
+        return FAILED;
       }
+      position = stream_node_num[stream_id]++;
     }
+    node_indexes[node.get()] = nodes.size();
+    nodes.emplace_back(node);
+    node_streams.emplace_back(stream_id);
+    node_positions.emplace_back(position);
   }
 
-  return SUCCESS;
-}
-
-/// Scenario: multiple send nodes on a stream sent to a single recv node on the destination stream
-/// Example:
-/// Stream0            Stream1
-///   N1 - -
-///   |    |
-///   |    - - event - - -
-///   |                  |
-///   V                  V
-///   N2 - - - event - > N2
-Status StreamAllocator::OptimizeByRecvEvents(const map<int64_t, vector<NodePtr>> &stream_nodes) {
-  for (const auto &one_pair : stream_nodes) {
-    // The nodes on a stream in order
-    const vector<NodePtr> &nodes = one_pair.second;
-
-    map<NodePtr, uint32_t> recv_node_to_event_id;
-
-    for (const auto &send_node_ptr : nodes) {
-      GE_CHECK_NOTNULL(send_node_ptr);
-      //  Get all send events of the current node, then traverse the event
-      vector<uint32_t> send_id_list;
-      GetSendEventIdList(send_node_ptr, send_id_list);
-
-      for (const auto &event_id : send_id_list) {
-        NodePtr recv_node_ptr = GetNodeFromRecvEventId(event_id);
-        GE_CHECK_NOTNULL(recv_node_ptr);
-
-        /// If the record to the stream is found in the map,
-        /// and the send node is the node, then remove sync event
-        auto it = recv_node_to_event_id.find(recv_node_ptr);
-        if (it != recv_node_to_event_id.end()) {
-          uint32_t pre_event_id = it->second;
-          NodePtr pre_send_node_ptr = GetNodeFromSendEventId(pre_event_id);
-          GE_CHECK_NOTNULL(pre_send_node_ptr);
-
-          RmvSendEventId(pre_send_node_ptr, pre_event_id);
-          RmvRecvEventId(recv_node_ptr, pre_event_id);
-          GELOGI("Remove event %u between node %s and node %s.", event_id, pre_send_node_ptr->GetName().c_str(),
-                 recv_node_ptr->GetName().c_str());
+  // The clock of each stream, and the clock of each send node at the moment it is finished
+  vector<vector<int64_t>> stream_clocks(stream_num, vector<int64_t>(stream_num, -1));
+  vector<vector<int64_t>> send_node_clocks(nodes.size());
+  vector<std::pair<size_t, uint32_t>> recv_events;
+  for (size_t index = 0; index < nodes.size(); ++index) {
+    const NodePtr &recv_node = nodes[index];
+    int64_t stream_id = node_streams[index];
+    if (stream_id == kInvalidStream) {
+      continue;
+    }
+    vector<int64_t> &clock = stream_clocks[stream_id];
+
+    recv_events.clear();
+    auto recv_iter = node_to_recv_events_.find(recv_node);
+    if (recv_iter != node_to_recv_events_.end()) {
+      for (uint32_t event_id : recv_iter->second) {
+        NodePtr send_node = GetNodeFromSendEventId(event_id);
+        GE_CHECK_NOTNULL(send_node);
+        auto index_iter = node_indexes.find(send_node.get());
+        if (index_iter == node_indexes.end()) {
+          GELOGE(FAILED, "OptimizeByVectorClock: send node %s of event %u is not in graph.",
+                 send_node->GetName().c_str(), event_id);
+          return FAILED;
         }
-        recv_node_to_event_id[recv_node_ptr] = event_id;
+        recv_events.emplace_back(index_iter->second, event_id);
+      }
+    }
+    std::sort(recv_events.begin(), recv_events.end(),
+              [](const std::pair<size_t, uint32_t> &lhs, const std::pair<size_t, uint32_t> &rhs) {
+                return lhs.first > rhs.first;
+              });
+
+    for (const auto &recv_event : recv_events) {
+      size_t send_index = recv_event.first;
+      uint32_t event_id = recv_event.second;
+      int64_t send_stream_id = node_streams[send_index];
+      // The send node that is not visited yet has no clock, keep its event
+      if (send_stream_id == kInvalidStream || send_index >= index || send_node_clocks[send_index].empty()) {
+        continue;
+      }
+      if (clock[send_stream_id] >= node_positions[send_index]) {
+        const NodePtr &send_node = nodes[send_index];
+        RmvSendEventId(send_node, event_id);
+        RmvRecvEventId(recv_node, event_id);
+        GELOGI("Remove event %u between node %s and node %s.", event_id, send_node->GetName().c_str(),
+               recv_node->GetName().c_str());
+        continue;
+      }
+      const vector<int64_t> &send_clock = send_node_clocks[send_index];
+      for (size_t i = 0; i < stream_num; ++i) {
+        clock[i] = std::max(clock[i], send_clock[i]);
       }
     }
+    clock[stream_id] = node_positions[index];
+
+    auto send_iter = node_to_send_events_.find(recv_node);
+    if (send_iter != node_to_send_events_.end() && !send_iter->second.empty()) {
+      send_node_clocks[index] = clock;
+    }
   }
 
   return SUCCESS;
@@ -648,6 +660,7 @@ Status StreamAllocator::RefreshContinuousEvents() {
   }
 
   event_num_ = static_cast<uint32_t>(old_to_new_events.size());
+  RefreshEventNodes();
 
   return SUCCESS;
 }
@@ -726,11 +739,19 @@ Status StreamAllocator::InsertSyncEventNodes() {
 // Insert send event id on a node
 void StreamAllocator::AddSendEventId(const NodePtr &node, uint32_t event_id) {
   node_to_send_events_[node].emplace_back(event_id);
+  if (event_id >= send_event_nodes_.size()) {
+    send_event_nodes_.resize(event_id + 1);
+  }
+  send_event_nodes_[event_id] = node;
 }
 
 // Insert recv event id on a node
 void StreamAllocator::AddRecvEventId(const NodePtr &node, uint32_t event_id) {
   node_to_recv_events_[node].emplace_back(event_id);
+  if (event_id >= recv_event_nodes_.size()) {
+    recv_event_nodes_.resize(event_id + 1);
+  }
+  recv_event_nodes_[event_id] = node;
 }
 
 // Remove send event id from a node
@@ -744,6 +765,9 @@ void StreamAllocator::RmvSendEventId(const NodePtr &node, uint32_t event_id) {
   for (auto it = send_events.begin(); it != send_events.end(); ++it) {
     if (*it == event_id) {
       send_events.erase(it);
+      if (event_id < send_event_nodes_.size()) {
+        send_event_nodes_[event_id] = nullptr;
+      }
       return;
     }
   }
@@ -760,6 +784,9 @@ void StreamAllocator::RmvRecvEventId(const NodePtr &node, uint32_t event_id) {
   for (auto it = recv_events.begin(); it != recv_events.end(); ++it) {
     if (*it == event_id) {
       recv_events.erase(it);
+      if (event_id < recv_event_nodes_.size()) {
+        recv_event_nodes_[event_id] = nullptr;
+      }
       return;
     }
   }
@@ -785,30 +812,46 @@ void StreamAllocator::GetRecvEventIdList(const NodePtr &node, vector<uint32_t> &
 
 // Get a specific send node according to the recv event
 NodePtr StreamAllocator::GetNodeFromSendEventId(uint32_t send_event_id) const {
-  for (const auto &one_pair : node_to_send_events_) {
-    const vector<uint32_t> &events = one_pair.second;
-    for (const auto &event_id : events) {
-      if (event_id == send_event_id) {
-        return one_pair.first;
-      }
-    }
+  if (send_event_id >= send_event_nodes_.size()) {
+    return nullptr;
   }
-
-  return nullptr;
+  return send_event_nodes_[send_event_id];
 }
 
 // Get a specific recv node according to the recv event
 NodePtr StreamAllocator::GetNodeFromRecvEventId(uint32_t recv_event_id) const {
+  if (recv_event_id >= recv_event_nodes_.size()) {
+    return nullptr;
+  }
+  return recv_event_nodes_[recv_event_id];
+}
+
+// Rebuild the event to node index after the event ids are refreshed
+void StreamAllocator::RefreshEventNodes() {
+  send_event_nodes_.assign(event_num_, nullptr);
+  recv_event_nodes_.assign(event_num_, nullptr);
+  for (const auto &one_pair : node_to_send_events_) {
+    for (const auto &event_id : one_pair.second) {
+      if (event_id < event_num_) {
+        send_event_nodes_[event_id] = one_pair.first;
+      }
+    }
+  }
   for (const auto &one_pair : node_to_recv_events_) {
-    const vector<uint32_t> &events = one_pair.second;
-    for (const auto &event_id : events) {
-      if (event_id == recv_event_id) {
-        return one_pair.first;
+    for (const auto &event_id : one_pair.second) {
+      if (event_id < event_num_) {
+        recv_event_nodes_[event_id] = one_pair.first;
       }
     }
   }
+}
 
-  return nullptr;
+uint32_t StreamAllocator::GetValidEventNum() const {
+  uint32_t valid_event_num = 0;
+  for (const auto &one_pair : node_to_send_events_) {
+    valid_event_num += static_cast<uint32_t>(one_pair.second.size());
+  }
+  return valid_event_num;
 }
 
 void StreamAllocator::DumpEvents() {
@@ -50,8 +50,7 @@ class StreamAllocator {
   Status InsertOneEventInTwoNodes(const NodePtr &cur_node_ptr, const NodePtr &next_node_ptr);
 
   Status OptimizeSyncEvents();
-  Status OptimizeBySendEvents(const std::map<int64_t, std::vector<NodePtr>> &stream_nodes);
-  Status OptimizeByRecvEvents(const std::map<int64_t, std::vector<NodePtr>> &stream_nodes);
+  Status OptimizeByVectorClock();
   Status OptimizeByStreamActivate();
 
   Status RefreshContinuousEvents();
@@ -69,6 +68,8 @@ class StreamAllocator {
   void GetRecvEventIdList(const NodePtr &node, std::vector<uint32_t> &recv_list) const;
   NodePtr GetNodeFromSendEventId(uint32_t send_event_id) const;
   NodePtr GetNodeFromRecvEventId(uint32_t recv_event_id) const;
+  void RefreshEventNodes();
+  uint32_t GetValidEventNum() const;
 
   void DumpEvents();
   // Determine if the successor node of RecvNode is directly or indirectly activated by the SendNode precursor node
@@ -89,6 +90,10 @@ class StreamAllocator {
 
   // recv events corresponding to the node
   std::map<NodePtr, std::vector<uint32_t>> node_to_recv_events_;
+
+  // send/recv node corresponding to the event, indexed by event id
+  std::vector<NodePtr> send_event_nodes_;
+  std::vector<NodePtr> recv_event_nodes_;
 };
 }  // namespace ge
 #endif  // GE_GRAPH_BUILD_STREAM_ALLOCATOR_H_
@@ -0,0 +1,169 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/build/stream_cost_model.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/types.h"
+#include "framework/common/util.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace ge {
+namespace {
+// Fixed launch overhead of one op.
+const int64_t kBaseOpCost = 1;
+// Number of output elements an elementwise op processes in one microsecond.
+const int64_t kElementsPerCostUnit = 1024;
+
+// Relative cost of one output element compared with elementwise ops.
+int64_t GetTypeFactor(const string &type) {
+  static const map<string, int64_t> kTypeFactors = {
+    {CONVOLUTION, 16},     {CONV2D, 16},        {CONVGRADFILTER, 16}, {CONV2DBACKPROPINPUT, 16}, {DECONVOLUTION, 16},
+    {DEPCONVOLUTION, 4},   {MATMUL, 16},        {BATCHMATMUL, 16},    {FULL_CONNECTION, 16},     {POOLING, 2},
+    {HCOMALLREDUCE, 8},    {HCOMALLGATHER, 8},  {HCOMBROADCAST, 8},   {HCOMREDUCESCATTER, 8}};
+  auto iter = kTypeFactors.find(type);
+  return (iter != kTypeFactors.end()) ? iter->second : 1;
+}
+}  // namespace
+
+Status StreamCostModel::LoadCostFile(const string &cost_file) {
+  string real_path = RealPath(cost_file.c_str());
+  if (real_path.empty()) {
+    GELOGE(PARAM_INVALID, "Invalid stream cost file %s.", cost_file.c_str());
+    return PARAM_INVALID;
+  }
+
+  std::ifstream ifs(real_path);
+  if (!ifs.is_open()) {
+    GELOGE(FAILED, "Open stream cost file %s failed.", real_path.c_str());
+    return FAILED;
+  }
+
+  string line;
+  size_t line_num = 0;
+  while (std::getline(ifs, line)) {
+    ++line_num;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream iss(line);
+    string key;
+    int64_t cost = 0;
+    if (!(iss >> key >> cost) || cost < 0) {
+      GELOGW("Skip invalid line %zu of stream cost file %s.", line_num, real_path.c_str());
+      continue;
+    }
+
+    // A key is used both as op name and op type, names are looked up first.
+    name_costs_[key] = cost;
+    type_costs_[key] = cost;
+  }
+
+  GELOGI("Load %zu op costs from stream cost file %s.", name_costs_.size(), real_path.c_str());
+  return SUCCESS;
+}
+
+int64_t StreamCostModel::GetNodeCost(const NodePtr &node) const {
+  if (node == nullptr || node->GetOpDesc() == nullptr) {
+    return 0;
+  }
+
+  const string &type = node->GetType();
+  if (type == PLACEHOLDER || type == END) {
+    return 0;
+  }
+
+  auto name_iter = name_costs_.find(node->GetName());
+  if (name_iter != name_costs_.end()) {
+    return name_iter->second;
+  }
+  auto type_iter = type_costs_.find(type);
+  if (type_iter != type_costs_.end()) {
+    return type_iter->second;
+  }
+  return GetStaticCost(node);
+}
+
+int64_t StreamCostModel::GetGraphCost(const ComputeGraphPtr &graph) const {
+  int64_t cost = 0;
+  if (graph == nullptr) {
+    return cost;
+  }
+  for (const NodePtr &node : graph->GetDirectNode()) {
+    cost += GetNodeCost(node);
+  }
+  return cost;
+}
+
+int64_t StreamCostModel::GetStaticCost(const NodePtr &node) const {
+  int64_t element_num = 0;
+  for (const auto &output_desc : node->GetOpDesc()->GetAllOutputsDescPtr()) {
+    if (output_desc == nullptr) {
+      continue;
+    }
+    int64_t shape_size = output_desc->GetShape().GetShapeSize();
+    if (shape_size > 0) {
+      element_num += shape_size;
+    }
+  }
+  return kBaseOpCost + element_num * GetTypeFactor(node->GetType()) / kElementsPerCostUnit;
+}
+
+Status StreamMakespanSimulator::Simulate(const vector<StreamSimTask> &tasks, StreamSimResult &result) {
+  result = StreamSimResult();
+  vector<int64_t> finish_times(tasks.size(), 0);
+  // <stream id, time when the last task issued to the stream finishes>
+  map<int64_t, int64_t> stream_free_times;
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    const StreamSimTask &task = tasks[i];
+    int64_t start_time = 0;
+    for (size_t pred : task.preds) {
+      if (pred >= i) {
+        GELOGE(PARAM_INVALID, "Predecessor %zu of task %s is not issued before it.", pred, task.name.c_str());
+        return PARAM_INVALID;
+      }
+      int64_t ready_time = finish_times[pred];
+      int64_t pred_stream = tasks[pred].stream_id;
+      if (task.stream_id >= 0 && pred_stream >= 0 && pred_stream != task.stream_id) {
+        ready_time += kEventCost;
+        ++result.event_num;
+      }
+      start_time = std::max(start_time, ready_time);
+    }
+
+    if (task.stream_id >= 0) {
+      int64_t &stream_free_time = stream_free_times[task.stream_id];
+      start_time = std::max(start_time, stream_free_time);
+      stream_free_time = start_time + task.cost;
+    }
+
+    finish_times[i] = start_time + task.cost;
+    result.makespan = std::max(result.makespan, finish_times[i]);
+  }
+
+  result.stream_num = static_cast<int64_t>(stream_free_times.size());
+  return SUCCESS;
+}
+}  // namespace ge
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_BUILD_STREAM_COST_MODEL_H_
+#define GE_GRAPH_BUILD_STREAM_COST_MODEL_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+#include "graph/compute_graph.h"
+
+namespace ge {
+// Estimate the execution cost (in microseconds) of ops for cost model driven stream assignment.
+class StreamCostModel {
+ public:
+  StreamCostModel() = default;
+  StreamCostModel(const StreamCostModel &) = delete;
+  StreamCostModel &operator=(const StreamCostModel &) = delete;
+  ~StreamCostModel() = default;
+
+  ///
+  /// Load op costs profiled by a previous run.
+  /// Each line of the file is "<op name or op type> <cost>", lines starting with '#' are ignored.
+  /// Ops which are not in the file fall back to the static cost table.
+  ///
+  Status LoadCostFile(const std::string &cost_file);
+
+  int64_t GetNodeCost(const NodePtr &node) const;
+
+  // Sum of the cost of all compute nodes in graph, PlaceHolder and End are free.
+  int64_t GetGraphCost(const ComputeGraphPtr &graph) const;
+
+ private:
+  int64_t GetStaticCost(const NodePtr &node) const;
+
+  // <op name, cost>
+  std::map<std::string, int64_t> name_costs_;
+  // <op type, cost>
+  std::map<std::string, int64_t> type_costs_;
+};
+
+struct StreamSimTask {
+  std::string name;
+  int64_t cost = 0;
+  // Negative stream means the task is not bound to any stream and does not occupy one.
+  int64_t stream_id = -1;
+  // Indexes of predecessors, which must be smaller than the index of the task.
+  std::vector<size_t> preds;
+};
+
+struct StreamSimResult {
+  int64_t makespan = 0;
+  int64_t event_num = 0;
+  int64_t stream_num = 0;
+};
+
+// Simulate the execution of tasks on their assigned streams to estimate the makespan of an assignment.
+class StreamMakespanSimulator {
+ public:
+  // Estimated cost of one send/recv event pair between two streams.
+  static const int64_t kEventCost = 5;
+
+  ///
+  /// Tasks are issued in vector order, which has to be the topological order their nodes are issued in,
+  /// tasks on the same stream run serially in issue order, and a dependency across two streams costs one event.
+  ///
+  static Status Simulate(const std::vector<StreamSimTask> &tasks, StreamSimResult &result);
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_BUILD_STREAM_COST_MODEL_H_
@@ -15,14 +15,22 @@
  */
 
 #include "graph/build/task_generator.h"
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <set>
 #include <string>
 #include <utility>
+#include "common/build_tracer.h"
+#include "common/thread_pool.h"
 #include "common/util.h"
 #include "common/types.h"
 #include "framework/common/debug/ge_log.h"
+#include "framework/common/string_util.h"
 
 #include "graph/debug/ge_attr_define.h"
 #include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
 #include "graph/manager/graph_var_manager.h"
 #include "graph/model_serialize.h"
 #include "graph/utils/node_utils.h"
@@ -51,6 +59,35 @@ const uint64_t kProfilingBpEndLogid = 2;
 const uint64_t kProfilingArStartLogid = 3;
 const uint64_t kProfilingArEndLogid = 4;
 const uint64_t kProfilingIterEndLogid = 255;
+const uint32_t kMaxTaskGenThreadNum = 64;
+
+uint32_t GetTaskGenThreadNum() {
+  string thread_num_str;
+  if (ge::GetContext().GetOption(ge::TASK_GEN_THREAD_NUM, thread_num_str) != ge::GRAPH_SUCCESS ||
+      thread_num_str.empty()) {
+    return 1;
+  }
+  const int base = 10;
+  int64_t thread_num = std::strtol(thread_num_str.c_str(), nullptr, base);
+  if (thread_num <= 1) {
+    return 1;
+  }
+  return static_cast<uint32_t>(std::min<int64_t>(thread_num, kMaxTaskGenThreadNum));
+}
+
+std::set<string> GetTaskGenThreadSafeLibs() {
+  std::set<string> lib_names;
+  string libs_str;
+  if (ge::GetContext().GetOption(ge::TASK_GEN_THREAD_SAFE_LIBS, libs_str) != ge::GRAPH_SUCCESS) {
+    return lib_names;
+  }
+  for (const auto &lib_name : ge::StringUtils::Split(libs_str, ',')) {
+    if (!lib_name.empty()) {
+      lib_names.insert(lib_name);
+    }
+  }
+  return lib_names;
+}
 }  // namespace
 namespace ge {
 TaskGenerator::TaskGenerator(uint8_t *var_mem_base, uint64_t var_mem_size) {
@@ -197,10 +234,81 @@ Status TaskGenerator::GenerateTask(RunContext &run_context, ComputeGraphPtr &gra
   vector<uint32_t> ar_ppoint;
   GE_CHK_STATUS_RET(FindProfilingTaskIndex(graph, ppoint, ar_ppoint));
 
+  GE_TRACE_SCOPE(GenerateTask, "TaskGenerator::GenerateTask");
+  vector<TaskGenJob> jobs;
+  GE_CHK_STATUS_RET(PrepareTaskGenJobs(graph, run_context.graphStreamList.size(), jobs));
+
+  uint32_t thread_num = GetTaskGenThreadNum();
+  if ((thread_num > 1) && (jobs.size() > 1)) {
+    GE_TIMESTAMP_START(GenerateTaskInParallel);
+    GE_CHK_STATUS_RET(GenerateTaskInParallel(run_context, thread_num, jobs));
+    GE_TIMESTAMP_END(GenerateTaskInParallel, "GraphBuild::GenerateTaskInParallel");
+  }
+
+  // Merge tasks in node order, tasks of libs not configured thread safe are generated here as serial mode
+  GE_TIMESTAMP_CALLNUM_START(GenerateTask);
+  for (auto &job : jobs) {
+    OpDescPtr op_desc = job.node->GetOpDesc();
+    const string &name = job.node->GetName();
+    const string &type = job.node->GetType();
+    int64_t op_id = op_desc->GetId();
+    int64_t stream_id = job.stream_id;
+
+    // Profiling task
+    size_t task_list_size_before = task_def_list.size();
+    GE_CHK_STATUS_RET(InsertProfilingTaskBefore(op_desc, ppoint, ar_ppoint, job.node_index, task_def_list));
+    if (job.generated) {
+      task_def_list.insert(task_def_list.end(), std::make_move_iterator(job.tasks.begin()),
+                           std::make_move_iterator(job.tasks.end()));
+      vector<domi::TaskDef>().swap(job.tasks);
+    } else {
+      GE_TIMESTAMP_RESTART(GenerateTask);
+      ret = GenerateNodeTask(job, run_context, task_def_list);
+      GE_TIMESTAMP_ADD(GenerateTask);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    }
+    // Profiling task
+    GE_CHK_STATUS_RET(InsertProfilingTaskAfter(op_desc, ppoint, ar_ppoint, job.node_index, task_def_list));
+
+    size_t task_list_size_after = task_def_list.size();
+    // If tasks is reduced
+    if (task_list_size_after < task_list_size_before) {
+      GELOGE(FAILED, "Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task. but task num from %zu to %zu.",
+             job.op_kernel_lib_name.c_str(), name.c_str(), type.c_str(), op_id, stream_id, task_list_size_before,
+             task_list_size_after);
+      return FAILED;
+    }
+
+    // Reset stream id to ge stream id, as graph load must use ge stream to reassign stream
+    void *ops_kernel_info_store_ptr = job.kernel_info_store.get();
+    for (size_t idx = task_list_size_before; idx < task_list_size_after; ++idx) {
+      task_def_list[idx].set_stream_id(static_cast<uint32_t>(stream_id));
+      op_name_map[idx] = name;
+      // Set opsKernelInfoStorePtr and op_index, the two fields be use in DistributeTask and InitTaskInfo
+      TaskDef *task_def_ptr = &task_def_list[idx];
+      GE_CHECK_NOTNULL(task_def_ptr);
+      task_def_ptr->set_ops_kernel_store_ptr(reinterpret_cast<uintptr_t>(ops_kernel_info_store_ptr));
+    }
+
+    GELOGD("Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task finished, generate %lu task(s).",
+           job.op_kernel_lib_name.c_str(), name.c_str(), type.c_str(), op_id, stream_id,
+           task_list_size_after - task_list_size_before);
+  }
+  GE_TIMESTAMP_CALLNUM_END(GenerateTask, "GraphBuild::GenerateTask");
+  GE_TRACE_ARG(GenerateTask, "node_num", static_cast<int64_t>(jobs.size()));
+  GE_TRACE_ARG(GenerateTask, "task_num", static_cast<int64_t>(task_def_list.size()));
+  GE_TRACE_COUNTER("task_num", static_cast<int64_t>(task_def_list.size()));
+  return SUCCESS;
+}
+
+Status TaskGenerator::PrepareTaskGenJobs(const ComputeGraphPtr &graph, size_t stream_num, vector<TaskGenJob> &jobs) {
+  std::shared_ptr<GELib> ge_lib = GELib::GetInstance();
+  GE_CHECK_NOTNULL(ge_lib);
   const OpsKernelManager &ops_kernel_manager = ge_lib->OpsKernelManagerObj();
 
   uint32_t node_index = 0;
-  GE_TIMESTAMP_CALLNUM_START(GenerateTask);
   for (auto &node : graph->GetAllNodes()) {
     GE_CHECK_NOTNULL(node->GetOpDesc());
     if (node->GetOpDesc()->GetType() == CONCAT) {
@@ -226,7 +334,7 @@ Status TaskGenerator::GenerateTask(RunContext &run_context, ComputeGraphPtr &gra
       return INTERNAL_ERROR;
     }
 
-    ret = UpdateAnchorStatus(node);
+    Status ret = UpdateAnchorStatus(node);
     if (ret != SUCCESS) {
       GELOGE(ret, "Call UpdateAnchorStatus node:%s(%s) failed", name.c_str(), type.c_str());
       return ret;
@@ -234,54 +342,94 @@ Status TaskGenerator::GenerateTask(RunContext &run_context, ComputeGraphPtr &gra
 
     int64_t op_id = op_desc->GetId();
     int64_t stream_id = op_desc->GetStreamId();
-    if (stream_id < 0 || stream_id >= static_cast<int64_t>(run_context.graphStreamList.size())) {
+    if (stream_id < 0 || stream_id >= static_cast<int64_t>(stream_num)) {
       GELOGE(INTERNAL_ERROR, "node[name:%s(%s), id:%ld] stream id is invalid, stream list size=%zu", name.c_str(),
-             type.c_str(), op_id, run_context.graphStreamList.size());
+             type.c_str(), op_id, stream_num);
       return INTERNAL_ERROR;
     }
 
-    // Profiling task
-    size_t task_list_size_before = task_def_list.size();
-    GE_CHK_STATUS_RET(InsertProfilingTaskBefore(op_desc, ppoint, ar_ppoint, node_index, task_def_list));
-    run_context.stream = run_context.graphStreamList[stream_id];
-    GELOGD("Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task.", op_kernel_lib_name.c_str(),
-           name.c_str(), type.c_str(), op_id, stream_id);
-    GE_TIMESTAMP_RESTART(GenerateTask);
-    ret = kernel_info_store->GenerateTask(*node, run_context, task_def_list);
-    GE_TIMESTAMP_ADD(GenerateTask);
-    if (ret != SUCCESS) {
-      GELOGE(ret, "Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task failed.",
-             op_kernel_lib_name.c_str(), name.c_str(), type.c_str(), op_id, stream_id);
-      return ret;
+    TaskGenJob job;
+    job.node = node;
+    job.kernel_info_store = kernel_info_store;
+    job.op_kernel_lib_name = op_kernel_lib_name;
+    job.node_index = node_index;
+    job.stream_id = stream_id;
+    jobs.emplace_back(std::move(job));
+  }
+  return SUCCESS;
+}
+
+Status TaskGenerator::GenerateTaskInParallel(const RunContext &run_context, uint32_t thread_num,
+                                             vector<TaskGenJob> &jobs) {
+  std::set<string> thread_safe_libs = GetTaskGenThreadSafeLibs();
+  vector<size_t> parallel_jobs;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (thread_safe_libs.count(jobs[i].op_kernel_lib_name) > 0) {
+      parallel_jobs.emplace_back(i);
     }
-    // Profiling task
-    GE_CHK_STATUS_RET(InsertProfilingTaskAfter(op_desc, ppoint, ar_ppoint, node_index, task_def_list));
+  }
+  size_t shard_num = std::min(static_cast<size_t>(thread_num), parallel_jobs.size());
+  GELOGI("Generate tasks of %zu of %zu nodes in %zu shards.", parallel_jobs.size(), jobs.size(), shard_num);
+  if (shard_num <= 1) {
+    return SUCCESS;
+  }
 
-    size_t task_list_size_after = task_def_list.size();
-    // If tasks is reduced
-    if (task_list_size_after < task_list_size_before) {
-      GELOGE(FAILED, "Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task. but task num from %zu to %zu.",
-             op_kernel_lib_name.c_str(), name.c_str(), type.c_str(), op_id, stream_id, task_list_size_before,
-             task_list_size_after);
+  // Every shard runs on its own copy of run context, as stream of run context is switched per node,
+  // and on a copy of the caller's thread local context, as kernel stores read options from it
+  auto generate_shard = [&jobs, &parallel_jobs, &run_context](size_t begin, size_t end,
+                                                               const GEThreadLocalContext &ge_context) -> Status {
+    GetThreadLocalContext() = ge_context;
+    GE_TRACE_SCOPE(GenerateShard, "TaskGenerator::GenerateShard");
+    GE_TRACE_ARG(GenerateShard, "node_num", static_cast<int64_t>(end - begin));
+    RunContext shard_context = run_context;
+    for (size_t i = begin; i < end; ++i) {
+      TaskGenJob &job = jobs[parallel_jobs[i]];
+      Status ret = GenerateNodeTask(job, shard_context, job.tasks);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+      job.generated = true;
+    }
+    return SUCCESS;
+  };
+
+  ThreadPool thread_pool(static_cast<uint32_t>(shard_num));
+  vector<std::future<Status>> futures;
+  for (size_t shard = 0; shard < shard_num; ++shard) {
+    size_t begin = parallel_jobs.size() * shard / shard_num;
+    size_t end = parallel_jobs.size() * (shard + 1) / shard_num;
+    std::future<Status> f = thread_pool.commit(generate_shard, begin, end, GetThreadLocalContext());
+    if (!f.valid()) {
+      GELOGE(FAILED, "Commit task generation of shard %zu failed.", shard);
       return FAILED;
     }
+    futures.emplace_back(std::move(f));
+  }
 
-    // Reset stream id to ge stream id, as graph load must use ge stream to reassign stream
-    void *ops_kernel_info_store_ptr = kernel_info_store.get();
-    for (size_t idx = task_list_size_before; idx < task_list_size_after; ++idx) {
-      task_def_list[idx].set_stream_id(static_cast<uint32_t>(stream_id));
-      op_name_map[idx] = name;
-      // Set opsKernelInfoStorePtr and op_index, the two fields be use in DistributeTask and InitTaskInfo
-      TaskDef *task_def_ptr = &task_def_list[idx];
-      GE_CHECK_NOTNULL(task_def_ptr);
-      task_def_ptr->set_ops_kernel_store_ptr(reinterpret_cast<uintptr_t>(ops_kernel_info_store_ptr));
+  Status result = SUCCESS;
+  for (auto &f : futures) {
+    Status ret = f.get();
+    if ((ret != SUCCESS) && (result == SUCCESS)) {
+      result = ret;
     }
+  }
+  return result;
+}
 
-    GELOGD("Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task finished, generate %lu task(s).",
-           op_kernel_lib_name.c_str(), name.c_str(), type.c_str(), op_id, stream_id,
-           task_list_size_after - task_list_size_before);
+Status TaskGenerator::GenerateNodeTask(const TaskGenJob &job, RunContext &run_context,
+                                       vector<domi::TaskDef> &task_def_list) {
+  const string &name = job.node->GetName();
+  const string &type = job.node->GetType();
+  int64_t op_id = job.node->GetOpDesc()->GetId();
+  run_context.stream = run_context.graphStreamList[job.stream_id];
+  GELOGD("Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task.", job.op_kernel_lib_name.c_str(),
+         name.c_str(), type.c_str(), op_id, job.stream_id);
+  Status ret = job.kernel_info_store->GenerateTask(*job.node, run_context, task_def_list);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task failed.",
+           job.op_kernel_lib_name.c_str(), name.c_str(), type.c_str(), op_id, job.stream_id);
+    return ret;
   }
-  GE_TIMESTAMP_CALLNUM_END(GenerateTask, "GraphBuild::GenerateTask");
   return SUCCESS;
 }
 
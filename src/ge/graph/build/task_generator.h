@@ -30,12 +30,26 @@
 #include "runtime/rt.h"
 
 namespace ge {
+class OpsKernelInfoStore;
+
 struct ProfilingPoint {
   uint32_t fp_index = 0;
   uint32_t bp_index = 0;
   uint32_t end_index = 0;
 };
 
+// A node whose tasks are generated by kernel store, collected in node order before generating tasks
+struct TaskGenJob {
+  NodePtr node;
+  std::shared_ptr<OpsKernelInfoStore> kernel_info_store;
+  std::string op_kernel_lib_name;
+  uint32_t node_index = 0;
+  int64_t stream_id = 0;
+  // Tasks generated concurrently, which are merged into task def list in node order
+  bool generated = false;
+  std::vector<domi::TaskDef> tasks;
+};
+
 class TaskGenerator {
  public:
   TaskGenerator() = default;
@@ -76,6 +90,30 @@ class TaskGenerator {
   Status GenerateTask(RunContext &run_context, ComputeGraphPtr &graph, std::vector<domi::TaskDef> &task_def_list,
                       std::map<uint32_t, string> &op_name_map);
 
+  ///
+  /// update attrs and anchor status of nodes in node order and collect nodes whose tasks need to be generated.
+  /// @param graph compute graph
+  /// @param stream_num number of streams of graph
+  /// @param jobs nodes to generate tasks
+  /// @return SUCCESS:seccess
+  ///         Other: failed
+  ///
+  Status PrepareTaskGenJobs(const ComputeGraphPtr &graph, size_t stream_num, std::vector<TaskGenJob> &jobs);
+
+  ///
+  /// generate tasks of jobs whose op kernel libs are configured thread safe on thread_num workers,
+  /// each worker generates tasks of a contiguous shard of jobs into job local task lists.
+  /// @param run_context run context
+  /// @param thread_num number of workers
+  /// @param jobs nodes to generate tasks
+  /// @return SUCCESS:seccess
+  ///         Other: failed
+  ///
+  Status GenerateTaskInParallel(const RunContext &run_context, uint32_t thread_num, std::vector<TaskGenJob> &jobs);
+
+  static Status GenerateNodeTask(const TaskGenJob &job, RunContext &run_context,
+                                 std::vector<domi::TaskDef> &task_def_list);
+
   ///
   /// AddModelTaskToModel
   /// @param model_task_def model task
@@ -21,7 +21,6 @@
 #include "graph/load/new_model_manager/model_manager.h"
 #include "omm/csa_interact.h"
 #include "runtime/dev.h"
-#include "runtime/mem.h"
 
 namespace ge {
 namespace {
@@ -40,15 +39,6 @@ GraphExecutor::GraphExecutor()
 
 GraphExecutor::~GraphExecutor() {
   outputs_desc_.clear();
-  if (malloc_flag_) {
-    for (auto &buffer_addr : buffer_addr_) {
-      rtError_t rt_ret;
-      rt_ret = rtFreeHost(buffer_addr);
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(RT_FAILED, "[GraphManager] subgraph free buffer failed, ret: 0x%X", rt_ret);
-      }
-    }
-  }
   malloc_flag_ = false;
   buffer_addr_.clear();
 }
@@ -91,17 +81,9 @@ void GraphExecutor::SetTrainFlag(bool is_train_graph) { train_graph_flag_ = is_t
 
 Status GraphExecutor::FreeInOutBuffer() {
   if (malloc_flag_) {
-    for (auto iter = buffer_addr_.begin(); iter != buffer_addr_.end(); ++iter) {
-      rtError_t rt_ret;
-      rt_ret = rtFreeHost(*iter);
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(RT_FAILED, "[GraphManager] subgraph free buffer failed, ret: 0x%X", rt_ret);
-        (void)buffer_addr_.erase(buffer_addr_.begin(), iter);
-        return GE_GRAPH_FREE_FAILED;
-      }
-    }
+    // Buffers are returned to the pool for other graphs
     buffer_addr_.clear();
-
+    buffer_size_.clear();
     malloc_flag_ = false;
     return SUCCESS;
   } else {
@@ -111,43 +93,30 @@ Status GraphExecutor::FreeInOutBuffer() {
 }
 
 Status GraphExecutor::MallocInOutBuffer(const std::vector<uint32_t> &buffer_size, std::vector<void *> &data_addr) {
-  if (malloc_flag_) {
-    auto all_size_same = true;
-    if (buffer_size.size() == buffer_size_.size()) {
-      for (size_t i = 0; i < buffer_size.size(); i++) {
-        if (buffer_size[i] != buffer_size_[i]) {
-          all_size_same = false;
-          break;
-        }
-      }
-    } else {
-      all_size_same = false;
-    }
-    if (all_size_same) {
-      data_addr = buffer_addr_;
-      return SUCCESS;
-    }
-    buffer_size_.clear();
-    auto rt_ret = FreeInOutBuffer();
-    if (rt_ret != SUCCESS) {
-      GELOGE(RT_FAILED, "[SubGraphInfo] MallocInOutBuffer free buffer failed, ret: 0x%X", rt_ret);
-      return RT_FAILED;
+  if (malloc_flag_ && (buffer_size == buffer_size_)) {
+    for (const auto &buffer : buffer_addr_) {
+      data_addr.push_back(buffer.get());
     }
+    return SUCCESS;
   }
 
-  rtError_t rt_ret;
+  // Buffers of sizes in the same size class are taken back from the pool
+  std::vector<HostBufferPtr> buffer_addr;
   for (size_t i = 0; i < buffer_size.size(); ++i) {
-    void *tmp_buf = nullptr;
-    rt_ret = rtMallocHost(&tmp_buf, buffer_size[i]);
-    if (rt_ret != RT_ERROR_NONE) {
-      GELOGE(RT_FAILED, "[GraphManager] subgraph malloc buffer failed, ret: 0x%X", rt_ret);
+    HostBufferPtr buffer = HostMemPool::Instance().Malloc(buffer_size[i]);
+    if (buffer == nullptr) {
+      GELOGE(GE_GRAPH_MALLOC_FAILED, "[GraphManager] subgraph malloc buffer failed, size: %u", buffer_size[i]);
       return GE_GRAPH_MALLOC_FAILED;
     }
-    malloc_flag_ = true;
-    data_addr.push_back(tmp_buf);
-    buffer_addr_.push_back(tmp_buf);
+    buffer_addr.push_back(buffer);
+  }
+  buffer_addr_.swap(buffer_addr);
+  buffer_addr.clear();
+  for (const auto &buffer : buffer_addr_) {
+    data_addr.push_back(buffer.get());
   }
   buffer_size_ = buffer_size;
+  malloc_flag_ = true;
   return SUCCESS;
 }
 
@@ -264,20 +233,10 @@ Status GraphExecutor::SyncExecuteModel(uint32_t model_id, const std::vector<GeTe
     }
   }
   for (size_t i = 0; i < output_data.blobs.size(); ++i) {
-    DataBuffer out_data_tmp = output_data.blobs[i];
+    const DataBuffer &out_data_tmp = output_data.blobs[i];
     CHECK_FALSE_EXEC(out_data_tmp.length != 0,
                      GELOGE(GE_GRAPH_EXECUTE_FAILED, "Failed to allocate memory, length is 0.");
                      return GE_GRAPH_EXECUTE_FAILED);
-    std::unique_ptr<uint8_t> out_buf_tmp(new (std::nothrow) uint8_t[out_data_tmp.length]);
-    if (out_buf_tmp == nullptr) {
-      GELOGE(FAILED, "Failed to allocate memory.");
-      return FAILED;
-    }
-    rtError_t ret_value = rtMemcpy(out_buf_tmp.get(), out_data_tmp.length, out_data_tmp.data, out_data_tmp.length,
-                                   RT_MEMCPY_DEVICE_TO_HOST);
-    CHECK_FALSE_EXEC(ret_value == RT_ERROR_NONE,
-                     GELOGE(GE_GRAPH_EXECUTE_FAILED, "Call rt api rtMemcpy failed, ret: 0x%X", ret);
-                     return GE_GRAPH_EXECUTE_FAILED);
     GeTensor out_tensor;
     std::vector<int64_t> shape_dims;
     for (const auto &dim : output_desc[i].shape_info.dims) {
@@ -287,7 +246,8 @@ Status GraphExecutor::SyncExecuteModel(uint32_t model_id, const std::vector<GeTe
     GeShape out_shape(shape_dims);
     out_tensor.MutableTensorDesc().SetShape(out_shape);
     out_tensor.MutableTensorDesc().SetDataType((DataType)output_desc[i].data_type);
-    if (out_tensor.SetData(out_buf_tmp.get(), out_data_tmp.length) != SUCCESS) {
+    // Outputs have been copied to pinned host buffers by model, tensor data is filled from them directly
+    if (out_tensor.SetData(reinterpret_cast<const uint8_t *>(out_data_tmp.data), out_data_tmp.length) != SUCCESS) {
       GELOGE(FAILED, "Out tensor set data failed");
       return FAILED;
     }
@@ -34,6 +34,7 @@
 #include "ge/ge_api_types.h"
 #include "graph/compute_graph.h"
 #include "graph/manager/graph_context.h"
+#include "graph/manager/host_mem_pool.h"
 #include "graph/manager/graph_manager_utils.h"
 #include "graph/model.h"
 #include "graph/utils/graph_utils.h"
@@ -109,7 +110,8 @@ class GraphExecutor {
   GraphId last_graph_id_;
 
   bool malloc_flag_;
-  std::vector<void *> buffer_addr_;
+  // Input and output buffers of the last run, taken from HostMemPool
+  std::vector<HostBufferPtr> buffer_addr_;
   std::vector<uint32_t> buffer_size_;
 };
 }  // namespace ge
@@ -0,0 +1,340 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/load/new_model_manager/async_data_dumper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "common/debug/memory_dumper.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+#include "framework/common/util.h"
+#include "runtime/event.h"
+#include "runtime/mem.h"
+
+namespace ge {
+namespace {
+// Items are aligned in host buffers for the copy engine
+const uint64_t kDumpItemAlign = 64;
+// Data of an op are written with their descriptions in one file, leave room for the descriptions
+const uint64_t kMaxOpDataSize = UINT32_MAX / 2;
+const uint16_t kFp16ExponentMask = 0x7C00;
+
+uint64_t ElapsedUs(const std::chrono::steady_clock::time_point &start) {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+template <typename T>
+bool HasNonFinite(const uint8_t *data, uint64_t size) {
+  for (uint64_t offset = 0; offset + sizeof(T) <= size; offset += sizeof(T)) {
+    T value;
+    (void)memcpy(&value, data + offset, sizeof(T));
+    if (!std::isfinite(value)) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+AsyncDataDumper::~AsyncDataDumper() { Finalize(); }
+
+Status AsyncDataDumper::Init(const std::string &dump_path, const AsyncDumpOptions &options,
+                             const std::vector<AsyncDumpOp> &ops) {
+  GE_CHK_BOOL_RET_STATUS(!is_inited_, FAILED, "Async data dumper is already inited.");
+  GE_CHK_BOOL_RET_STATUS(options.step_interval > 0 && options.buffer_num > 0, PARAM_INVALID,
+                         "Step interval %lu and buffer num %u of async dump should be positive.",
+                         options.step_interval, options.buffer_num);
+  dump_path_ = dump_path;
+  options_ = options;
+  for (const auto &op : ops) {
+    const std::string &op_name = op.task.op().op_name();
+    if (!IsOpDumped(op_name)) {
+      continue;
+    }
+    size_t output_num = static_cast<size_t>(op.task.output_size());
+    GE_CHK_BOOL_RET_STATUS(op.output_sizes.size() == output_num && op.output_data_types.size() == output_num,
+                           PARAM_INVALID, "Sizes or data types of %zu outputs of op %s to dump are not given.",
+                           output_num, op_name.c_str());
+    std::vector<uint64_t> offsets;
+    uint64_t op_data_size = 0;
+    for (size_t i = 0; i < output_num; ++i) {
+      offsets.push_back(buffer_size_);
+      op_data_size += op.output_sizes[i];
+      buffer_size_ += (op.output_sizes[i] + kDumpItemAlign - 1) / kDumpItemAlign * kDumpItemAlign;
+    }
+    // A file of the op is written at once, with the data and descriptions of outputs
+    GE_CHK_BOOL_RET_STATUS(op_data_size <= kMaxOpDataSize, PARAM_INVALID, "Op %s is too large to dump, size %lu.",
+                           op_name.c_str(), op_data_size);
+    ops_.push_back(op);
+    offsets_.push_back(std::move(offsets));
+    data_size_ += op_data_size;
+  }
+  if (ops_.empty()) {
+    GELOGW("No output to dump asynchronously in %s.", dump_path_.c_str());
+    return SUCCESS;
+  }
+
+  buffers_.resize(options_.buffer_num);
+  for (auto &buffer : buffers_) {
+    rtError_t rt_ret = rtMallocHost(reinterpret_cast<void **>(&buffer.host_addr), buffer_size_);
+    if (rt_ret == RT_ERROR_NONE) {
+      rt_ret = rtEventCreate(&buffer.event);
+    }
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Alloc async dump buffer of size %lu failed, ret: 0x%X.", buffer_size_, rt_ret);
+      FreeBuffers();
+      return RT_FAILED;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    free_buffers_.push_back(i);
+  }
+  is_stopped_ = false;
+  thread_ = std::thread(&AsyncDataDumper::Run, this);
+  is_inited_ = true;
+  GELOGI("Async data dumper starts, %zu ops, %u buffers of size %lu, step interval %lu, nan inf only %d.",
+         ops_.size(), options_.buffer_num, buffer_size_, options_.step_interval, options_.nan_inf_only);
+  return SUCCESS;
+}
+
+void AsyncDataDumper::Finalize() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  cond_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  FreeBuffers();
+  is_inited_ = false;
+}
+
+Status AsyncDataDumper::DumpIteration(uint64_t iteration, rtStream_t stream) {
+  if (!is_inited_ || !IsSampled(iteration)) {
+    return SUCCESS;
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t index = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_stopped_) {
+      return SUCCESS;
+    }
+    if (free_buffers_.empty()) {
+      stats_.dropped_count++;
+      GELOGD("Iteration %lu is not dumped as all buffers are in use.", iteration);
+      return SUCCESS;
+    }
+    index = free_buffers_.front();
+    free_buffers_.pop_front();
+  }
+
+  DumpBuffer &buffer = buffers_[index];
+  rtError_t rt_ret = RT_ERROR_NONE;
+  for (size_t i = 0; i < ops_.size() && rt_ret == RT_ERROR_NONE; ++i) {
+    const auto &op = ops_[i];
+    for (size_t j = 0; j < op.output_sizes.size() && rt_ret == RT_ERROR_NONE; ++j) {
+      if (op.output_sizes[j] == 0) {
+        continue;
+      }
+      void *dev_addr = reinterpret_cast<void *>(static_cast<uintptr_t>(op.task.output(j).address()));
+      rt_ret = rtMemcpyAsync(buffer.host_addr + offsets_[i][j], op.output_sizes[j], dev_addr, op.output_sizes[j],
+                             RT_MEMCPY_DEVICE_TO_HOST, stream);
+    }
+  }
+  if (rt_ret == RT_ERROR_NONE) {
+    rt_ret = rtEventRecord(buffer.event, stream);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rt_ret != RT_ERROR_NONE) {
+      free_buffers_.push_front(index);
+      GELOGE(RT_FAILED, "Copy outputs of iteration %lu to dump failed, ret: 0x%X.", iteration, rt_ret);
+      return RT_FAILED;
+    }
+    buffer.iteration = iteration;
+    filled_buffers_.push_back(index);
+    stats_.sampled_count++;
+    stats_.enqueue_time_us += ElapsedUs(start);
+  }
+  cond_.notify_one();
+  return SUCCESS;
+}
+
+void AsyncDataDumper::GetStats(AsyncDumpStats &stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats = stats_;
+}
+
+bool AsyncDataDumper::IsSampled(uint64_t iteration) const { return (iteration % options_.step_interval) == 0; }
+
+bool AsyncDataDumper::IsOpDumped(const std::string &op_name) const {
+  if (options_.op_filters.empty()) {
+    return true;
+  }
+  for (const auto &op_filter : options_.op_filters) {
+    bool is_scope = !op_filter.empty() && op_filter.back() == '/';
+    if ((is_scope && op_name.compare(0, op_filter.size(), op_filter) == 0) || (op_name == op_filter)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AsyncDataDumper::Run() {
+  while (true) {
+    size_t index = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return is_stopped_ || !filled_buffers_.empty(); });
+      // Queued iterations are still written after stopped
+      if (filled_buffers_.empty()) {
+        break;
+      }
+      index = filled_buffers_.front();
+      filled_buffers_.pop_front();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const DumpBuffer &buffer = buffers_[index];
+    bool is_skipped = false;
+    Status ret = FAILED;
+    rtError_t rt_ret = rtEventSynchronize(buffer.event);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Wait for outputs of iteration %lu failed, ret: 0x%X.", buffer.iteration, rt_ret);
+    } else {
+      ret = WriteBuffer(buffer, is_skipped);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ret == SUCCESS && is_skipped) {
+      stats_.skipped_count++;
+    } else if (ret == SUCCESS) {
+      stats_.written_count++;
+      stats_.written_bytes += data_size_;
+    }
+    stats_.write_time_us += ElapsedUs(start);
+    free_buffers_.push_back(index);
+  }
+}
+
+void AsyncDataDumper::FillOpDump(size_t index, const DumpBuffer &buffer, dump::OpDump &op_dump) const {
+  const AsyncDumpOp &op = ops_[index];
+  op_dump.set_op_name(op.task.op().op_name());
+  op_dump.set_op_type(op.task.op().op_type());
+  op_dump.set_task_id(op.task.task_id());
+  op_dump.set_stream_id(op.task.stream_id());
+  op_dump.set_iteration(buffer.iteration);
+  for (size_t j = 0; j < op.output_sizes.size(); ++j) {
+    const aicpu::dump::Output &output = op.task.output(static_cast<int>(j));
+    dump::OutputDump *output_dump = op_dump.add_output();
+    output_dump->set_data_type(output.data_type());
+    output_dump->set_format(output.format());
+    for (uint64_t dim : output.shape().dim()) {
+      output_dump->add_dim(dim);
+    }
+    output_dump->set_original_name(output.original_name());
+    output_dump->set_original_output_index(output.original_output_index());
+    output_dump->set_original_output_data_type(output.original_output_data_type());
+    output_dump->set_original_output_format(output.original_output_format());
+    output_dump->set_data(buffer.host_addr + offsets_[index][j], static_cast<size_t>(op.output_sizes[j]));
+  }
+}
+
+Status AsyncDataDumper::WriteBuffer(const DumpBuffer &buffer, bool &is_skipped) {
+  if (options_.nan_inf_only) {
+    bool has_nan_or_inf = false;
+    for (size_t i = 0; i < ops_.size() && !has_nan_or_inf; ++i) {
+      for (size_t j = 0; j < ops_[i].output_sizes.size() && !has_nan_or_inf; ++j) {
+        has_nan_or_inf = HasNanOrInf(ops_[i].output_data_types[j], buffer.host_addr + offsets_[i][j],
+                                     ops_[i].output_sizes[j]);
+      }
+    }
+    if (!has_nan_or_inf) {
+      is_skipped = true;
+      return SUCCESS;
+    }
+    GELOGI("NaN or Inf is found in iteration %lu, dump it.", buffer.iteration);
+  }
+
+  std::string dir_path = dump_path_ + std::to_string(buffer.iteration) + "/";
+  GE_CHK_BOOL_RET_STATUS(CreateDirectory(dir_path) == 0, FAILED, "Create dump directory %s failed.", dir_path.c_str());
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  std::string timestamp = std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+  std::string proto_str;
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    dump::OpDump op_dump;
+    FillOpDump(i, buffer, op_dump);
+    GE_CHK_BOOL_RET_STATUS(op_dump.SerializeToString(&proto_str), FAILED, "Serialize dump of op %s failed.",
+                           op_dump.op_name().c_str());
+    // Named as {op_type}.{op_name}.{task_id}.{timestamp}, the same as aicpu dump
+    std::string op_name = op_dump.op_name();
+    std::replace(op_name.begin(), op_name.end(), '/', '_');
+    std::replace(op_name.begin(), op_name.end(), '.', '_');
+    std::string file_path =
+      dir_path + op_dump.op_type() + "." + op_name + "." + std::to_string(op_dump.task_id()) + "." + timestamp;
+    GE_CHK_STATUS_RET(
+      MemoryDumper::DumpToFile(file_path.c_str(), &proto_str[0], static_cast<uint32_t>(proto_str.size())),
+      "Dump %s failed.", file_path.c_str());
+  }
+  return SUCCESS;
+}
+
+void AsyncDataDumper::FreeBuffers() {
+  for (auto &buffer : buffers_) {
+    if (buffer.host_addr != nullptr) {
+      GE_CHK_RT(rtFreeHost(buffer.host_addr));
+      buffer.host_addr = nullptr;
+    }
+    if (buffer.event != nullptr) {
+      GE_CHK_RT(rtEventDestroy(buffer.event));
+      buffer.event = nullptr;
+    }
+  }
+  buffers_.clear();
+  free_buffers_.clear();
+  filled_buffers_.clear();
+}
+
+bool AsyncDataDumper::HasNanOrInf(DataType data_type, const uint8_t *data, uint64_t size) {
+  switch (data_type) {
+    case DT_FLOAT:
+      return HasNonFinite<float>(data, size);
+    case DT_DOUBLE:
+      return HasNonFinite<double>(data, size);
+    case DT_FLOAT16:
+      for (uint64_t offset = 0; offset + sizeof(uint16_t) <= size; offset += sizeof(uint16_t)) {
+        uint16_t value = 0;
+        (void)memcpy(&value, data + offset, sizeof(uint16_t));
+        if ((value & kFp16ExponentMask) == kFp16ExponentMask) {
+          return true;
+        }
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+}  // namespace ge
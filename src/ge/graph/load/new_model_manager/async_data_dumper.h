@@ -0,0 +1,124 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_LOAD_NEW_MODEL_MANAGER_ASYNC_DATA_DUMPER_H_
+#define GE_GRAPH_LOAD_NEW_MODEL_MANAGER_ASYNC_DATA_DUMPER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/ge_inner_error_codes.h"
+#include "common/ge_types.h"
+#include "external/graph/types.h"
+#include "proto/async_dump.pb.h"
+#include "proto/op_mapping_info.pb.h"
+#include "runtime/base.h"
+
+namespace ge {
+// An op to dump, the device memory of its outputs is rewritten by every iteration
+struct AsyncDumpOp {
+  // The same as loaded for aicpu dump, addresses of outputs are device addresses
+  aicpu::dump::Task task;
+  std::vector<uint64_t> output_sizes;
+  std::vector<DataType> output_data_types;
+};
+
+///
+/// @ingroup ge
+/// @brief Dump outputs of sampled iterations without blocking execution.
+///        Outputs of an iteration are copied on the model stream into one of buffer_num preallocated host buffers,
+///        then a background thread waits for the copy and writes the files. When all buffers are still being written
+///        the iteration is dropped and counted, so the executing thread never waits for files.
+///        Each op is written to a file named as by aicpu dump, holding one ge::dump::OpDump with the output data,
+///        which is a host only format for tools of GE, not the one written by aicpu dump.
+///
+class AsyncDataDumper {
+ public:
+  AsyncDataDumper() = default;
+  ~AsyncDataDumper();
+
+  AsyncDataDumper(const AsyncDataDumper &) = delete;
+  AsyncDataDumper &operator=(const AsyncDataDumper &) = delete;
+
+  ///
+  /// @ingroup ge
+  /// @brief Allocate host buffers and start the writing thread.
+  /// @param [in] dump_path: files of iteration N are written to dump_path/N/.
+  /// @param [in] options: sampling policy, ops are filtered by op_filters here.
+  /// @param [in] ops: ops to dump.
+  ///
+  Status Init(const std::string &dump_path, const AsyncDumpOptions &options, const std::vector<AsyncDumpOp> &ops);
+
+  // Write the queued iterations and stop the writing thread.
+  void Finalize();
+
+  bool IsInited() const { return is_inited_; }
+
+  ///
+  /// @ingroup ge
+  /// @brief Called after the iteration is launched on stream, copies are queued behind it.
+  /// @param [in] iteration: iteration number, iterations not sampled return directly.
+  /// @param [in] stream: stream the model is executed on.
+  ///
+  Status DumpIteration(uint64_t iteration, rtStream_t stream);
+
+  void GetStats(AsyncDumpStats &stats);
+
+ private:
+  struct DumpBuffer {
+    uint8_t *host_addr = nullptr;
+    rtEvent_t event = nullptr;
+    uint64_t iteration = 0;
+  };
+
+  bool IsSampled(uint64_t iteration) const;
+  bool IsOpDumped(const std::string &op_name) const;
+  void Run();
+  // Dump of the op with the copied data of outputs
+  void FillOpDump(size_t index, const DumpBuffer &buffer, dump::OpDump &op_dump) const;
+  Status WriteBuffer(const DumpBuffer &buffer, bool &is_skipped);
+  void FreeBuffers();
+
+  static bool HasNanOrInf(DataType data_type, const uint8_t *data, uint64_t size);
+
+  std::string dump_path_;
+  AsyncDumpOptions options_;
+  std::vector<AsyncDumpOp> ops_;
+  // Offsets of outputs of ops in a host buffer
+  std::vector<std::vector<uint64_t>> offsets_;
+  uint64_t data_size_ = 0;
+  uint64_t buffer_size_ = 0;
+  std::vector<DumpBuffer> buffers_;
+  bool is_inited_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // Indexes of buffers, a buffer is either free or filled, or being written
+  std::deque<size_t> free_buffers_;
+  std::deque<size_t> filled_buffers_;
+  bool is_stopped_ = true;
+  std::thread thread_;
+
+  // Guarded by mutex_.
+  AsyncDumpStats stats_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_LOAD_NEW_MODEL_MANAGER_ASYNC_DATA_DUMPER_H_
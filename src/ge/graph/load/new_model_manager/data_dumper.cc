@@ -15,6 +15,9 @@
  */
 
 #include "graph/load/new_model_manager/data_dumper.h"
+
+#include <utility>
+
 #include "graph/utils/attr_utils.h"
 #include "graph/debug/ge_attr_define.h"
 #include "framework/common/debug/ge_log.h"
@@ -25,6 +28,7 @@
 #include "framework/common/util.h"
 #include "model_utils.h"
 #include "graph/anchor.h"
+#include "graph/utils/tensor_utils.h"
 
 namespace {
 const uint32_t kAicpuLoadFlag = 1;
@@ -69,6 +73,26 @@ static int32_t GetIrDataType(ge::DataType data_type) {
   return static_cast<int32_t>(iter->second);
 }
 
+static void SetDumpOutput(const ge::GeTensorDesc &tensor_desc, const void *addr, aicpu::dump::Output &output) {
+  output.set_data_type(static_cast<int32_t>(GetIrDataType(tensor_desc.GetDataType())));
+  output.set_format(static_cast<int32_t>(tensor_desc.GetFormat()));
+
+  for (auto dim : tensor_desc.GetShape().GetDims()) {
+    output.mutable_shape()->add_dim(dim);
+  }
+
+  std::string origin_name;
+  int32_t origin_output_index = -1;
+  (void)ge::AttrUtils::GetStr(&tensor_desc, ge::ATTR_NAME_DATA_DUMP_ORIGIN_NAME, origin_name);
+  (void)ge::AttrUtils::GetInt(&tensor_desc, ge::ATTR_NAME_DATA_DUMP_ORIGIN_OUTPUT_INDEX, origin_output_index);
+  output.set_original_name(origin_name);
+  output.set_original_output_index(origin_output_index);
+  output.set_original_output_format(static_cast<int32_t>(tensor_desc.GetOriginFormat()));
+  output.set_original_output_data_type(static_cast<int32_t>(tensor_desc.GetOriginDataType()));
+  // due to lhisi virtual addr bug, cannot use args now
+  output.set_address(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(addr)));
+}
+
 namespace ge {
 DataDumper::~DataDumper() {
   ReleaseDevMem(&dev_mem_load_);
@@ -181,6 +205,11 @@ Status DataDumper::LoadDumpInfo() {
     return SUCCESS;
   }
 
+  AsyncDumpOptions async_dump_options = PropertiesManager::Instance().GetAsyncDumpOptions();
+  if (async_dump_options.enable) {
+    return LoadAsyncDumpInfo(async_dump_options);
+  }
+
   aicpu::dump::OpMappingInfo op_mapping_info;
 
   op_mapping_info.set_dump_path(PropertiesManager::Instance().GetDumpOutputPath() + std::to_string(device_id_) + "/");
@@ -208,24 +237,7 @@ Status DataDumper::LoadDumpInfo() {
 
       for (size_t i = 0; i < output_descs.size(); ++i) {
         aicpu::dump::Output output;
-        output.set_data_type(static_cast<int32_t>(GetIrDataType(output_descs.at(i).GetDataType())));
-        output.set_format(static_cast<int32_t>(output_descs.at(i).GetFormat()));
-
-        for (auto dim : output_descs.at(i).GetShape().GetDims()) {
-          output.mutable_shape()->add_dim(dim);
-        }
-
-        std::string origin_name;
-        int32_t origin_output_index = -1;
-        (void)AttrUtils::GetStr(&output_descs.at(i), ATTR_NAME_DATA_DUMP_ORIGIN_NAME, origin_name);
-        (void)AttrUtils::GetInt(&output_descs.at(i), ATTR_NAME_DATA_DUMP_ORIGIN_OUTPUT_INDEX, origin_output_index);
-        output.set_original_name(origin_name);
-        output.set_original_output_index(origin_output_index);
-        output.set_original_output_format(static_cast<int32_t>(output_descs.at(i).GetOriginFormat()));
-        output.set_original_output_data_type(static_cast<int32_t>(output_descs.at(i).GetOriginDataType()));
-        // due to lhisi virtual addr bug, cannot use args now
-        output.set_address(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(output_addrs[i])));
-
+        SetDumpOutput(output_descs.at(i), output_addrs[i], output);
         task.mutable_output()->Add(std::move(output));
       }
       op_mapping_info.mutable_task()->Add(std::move(task));
@@ -242,24 +254,7 @@ Status DataDumper::LoadDumpInfo() {
       return PARAM_INVALID;
     }
 
-    output.set_data_type(static_cast<int32_t>(GetIrDataType(output_tensor->GetDataType())));
-    output.set_format(static_cast<int32_t>(output_tensor->GetFormat()));
-
-    for (auto dim : output_tensor->GetShape().GetDims()) {
-      output.mutable_shape()->add_dim(dim);
-    }
-
-    std::string origin_name;
-    int32_t origin_output_index = -1;
-    (void)AttrUtils::GetStr(output_tensor, ATTR_NAME_DATA_DUMP_ORIGIN_NAME, origin_name);
-    (void)AttrUtils::GetInt(output_tensor, ATTR_NAME_DATA_DUMP_ORIGIN_OUTPUT_INDEX, origin_output_index);
-    output.set_original_name(origin_name);
-    output.set_original_output_index(origin_output_index);
-    output.set_original_output_format(static_cast<int32_t>(output_tensor->GetOriginFormat()));
-    output.set_original_output_data_type(static_cast<int32_t>(output_tensor->GetOriginDataType()));
-    // due to lhisi virtual addr bug, cannot use args now
-    output.set_address(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(output_addrs[op_iter.output_anchor_index])));
-
+    SetDumpOutput(*output_tensor, output_addrs[op_iter.output_anchor_index], output);
     task.mutable_output()->Add(std::move(output));
 
     op_mapping_info.mutable_task()->Add(std::move(task));
@@ -301,7 +296,57 @@ Status DataDumper::LoadDumpInfo() {
   return SUCCESS;
 }
 
+Status DataDumper::LoadAsyncDumpInfo(const AsyncDumpOptions &options) {
+  // Ops are described as for aicpu dump, including data ops saved for each of their peer tasks
+  std::vector<AsyncDumpOp> dump_ops;
+  for (const auto &op_iter : op_list_) {
+    const std::vector<void *> output_addrs = ModelUtils::GetOutputDataAddrs(runtime_param_, op_iter.op, false);
+    const auto &output_descs = op_iter.op->GetAllOutputsDesc();
+    GE_CHK_BOOL_RET_STATUS(output_descs.size() == output_addrs.size(), PARAM_INVALID,
+                           "Invalid output desc addrs size %zu, op %s has %zu output desc.", output_addrs.size(),
+                           op_iter.op->GetName().c_str(), output_descs.size());
+    AsyncDumpOp dump_op;
+    dump_op.task.set_task_id(op_iter.task_id);
+    dump_op.task.mutable_op()->set_op_name(op_iter.op->GetName());
+    dump_op.task.mutable_op()->set_op_type(op_iter.op->GetType());
+    for (size_t i = 0; i < output_descs.size(); ++i) {
+      if (!op_iter.is_task && static_cast<int>(i) != op_iter.output_anchor_index) {
+        continue;
+      }
+      uint32_t size = 0;
+      GE_CHK_STATUS_RET(TensorUtils::GetSize(output_descs.at(i), size), "Get size of output %zu of op %s failed.", i,
+                        op_iter.op->GetName().c_str());
+      aicpu::dump::Output output;
+      SetDumpOutput(output_descs.at(i), output_addrs[i], output);
+      dump_op.task.mutable_output()->Add(std::move(output));
+      dump_op.output_sizes.push_back(output_addrs[i] == nullptr ? 0 : size);
+      dump_op.output_data_types.push_back(output_descs.at(i).GetDataType());
+    }
+    dump_ops.push_back(std::move(dump_op));
+  }
+
+  // The same layout as aicpu dump, which writes steps of a model to dump_path/model_name/model_id/
+  std::string dump_path = PropertiesManager::Instance().GetDumpOutputPath() + std::to_string(device_id_) + "/" +
+                          model_name_ + "/" + std::to_string(model_id_) + "/";
+  GE_CHK_STATUS_RET(async_dumper_.Init(dump_path, options, dump_ops), "Init async dump of %s failed.",
+                    model_name_.c_str());
+  GELOGI("LoadAsyncDumpInfo success, %zu ops.", dump_ops.size());
+  return SUCCESS;
+}
+
+Status DataDumper::DumpIteration(rtStream_t stream) { return async_dumper_.DumpIteration(iteration_++, stream); }
+
 Status DataDumper::UnloadDumpInfo() {
+  if (async_dumper_.IsInited()) {
+    async_dumper_.Finalize();
+    AsyncDumpStats stats;
+    async_dumper_.GetStats(stats);
+    GEEVENT("[GEPERFTRACE] Async dump of %s, sampled %lu, dropped %lu, written %lu, skipped %lu, bytes %lu, "
+            "enqueue time %lu us, write time %lu us.",
+            model_name_.c_str(), stats.sampled_count, stats.dropped_count, stats.written_count, stats.skipped_count,
+            stats.written_bytes, stats.enqueue_time_us, stats.write_time_us);
+  }
+
   if (!load_flag_) {
     GELOGI("No need to UnloadDumpInfo.");
     load_flag_ = false;
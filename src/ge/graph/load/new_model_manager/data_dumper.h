@@ -17,10 +17,12 @@
 #ifndef GE_GRAPH_LOAD_NEW_MODEL_MANAGER_DATA_DUMPER_H_
 #define GE_GRAPH_LOAD_NEW_MODEL_MANAGER_DATA_DUMPER_H_
 
+#include <atomic>
 #include <string>
 #include <memory>
 
 #include "framework/common/ge_inner_error_codes.h"
+#include "graph/load/new_model_manager/async_data_dumper.h"
 #include "graph/node.h"
 #include "task_info/task_info.h"
 
@@ -39,7 +41,8 @@ class DataDumper {
         device_id_(0),
         global_step_(0),
         loop_per_iter_(0),
-        loop_cond_(0) {}
+        loop_cond_(0),
+        iteration_(0) {}
 
   ~DataDumper();
 
@@ -52,11 +55,15 @@ class DataDumper {
   void SaveDumpInput(const std::shared_ptr<Node> &node);
   // args is device memory stored first output addr
   void SaveDumpTask(uint32_t task_id, const std::shared_ptr<OpDesc> &op_desc, uintptr_t args);
+  // Dump by aicpu, or on host if async dump is enabled
   Status LoadDumpInfo();
   Status UnloadDumpInfo();
+  // Queue copies of outputs to dump after an iteration is launched on stream, only for async dump
+  Status DumpIteration(rtStream_t stream);
 
  private:
   void ReleaseDevMem(void **ptr) noexcept;
+  Status LoadAsyncDumpInfo(const AsyncDumpOptions &options);
 
   std::string model_name_;
   uint32_t model_id_;
@@ -74,6 +81,9 @@ class DataDumper {
   uintptr_t global_step_;
   uintptr_t loop_per_iter_;
   uintptr_t loop_cond_;
+  // Counted by the executing threads of the model
+  std::atomic<uint64_t> iteration_;
+  AsyncDataDumper async_dumper_;
 };
 
 struct DataDumper::InnerDumpInfo {
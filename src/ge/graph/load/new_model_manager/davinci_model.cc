@@ -24,6 +24,7 @@
 #include <securec.h>
 #include <sys/prctl.h>
 #include <map>
+#include "common/build_tracer.h"
 #include "common/debug/log.h"
 #include "common/formats/formats.h"
 #include "common/formats/utils/formats_trans_utils.h"
@@ -39,9 +40,11 @@
 #include "graph/ge_context.h"
 #include "graph/graph.h"
 #include "graph/load/output/output.h"
+#include "graph/load/new_model_manager/shared_weight_store.h"
 #include "graph/load/new_model_manager/tbe_handle_store.h"
 #include "graph/manager/graph_mem_allocator.h"
 #include "graph/manager/graph_var_manager.h"
+#include "graph/manager/trans_var_data_utils.h"
 #include "graph/manager/util/debug.h"
 #include "graph/model_serialize.h"
 #include "graph/node.h"
@@ -192,73 +195,6 @@ Status CopyVarToDevice(const NodePtr &var, const formats::TransResult &trans_res
   return SUCCESS;
 }
 
-Status TransVarOnHost(uint8_t *var_data, const VarTransRoad &trans_road, formats::TransResult &result) {
-  formats::TransResult resultLastTime{};
-  bool use_init_data = true;
-  for (const auto &trans_info : trans_road) {
-    if (trans_info.node_type == RESHAPE || trans_info.node_type == REFORMAT) {
-      GELOGD("Skip to trans variable data on the reshape/reformat node");
-      continue;
-    }
-    uint8_t *src_data = nullptr;
-    if (use_init_data) {
-      src_data = var_data;
-      use_init_data = false;
-    } else {
-      src_data = resultLastTime.data.get();
-    }
-
-    formats::TransResult tmp_result{};
-    if (trans_info.node_type == TRANSDATA) {
-      auto src_format = trans_info.input.GetFormat();
-      auto src_shape = trans_info.input.GetShape().GetDims();
-      auto dst_format = trans_info.output.GetFormat();
-      auto dst_shape = trans_info.output.GetShape().GetDims();
-      auto data_type = trans_info.input.GetDataType();
-      GELOGD("Trans format from %s to %s, shape %s to %s, data-type %s",
-             TypeUtils::FormatToSerialString(src_format).c_str(), TypeUtils::FormatToSerialString(dst_format).c_str(),
-             formats::ShapeToString(src_shape).c_str(), formats::ShapeToString(dst_shape).c_str(),
-             TypeUtils::DataTypeToSerialString(data_type).c_str());
-      auto ret = formats::TransFormat({src_data, src_format, dst_format, src_shape, dst_shape, data_type}, tmp_result);
-      if (ret != SUCCESS) {
-        GELOGE(INTERNAL_ERROR,
-               "Failed to trans format from %s to %s, shape %s to %s, "
-               "data type %s error code %u",
-               TypeUtils::FormatToSerialString(src_format).c_str(), TypeUtils::FormatToSerialString(dst_format).c_str(),
-               formats::ShapeToString(src_shape).c_str(), formats::ShapeToString(dst_shape).c_str(),
-               TypeUtils::DataTypeToSerialString(data_type).c_str(), ret);
-        return ret;
-      }
-    } else if (trans_info.node_type == CAST) {
-      auto input_shape = trans_info.input.GetShape();
-      auto src_data_size = input_shape.GetShapeSize();
-      auto src_data_type = trans_info.input.GetDataType();
-      auto dst_data_type = trans_info.output.GetDataType();
-      GELOGD("Trans data type from %s to %s, input shape %s, data size %ld",
-             TypeUtils::DataTypeToSerialString(src_data_type).c_str(),
-             TypeUtils::DataTypeToSerialString(dst_data_type).c_str(), formats::ShapeToString(input_shape).c_str(),
-             src_data_size);
-      auto ret = formats::TransDataType({src_data, static_cast<size_t>(src_data_size), src_data_type, dst_data_type},
-                                        tmp_result);
-      if (ret != SUCCESS) {
-        GELOGE(INTERNAL_ERROR, "Failed to trans data type from %s to %s, input shape %s, data size %ld, error code %u",
-               TypeUtils::DataTypeToSerialString(src_data_type).c_str(),
-               TypeUtils::DataTypeToSerialString(dst_data_type).c_str(), formats::ShapeToString(input_shape).c_str(),
-               src_data_size, ret);
-        return ret;
-      }
-    } else {
-      GELOGE(UNSUPPORTED, "Failed to trans var data, the trans type %s does not supported",
-             trans_info.node_type.c_str());
-      return UNSUPPORTED;
-    }
-    resultLastTime = tmp_result;
-  }
-
-  result = resultLastTime;
-  return SUCCESS;
-}
-
 ///
 /// re-alloc var memory on device using var-manager
 /// free origin var memory(var manager does not support now)
@@ -290,61 +226,6 @@ Status ReAssignVarAddr(uint64_t session_id, const std::string &var_name, const G
   return SUCCESS;
 }
 
-Status TransVarData(const NodePtr &var, const VarTransRoad &trans_road, uint64_t session_id, uint32_t device_id) {
-  // do not need to do anything if only all reshape/reformat node on the trans_road
-  GE_CHECK_NOTNULL(var);
-  bool need_trans = false;
-  if (std::any_of(trans_road.begin(), trans_road.end(), [](const ge::TransNodeInfo &road) {
-        return road.node_type != RESHAPE && road.node_type != REFORMAT;
-      })) {
-    need_trans = true;
-  }
-
-  if (!need_trans) {
-    return SUCCESS;
-  }
-
-  // Sync var data from device
-  std::unique_ptr<uint8_t[]> var_data;
-  if (trans_road.size() == 0) {
-    GELOGE(INTERNAL_ERROR, "Failed to get trans_road, trans_road is empty.");
-    return INTERNAL_ERROR;
-  }
-  const GeTensorDesc &input_desc = trans_road.begin()->input;
-  auto ret = CopyVarFromDevice(session_id, var, var_data, input_desc);
-  if (ret != SUCCESS) {
-    return ret;
-  }
-
-  formats::TransResult trans_result{};
-  ret = TransVarOnHost(var_data.get(), trans_road, trans_result);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "Failed to trans var data on host, error code %u", ret);
-    return ret;
-  }
-
-  void *var_device = nullptr;
-  ///
-  /// It is a temporary solution to use the last GeTensorDesc to assign variable memory because the variable manager
-  /// depends on TensorDesc and it is difficult to be modified. The correct solution is to assign memory based on the
-  /// size of the converted variable. To complete the final solution, the dependency of the variable manager on
-  /// TensorDesc needs to be removed. This change is large and needs to be performed step by step.
-  ///
-  ret = ReAssignVarAddr(session_id, var->GetName(), trans_road.rbegin()->output, &var_device);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "Failed to re-assign memory on device, size %zu", trans_result.length);
-    return ret;
-  }
-
-  // sync new data to device
-  ret = CopyVarToDevice(var, trans_result, var_device);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "Failed to send var data to device");
-    return ret;
-  }
-
-  return SUCCESS;
-}
 }  // namespace
 
 std::mutex DavinciModel::tvm_bin_mutex_;
@@ -356,6 +237,7 @@ DavinciModel::DavinciModel(int32_t priority, const std::shared_ptr<ModelListener
       mem_base_(nullptr),
       is_inner_mem_base_(false),
       is_inner_weight_base_(false),
+      is_shared_weight_(false),
       data_inputer_(nullptr),
       dataInputTid(0),
       is_model_has_inited_(false),
@@ -499,15 +381,28 @@ Status DavinciModel::InitModelMem(void *dev_ptr, size_t memsize, void *weight_pt
   if (weights_size != 0) {
     weights_mem_base_ = static_cast<uint8_t *>(weight_ptr);
     is_inner_weight_base_ = false;
-    if (weight_ptr == nullptr) {
-      weights_mem_base_ = MallocWeightsMem(weights_size);
-      if (weights_mem_base_ == nullptr) {
-        return FAILED;
+    if ((weight_ptr == nullptr) && IsWeightsSharable()) {
+      weight_digest_ = ContentHash::Digest(weights_addr, weights_size);
+      SharedWeightStore &weight_store = SharedWeightStore::GetInstance();
+      GE_CHK_STATUS_RET(weight_store.Acquire(GetDeviceId(), weight_digest_, weights_addr, weights_mem_base_),
+                        "Acquire shared weights of size %zu failed.", weights_size);
+      is_shared_weight_ = (weights_mem_base_ != nullptr);
+      if (is_shared_weight_) {
+        GEEVENT("[GEPERFTRACE] Weights of size %zu are shared, %lu bytes deduplicated in total.", weights_size,
+                weight_store.GetDedupBytes());
+      }
+    }
+    if (!is_shared_weight_) {
+      if (weight_ptr == nullptr) {
+        weights_mem_base_ = MallocWeightsMem(weights_size);
+        if (weights_mem_base_ == nullptr) {
+          return FAILED;
+        }
+        is_inner_weight_base_ = true;
       }
-      is_inner_weight_base_ = true;
+      GE_CHK_RT_RET(rtMemcpy(weights_mem_base_, weights_size, weights_addr, weights_size, RT_MEMCPY_HOST_TO_DEVICE))
+      GELOGI("copy weights data to device");
     }
-    GE_CHK_RT_RET(rtMemcpy(weights_mem_base_, weights_size, weights_addr, weights_size, RT_MEMCPY_HOST_TO_DEVICE))
-    GELOGI("copy weights data to device");
   }
 
   var_mem_base_ = VarManager::Instance(session_id_)->GetVarMemoryBase(RT_MEMORY_HBM);
@@ -661,6 +556,8 @@ Status DavinciModel::Init(void *dev_ptr, size_t memsize, void *weight_ptr, size_
   GE_TIMESTAMP_START(InitModelMem);
   GE_CHK_STATUS_RET_NOLOG(InitModelMem(dev_ptr, memsize, weight_ptr, weight_size));
   GE_TIMESTAMP_END(InitModelMem, "GraphLoader::InitModelMem");
+  GE_TRACE_COUNTER("model_mem_bytes", static_cast<int64_t>(runtime_param_.mem_size));
+  GE_TRACE_COUNTER("model_weight_bytes", static_cast<int64_t>(runtime_param_.weight_size));
 
   data_inputer_ = new (std::nothrow) DataInputer();
   GE_CHK_BOOL_RET_STATUS(data_inputer_ != nullptr, INTERNAL_ERROR, "data_inputer_ is nullptr!");
@@ -675,7 +572,6 @@ Status DavinciModel::Init(void *dev_ptr, size_t memsize, void *weight_ptr, size_
   op_name_map_ = compute_graph->GetGraphOpName();
 
   GE_TIMESTAMP_CALLNUM_START(LoadTBEKernelBinToOpDesc);
-  GE_TIMESTAMP_CALLNUM_START(InitTbeHandle);
 
   vector<string> op_name;
   GE_IF_BOOL_EXEC(ge::AttrUtils::GetListStr(ge_model_, ATTR_MODEL_TASK_INDEX_OP_NAME, op_name),
@@ -689,6 +585,7 @@ Status DavinciModel::Init(void *dev_ptr, size_t memsize, void *weight_ptr, size_
 
   auto nodes = compute_graph->GetAllNodes();
   tbekernel_store_ = ge_model_->GetTBEKernelStore();
+  vector<OpDescPtr> tvm_op_descs;
   for (size_t i = 0; i < nodes.size(); i++) {
     auto node = nodes.at(i);
     GE_CHK_BOOL_RET_STATUS(node != nullptr, PARAM_INVALID, "CreateOp failed.");
@@ -725,18 +622,19 @@ Status DavinciModel::Init(void *dev_ptr, size_t memsize, void *weight_ptr, size_
     GE_IF_BOOL_EXEC(op_desc->GetType() == CONSTANTOP,
                     GE_CHK_STATUS_RET(InitConstant(op_desc), "Constant init failed. %s", op_desc->GetName().c_str()););
 
-    GE_TIMESTAMP_RESTART(InitTbeHandle);
     uint32_t run_mode = static_cast<uint32_t>(domi::ImplyType::INVALID);
     GE_IF_BOOL_EXEC((AttrUtils::GetInt(op_desc, ATTR_NAME_IMPLY_TYPE, run_mode) &&
                      run_mode == static_cast<uint32_t>(domi::ImplyType::TVM)),
-                    GE_CHK_STATUS_RET(InitTbeHandle(op_desc), "TBE init failed. %s", op_desc->GetName().c_str()););
-    GE_TIMESTAMP_ADD(InitTbeHandle);
+                    tvm_op_descs.push_back(op_desc));
 
     GE_CHK_STATUS_RET(MarkActiveStream(op_desc), "MarkActiveStream failed, node:%s, opIndex:%zu",
                       op_desc->GetName().c_str(), i);
   }
   GE_TIMESTAMP_CALLNUM_END(LoadTBEKernelBinToOpDesc, "GraphLoader::LoadTBEKernelBinToOpDesc");
-  GE_TIMESTAMP_CALLNUM_END(InitTbeHandle, "GraphLoader::InitTbeHandle");
+
+  GE_TIMESTAMP_START(InitTbeHandles);
+  GE_CHK_STATUS_RET(InitTbeHandles(tvm_op_descs), "TBE init failed.");
+  GE_TIMESTAMP_END(InitTbeHandles, "GraphLoader::InitTbeHandles");
 
   SetDataDumperArgs();
 
@@ -1494,13 +1392,14 @@ void *DavinciModel::Run(DavinciModel *model) {
           (void)ProfilingManager::Instance().StartProfiling(i);  // just profiling, no need to check value
         }
         // collect profiling for ge
-        ProfilingManager::Instance().ReportProfilingData(model->GetTaskIdOpName());
+        ProfilingManager::Instance().ReportProfilingData(model->GetProfTaskRecords());
         GELOGI("rtModelExecute start.");
         rtError_t rt_ret = rtModelExecute(model->rt_model_handle_, model->rt_model_stream_, 0);
         GE_IF_BOOL_EXEC(rt_ret != RT_ERROR_NONE, rslt_flg = false; (void)model->ReturnResult(
           model->model_id_, current_data.index, false, false, data_wrapper->GetOutput());
                         continue);  // [No need to check value]
         GELOGI("rtModelExecute end");
+        GE_CHK_STATUS(model->data_dumper_.DumpIteration(model->rt_model_stream_), "Dump iteration failed.");
 
         GELOGI("rtStreamSynchronize start.");
         rt_ret = rtStreamSynchronize(model->rt_model_stream_);
@@ -1520,6 +1419,8 @@ void *DavinciModel::Run(DavinciModel *model) {
         CsaInteract::GetInstance().WriteErrorCode(rt_ret, ERROR_MODULE_RUNTIME, JOBSUBSTATE_GRAPH_EXEC); continue);
       GELOGI("rtModelExecute end");
       GE_TIMESTAMP_END(rtModelExecute, "GraphExcute::rtModelExecute");
+      // Outputs to dump are copied behind the iteration on its stream, and written in background
+      GE_CHK_STATUS(model->data_dumper_.DumpIteration(model->rt_model_stream_), "Dump iteration failed.");
 
       GE_TIMESTAMP_START(rtStreamSynchronize);
       GELOGI("rtStreamSynchronize start.");
@@ -1538,7 +1439,7 @@ void *DavinciModel::Run(DavinciModel *model) {
 
       // collect profiling for ge
       if (ProfilingManager::Instance().ProfilingOn()) {
-        ProfilingManager::Instance().ReportProfilingData(model->GetTaskIdOpName());
+        ProfilingManager::Instance().ReportProfilingData(model->GetProfTaskRecords());
       }
     }
 
@@ -1750,6 +1651,18 @@ Status DavinciModel::DistributeTask() {
     }
   }
 
+  // Names are interned once here, so only fixed size records are reported after each run
+  prof_task_records_.clear();
+  uint32_t model_name_id = ProfilingManager::Instance().InternProfilingName(name_);
+  for (const auto &op_task : op_task_id_map_) {
+    ProfEventRecord record;
+    record.model_id = model_id_;
+    record.model_name_id = model_name_id;
+    record.op_name_id = ProfilingManager::Instance().InternProfilingName(op_task.second);
+    record.task_id = op_task.first;
+    prof_task_records_.push_back(record);
+  }
+
   // launch dump kernel to aicpu
   ret = data_dumper_.LoadDumpInfo();
   if (ret != SUCCESS) {
@@ -2033,26 +1946,48 @@ Status DavinciModel::InitConstant(const ConstOpDescPtr &op_desc) const {
 
 ///
 /// @ingroup domi_ome
-/// @brief TVM Op Init.
+/// @brief TVM Ops Init.
 /// @return Status
 ///
+Status DavinciModel::InitTbeHandles(const std::vector<OpDescPtr> &op_descs) {
+  std::vector<std::pair<std::string, TBEKernelPtr>> kernels;
+  std::vector<const char *> bin_file_keys;
+  for (const auto &op_desc : op_descs) {
+    TBEKernelPtr tbe_kernel = op_desc->TryGetExtAttr(OP_EXTATTR_NAME_TBE_KERNEL, TBEKernelPtr());
+    if (tbe_kernel == nullptr) {
+      GELOGE(INTERNAL_ERROR, "TBE: %s can't find tvm bin file!", op_desc->GetName().c_str());
+      return INTERNAL_ERROR;
+    }
 
-Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc) {
-  TBEKernelPtr tbe_kernel = op_desc->TryGetExtAttr(OP_EXTATTR_NAME_TBE_KERNEL, TBEKernelPtr());
-  if (tbe_kernel == nullptr) {
-    GELOGE(INTERNAL_ERROR, "TBE: %s can't find tvm bin file!", op_desc->GetName().c_str());
-    return INTERNAL_ERROR;
+    std::string session_graph_model_id;
+    GetUniqueId(op_desc, session_graph_model_id);
+    const char *bin_file_key = GetRegisterStub(op_desc->GetName(), session_graph_model_id);  // from set, always valid.
+    kernels.emplace_back(bin_file_key, tbe_kernel);
+    bin_file_keys.push_back(bin_file_key);
   }
 
-  std::string session_graph_model_id;
-  GetUniqueId(op_desc, session_graph_model_id);
-  const char *bin_file_key = GetRegisterStub(op_desc->GetName(), session_graph_model_id);  // from set, always valid.
-  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  // Ops sharing a kernel with other models are serialized by the store, others are registered without waiting
+  auto prepare = [this, &op_descs, &bin_file_keys](size_t index, void *&bin_handle) -> Status {
+    Status ret = InitTbeHandle(op_descs[index], bin_file_keys[index], bin_handle);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "TBE init failed. %s", op_descs[index]->GetName().c_str());
+    }
+    return ret;
+  };
+  Status ret = TBEHandleStore::GetInstance().ReferTBEHandles(kernels, prepare);
+  GELOGI("TBE: %zu kernels of model %u are initialized.", kernels.size(), model_id_);
+  return ret;
+}
 
-  std::lock_guard<std::mutex> lock(tvm_bin_mutex_);
+///
+/// @ingroup domi_ome
+/// @brief TVM Op Init.
+/// @return Status
+///
+Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc, const char *bin_file_key, void *&bin_handle) {
   if (rtQueryFunctionRegistered(bin_file_key) != RT_ERROR_NONE) {
-    void *bin_handle = nullptr;
-    if (!kernel_store.FindTBEHandle(bin_file_key, bin_handle)) {
+    bool new_handle = (bin_handle == nullptr);
+    if (new_handle) {
       GELOGI("TBE: can't find the kernel_name[%s] in HandleMap", bin_file_key);
 
       rtDevBinary_t binary;
@@ -2068,6 +2003,8 @@ Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc) {
         return PARAM_INVALID;
       }
 
+      TBEKernelPtr tbe_kernel = op_desc->TryGetExtAttr(OP_EXTATTR_NAME_TBE_KERNEL, TBEKernelPtr());
+      GE_CHECK_NOTNULL(tbe_kernel);
       binary.version = 0;
       binary.data = tbe_kernel->GetBinData();
       binary.length = tbe_kernel->GetBinDataSize();
@@ -2079,53 +2016,51 @@ Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc) {
       GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_METADATA, meta_data),
                       GELOGI("Get original type of json_string"));
       GELOGI("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
-      GE_IF_BOOL_EXEC(!meta_data.empty(), GE_CHK_RT_RET(rtMetadataRegister(bin_handle, meta_data.c_str())));
-
-      kernel_store.StoreTBEHandle(bin_file_key, bin_handle, tbe_kernel);
+      if (!meta_data.empty()) {
+        rtError_t rt_ret = rtMetadataRegister(bin_handle, meta_data.c_str());
+        if (rt_ret != RT_ERROR_NONE) {
+          GELOGE(RT_FAILED, "TBE: rtMetadataRegister failed, kernel_name[%s], ret: 0x%X", bin_file_key, rt_ret);
+          GE_CHK_RT(rtDevBinaryUnRegister(bin_handle));
+          bin_handle = nullptr;
+          return RT_FAILED;
+        }
+      }
     } else {
       GELOGI("TBE: find the kernel_name[%s] in HandleMap", bin_file_key);
-      kernel_store.ReferTBEHandle(bin_file_key);
     }
 
     std::string kernel_name;
     GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, op_desc->GetName() + "_kernelname", kernel_name),
                     GELOGI("Get original type of kernel_name"));
     GELOGI("TBE: binfile_key=%s, kernel_name=%s", bin_file_key, kernel_name.c_str());
-    GE_CHK_RT_RET(rtFunctionRegister(bin_handle, bin_file_key, bin_file_key, kernel_name.c_str(), 0));
+    rtError_t rt_ret = rtFunctionRegister(bin_handle, bin_file_key, bin_file_key, kernel_name.c_str(), 0);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "TBE: rtFunctionRegister failed, kernel_name[%s], ret: 0x%X", bin_file_key, rt_ret);
+      if (new_handle) {
+        GE_CHK_RT(rtDevBinaryUnRegister(bin_handle));
+      }
+      bin_handle = nullptr;
+      return RT_FAILED;
+    }
     used_tbe_handle_map_[bin_file_key] = 1;  // Init used num to 1.
     return SUCCESS;
   }
 
-  // Kernel registed, Increase used num in store.
-  StoreTbeHandle(bin_file_key);
-  return SUCCESS;
-}
-
-void DavinciModel::StoreTbeHandle(const std::string &handle_key) {
-  // Online mode FE may call rtFunctionRegister.
-  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
-
-  // Need protection of tvm_bin_mutex_.
-  auto it = used_tbe_handle_map_.find(handle_key);
-  if (it != used_tbe_handle_map_.end()) {
-    // GE registered, increase reference.
-    kernel_store.ReferTBEHandle(handle_key);
-    it->second++;
-    return;
-  }
-
-  void *bin_handle = nullptr;
-  if (kernel_store.FindTBEHandle(handle_key, bin_handle)) {
-    // GE registered, increase reference.
-    used_tbe_handle_map_[handle_key] = 1;  // Init used num to 1.
-    kernel_store.ReferTBEHandle(handle_key);
+  // Online mode FE may call rtFunctionRegister, kernel registered by GE is referred by the store.
+  if (bin_handle != nullptr) {
+    auto it = used_tbe_handle_map_.find(bin_file_key);
+    if (it != used_tbe_handle_map_.end()) {
+      it->second++;
+    } else {
+      used_tbe_handle_map_[bin_file_key] = 1;  // Init used num to 1.
+    }
   }
+  return SUCCESS;
 }
 
 void DavinciModel::CleanTbeHandle() {
   TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
 
-  std::lock_guard<std::mutex> lock(tvm_bin_mutex_);
   kernel_store.EraseTBEHandle(used_tbe_handle_map_);
   used_tbe_handle_map_.clear();
 }
@@ -2215,6 +2150,12 @@ Status DavinciModel::InitModelStream(rtStream_t stream, bool async_mode) {
   return SUCCESS;
 }
 
+void DavinciModel::ResetModelStream(rtStream_t stream) {
+  if ((rt_model_stream_ == stream) && !is_inner_model_stream_) {
+    rt_model_stream_ = nullptr;
+  }
+}
+
 ///
 /// @ingroup domi_ome
 /// @brief ACL case, do not start  new thread, return execute result.
@@ -2239,6 +2180,7 @@ Status DavinciModel::NnExecute(rtStream_t stream, bool async_mode, const InputDa
   rtError_t rt_ret = rtModelExecute(rt_model_handle_, rt_model_stream_, 0);
   GE_CHK_RT_EXEC(rt_ret, return INTERNAL_ERROR);
   GELOGI("rtModelExecute end");
+  GE_CHK_STATUS(data_dumper_.DumpIteration(rt_model_stream_), "Dump iteration failed.");
 
   if (async_mode) {
     rt_ret = rtStreamSynchronize(rt_model_stream_);
@@ -2250,7 +2192,7 @@ Status DavinciModel::NnExecute(rtStream_t stream, bool async_mode, const InputDa
 
   // collect profiling for ge
   if (ProfilingManager::Instance().ProfilingOn()) {
-    ProfilingManager::Instance().ReportProfilingData(op_task_id_map_);
+    ProfilingManager::Instance().ReportProfilingData(prof_task_records_);
     GELOGI("Acl Profiling Op name taskId report.");
   }
 
@@ -2287,6 +2229,31 @@ uint8_t *DavinciModel::MallocWeightsMem(uint32_t weights_size) {
   return weights_mem_base;
 }
 
+bool DavinciModel::IsWeightsSharable() const {
+  // static memory is keyed by model, it can not be shared
+  if (std::getenv(kEnvGeuseStaticMemory) != nullptr) {
+    return false;
+  }
+  auto compute_graph = GraphUtils::GetComputeGraph(ge_model_->GetGraph());
+  if (compute_graph == nullptr) {
+    return false;
+  }
+  for (const NodePtr &node : compute_graph->GetAllNodes()) {
+    bool is_ref = false;
+    (void)AttrUtils::GetBool(node->GetOpDesc(), ATTR_NAME_REFERENCE, is_ref);
+    if (!is_ref) {
+      continue;
+    }
+    for (const NodePtr &in_node : node->GetInDataNodes()) {
+      if ((in_node->GetType() == CONSTANT) || (in_node->GetType() == CONSTANTOP)) {
+        GELOGI("Weights are written by reference node %s, they are not shared.", node->GetName().c_str());
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void DavinciModel::FreeFeatureMapMem() {
   if (std::getenv(kEnvGeuseStaticMemory) != nullptr) {
     string weight_memory_key = std::to_string(0) + "_f";
@@ -2304,6 +2271,13 @@ void DavinciModel::FreeFeatureMapMem() {
 }
 
 void DavinciModel::FreeWeightsMem() {
+  if (is_shared_weight_) {
+    GE_CHK_STATUS(SharedWeightStore::GetInstance().Release(GetDeviceId(), weight_digest_),
+                  "failed to release shared weight memory");
+    is_shared_weight_ = false;
+    weights_mem_base_ = nullptr;
+    return;
+  }
   if (std::getenv(kEnvGeuseStaticMemory) != nullptr) {
     string memory_key = std::to_string(0) + "_w";
     if (MemManager::Instance(RT_MEMORY_HBM)->GetMemoryAddr(memory_key) != nullptr) {
@@ -2333,16 +2307,7 @@ uint32_t DavinciModel::GetGraphID(const std::string &session_graph_id) {
 Status DavinciModel::TransAllVarData(ComputeGraphPtr &graph, uint32_t graph_id) {
   GELOGI("TransAllVarData start: session_id:%lu, graph_id: %u.", session_id_, graph_id);
 
-  ThreadPool executor(THREAD_NUM);
-  std::vector<std::future<Status>> vector_future;
-
-  rtContext_t ctx = nullptr;
-  rtError_t rt_ret = rtCtxGetCurrent(&ctx);
-  if (rt_ret != RT_ERROR_NONE) {
-    GELOGE(RT_FAILED, "Failed to get current context, error_code is: 0x%X.", rt_ret);
-    return RT_FAILED;
-  }
-
+  std::vector<VarTransTask> tasks;
   for (ge::NodePtr &node : graph->GetDirectNode()) {
     if (node == nullptr) {
       continue;
@@ -2350,62 +2315,70 @@ Status DavinciModel::TransAllVarData(ComputeGraphPtr &graph, uint32_t graph_id)
     if (node->GetType() != VARIABLE) {
       continue;
     }
-    std::future<Status> f = executor.commit(
-      [](ge::NodePtr &node, DavinciModel *model, rtContext_t ctx, uint32_t graph_id) -> Status {
-        if (model == nullptr) {
-          GELOGE(FAILED, "DavinciModel is NULL!");
-          return FAILED;
-        }
-        rtError_t rt_ret = rtCtxSetCurrent(ctx);
-        if (rt_ret != RT_ERROR_NONE) {
-          GELOGE(RT_FAILED, "Failed to set context, error_code is: 0x%X.", rt_ret);
-          return RT_FAILED;
-        }
-        uint32_t allocated_graph_id = 0;
-        Status ret = VarManager::Instance(model->session_id_)->GetAllocatedGraphId(node->GetName(), allocated_graph_id);
-        if (ret != SUCCESS) {
-          GELOGE(INTERNAL_ERROR, "var has not been allocated, node:%s, graph_id:%u.", node->GetName().c_str(),
-                 graph_id);
-          return INTERNAL_ERROR;
-        }
-        uint32_t changed_graph_id = 0;
-        ret = VarManager::Instance(model->session_id_)->GetChangedGraphId(node->GetName(), changed_graph_id);
-        bool call_trans_var =
-          (ret == SUCCESS && changed_graph_id == graph_id && changed_graph_id != allocated_graph_id);
-        if (call_trans_var) {
-          GELOGI("VarManager::GetChangedGraphId() success, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
-          VarTransRoad *trans_road = VarManager::Instance(model->session_id_)->GetTransRoad(node->GetName());
-          if (trans_road == nullptr) {
-            GELOGI("The variable %s does not have any trans road", node->GetName().c_str());
-            return SUCCESS;
-          }
-          ret = TransVarData(node, *trans_road, model->session_id_, model->device_id_);
-          if (ret != SUCCESS) {
-            GELOGE(INTERNAL_ERROR, "TransVarData failed, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
-            return INTERNAL_ERROR;
-          }
-          VarManager::Instance(model->session_id_)->RemoveChangedGraphId(node->GetName());
-        }
-        return SUCCESS;
-      },
-      node, this, ctx, graph_id);
-    if (!f.valid()) {
-      GELOGE(FAILED, "Future is invalid");
-      return FAILED;
+    uint32_t allocated_graph_id = 0;
+    Status ret = VarManager::Instance(session_id_)->GetAllocatedGraphId(node->GetName(), allocated_graph_id);
+    if (ret != SUCCESS) {
+      GELOGE(INTERNAL_ERROR, "var has not been allocated, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
+      return INTERNAL_ERROR;
     }
-    vector_future.push_back(std::move(f));
-  }
-
-  Status ret_status;
-  for (size_t i = 0; i < vector_future.size(); ++i) {
-    ret_status = vector_future[i].get();
-    if (ret_status != SUCCESS) {
-      GELOGE(ret_status, "TransAllVarData:: trans %zu vardata failed", i);
-      return ret_status;
+    uint32_t changed_graph_id = 0;
+    ret = VarManager::Instance(session_id_)->GetChangedGraphId(node->GetName(), changed_graph_id);
+    bool call_trans_var = (ret == SUCCESS && changed_graph_id == graph_id && changed_graph_id != allocated_graph_id);
+    if (!call_trans_var) {
+      continue;
+    }
+    GELOGI("VarManager::GetChangedGraphId() success, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
+    VarTransRoad *trans_road = VarManager::Instance(session_id_)->GetTransRoad(node->GetName());
+    if (trans_road == nullptr) {
+      GELOGI("The variable %s does not have any trans road", node->GetName().c_str());
+      continue;
+    }
+    // do not need to do anything if only all reshape/reformat node on the trans_road
+    bool need_trans = std::any_of(trans_road->begin(), trans_road->end(), [](const ge::TransNodeInfo &road) {
+      return road.node_type != RESHAPE && road.node_type != REFORMAT;
+    });
+    if (!need_trans) {
+      VarManager::Instance(session_id_)->RemoveChangedGraphId(node->GetName());
+      continue;
     }
-  }
 
-  GELOGI("TransAllVarData success.");
+    VarTransTask task;
+    task.var_name = node->GetName();
+    task.trans_road = trans_road;
+    void *src_addr = nullptr;
+    void *dst_addr = nullptr;
+    int src_size = CalcVarSizeInBytes(trans_road->begin()->input);
+    int dst_size = CalcVarSizeInBytes(trans_road->rbegin()->output);
+    if (src_size <= 0 || dst_size <= 0) {
+      GELOGE(INTERNAL_ERROR, "Invalid size of var %s, src size %d, dst size %d.", task.var_name.c_str(), src_size,
+             dst_size);
+      return INTERNAL_ERROR;
+    }
+    GE_CHK_STATUS_RET(ReAssignVarAddr(session_id_, task.var_name, trans_road->begin()->input, &src_addr),
+                      "Failed to get device addr of var %s.", task.var_name.c_str());
+    ///
+    /// It is a temporary solution to use the last GeTensorDesc to assign variable memory because the variable manager
+    /// depends on TensorDesc and it is difficult to be modified. The correct solution is to assign memory based on the
+    /// size of the converted variable. To complete the final solution, the dependency of the variable manager on
+    /// TensorDesc needs to be removed. This change is large and needs to be performed step by step.
+    ///
+    GE_CHK_STATUS_RET(ReAssignVarAddr(session_id_, task.var_name, trans_road->rbegin()->output, &dst_addr),
+                      "Failed to re-assign memory of var %s on device.", task.var_name.c_str());
+    task.src_addr = reinterpret_cast<uint8_t *>(src_addr);
+    task.src_size = static_cast<uint64_t>(src_size);
+    task.dst_addr = reinterpret_cast<uint8_t *>(dst_addr);
+    task.dst_size = static_cast<uint64_t>(dst_size);
+    tasks.push_back(task);
+  }
+
+  // Variables are copied in batches on this thread, and transformed on host by other threads
+  VarTransStats stats;
+  GE_CHK_STATUS_RET(TransVarDataUtils::TransVarDataBatch(tasks, THREAD_NUM, stats), "TransAllVarData failed.");
+  for (const auto &task : tasks) {
+    VarManager::Instance(session_id_)->RemoveChangedGraphId(task.var_name);
+  }
+
+  GELOGI("TransAllVarData success, %zu vars transformed.", tasks.size());
 
   return SUCCESS;
 }
@@ -24,6 +24,8 @@
 #include <thread>
 #include <vector>
 
+#include "common/ge/content_hash.h"
+#include "common/profiling/profiling_event_buffer.h"
 #include "common/ge_types.h"
 #include "common/types.h"
 #include "graph/load/new_model_manager/data_inputer.h"
@@ -225,6 +227,9 @@ class DavinciModel {
   // get taskid to op name
   const map<uint32_t, std::string> &GetTaskIdOpName() const { return op_task_id_map_; }
 
+  // get profiling records of tasks with interned names
+  const std::vector<ProfEventRecord> &GetProfTaskRecords() const { return prof_task_records_; }
+
   // get updated task info list
   std::vector<TaskInfoPtr> GetTaskList() { return task_list_; }
 
@@ -240,6 +245,12 @@ class DavinciModel {
     return res;
   }
 
+  // Stream the model was executed on last, which is the inner stream when executed with null stream
+  rtStream_t GetRtModelStream() const { return rt_model_stream_; }
+
+  // Forget the stream given by caller before it is destroyed, so that the next run does not use it
+  void ResetModelStream(rtStream_t stream);
+
   uint64_t GetRtBaseAddr() const { return runtime_param_.logic_mem_base; }
 
   uint64_t GetRtWeightAddr() const { return runtime_param_.logic_weight_base; }
@@ -417,6 +428,9 @@ class DavinciModel {
   uint8_t *mem_base_;
   bool is_inner_mem_base_;
   bool is_inner_weight_base_;
+  // weights memory is shared with other models through SharedWeightStore
+  bool is_shared_weight_;
+  ContentDigest weight_digest_;
   // input data manager
   DataInputer *data_inputer_;
 
@@ -464,6 +478,13 @@ class DavinciModel {
 
   uint8_t *MallocWeightsMem(uint32_t weights_size);
 
+  ///
+  /// @ingroup ge
+  /// @brief Weights can be shared with other models only if no op writes them in place.
+  /// @return true: sharable / false: not sharable.
+  ///
+  bool IsWeightsSharable() const;
+
   void FreeFeatureMapMem();
 
   void FreeWeightsMem();
@@ -481,12 +502,18 @@ class DavinciModel {
 
   ///
   /// @ingroup domi_ome
-  /// @brief TVM Op Init.
+  /// @brief TVM Ops Init, kernel bins of all ops are registered in one pass of TBEHandleStore.
+  /// @return Status
+  ///
+  Status InitTbeHandles(const std::vector<OpDescPtr> &op_descs);
+
+  ///
+  /// @ingroup domi_ome
+  /// @brief TVM Op Init, called by TBEHandleStore with the handle stored for bin_file_key or nullptr.
   /// @return Status
   ///
-  Status InitTbeHandle(const OpDescPtr &op_desc);
+  Status InitTbeHandle(const OpDescPtr &op_desc, const char *bin_file_key, void *&bin_handle);
 
-  void StoreTbeHandle(const std::string &handle_key);
   void CleanTbeHandle();
 
   ///
@@ -599,7 +626,7 @@ class DavinciModel {
   RuntimeParam runtime_param_;
   TBEKernelStore tbekernel_store_;
 
-  static std::mutex tvm_bin_mutex_;  // lock for tvm maps.
+  static std::mutex tvm_bin_mutex_;  // lock for tvm_bin_kernel_.
   static std::set<std::string> tvm_bin_kernel_;
 
   std::map<std::string, uint32_t> used_tbe_handle_map_;
@@ -607,6 +634,7 @@ class DavinciModel {
   // for profiling
   std::map<uint32_t, std::string> op_name_map_;
   std::map<uint32_t, std::string> op_task_id_map_;
+  std::vector<ProfEventRecord> prof_task_records_;
 
   int64_t maxDumpOpNum_;
   // for data dump
@@ -0,0 +1,337 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/load/new_model_manager/dynamic_batcher.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+#include "runtime/mem.h"
+
+namespace ge {
+namespace {
+// Number of recent requests whose latencies are kept for statistics
+const size_t kLatencyWindow = 10000;
+const double kTailLatencyRatio = 0.99;
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(uint32_t model_id, const DynamicBatchOptions &options, Dispatcher dispatcher)
+    : model_id_(model_id), options_(options), dispatcher_(std::move(dispatcher)) {}
+
+DynamicBatcher::~DynamicBatcher() { Finalize(); }
+
+Status DynamicBatcher::Init() {
+  GE_CHK_BOOL_RET_STATUS(dispatcher_ != nullptr, PARAM_INVALID, "Dispatcher of model %u is null.", model_id_);
+  std::vector<uint32_t> &batch_sizes = options_.batch_sizes;
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  batch_sizes.erase(std::unique(batch_sizes.begin(), batch_sizes.end()), batch_sizes.end());
+  GE_CHK_BOOL_RET_STATUS(!batch_sizes.empty() && batch_sizes.front() > 0, PARAM_INVALID,
+                         "Batch sizes of model %u are invalid.", model_id_);
+  max_batch_size_ = batch_sizes.back();
+
+  if (options_.has_batch_shape_input) {
+    for (uint32_t batch_size : batch_sizes) {
+      void *buffer = nullptr;
+      GE_CHK_RT_RET(rtMalloc(&buffer, sizeof(int64_t), RT_MEMORY_HBM));
+      batch_shape_buffers_.emplace_back(batch_size, buffer);
+      int64_t batch_dim = batch_size;
+      GE_CHK_RT_RET(rtMemcpy(buffer, sizeof(int64_t), &batch_dim, sizeof(int64_t), RT_MEMCPY_HOST_TO_DEVICE));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_stopped_ = false;
+  thread_ = std::thread(&DynamicBatcher::Run, this);
+  GELOGI("Dynamic batcher of model %u starts, max batch size %u, max delay %lu us.", model_id_, max_batch_size_,
+         options_.max_delay_us);
+  return SUCCESS;
+}
+
+void DynamicBatcher::Finalize() {
+  if (IsDispatchThread()) {
+    GELOGE(FAILED, "Dynamic batcher of model %u can not be finalized in its dispatching thread.", model_id_);
+    return;
+  }
+  std::deque<Request> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+    pending.swap(requests_);
+  }
+  cond_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  if (!pending.empty()) {
+    GELOGW("%zu requests of model %u are dropped as dynamic batcher stops.", pending.size(), model_id_);
+  }
+  for (auto &request : pending) {
+    request.done(FAILED);
+  }
+  FreeBuffers();
+}
+
+Status DynamicBatcher::Submit(const std::vector<DataBuffer> &inputs, const std::vector<DataBuffer> &outputs,
+                              DoneCallback done) {
+  GE_CHK_BOOL_RET_STATUS(done != nullptr, PARAM_INVALID, "Callback of request to model %u is null.", model_id_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    GE_CHK_BOOL_RET_STATUS(!is_stopped_, FAILED, "Dynamic batcher of model %u is stopped.", model_id_);
+    if (!is_size_fixed_) {
+      // Lengths of batches are uint32 as lengths of samples.
+      GE_CHK_BOOL_RET_STATUS(IsBatchLengthValid(inputs) && IsBatchLengthValid(outputs), PARAM_INVALID,
+                             "Batch of %u samples of model %u is too large.", max_batch_size_, model_id_);
+      for (const auto &input : inputs) {
+        input_sizes_.push_back(input.length);
+      }
+      for (const auto &output : outputs) {
+        output_sizes_.push_back(output.length);
+      }
+      is_size_fixed_ = true;
+    }
+
+    GE_CHK_BOOL_RET_STATUS(inputs.size() == input_sizes_.size() && outputs.size() == output_sizes_.size(),
+                           PARAM_INVALID, "Request of %zu inputs and %zu outputs does not match model %u.",
+                           inputs.size(), outputs.size(), model_id_);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      GE_CHK_BOOL_RET_STATUS(inputs[i].data != nullptr && inputs[i].length == input_sizes_[i], PARAM_INVALID,
+                             "Input %zu of length %u does not match sample length %u.", i, inputs[i].length,
+                             input_sizes_[i]);
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      GE_CHK_BOOL_RET_STATUS(outputs[i].data != nullptr && outputs[i].length == output_sizes_[i], PARAM_INVALID,
+                             "Output %zu of length %u does not match sample length %u.", i, outputs[i].length,
+                             output_sizes_[i]);
+    }
+
+    requests_.push_back(Request{inputs, outputs, std::move(done), Clock::now()});
+    stats_.request_count++;
+  }
+  cond_.notify_one();
+  return SUCCESS;
+}
+
+void DynamicBatcher::GetStats(DynamicBatchStats &stats) {
+  std::vector<uint64_t> latencies;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats = stats_;
+    latencies = latencies_us_;
+  }
+  if (latencies.empty()) {
+    return;
+  }
+  uint64_t total = 0;
+  for (uint64_t latency : latencies) {
+    total += latency;
+  }
+  stats.avg_latency_us = total / latencies.size();
+  size_t tail_index = static_cast<size_t>(static_cast<double>(latencies.size() - 1) * kTailLatencyRatio);
+  std::nth_element(latencies.begin(), latencies.begin() + tail_index, latencies.end());
+  stats.p99_latency_us = latencies[tail_index];
+}
+
+void DynamicBatcher::Run() {
+  while (true) {
+    std::vector<Request> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return is_stopped_ || !requests_.empty(); });
+      if (is_stopped_) {
+        return;
+      }
+      // Wait for more requests until the batch is full or the oldest request reaches its delay budget.
+      auto deadline = requests_.front().submit_time + std::chrono::microseconds(options_.max_delay_us);
+      (void)cond_.wait_until(lock, deadline, [this] { return is_stopped_ || requests_.size() >= max_batch_size_; });
+      if (is_stopped_) {
+        return;
+      }
+      size_t request_num = std::min(requests_.size(), static_cast<size_t>(max_batch_size_));
+      batch.reserve(request_num);
+      for (size_t i = 0; i < request_num; ++i) {
+        batch.emplace_back(std::move(requests_.front()));
+        requests_.pop_front();
+      }
+    }
+    Dispatch(batch);
+  }
+}
+
+uint32_t DynamicBatcher::SelectBatchSize(size_t request_num) const {
+  const std::vector<uint32_t> &batch_sizes = options_.batch_sizes;
+  auto iter = std::lower_bound(batch_sizes.begin(), batch_sizes.end(), static_cast<uint32_t>(request_num));
+  return (iter == batch_sizes.end()) ? max_batch_size_ : *iter;
+}
+
+void DynamicBatcher::Dispatch(std::vector<Request> &requests) {
+  uint32_t batch_size = SelectBatchSize(requests.size());
+  InputData input_data;
+  OutputData output_data;
+  bool zero_copy = false;
+  Status ret = PrepareBatch(requests, batch_size, input_data, output_data, zero_copy);
+  if (ret == SUCCESS) {
+    ret = dispatcher_(input_data, output_data);
+  }
+  if ((ret == SUCCESS) && !zero_copy) {
+    ret = ScatterOutputs(requests, output_data);
+  }
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Run batch of %zu requests on model %u failed.", requests.size(), model_id_);
+  }
+
+  for (auto &request : requests) {
+    request.done(ret);
+  }
+
+  auto end = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.batch_count++;
+  stats_.padded_count += batch_size - requests.size();
+  stats_.zero_copy_count += zero_copy ? 1 : 0;
+  for (const auto &request : requests) {
+    auto latency =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - request.submit_time).count());
+    if (latencies_us_.size() < kLatencyWindow) {
+      latencies_us_.push_back(latency);
+    } else {
+      latencies_us_[latency_pos_] = latency;
+      latency_pos_ = (latency_pos_ + 1) % kLatencyWindow;
+    }
+  }
+}
+
+Status DynamicBatcher::PrepareBatch(const std::vector<Request> &requests, uint32_t batch_size, InputData &input_data,
+                                    OutputData &output_data, bool &zero_copy) {
+  input_data.index = batch_index_++;
+  input_data.timestamp = 0;
+  input_data.timeout = 0;
+  input_data.model_id = model_id_;
+  output_data.index = input_data.index;
+  output_data.model_id = model_id_;
+
+  // Buffers of requests laid out one after another already form the batch.
+  zero_copy = (requests.size() == batch_size);
+  for (size_t i = 0; zero_copy && (i < input_sizes_.size()); ++i) {
+    zero_copy = IsContiguous(requests, true, i);
+  }
+  for (size_t i = 0; zero_copy && (i < output_sizes_.size()); ++i) {
+    zero_copy = IsContiguous(requests, false, i);
+  }
+  if (!zero_copy) {
+    GE_CHK_STATUS_RET_NOLOG(InitBuffers());
+  }
+
+  // Length of the largest batch is checked when sample lengths are fixed by the first request.
+  for (size_t i = 0; i < input_sizes_.size(); ++i) {
+    uint32_t size = input_sizes_[i];
+    void *batch_data = zero_copy ? requests[0].inputs[i].data : input_buffers_[i];
+    for (size_t j = 0; !zero_copy && (j < requests.size()); ++j) {
+      GE_CHK_RT_RET(rtMemcpy(static_cast<uint8_t *>(batch_data) + j * size, size, requests[j].inputs[i].data, size,
+                             RT_MEMCPY_DEVICE_TO_DEVICE));
+    }
+    input_data.blobs.emplace_back(batch_data, size * batch_size, false);
+  }
+  if (options_.has_batch_shape_input) {
+    for (const auto &shape_buffer : batch_shape_buffers_) {
+      if (shape_buffer.first == batch_size) {
+        input_data.blobs.emplace_back(shape_buffer.second, sizeof(int64_t), false);
+        break;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < output_sizes_.size(); ++i) {
+    void *batch_data = zero_copy ? requests[0].outputs[i].data : output_buffers_[i];
+    output_data.blobs.emplace_back(batch_data, output_sizes_[i] * batch_size, false);
+  }
+  return SUCCESS;
+}
+
+Status DynamicBatcher::ScatterOutputs(const std::vector<Request> &requests, const OutputData &output_data) {
+  for (size_t i = 0; i < output_sizes_.size(); ++i) {
+    uint32_t size = output_sizes_[i];
+    const uint8_t *batch_data = static_cast<const uint8_t *>(output_data.blobs[i].data);
+    for (size_t j = 0; j < requests.size(); ++j) {
+      GE_CHK_RT_RET(
+        rtMemcpy(requests[j].outputs[i].data, size, batch_data + j * size, size, RT_MEMCPY_DEVICE_TO_DEVICE));
+    }
+  }
+  return SUCCESS;
+}
+
+Status DynamicBatcher::InitBuffers() {
+  if (is_buffer_inited_) {
+    return SUCCESS;
+  }
+  auto malloc_buffers = [this](const std::vector<uint32_t> &sizes, std::vector<void *> &buffers) -> Status {
+    for (uint32_t size : sizes) {
+      uint64_t batch_len = static_cast<uint64_t>(size) * max_batch_size_;
+      GE_CHK_BOOL_RET_STATUS(batch_len <= std::numeric_limits<uint32_t>::max(), PARAM_INVALID,
+                             "Batch of length %lu of model %u is too large.", batch_len, model_id_);
+      void *buffer = nullptr;
+      if (batch_len != 0) {
+        GE_CHK_RT_RET(rtMalloc(&buffer, batch_len, RT_MEMORY_HBM));
+      }
+      buffers.push_back(buffer);
+    }
+    return SUCCESS;
+  };
+  GE_CHK_STATUS_RET_NOLOG(malloc_buffers(input_sizes_, input_buffers_));
+  GE_CHK_STATUS_RET_NOLOG(malloc_buffers(output_sizes_, output_buffers_));
+  is_buffer_inited_ = true;
+  return SUCCESS;
+}
+
+void DynamicBatcher::FreeBuffers() {
+  for (void *buffer : input_buffers_) {
+    GE_IF_BOOL_EXEC(buffer != nullptr, GE_CHK_RT(rtFree(buffer)));
+  }
+  for (void *buffer : output_buffers_) {
+    GE_IF_BOOL_EXEC(buffer != nullptr, GE_CHK_RT(rtFree(buffer)));
+  }
+  for (const auto &shape_buffer : batch_shape_buffers_) {
+    GE_CHK_RT(rtFree(shape_buffer.second));
+  }
+  input_buffers_.clear();
+  output_buffers_.clear();
+  batch_shape_buffers_.clear();
+  is_buffer_inited_ = false;
+}
+
+bool DynamicBatcher::IsBatchLengthValid(const std::vector<DataBuffer> &buffers) const {
+  for (const auto &buffer : buffers) {
+    if (static_cast<uint64_t>(buffer.length) * max_batch_size_ > std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DynamicBatcher::IsContiguous(const std::vector<Request> &requests, bool is_input, size_t index) {
+  const DataBuffer &first = is_input ? requests[0].inputs[index] : requests[0].outputs[index];
+  const uint8_t *base = static_cast<const uint8_t *>(first.data);
+  for (size_t j = 1; j < requests.size(); ++j) {
+    const DataBuffer &buffer = is_input ? requests[j].inputs[index] : requests[j].outputs[index];
+    if (static_cast<const uint8_t *>(buffer.data) != base + j * first.length) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace ge
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_LOAD_NEW_MODEL_MANAGER_DYNAMIC_BATCHER_H_
+#define GE_GRAPH_LOAD_NEW_MODEL_MANAGER_DYNAMIC_BATCHER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/ge_inner_error_codes.h"
+#include "common/ge_types.h"
+
+namespace ge {
+///
+/// @ingroup ge
+/// @brief Coalesce single requests of a multi-batch model into batches.
+///        Requests are queued until the largest compiled batch size is reached or the oldest one has waited
+///        max_delay_us, then they are dispatched with the smallest compiled batch size that fits them.
+///        Buffers of requests are device memory with the layout of one sample, the same as ExecModel takes.
+///
+class DynamicBatcher {
+ public:
+  using DoneCallback = std::function<void(Status)>;
+  // Run one batch, the batch is done when it returns.
+  using Dispatcher = std::function<Status(const InputData &, OutputData &)>;
+
+  DynamicBatcher(uint32_t model_id, const DynamicBatchOptions &options, Dispatcher dispatcher);
+  ~DynamicBatcher();
+
+  DynamicBatcher(const DynamicBatcher &) = delete;
+  DynamicBatcher &operator=(const DynamicBatcher &) = delete;
+
+  Status Init();
+
+  // Fail the queued requests and stop dispatching.
+  void Finalize();
+
+  ///
+  /// @ingroup ge
+  /// @brief Queue a request of one sample, done is called in the dispatching thread when it finishes.
+  /// @param [in] inputs: input buffers of the sample, not including the batch shape input.
+  /// @param [in] outputs: output buffers of the sample.
+  /// @param [in] done: callback with result of the batch.
+  ///
+  Status Submit(const std::vector<DataBuffer> &inputs, const std::vector<DataBuffer> &outputs, DoneCallback done);
+
+  void GetStats(DynamicBatchStats &stats);
+
+  // Whether the caller runs in the dispatching thread, e.g. in callback of a request.
+  bool IsDispatchThread() const { return std::this_thread::get_id() == thread_.get_id(); }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    std::vector<DataBuffer> inputs;
+    std::vector<DataBuffer> outputs;
+    DoneCallback done;
+    Clock::time_point submit_time;
+  };
+
+  void Run();
+  uint32_t SelectBatchSize(size_t request_num) const;
+  void Dispatch(std::vector<Request> &requests);
+  Status PrepareBatch(const std::vector<Request> &requests, uint32_t batch_size, InputData &input_data,
+                      OutputData &output_data, bool &zero_copy);
+  Status ScatterOutputs(const std::vector<Request> &requests, const OutputData &output_data);
+  Status InitBuffers();
+  void FreeBuffers();
+
+  bool IsBatchLengthValid(const std::vector<DataBuffer> &buffers) const;
+
+  static bool IsContiguous(const std::vector<Request> &requests, bool is_input, size_t index);
+
+  uint32_t model_id_;
+  DynamicBatchOptions options_;
+  Dispatcher dispatcher_;
+  uint32_t max_batch_size_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Request> requests_;
+  bool is_stopped_ = true;
+  std::thread thread_;
+
+  // Length of each input and output of one sample, fixed by the first request.
+  bool is_size_fixed_ = false;
+  std::vector<uint32_t> input_sizes_;
+  std::vector<uint32_t> output_sizes_;
+  // Device buffers of max batch size to gather inputs and scatter outputs, used by the dispatching thread only.
+  bool is_buffer_inited_ = false;
+  std::vector<void *> input_buffers_;
+  std::vector<void *> output_buffers_;
+  // <batch size, device buffer holding the batch size for the batch shape input>
+  std::vector<std::pair<uint32_t, void *>> batch_shape_buffers_;
+  uint32_t batch_index_ = 0;
+
+  // Guarded by mutex_.
+  DynamicBatchStats stats_;
+  std::vector<uint64_t> latencies_us_;
+  size_t latency_pos_ = 0;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_LOAD_NEW_MODEL_MANAGER_DYNAMIC_BATCHER_H_
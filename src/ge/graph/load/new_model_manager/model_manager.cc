@@ -16,6 +16,7 @@
 
 #include "graph/load/new_model_manager/model_manager.h"
 
+#include <chrono>
 #include <string>
 
 #include "common/l2_cache_optimize.h"
@@ -24,12 +25,20 @@
 #include "framework/common/debug/ge_log.h"
 #include "graph/load/new_model_manager/davinci_model.h"
 #include "graph/load/new_model_manager/davinci_model_parser.h"
+#include "graph/load/new_model_manager/dynamic_batcher.h"
+#include "graph/manager/graph_mem_allocator.h"
 
 namespace ge {
 thread_local uint32_t device_count = 0;
 namespace {
 const int kCmdParSize = 2;
 const int kDumpCmdPairSize = 2;
+// Alignment of weights packed in the weight memory of model group
+const size_t kModelGroupMemAlign = 512;
+
+size_t AlignModelGroupMem(size_t size) {
+  return (size + kModelGroupMemAlign - 1) / kModelGroupMemAlign * kModelGroupMemAlign;
+}
 }  // namespace
 
 std::shared_ptr<ModelManager> ModelManager::GetInstance() {
@@ -274,6 +283,22 @@ std::shared_ptr<DavinciModel> ModelManager::GetModel(uint32_t id) {
 }
 
 Status ModelManager::Unload(uint32_t model_id) {
+  bool has_batcher = false;
+  {
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    auto it = grouped_models_.find(model_id);
+    if (it != grouped_models_.end()) {
+      GELOGE(PARAM_INVALID, "Model %u is in model group %u, it is unloaded with the group.", model_id, it->second);
+      return PARAM_INVALID;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    has_batcher = (batchers_.count(model_id) != 0);
+  }
+  if (has_batcher) {
+    GE_CHK_STATUS_RET(DisableDynamicBatch(model_id), "Disable dynamic batch of model %u failed.", model_id);
+  }
   GE_CHK_STATUS_RET(DeleteModel(model_id), "failed to unload model id: %u", model_id);
   if (device_count > 0) {
     device_count--;
@@ -408,6 +433,9 @@ Status ModelManager::Start(uint32_t model_id) {
   std::shared_ptr<DavinciModel> davinci_model = GetModel(model_id);
 
   GE_CHK_BOOL_RET_STATUS(davinci_model != nullptr, PARAM_INVALID, "Invalid Model ID %u to start! ", model_id);
+  // Models of a group have no run thread, they share the threads calling ExecuteModel.
+  GE_CHK_BOOL_RET_STATUS(GetModelGroupOfModel(model_id) == nullptr, PARAM_INVALID,
+                         "Model %u is in a model group, it can only be run by ExecuteModel.", model_id);
 
   Status status = davinci_model->ModelRunStart();
   if (status == SUCCESS) {
@@ -669,6 +697,242 @@ Status ModelManager::LoadModelOffline(uint32_t &model_id, const ModelData &model
   return ret;
 }
 
+Status ModelManager::LoadModelGroup(uint32_t &group_id, const std::vector<ModelData> &models, size_t mem_limit,
+                                    std::vector<uint32_t> &model_ids) {
+  if (models.empty()) {
+    GELOGE(PARAM_INVALID, "No model to load into model group.");
+    return PARAM_INVALID;
+  }
+
+  // Admission control, the largest feature map is shared and weights are packed one after another.
+  size_t feature_map_size = 0;
+  size_t weight_mem_size = 0;
+  size_t separate_size = 0;
+  std::vector<size_t> weight_offsets(models.size(), 0);
+  std::vector<size_t> weight_sizes(models.size(), 0);
+  for (size_t i = 0; i < models.size(); ++i) {
+    size_t mem_size = 0;
+    GE_CHK_STATUS_RET(GetModelMemAndWeightSize(models[i], mem_size, weight_sizes[i]),
+                      "Get memory size of model %zu in group failed.", i);
+    feature_map_size = std::max(feature_map_size, mem_size);
+    weight_offsets[i] = weight_mem_size;
+    weight_mem_size += AlignModelGroupMem(weight_sizes[i]);
+    separate_size += mem_size + weight_sizes[i];
+  }
+  size_t group_size = feature_map_size + weight_mem_size;
+  if ((mem_limit != 0) && (group_size > mem_limit)) {
+    GELOGE(PARAM_INVALID, "Model group needs %zu bytes of memory, which exceeds limit %zu.", group_size, mem_limit);
+    return PARAM_INVALID;
+  }
+  size_t free_mem = 0;
+  size_t total_mem = 0;
+  if ((rtMemGetInfo(&free_mem, &total_mem) == RT_ERROR_NONE) && (group_size > free_mem)) {
+    GELOGE(MEMALLOC_FAILED, "Model group needs %zu bytes of memory, only %zu bytes are free.", group_size, free_mem);
+    return MEMALLOC_FAILED;
+  }
+
+  std::shared_ptr<ModelGroup> group = MakeShared<ModelGroup>();
+  GE_CHECK_NOTNULL(group);
+  int32_t device_id = 0;
+  GE_CHK_RT_RET(rtGetDevice(&device_id));
+  group->device_id = static_cast<uint32_t>(device_id);
+  if (feature_map_size != 0) {
+    group->feature_map_mem = MemManager::Instance(RT_MEMORY_HBM)->MallocMemory(feature_map_size, group->device_id);
+    GE_CHK_BOOL_RET_STATUS(group->feature_map_mem != nullptr, MEMALLOC_FAILED,
+                           "Malloc feature map memory of size %zu for model group failed.", feature_map_size);
+  }
+  if (weight_mem_size != 0) {
+    group->weight_mem = MemManager::Instance(RT_MEMORY_HBM)->MallocMemory(weight_mem_size, group->device_id);
+    GE_CHK_BOOL_EXEC(group->weight_mem != nullptr, FreeModelGroupMem(*group);
+                     return MEMALLOC_FAILED, "Malloc weight memory of size %zu for model group failed.",
+                     weight_mem_size);
+  }
+
+  for (size_t i = 0; i < models.size(); ++i) {
+    uint32_t model_id = 0;
+    void *weight_ptr = (weight_sizes[i] != 0) ? (group->weight_mem + weight_offsets[i]) : nullptr;
+    Status ret = LoadModelOffline(model_id, models[i], nullptr, group->feature_map_mem, feature_map_size, weight_ptr,
+                                  weight_sizes[i]);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Load model %zu of model group failed.", i);
+      for (uint32_t loaded_id : group->model_ids) {
+        (void)Unload(loaded_id);
+      }
+      FreeModelGroupMem(*group);
+      return ret;
+    }
+    group->model_ids.push_back(model_id);
+  }
+
+  group->info.model_num = static_cast<uint32_t>(models.size());
+  group->info.feature_map_size = feature_map_size;
+  group->info.weight_size = weight_mem_size;
+  group->info.saved_size = (separate_size > group_size) ? (separate_size - group_size) : 0;
+  model_ids = group->model_ids;
+  {
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    group_id = ++max_group_id_;
+    for (uint32_t model_id : model_ids) {
+      grouped_models_[model_id] = group_id;
+    }
+    model_groups_[group_id] = group;
+  }
+  GEEVENT("[GEPERFTRACE] Load %zu models into group %u, feature map %zu bytes, weights %zu bytes, %zu bytes saved.",
+          models.size(), group_id, feature_map_size, weight_mem_size, static_cast<size_t>(group->info.saved_size));
+  return SUCCESS;
+}
+
+Status ModelManager::UnloadModelGroup(uint32_t group_id) {
+  std::shared_ptr<ModelGroup> group;
+  {
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    auto it = model_groups_.find(group_id);
+    if (it == model_groups_.end()) {
+      GELOGE(PARAM_INVALID, "Model group %u does not exist.", group_id);
+      return PARAM_INVALID;
+    }
+    group = it->second;
+    (void)model_groups_.erase(it);
+    for (uint32_t model_id : group->model_ids) {
+      (void)grouped_models_.erase(model_id);
+    }
+  }
+
+  // Wait for the running model, memory of the group is freed after that.
+  std::lock_guard<std::mutex> run_lock(group->run_mutex);
+  group->is_unloaded = true;
+  Status ret = SUCCESS;
+  for (uint32_t model_id : group->model_ids) {
+    Status unload_ret = Unload(model_id);
+    if (unload_ret != SUCCESS) {
+      GELOGE(unload_ret, "Unload model %u of model group %u failed.", model_id, group_id);
+      ret = unload_ret;
+    }
+  }
+  FreeModelGroupMem(*group);
+
+  const ModelGroupInfo &info = group->info;
+  GEEVENT("[GEPERFTRACE] Unload model group %u of %u models, %lu runs in %lu us.", group_id, info.model_num,
+          info.run_count, info.run_time_us);
+  return ret;
+}
+
+Status ModelManager::GetModelGroupInfo(uint32_t group_id, ModelGroupInfo &info) {
+  std::shared_ptr<ModelGroup> group;
+  {
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    auto it = model_groups_.find(group_id);
+    GE_CHK_BOOL_RET_STATUS(it != model_groups_.end(), PARAM_INVALID, "Model group %u does not exist.", group_id);
+    group = it->second;
+  }
+  std::lock_guard<std::mutex> run_lock(group->run_mutex);
+  info = group->info;
+  return SUCCESS;
+}
+
+std::shared_ptr<ModelManager::ModelGroup> ModelManager::GetModelGroupOfModel(uint32_t model_id) {
+  std::lock_guard<std::mutex> lock(group_mutex_);
+  auto it = grouped_models_.find(model_id);
+  if (it == grouped_models_.end()) {
+    return nullptr;
+  }
+  auto group_it = model_groups_.find(it->second);
+  return (group_it == model_groups_.end()) ? nullptr : group_it->second;
+}
+
+void ModelManager::FreeModelGroupMem(ModelGroup &group) {
+  if (group.feature_map_mem != nullptr) {
+    GE_CHK_STATUS(MemManager::Instance(RT_MEMORY_HBM)->FreeMemory(group.feature_map_mem, group.device_id),
+                  "failed to free feature map memory of model group");
+    group.feature_map_mem = nullptr;
+  }
+  if (group.weight_mem != nullptr) {
+    GE_CHK_STATUS(MemManager::Instance(RT_MEMORY_HBM)->FreeMemory(group.weight_mem, group.device_id),
+                  "failed to free weight memory of model group");
+    group.weight_mem = nullptr;
+  }
+}
+
+Status ModelManager::EnableDynamicBatch(uint32_t model_id, const DynamicBatchOptions &options) {
+  GE_CHK_BOOL_RET_STATUS(GetModel(model_id) != nullptr, PARAM_INVALID, "Invalid model id %u.", model_id);
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
+  GE_CHK_BOOL_RET_STATUS(batchers_.count(model_id) == 0, PARAM_INVALID, "Dynamic batch of model %u is enabled.",
+                         model_id);
+
+  BatcherInfo batcher_info;
+  GE_CHK_RT_RET(rtStreamCreate(&batcher_info.stream, 0));
+  rtStream_t stream = batcher_info.stream;
+  // Batches run in asynchronize mode on the stream of batcher, which waits until the batch finishes.
+  auto dispatcher = [this, model_id, stream](const InputData &input_data, OutputData &output_data) -> Status {
+    return ExecuteModel(model_id, stream, true, input_data, output_data);
+  };
+  batcher_info.batcher = MakeShared<DynamicBatcher>(model_id, options, dispatcher);
+  Status ret = (batcher_info.batcher == nullptr) ? MEMALLOC_FAILED : batcher_info.batcher->Init();
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Init dynamic batcher of model %u failed.", model_id);
+    batcher_info.batcher.reset();
+    GE_CHK_RT(rtStreamDestroy(batcher_info.stream));
+    return ret;
+  }
+  batchers_[model_id] = batcher_info;
+  return SUCCESS;
+}
+
+Status ModelManager::DisableDynamicBatch(uint32_t model_id) {
+  BatcherInfo batcher_info;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    auto it = batchers_.find(model_id);
+    GE_CHK_BOOL_RET_STATUS(it != batchers_.end(), PARAM_INVALID, "Dynamic batch of model %u is not enabled.",
+                           model_id);
+    // Stopping the batcher joins its dispatching thread, which runs the callbacks of requests.
+    GE_CHK_BOOL_RET_STATUS(!it->second.batcher->IsDispatchThread(), FAILED,
+                           "Dynamic batch of model %u can not be disabled in callback of its requests.", model_id);
+    batcher_info = it->second;
+    (void)batchers_.erase(it);
+  }
+
+  batcher_info.batcher->Finalize();
+  DynamicBatchStats stats;
+  batcher_info.batcher->GetStats(stats);
+  GEEVENT("[GEPERFTRACE] Dynamic batch of model %u: %lu requests in %lu batches, %lu padded, %lu zero copy, "
+          "latency avg %lu us, p99 %lu us.", model_id, stats.request_count, stats.batch_count, stats.padded_count,
+          stats.zero_copy_count, stats.avg_latency_us, stats.p99_latency_us);
+  // The model keeps the stream of the last batch it ran, which must not be used after it is destroyed.
+  std::shared_ptr<DavinciModel> davinci_model = GetModel(model_id);
+  if (davinci_model != nullptr) {
+    davinci_model->ResetModelStream(batcher_info.stream);
+  }
+  GE_CHK_RT(rtStreamDestroy(batcher_info.stream));
+  return SUCCESS;
+}
+
+Status ModelManager::DynamicBatchInput(uint32_t model_id, const std::vector<DataBuffer> &inputs,
+                                       const std::vector<DataBuffer> &outputs, std::function<void(Status)> done) {
+  std::shared_ptr<DynamicBatcher> batcher;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    auto it = batchers_.find(model_id);
+    GE_CHK_BOOL_RET_STATUS(it != batchers_.end(), PARAM_INVALID, "Dynamic batch of model %u is not enabled.",
+                           model_id);
+    batcher = it->second.batcher;
+  }
+  return batcher->Submit(inputs, outputs, std::move(done));
+}
+
+Status ModelManager::GetDynamicBatchStats(uint32_t model_id, DynamicBatchStats &stats) {
+  std::shared_ptr<DynamicBatcher> batcher;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    auto it = batchers_.find(model_id);
+    GE_CHK_BOOL_RET_STATUS(it != batchers_.end(), PARAM_INVALID, "Dynamic batch of model %u is not enabled.",
+                           model_id);
+    batcher = it->second.batcher;
+  }
+  batcher->GetStats(stats);
+  return SUCCESS;
+}
+
 ///
 /// @ingroup ge
 /// @brief ACL case, Load task list with queue.
@@ -738,7 +1002,27 @@ Status ModelManager::ExecuteModel(uint32_t model_id, rtStream_t stream, bool asy
   std::shared_ptr<DavinciModel> davinci_model = GetModel(model_id);
   GE_CHK_BOOL_RET_STATUS(davinci_model != nullptr, PARAM_INVALID, "Invalid Model ID %u to start! ", model_id);
 
-  Status status = davinci_model->NnExecute(stream, async_mode, input_data, output_data);
+  Status status = SUCCESS;
+  std::shared_ptr<ModelGroup> group = GetModelGroupOfModel(model_id);
+  if (group == nullptr) {
+    status = davinci_model->NnExecute(stream, async_mode, input_data, output_data);
+  } else {
+    std::lock_guard<std::mutex> run_lock(group->run_mutex);
+    GE_CHK_BOOL_RET_STATUS(!group->is_unloaded, PARAM_INVALID, "Model group of model %u is unloaded.", model_id);
+    auto start = std::chrono::steady_clock::now();
+    status = davinci_model->NnExecute(stream, async_mode, input_data, output_data);
+    // The feature map is reused by the next model of the group, so wait until the model is done
+    // on the stream it actually ran on, which is its inner stream if the caller passed null.
+    if ((status == SUCCESS) && !async_mode) {
+      rtError_t rt_ret = rtStreamSynchronize(davinci_model->GetRtModelStream());
+      GE_IF_BOOL_EXEC(rt_ret != RT_ERROR_NONE, GELOGE(RT_FAILED, "Synchronize stream failed, ret: 0x%X", rt_ret);
+                      status = RT_FAILED);
+    }
+    auto end = std::chrono::steady_clock::now();
+    group->info.run_count++;
+    group->info.run_time_us +=
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+  }
   if (status == SUCCESS) {
     GELOGI("Execute model %u success.", model_id);
   }
@@ -20,8 +20,10 @@
 #include <pthread.h>
 #include <stdint.h>
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 #include "cce/aicpu_engine_struct.h"
@@ -37,6 +39,7 @@
 
 namespace ge {
 class DavinciModel;
+class DynamicBatcher;
 
 class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelManager {
  public:
@@ -57,6 +60,45 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelManager {
                               std::shared_ptr<ModelListener> listener = nullptr, void *dev_ptr = nullptr,
                               size_t mem_size = 0, void *weight_ptr = nullptr, size_t weight_size = 0);
 
+  ///
+  /// @ingroup ge
+  /// @brief Load models into one group. Models of a group share one feature map memory sized to the largest
+  ///        model and one packed weight memory, so they are executed one at a time by ExecuteModel.
+  /// @param [out] group_id: id of model group.
+  /// @param [in] models: offline models to load.
+  /// @param [in] mem_limit: max device memory of the group, 0 means no limit except free device memory.
+  /// @param [out] model_ids: ids of loaded models, in the order of models.
+  /// @return Status run result
+  ///
+  ge::Status LoadModelGroup(uint32_t &group_id, const std::vector<ModelData> &models, size_t mem_limit,
+                            std::vector<uint32_t> &model_ids);
+
+  ge::Status UnloadModelGroup(uint32_t group_id);
+
+  ge::Status GetModelGroupInfo(uint32_t group_id, ModelGroupInfo &info);
+
+  ///
+  /// @ingroup ge
+  /// @brief Queue single requests of a multi-batch model, and run them in batches of compiled batch sizes.
+  ///
+  ge::Status EnableDynamicBatch(uint32_t model_id, const DynamicBatchOptions &options);
+
+  ge::Status DisableDynamicBatch(uint32_t model_id);
+
+  ///
+  /// @ingroup ge
+  /// @brief Submit a request of one sample to the dynamic batcher of model.
+  /// @param [in] model_id: id of model whose dynamic batch is enabled.
+  /// @param [in] inputs: device buffers of one sample, not including the batch shape input.
+  /// @param [in] outputs: device buffers receiving outputs of the sample.
+  /// @param [in] done: called with result when the batch of the request finishes.
+  /// @return Status run result
+  ///
+  ge::Status DynamicBatchInput(uint32_t model_id, const std::vector<DataBuffer> &inputs,
+                               const std::vector<DataBuffer> &outputs, std::function<void(Status)> done);
+
+  ge::Status GetDynamicBatchStats(uint32_t model_id, DynamicBatchStats &stats);
+
   ///
   /// @ingroup domi_ome
   /// @brief load and init model
@@ -239,6 +281,22 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelManager {
 
   void GenModelId(uint32_t *id);
 
+  // Models of a group share feature map memory, so they never run concurrently.
+  struct ModelGroup {
+    uint32_t device_id = 0;
+    uint8_t *feature_map_mem = nullptr;
+    uint8_t *weight_mem = nullptr;
+    std::vector<uint32_t> model_ids;
+    // Guards running models of the group and the fields below.
+    std::mutex run_mutex;
+    bool is_unloaded = false;
+    ModelGroupInfo info;
+  };
+
+  std::shared_ptr<ModelGroup> GetModelGroupOfModel(uint32_t model_id);
+
+  static void FreeModelGroupMem(ModelGroup &group);
+
   std::map<uint32_t, std::shared_ptr<DavinciModel>> model_map_;
   std::map<std::string, std::vector<uint64_t>> model_aicpu_kernel_;
   std::vector<uint32_t> free_model_id_;
@@ -246,6 +304,21 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelManager {
   std::mutex map_mutex_;
   std::mutex sess_ids_mutex_;
   std::set<uint64_t> sess_ids_;
+
+  std::mutex group_mutex_;
+  // <group id, model group>
+  std::map<uint32_t, std::shared_ptr<ModelGroup>> model_groups_;
+  // <model id, group id>
+  std::map<uint32_t, uint32_t> grouped_models_;
+  uint32_t max_group_id_ = 0;
+
+  struct BatcherInfo {
+    std::shared_ptr<DynamicBatcher> batcher;
+    rtStream_t stream = nullptr;
+  };
+  std::mutex batcher_mutex_;
+  // <model id, dynamic batcher of model>
+  std::map<uint32_t, BatcherInfo> batchers_;
 };
 }  // namespace ge
 
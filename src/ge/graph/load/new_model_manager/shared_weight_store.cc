@@ -0,0 +1,148 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "graph/load/new_model_manager/shared_weight_store.h"
+
+#include <cstring>
+
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+#include "graph/manager/graph_mem_allocator.h"
+#include "graph/utils/mem_utils.h"
+#include "runtime/mem.h"
+
+namespace ge {
+SharedWeightStore &SharedWeightStore::GetInstance() {
+  static SharedWeightStore instance;
+
+  return instance;
+}
+
+Status SharedWeightStore::Acquire(uint32_t device_id, const ContentDigest &digest, const uint8_t *weights,
+                                  uint8_t *&dev_addr) {
+  GE_CHECK_NOTNULL(weights);
+  if (digest.size == 0) {
+    GELOGE(PARAM_INVALID, "Can not share empty weights.");
+    return PARAM_INVALID;
+  }
+  dev_addr = nullptr;
+
+  std::shared_ptr<const std::vector<uint8_t>> host_weights = nullptr;
+  uint8_t *stored_addr = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto iter = weights_[device_id].find(digest);
+    // Models loaded concurrently with the same weights wait for the first one, and upload them if it fails.
+    while ((iter != weights_[device_id].end()) && !iter->second.is_ready) {
+      ready_cond_.wait(lock);
+      iter = weights_[device_id].find(digest);
+    }
+    if (iter == weights_[device_id].end()) {
+      weights_[device_id][digest].ref_count = 1;
+      lock.unlock();
+      return Upload(device_id, digest, weights, dev_addr);
+    }
+    // Referred while comparing, so that the memory is not freed by other models.
+    ++iter->second.ref_count;
+    host_weights = iter->second.host_weights;
+    stored_addr = iter->second.dev_addr;
+  }
+
+  if (memcmp(host_weights->data(), weights, digest.size) != 0) {
+    GELOGW("Weights of size %zu differ from stored ones with the same digest on device %u, not shared.", digest.size,
+           device_id);
+    return Release(device_id, digest);
+  }
+  dev_addr = stored_addr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  dedup_bytes_ += digest.size;
+  GELOGI("Share weights of size %zu on device %u.", digest.size, device_id);
+  return SUCCESS;
+}
+
+Status SharedWeightStore::Upload(uint32_t device_id, const ContentDigest &digest, const uint8_t *weights,
+                                 uint8_t *&dev_addr) {
+  Status ret = SUCCESS;
+  auto host_weights = MakeShared<const std::vector<uint8_t>>(weights, weights + digest.size);
+  uint8_t *addr = nullptr;
+  if (host_weights == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "Malloc host copy of weights of size %zu failed.", digest.size);
+    ret = MEMALLOC_FAILED;
+  } else {
+    addr = MemManager::Instance(RT_MEMORY_HBM)->MallocMemory(digest.size, device_id);
+    if (addr == nullptr) {
+      GELOGE(MEMALLOC_FAILED, "Malloc weight memory of size %zu failed.", digest.size);
+      ret = MEMALLOC_FAILED;
+    }
+  }
+  if (ret == SUCCESS) {
+    rtError_t rt_ret = rtMemcpy(addr, digest.size, weights, digest.size, RT_MEMCPY_HOST_TO_DEVICE);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "Copy weights to device failed, ret: 0x%X.", rt_ret);
+      (void)MemManager::Instance(RT_MEMORY_HBM)->FreeMemory(addr, device_id);
+      ret = RT_FAILED;
+    }
+  }
+
+  // The entry reserved by Acquire is published, or removed for waiting models to upload again.
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &device_weights = weights_[device_id];
+  if (ret == SUCCESS) {
+    WeightMemInfo &info = device_weights[digest];
+    info.dev_addr = addr;
+    info.host_weights = host_weights;
+    info.is_ready = true;
+    dev_addr = addr;
+  } else {
+    device_weights.erase(digest);
+    if (device_weights.empty()) {
+      weights_.erase(device_id);
+    }
+  }
+  ready_cond_.notify_all();
+  return ret;
+}
+
+Status SharedWeightStore::Release(uint32_t device_id, const ContentDigest &digest) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto device_iter = weights_.find(device_id);
+  if (device_iter == weights_.end()) {
+    GELOGE(INTERNAL_ERROR, "No shared weights on device %u.", device_id);
+    return INTERNAL_ERROR;
+  }
+  auto iter = device_iter->second.find(digest);
+  if (iter == device_iter->second.end()) {
+    GELOGE(INTERNAL_ERROR, "Shared weights of size %zu not found on device %u.", digest.size, device_id);
+    return INTERNAL_ERROR;
+  }
+
+  if (--iter->second.ref_count > 0) {
+    return SUCCESS;
+  }
+  Status ret = MemManager::Instance(RT_MEMORY_HBM)->FreeMemory(iter->second.dev_addr, device_id);
+  device_iter->second.erase(iter);
+  if (device_iter->second.empty()) {
+    weights_.erase(device_iter);
+  }
+  return ret;
+}
+
+uint64_t SharedWeightStore::GetDedupBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dedup_bytes_;
+}
+}  // namespace ge
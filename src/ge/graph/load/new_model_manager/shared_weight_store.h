@@ -0,0 +1,92 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_GRAPH_LOAD_NEW_MODEL_MANAGER_SHARED_WEIGHT_STORE_H_
+#define GE_GRAPH_LOAD_NEW_MODEL_MANAGER_SHARED_WEIGHT_STORE_H_
+
+#include <condition_variable>
+#include <cstdint>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/fmk_types.h"
+#include "common/ge/content_hash.h"
+#include "framework/common/ge_inner_error_codes.h"
+
+namespace ge {
+///
+/// Device weight memory shared by models loaded in the same process.
+/// Models whose weights have the same content refer to one device buffer, which is freed by the last model.
+/// Weights are looked up by digest and then compared byte by byte, so a digest collision is never shared.
+///
+class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY SharedWeightStore {
+ public:
+  static SharedWeightStore &GetInstance();
+
+  ///
+  /// @ingroup ge
+  /// @brief Get device memory holding weights, weights are copied to device only if not stored yet.
+  /// @param [in] device_id: device of the memory.
+  /// @param [in] digest: content digest of weights.
+  /// @param [in] weights: host weights data.
+  /// @param [out] dev_addr: device memory of weights, nullptr if stored weights of the same digest differ in content,
+  ///                        which are left to the caller to copy to its own memory.
+  /// @return Status
+  ///
+  Status Acquire(uint32_t device_id, const ContentDigest &digest, const uint8_t *weights, uint8_t *&dev_addr);
+
+  ///
+  /// @ingroup ge
+  /// @brief Release device memory got by Acquire, it is freed when no model refers to it.
+  /// @param [in] device_id: device of the memory.
+  /// @param [in] digest: content digest of weights.
+  /// @return Status
+  ///
+  Status Release(uint32_t device_id, const ContentDigest &digest);
+
+  // Bytes of device memory saved by sharing weights so far.
+  uint64_t GetDedupBytes();
+
+ private:
+  SharedWeightStore() = default;
+  ~SharedWeightStore() = default;
+
+  struct WeightMemInfo {
+    uint8_t *dev_addr = nullptr;
+    uint32_t ref_count = 0;
+    // False while the first model copies weights to device, others with the same digest wait for it.
+    bool is_ready = false;
+    // Copy of weights, compared with weights of the same digest.
+    std::shared_ptr<const std::vector<uint8_t>> host_weights;
+  };
+
+  Status Upload(uint32_t device_id, const ContentDigest &digest, const uint8_t *weights, uint8_t *&dev_addr);
+
+  // Guards weights_ and dedup_bytes_, not held while weights are copied or compared.
+  std::mutex mutex_;
+  std::condition_variable ready_cond_;
+  // <device id, <digest of weights, weight memory>>
+  std::map<uint32_t, std::unordered_map<ContentDigest, WeightMemInfo, ContentDigestHasher>> weights_;
+  uint64_t dedup_bytes_ = 0;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_LOAD_NEW_MODEL_MANAGER_SHARED_WEIGHT_STORE_H_
@@ -16,7 +16,9 @@
 
 #include "graph/load/new_model_manager/tbe_handle_store.h"
 
+#include <atomic>
 #include <limits>
+
 #include "common/ge_inner_error_codes.h"
 #include "framework/common/debug/ge_log.h"
 #include "runtime/kernel.h"
@@ -50,6 +52,14 @@ TBEHandleStore &TBEHandleStore::GetInstance() {
   return instance;
 }
 
+TBEHandleStore::Shard &TBEHandleStore::GetShard(const std::string &name) {
+  return shards_[std::hash<std::string>()(name) % kShardNum];
+}
+
+std::shared_ptr<const TBEHandleStore::HandleMap> TBEHandleStore::LoadKernels(const Shard &shard) {
+  return std::atomic_load(&shard.kernels);
+}
+
 ///
 /// @ingroup ge
 /// @brief Find Registered TBE handle by name.
@@ -58,13 +68,12 @@ TBEHandleStore &TBEHandleStore::GetInstance() {
 /// @return true: found / false: not found.
 ///
 bool TBEHandleStore::FindTBEHandle(const std::string &name, void *&handle) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = kernels_.find(name);
-  if (it == kernels_.end()) {
+  std::shared_ptr<const HandleMap> kernels = LoadKernels(GetShard(name));
+  auto it = kernels->find(name);
+  if (it == kernels->end()) {
     return false;
   } else {
-    TbeHandleInfo &info = it->second;
-    handle = info.handle();
+    handle = it->second->handle();
     return true;
   }
 }
@@ -78,15 +87,17 @@ bool TBEHandleStore::FindTBEHandle(const std::string &name, void *&handle) {
 /// @return NA
 ///
 void TBEHandleStore::StoreTBEHandle(const std::string &name, void *handle, std::shared_ptr<OpKernelBin> &kernel) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = kernels_.find(name);
-  if (it == kernels_.end()) {
-    TbeHandleInfo info(handle, kernel);
-    info.used_inc();
-    kernels_.emplace(name, info);
+  Shard &shard = GetShard(name);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.kernels->find(name);
+  if (it == shard.kernels->end()) {
+    auto info = std::make_shared<TbeHandleInfo>(handle, kernel);
+    info->used_inc();
+    auto kernels = std::make_shared<HandleMap>(*shard.kernels);
+    kernels->emplace(name, info);
+    std::atomic_store(&shard.kernels, std::shared_ptr<const HandleMap>(kernels));
   } else {
-    TbeHandleInfo &info = it->second;
-    info.used_inc();
+    it->second->used_inc();
   }
 }
 
@@ -97,15 +108,73 @@ void TBEHandleStore::StoreTBEHandle(const std::string &name, void *handle, std::
 /// @return NA
 ///
 void TBEHandleStore::ReferTBEHandle(const std::string &name) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = kernels_.find(name);
-  if (it == kernels_.end()) {
+  Shard &shard = GetShard(name);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.kernels->find(name);
+  if (it == shard.kernels->end()) {
     GELOGE(INTERNAL_ERROR, "Kernel[%s] not found in stored.", name.c_str());
     return;
   }
 
-  TbeHandleInfo &info = it->second;
-  info.used_inc();
+  it->second->used_inc();
+}
+
+///
+/// @ingroup ge
+/// @brief Refer TBE handles of kernels in one pass.
+/// @param [in] kernels: handle names and kernel bins.
+/// @param [in] prepare: called with index of kernel and its handle.
+/// @return SUCCESS / status prepare failed with.
+///
+Status TBEHandleStore::ReferTBEHandles(const std::vector<std::pair<std::string, std::shared_ptr<OpKernelBin>>> &kernels,
+                                       const std::function<Status(size_t, void *&)> &prepare) {
+  std::vector<std::vector<size_t>> shard_kernels(kShardNum);
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    shard_kernels[&GetShard(kernels[i].first) - shards_].push_back(i);
+  }
+
+  for (size_t shard_index = 0; shard_index < kShardNum; ++shard_index) {
+    if (shard_kernels[shard_index].empty()) {
+      continue;
+    }
+    Shard &shard = shards_[shard_index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // Map of the shard is copied once for all kernels inserted
+    std::shared_ptr<HandleMap> new_kernels;
+    Status ret = SUCCESS;
+    for (size_t index : shard_kernels[shard_index]) {
+      const std::string &name = kernels[index].first;
+      const HandleMap &current = (new_kernels != nullptr) ? *new_kernels : *shard.kernels;
+      auto it = current.find(name);
+      void *handle = (it != current.end()) ? it->second->handle() : nullptr;
+      ret = prepare(index, handle);
+      if (ret != SUCCESS) {
+        break;
+      }
+      if (handle == nullptr) {
+        continue;
+      }
+      if (it != current.end()) {
+        it->second->used_inc();
+        continue;
+      }
+
+      std::shared_ptr<OpKernelBin> kernel = kernels[index].second;
+      auto info = std::make_shared<TbeHandleInfo>(handle, kernel);
+      info->used_inc();
+      if (new_kernels == nullptr) {
+        new_kernels = std::make_shared<HandleMap>(*shard.kernels);
+      }
+      new_kernels->emplace(name, info);
+    }
+    if (new_kernels != nullptr) {
+      std::atomic_store(&shard.kernels, std::shared_ptr<const HandleMap>(new_kernels));
+    }
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+  return SUCCESS;
 }
 
 ///
@@ -115,23 +184,42 @@ void TBEHandleStore::ReferTBEHandle(const std::string &name) {
 /// @return NA
 ///
 void TBEHandleStore::EraseTBEHandle(const std::map<std::string, uint32_t> &names) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::vector<const std::pair<const std::string, uint32_t> *>> shard_names(kShardNum);
   for (auto &item : names) {
-    auto it = kernels_.find(item.first);
-    if (it == kernels_.end()) {
-      GELOGE(INTERNAL_ERROR, "Kernel[%s] not found in stored.", item.first.c_str());
+    shard_names[&GetShard(item.first) - shards_].push_back(&item);
+  }
+
+  for (size_t shard_index = 0; shard_index < kShardNum; ++shard_index) {
+    if (shard_names[shard_index].empty()) {
       continue;
     }
+    Shard &shard = shards_[shard_index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::shared_ptr<HandleMap> new_kernels;
+    for (auto item : shard_names[shard_index]) {
+      const HandleMap &current = (new_kernels != nullptr) ? *new_kernels : *shard.kernels;
+      auto it = current.find(item->first);
+      if (it == current.end()) {
+        GELOGE(INTERNAL_ERROR, "Kernel[%s] not found in stored.", item->first.c_str());
+        continue;
+      }
 
-    TbeHandleInfo &info = it->second;
-    if (info.used_num() > item.second) {
-      info.used_dec(item.second);
-    } else {
-      rtError_t rt_ret = rtDevBinaryUnRegister(info.handle());
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(INTERNAL_ERROR, "Kernel[%s] UnRegister handle fail:%u.", item.first.c_str(), rt_ret);
+      TbeHandleInfo &info = *it->second;
+      if (info.used_num() > item->second) {
+        info.used_dec(item->second);
+      } else {
+        rtError_t rt_ret = rtDevBinaryUnRegister(info.handle());
+        if (rt_ret != RT_ERROR_NONE) {
+          GELOGE(INTERNAL_ERROR, "Kernel[%s] UnRegister handle fail:%u.", item->first.c_str(), rt_ret);
+        }
+        if (new_kernels == nullptr) {
+          new_kernels = std::make_shared<HandleMap>(*shard.kernels);
+        }
+        new_kernels->erase(item->first);
       }
-      kernels_.erase(it);
+    }
+    if (new_kernels != nullptr) {
+      std::atomic_store(&shard.kernels, std::shared_ptr<const HandleMap>(new_kernels));
     }
   }
 }
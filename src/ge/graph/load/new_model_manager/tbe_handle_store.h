@@ -19,13 +19,17 @@
 
 #include <cstdint>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/fmk_types.h"
+#include "common/ge_inner_error_codes.h"
 #include "graph/op_kernel_bin.h"
 
 namespace ge {
@@ -48,6 +52,11 @@ class TbeHandleInfo {
   std::shared_ptr<OpKernelBin> kernel_;
 };
 
+///
+/// @ingroup ge
+/// @brief Store of TBE handles registered by models. Handles are spread over shards by name, finding a handle takes
+///        no lock, and storing, referring and erasing lock only the shard of the name.
+///
 class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
  public:
   static TBEHandleStore &GetInstance();
@@ -79,6 +88,19 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
   ///
   void ReferTBEHandle(const std::string &name);
 
+  ///
+  /// @ingroup ge
+  /// @brief Refer TBE handles of kernels in one pass, kernels of a shard are processed under one lock of the shard.
+  ///        prepare is called for each kernel with the handle stored or nullptr, and may register the kernel bin
+  ///        when no handle is stored. The handle it leaves is referred, and stored if new. Nothing is referred
+  ///        if it leaves nullptr.
+  /// @param [in] kernels: handle names and kernel bins.
+  /// @param [in] prepare: called with index of kernel and its handle.
+  /// @return SUCCESS / status prepare failed with, kernels prepared before are still referred.
+  ///
+  Status ReferTBEHandles(const std::vector<std::pair<std::string, std::shared_ptr<OpKernelBin>>> &kernels,
+                         const std::function<Status(size_t, void *&)> &prepare);
+
   ///
   /// @ingroup ge
   /// @brief Erase TBE registered handle record.
@@ -88,11 +110,23 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
   void EraseTBEHandle(const std::map<std::string, uint32_t> &names);
 
  private:
+  using HandleMap = std::unordered_map<std::string, std::shared_ptr<TbeHandleInfo>>;
+
+  struct Shard {
+    // Writers of the shard are serialized by mutex, handle infos are changed only with it held
+    std::mutex mutex;
+    // Replaced by a new map on insertion and erasure, so that readers load it without the mutex
+    std::shared_ptr<const HandleMap> kernels = std::make_shared<const HandleMap>();
+  };
+
   TBEHandleStore() = default;
   ~TBEHandleStore() = default;
 
-  std::mutex mutex_;
-  std::unordered_map<std::string, TbeHandleInfo> kernels_;
+  Shard &GetShard(const std::string &name);
+  static std::shared_ptr<const HandleMap> LoadKernels(const Shard &shard);
+
+  static const size_t kShardNum = 16;
+  Shard shards_[kShardNum];
 };
 }  // namespace ge
 
@@ -0,0 +1,571 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/manager/graph_exec_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/string_util.h"
+#include "external/ge/ge_api_types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/ge_local_context.h"
+#include "graph/model_serialize.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "graph/utils/type_utils.h"
+#include "securec.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace ge {
+namespace {
+const size_t kBucketFieldNum = 3;
+const size_t kOutputDimFieldNum = 4;
+
+bool ParseInt64(const string &str, int64_t &value) {
+  if (str.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  value = std::strtoll(str.c_str(), &end, 10);
+  return (end != nullptr) && (*end == '\0');
+}
+
+uint64_t GetTimeUs() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+// Copy the leading block of copy_dims from src of src_dims to dst of dst_dims, row by row on the last dim.
+void CopyBlock(const uint8_t *src, const vector<int64_t> &src_dims, uint8_t *dst, const vector<int64_t> &dst_dims,
+               const vector<int64_t> &copy_dims, size_t elem_size) {
+  size_t dim_num = copy_dims.size();
+  if (dim_num == 0) {
+    (void)memcpy_s(dst, elem_size, src, elem_size);
+    return;
+  }
+  vector<int64_t> src_strides(dim_num, 1);
+  vector<int64_t> dst_strides(dim_num, 1);
+  int64_t row_num = 1;
+  for (size_t i = dim_num - 1; i > 0; --i) {
+    src_strides[i - 1] = src_strides[i] * src_dims[i];
+    dst_strides[i - 1] = dst_strides[i] * dst_dims[i];
+    row_num *= copy_dims[i - 1];
+  }
+  size_t row_size = static_cast<size_t>(copy_dims[dim_num - 1]) * elem_size;
+  for (int64_t row = 0; row < row_num; ++row) {
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    int64_t rest = row;
+    for (size_t i = dim_num - 1; i > 0; --i) {
+      int64_t index = rest % copy_dims[i - 1];
+      rest /= copy_dims[i - 1];
+      src_offset += index * src_strides[i - 1];
+      dst_offset += index * dst_strides[i - 1];
+    }
+    (void)memcpy_s(dst + dst_offset * elem_size, row_size, src + src_offset * elem_size, row_size);
+  }
+}
+
+Status CheckTensorData(const GeTensor &tensor, const vector<int64_t> &dims, uint32_t &elem_size) {
+  DataType data_type = tensor.GetTensorDesc().GetDataType();
+  if (!TypeUtils::GetDataTypeLength(data_type, elem_size)) {
+    GELOGE(PARAM_INVALID, "Data type %s is not supported.", TypeUtils::DataTypeToSerialString(data_type).c_str());
+    return PARAM_INVALID;
+  }
+  int64_t shape_size = GeShape(dims).GetShapeSize();
+  if (dims.empty()) {
+    shape_size = 1;
+  }
+  if (shape_size < 0 || tensor.GetData().GetSize() != static_cast<size_t>(shape_size) * elem_size) {
+    GELOGE(PARAM_INVALID, "Tensor data size %zu does not match shape size %ld.", tensor.GetData().GetSize(),
+           shape_size);
+    return PARAM_INVALID;
+  }
+  return SUCCESS;
+}
+
+void SetTensorShape(const vector<int64_t> &dims, size_t data_size, GeTensorDesc &desc) {
+  desc.SetShape(GeShape(dims));
+  desc.SetOriginShape(GeShape(dims));
+  TensorUtils::SetSize(desc, static_cast<uint32_t>(data_size));
+}
+}  // namespace
+
+Status ShapeBucketer::Init(const string &buckets) {
+  buckets_.clear();
+  for (const auto &item : StringUtils::Split(buckets, ';')) {
+    if (item.empty()) {
+      continue;
+    }
+    vector<string> fields = StringUtils::Split(item, ':');
+    int64_t input_index = 0;
+    int64_t dim_index = 0;
+    if (fields.size() != kBucketFieldNum || !ParseInt64(fields[0], input_index) || !ParseInt64(fields[1], dim_index) ||
+        input_index < 0 || dim_index < 0) {
+      GELOGE(PARAM_INVALID, "Invalid shape bucket %s, it should be input_index:dim_index:b1,b2,...", item.c_str());
+      return PARAM_INVALID;
+    }
+    vector<int64_t> bounds;
+    for (const auto &bound_str : StringUtils::Split(fields[2], ',')) {
+      int64_t bound = 0;
+      if (!ParseInt64(bound_str, bound) || bound <= 0 || (!bounds.empty() && bound <= bounds.back())) {
+        GELOGE(PARAM_INVALID, "Boundaries of shape bucket %s should be positive and ascending.", item.c_str());
+        return PARAM_INVALID;
+      }
+      bounds.push_back(bound);
+    }
+    if (bounds.empty()) {
+      GELOGE(PARAM_INVALID, "Shape bucket %s has no boundary.", item.c_str());
+      return PARAM_INVALID;
+    }
+    buckets_[static_cast<size_t>(input_index)][static_cast<size_t>(dim_index)] = bounds;
+  }
+  GELOGI("Init %zu bucketed inputs from %s.", buckets_.size(), buckets.c_str());
+  return SUCCESS;
+}
+
+void ShapeBucketer::GetBucketShapes(const vector<GeTensor> &inputs, vector<vector<int64_t>> &shapes) const {
+  shapes.clear();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    vector<int64_t> dims = inputs[i].GetTensorDesc().GetShape().GetDims();
+    auto iter = buckets_.find(i);
+    if (iter != buckets_.end()) {
+      for (const auto &dim_bounds : iter->second) {
+        if (dim_bounds.first >= dims.size()) {
+          continue;
+        }
+        const vector<int64_t> &bounds = dim_bounds.second;
+        auto bound = std::lower_bound(bounds.begin(), bounds.end(), dims[dim_bounds.first]);
+        if (bound != bounds.end()) {
+          dims[dim_bounds.first] = *bound;
+        }
+      }
+    }
+    shapes.push_back(dims);
+  }
+}
+
+bool ShapeBucketer::GetNextBucketShapes(const vector<vector<int64_t>> &shapes,
+                                        vector<vector<int64_t>> &next_shapes) const {
+  next_shapes = shapes;
+  bool grown = false;
+  for (const auto &input_buckets : buckets_) {
+    if (input_buckets.first >= next_shapes.size()) {
+      continue;
+    }
+    vector<int64_t> &dims = next_shapes[input_buckets.first];
+    for (const auto &dim_bounds : input_buckets.second) {
+      if (dim_bounds.first >= dims.size()) {
+        continue;
+      }
+      const vector<int64_t> &bounds = dim_bounds.second;
+      auto bound = std::upper_bound(bounds.begin(), bounds.end(), dims[dim_bounds.first]);
+      if (bound != bounds.end()) {
+        dims[dim_bounds.first] = *bound;
+        grown = true;
+      }
+    }
+  }
+  return grown;
+}
+
+Status ShapeBucketer::PadTensor(const GeTensor &src, const vector<int64_t> &dims, GeTensor &dst) {
+  vector<int64_t> src_dims = src.GetTensorDesc().GetShape().GetDims();
+  if (src_dims.size() != dims.size()) {
+    GELOGE(PARAM_INVALID, "Pad tensor of %zu dims to %zu dims.", src_dims.size(), dims.size());
+    return PARAM_INVALID;
+  }
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (dims[i] < src_dims[i]) {
+      GELOGE(PARAM_INVALID, "Dim %zu of tensor is %ld, which can not be padded to %ld.", i, src_dims[i], dims[i]);
+      return PARAM_INVALID;
+    }
+  }
+  uint32_t elem_size = 0;
+  GE_CHK_STATUS_RET(CheckTensorData(src, src_dims, elem_size), "Check tensor to pad failed.");
+
+  int64_t shape_size = dims.empty() ? 1 : GeShape(dims).GetShapeSize();
+  vector<uint8_t> data(static_cast<size_t>(shape_size) * elem_size, 0);
+  if (!data.empty() && GeShape(src_dims).GetShapeSize() != 0) {
+    CopyBlock(src.GetData().GetData(), src_dims, data.data(), dims, src_dims, elem_size);
+  }
+
+  GeTensorDesc desc = src.GetTensorDesc();
+  SetTensorShape(dims, data.size(), desc);
+  dst.SetTensorDesc(desc);
+  (void)dst.SetData(std::move(data));
+  return SUCCESS;
+}
+
+Status ShapeBucketer::SliceTensor(const GeTensor &src, const vector<int64_t> &dims, GeTensor &dst) {
+  vector<int64_t> src_dims = src.GetTensorDesc().GetShape().GetDims();
+  if (src_dims.size() != dims.size()) {
+    GELOGE(PARAM_INVALID, "Slice tensor of %zu dims to %zu dims.", src_dims.size(), dims.size());
+    return PARAM_INVALID;
+  }
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (dims[i] > src_dims[i] || dims[i] < 0) {
+      GELOGE(PARAM_INVALID, "Dim %zu of tensor is %ld, which can not be sliced to %ld.", i, src_dims[i], dims[i]);
+      return PARAM_INVALID;
+    }
+  }
+  uint32_t elem_size = 0;
+  GE_CHK_STATUS_RET(CheckTensorData(src, src_dims, elem_size), "Check tensor to slice failed.");
+
+  int64_t shape_size = dims.empty() ? 1 : GeShape(dims).GetShapeSize();
+  vector<uint8_t> data(static_cast<size_t>(shape_size) * elem_size, 0);
+  if (!data.empty()) {
+    CopyBlock(src.GetData().GetData(), src_dims, data.data(), dims, dims, elem_size);
+  }
+
+  GeTensorDesc desc = src.GetTensorDesc();
+  SetTensorShape(dims, data.size(), desc);
+  dst.SetTensorDesc(desc);
+  (void)dst.SetData(std::move(data));
+  return SUCCESS;
+}
+
+GraphExecCache::GraphExecCache(GraphId graph_id, const GraphExecCacheOptions &options, Compiler compiler,
+                               Unloader unloader)
+    : graph_id_(graph_id), options_(options), compiler_(std::move(compiler)), unloader_(std::move(unloader)) {}
+
+GraphExecCache::~GraphExecCache() { Clear(); }
+
+Status GraphExecCache::Init(const ComputeGraphPtr &compute_graph, const map<string, string> &graph_options) {
+  GE_CHECK_NOTNULL(compute_graph);
+  GE_CHK_STATUS_RET(bucketer_.Init(options_.buckets), "Init shape buckets of graph %u failed.", graph_id_);
+  GE_CHK_STATUS_RET(ParseOutputDims(), "Init output dims of graph %u failed.", graph_id_);
+
+  ModelSerialize serialize;
+  Buffer buffer = serialize.SerializeGraph(compute_graph);
+  if (buffer.GetSize() == 0) {
+    GELOGE(FAILED, "Serialize graph %u failed.", graph_id_);
+    return FAILED;
+  }
+  graph_buffer_.assign(buffer.GetData(), buffer.GetData() + buffer.GetSize());
+  graph_options_ = graph_options;
+
+  if (options_.precompile) {
+    precompile_pool_.reset(new (std::nothrow) ThreadPool(1));
+    GE_CHECK_NOTNULL(precompile_pool_);
+  }
+  GELOGI("Init executable cache of graph %u, mem limit %lu, precompile %d.", graph_id_, options_.mem_limit,
+         options_.precompile);
+  return SUCCESS;
+}
+
+Status GraphExecCache::ParseOutputDims() {
+  output_dims_.clear();
+  for (const auto &item : StringUtils::Split(options_.output_dims, ';')) {
+    if (item.empty()) {
+      continue;
+    }
+    vector<string> fields = StringUtils::Split(item, ':');
+    vector<int64_t> indexes(kOutputDimFieldNum, 0);
+    bool valid = (fields.size() == kOutputDimFieldNum);
+    for (size_t i = 0; valid && i < kOutputDimFieldNum; ++i) {
+      valid = ParseInt64(fields[i], indexes[i]) && indexes[i] >= 0;
+    }
+    if (!valid) {
+      GELOGE(PARAM_INVALID, "Invalid output dim %s, it should be output_index:dim_index:input_index:input_dim_index",
+             item.c_str());
+      return PARAM_INVALID;
+    }
+    output_dims_[static_cast<size_t>(indexes[0])][static_cast<size_t>(indexes[1])] =
+      std::make_pair(static_cast<size_t>(indexes[2]), static_cast<size_t>(indexes[3]));
+  }
+  return SUCCESS;
+}
+
+string GraphExecCache::GetSignature(const vector<GeTensor> &inputs, const vector<vector<int64_t>> &shapes) {
+  string signature;
+  for (size_t i = 0; i < inputs.size() && i < shapes.size(); ++i) {
+    signature += std::to_string(static_cast<int>(inputs[i].GetTensorDesc().GetDataType()));
+    signature += ":";
+    for (int64_t dim : shapes[i]) {
+      signature += std::to_string(dim);
+      signature += ",";
+    }
+    signature += ";";
+  }
+  return signature;
+}
+
+vector<GeTensor> GraphExecCache::MakeInputDescs(const vector<GeTensor> &inputs,
+                                                const vector<vector<int64_t>> &shapes) {
+  vector<GeTensor> input_descs;
+  for (size_t i = 0; i < inputs.size() && i < shapes.size(); ++i) {
+    GeTensorDesc desc = inputs[i].GetTensorDesc();
+    uint32_t elem_size = 0;
+    (void)TypeUtils::GetDataTypeLength(desc.GetDataType(), elem_size);
+    int64_t shape_size = shapes[i].empty() ? 1 : GeShape(shapes[i]).GetShapeSize();
+    SetTensorShape(shapes[i], static_cast<size_t>(shape_size) * elem_size, desc);
+    input_descs.emplace_back(desc);
+  }
+  return input_descs;
+}
+
+Status GraphExecCache::Build(const vector<GeTensor> &inputs, bool is_precompile, GraphNodePtr &graph_node) {
+  ModelSerialize serialize;
+  ComputeGraphPtr compute_graph = serialize.UnserializeGraph(graph_buffer_.data(), graph_buffer_.size());
+  GE_CHECK_NOTNULL(compute_graph);
+  compute_graph->SetGraphID(graph_id_);
+  auto graph = MakeShared<Graph>(GraphUtils::CreateGraphFromComputeGraph(compute_graph));
+  GE_CHECK_NOTNULL(graph);
+  graph_node = MakeShared<GraphNode>(graph_id_);
+  GE_CHECK_NOTNULL(graph_node);
+  graph_node->SetGraph(graph);
+  graph_node->SetOptions(graph_options_);
+
+  Status ret = compiler_(graph_node, inputs, is_precompile);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Build graph %u for shape bucket failed.", graph_id_);
+    unloader_(graph_node);
+    graph_node = nullptr;
+    return ret;
+  }
+  graph_node->SetBuildFlag(true);
+  return SUCCESS;
+}
+
+void GraphExecCache::Insert(const string &signature, const GraphNodePtr &graph_node, bool precompiled) {
+  CacheEntry entry;
+  entry.graph_node = graph_node;
+  auto ge_model = graph_node->GetGeModel();
+  if (ge_model != nullptr) {
+    int64_t memory_size = 0;
+    (void)AttrUtils::GetInt(ge_model, ATTR_MODEL_MEMORY_SIZE, memory_size);
+    entry.mem_size = static_cast<uint64_t>(std::max<int64_t>(memory_size, 0)) + ge_model->GetWeight().GetSize();
+  }
+  entry.last_use = ++use_tick_;
+  entry.precompiled = precompiled;
+  entries_[signature] = entry;
+  mem_size_ += entry.mem_size;
+
+  // Unload least recently used models until the budget holds, the active one and the new one are kept.
+  while (options_.mem_limit > 0 && mem_size_ > options_.mem_limit) {
+    auto victim = entries_.end();
+    for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
+      if (iter->first == active_signature_ || iter->first == signature) {
+        continue;
+      }
+      if (victim == entries_.end() || iter->second.last_use < victim->second.last_use) {
+        victim = iter;
+      }
+    }
+    if (victim == entries_.end()) {
+      GELOGW("Executable cache of graph %u uses %lu bytes over limit %lu, no model can be evicted.", graph_id_,
+             mem_size_, options_.mem_limit);
+      break;
+    }
+    GELOGI("Evict shape bucket %s of graph %u, %lu bytes.", victim->first.c_str(), graph_id_, victim->second.mem_size);
+    unloader_(victim->second.graph_node);
+    mem_size_ -= victim->second.mem_size;
+    entries_.erase(victim);
+    ++stats_.evict_count;
+  }
+}
+
+void GraphExecCache::Precompile(const vector<GeTensor> &inputs, const vector<vector<int64_t>> &shapes) {
+  vector<vector<int64_t>> next_shapes;
+  if (precompile_pool_ == nullptr || !bucketer_.GetNextBucketShapes(shapes, next_shapes)) {
+    return;
+  }
+  string signature = GetSignature(inputs, next_shapes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.count(signature) > 0 || pending_.count(signature) > 0) {
+    return;
+  }
+
+  vector<GeTensor> input_descs = MakeInputDescs(inputs, next_shapes);
+  auto build_task = [this, signature, input_descs](const GEThreadLocalContext &context) -> Status {
+    GetThreadLocalContext() = context;
+    GraphNodePtr graph_node = nullptr;
+    Status ret = Build(input_descs, true, graph_node);
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(signature);
+    if (ret == SUCCESS) {
+      Insert(signature, graph_node, true);
+    }
+    return ret;
+  };
+  std::future<Status> f = precompile_pool_->commit(build_task, GetThreadLocalContext());
+  if (!f.valid()) {
+    GELOGW("Commit precompile of shape bucket %s failed.", signature.c_str());
+    return;
+  }
+  pending_[signature] = f.share();
+  ++stats_.precompile_count;
+  GELOGI("Precompile shape bucket %s of graph %u.", signature.c_str(), graph_id_);
+}
+
+Status GraphExecCache::Acquire(const vector<GeTensor> &inputs, vector<GeTensor> &padded_inputs,
+                               GraphNodePtr &graph_node) {
+  vector<vector<int64_t>> shapes;
+  bucketer_.GetBucketShapes(inputs, shapes);
+  padded_inputs.clear();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (shapes[i] == inputs[i].GetTensorDesc().GetShape().GetDims()) {
+      padded_inputs.emplace_back(inputs[i]);
+      continue;
+    }
+    GeTensor padded_input;
+    GE_CHK_STATUS_RET(ShapeBucketer::PadTensor(inputs[i], shapes[i], padded_input), "Pad input %zu failed.", i);
+    padded_inputs.emplace_back(padded_input);
+  }
+  string signature = GetSignature(inputs, shapes);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto pending = pending_.find(signature);
+  if (pending != pending_.end()) {
+    // Wait for the background build of this bucket rather than building it twice.
+    std::shared_future<Status> f = pending->second;
+    lock.unlock();
+    uint64_t start = GetTimeUs();
+    Status ret = f.get();
+    lock.lock();
+    ++stats_.stall_count;
+    stats_.stall_time_us += GetTimeUs() - start;
+    if (ret != SUCCESS) {
+      GELOGW("Precompile of shape bucket %s failed, build it again.", signature.c_str());
+    }
+  }
+
+  auto iter = entries_.find(signature);
+  if (iter != entries_.end()) {
+    ++stats_.hit_count;
+    if (iter->second.precompiled) {
+      ++stats_.precompile_hit_count;
+      iter->second.precompiled = false;
+    }
+    iter->second.last_use = ++use_tick_;
+    active_signature_ = signature;
+    graph_node = iter->second.graph_node;
+    GELOGD("Hit shape bucket %s of graph %u.", signature.c_str(), graph_id_);
+  } else {
+    ++stats_.miss_count;
+    lock.unlock();
+    GELOGI("Miss shape bucket %s of graph %u, build it.", signature.c_str(), graph_id_);
+    uint64_t start = GetTimeUs();
+    GE_CHK_STATUS_RET(Build(padded_inputs, false, graph_node), "Build shape bucket %s failed.", signature.c_str());
+    lock.lock();
+    ++stats_.stall_count;
+    stats_.stall_time_us += GetTimeUs() - start;
+    active_signature_ = signature;
+    Insert(signature, graph_node, false);
+  }
+  lock.unlock();
+
+  if (options_.precompile) {
+    Precompile(inputs, shapes);
+  }
+  return SUCCESS;
+}
+
+Status GraphExecCache::UnpadOutputs(const vector<GeTensor> &inputs, const vector<GeTensor> &padded_inputs,
+                                    const vector<GeTensor> &padded_outputs, vector<GeTensor> &outputs) const {
+  bool is_padded = false;
+  for (size_t i = 0; i < inputs.size() && i < padded_inputs.size(); ++i) {
+    if (inputs[i].GetTensorDesc().GetShape().GetDims() != padded_inputs[i].GetTensorDesc().GetShape().GetDims()) {
+      is_padded = true;
+    }
+  }
+  if (!is_padded) {
+    outputs = padded_outputs;
+    return SUCCESS;
+  }
+  // Which output dims follow padded inputs is not known from shapes, so it must be given.
+  if (output_dims_.empty()) {
+    GELOGE(PARAM_INVALID, "Inputs of graph %u are padded, but option %s is not given to slice outputs back.",
+           graph_id_, SHAPE_CACHE_OUTPUT_DIMS.c_str());
+    return PARAM_INVALID;
+  }
+
+  outputs.clear();
+  for (size_t i = 0; i < padded_outputs.size(); ++i) {
+    auto output_iter = output_dims_.find(i);
+    if (output_iter == output_dims_.end()) {
+      outputs.emplace_back(padded_outputs[i]);
+      continue;
+    }
+    vector<int64_t> dims = padded_outputs[i].GetTensorDesc().GetShape().GetDims();
+    for (const auto &dim_map : output_iter->second) {
+      size_t dim_index = dim_map.first;
+      size_t input_index = dim_map.second.first;
+      size_t input_dim_index = dim_map.second.second;
+      if (dim_index >= dims.size() || input_index >= inputs.size() || input_index >= padded_inputs.size()) {
+        GELOGE(PARAM_INVALID, "Dim %zu of output %zu or input %zu of graph %u does not exist.", dim_index, i,
+               input_index, graph_id_);
+        return PARAM_INVALID;
+      }
+      vector<int64_t> input_dims = inputs[input_index].GetTensorDesc().GetShape().GetDims();
+      vector<int64_t> padded_dims = padded_inputs[input_index].GetTensorDesc().GetShape().GetDims();
+      if (input_dim_index >= input_dims.size() || input_dim_index >= padded_dims.size()) {
+        GELOGE(PARAM_INVALID, "Dim %zu of input %zu of graph %u does not exist.", input_dim_index, input_index,
+               graph_id_);
+        return PARAM_INVALID;
+      }
+      if (dims[dim_index] != padded_dims[input_dim_index]) {
+        GELOGE(PARAM_INVALID, "Dim %zu of output %zu is %ld, not dim %zu of input %zu padded to %ld.",
+               dim_index, i, dims[dim_index], input_dim_index, input_index, padded_dims[input_dim_index]);
+        return PARAM_INVALID;
+      }
+      dims[dim_index] = input_dims[input_dim_index];
+    }
+    if (dims == padded_outputs[i].GetTensorDesc().GetShape().GetDims()) {
+      outputs.emplace_back(padded_outputs[i]);
+      continue;
+    }
+    GeTensor output;
+    GE_CHK_STATUS_RET(ShapeBucketer::SliceTensor(padded_outputs[i], dims, output), "Slice output %zu failed.", i);
+    outputs.emplace_back(output);
+  }
+  return SUCCESS;
+}
+
+void GraphExecCache::Clear() {
+  // Tasks of the pool are done before it is destroyed.
+  precompile_pool_.reset();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stats_.hit_count + stats_.miss_count > 0) {
+    GEEVENT("[GEPERFTRACE] Shape cache of graph %u: hit %lu, miss %lu, stall %lu (%lu us), precompile %lu "
+            "(used %lu), evict %lu, %zu models of %lu bytes.",
+            graph_id_, stats_.hit_count, stats_.miss_count, stats_.stall_count, stats_.stall_time_us,
+            stats_.precompile_count, stats_.precompile_hit_count, stats_.evict_count, entries_.size(), mem_size_);
+  }
+  for (auto &entry : entries_) {
+    unloader_(entry.second.graph_node);
+  }
+  entries_.clear();
+  pending_.clear();
+  active_signature_.clear();
+  mem_size_ = 0;
+}
+
+void GraphExecCache::GetStats(GraphExecCacheStats &stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats = stats_;
+}
+}  // namespace ge
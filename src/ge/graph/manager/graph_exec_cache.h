@@ -0,0 +1,161 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_MANAGER_GRAPH_EXEC_CACHE_H_
+#define GE_GRAPH_MANAGER_GRAPH_EXEC_CACHE_H_
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/thread_pool.h"
+#include "framework/common/ge_inner_error_codes.h"
+#include "graph/ge_tensor.h"
+#include "graph/manager/graph_manager_utils.h"
+
+namespace ge {
+///
+/// Round dims of graph inputs up to bucket boundaries, so that inputs of nearby shapes share one built model.
+///
+class ShapeBucketer {
+ public:
+  ///
+  /// @ingroup ge
+  /// @brief Parse buckets of the form "input_index:dim_index:b1,b2,...;...", boundaries are ascending.
+  ///
+  Status Init(const std::string &buckets);
+
+  // Shapes of inputs rounded up to buckets, dims larger than the largest boundary are kept.
+  void GetBucketShapes(const std::vector<GeTensor> &inputs, std::vector<std::vector<int64_t>> &shapes) const;
+
+  // Shapes with every bucketed dim moved to its next boundary, false if no dim can grow.
+  bool GetNextBucketShapes(const std::vector<std::vector<int64_t>> &shapes,
+                           std::vector<std::vector<int64_t>> &next_shapes) const;
+
+  // Copy src into dst of dims, dims are not smaller than those of src and the rest is filled with 0.
+  static Status PadTensor(const GeTensor &src, const std::vector<int64_t> &dims, GeTensor &dst);
+
+  // Copy the leading part of src of dims into dst.
+  static Status SliceTensor(const GeTensor &src, const std::vector<int64_t> &dims, GeTensor &dst);
+
+ private:
+  // <input index, <dim index, boundaries>>
+  std::map<size_t, std::map<size_t, std::vector<int64_t>>> buckets_;
+};
+
+struct GraphExecCacheOptions {
+  std::string buckets;
+  // Output dims following padded input dims, "output_index:dim_index:input_index:input_dim_index;..."
+  std::string output_dims;
+  uint64_t mem_limit = 0;  // Device memory budget of built models, 0 means no limit
+  bool precompile = false;  // Build the next larger bucket in background after a miss
+};
+
+struct GraphExecCacheStats {
+  uint64_t hit_count = 0;
+  uint64_t miss_count = 0;
+  uint64_t stall_count = 0;  // Runs which waited for a build, in foreground or in background
+  uint64_t stall_time_us = 0;
+  uint64_t precompile_count = 0;
+  uint64_t precompile_hit_count = 0;  // Precompiled models which are used later
+  uint64_t evict_count = 0;
+};
+
+///
+/// Built models of one graph keyed by bucketed input shapes. Inputs are padded to their bucket before running,
+/// and outputs are sliced back. Least recently used models are unloaded when the memory budget is exceeded.
+///
+class GraphExecCache {
+ public:
+  // Build and load the graph of graph_node with inputs, the last argument tells if it runs in the precompile thread.
+  using Compiler = std::function<Status(const GraphNodePtr &, const std::vector<GeTensor> &, bool)>;
+  // Unload the models of a built graph_node.
+  using Unloader = std::function<void(const GraphNodePtr &)>;
+
+  GraphExecCache(GraphId graph_id, const GraphExecCacheOptions &options, Compiler compiler, Unloader unloader);
+  ~GraphExecCache();
+
+  GraphExecCache(const GraphExecCache &) = delete;
+  GraphExecCache &operator=(const GraphExecCache &) = delete;
+
+  // Keep a copy of the graph before any build, every bucket is built from it.
+  Status Init(const ComputeGraphPtr &compute_graph, const std::map<std::string, std::string> &graph_options);
+
+  ///
+  /// @ingroup ge
+  /// @brief Get graph node built for the bucket of inputs, and inputs padded to the bucket.
+  ///
+  Status Acquire(const std::vector<GeTensor> &inputs, std::vector<GeTensor> &padded_inputs, GraphNodePtr &graph_node);
+
+  ///
+  /// @ingroup ge
+  /// @brief Slice outputs back on dims which follow padded input dims by the output dims option.
+  ///        Outputs of padded inputs are refused if the option is not given.
+  ///
+  Status UnpadOutputs(const std::vector<GeTensor> &inputs, const std::vector<GeTensor> &padded_inputs,
+                      const std::vector<GeTensor> &padded_outputs, std::vector<GeTensor> &outputs) const;
+
+  // Wait for background builds and unload all built models.
+  void Clear();
+
+  void GetStats(GraphExecCacheStats &stats);
+
+ private:
+  struct CacheEntry {
+    GraphNodePtr graph_node;
+    uint64_t mem_size = 0;
+    uint64_t last_use = 0;
+    bool precompiled = false;  // Built in background and not used yet
+  };
+
+  static std::string GetSignature(const std::vector<GeTensor> &inputs, const std::vector<std::vector<int64_t>> &shapes);
+  static std::vector<GeTensor> MakeInputDescs(const std::vector<GeTensor> &inputs,
+                                              const std::vector<std::vector<int64_t>> &shapes);
+
+  Status ParseOutputDims();
+  Status Build(const std::vector<GeTensor> &inputs, bool is_precompile, GraphNodePtr &graph_node);
+  void Insert(const std::string &signature, const GraphNodePtr &graph_node, bool precompiled);
+  void Precompile(const std::vector<GeTensor> &inputs, const std::vector<std::vector<int64_t>> &shapes);
+
+  GraphId graph_id_;
+  GraphExecCacheOptions options_;
+  ShapeBucketer bucketer_;
+  // <output index, <dim index, <input index, input dim index>>>
+  std::map<size_t, std::map<size_t, std::pair<size_t, size_t>>> output_dims_;
+  Compiler compiler_;
+  Unloader unloader_;
+  std::map<std::string, std::string> graph_options_;
+  // Graph serialized before any build
+  std::vector<uint8_t> graph_buffer_;
+
+  std::mutex mutex_;
+  std::map<std::string, CacheEntry> entries_;
+  // <signature, background build>
+  std::map<std::string, std::shared_future<Status>> pending_;
+  // Entry of the last Acquire, which may be running and is never evicted.
+  std::string active_signature_;
+  uint64_t mem_size_ = 0;
+  uint64_t use_tick_ = 0;
+  GraphExecCacheStats stats_;
+  std::unique_ptr<ThreadPool> precompile_pool_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_MANAGER_GRAPH_EXEC_CACHE_H_
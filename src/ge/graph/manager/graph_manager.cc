@@ -25,6 +25,7 @@
 #include <thread>
 #include <utility>
 
+#include "common/build_tracer.h"
 #include "common/ge/ge_util.h"
 #include "common/math/math_util.h"
 #include "common/thread_pool.h"
@@ -37,6 +38,7 @@
 #include "graph/debug/ge_attr_define.h"
 #include "graph/ge_context.h"
 #include "graph/ge_global_options.h"
+#include "graph/graph_arena.h"
 #include "graph/ge_local_context.h"
 #include "graph/manager/graph_mem_allocator.h"
 #include "graph/passes/atomic_addr_clean_pass.h"
@@ -69,6 +71,7 @@ const char *const kNetOutput = "NetOutput";
 const char *const kVariable = "Variable";
 const char *const kSend = "Send";
 const char *const kRecv = "Recv";
+const uint64_t kMegaByte = 1024 * 1024;
 }  // namespace
 
 namespace ge {
@@ -146,6 +149,14 @@ Status GraphManager::Finalize() {
     run_thread_.join();
   }
 
+  std::map<GraphId, std::shared_ptr<GraphExecCache>> exec_caches;
+  {
+    std::lock_guard<std::mutex> lock(exec_cache_mutex_);
+    exec_caches.swap(exec_caches_);
+  }
+  // Caches wait for their background builds when they are destroyed, which is out of the lock.
+  exec_caches.clear();
+
   // check graph whether running or not
   Status unload_model_ret = SUCCESS;
   Status ret;
@@ -264,6 +275,7 @@ Status GraphManager::MergeSubGraph(ComputeGraphPtr &compute_graph, const std::ve
 Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<GeTensor> &inputs,
                             vector<GeModelPtr> &ge_models, GeModelPtr &ge_model, uint64_t session_id) {
   GELOGI("Ready For PreRun Start session_id = %lu.", session_id);
+  std::lock_guard<std::mutex> lock(build_mutex_);
   GE_TIMESTAMP_START(PreRun);
   GE_CHECK_NOTNULL(graph_node);
   // it will not execute graph preprocess, optimize, parition, build if the graph has built successful.
@@ -284,6 +296,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
     return ret;
   }
   GE_TIMESTAMP_END(GraphPrepare, "GraphPrepare::Prepare");
+  GE_TRACE_COUNTER("graph_node_num", static_cast<int64_t>(compute_graph->GetDirectNodesSize()));
   compute_graph->SetSessionID(session_id);
   GraphUtils::DumpGEGraph(compute_graph, "OptimizeOriginalGraphAfter");
   GraphUtils::DumpGEGraphToOnnx(*compute_graph, "OptimizeOriginalGraphAfter");
@@ -294,6 +307,14 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
                      GELOGE(GE_GRAPH_INFERSHAPE_FAILED, " OriginGraph infershape failed");
                      return GE_GRAPH_INFERSHAPE_FAILED;)
   GE_TIMESTAMP_END(InferShape, "ComputeGraph::InferShapeInNeed");
+  // Graphs created by the build from here on share one arena, which is released with them when the graph is
+  // rebuilt or removed. The user's graph lives across builds and stays on heap, as freed blocks are not reused.
+  std::shared_ptr<GraphArena> arena = nullptr;
+  if (options_.graph_arena_flag) {
+    arena = MakeShared<GraphArena>();
+    GE_CHECK_NOTNULL(arena);
+  }
+  GraphArenaScope arena_scope(arena);
   // graph partition
   std::vector<SubGraphInfoPtr> sub_graph_list;
   GE_TIMESTAMP_START(GraphPartition);
@@ -303,6 +324,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
     return ret;
   }
   GE_TIMESTAMP_END(GraphPartition, "GraphPartitioner::Partition1");
+  GE_TRACE_COUNTER("sub_graph_num", static_cast<int64_t>(sub_graph_list.size()));
   GE_TIMESTAMP_START(SetSubgraph);
   // use default 16 multi thread
   const uint32_t thread_num = 16;
@@ -338,6 +360,7 @@ Status GraphManager::PreRun(const GraphNodePtr &graph_node, const std::vector<Ge
   merged_compute_graph->SetSessionID(session_id);
   merged_compute_graph->SetGraphID(graph_node->GetGraphId());
   GE_TIMESTAMP_END(MergeSubgraph, "GraphManager::MergeSubGraph");
+  GE_TRACE_COUNTER("graph_node_num", static_cast<int64_t>(merged_compute_graph->GetDirectNodesSize()));
 
   GraphUtils::DumpGEGraph(merged_compute_graph, "mergedComputeGraph");
   GraphUtils::DumpGEGraphToOnnx(*merged_compute_graph, "mergedComputeGraph");
@@ -525,6 +548,17 @@ Status GraphManager::RunGraph(const GraphId &graph_id, const std::vector<GeTenso
     graph_optimize_.TranFrameOp(compute_graph_tmp);
   }
 
+  if (options_.shape_cache_flag && options_.run_graph_flag && !GetTrainFlag()) {
+    ret = RunGraphWithShapeCache(graph_node, inputs, outputs, session_id);
+    graph_node->SetRunFlag(false);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "[RunGraph] run graph with shape cache failed, graph_id = %u.", graph_id);
+      return ret;
+    }
+    GELOGI("[RunGraph] run graph success, graph_id = %u.", graph_id);
+    return SUCCESS;
+  }
+
   ret = StartForRunGraph(graph_node, inputs, ge_models, session_id);
   if (ret != SUCCESS) {
     GELOGE(ret, "[RunGraph] StartForRunGraph failed!");
@@ -563,6 +597,95 @@ Status GraphManager::RunGraph(const GraphId &graph_id, const std::vector<GeTenso
   return SUCCESS;
 }
 
+Status GraphManager::RunGraphWithShapeCache(const GraphNodePtr &graph_node, const std::vector<GeTensor> &inputs,
+                                            std::vector<GeTensor> &outputs, uint64_t session_id) {
+  std::shared_ptr<GraphExecCache> exec_cache = nullptr;
+  GE_CHK_STATUS_RET(GetExecCache(graph_node, session_id, exec_cache), "Get executable cache failed.");
+
+  std::vector<GeTensor> padded_inputs;
+  GraphNodePtr exec_node = nullptr;
+  GE_TIMESTAMP_START(AcquireExecCache);
+  GE_CHK_STATUS_RET(exec_cache->Acquire(inputs, padded_inputs, exec_node), "Acquire executable cache failed.");
+  GE_TIMESTAMP_END(AcquireExecCache, "GraphExecCache::Acquire");
+
+  std::vector<GeTensor> padded_outputs;
+  exec_node->SetRunFlag(true);
+  GE_CHK_STATUS_RET(InnerRunGraph(exec_node, graph_node->GetGraphId(), padded_inputs, padded_outputs),
+                    "Run graph of shape bucket failed.");
+  return exec_cache->UnpadOutputs(inputs, padded_inputs, padded_outputs, outputs);
+}
+
+Status GraphManager::GetExecCache(const GraphNodePtr &graph_node, uint64_t session_id,
+                                  std::shared_ptr<GraphExecCache> &exec_cache) {
+  GraphId graph_id = graph_node->GetGraphId();
+  std::lock_guard<std::mutex> lock(exec_cache_mutex_);
+  auto iter = exec_caches_.find(graph_id);
+  if (iter != exec_caches_.end()) {
+    exec_cache = iter->second;
+    return SUCCESS;
+  }
+
+  GraphExecCacheOptions cache_options;
+  cache_options.buckets = options_.shape_buckets;
+  cache_options.output_dims = options_.shape_cache_output_dims;
+  cache_options.mem_limit = static_cast<uint64_t>(std::max(options_.shape_cache_mem_limit, 0)) * kMegaByte;
+  cache_options.precompile = options_.shape_cache_precompile;
+  auto compiler = [this, session_id](const GraphNodePtr &node, const std::vector<GeTensor> &inputs,
+                                     bool is_precompile) -> Status {
+    // A foreground build runs on the device of the caller, only the precompile thread sets the device itself.
+    if (is_precompile) {
+      rtError_t rt_ret = rtSetDevice(GetContext().DeviceId());
+      if (rt_ret != RT_ERROR_NONE) {
+        GELOGE(RT_FAILED, "rtSetDevice failed, graph_id = %u.", node->GetGraphId());
+        return RT_FAILED;
+      }
+    }
+    std::vector<GeModelPtr> ge_models;
+    GeModelPtr ge_model = nullptr;
+    Status ret = PreRun(node, inputs, ge_models, ge_model, session_id);
+    if (ret == SUCCESS) {
+      ret = LoadGraph(ge_model, node);
+    }
+    if (is_precompile) {
+      (void)rtDeviceReset(GetContext().DeviceId());
+    }
+    return ret;
+  };
+  auto unloader = [this](const GraphNodePtr &node) { UnloadExecGraphNode(node); };
+
+  exec_cache = MakeShared<GraphExecCache>(graph_id, cache_options, compiler, unloader);
+  GE_CHECK_NOTNULL(exec_cache);
+  GE_CHECK_NOTNULL(graph_node->GetGraph());
+  GE_CHK_STATUS_RET(exec_cache->Init(GraphUtils::GetComputeGraph(*graph_node->GetGraph()), graph_node->GetOptions()),
+                    "Init executable cache of graph %u failed.", graph_id);
+  exec_caches_[graph_id] = exec_cache;
+  return SUCCESS;
+}
+
+void GraphManager::UnloadExecGraphNode(const GraphNodePtr &graph_node) {
+  if (graph_node == nullptr) {
+    return;
+  }
+  for (const auto &sub_graph : graph_node->GetAllSubGraph()) {
+    if (sub_graph->FreeInOutBuffer() != SUCCESS) {
+      GELOGW("Free buffer of graph %u failed.", graph_node->GetGraphId());
+    }
+  }
+  auto ge_model = graph_node->GetGeModel();
+  if (ge_model == nullptr || ge_model->GetModelId() == INVALID_MODEL_ID || !graph_node->GetLoadFlag()) {
+    return;
+  }
+  if (rtSetDevice(GetContext().DeviceId()) != RT_ERROR_NONE) {
+    GELOGW("rtSetDevice failed, modelId=%u, graphId=%u.", ge_model->GetModelId(), graph_node->GetGraphId());
+    return;
+  }
+  if (GraphLoader::UnloadModel(ge_model->GetModelId()) != SUCCESS) {
+    GELOGW("Unload model failed, modelId=%u, graphId=%u.", ge_model->GetModelId(), graph_node->GetGraphId());
+  }
+  graph_node->SetLoadFlag(false);
+  (void)rtDeviceReset(GetContext().DeviceId());
+}
+
 Status GraphManager::BuildGraph(const GraphId &graph_id, const std::vector<GeTensor> &inputs,
                                 std::vector<GeModelPtr> &models) {
   GELOGI("[BuildGraph] start to build graph, graph_id=%u.", graph_id);
@@ -647,6 +770,17 @@ Status GraphManager::RemoveGraph(const GraphId &graph_id) {
     GELOGE(GE_GRAPH_GRAPH_IS_RUNNING, "[GraphManager] Id %u is running, can't be deleted.", graph_id);
     return GE_GRAPH_GRAPH_IS_RUNNING;
   }
+  std::shared_ptr<GraphExecCache> exec_cache = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(exec_cache_mutex_);
+    auto cache_iter = exec_caches_.find(graph_id);
+    if (cache_iter != exec_caches_.end()) {
+      exec_cache = cache_iter->second;
+      (void)exec_caches_.erase(cache_iter);
+    }
+  }
+  // Waits for background builds of the cache out of the lock.
+  exec_cache.reset();
   Status ret = SUCCESS;
   Status middle_ret;
   rtError_t rt_ret;
@@ -837,6 +971,24 @@ Status GraphManager::ParseOptions(const std::map<std::string, std::string> &opti
   // Original model file name
   ParseOption(options, ORIGINAL_MODEL_FILE, options_.original_model_file);
 
+  // allocate graph objects of each build from an arena
+  GE_CHK_STATUS_RET(ParseOption(options, GRAPH_ARENA_FLAG, options_.graph_arena_flag), "Parse %s failed.",
+                    GRAPH_ARENA_FLAG.c_str());
+
+  // shape bucketed executable cache
+  GE_CHK_STATUS_RET(ParseOption(options, SHAPE_CACHE_FLAG, options_.shape_cache_flag), "Parse %s failed.",
+                    SHAPE_CACHE_FLAG.c_str());
+  ParseOption(options, SHAPE_BUCKETS, options_.shape_buckets);
+  ParseOption(options, SHAPE_CACHE_OUTPUT_DIMS, options_.shape_cache_output_dims);
+  ret = ParseOption(options, SHAPE_CACHE_MEM_LIMIT, options_.shape_cache_mem_limit);
+  if ((ret != SUCCESS) || (options_.shape_cache_mem_limit < 0)) {
+    GELOGE(GE_GRAPH_OPTIONS_INVALID, "Key:%s value is invalid, must be non-negative int32_t.",
+           SHAPE_CACHE_MEM_LIMIT.c_str());
+    return GE_GRAPH_OPTIONS_INVALID;
+  }
+  GE_CHK_STATUS_RET(ParseOption(options, SHAPE_CACHE_PRECOMPILE, options_.shape_cache_precompile),
+                    "Parse %s failed.", SHAPE_CACHE_PRECOMPILE.c_str());
+
   return SUCCESS;
 }
 
@@ -1411,7 +1563,10 @@ Status GraphManager::OptimizeAfterMergeSubGraph(ge::ComputeGraphPtr &compute_gra
   names_to_passes.emplace_back("ReshapeRemovePass", &trans_op_nearby_allreduce_fusion_pass);
   ReshapeRemovePass reshape_remove_pass;
   names_to_passes.emplace_back("ReshapeRemovePass", &reshape_remove_pass);
-  ConstantFoldingPass constant_folding_pass;
+  // Constant subgraphs are evaluated in parallel ahead, ConstantFoldingPass only replaces them with the results.
+  ConstantFoldingEngine constant_folding_engine;
+  GE_CHK_STATUS_RET(constant_folding_engine.Run(compute_graph), "Run constant folding engine failed.");
+  ConstantFoldingPass constant_folding_pass(&constant_folding_engine);
   names_to_passes.emplace_back("ConstantFoldingPass", &constant_folding_pass);
   DimensionAdjustPass dimension_adjust_pass;
   names_to_passes.emplace_back("DimensionAdjustPass", &dimension_adjust_pass);
@@ -1422,6 +1577,8 @@ Status GraphManager::OptimizeAfterMergeSubGraph(ge::ComputeGraphPtr &compute_gra
     GELOGE(ret, "Run ge_passes optimize for OptimizeAfterMergeSubGraph failed, ret:%d.", ret);
     return ret;
   }
+  GEEVENT("[GEPERFTRACE] %zu of %zu nodes evaluated by constant folding engine are folded.",
+          constant_folding_engine.GetTakenNum(), constant_folding_engine.GetEvaluatedNum());
 
   ResetConstType(compute_graph);
 
@@ -1558,7 +1715,12 @@ Status GraphManager::ProcessSubGraphWithMultiThreads(GraphManager *graph_manager
     GraphUtils::DumpGEGraph(compute_graph_tmp, "OptimizeSubGraphBefore");
     GraphUtils::DumpGEGraphToOnnx(*compute_graph_tmp, "OptimizeSubGraphBefore");
     GE_CHECK_NOTNULL(compute_graph_tmp);
+    GE_TRACE_SCOPE(OptimizeSubGraph, "GraphOptimize::OptimizeSubGraph");
+    GE_TRACE_ARG(OptimizeSubGraph, "graph", compute_graph_tmp->GetName());
+    GE_TRACE_ARG(OptimizeSubGraph, "engine", engine_name);
+    GE_TRACE_ARG(OptimizeSubGraph, "node_num", static_cast<int64_t>(compute_graph_tmp->GetDirectNodesSize()));
     compute_graph_tmp->SetSessionID(session_id);
+    GraphArenaScope arena_scope(compute_graph_tmp->GetArena());
     ret = graph_manager->graph_optimize_.OptimizeSubGraph(compute_graph_tmp, engine_name);
     if (ret != SUCCESS) {
       GELOGE(ret, "SubGraph optimize Failed %s", engine_name.c_str());
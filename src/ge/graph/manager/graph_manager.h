@@ -33,6 +33,7 @@
 #include "graph/execute/graph_execute.h"
 #include "graph/ge_local_context.h"
 #include "graph/load/graph_loader.h"
+#include "graph/manager/graph_exec_cache.h"
 #include "graph/manager/graph_manager_utils.h"
 #include "graph/manager/util/variable_accelerate_ctrl.h"
 #include "graph/optimize/graph_optimize.h"
@@ -186,6 +187,16 @@ class GraphManager {
   Status InnerRunGraph(GraphNodePtr &graph_node, const GraphId &graph_id, const std::vector<GeTensor> &inputs,
                        std::vector<GeTensor> &outputs);
 
+  // Run the model built for the shape bucket of inputs, see SHAPE_CACHE_FLAG.
+  Status RunGraphWithShapeCache(const GraphNodePtr &graph_node, const std::vector<GeTensor> &inputs,
+                                std::vector<GeTensor> &outputs, uint64_t session_id);
+
+  Status GetExecCache(const GraphNodePtr &graph_node, uint64_t session_id,
+                      std::shared_ptr<GraphExecCache> &exec_cache);
+
+  // Free buffers and unload models of a graph node which is built by an executable cache.
+  void UnloadExecGraphNode(const GraphNodePtr &graph_node);
+
   Status ParseOptions(const std::map<std::string, std::string> &options);
 
   static void ParseOption(const std::map<std::string, std::string> &options, const std::string &key,
@@ -296,6 +307,12 @@ class GraphManager {
   VarAccelerateCtrl var_acc_ctrl_;
 
   std::mutex run_mutex_;
+  // PreRun may be called by precompile threads of executable caches.
+  std::mutex build_mutex_;
+
+  // Destroyed first, precompile threads of caches use the members above.
+  std::mutex exec_cache_mutex_;
+  std::map<GraphId, std::shared_ptr<GraphExecCache>> exec_caches_;
 };
 };  // namespace ge
 
@@ -237,6 +237,12 @@ struct GraphManagerOptions {
   std::string output_datatype;
   std::string original_model_file;
   bool save_original_model;
+  bool shape_cache_flag;
+  std::string shape_buckets;
+  std::string shape_cache_output_dims;
+  int shape_cache_mem_limit;
+  bool shape_cache_precompile;
+  bool graph_arena_flag;
   GraphManagerOptions()
       : stream_num(1),
         perf_level(domi::GEN_TASK_WITHOUT_FUSION),
@@ -257,7 +263,13 @@ struct GraphManagerOptions {
         local_fmk_op_flag(false),
         hcom_parallel(false),
         enable_print_op_pass(true),
-        save_original_model(false) {}
+        save_original_model(false),
+        shape_cache_flag(false),
+        shape_buckets(""),
+        shape_cache_output_dims(""),
+        shape_cache_mem_limit(0),
+        shape_cache_precompile(false),
+        graph_arena_flag(false) {}
 };
 }  // namespace ge
 
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/manager/host_mem_pool.h"
+
+#include "framework/common/debug/ge_log.h"
+#include "runtime/mem.h"
+
+namespace ge {
+namespace {
+const uint64_t kMinBlockSize = 4096;
+// Size classes in every power of two
+const uint64_t kSizeClassNum = 4;
+}  // namespace
+
+HostMemPool &HostMemPool::Instance() {
+  // Buffers hold the pool, so it outlives the ones released after exit
+  static std::shared_ptr<HostMemPool> instance(new HostMemPool());
+  return *instance;
+}
+
+HostMemPool::~HostMemPool() { Release(); }
+
+uint64_t HostMemPool::GetBlockSize(uint64_t size) {
+  if (size <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  // Largest power of two less than size
+  uint64_t power = kMinBlockSize;
+  while ((power << 1) < size) {
+    power <<= 1;
+  }
+  uint64_t step = power / kSizeClassNum;
+  return (size + step - 1) / step * step;
+}
+
+HostBufferPtr HostMemPool::Malloc(uint64_t size, bool keep_idle) {
+  uint64_t block_size = GetBlockSize(size);
+  uint8_t *addr = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = idle_blocks_.find(block_size);
+    if (iter != idle_blocks_.end() && !iter->second.empty()) {
+      addr = iter->second.back();
+      iter->second.pop_back();
+      stats_.reuse_count++;
+      stats_.idle_bytes -= block_size;
+    } else {
+      rtError_t rt_ret = rtMallocHost(reinterpret_cast<void **>(&addr), block_size);
+      if (rt_ret != RT_ERROR_NONE || addr == nullptr) {
+        GELOGE(RT_FAILED, "Malloc host memory of size %lu failed, ret: 0x%X", block_size, rt_ret);
+        return nullptr;
+      }
+      stats_.malloc_count++;
+    }
+    stats_.in_use_bytes += block_size;
+  }
+
+  auto pool = shared_from_this();
+  return HostBufferPtr(addr,
+                       [pool, block_size, keep_idle](uint8_t *block) { pool->Free(block, block_size, keep_idle); });
+}
+
+void HostMemPool::Free(uint8_t *addr, uint64_t block_size, bool keep_idle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.in_use_bytes -= block_size;
+  if (keep_idle && stats_.idle_bytes + block_size <= idle_limit_) {
+    idle_blocks_[block_size].push_back(addr);
+    stats_.idle_bytes += block_size;
+    return;
+  }
+  rtError_t rt_ret = rtFreeHost(addr);
+  if (rt_ret != RT_ERROR_NONE) {
+    GELOGE(RT_FAILED, "Free host memory of size %lu failed, ret: 0x%X", block_size, rt_ret);
+  }
+  stats_.free_count++;
+}
+
+void HostMemPool::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &blocks : idle_blocks_) {
+    for (auto addr : blocks.second) {
+      rtError_t rt_ret = rtFreeHost(addr);
+      if (rt_ret != RT_ERROR_NONE) {
+        GELOGE(RT_FAILED, "Free host memory of size %lu failed, ret: 0x%X", blocks.first, rt_ret);
+      }
+      stats_.free_count++;
+    }
+  }
+  idle_blocks_.clear();
+  stats_.idle_bytes = 0;
+}
+
+void HostMemPool::SetIdleLimit(uint64_t idle_limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_limit_ = idle_limit;
+}
+
+void HostMemPool::GetStats(HostMemPoolStats &stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats = stats_;
+}
+}  // namespace ge
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_MANAGER_HOST_MEM_POOL_H_
+#define GE_GRAPH_MANAGER_HOST_MEM_POOL_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+
+namespace ge {
+// Pinned host buffer, it is returned to the pool when the last reference is released
+using HostBufferPtr = std::shared_ptr<uint8_t>;
+
+struct HostMemPoolStats {
+  // Number of rtMallocHost and rtFreeHost called
+  uint64_t malloc_count = 0;
+  uint64_t free_count = 0;
+  // Number of buffers taken from idle blocks
+  uint64_t reuse_count = 0;
+  uint64_t idle_bytes = 0;
+  uint64_t in_use_bytes = 0;
+};
+
+///
+/// @ingroup ge_graph
+/// @brief Pool of pinned host memory shared by all graphs.
+///        Sizes are rounded up to size classes, four for every power of two, and released blocks are kept idle for
+///        the next request of the same class until idle bytes reach the limit.
+///
+class HostMemPool : public std::enable_shared_from_this<HostMemPool> {
+ public:
+  static HostMemPool &Instance();
+
+  ~HostMemPool();
+
+  HostMemPool(const HostMemPool &) = delete;
+  HostMemPool &operator=(const HostMemPool &) = delete;
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief malloc pinned host memory
+  /// @param [in] size memory size
+  /// @param [in] keep_idle whether the block is kept idle when the buffer is released, or freed for one-off buffers
+  /// @return buffer of at least size bytes, nullptr if failed
+  ///
+  HostBufferPtr Malloc(uint64_t size, bool keep_idle = true);
+
+  // Free all idle blocks, buffers in use are still returned to the pool later.
+  void Release();
+
+  void SetIdleLimit(uint64_t idle_limit);
+
+  void GetStats(HostMemPoolStats &stats);
+
+  static uint64_t GetBlockSize(uint64_t size);
+
+ private:
+  HostMemPool() = default;
+
+  void Free(uint8_t *addr, uint64_t block_size, bool keep_idle);
+
+  std::mutex mutex_;
+  // Idle blocks by block size
+  std::map<uint64_t, std::vector<uint8_t *>> idle_blocks_;
+  uint64_t idle_limit_ = 256ULL * 1024 * 1024;
+  HostMemPoolStats stats_;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_MANAGER_HOST_MEM_POOL_H_
@@ -16,17 +16,349 @@
 
 #include "graph/manager/trans_var_data_utils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+
 #include "common/debug/log.h"
 #include "common/debug/memory_dumper.h"
 #include "common/formats/formats.h"
 #include "common/formats/utils/formats_trans_utils.h"
 #include "common/op/ge_op_utils.h"
+#include "common/thread_pool.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/manager/graph_var_manager.h"
+#include "graph/manager/host_mem_pool.h"
 #include "graph/types.h"
 #include "graph/utils/type_utils.h"
 
 namespace ge {
+namespace {
+///
+/// MemResource::AssignVarMem rounds the size of a variable up to 512 bytes and leaves 512 + 512 bytes after it, so the
+/// gap between two adjacent variables is less than 3 * 512 bytes. Such gaps are padding only, which is copied together
+/// with the variables to save calls of rtMemcpy.
+///
+const uint64_t kMaxCopyGap = kSessionMemAlignSize * 3;
+
+// Device memory copied in one rtMemcpy, and its offset in host staging buffer
+struct CopyRange {
+  uint8_t *dev_addr;
+  uint64_t host_offset;
+  uint64_t size;
+};
+
+struct VarTransBatch {
+  // Tasks in order of src address
+  std::vector<size_t> indexes;
+  std::vector<uint64_t> src_offsets;
+  std::vector<uint64_t> dst_offsets;
+  // Gap after dst of each task in its store range, which is filled with zero
+  std::vector<uint64_t> dst_gaps;
+  std::vector<CopyRange> load_ranges;
+  std::vector<CopyRange> store_ranges;
+  // Results not in dst size are copied alone after store ranges
+  std::vector<formats::TransResult> results;
+  uint64_t src_size = 0;
+  uint64_t dst_size = 0;
+  uint64_t load_size = 0;
+  uint64_t store_size = 0;
+};
+
+uint64_t ElapsedUs(const std::chrono::steady_clock::time_point &start) {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Add memory of dev_addr to ranges, returns its offset in host staging buffer
+uint64_t AddCopyRange(uint8_t *dev_addr, uint64_t size, std::vector<CopyRange> &ranges, uint64_t &total_size) {
+  if (!ranges.empty()) {
+    CopyRange &last = ranges.back();
+    uint8_t *last_end = last.dev_addr + last.size;
+    if (dev_addr >= last_end && static_cast<uint64_t>(dev_addr - last_end) < kMaxCopyGap) {
+      uint64_t offset = last.host_offset + static_cast<uint64_t>(dev_addr - last.dev_addr);
+      total_size += static_cast<uint64_t>(dev_addr - last_end) + size;
+      last.size = static_cast<uint64_t>(dev_addr - last.dev_addr) + size;
+      return offset;
+    }
+  }
+  ranges.push_back({dev_addr, total_size, size});
+  total_size += size;
+  return ranges.back().host_offset;
+}
+
+Status CheckVarTransTasks(const std::vector<VarTransTask> &tasks) {
+  std::vector<std::pair<uint8_t *, size_t>> src_addrs;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    const VarTransTask &task = tasks[i];
+    GE_CHK_BOOL_RET_STATUS(task.trans_road != nullptr && task.src_addr != nullptr && task.dst_addr != nullptr &&
+                             task.src_size > 0 && task.dst_size > 0,
+                           PARAM_INVALID, "Invalid trans task of var %s.", task.var_name.c_str());
+    src_addrs.emplace_back(task.src_addr, i);
+  }
+  std::sort(src_addrs.begin(), src_addrs.end());
+
+  // Dst of a variable is written before src of variables in next batches is read
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    const VarTransTask &task = tasks[i];
+    auto dst_end = std::make_pair(task.dst_addr + task.dst_size, static_cast<size_t>(0));
+    auto iter = std::lower_bound(src_addrs.begin(), src_addrs.end(), dst_end);
+    while (iter != src_addrs.begin()) {
+      --iter;
+      const VarTransTask &src_task = tasks[iter->second];
+      if (src_task.src_addr + src_task.src_size <= task.dst_addr) {
+        break;
+      }
+      GE_CHK_BOOL_RET_STATUS(iter->second == i, PARAM_INVALID, "Dst of var %s overlaps src of var %s.",
+                             task.var_name.c_str(), src_task.var_name.c_str());
+    }
+  }
+  return SUCCESS;
+}
+
+void PlanVarTransBatches(const std::vector<VarTransTask> &tasks, uint64_t staging_size,
+                         std::vector<VarTransBatch> &batches) {
+  std::vector<size_t> indexes(tasks.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    indexes[i] = i;
+  }
+  std::sort(indexes.begin(), indexes.end(),
+            [&tasks](size_t lhs, size_t rhs) { return tasks[lhs].src_addr < tasks[rhs].src_addr; });
+
+  VarTransBatch batch;
+  for (auto index : indexes) {
+    const VarTransTask &task = tasks[index];
+    if (!batch.indexes.empty() &&
+        (batch.src_size + task.src_size > staging_size || batch.dst_size + task.dst_size > staging_size)) {
+      batches.push_back(std::move(batch));
+      batch = VarTransBatch();
+    }
+    batch.indexes.push_back(index);
+    batch.src_offsets.push_back(AddCopyRange(task.src_addr, task.src_size, batch.load_ranges, batch.load_size));
+    batch.src_size += task.src_size;
+    batch.dst_size += task.dst_size;
+  }
+  if (!batch.indexes.empty()) {
+    batches.push_back(std::move(batch));
+  }
+
+  for (auto &plan : batches) {
+    std::vector<size_t> positions(plan.indexes.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+      positions[i] = i;
+    }
+    std::sort(positions.begin(), positions.end(), [&tasks, &plan](size_t lhs, size_t rhs) {
+      return tasks[plan.indexes[lhs]].dst_addr < tasks[plan.indexes[rhs]].dst_addr;
+    });
+    plan.dst_offsets.resize(positions.size());
+    plan.dst_gaps.assign(positions.size(), 0);
+    plan.results.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+      const VarTransTask &task = tasks[plan.indexes[positions[i]]];
+      size_t range_num = plan.store_ranges.size();
+      plan.dst_offsets[positions[i]] = AddCopyRange(task.dst_addr, task.dst_size, plan.store_ranges, plan.store_size);
+      if (i > 0 && plan.store_ranges.size() == range_num) {
+        size_t last = positions[i - 1];
+        uint64_t last_end = plan.dst_offsets[last] + tasks[plan.indexes[last]].dst_size;
+        plan.dst_gaps[last] = plan.dst_offsets[positions[i]] - last_end;
+      }
+    }
+  }
+}
+
+Status CopyRanges(const std::vector<CopyRange> &ranges, uint8_t *host_addr, bool to_host, VarTransStats &stats) {
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &range : ranges) {
+    if (to_host) {
+      GE_CHK_RT_RET(
+        rtMemcpy(host_addr + range.host_offset, range.size, range.dev_addr, range.size, RT_MEMCPY_DEVICE_TO_HOST));
+    } else {
+      GE_CHK_RT_RET(
+        rtMemcpy(range.dev_addr, range.size, host_addr + range.host_offset, range.size, RT_MEMCPY_HOST_TO_DEVICE));
+    }
+  }
+  stats.copy_num += static_cast<uint32_t>(ranges.size());
+  stats.copy_time_us += ElapsedUs(start);
+  return SUCCESS;
+}
+
+Status StoreBatch(const std::vector<VarTransTask> &tasks, VarTransBatch &batch, uint8_t *host_addr,
+                  VarTransStats &stats) {
+  GE_CHK_STATUS_RET(CopyRanges(batch.store_ranges, host_addr, false, stats), "Copy vars to device failed.");
+  for (size_t i = 0; i < batch.results.size(); ++i) {
+    formats::TransResult &result = batch.results[i];
+    if (result.data == nullptr) {
+      continue;
+    }
+    const VarTransTask &task = tasks[batch.indexes[i]];
+    GELOGW("Size %zu of var %s after trans is not %lu.", result.length, task.var_name.c_str(), task.dst_size);
+    GE_CHK_RT_RET(rtMemcpy(task.dst_addr, result.length, result.data.get(), result.length, RT_MEMCPY_HOST_TO_DEVICE));
+    stats.copy_num++;
+    result = formats::TransResult();
+  }
+  return SUCCESS;
+}
+
+Status TransBatch(const std::vector<VarTransTask> &tasks, VarTransBatch &batch, const uint8_t *src_host_addr,
+                  uint8_t *dst_host_addr, std::atomic<size_t> &next) {
+  size_t i = 0;
+  while ((i = next++) < batch.indexes.size()) {
+    const VarTransTask &task = tasks[batch.indexes[i]];
+    formats::TransResult result;
+    Status ret = TransVarDataUtils::TransVarOnHost(const_cast<uint8_t *>(src_host_addr + batch.src_offsets[i]),
+                                                   *task.trans_road, result);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Failed to trans var %s on host.", task.var_name.c_str());
+      return ret;
+    }
+    uint8_t *dst = dst_host_addr + batch.dst_offsets[i];
+    if (result.length == task.dst_size) {
+      GE_CHK_BOOL_RET_STATUS(memcpy_s(dst, task.dst_size, result.data.get(), result.length) == EOK, FAILED,
+                             "Copy var %s to staging failed.", task.var_name.c_str());
+    } else {
+      (void)memset_s(dst, task.dst_size, 0, task.dst_size);
+      batch.results[i] = result;
+    }
+    if (batch.dst_gaps[i] > 0) {
+      (void)memset_s(dst + task.dst_size, batch.dst_gaps[i], 0, batch.dst_gaps[i]);
+    }
+  }
+  return SUCCESS;
+}
+}  // namespace
+
+Status TransVarDataUtils::TransVarOnHost(uint8_t *var_data, const VarTransRoad &trans_road,
+                                         formats::TransResult &result) {
+  formats::TransResult resultLastTime{};
+  bool use_init_data = true;
+  for (const auto &trans_info : trans_road) {
+    if (trans_info.node_type == RESHAPE || trans_info.node_type == REFORMAT) {
+      GELOGD("Skip to trans variable data on the reshape/reformat node");
+      continue;
+    }
+    uint8_t *src_data = nullptr;
+    if (use_init_data) {
+      src_data = var_data;
+      use_init_data = false;
+    } else {
+      src_data = resultLastTime.data.get();
+    }
+
+    formats::TransResult tmp_result{};
+    if (trans_info.node_type == TRANSDATA) {
+      auto src_format = trans_info.input.GetFormat();
+      auto src_shape = trans_info.input.GetShape().GetDims();
+      auto dst_format = trans_info.output.GetFormat();
+      auto dst_shape = trans_info.output.GetShape().GetDims();
+      auto data_type = trans_info.input.GetDataType();
+      GELOGD("Trans format from %s to %s, shape %s to %s, data-type %s",
+             TypeUtils::FormatToSerialString(src_format).c_str(), TypeUtils::FormatToSerialString(dst_format).c_str(),
+             formats::ShapeToString(src_shape).c_str(), formats::ShapeToString(dst_shape).c_str(),
+             TypeUtils::DataTypeToSerialString(data_type).c_str());
+      auto ret = formats::TransFormat({src_data, src_format, dst_format, src_shape, dst_shape, data_type}, tmp_result);
+      if (ret != SUCCESS) {
+        GELOGE(INTERNAL_ERROR,
+               "Failed to trans format from %s to %s, shape %s to %s, "
+               "data type %s error code %u",
+               TypeUtils::FormatToSerialString(src_format).c_str(), TypeUtils::FormatToSerialString(dst_format).c_str(),
+               formats::ShapeToString(src_shape).c_str(), formats::ShapeToString(dst_shape).c_str(),
+               TypeUtils::DataTypeToSerialString(data_type).c_str(), ret);
+        return ret;
+      }
+    } else if (trans_info.node_type == CAST) {
+      auto input_shape = trans_info.input.GetShape();
+      auto src_data_size = input_shape.GetShapeSize();
+      auto src_data_type = trans_info.input.GetDataType();
+      auto dst_data_type = trans_info.output.GetDataType();
+      GELOGD("Trans data type from %s to %s, input shape %s, data size %ld",
+             TypeUtils::DataTypeToSerialString(src_data_type).c_str(),
+             TypeUtils::DataTypeToSerialString(dst_data_type).c_str(), formats::ShapeToString(input_shape).c_str(),
+             src_data_size);
+      auto ret = formats::TransDataType({src_data, static_cast<size_t>(src_data_size), src_data_type, dst_data_type},
+                                        tmp_result);
+      if (ret != SUCCESS) {
+        GELOGE(INTERNAL_ERROR, "Failed to trans data type from %s to %s, input shape %s, data size %ld, error code %u",
+               TypeUtils::DataTypeToSerialString(src_data_type).c_str(),
+               TypeUtils::DataTypeToSerialString(dst_data_type).c_str(), formats::ShapeToString(input_shape).c_str(),
+               src_data_size, ret);
+        return ret;
+      }
+    } else {
+      GELOGE(UNSUPPORTED, "Failed to trans var data, the trans type %s does not supported",
+             trans_info.node_type.c_str());
+      return UNSUPPORTED;
+    }
+    resultLastTime = tmp_result;
+  }
+
+  result = resultLastTime;
+  return SUCCESS;
+}
+
+Status TransVarDataUtils::TransVarDataBatch(const std::vector<VarTransTask> &tasks, uint32_t thread_num,
+                                            VarTransStats &stats, uint64_t staging_size) {
+  GE_CHK_BOOL_RET_STATUS(thread_num > 0 && staging_size > 0, PARAM_INVALID, "Invalid thread num or staging size.");
+  if (tasks.empty()) {
+    return SUCCESS;
+  }
+  GE_CHK_STATUS_RET(CheckVarTransTasks(tasks), "Check var trans tasks failed.");
+  std::vector<VarTransBatch> batches;
+  PlanVarTransBatches(tasks, staging_size, batches);
+  stats.batch_num = static_cast<uint32_t>(batches.size());
+
+  // Two buffers in each direction, batch N is transformed while N - 1 is copied to device and N + 1 to host
+  uint64_t load_size = 0;
+  uint64_t store_size = 0;
+  for (const auto &batch : batches) {
+    load_size = std::max(load_size, batch.load_size);
+    store_size = std::max(store_size, batch.store_size);
+  }
+  // Vars are transformed once after loading, so staging buffers are freed instead of kept idle in the pool
+  HostBufferPtr src_buffers[] = {HostMemPool::Instance().Malloc(load_size, false),
+                                 HostMemPool::Instance().Malloc(load_size, false)};
+  HostBufferPtr dst_buffers[] = {HostMemPool::Instance().Malloc(store_size, false),
+                                 HostMemPool::Instance().Malloc(store_size, false)};
+  for (size_t i = 0; i < 2; ++i) {
+    GE_CHK_BOOL_RET_STATUS(src_buffers[i] != nullptr && dst_buffers[i] != nullptr, MEMALLOC_FAILED,
+                           "Malloc staging buffers failed, size %lu and %lu.", load_size, store_size);
+  }
+
+  ThreadPool executor(thread_num);
+  GE_CHK_STATUS_RET(CopyRanges(batches[0].load_ranges, src_buffers[0].get(), true, stats), "Copy vars to host failed.");
+  for (size_t i = 0; i < batches.size(); ++i) {
+    VarTransBatch &batch = batches[i];
+    const uint8_t *src_host_addr = src_buffers[i % 2].get();
+    uint8_t *dst_host_addr = dst_buffers[i % 2].get();
+    std::atomic<size_t> next(0);
+    std::vector<std::future<Status>> futures;
+    for (uint32_t j = 0; j < thread_num && j < batch.indexes.size(); ++j) {
+      futures.push_back(executor.commit(TransBatch, std::cref(tasks), std::ref(batch), src_host_addr, dst_host_addr,
+                                        std::ref(next)));
+    }
+
+    Status ret = SUCCESS;
+    if (i > 0) {
+      ret = StoreBatch(tasks, batches[i - 1], dst_buffers[(i - 1) % 2].get(), stats);
+    }
+    if (ret == SUCCESS && i + 1 < batches.size()) {
+      ret = CopyRanges(batches[i + 1].load_ranges, src_buffers[(i + 1) % 2].get(), true, stats);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (auto &future : futures) {
+      Status trans_ret = future.valid() ? future.get() : FAILED;
+      ret = (ret == SUCCESS) ? trans_ret : ret;
+    }
+    stats.trans_wait_time_us += ElapsedUs(start);
+    GE_CHK_STATUS_RET(ret, "Trans batch %zu of vars failed.", i);
+  }
+  GE_CHK_STATUS_RET(StoreBatch(tasks, batches.back(), dst_buffers[(batches.size() - 1) % 2].get(), stats),
+                    "Copy vars to device failed.");
+  GELOGI("Trans %zu vars in %u batches, copy num %u, copy time %lu us, wait for trans %lu us.", tasks.size(),
+         stats.batch_num, stats.copy_num, stats.copy_time_us, stats.trans_wait_time_us);
+  return SUCCESS;
+}
+
 Status TransVarDataUtils::SyncVarData2BroadCast(const string &var_name, const ge::GeTensorDesc &src_tensor_desc,
                                                 uint8_t *dst_addr, uint32_t dst_addr_size, uint64_t session_id) {
   GE_CHK_BOOL_RET_STATUS(dst_addr != nullptr, FAILED, "dst addr is null. ");
@@ -18,14 +18,52 @@
 #define GE_GRAPH_MANAGER_TRANS_VAR_DATA_UTILS_H_
 
 #include <string>
+#include <vector>
 
+#include "common/formats/formats.h"
 #include "framework/common/ge_inner_error_codes.h"
 #include "framework/common/ge_types.h"
+#include "graph/manager/graph_var_manager.h"
 #include "graph/utils/tensor_utils.h"
 
 namespace ge {
+// A variable to read from src_addr on device, transform on host by trans_road, and write to dst_addr on device
+struct VarTransTask {
+  std::string var_name;
+  const VarTransRoad *trans_road = nullptr;
+  uint8_t *src_addr = nullptr;
+  uint64_t src_size = 0;
+  uint8_t *dst_addr = nullptr;
+  uint64_t dst_size = 0;
+};
+
+struct VarTransStats {
+  uint32_t batch_num = 0;
+  // Number of rtMemcpy called in both directions, adjacent variables are copied together
+  uint32_t copy_num = 0;
+  uint64_t copy_time_us = 0;
+  // Time waiting for transforms not overlapped by copies
+  uint64_t trans_wait_time_us = 0;
+};
+
 class TransVarDataUtils {
  public:
+  static Status TransVarOnHost(uint8_t *var_data, const VarTransRoad &trans_road, formats::TransResult &result);
+
+  ///
+  /// @ingroup ge_graph
+  /// @brief transform data of variables in batches
+  ///        Variables are copied to pinned host buffers of staging_size at most in each batch, transformed by
+  ///        thread_num threads, then copied back. Copies of a batch are done while the next batch is transformed.
+  /// @param [in] tasks variables to transform
+  /// @param [in] thread_num number of threads to transform
+  /// @param [out] stats
+  /// @param [in] staging_size size of data copied in one batch
+  /// @return Status result of function
+  ///
+  static Status TransVarDataBatch(const std::vector<VarTransTask> &tasks, uint32_t thread_num, VarTransStats &stats,
+                                  uint64_t staging_size = 16 * 1024 * 1024);
+
   static ge::Status SyncVarData2BroadCast(const string &var_name, const ge::GeTensorDesc &src_tensor_desc,
                                           uint8_t *dst_addr, uint32_t dst_addr_size, uint64_t session_id_);
   static ge::Status SyncBroadCastData2Var(uint8_t *src_addr, uint32_t src_addr_size, const string &var_name,
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include "common/op/ge_op_utils.h"
 #include "graph/utils/graph_utils.h"
 #include "graph/utils/op_desc_utils.h"
@@ -37,23 +38,36 @@ Status EnginePlacer::Run() {
     GELOGE(GE_CLI_GE_NOT_INITIALIZED, "Run enginePlacer failed");
     return FAILED;
   }
-  // Assign engine for each node in the graph
+  // Assign engines for nodes which have not been assigned in one go
+  std::vector<OpDescPtr> op_descs;
   for (const auto &node_ptr : compute_graph_->GetDirectNode()) {
     GE_CHECK_NOTNULL(node_ptr);
     GE_CHECK_NOTNULL(node_ptr->GetOpDesc());
+    if (node_ptr->GetOpDesc()->GetOpKernelLibName().empty()) {
+      op_descs.emplace_back(node_ptr->GetOpDesc());
+    }
+  }
+  std::vector<std::string> engine_names;
+  if (!op_descs.empty()) {
+    // Call placer cost model to get the "best" engine for these nodes
+    GE_CHK_STATUS_RET(instance_ptr->DNNEngineManagerObj().GetDNNEngineNames(op_descs, engine_names),
+                      "[GraphPartitioner]: Assign engines of %zu ops failed.", op_descs.size());
+  }
+
+  size_t place_index = 0;
+  for (const auto &node_ptr : compute_graph_->GetDirectNode()) {
     std::string engine_name;
     // Check if this node has assigned engine
-    if ((!node_ptr->GetOpDesc()->GetOpKernelLibName().empty())) {
-      engine_name = node_ptr->GetOpDesc()->GetOpEngineName();
-    } else {
-      // Call placer cost model to get the "best" engine for this node
-      engine_name = instance_ptr->DNNEngineManagerObj().GetDNNEngineName(node_ptr->GetOpDesc());
+    if ((place_index < op_descs.size()) && (node_ptr->GetOpDesc() == op_descs[place_index])) {
+      engine_name = engine_names[place_index++];
       // If can't get op's engine name, return failed
       if (engine_name.empty()) {
         GELOGE(GE_CLI_GE_NOT_INITIALIZED, "Can not find engine of op type %s",
                node_ptr->GetOpDesc()->GetType().c_str());
         return FAILED;
       }
+    } else {
+      engine_name = node_ptr->GetOpDesc()->GetOpEngineName();
     }
     if (AssignEngineAndLog(node_ptr, engine_name) != SUCCESS) {
       GELOGE(GE_GRAPH_ASSIGN_ENGINE_FAILED, "[GraphPartitioner]: AssignEngineAndLog FAILED");
@@ -19,6 +19,7 @@
 #include <queue>
 #include <unordered_set>
 
+#include "common/build_tracer.h"
 #include "common/debug/log.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/compute_graph.h"
@@ -63,14 +64,17 @@ void AddNextIterNodes(const Node::Vistor<NodePtr> &nodes, std::queue<NodePtr> &n
   }
 }
 
+// Time of each pass is added to pass_time_us if it is not null
 Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unordered_set<NodePtr> &nodes_re_pass,
-                 std::unordered_set<Node *> &nodes_deleted, std::unordered_set<Node *> &nodes_seen) {
+                 std::unordered_set<Node *> &nodes_deleted, std::unordered_set<Node *> &nodes_seen,
+                 std::vector<uint64_t> *pass_time_us) {
   if (node == nullptr) {
     GELOGE(FAILED, "parameter is null.");
     return FAILED;
   }
   GELOGD("Begin to run pass for node %s", node->GetName().c_str());
-  for (const auto &name_to_pass : names_to_passes) {
+  for (size_t i = 0; i < names_to_passes.size(); ++i) {
+    const auto &name_to_pass = names_to_passes[i];
     if (name_to_pass.second == nullptr) {
       GELOGE(INTERNAL_ERROR, "There is null pointer in passes(%s), skip it", name_to_pass.first.c_str());
       continue;
@@ -78,7 +82,11 @@ Status RunPasses(NodePtr &node, const NamesToPass &names_to_passes, std::unorder
 
     GELOGD("Begin to run pass %s", name_to_pass.first.c_str());
     name_to_pass.second->init();
+    uint64_t start_us = (pass_time_us != nullptr) ? GetCurrentTimestap() : 0;
     auto result = name_to_pass.second->Run(node);
+    if (pass_time_us != nullptr) {
+      (*pass_time_us)[i] += GetCurrentTimestap() - start_us;
+    }
     if (result != SUCCESS) {
       GELOGE(INTERNAL_ERROR,
              "Failed to process pass %s on node %s, result "
@@ -160,6 +168,11 @@ Status GEPass::Run(const NamesToPass &names_to_passes) {
   std::unordered_set<Node *> nodes_deleted;
   std::unordered_set<NodePtr> nodes_re_pass;
   std::unordered_set<NodePtr> nodes_last;
+  GE_TRACE_SCOPE(GEPass, "GEPass::Run");
+  std::vector<uint64_t> pass_time_us;
+  if (trace_scope_GEPass.IsActive()) {
+    pass_time_us.resize(names_to_passes.size(), 0);
+  }
   GetAllNodesNoInputEdge(graph_, nodes, nodes_seen, nodes_last);
   GELOGD("Start points count %zu", nodes.size());
   int re_pass_times = 0;
@@ -184,7 +197,8 @@ Status GEPass::Run(const NamesToPass &names_to_passes) {
 
       AddNextIterNodes(node->GetOutNodes(), nodes, nodes_seen, nodes_last);
 
-      auto ret = RunPasses(node, names_to_passes, nodes_re_pass, nodes_deleted, nodes_seen);
+      auto ret = RunPasses(node, names_to_passes, nodes_re_pass, nodes_deleted, nodes_seen,
+                           pass_time_us.empty() ? nullptr : &pass_time_us);
       if (ret != SUCCESS) {
         GELOGE(INTERNAL_ERROR,
                "Failed to process passes on node %s type %s,"
@@ -207,6 +221,14 @@ Status GEPass::Run(const NamesToPass &names_to_passes) {
     GELOGW("re_pass_times should not come to %d", kMaxRePassTimes);
   }
   GELOGD("All passes runs end");
+  if (trace_scope_GEPass.IsActive()) {
+    trace_scope_GEPass.AddArg("graph", graph_->GetName());
+    trace_scope_GEPass.AddArg("node_num", static_cast<int64_t>(nodes_seen.size()));
+    trace_scope_GEPass.AddArg("re_pass_times", static_cast<int64_t>(re_pass_times));
+    for (size_t i = 0; i < names_to_passes.size(); ++i) {
+      trace_scope_GEPass.AddArg((names_to_passes[i].first + "_us").c_str(), static_cast<int64_t>(pass_time_us[i]));
+    }
+  }
 
   return SUCCESS;
 }
@@ -0,0 +1,319 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/constant_folding_engine.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+
+#include "common/ge/ge_util.h"
+#include "common/thread_pool.h"
+#include "common/types.h"
+#include "external/ge/ge_api_types.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/ge_context.h"
+#include "graph/passes/folding_pass.h"
+#include "graph/utils/op_desc_utils.h"
+
+namespace ge {
+namespace {
+const int64_t kMaxConstantFoldingThreadNum = 64;
+
+bool IsConstNode(const NodePtr &node) { return (node->GetType() == CONSTANT) || (node->GetType() == CONSTANTOP); }
+
+bool IsSameTensor(const ConstGeTensorPtr &left, const ConstGeTensorPtr &right) {
+  if (left == right) {
+    return true;
+  }
+  if (left == nullptr || right == nullptr) {
+    return false;
+  }
+  const GeTensorDesc &left_desc = left->GetTensorDesc();
+  const GeTensorDesc &right_desc = right->GetTensorDesc();
+  if ((left_desc.GetDataType() != right_desc.GetDataType()) || (left_desc.GetFormat() != right_desc.GetFormat()) ||
+      (left_desc.GetShape().GetDims() != right_desc.GetShape().GetDims())) {
+    return false;
+  }
+  const Buffer &left_data = left->GetData();
+  const Buffer &right_data = right->GetData();
+  if (left_data.size() != right_data.size()) {
+    return false;
+  }
+  return (left_data.size() == 0) || (memcmp(left_data.data(), right_data.data(), left_data.size()) == 0);
+}
+
+uint32_t GetConstantFoldingThreadNum() {
+  std::string thread_num_str;
+  if (GetContext().GetOption(CONSTANT_FOLDING_THREAD_NUM, thread_num_str) != GRAPH_SUCCESS ||
+      thread_num_str.empty()) {
+    return 1;
+  }
+  const int base = 10;
+  int64_t thread_num = std::strtol(thread_num_str.c_str(), nullptr, base);
+  if (thread_num <= 1) {
+    return 1;
+  }
+  return static_cast<uint32_t>(std::min<int64_t>(thread_num, kMaxConstantFoldingThreadNum));
+}
+
+size_t FindRoot(std::vector<size_t> &parents, size_t index) {
+  while (parents[index] != index) {
+    parents[index] = parents[parents[index]];
+    index = parents[index];
+  }
+  return index;
+}
+}  // namespace
+
+ConstantFoldingEngine::ConstantFoldingEngine() : thread_num_(GetConstantFoldingThreadNum()) {}
+
+ConstantFoldingEngine::ConstantFoldingEngine(uint32_t thread_num) : thread_num_(thread_num) {}
+
+Status ConstantFoldingEngine::Run(const ComputeGraphPtr &graph) {
+  GE_CHECK_NOTNULL(graph);
+  GE_TIMESTAMP_START(ConstantFoldingEngine);
+  slots_.clear();
+  slot_indexes_.clear();
+  evaluated_num_ = 0;
+  taken_num_ = 0;
+
+  size_t wave_num = 0;
+  size_t subgraph_num = 0;
+  GE_CHK_STATUS_RET(CollectSlots(graph, wave_num, subgraph_num), "Collect constant subgraphs of graph %s failed.",
+                    graph->GetName().c_str());
+  if (slots_.empty()) {
+    GELOGI("No constant subgraph to fold on host in graph %s.", graph->GetName().c_str());
+    return SUCCESS;
+  }
+
+  std::vector<std::vector<size_t>> waves(wave_num);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    waves[slots_[i].wave].emplace_back(i);
+  }
+
+  std::unique_ptr<ThreadPool> thread_pool;
+  for (const auto &wave : waves) {
+    // Inputs are prepared serially, weights of const nodes are shared by nodes of the same wave.
+    std::vector<size_t> ready_slots;
+    for (size_t index : wave) {
+      if (PrepareInputs(slots_[index])) {
+        ready_slots.emplace_back(index);
+      }
+    }
+    if ((ready_slots.size() > 1) && (thread_num_ > 1) && (thread_pool == nullptr)) {
+      thread_pool.reset(new (std::nothrow) ThreadPool(thread_num_));
+    }
+    GE_CHK_STATUS_RET(EvaluateWave(ready_slots, thread_pool.get()), "Evaluate constant subgraphs failed.");
+  }
+
+  for (const auto &slot : slots_) {
+    if (slot.evaluated) {
+      ++evaluated_num_;
+    }
+  }
+  GEEVENT("[GEPERFTRACE] Host constant folding of graph %s: %zu constant subgraphs, %zu foldable nodes in %zu waves, "
+          "%zu nodes evaluated.",
+          graph->GetName().c_str(), subgraph_num, slots_.size(), wave_num, evaluated_num_);
+  GE_TIMESTAMP_END(ConstantFoldingEngine, "ConstantFoldingEngine::Run");
+  return SUCCESS;
+}
+
+Status ConstantFoldingEngine::CollectSlots(const ComputeGraphPtr &graph, size_t &wave_num, size_t &subgraph_num) {
+  // Sort nodes topologically by data edges, only direct nodes are folded as ConstantFoldingPass does.
+  std::unordered_map<const Node *, size_t> in_degrees;
+  std::vector<NodePtr> topo_nodes;
+  for (const NodePtr &node : graph->GetDirectNode()) {
+    GE_CHECK_NOTNULL(node);
+    size_t in_degree = 0;
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      if ((in_anchor != nullptr) && (in_anchor->GetPeerOutAnchor() != nullptr)) {
+        ++in_degree;
+      }
+    }
+    in_degrees[node.get()] = in_degree;
+    if (in_degree == 0) {
+      topo_nodes.emplace_back(node);
+    }
+  }
+  for (size_t pos = 0; pos < topo_nodes.size(); ++pos) {
+    for (const auto &out_anchor : topo_nodes[pos]->GetAllOutDataAnchors()) {
+      for (const auto &peer_in_anchor : out_anchor->GetPeerInDataAnchors()) {
+        NodePtr out_node = peer_in_anchor->GetOwnerNode();
+        auto iter = in_degrees.find(out_node.get());
+        if ((iter != in_degrees.end()) && (--iter->second == 0)) {
+          topo_nodes.emplace_back(out_node);
+        }
+      }
+    }
+  }
+
+  std::vector<size_t> parents;
+  for (const NodePtr &node : topo_nodes) {
+    OpDescPtr op_desc = node->GetOpDesc();
+    if ((op_desc == nullptr) || IsConstNode(node) || (op_desc->GetInputsSize() == 0) ||
+        (folding_pass::GetKernelByType(node) == nullptr)) {
+      continue;
+    }
+
+    bool foldable = true;
+    size_t input_num = 0;
+    size_t wave = 0;
+    std::vector<size_t> pred_slots;
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+      if (peer_out_anchor == nullptr) {
+        continue;
+      }
+      ++input_num;
+      NodePtr in_node = peer_out_anchor->GetOwnerNode();
+      if (IsConstNode(in_node)) {
+        continue;
+      }
+      auto iter = slot_indexes_.find(in_node.get());
+      if (iter == slot_indexes_.end()) {
+        foldable = false;
+        break;
+      }
+      pred_slots.emplace_back(iter->second);
+      wave = std::max(wave, slots_[iter->second].wave + 1);
+    }
+    if (!foldable || (input_num != op_desc->GetInputsSize())) {
+      continue;
+    }
+
+    size_t index = slots_.size();
+    FoldingSlot slot;
+    slot.node = node;
+    slot.wave = wave;
+    slots_.emplace_back(slot);
+    slot_indexes_[node.get()] = index;
+    wave_num = std::max(wave_num, wave + 1);
+
+    parents.emplace_back(index);
+    for (size_t pred : pred_slots) {
+      parents[FindRoot(parents, pred)] = index;
+    }
+  }
+
+  for (size_t i = 0; i < parents.size(); ++i) {
+    if (FindRoot(parents, i) == i) {
+      ++subgraph_num;
+    }
+  }
+  return SUCCESS;
+}
+
+bool ConstantFoldingEngine::PrepareInputs(FoldingSlot &slot) const {
+  slot.inputs.clear();
+  for (const auto &in_anchor : slot.node->GetAllInDataAnchors()) {
+    auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+    if (peer_out_anchor == nullptr) {
+      continue;
+    }
+    NodePtr in_node = peer_out_anchor->GetOwnerNode();
+    if (IsConstNode(in_node)) {
+      auto weights = OpDescUtils::GetInputData({in_node});
+      if (weights.empty()) {
+        return false;
+      }
+      slot.inputs.emplace_back(weights[0]);
+      continue;
+    }
+
+    auto iter = slot_indexes_.find(in_node.get());
+    if (iter == slot_indexes_.end()) {
+      return false;
+    }
+    const FoldingSlot &pred_slot = slots_[iter->second];
+    size_t out_index = static_cast<size_t>(peer_out_anchor->GetIdx());
+    if (!pred_slot.evaluated || (out_index >= pred_slot.outputs.size()) || (pred_slot.outputs[out_index] == nullptr)) {
+      return false;
+    }
+    slot.inputs.emplace_back(pred_slot.outputs[out_index]);
+  }
+  return true;
+}
+
+Status ConstantFoldingEngine::EvaluateWave(const std::vector<size_t> &wave, ThreadPool *thread_pool) {
+  // A node failed to evaluate is not an error, ConstantFoldingPass handles it as usual.
+  auto evaluate = [this](size_t index) {
+    FoldingSlot &slot = slots_[index];
+    auto op_kernel = folding_pass::GetKernelByType(slot.node);
+    if (op_kernel == nullptr) {
+      return;
+    }
+    std::vector<GeTensorPtr> outputs;
+    Status ret = op_kernel->Compute(slot.node->GetOpDesc(), slot.inputs, outputs);
+    if ((ret == SUCCESS) && !outputs.empty()) {
+      slot.outputs.swap(outputs);
+      slot.evaluated = true;
+    } else {
+      GELOGD("Node %s is not evaluated on host, ret %u.", slot.node->GetName().c_str(), ret);
+    }
+  };
+
+  if (thread_pool == nullptr || wave.size() <= 1) {
+    for (size_t index : wave) {
+      evaluate(index);
+    }
+    return SUCCESS;
+  }
+
+  std::vector<std::future<void>> futures;
+  for (size_t index : wave) {
+    std::future<void> f = thread_pool->commit(evaluate, index);
+    if (!f.valid()) {
+      GELOGE(FAILED, "Commit constant folding task of node %s failed.", slots_[index].node->GetName().c_str());
+      return FAILED;
+    }
+    futures.emplace_back(std::move(f));
+  }
+  for (auto &f : futures) {
+    f.get();
+  }
+  return SUCCESS;
+}
+
+bool ConstantFoldingEngine::TakeOutputs(const NodePtr &node, const std::vector<ConstGeTensorPtr> &inputs,
+                                        std::vector<GeTensorPtr> &outputs) {
+  if (node == nullptr) {
+    return false;
+  }
+  auto iter = slot_indexes_.find(node.get());
+  if (iter == slot_indexes_.end()) {
+    return false;
+  }
+  FoldingSlot &slot = slots_[iter->second];
+  if (!slot.evaluated || (slot.inputs.size() != inputs.size())) {
+    return false;
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (!IsSameTensor(slot.inputs[i], inputs[i])) {
+      GELOGI("Input %zu of node %s changed since evaluated, fold it again.", i, node->GetName().c_str());
+      return false;
+    }
+  }
+
+  outputs.swap(slot.outputs);
+  slot.evaluated = false;
+  slot.inputs.clear();
+  ++taken_num_;
+  return true;
+}
+}  // namespace ge
@@ -0,0 +1,78 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_CONSTANT_FOLDING_ENGINE_H_
+#define GE_GRAPH_PASSES_CONSTANT_FOLDING_ENGINE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+#include "graph/compute_graph.h"
+
+namespace ge {
+class ThreadPool;
+
+///
+/// Evaluate maximal constant subgraphs with host kernels ahead of ConstantFoldingPass.
+/// Nodes are evaluated in topological waves, nodes of the same wave run concurrently on a thread pool.
+/// ConstantFoldingPass takes the evaluated outputs instead of computing node by node.
+///
+class ConstantFoldingEngine {
+ public:
+  // Thread num is taken from option CONSTANT_FOLDING_THREAD_NUM.
+  ConstantFoldingEngine();
+  explicit ConstantFoldingEngine(uint32_t thread_num);
+  ConstantFoldingEngine(const ConstantFoldingEngine &) = delete;
+  ConstantFoldingEngine &operator=(const ConstantFoldingEngine &) = delete;
+  ~ConstantFoldingEngine() = default;
+
+  Status Run(const ComputeGraphPtr &graph);
+
+  ///
+  /// Take the outputs evaluated for node, they are only returned if inputs are the same as evaluated with,
+  /// since passes running between evaluation and folding may change the graph.
+  ///
+  bool TakeOutputs(const NodePtr &node, const std::vector<ConstGeTensorPtr> &inputs,
+                   std::vector<GeTensorPtr> &outputs);
+
+  size_t GetEvaluatedNum() const { return evaluated_num_; }
+  size_t GetTakenNum() const { return taken_num_; }
+
+ private:
+  struct FoldingSlot {
+    NodePtr node;
+    // Wave of the node, all of its foldable predecessors are in earlier waves.
+    size_t wave = 0;
+    bool evaluated = false;
+    std::vector<ConstGeTensorPtr> inputs;
+    std::vector<GeTensorPtr> outputs;
+  };
+
+  Status CollectSlots(const ComputeGraphPtr &graph, size_t &wave_num, size_t &subgraph_num);
+  bool PrepareInputs(FoldingSlot &slot) const;
+  Status EvaluateWave(const std::vector<size_t> &wave, ThreadPool *thread_pool);
+
+  uint32_t thread_num_;
+  // Slots of foldable nodes in topological order, intermediates are released once they are taken.
+  std::vector<FoldingSlot> slots_;
+  std::unordered_map<const Node *, size_t> slot_indexes_;
+  size_t evaluated_num_ = 0;
+  size_t taken_num_ = 0;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_PASSES_CONSTANT_FOLDING_ENGINE_H_
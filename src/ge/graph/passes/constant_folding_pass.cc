@@ -47,14 +47,19 @@ Status ConstantFoldingPass::Run(ge::NodePtr &node) {
     return SUCCESS;
   }
 
+  auto inputs = OpDescUtils::GetInputData(input_nodes);
+  vector<GeTensorPtr> outputs;
+  if ((folding_engine_ != nullptr) && folding_engine_->TakeOutputs(node, inputs, outputs)) {
+    GELOGD("Fold node %s with outputs evaluated by folding engine.", node->GetName().c_str());
+    return Folding(node, outputs);
+  }
+
   auto op_kernel = folding_pass::GetKernelByType(node);
   if (op_kernel == nullptr) {
     GELOGD("No op kernel for node %s type %s, skip the constant folding", node->GetName().c_str(),
            node->GetType().c_str());
     return SUCCESS;
   }
-  auto inputs = OpDescUtils::GetInputData(input_nodes);
-  vector<GeTensorPtr> outputs;
   auto ret = op_kernel->Compute(node_desc, inputs, outputs);
   if (ret != SUCCESS) {
     if (ret == NOT_CHANGED) {
@@ -20,12 +20,18 @@
 #include <map>
 #include <vector>
 
+#include "graph/passes/constant_folding_engine.h"
 #include "graph/passes/folding_pass.h"
 
 namespace ge {
 class ConstantFoldingPass : public FoldingPass {
  public:
+  // Outputs evaluated by folding_engine are used if it is not nullptr.
+  explicit ConstantFoldingPass(ConstantFoldingEngine *folding_engine = nullptr) : folding_engine_(folding_engine) {}
   Status Run(ge::NodePtr &node) override;
+
+ private:
+  ConstantFoldingEngine *folding_engine_;
 };
 }  // namespace ge
 
@@ -25,6 +25,7 @@
 #include "graph/debug/ge_attr_define.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/ge_inner_error_codes.h"
+#include "common/ge/content_hash.h"
 #include "common/ge/ge_util.h"
 #include "graph/utils/op_desc_utils.h"
 #include "graph/utils/type_utils.h"
@@ -43,6 +44,27 @@ bool CheckConstInAndOut(const NodePtr &node) {
   return false;
 }
 
+// Reference nodes write their inputs in place, the const they write must not be shared with other nodes.
+bool IsWrittenByPeer(const NodePtr &node) {
+  for (const auto &peer_in_anchor : node->GetOutDataAnchor(0)->GetPeerInDataAnchors()) {
+    NodePtr out_node = peer_in_anchor->GetOwnerNode();
+    if ((out_node == nullptr) || (out_node->GetOpDesc() == nullptr)) {
+      continue;
+    }
+    OpDescPtr out_desc = out_node->GetOpDesc();
+    bool is_ref = false;
+    (void)AttrUtils::GetBool(out_desc, ATTR_NAME_REFERENCE, is_ref);
+    if (is_ref) {
+      return true;
+    }
+    string input_name = out_desc->GetInputNameByIndex(static_cast<uint32_t>(peer_in_anchor->GetIdx()));
+    if (!input_name.empty() && (out_desc->GetOutputIndexByName(input_name) >= 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void GetOutDataNodeToIndexMap(NodePtr &node, std::map<string, InDataAnchorPtr> &out_node_to_indexs) {
   auto out_data_anchor = node->GetOutDataAnchor(0);
   GE_CHECK_NOTNULL_JUST_RETURN(out_data_anchor);
@@ -68,14 +90,15 @@ Status ConstantFuseSamePass::Run(ge::ComputeGraphPtr graph) {
   }
   GELOGI("ConstantFuseSamePass in.");
 
-  std::map<SameConstKey, std::vector<NodePtr>> fuse_nodes;
-  GetFuseConstNodes(graph, fuse_nodes);
+  SameConstMap fuse_nodes;
+  std::vector<SameConstKey> keys;
+  GetFuseConstNodes(graph, fuse_nodes, keys);
 
-  return FuseConstNodes(graph, fuse_nodes);
+  return FuseConstNodes(graph, fuse_nodes, keys);
 }
 
-void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph,
-                                             std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes) {
+void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph, SameConstMap &fuse_nodes,
+                                             std::vector<SameConstKey> &keys) {
   int total_const_nums = 0;
   int insert_const_nums = 0;
   for (auto &node : graph->GetDirectNode()) {
@@ -92,22 +115,19 @@ void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph,
       GELOGD("The const %s does not support to fusion, skip it", node->GetName().c_str());
       continue;
     }
+    if (IsWrittenByPeer(node)) {
+      GELOGI("The const %s is written by its peer node, skip it", node->GetName().c_str());
+      continue;
+    }
 
     GeTensorPtr weight;
     if (!AttrUtils::MutableTensor(op_desc, ATTR_NAME_WEIGHTS, weight)) {
       GELOGW("The const node %s does not have weight attr, skip it", node->GetName().c_str());
       continue;
     }
+    // Weights of consts broadcast from one element only hold the element, the attribute tells them apart.
     int64_t origin_element_num = -1;
-    if (!AttrUtils::GetInt(weight->MutableTensorDesc(), kOriginElementNumAttrName, origin_element_num)) {
-      GELOGI("The const %s does not have origin element num attribute, skip it", node->GetName().c_str());
-      continue;
-    }
-    if (origin_element_num != 1) {
-      GELOGI("The const %s origin element num %ld, does not support to fusion now", node->GetName().c_str(),
-             origin_element_num);
-      continue;
-    }
+    (void)AttrUtils::GetInt(weight->MutableTensorDesc(), kOriginElementNumAttrName, origin_element_num);
 
     auto output_tensor = op_desc->MutableOutputDesc(0);
     if (output_tensor == nullptr) {
@@ -124,13 +144,19 @@ void ConstantFuseSamePass::GetFuseConstNodes(ComputeGraphPtr &graph,
     ++insert_const_nums;
 
     SameConstKey map_key;
-    map_key.data_size = type_size;
+    map_key.data_size = weight->GetData().GetSize();
     map_key.data = weight->GetData().GetData();
+    map_key.hash = ContentHash::Hash64(map_key.data, map_key.data_size);
+    map_key.origin_element_num = origin_element_num;
     map_key.data_type = data_type;
     map_key.format = output_tensor->GetFormat();
     map_key.shape = output_tensor->GetShape().GetDims();
-    fuse_nodes[map_key].emplace_back(node);
-    GELOGD("ConstantFuseSamePass, format %s, datatype %s, data_size %d, shape_size %zu. node name %s",
+    auto &same_nodes = fuse_nodes[map_key];
+    if (same_nodes.empty()) {
+      keys.emplace_back(map_key);
+    }
+    same_nodes.emplace_back(node);
+    GELOGD("ConstantFuseSamePass, format %s, datatype %s, data_size %zu, shape_size %zu. node name %s",
            TypeUtils::FormatToSerialString(map_key.format).c_str(),
            TypeUtils::DataTypeToSerialString(map_key.data_type).c_str(), map_key.data_size, map_key.shape.size(),
            node->GetName().c_str());
@@ -169,10 +195,13 @@ Status ConstantFuseSamePass::MoveOutDataEdges(NodePtr &src_node, NodePtr &dst_no
   return SUCCESS;
 }
 
-Status ConstantFuseSamePass::FuseConstNodes(ComputeGraphPtr &graph,
-                                            std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes) {
-  for (auto iter = fuse_nodes.begin(); iter != fuse_nodes.end(); ++iter) {
-    auto nodes = iter->second;
+Status ConstantFuseSamePass::FuseConstNodes(ComputeGraphPtr &graph, SameConstMap &fuse_nodes,
+                                            const std::vector<SameConstKey> &keys) {
+  size_t fused_num = 0;
+  size_t fused_bytes = 0;
+  // Fuse in the order consts are found, so that the result does not depend on the layout of hash map.
+  for (const auto &key : keys) {
+    auto &nodes = fuse_nodes[key];
     size_t len = nodes.size();
     auto first_node = nodes.at(0);
     for (size_t i = 1; i < len; ++i) {
@@ -188,8 +217,12 @@ Status ConstantFuseSamePass::FuseConstNodes(ComputeGraphPtr &graph,
         GELOGE(FAILED, "[%s] RemoveNodeWithoutRelink failed.", node->GetName().c_str());
         return FAILED;
       }
+      ++fused_num;
+      fused_bytes += key.data_size;
     }
   }
+  GEEVENT("[GEPERFTRACE] ConstantFuseSamePass fused %zu consts of graph %s, %zu bytes of weights deduplicated.",
+          fused_num, graph->GetName().c_str(), fused_bytes);
   return SUCCESS;
 }
 }  // namespace ge
@@ -17,8 +17,8 @@
 #ifndef GE_GRAPH_PASSES_CONSTANT_FUSE_SAME_PASS_H_
 #define GE_GRAPH_PASSES_CONSTANT_FUSE_SAME_PASS_H_
 
-#include <map>
-#include <set>
+#include <cstring>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -27,48 +27,41 @@
 
 namespace ge {
 struct SameConstKey {
-  int data_size;
+  // content hash of weight data, consts with different hash can not be the same
+  uint64_t hash;
+  size_t data_size;
   const uint8_t *data;
+  int64_t origin_element_num;
   DataType data_type;
   Format format;
   std::vector<int64_t> shape;
 
  public:
-  bool operator<(const SameConstKey &key) const {
-    if (data_size != key.data_size) {
-      return data_size < key.data_size;
-    }
-    int ret = memcmp(data, key.data, data_size);
-    if (ret != 0) {
-      return ret < 0;
-    }
-    if (data_type != key.data_type) {
-      return data_type < key.data_type;
-    }
-    if (format != key.format) {
-      return format < key.format;
-    }
-    size_t shape_size = shape.size();
-    if (shape_size != key.shape.size()) {
-      return shape_size < key.shape.size();
-    }
-    for (size_t i = 0; i < shape_size; ++i) {
-      if (shape.at(i) != key.shape.at(i)) {
-        return shape.at(i) < key.shape.at(i);
-      }
-    }
-    return false;
+  bool operator==(const SameConstKey &key) const {
+    return (hash == key.hash) && (data_size == key.data_size) && (origin_element_num == key.origin_element_num) &&
+           (data_type == key.data_type) && (format == key.format) && (shape == key.shape) &&
+           ((data_size == 0) || (memcmp(data, key.data, data_size) == 0));
   }
 };
 
+struct SameConstKeyHasher {
+  size_t operator()(const SameConstKey &key) const { return static_cast<size_t>(key.hash); }
+};
+
+using SameConstMap = std::unordered_map<SameConstKey, std::vector<NodePtr>, SameConstKeyHasher>;
+
+///
+/// Fuse const nodes with the same weights into one.
+/// Weights are bucketed by content hash, so that fusion takes linear time in the total weight size.
+///
 class ConstantFuseSamePass : public GraphPass {
  public:
   Status Run(ge::ComputeGraphPtr graph) override;
 
  private:
-  void GetFuseConstNodes(ComputeGraphPtr &graph, std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes);
+  void GetFuseConstNodes(ComputeGraphPtr &graph, SameConstMap &fuse_nodes, std::vector<SameConstKey> &keys);
   Status MoveOutDataEdges(NodePtr &src_node, NodePtr &dst_node);
-  Status FuseConstNodes(ComputeGraphPtr &graph, std::map<SameConstKey, std::vector<NodePtr>> &fuse_nodes);
+  Status FuseConstNodes(ComputeGraphPtr &graph, SameConstMap &fuse_nodes, const std::vector<SameConstKey> &keys);
 };
 }  // namespace ge
 #endif  // GE_GRAPH_PASSES_CONSTANT_FUSE_SAME_PASS_H_
@@ -40,9 +40,7 @@ void GetOutputData(std::vector<T> &y_data, int loop, size_t &input_size, const s
       GeShape datak_shape = input.at(k)->GetTensorDesc().GetShape();
       const T *datak = reinterpret_cast<const T *>(input.at(k)->GetData().data());
       int gapk = datak_shape.GetShapeSize() / loop;  // [2,3] is 6/loop
-      for (int j = 0; j < gapk; j++) {
-        y_data.push_back(datak[j + gapk * i]);
-      }
+      y_data.insert(y_data.end(), datak + gapk * i, datak + gapk * (i + 1));
     }
   }
 }
@@ -0,0 +1,202 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/folding_kernel/matmul_kernel.h"
+
+#include <limits>
+#include <memory>
+#include <set>
+#include <type_traits>
+
+#include "common/ge_inner_error_codes.h"
+#include "common/op/ge_op_utils.h"
+#include "common/types.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/passes/folding_kernel/kernel_utils.h"
+#include "graph/utils/type_utils.h"
+#include "inc/kernel_factory.h"
+
+namespace ge {
+namespace {
+const size_t kMatMulX1Index = 0;
+const size_t kMatMulX2Index = 1;
+const size_t kMatMulBiasIndex = 2;
+const size_t kMatMulInputSize = 2;
+const size_t kMatMulInputSizeWithBias = 3;
+const size_t kMatMulDimNum = 2;
+const char *const kMatMulAttrTransposeA = "transpose_a";
+const char *const kMatMulAttrTransposeB = "transpose_b";
+// Only small constants are folded on host, larger ones are left to the device.
+const int64_t kMatMulMaxMacNum = 16 * 1024 * 1024;
+const std::set<DataType> kMatMulSupportedType = {DT_FLOAT, DT_INT32};
+
+// Copy matrix to row-major layout of its logical shape [rows, cols].
+template <typename T>
+std::vector<T> ToRowMajor(const T *data, int64_t rows, int64_t cols, bool transposed) {
+  std::vector<T> matrix(data, data + rows * cols);
+  if (transposed) {
+    // data is [cols, rows]
+    for (int64_t r = 0; r < rows; ++r) {
+      for (int64_t c = 0; c < cols; ++c) {
+        matrix[r * cols + c] = data[c * rows + r];
+      }
+    }
+  }
+  return matrix;
+}
+}  // namespace
+
+Status MatMulKernel::MatMulCheck(const OpDescPtr &op_desc_ptr, const std::vector<ConstGeTensorPtr> &input) {
+  if (op_desc_ptr == nullptr) {
+    GELOGE(PARAM_INVALID, "input opdesc is nullptr.");
+    return PARAM_INVALID;
+  }
+  if (input.size() != kMatMulInputSize && input.size() != kMatMulInputSizeWithBias) {
+    GELOGI("The number of input for MatMul must be %zu or %zu, node name: %s.", kMatMulInputSize,
+           kMatMulInputSizeWithBias, op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  for (size_t i = 0; i < input.size(); ++i) {
+    if (input[i] == nullptr) {
+      GELOGI("Input %zu of node %s must not be null.", i, op_desc_ptr->GetName().c_str());
+      return NOT_CHANGED;
+    }
+  }
+
+  const GeTensorDesc &x1_desc = input[kMatMulX1Index]->GetTensorDesc();
+  const GeTensorDesc &x2_desc = input[kMatMulX2Index]->GetTensorDesc();
+  DataType data_type = x1_desc.GetDataType();
+  if (kMatMulSupportedType.find(data_type) == kMatMulSupportedType.end() || x2_desc.GetDataType() != data_type) {
+    GELOGI("MatMul does not support data type %s and %s, node name: %s.",
+           TypeUtils::DataTypeToSerialString(data_type).c_str(),
+           TypeUtils::DataTypeToSerialString(x2_desc.GetDataType()).c_str(), op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  const GeShape &x1_shape = x1_desc.GetShape();
+  const GeShape &x2_shape = x2_desc.GetShape();
+  if (x1_shape.GetDimNum() != kMatMulDimNum || x2_shape.GetDimNum() != kMatMulDimNum ||
+      KernelUtils::IsUnknownShape(x1_shape) || KernelUtils::IsUnknownShape(x2_shape)) {
+    GELOGI("Inputs of MatMul must be known 2D matrix, node name: %s.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+
+  (void)AttrUtils::GetBool(op_desc_ptr, kMatMulAttrTransposeA, transpose_a_);
+  (void)AttrUtils::GetBool(op_desc_ptr, kMatMulAttrTransposeB, transpose_b_);
+  m_ = transpose_a_ ? x1_shape.GetDim(1) : x1_shape.GetDim(0);
+  k_ = transpose_a_ ? x1_shape.GetDim(0) : x1_shape.GetDim(1);
+  int64_t k2 = transpose_b_ ? x2_shape.GetDim(1) : x2_shape.GetDim(0);
+  n_ = transpose_b_ ? x2_shape.GetDim(0) : x2_shape.GetDim(1);
+  if (k_ != k2 || m_ <= 0 || k_ <= 0 || n_ <= 0) {
+    GELOGI("Shapes of MatMul inputs do not match, node name: %s.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  if (m_ > kMatMulMaxMacNum / k_ || m_ * k_ > kMatMulMaxMacNum / n_) {
+    GELOGI("MatMul %s is too large to fold on host.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+
+  size_t type_size = static_cast<size_t>(GetSizeByDataType(data_type));
+  if (input[kMatMulX1Index]->GetData().size() != static_cast<size_t>(m_ * k_) * type_size ||
+      input[kMatMulX2Index]->GetData().size() != static_cast<size_t>(k_ * n_) * type_size) {
+    GELOGI("Data size of MatMul inputs does not match shape, node name: %s.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  if (input.size() == kMatMulInputSizeWithBias) {
+    const GeTensorDesc &bias_desc = input[kMatMulBiasIndex]->GetTensorDesc();
+    if (bias_desc.GetDataType() != data_type ||
+        input[kMatMulBiasIndex]->GetData().size() != static_cast<size_t>(n_) * type_size) {
+      GELOGI("Bias of MatMul must be 1D tensor of size %ld, node name: %s.", n_, op_desc_ptr->GetName().c_str());
+      return NOT_CHANGED;
+    }
+  }
+  return SUCCESS;
+}
+
+template <typename T, typename AccT>
+Status MatMulKernel::DataCal(const std::vector<ConstGeTensorPtr> &input, const GeTensorPtr &output_ptr) const {
+  std::vector<T> a = ToRowMajor(reinterpret_cast<const T *>(input[kMatMulX1Index]->GetData().data()), m_, k_,
+                                transpose_a_);
+  std::vector<T> b = ToRowMajor(reinterpret_cast<const T *>(input[kMatMulX2Index]->GetData().data()), k_, n_,
+                                transpose_b_);
+  const T *bias = nullptr;
+  if (input.size() == kMatMulInputSizeWithBias) {
+    bias = reinterpret_cast<const T *>(input[kMatMulBiasIndex]->GetData().data());
+  }
+
+  std::vector<T> output(static_cast<size_t>(m_ * n_));
+  std::vector<AccT> row(static_cast<size_t>(n_));
+  for (int64_t i = 0; i < m_; ++i) {
+    for (int64_t j = 0; j < n_; ++j) {
+      row[j] = (bias == nullptr) ? static_cast<AccT>(0) : static_cast<AccT>(bias[j]);
+    }
+    // i-k-j order, the innermost loop runs over contiguous rows of b and can be vectorized.
+    for (int64_t k = 0; k < k_; ++k) {
+      AccT a_ik = static_cast<AccT>(a[i * k_ + k]);
+      const T *b_row = b.data() + k * n_;
+      for (int64_t j = 0; j < n_; ++j) {
+        row[j] += a_ik * static_cast<AccT>(b_row[j]);
+      }
+    }
+    for (int64_t j = 0; j < n_; ++j) {
+      if (std::is_integral<T>::value && (row[j] > static_cast<AccT>(std::numeric_limits<T>::max()) ||
+                                         row[j] < static_cast<AccT>(std::numeric_limits<T>::lowest()))) {
+        GELOGI("Result [%ld, %ld] is overflow.", i, j);
+        return NOT_CHANGED;
+      }
+      output[i * n_ + j] = static_cast<T>(row[j]);
+    }
+  }
+
+  if (output_ptr->SetData(reinterpret_cast<uint8_t *>(output.data()), output.size() * sizeof(T)) != GRAPH_SUCCESS) {
+    GELOGW("Set data failed.");
+    return NOT_CHANGED;
+  }
+  return SUCCESS;
+}
+
+Status MatMulKernel::Compute(const OpDescPtr op_desc_ptr, const std::vector<ConstGeTensorPtr> &input,
+                             std::vector<GeTensorPtr> &v_output) {
+  GELOGD("MatMulKernel in.");
+  Status ret = MatMulCheck(op_desc_ptr, input);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  GeTensorPtr output_ptr = MakeShared<GeTensor>(op_desc_ptr->GetOutputDesc(0));
+  if (output_ptr == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "make_shared ge::GeTensor failed, node name %s.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+
+  DataType data_type = input[kMatMulX1Index]->GetTensorDesc().GetDataType();
+  if (data_type == DT_FLOAT) {
+    ret = DataCal<float, float>(input, output_ptr);
+  } else {
+    ret = DataCal<int32_t, int64_t>(input, output_ptr);
+  }
+  if (ret != SUCCESS) {
+    return NOT_CHANGED;
+  }
+
+  output_ptr->MutableTensorDesc().SetShape(GeShape({m_, n_}));
+  output_ptr->MutableTensorDesc().SetDataType(data_type);
+  v_output.emplace_back(output_ptr);
+  GELOGD("MatMulKernel success, node name %s.", op_desc_ptr->GetName().c_str());
+  return SUCCESS;
+}
+
+REGISTER_KERNEL(MATMUL, MatMulKernel);
+}  // namespace ge
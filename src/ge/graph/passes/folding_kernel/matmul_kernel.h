@@ -0,0 +1,43 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_FOLDING_KERNEL_MATMUL_KERNEL_H_
+#define GE_GRAPH_PASSES_FOLDING_KERNEL_MATMUL_KERNEL_H_
+
+#include <vector>
+
+#include "inc/kernel.h"
+
+namespace ge {
+class MatMulKernel : public Kernel {
+ public:
+  Status Compute(const OpDescPtr op_desc_ptr, const std::vector<ConstGeTensorPtr> &input,
+                 std::vector<GeTensorPtr> &v_output) override;
+
+ private:
+  Status MatMulCheck(const OpDescPtr &op_desc_ptr, const std::vector<ConstGeTensorPtr> &input);
+  template <typename T, typename AccT>
+  Status DataCal(const std::vector<ConstGeTensorPtr> &input, const GeTensorPtr &output_ptr) const;
+
+  bool transpose_a_ = false;
+  bool transpose_b_ = false;
+  int64_t m_ = 0;
+  int64_t k_ = 0;
+  int64_t n_ = 0;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_PASSES_FOLDING_KERNEL_MATMUL_KERNEL_H_
@@ -0,0 +1,24 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/folding_kernel/reduce_mean_kernel.h"
+
+#include "common/types.h"
+#include "inc/kernel_factory.h"
+
+namespace ge {
+REGISTER_KERNEL(REDUCEMEAN, ReduceMeanKernel);
+}  // namespace ge
@@ -0,0 +1,225 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/passes/folding_kernel/reduce_sum_kernel.h"
+
+#include <limits>
+#include <memory>
+#include <set>
+#include <type_traits>
+
+#include "common/ge_inner_error_codes.h"
+#include "common/op/ge_op_utils.h"
+#include "common/types.h"
+#include "framework/common/debug/ge_log.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/passes/folding_kernel/kernel_utils.h"
+#include "graph/utils/type_utils.h"
+#include "inc/kernel_factory.h"
+
+namespace ge {
+namespace {
+const size_t kReduceSumDataIndex = 0;
+const size_t kReduceSumAxisIndex = 1;
+const size_t kReduceSumInputSize = 2;
+const size_t kReduceSumMaxAxisRank = 1;
+const std::set<DataType> kReduceSumSupportedType = {DT_FLOAT, DT_INT32};
+}  // namespace
+
+Status ReduceSumKernel::ReduceSumCheck(const OpDescPtr &op_desc_ptr, const std::vector<ConstGeTensorPtr> &input) const {
+  if (op_desc_ptr == nullptr) {
+    GELOGE(PARAM_INVALID, "input opdesc is nullptr.");
+    return PARAM_INVALID;
+  }
+  if (input.size() != kReduceSumInputSize) {
+    GELOGI("The number of input for %s must be %zu, node name: %s.", op_desc_ptr->GetType().c_str(),
+           kReduceSumInputSize, op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  ConstGeTensorPtr data_tensor = input.at(kReduceSumDataIndex);
+  ConstGeTensorPtr axis_tensor = input.at(kReduceSumAxisIndex);
+  if (data_tensor == nullptr || axis_tensor == nullptr) {
+    GELOGI("Input of node %s must not be null.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+
+  const GeShape &data_shape = data_tensor->GetTensorDesc().GetShape();
+  if (KernelUtils::IsUnknownShape(data_shape) || data_shape.GetDimNum() == 0) {
+    GELOGI("Data of node %s is unknown shape or scalar.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  DataType data_type = data_tensor->GetTensorDesc().GetDataType();
+  if (kReduceSumSupportedType.find(data_type) == kReduceSumSupportedType.end()) {
+    GELOGI("%s does not support data type %s, node name: %s.", op_desc_ptr->GetType().c_str(),
+           TypeUtils::DataTypeToSerialString(data_type).c_str(), op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  int64_t shape_size = data_shape.GetShapeSize();
+  if (shape_size <= 0 ||
+      data_tensor->GetData().size() != static_cast<size_t>(shape_size) * GetSizeByDataType(data_type)) {
+    GELOGI("Data size %zu of node %s does not match its shape.", data_tensor->GetData().size(),
+           op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  if (axis_tensor->GetTensorDesc().GetShape().GetDimNum() > kReduceSumMaxAxisRank) {
+    GELOGI("Axis of node %s must be at most rank 1.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  return SUCCESS;
+}
+
+Status ReduceSumKernel::GetReduceAxes(const ConstGeTensorPtr &axis_tensor, size_t rank,
+                                      std::vector<bool> &reduce_axes) const {
+  std::vector<int64_t> axes;
+  DataType axis_type = axis_tensor->GetTensorDesc().GetDataType();
+  const uint8_t *axis_data = axis_tensor->GetData().data();
+  size_t axis_size = axis_tensor->GetData().size();
+  if (axis_type == DT_INT32) {
+    const int32_t *axis_ptr = reinterpret_cast<const int32_t *>(axis_data);
+    axes.assign(axis_ptr, axis_ptr + axis_size / sizeof(int32_t));
+  } else if (axis_type == DT_INT64) {
+    const int64_t *axis_ptr = reinterpret_cast<const int64_t *>(axis_data);
+    axes.assign(axis_ptr, axis_ptr + axis_size / sizeof(int64_t));
+  } else {
+    GELOGI("Data type %s of axis is not supported.", TypeUtils::DataTypeToSerialString(axis_type).c_str());
+    return NOT_CHANGED;
+  }
+  if (axes.empty()) {
+    GELOGI("Axis is empty, nothing to reduce.");
+    return NOT_CHANGED;
+  }
+
+  int64_t dim_num = static_cast<int64_t>(rank);
+  reduce_axes.assign(rank, false);
+  for (int64_t axis : axes) {
+    if (axis < -dim_num || axis >= dim_num) {
+      GELOGI("Axis %ld is out of range [%ld, %ld).", axis, -dim_num, dim_num);
+      return NOT_CHANGED;
+    }
+    reduce_axes[static_cast<size_t>(axis < 0 ? axis + dim_num : axis)] = true;
+  }
+  return SUCCESS;
+}
+
+template <typename T, typename AccT>
+Status ReduceSumKernel::DataCal(const ConstGeTensorPtr &data_tensor, const std::vector<bool> &reduce_axes,
+                                const GeTensorPtr &output_ptr) const {
+  std::vector<int64_t> dims = data_tensor->GetTensorDesc().GetShape().GetDims();
+  const T *input_data = reinterpret_cast<const T *>(data_tensor->GetData().data());
+  GE_CHECK_NOTNULL(input_data);
+  size_t data_num = data_tensor->GetData().size() / sizeof(T);
+  std::vector<AccT> acc(input_data, input_data + data_num);
+
+  // Reduce one axis at a time, the innermost loop runs over contiguous elements so it can be vectorized.
+  int64_t reduce_num = 1;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (!reduce_axes[i] || dims[i] == 1) {
+      continue;
+    }
+    int64_t head_dim = 1;
+    int64_t end_dim = 1;
+    for (size_t j = 0; j < dims.size(); ++j) {
+      if (j < i) {
+        head_dim *= dims[j];
+      } else if (j > i) {
+        end_dim *= dims[j];
+      }
+    }
+    int64_t axis_dim = dims[i];
+    std::vector<AccT> reduced(static_cast<size_t>(head_dim * end_dim), static_cast<AccT>(0));
+    for (int64_t h = 0; h < head_dim; ++h) {
+      AccT *dst = reduced.data() + h * end_dim;
+      for (int64_t k = 0; k < axis_dim; ++k) {
+        const AccT *src = acc.data() + (h * axis_dim + k) * end_dim;
+        for (int64_t e = 0; e < end_dim; ++e) {
+          dst[e] += src[e];
+        }
+      }
+    }
+    reduce_num *= axis_dim;
+    dims[i] = 1;
+    acc.swap(reduced);
+  }
+
+  std::vector<T> output(acc.size());
+  for (size_t i = 0; i < acc.size(); ++i) {
+    AccT value = IsMean() ? acc[i] / static_cast<AccT>(reduce_num) : acc[i];
+    if (std::is_integral<T>::value && (value > static_cast<AccT>(std::numeric_limits<T>::max()) ||
+                                       value < static_cast<AccT>(std::numeric_limits<T>::lowest()))) {
+      GELOGI("Result %zu is overflow.", i);
+      return NOT_CHANGED;
+    }
+    output[i] = static_cast<T>(value);
+  }
+  if (output_ptr->SetData(reinterpret_cast<uint8_t *>(output.data()), output.size() * sizeof(T)) != GRAPH_SUCCESS) {
+    GELOGW("Set data failed.");
+    return NOT_CHANGED;
+  }
+  return SUCCESS;
+}
+
+Status ReduceSumKernel::Compute(const OpDescPtr op_desc_ptr, const std::vector<ConstGeTensorPtr> &input,
+                                std::vector<GeTensorPtr> &v_output) {
+  GELOGD("ReduceSumKernel in.");
+  Status ret = ReduceSumCheck(op_desc_ptr, input);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  ConstGeTensorPtr data_tensor = input.at(kReduceSumDataIndex);
+  const GeTensorDesc &data_desc = data_tensor->GetTensorDesc();
+  std::vector<int64_t> data_dims = data_desc.GetShape().GetDims();
+  std::vector<bool> reduce_axes;
+  ret = GetReduceAxes(input.at(kReduceSumAxisIndex), data_dims.size(), reduce_axes);
+  if (ret != SUCCESS) {
+    return NOT_CHANGED;
+  }
+
+  GeTensorPtr output_ptr = MakeShared<GeTensor>(op_desc_ptr->GetOutputDesc(0));
+  if (output_ptr == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "make_shared ge::GeTensor failed, node name %s.", op_desc_ptr->GetName().c_str());
+    return NOT_CHANGED;
+  }
+
+  DataType data_type = data_desc.GetDataType();
+  if (data_type == DT_FLOAT) {
+    ret = DataCal<float, float>(data_tensor, reduce_axes, output_ptr);
+  } else {
+    ret = DataCal<int32_t, int64_t>(data_tensor, reduce_axes, output_ptr);
+  }
+  if (ret != SUCCESS) {
+    return NOT_CHANGED;
+  }
+
+  bool keep_dims = false;
+  (void)AttrUtils::GetBool(op_desc_ptr, SUM_ATTR_KEEP_DIMS, keep_dims);
+  std::vector<int64_t> output_dims;
+  for (size_t i = 0; i < data_dims.size(); ++i) {
+    if (!reduce_axes[i]) {
+      output_dims.push_back(data_dims[i]);
+    } else if (keep_dims) {
+      output_dims.push_back(1);
+    }
+  }
+  output_ptr->MutableTensorDesc().SetShape(GeShape(output_dims));
+  output_ptr->MutableTensorDesc().SetDataType(data_type);
+  v_output.emplace_back(output_ptr);
+  GELOGD("ReduceSumKernel success, node name %s.", op_desc_ptr->GetName().c_str());
+  return SUCCESS;
+}
+
+REGISTER_KERNEL(REDUCESUM, ReduceSumKernel);
+}  // namespace ge
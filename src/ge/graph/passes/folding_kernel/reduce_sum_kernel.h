@@ -0,0 +1,43 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PASSES_FOLDING_KERNEL_REDUCE_SUM_KERNEL_H_
+#define GE_GRAPH_PASSES_FOLDING_KERNEL_REDUCE_SUM_KERNEL_H_
+
+#include <vector>
+
+#include "inc/kernel.h"
+
+namespace ge {
+class ReduceSumKernel : public Kernel {
+ public:
+  Status Compute(const OpDescPtr op_desc_ptr, const std::vector<ConstGeTensorPtr> &input,
+                 std::vector<GeTensorPtr> &v_output) override;
+
+ protected:
+  // ReduceMean shares the reduction, and divides the sum by the number of reduced elements.
+  virtual bool IsMean() const { return false; }
+
+ private:
+  Status ReduceSumCheck(const OpDescPtr &op_desc_ptr, const std::vector<ConstGeTensorPtr> &input) const;
+  Status GetReduceAxes(const ConstGeTensorPtr &axis_tensor, size_t rank, std::vector<bool> &reduce_axes) const;
+  template <typename T, typename AccT>
+  Status DataCal(const ConstGeTensorPtr &data_tensor, const std::vector<bool> &reduce_axes,
+                 const GeTensorPtr &output_ptr) const;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_PASSES_FOLDING_KERNEL_REDUCE_SUM_KERNEL_H_
@@ -15,6 +15,12 @@
  */
 
 #include "inc/pass_manager.h"
+
+#include <cxxabi.h>
+#include <cstdlib>
+#include <typeinfo>
+
+#include "common/build_tracer.h"
 #include "common/debug/log.h"
 #include "common/types.h"
 #include "common/util.h"
@@ -22,6 +28,21 @@
 #include "omg/omg_inner_types.h"
 
 namespace ge {
+namespace {
+// Class name of the pass as the span name of build trace
+std::string GetPassName(const GraphPass &pass) {
+  const char *mangled_name = typeid(pass).name();
+  int status = 0;
+  char *name = abi::__cxa_demangle(mangled_name, nullptr, nullptr, &status);
+  if (name == nullptr) {
+    return mangled_name;
+  }
+  std::string pass_name = (status == 0) ? name : mangled_name;
+  free(name);
+  return pass_name;
+}
+}  // namespace
+
 const vector<GraphPass *> &PassManager::GraphPasses() const { return graph_passes_; }
 
 Status PassManager::AddPass(GraphPass *pass) {
@@ -42,6 +63,8 @@ Status PassManager::Run(const ComputeGraphPtr &graph, vector<GraphPass *> &passe
   for (auto &pass : passes) {
     GE_CHECK_NOTNULL(pass);
 
+    GE_TRACE_SCOPE(GraphPass, BuildTracer::IsEnabled() ? GetPassName(*pass) : std::string());
+    GE_TRACE_ARG(GraphPass, "graph", graph->GetName());
     Status status = pass->Run(graph);
     if (status == SUCCESS) {
       not_changed = false;
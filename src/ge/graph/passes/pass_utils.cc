@@ -16,7 +16,9 @@
 
 #include "graph/passes/pass_utils.h"
 
+#include <algorithm>
 #include <climits>
+#include <future>
 #include <memory>
 #include <queue>
 #include <string>
@@ -26,6 +28,7 @@
 #include "common/ge_inner_error_codes.h"
 #include "common/ge/ge_util.h"
 #include "common/op/ge_op_utils.h"
+#include "common/thread_pool.h"
 #include "common/types.h"
 #include "graph/common/omg_util.h"
 #include "graph/debug/ge_attr_define.h"
@@ -40,6 +43,8 @@ namespace ge {
 namespace {
 const uint32_t kShapeDimSize = 1;
 const uint32_t DIM_SIZE_TWO = 2;
+// Shards smaller than this are not worth a task of thread pool
+const size_t kMinFilterShardSize = 256;
 }  // namespace
 
 Status PassUtils::ConstructTensorDescWithData(const GeTensorDesc &out_desc, std::vector<int64_t> &data,
@@ -333,4 +338,43 @@ Status PassUtils::RemoveInactiveBranchToMerge(const OutDataAnchorPtr &inactive_o
   }
   return SUCCESS;
 }
+Status PassUtils::FilterNodes(uint32_t thread_num, const std::function<bool(const NodePtr &)> &condition,
+                              std::vector<NodePtr> &nodes) {
+  std::vector<uint8_t> kept(nodes.size(), 0);
+  auto check_nodes = [&condition, &nodes, &kept](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      kept[i] = condition(nodes[i]) ? 1 : 0;
+    }
+  };
+
+  size_t shard_num = std::min<size_t>(thread_num, nodes.size() / kMinFilterShardSize);
+  if (shard_num <= 1) {
+    check_nodes(0, nodes.size());
+  } else {
+    ThreadPool thread_pool(static_cast<uint32_t>(shard_num));
+    std::vector<std::future<void>> futures;
+    for (size_t shard = 0; shard < shard_num; ++shard) {
+      size_t begin = nodes.size() * shard / shard_num;
+      size_t end = nodes.size() * (shard + 1) / shard_num;
+      std::future<void> f = thread_pool.commit(check_nodes, begin, end);
+      if (!f.valid()) {
+        GELOGE(FAILED, "Commit filter task of shard %zu failed.", shard);
+        return FAILED;
+      }
+      futures.emplace_back(std::move(f));
+    }
+    for (auto &f : futures) {
+      f.get();
+    }
+  }
+
+  size_t kept_num = 0;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (kept[i] != 0) {
+      nodes[kept_num++] = nodes[i];
+    }
+  }
+  nodes.resize(kept_num);
+  return SUCCESS;
+}
 }  // namespace ge
@@ -17,6 +17,7 @@
 #ifndef GE_GRAPH_PASSES_PASS_UTILS_H_
 #define GE_GRAPH_PASSES_PASS_UTILS_H_
 
+#include <functional>
 #include <vector>
 
 #include "framework/common/debug/ge_log.h"
@@ -69,6 +70,17 @@ class PassUtils {
   /// @return
   ///
   static Status UnlinkNodeWithControlCopy(NodePtr &node, int index);
+
+  ///
+  /// keep nodes meeting the condition in their original order, the condition is checked for shards of
+  /// nodes concurrently when thread_num is greater than 1, so it must not modify the graph
+  /// @param thread_num
+  /// @param condition
+  /// @param nodes
+  /// @return
+  ///
+  static Status FilterNodes(uint32_t thread_num, const std::function<bool(const NodePtr &)> &condition,
+                            std::vector<NodePtr> &nodes);
 };
 }  // namespace ge
 
@@ -26,6 +26,8 @@
 #include "common/types.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/debug/ge_attr_define.h"
+#include "graph/ge_context.h"
+#include "graph/passes/pass_utils.h"
 #include "graph/utils/graph_utils.h"
 #include "graph/utils/op_desc_utils.h"
 #include "init/gelib.h"
@@ -344,7 +346,21 @@ graphStatus SameTransdataBreadthFusionPass::Run(ComputeGraphPtr graph) {
     return GRAPH_SUCCESS;
   }
 
-  for (auto &node : graph->GetAllNodes()) {
+  auto all_nodes = graph->GetAllNodes();
+  std::vector<NodePtr> nodes(all_nodes.begin(), all_nodes.end());
+  uint32_t thread_num = GetContext().FormatPassThreadNum();
+  if (thread_num > 1) {
+    // Fusion only relinks the sub graphs of its own normal node, so nodes can be filtered ahead
+    auto is_fusion_head = [this](const NodePtr &node) { return IsFusionHead(node); };
+    if (PassUtils::FilterNodes(thread_num, is_fusion_head, nodes) != SUCCESS) {
+      GELOGE(GRAPH_FAILED, "Filter normal nodes of graph %s failed.", graph->GetName().c_str());
+      return GRAPH_FAILED;
+    }
+    GELOGI("[GEPERFTRACE] SameTransdataBreadthFusionPass filtered %zu of %zu nodes with %u threads.", nodes.size(),
+           all_nodes.size(), thread_num);
+  }
+
+  for (auto &node : nodes) {
     if (IsTransOp(node) || node->GetOutDataNodes().size() <= 1) {
       continue;
     }
@@ -744,6 +760,21 @@ graphStatus SameTransdataBreadthFusionPass::GetSubGraphsBetweenNormalAndTransdat
   return GRAPH_SUCCESS;
 }
 
+bool SameTransdataBreadthFusionPass::IsFusionHead(const NodePtr &node) {
+  if (IsTransOp(node) || node->GetOutDataNodes().size() <= 1) {
+    return false;
+  }
+  for (auto &out_anchor : node->GetAllOutDataAnchors()) {
+    std::vector<std::vector<std::pair<OutDataAnchorPtr, InDataAnchorPtr>>> sub_graph_anchors;
+    std::vector<std::pair<OutDataAnchorPtr, InDataAnchorPtr>> nodes_list;
+    if (GetSubGraphsBetweenNormalAndTransdataNode(out_anchor, sub_graph_anchors, nodes_list) == GRAPH_SUCCESS &&
+        sub_graph_anchors.size() > 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool SameTransdataBreadthFusionPass::IsTransOp(const NodePtr &node) {
   if (node == nullptr) {
     return false;
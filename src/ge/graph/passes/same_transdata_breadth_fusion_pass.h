@@ -104,6 +104,13 @@ class SameTransdataBreadthFusionPass : public GraphPass {
 
   static bool IsHandleOp(const NodePtr &node);
 
+  ///
+  /// judge whether a normal node has more than one sub graph to fuse, the graph is only read
+  /// @param node
+  /// @return True or False
+  ///
+  bool IsFusionHead(const NodePtr &node);
+
   vector<vector<pair<OutDataAnchorPtr, InDataAnchorPtr>>> sub_graph_anchors_;
   vector<vector<NodePtr>> before_transdata_nodes_;
   vector<pair<int, InDataAnchorPtr>> all_transdata_nodes_;
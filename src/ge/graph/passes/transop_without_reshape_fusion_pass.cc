@@ -27,8 +27,10 @@
 #include "framework/common/debug/ge_log.h"
 #include "graph/compute_graph.h"
 #include "graph/debug/ge_attr_define.h"
+#include "graph/ge_context.h"
 #include "graph/ge_tensor.h"
 #include "graph/op_desc.h"
+#include "graph/passes/pass_utils.h"
 #include "graph/utils/graph_utils.h"
 #include "graph/utils/op_desc_utils.h"
 #include "graph/utils/type_utils.h"
@@ -738,7 +740,21 @@ graphStatus TransOpWithoutReshapeFusionPass::Run(ComputeGraphPtr graph) {
     return GRAPH_SUCCESS;
   }
 
-  for (const auto &node : graph->GetAllNodes()) {
+  auto all_nodes = graph->GetAllNodes();
+  std::vector<NodePtr> nodes(all_nodes.begin(), all_nodes.end());
+  uint32_t thread_num = GetContext().FormatPassThreadNum();
+  if (thread_num > 1) {
+    // Fusion only relinks the sub graphs of its own normal node, so nodes can be filtered ahead
+    auto is_fusion_head = [this](const NodePtr &node) { return IsFusionHead(node); };
+    if (PassUtils::FilterNodes(thread_num, is_fusion_head, nodes) != SUCCESS) {
+      GELOGE(GRAPH_FAILED, "Filter normal nodes of graph %s failed.", graph->GetName().c_str());
+      return GRAPH_FAILED;
+    }
+    GELOGI("[GEPERFTRACE] TransOpWithoutReshapeFusionPass filtered %zu of %zu nodes with %u threads.", nodes.size(),
+           all_nodes.size(), thread_num);
+  }
+
+  for (const auto &node : nodes) {
     GE_CHECK_NOTNULL(node);
     if (IsTransOp(node)) {
       continue;
@@ -1085,6 +1101,32 @@ graphStatus TransOpWithoutReshapeFusionPass::GetSubGraphsBetweenNormalNode(
   return GRAPH_SUCCESS;
 }
 
+bool TransOpWithoutReshapeFusionPass::IsFusionHead(const NodePtr &node) {
+  // Null nodes and anchors are kept, so that they are reported by the serial loop
+  if (node == nullptr) {
+    return true;
+  }
+  if (IsTransOp(node)) {
+    return false;
+  }
+  for (const auto &out_anchor : node->GetAllOutDataAnchors()) {
+    if (out_anchor == nullptr) {
+      return true;
+    }
+    vector<vector<pair<OutDataAnchorPtr, InDataAnchorPtr>>> sub_graph_anchors;
+    vector<pair<OutDataAnchorPtr, InDataAnchorPtr>> nodes_list;
+    if (GetSubGraphsBetweenNormalNode(out_anchor, sub_graph_anchors, nodes_list) != GRAPH_SUCCESS) {
+      continue;
+    }
+    for (const auto &sub_graph : sub_graph_anchors) {
+      if (sub_graph.size() > 1) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool TransOpWithoutReshapeFusionPass::IsTransOp(const NodePtr &node) {
   // The caller guarantees that the pointer is not null.
   return node->GetType() == CAST || node->GetType() == RESHAPE || node->GetType() == TRANSPOSE ||
@@ -120,6 +120,13 @@ class TransOpWithoutReshapeFusionPass : public GraphPass {
   ///
   static bool IsTransOp(const NodePtr &node);
 
+  ///
+  /// judge whether a normal node has a sub graph of trans ops to fuse, the graph is only read
+  /// @param node
+  /// @return True or False
+  ///
+  bool IsFusionHead(const NodePtr &node);
+
   static bool FusionFormatSupport(Format format);
 
   vector<vector<pair<OutDataAnchorPtr, InDataAnchorPtr>>> sub_graph_anchors_;
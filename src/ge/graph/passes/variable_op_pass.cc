@@ -414,8 +414,8 @@ Status VariableOpPass::UpdateVarAndRefOutputFormatInfo(const GeTensorDesc &final
 }
 
 Status VariableOpPass::GenerateVariableVariableRefMap(const ComputeGraphPtr &compute_graph) {
-  std::map<std::string, NodePtr> names_to_var;
-  std::map<std::string, std::set<NodePtr>> names_to_refs;
+  std::map<NodePtr, std::set<NodePtr>> var_to_refs;
+  std::vector<std::pair<std::string, NodePtr>> ref_names_to_refs;
   GE_CHECK_NOTNULL(compute_graph);
   for (auto &node : compute_graph->GetAllNodes()) {
     if (node->GetType() != VARIABLE) {
@@ -423,14 +423,30 @@ Status VariableOpPass::GenerateVariableVariableRefMap(const ComputeGraphPtr &com
     }
     std::string ref_var_name;
     if (!ge::AttrUtils::GetStr(node->GetOpDesc(), REF_VAR_SRC_VAR_NAME, ref_var_name)) {
-      names_to_var[node->GetName()] = node;
+      (void)var_to_refs[node];
     } else {
-      names_to_refs[ref_var_name].insert(node);
+      ref_names_to_refs.emplace_back(ref_var_name, node);
     }
   }
 
-  for (auto &name_to_var : names_to_var) {
-    var_and_var_ref_map_[name_to_var.second] = names_to_refs[name_to_var.first];
+  for (auto &ref_name_to_ref : ref_names_to_refs) {
+    // The variable is looked up in the graph of the ref first, and then in the root graph
+    NodePtr var_node;
+    auto owner_graph = ref_name_to_ref.second->GetOwnerComputeGraph();
+    if (owner_graph != nullptr) {
+      var_node = owner_graph->FindNode(ref_name_to_ref.first);
+    }
+    if (var_node == nullptr || var_to_refs.count(var_node) == 0) {
+      var_node = compute_graph->FindNode(ref_name_to_ref.first);
+    }
+    auto iter = var_to_refs.find(var_node);
+    if (iter != var_to_refs.end()) {
+      (void)iter->second.insert(ref_name_to_ref.second);
+    }
+  }
+
+  for (auto &var_to_ref : var_to_refs) {
+    var_and_var_ref_map_[var_to_ref.first] = var_to_ref.second;
   }
   return SUCCESS;
 }
@@ -793,7 +793,7 @@ Status GraphPrepare::UpdateInput(const std::vector<GeTensor> &user_input) {
   return SUCCESS;
 }
 
-Status GraphPrepare::TryDoAipp() {
+Status GraphPrepare::TryDoAipp(bool is_sorted) {
   // infer and with aipp configure file, then call aipp insert
   if ((!options_.train_graph_flag) && (!options_.insert_op_file.empty())) {
     GraphUtils::DumpGEGraph(compute_graph_, "Before_insert_aipp");
@@ -809,7 +809,7 @@ Status GraphPrepare::TryDoAipp() {
              options_.insert_op_file.c_str());
       return GE_GRAPH_OPTIMIZE_INSERT_OP_PARSE_FAILED;
     }
-    ret = ge::InsertNewOpUtil::Instance().InsertAippOps(compute_graph_, options_.insert_op_file);
+    ret = ge::InsertNewOpUtil::Instance().InsertAippOps(compute_graph_, options_.insert_op_file, is_sorted);
     if (ret != SUCCESS) {
       GELOGE(GE_GRAPH_OPTIMIZE_INSERT_DYN_OP_FAILED, "TryDoAipp: insert aipp op ret failed, ret:%u", ret);
       return GE_GRAPH_OPTIMIZE_INSERT_DYN_OP_FAILED;
@@ -1016,6 +1016,7 @@ Status GraphPrepare::Preprocess(const std::vector<GeTensor> &user_input) {
   }
   GraphUtils::DumpGEGraph(compute_graph_, "after_update_input");
   GraphUtils::DumpGEGraphToOnnx(*compute_graph_, "after_update_input");
+  bool is_sorted = false;
   if (user_input.size() != 0) {
     ret = CheckConstOp();
     if (ret != SUCCESS) {
@@ -1028,8 +1029,9 @@ Status GraphPrepare::Preprocess(const std::vector<GeTensor> &user_input) {
       GELOGE(ret, "graph prepare error: compute_graph_->Topological Sorting");
       return FAILED;
     }
+    is_sorted = true;
   }
-  ret = TryDoAipp();
+  ret = TryDoAipp(is_sorted);
   if (ret != SUCCESS) {
     return ret;
   }
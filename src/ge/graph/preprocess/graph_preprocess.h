@@ -60,7 +60,7 @@ class GraphPrepare {
   Status CheckUserInput(const std::vector<GeTensor> &user_input);
   Status OptimizeForPreprocess();
   Status InferShapeForPreprocess();
-  Status TryDoAipp();
+  Status TryDoAipp(bool is_sorted);
   Status OptimizeForDataAfterInfershape();
   Status UpdateVariableFormats(ComputeGraphPtr &graph);
   Status FormatAndShapeProcess();
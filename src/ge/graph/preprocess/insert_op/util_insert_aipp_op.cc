@@ -224,8 +224,9 @@ Status InsertNewOpUtil::InsertNewOps(const ComputeGraphPtr &graph) {
   return SUCCESS;
 }
 
-Status InsertNewOpUtil::InsertAippOps(ComputeGraphPtr &graph, std::string &aippConfigPath) {
+Status InsertNewOpUtil::InsertAippOps(ComputeGraphPtr &graph, std::string &aippConfigPath, bool is_sorted) {
   GE_CHECK_NOTNULL(graph);
+  std::vector<NodePtr> aipp_nodes;
   for (auto &insert_op : insert_ops_) {
     AippOpParams::AippMode aipp_mode = insert_op->GetAippMode();
     ge::NodePtr aipp_node = nullptr;
@@ -234,6 +235,7 @@ Status InsertNewOpUtil::InsertAippOps(ComputeGraphPtr &graph, std::string &aippC
       GELOGE(FAILED, "aipp node is null!");
       return FAILED;
     }
+    aipp_nodes.push_back(aipp_node);
     if (aipp_mode == AippOpParams::dynamic) {
       Status stat = AddAippInputData(aipp_node, graph);
       if (stat != SUCCESS) {
@@ -245,7 +247,12 @@ Status InsertNewOpUtil::InsertAippOps(ComputeGraphPtr &graph, std::string &aippC
 
   GE_CHK_STATUS_RET(CheckGraph(graph), "after inserting all ops, check graph failed");
 
-  GE_CHK_STATUS_RET(graph->TopologicalSorting(), "after insert dynamic op, sort graph failed");
+  // Every changed edge, including the one from the aipp input data, is linked to an aipp node
+  if (is_sorted) {
+    GE_CHK_STATUS_RET(graph->IncrementalTopologicalSorting(aipp_nodes), "after insert aipp op, sort graph failed");
+  } else {
+    GE_CHK_STATUS_RET(graph->TopologicalSorting(), "after insert dynamic op, sort graph failed");
+  }
 
   ClearNewOps();
 
@@ -40,7 +40,7 @@ class InsertNewOpUtil {
 
   Status InsertNewOps(const ge::ComputeGraphPtr &graph);
 
-  Status InsertAippOps(ge::ComputeGraphPtr &graph, std::string &aippConfigPath);
+  Status InsertAippOps(ge::ComputeGraphPtr &graph, std::string &aippConfigPath, bool is_sorted);
 
   void ClearNewOps();
 
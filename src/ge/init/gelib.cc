@@ -16,6 +16,7 @@
 
 #include "init/gelib.h"
 #include <dlfcn.h>
+#include <algorithm>
 #include <cstdlib>
 #include <mutex>
 #include <set>
@@ -28,6 +29,7 @@
 #include "common/profiling/profiling_manager.h"
 #include "graph/manager/graph_mem_allocator.h"
 #include "graph/manager/graph_var_manager.h"
+#include "graph/manager/host_mem_pool.h"
 #include "runtime/kernel.h"
 #include "graph/ge_context.h"
 #include "graph/ge_global_options.h"
@@ -35,13 +37,43 @@
 #include <cstdlib>
 #include "graph/load/new_model_manager/model_manager.h"
 #include "omm/csa_interact.h"
+#include "common/build_tracer.h"
 #include "common/properties_manager.h"
+#include "framework/common/string_util.h"
 
 using Json = nlohmann::json;
 
 namespace ge {
 namespace {
 const int kDecimal = 10;
+
+void InitAsyncDumpOptions(const map<string, string> &options) {
+  AsyncDumpOptions dump_options;
+  auto iter = options.find(OPTION_EXEC_DUMP_ASYNC);
+  dump_options.enable = (iter != options.end()) && (iter->second == "1");
+  iter = options.find(OPTION_EXEC_DUMP_STEP_INTERVAL);
+  if (iter != options.end()) {
+    dump_options.step_interval = std::max(std::strtoull(iter->second.c_str(), nullptr, kDecimal), 1ULL);
+  }
+  iter = options.find(OPTION_EXEC_DUMP_OP_FILTER);
+  if (iter != options.end()) {
+    for (auto &op_filter : StringUtils::Split(iter->second, ',')) {
+      if (!StringUtils::Trim(op_filter).empty()) {
+        dump_options.op_filters.push_back(op_filter);
+      }
+    }
+  }
+  iter = options.find(OPTION_EXEC_DUMP_ON_NAN_INF);
+  dump_options.nan_inf_only = (iter != options.end()) && (iter->second == "1");
+  iter = options.find(OPTION_EXEC_DUMP_BUFFER_NUM);
+  if (iter != options.end()) {
+    dump_options.buffer_num = std::max(static_cast<uint32_t>(std::strtoul(iter->second.c_str(), nullptr, kDecimal)), 1U);
+  }
+  GELOGI("Async dump %d, step interval %lu, op filter num %zu, nan inf only %d, buffer num %u.", dump_options.enable,
+         dump_options.step_interval, dump_options.op_filters.size(), dump_options.nan_inf_only,
+         dump_options.buffer_num);
+  PropertiesManager::Instance().SetAsyncDumpOptions(dump_options);
+}
 }  // namespace
 static std::shared_ptr<GELib> instancePtr_ = nullptr;
 
@@ -57,6 +89,10 @@ Status GELib::Initialize(const map<string, string> &options) {
   }
   GetMutableGlobalOptions().insert(options.begin(), options.end());
   GetThreadLocalContext().SetGlobalOption(GetMutableGlobalOptions());
+  auto trace_iter = options.find(OPTION_BUILD_TRACE_FILE);
+  if ((trace_iter != options.end()) && !trace_iter->second.empty()) {
+    BuildTracer::Instance().Start(trace_iter->second);
+  }
   GE_TIMESTAMP_START(Init);
   Status ret = instancePtr_->InnerInitialize(options);
   if (ret != SUCCESS) {
@@ -144,6 +180,7 @@ Status GELib::SystemInitialize(const map<string, string> &options) {
 
       PropertiesManager::Instance().AddDumpPropertyValue(DUMP_ALL_MODEL, {});
       PropertiesManager::Instance().SetDumpOutputPath(dump_path);
+      InitAsyncDumpOptions(options);
     }
   }
 
@@ -342,6 +379,14 @@ Status GELib::Finalize() {
   GELOGI("MemManager finalization.");
   MemManager::Instance().Finalize();
 
+  GELOGI("HostMemPool finalization.");
+  HostMemPool::Instance().Release();
+
+  GELOGI("BuildTracer finalization.");
+  if (BuildTracer::Instance().Stop() != SUCCESS) {
+    GELOGW("Write build trace failed.");
+  }
+
 #ifdef DAVINCI_CLOUD
   if (is_train_mode_) {
     GELOGI("System ShutDown.");
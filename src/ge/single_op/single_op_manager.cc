@@ -106,6 +106,64 @@ Status SingleOpManager::GetOpFromModel(const std::string &model_name,
   return SUCCESS;
 }
 
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY
+Status SingleOpManager::LoadArchive(const ModelData &archive_data, uint64_t &archive_id) {
+  if (archive_data.model_data == nullptr) {
+    GELOGE(PARAM_INVALID, "archive data is null");
+    return PARAM_INVALID;
+  }
+
+  std::unique_ptr<SingleOpArchive> archive(new(std::nothrow) SingleOpArchive());
+  if (archive == nullptr) {
+    GELOGE(MEMALLOC_FAILED, "new SingleOpArchive failed");
+    return MEMALLOC_FAILED;
+  }
+  auto ret = archive->Load(static_cast<const uint8_t *>(archive_data.model_data), archive_data.model_len);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "Load single op archive failed.");
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  archive_id = next_archive_id_++;
+  archives_.emplace(archive_id, std::move(archive));
+  GELOGI("Load single op archive %lu.", archive_id);
+  return SUCCESS;
+}
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY
+Status SingleOpManager::GetOpFromArchive(const std::string &key,
+                                         uint64_t archive_id,
+                                         void *stream,
+                                         SingleOp **single_op) {
+  ModelData model_data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = archives_.find(archive_id);
+    if (it == archives_.end()) {
+      GELOGE(PARAM_INVALID, "Single op archive %lu is not loaded.", archive_id);
+      return PARAM_INVALID;
+    }
+    auto ret = it->second->FindModel(key, model_data);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+
+  return GetOpFromModel(key, model_data, stream, single_op);
+}
+
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY
+Status SingleOpManager::UnloadArchive(uint64_t archive_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (archives_.erase(archive_id) == 0) {
+    GELOGE(PARAM_INVALID, "Single op archive %lu is not loaded.", archive_id);
+    return PARAM_INVALID;
+  }
+  GELOGI("Unload single op archive %lu.", archive_id);
+  return SUCCESS;
+}
+
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY
 Status SingleOpManager::ReleaseResource(void *stream) {
   auto resource_id = reinterpret_cast<uintptr_t>(stream);
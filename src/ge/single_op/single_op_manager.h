@@ -17,10 +17,12 @@
 #ifndef GE_SINGLE_OP_SINGLE_OP_MANAGER_H_
 #define GE_SINGLE_OP_SINGLE_OP_MANAGER_H_
 
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <string>
 
+#include "common/single_op_archive.h"
 #include "single_op/single_op_model.h"
 #include "single_op/stream_resource.h"
 
@@ -36,6 +38,14 @@ class SingleOpManager {
 
   Status GetOpFromModel(const std::string &key, const ge::ModelData &model_data, void *stream, SingleOp **single_op);
 
+  // Index an archive of single op models, archive data is referred to until the archive is unloaded
+  Status LoadArchive(const ge::ModelData &archive_data, uint64_t &archive_id);
+
+  // Get op of key from a loaded archive, only the model of key is loaded
+  Status GetOpFromArchive(const std::string &key, uint64_t archive_id, void *stream, SingleOp **single_op);
+
+  Status UnloadArchive(uint64_t archive_id);
+
   Status ReleaseResource(void *stream);
 
  private:
@@ -44,6 +54,9 @@ class SingleOpManager {
 
   std::mutex mutex_;
   std::unordered_map<uintptr_t, StreamResource *> stream_resources_;
+  uint64_t next_archive_id_ = 0;
+  // <archive id, indexed archive>
+  std::unordered_map<uint64_t, std::unique_ptr<SingleOpArchive>> archives_;
 };
 }  // namespace ge
 
@@ -97,6 +97,20 @@ mmSsize_t mmWrite(INT32 fd, VOID *mm_buf, UINT32 mm_count) {
   return result;
 }
 
+LONG mmLseek(INT32 fd, INT64 offset, INT32 seek_flag) {
+  if (fd < MMPA_ZERO) {
+    syslog(LOG_ERR, "The file fd is invalid.\r\n");
+    return EN_INVALID_PARAM;
+  }
+
+  LONG result = lseek(fd, (off_t)offset, seek_flag);
+  if (result < MMPA_ZERO) {
+    syslog(LOG_ERR, "Seek file failed, errno is %s.\r\n", strerror(errno));
+    return EN_ERROR;
+  }
+  return result;
+}
+
 mmSsize_t mmRead(INT32 fd, VOID *mm_buf, UINT32 mm_count) {
   mmSsize_t result = MMPA_ZERO;
 
@@ -348,7 +348,7 @@ class InsertNewOpUtil {
   InsertNewOpUtil();
   ~InsertNewOpUtil();
   Status InsertNewOps(const ComputeGraphPtr &graph);
-  Status InsertAippOps(ge::ComputeGraphPtr graph, std::string &aipp_config_path);
+  Status InsertAippOps(ge::ComputeGraphPtr graph, std::string &aipp_config_path, bool is_sorted);
   Status Parse(const char *conf_path);
 };
 
@@ -356,7 +356,9 @@ InsertNewOpUtil::InsertNewOpUtil() {}
 
 Status InsertNewOpUtil::InsertNewOps(const ComputeGraphPtr &graph) { return SUCCESS; }
 
-Status InsertNewOpUtil::InsertAippOps(ge::ComputeGraphPtr graph, std::string &aipp_config_path) { return SUCCESS; }
+Status InsertNewOpUtil::InsertAippOps(ge::ComputeGraphPtr graph, std::string &aipp_config_path, bool is_sorted) {
+  return SUCCESS;
+}
 
 Status InsertNewOpUtil::Parse(const char *conf_path) { return SUCCESS; }
 
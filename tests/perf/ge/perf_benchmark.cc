@@ -0,0 +1,907 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/build_tracer.h"
+#include "common/profiling/profiling_event_buffer.h"
+#include "common/thread_pool.h"
+#include "common/types.h"
+#include "graph/build/memory/hybrid_mem_assigner.h"
+#include "graph/graph_arena.h"
+#include "graph/load/new_model_manager/async_data_dumper.h"
+#include "graph/load/new_model_manager/dynamic_batcher.h"
+#include "graph/load/new_model_manager/tbe_handle_store.h"
+#include "graph/manager/trans_var_data_utils.h"
+#include "graph/model.h"
+#include "graph/model_serialize.h"
+#include "graph/passes/base_pass.h"
+#include "graph/passes/constant_folding_pass.h"
+#include "graph/utils/graph_utils.h"
+#include "perf_result.h"
+#include "runtime/kernel.h"
+#include "runtime/mem.h"
+#include "securec.h"
+#include "synthetic_graph.h"
+#include "toolchain/prof_reporter.h"
+
+#define private public
+#include "graph/build/stream_allocator.h"
+#include "graph/execute/graph_execute.h"
+#include "graph/manager/host_mem_pool.h"
+#include "single_op/single_op.h"
+#include "single_op/task/op_task.h"
+#undef private
+
+using namespace ge;
+using namespace ge::perf;
+
+namespace {
+struct BenchmarkOptions {
+  std::vector<GraphKind> graphs = {kChainGraph, kWideGraph, kResNetGraph, kTransformerGraph};
+  // Larger graphs up to 200000 nodes are given by --sizes, they take minutes for each stage
+  std::vector<int64_t> sizes = {10000, 50000};
+  int repeat = 3;
+  int64_t dispatch_num = 1000000;
+  int64_t kernel_num = 2000;
+  int load_threads = 8;
+  int64_t batch_requests = 1000;
+  int64_t arena_nodes = 100000;
+  int64_t profiling_runs = 2000;
+  int64_t buffer_steps = 500;
+  int64_t dump_iterations = 1000;
+  int64_t trans_vars = 10000;
+  int64_t trace_scopes = 100000;
+  std::string output;
+  std::string baseline;
+  double tolerance = 0.1;
+};
+
+const char *const kUsage =
+  "Usage: perf_ge_benchmark [options]\n"
+  "  --graphs=chain,wide,resnet,transformer  synthetic graphs to run, all by default\n"
+  "  --sizes=10000,50000                     node numbers of graphs, e.g. 10000,50000,200000\n"
+  "  --repeat=3                              runs of each stage, the fastest one is reported\n"
+  "  --dispatch_num=1000000                  single op launches, 0 to skip\n"
+  "  --kernel_num=2000                       kernels shared by models loaded in parallel, 0 to skip\n"
+  "  --load_threads=8                        threads loading models in parallel\n"
+  "  --batch_requests=1000                   requests of poisson arrivals to dynamic batcher, 0 to skip\n"
+  "  --arena_nodes=100000                    nodes of chain graph built on heap and in graph arena, 0 to skip\n"
+  "  --profiling_runs=2000                   runs of a model of 500 ops reported to profiling, 0 to skip\n"
+  "  --buffer_steps=500                      steps of input and output host buffers of dynamic batch, 0 to skip\n"
+  "  --dump_iterations=1000                  iterations of a model of 256 outputs with async dump, 0 to skip\n"
+  "  --trans_vars=10000                      variables cast from float to float16 on host, 0 to skip\n"
+  "  --trace_scopes=100000                   build trace scopes with the tracer stopped and started, 0 to skip\n"
+  "  --output=file                           write json lines to file instead of stdout\n"
+  "  --baseline=file                         compare with results of an earlier run, exit 1 on regression\n"
+  "  --tolerance=0.1                         allowed relative increase of time and peak rss\n";
+
+std::vector<std::string> Split(const std::string &str) {
+  std::vector<std::string> items;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool ParseOptions(int argc, char **argv, BenchmarkOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t pos = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || pos == std::string::npos) {
+      return false;
+    }
+    std::string key = arg.substr(2, pos - 2);
+    std::string value = arg.substr(pos + 1);
+    if (key == "graphs") {
+      options.graphs.clear();
+      for (const auto &name : Split(value)) {
+        GraphKind kind;
+        if (!ParseGraphKind(name, kind)) {
+          std::cerr << "Unknown graph " << name << std::endl;
+          return false;
+        }
+        options.graphs.push_back(kind);
+      }
+    } else if (key == "sizes") {
+      options.sizes.clear();
+      for (const auto &size : Split(value)) {
+        options.sizes.push_back(std::stoll(size));
+      }
+    } else if (key == "repeat") {
+      options.repeat = std::max(1, std::stoi(value));
+    } else if (key == "dispatch_num") {
+      options.dispatch_num = std::stoll(value);
+    } else if (key == "kernel_num") {
+      options.kernel_num = std::stoll(value);
+    } else if (key == "load_threads") {
+      options.load_threads = std::max(1, std::stoi(value));
+    } else if (key == "batch_requests") {
+      options.batch_requests = std::stoll(value);
+    } else if (key == "arena_nodes") {
+      options.arena_nodes = std::stoll(value);
+    } else if (key == "profiling_runs") {
+      options.profiling_runs = std::stoll(value);
+    } else if (key == "buffer_steps") {
+      options.buffer_steps = std::stoll(value);
+    } else if (key == "dump_iterations") {
+      options.dump_iterations = std::stoll(value);
+    } else if (key == "trans_vars") {
+      options.trans_vars = std::stoll(value);
+    } else if (key == "trace_scopes") {
+      options.trace_scopes = std::stoll(value);
+    } else if (key == "output") {
+      options.output = value;
+    } else if (key == "baseline") {
+      options.baseline = value;
+    } else if (key == "tolerance") {
+      options.tolerance = std::stod(value);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs a stage and keeps the fastest of repeated runs, metrics are taken from the last run
+class StageRecorder {
+ public:
+  StageRecorder(const std::string &graph, int64_t node_num) : graph_(graph), node_num_(node_num) {}
+
+  void Run(const std::string &stage, const std::function<Status(PerfResult &)> &func) {
+    PerfResult result;
+    result.graph = graph_;
+    result.node_num = node_num_;
+    result.stage = stage;
+    ResetPeakRss();
+    auto start = std::chrono::steady_clock::now();
+    result.status = func(result);
+    auto end = std::chrono::steady_clock::now();
+    result.time_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    result.peak_rss_kb = GetPeakRssKb();
+
+    for (auto &recorded : results_) {
+      if (recorded.stage == stage) {
+        result.time_us = std::min(result.time_us, recorded.time_us);
+        result.peak_rss_kb = std::min(result.peak_rss_kb, recorded.peak_rss_kb);
+        result.status = (recorded.status != SUCCESS) ? recorded.status : result.status;
+        recorded = result;
+        return;
+      }
+    }
+    results_.push_back(result);
+  }
+
+  const std::vector<PerfResult> &GetResults() const { return results_; }
+
+ private:
+  std::string graph_;
+  int64_t node_num_;
+  std::vector<PerfResult> results_;
+};
+
+// Inserts a cast on the last data edge of the graph, as passes insert nodes locally
+NodePtr InsertCastNearTail(const ComputeGraphPtr &graph) {
+  auto nodes = graph->GetDirectNode();
+  std::vector<NodePtr> direct_nodes(nodes.begin(), nodes.end());
+  for (auto iter = direct_nodes.rbegin(); iter != direct_nodes.rend(); ++iter) {
+    for (const auto &in_anchor : (*iter)->GetAllInDataAnchors()) {
+      auto peer_out_anchor = in_anchor->GetPeerOutAnchor();
+      if (peer_out_anchor == nullptr) {
+        continue;
+      }
+      auto op_desc = std::make_shared<OpDesc>("perf_cast", CAST);
+      (void)op_desc->AddInputDesc(GeTensorDesc());
+      (void)op_desc->AddOutputDesc(GeTensorDesc());
+      NodePtr cast = graph->AddNode(op_desc);
+      if (cast == nullptr || GraphUtils::InsertNodeBetweenDataAnchors(peer_out_anchor, in_anchor, cast) != SUCCESS) {
+        return nullptr;
+      }
+      return cast;
+    }
+  }
+  return nullptr;
+}
+
+void RunGraphStages(GraphKind kind, int64_t node_num, StageRecorder &recorder) {
+  // Stages change the graph, so every run starts from a new graph
+  ComputeGraphPtr graph;
+  recorder.Run("build", [&graph, kind, node_num](PerfResult &result) -> Status {
+    graph = BuildSyntheticGraph(kind, static_cast<size_t>(node_num));
+    if (graph == nullptr) {
+      return FAILED;
+    }
+    result.metrics["real_node_num"] = static_cast<int64_t>(graph->GetDirectNodesSize());
+    return SUCCESS;
+  });
+  if (graph == nullptr) {
+    return;
+  }
+
+  recorder.Run("topo_sort", [&graph](PerfResult &) { return graph->TopologicalSorting(); });
+
+  recorder.Run("find_node", [&graph](PerfResult &result) -> Status {
+    int64_t found_num = 0;
+    for (const auto &node : graph->GetDirectNode()) {
+      if (graph->FindNode(node->GetName()) != nullptr) {
+        ++found_num;
+      }
+    }
+    result.metrics["found_num"] = found_num;
+    return (found_num == static_cast<int64_t>(graph->GetDirectNodesSize())) ? SUCCESS : FAILED;
+  });
+
+  NodePtr cast = InsertCastNearTail(graph);
+  recorder.Run("incremental_sort", [&graph, &cast](PerfResult &) -> Status {
+    return (cast != nullptr) ? graph->IncrementalTopologicalSorting({cast}) : FAILED;
+  });
+
+  recorder.Run("passes", [&graph](PerfResult &result) -> Status {
+    ConstantFoldingPass constant_folding_pass;
+    NamesToPass names_to_passes = {{"ConstantFoldingPass", &constant_folding_pass}};
+    GEPass ge_passes(graph);
+    Status ret = ge_passes.Run(names_to_passes);
+    result.metrics["pass_node_num"] = static_cast<int64_t>(graph->GetDirectNodesSize());
+    return ret;
+  });
+
+  recorder.Run("mem_assign", [&graph](PerfResult &result) -> Status {
+    HybridMemAssigner mem_assigner(graph);
+    Status ret = mem_assigner.Assign();
+    result.metrics["mem_bytes"] = static_cast<int64_t>(mem_assigner.GetMemOffset());
+    return ret;
+  });
+
+  recorder.Run("stream_assign", [&graph](PerfResult &result) -> Status {
+    // Streams are given by the graph builder, so logical stream assignment is skipped
+    StreamAllocator stream_allocator(graph, {});
+    stream_allocator.stream_num_ = kSyntheticStreamNum;
+    int64_t stream_num = 0;
+    int64_t event_num = 0;
+    Status ret = stream_allocator.RefreshRealStream(stream_num, event_num);
+    result.metrics["stream_num"] = stream_num;
+    result.metrics["event_num"] = event_num;
+    return ret;
+  });
+
+  Buffer buffer;
+  recorder.Run("serialize", [&graph, &buffer](PerfResult &result) -> Status {
+    Model model(graph->GetName(), "");
+    model.SetGraph(GraphUtils::CreateGraphFromComputeGraph(graph));
+    buffer = ModelSerialize().SerializeModel(model);
+    result.metrics["model_bytes"] = static_cast<int64_t>(buffer.GetSize());
+    return (buffer.GetSize() > 0) ? SUCCESS : FAILED;
+  });
+
+  recorder.Run("load", [&buffer](PerfResult &) -> Status {
+    if (buffer.GetSize() == 0) {
+      return FAILED;
+    }
+    Model model = ModelSerialize().UnserializeModel(buffer.GetData(), buffer.GetSize());
+    return model.IsValid() ? SUCCESS : FAILED;
+  });
+}
+
+void RunSingleOpDispatch(int64_t dispatch_num, StageRecorder &recorder) {
+  // Inputs and outputs of a task are patched to the buffers given to each launch
+  const size_t kArgNum = 3;
+  const size_t kBufferSize = 1024;
+  static char stub_func = 0;
+  SingleOp single_op;
+  auto *task = new (std::nothrow) TbeOpTask();
+  if (task == nullptr) {
+    return;
+  }
+  void *args = nullptr;
+  (void)rtMallocHost(&args, kArgNum * sizeof(uintptr_t));
+  task->SetStubFunc("perf_stub", &stub_func);
+  task->SetKernelArgs(args, kArgNum * sizeof(uintptr_t), 1);
+  single_op.tasks_.push_back(task);
+  single_op.input_sizes_ = {kBufferSize, kBufferSize};
+  single_op.output_sizes_ = {kBufferSize};
+  single_op.args_.resize(kArgNum);
+  for (size_t i = 0; i < kArgNum; ++i) {
+    single_op.arg_table_.push_back({reinterpret_cast<uintptr_t *>(args) + i});
+  }
+
+  std::vector<char> memory(kBufferSize * kArgNum);
+  std::vector<DataBuffer> inputs = {{&memory[0], kBufferSize, false}, {&memory[kBufferSize], kBufferSize, false}};
+  std::vector<DataBuffer> outputs = {{&memory[kBufferSize * 2], kBufferSize, false}};
+  recorder.Run("dispatch", [&](PerfResult &result) -> Status {
+    for (int64_t i = 0; i < dispatch_num; ++i) {
+      Status ret = single_op.ExecuteAsync(inputs, outputs);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    }
+    result.metrics["dispatch_num"] = dispatch_num;
+    return SUCCESS;
+  });
+}
+void RunKernelLoad(int64_t kernel_num, int load_threads, StageRecorder &recorder) {
+  // Every thread loads and unloads models of the same graph, so all kernels are shared
+  const int kLoadNum = 10;
+  std::vector<std::pair<std::string, std::shared_ptr<OpKernelBin>>> kernels;
+  std::map<std::string, uint32_t> names;
+  for (int64_t i = 0; i < kernel_num; ++i) {
+    std::string name = "perf_graph_te_op_" + std::to_string(i) + "_tvmbin";
+    std::vector<char> data(1024, static_cast<char>(i));
+    kernels.emplace_back(name, std::make_shared<OpKernelBin>(name, std::move(data)));
+    names[name] = 1;
+  }
+
+  recorder.Run("kernel_load", [&](PerfResult &result) -> Status {
+    std::atomic<int64_t> register_num(0);
+    std::atomic<bool> failed(false);
+    auto load = [&]() {
+      TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+      for (int i = 0; i < kLoadNum; ++i) {
+        auto prepare = [&kernels, &register_num](size_t index, void *&handle) -> Status {
+          if (handle == nullptr) {
+            rtDevBinary_t binary;
+            binary.magic = RT_DEV_BINARY_MAGIC_ELF;
+            binary.version = 0;
+            binary.data = kernels[index].second->GetBinData();
+            binary.length = kernels[index].second->GetBinDataSize();
+            if (rtDevBinaryRegister(&binary, &handle) != RT_ERROR_NONE) {
+              return RT_FAILED;
+            }
+            // Stub runtime gives no handle
+            handle = (handle == nullptr) ? kernels[index].second.get() : handle;
+            register_num++;
+          }
+          const char *stub_name = kernels[index].first.c_str();
+          return (rtFunctionRegister(handle, stub_name, stub_name, stub_name, 0) == RT_ERROR_NONE) ? SUCCESS
+                                                                                                   : RT_FAILED;
+        };
+        if (kernel_store.ReferTBEHandles(kernels, prepare) != SUCCESS) {
+          failed = true;
+        }
+        kernel_store.EraseTBEHandle(names);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < load_threads; ++i) {
+      threads.emplace_back(load);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    result.metrics["model_num"] = static_cast<int64_t>(load_threads) * kLoadNum;
+    result.metrics["register_num"] = register_num.load();
+    return failed ? FAILED : SUCCESS;
+  });
+}
+
+void RunDynamicBatch(int64_t request_num, StageRecorder &recorder) {
+  // Requests arrive at 5000 per second, and a batch takes 200us to launch and 10us per sample,
+  // so running them one by one keeps up with at most 4762 requests per second.
+  const double kArrivalsPerSecond = 5000.0;
+  const int64_t kLaunchUs = 200;
+  const int64_t kSampleUs = 10;
+  const uint32_t kSampleSize = 16;
+  const std::vector<std::vector<uint32_t>> kBatchSizes = {{1}, {1, 2, 4, 8, 16}};
+  for (const auto &batch_sizes : kBatchSizes) {
+    recorder.Run("max_batch_" + std::to_string(batch_sizes.back()), [&](PerfResult &result) -> Status {
+      auto dispatcher = [&](const InputData &input_data, OutputData &) -> Status {
+        uint32_t batch_size = input_data.blobs[0].length / kSampleSize;
+        std::this_thread::sleep_for(std::chrono::microseconds(kLaunchUs + kSampleUs * batch_size));
+        return SUCCESS;
+      };
+      DynamicBatchOptions options;
+      options.batch_sizes = batch_sizes;
+      options.max_delay_us = 500;
+      options.has_batch_shape_input = false;
+      DynamicBatcher batcher(1, options, dispatcher);
+      Status ret = batcher.Init();
+      if (ret != SUCCESS) {
+        return ret;
+      }
+
+      std::mutex mutex;
+      std::condition_variable cond;
+      int64_t done_num = 0;
+      bool failed = false;
+      auto done = [&](Status status) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done_num++;
+        failed = failed || (status != SUCCESS);
+        cond.notify_all();
+      };
+      std::vector<uint8_t> input(kSampleSize);
+      std::vector<uint8_t> output(kSampleSize);
+      std::mt19937 engine(0);
+      std::exponential_distribution<double> interval_dist(kArrivalsPerSecond);
+      auto arrival = std::chrono::steady_clock::now();
+      for (int64_t i = 0; (i < request_num) && (ret == SUCCESS); ++i) {
+        arrival += std::chrono::microseconds(static_cast<int64_t>(interval_dist(engine) * 1000000));
+        std::this_thread::sleep_until(arrival);
+        ret = batcher.Submit({DataBuffer(input.data(), kSampleSize, false)},
+                             {DataBuffer(output.data(), kSampleSize, false)}, done);
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return (ret != SUCCESS) || (done_num >= request_num); });
+      }
+      batcher.Finalize();
+      result.metrics["request_num"] = request_num;
+      return ((ret != SUCCESS) || failed) ? FAILED : SUCCESS;
+    });
+  }
+}
+
+void RunArenaBuild(int64_t node_num, StageRecorder &recorder) {
+  // Graph is built and released in each stage, so the release is timed too
+  recorder.Run("heap", [node_num](PerfResult &) -> Status {
+    ComputeGraphPtr graph = BuildSyntheticGraph(kChainGraph, static_cast<size_t>(node_num));
+    return (graph != nullptr) ? SUCCESS : FAILED;
+  });
+
+  recorder.Run("arena", [node_num](PerfResult &result) -> Status {
+    auto arena = std::make_shared<GraphArena>();
+    {
+      GraphArenaScope scope(arena);
+      ComputeGraphPtr graph = BuildSyntheticGraph(kChainGraph, static_cast<size_t>(node_num));
+      if (graph == nullptr) {
+        return FAILED;
+      }
+    }
+    result.metrics["arena_alloc_num"] = static_cast<int64_t>(arena->GetAllocCount());
+    result.metrics["heap_alloc_num"] = static_cast<int64_t>(arena->GetChunkCount());
+    return (arena->GetUsedSize() == 0) ? SUCCESS : FAILED;
+  });
+}
+
+// Counts reports like the profiling reporter, which copies each report
+class CountReporter : public Msprof::Engine::Reporter {
+ public:
+  int Report(const Msprof::Engine::ReporterData *data) override {
+    report_num_++;
+    data_.assign(data->data, data->data + data->dataLen);
+    return 0;
+  }
+
+  int Flush() override { return 0; }
+
+  int64_t report_num_ = 0;
+
+ private:
+  std::vector<unsigned char> data_;
+};
+
+int ReportText(CountReporter &reporter, const std::string &data) {
+  Msprof::Engine::ReporterData reporter_data{};
+  reporter_data.data = (unsigned char *)data.c_str();
+  reporter_data.dataLen = data.size();
+  if (memcpy_s(reporter_data.tag, MSPROF_ENGINE_MAX_TAG_LEN + 1, "framework", sizeof("framework")) != EOK) {
+    return -1;
+  }
+  return reporter.Report(&reporter_data);
+}
+
+void RunProfilingReport(int64_t run_num, StageRecorder &recorder) {
+  const uint32_t kOpNum = 500;
+  std::map<uint32_t, std::string> op_task_id_map;
+  for (uint32_t i = 0; i < kOpNum; ++i) {
+    op_task_id_map[i * 3] = "resnet50/layer" + std::to_string(i / 10) + "/conv2d_" + std::to_string(i) + "/Conv2D";
+  }
+
+  // Text of each op built and reported on the run thread, as ReportProfilingData of op_task_id_map
+  recorder.Run("per_op_report", [&](PerfResult &result) -> Status {
+    CountReporter reporter;
+    for (int64_t i = 0; i < run_num; ++i) {
+      for (const auto &iter : op_task_id_map) {
+        if (ReportText(reporter, iter.second + ' ' + std::to_string(iter.first) + ';') != 0) {
+          return FAILED;
+        }
+      }
+    }
+    result.metrics["report_num"] = reporter.report_num_;
+    return SUCCESS;
+  });
+
+  // Run thread only pushes records, rings have room for all of them so nothing is dropped
+  ProfilingEventBuffer buffer(static_cast<size_t>(run_num) * kOpNum);
+  std::vector<ProfEventRecord> records;
+  for (const auto &iter : op_task_id_map) {
+    ProfEventRecord record;
+    record.op_name_id = buffer.InternName(iter.second);
+    record.task_id = iter.first;
+    records.push_back(record);
+  }
+  recorder.Run("event_record", [&](PerfResult &result) -> Status {
+    for (int64_t i = 0; i < run_num; ++i) {
+      buffer.Record(records.data(), records.size());
+    }
+    ProfEventStats stats;
+    buffer.GetStats(stats);
+    result.metrics["dropped_num"] = static_cast<int64_t>(stats.dropped_num);
+    return (stats.dropped_num == 0) ? SUCCESS : FAILED;
+  });
+
+  // Records are kept until the sink is set, so all of them are exported at once
+  recorder.Run("event_export", [&](PerfResult &result) -> Status {
+    CountReporter reporter;
+    Status ret = buffer.Start([&reporter](const std::string &data) -> int { return ReportText(reporter, data); });
+    buffer.Stop();
+    ProfEventStats stats;
+    buffer.GetStats(stats);
+    result.metrics["report_num"] = reporter.report_num_;
+    return ((ret == SUCCESS) && (stats.export_failed_num == 0)) ? SUCCESS : FAILED;
+  });
+}
+// Input and output sizes of a step, outputs change every few steps like graphs of dynamic batch
+std::vector<uint32_t> GetStepSizes(int64_t step) {
+  const uint32_t kOutputSizes[] = {1000, 64 * 1024, 300 * 1024, 1024 * 1024};
+  uint32_t batch = static_cast<uint32_t>(step / 4 % 4 + 1);
+  std::vector<uint32_t> sizes = {batch * 3 * 1024};
+  for (auto output_size : kOutputSizes) {
+    sizes.push_back(batch * output_size);
+  }
+  return sizes;
+}
+
+void RunStepBuffers(int64_t step_num, StageRecorder &recorder) {
+  // Buffers freed on every size change and outputs copied through a temporary buffer, as before the pool
+  std::vector<uint8_t> output_data(4 * 1024 * 1024, 1);
+  recorder.Run("free_on_resize", [&](PerfResult &result) -> Status {
+    int64_t alloc_num = 0;
+    bool failed = false;
+    std::vector<void *> buffer_addr;
+    std::vector<uint32_t> buffer_size;
+    for (int64_t step = 0; step < step_num; ++step) {
+      std::vector<uint32_t> sizes = GetStepSizes(step);
+      if (sizes != buffer_size) {
+        for (auto addr : buffer_addr) {
+          failed = (rtFreeHost(addr) != RT_ERROR_NONE) || failed;
+        }
+        buffer_addr.clear();
+        for (auto size : sizes) {
+          void *addr = nullptr;
+          failed = (rtMallocHost(&addr, size) != RT_ERROR_NONE) || failed;
+          buffer_addr.push_back(addr);
+          alloc_num++;
+        }
+        buffer_size = sizes;
+      }
+      for (size_t i = 1; i < sizes.size(); ++i) {
+        std::unique_ptr<uint8_t[]> out_buf_tmp(new (std::nothrow) uint8_t[sizes[i]]);
+        alloc_num++;
+        failed = (out_buf_tmp == nullptr) || failed;
+        failed = failed || (rtMemcpy(out_buf_tmp.get(), sizes[i], output_data.data(), sizes[i],
+                                     RT_MEMCPY_HOST_TO_HOST) != RT_ERROR_NONE);
+        GeTensor out_tensor;
+        failed = failed || (out_tensor.SetData(out_buf_tmp.get(), sizes[i]) != GRAPH_SUCCESS);
+      }
+    }
+    for (auto addr : buffer_addr) {
+      failed = (rtFreeHost(addr) != RT_ERROR_NONE) || failed;
+    }
+    result.metrics["alloc_num"] = alloc_num;
+    return failed ? FAILED : SUCCESS;
+  });
+
+  // Buffers of the executor come from the pool and outputs point to them directly
+  recorder.Run("host_mem_pool", [&](PerfResult &result) -> Status {
+    HostMemPool::Instance().Release();
+    HostMemPoolStats stats;
+    HostMemPool::Instance().GetStats(stats);
+    uint64_t malloc_count = stats.malloc_count;
+    GraphExecutor executor;
+    bool failed = false;
+    for (int64_t step = 0; step < step_num; ++step) {
+      std::vector<uint32_t> sizes = GetStepSizes(step);
+      std::vector<void *> addrs;
+      failed = (executor.MallocInOutBuffer(sizes, addrs) != SUCCESS) || failed;
+      for (size_t i = 1; (i < sizes.size()) && (i < addrs.size()); ++i) {
+        GeTensor out_tensor;
+        failed = failed || (out_tensor.SetData(reinterpret_cast<uint8_t *>(addrs[i]), sizes[i]) != GRAPH_SUCCESS);
+      }
+    }
+    HostMemPool::Instance().GetStats(stats);
+    result.metrics["alloc_num"] = static_cast<int64_t>(stats.malloc_count - malloc_count);
+    return failed ? FAILED : SUCCESS;
+  });
+}
+void RunAsyncDump(int64_t iteration_num, StageRecorder &recorder) {
+  const size_t kOpNum = 256;
+  const uint64_t kOutputSize = 16 * sizeof(float);
+  std::vector<float> dev_mem(kOpNum * 16, 1.0f);
+  std::vector<AsyncDumpOp> ops(kOpNum);
+  for (size_t i = 0; i < kOpNum; ++i) {
+    ops[i].task.set_task_id(static_cast<uint32_t>(i));
+    ops[i].task.mutable_op()->set_op_name("scope_" + std::to_string(i % 2) + "/op_" + std::to_string(i));
+    ops[i].task.mutable_op()->set_op_type("Add");
+    aicpu::dump::Output *output = ops[i].task.add_output();
+    output->set_data_type(DT_FLOAT);
+    output->set_address(reinterpret_cast<uintptr_t>(&dev_mem[i * 16]));
+    ops[i].output_sizes.push_back(kOutputSize);
+    ops[i].output_data_types.push_back(DT_FLOAT);
+  }
+
+  // Dump off, the same as a model without dump
+  recorder.Run("dump_off", [&](PerfResult &) -> Status {
+    AsyncDataDumper dumper;
+    for (int64_t iteration = 0; iteration < iteration_num; ++iteration) {
+      Status ret = dumper.DumpIteration(static_cast<uint64_t>(iteration), nullptr);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    }
+    return SUCCESS;
+  });
+
+  // Only the executing thread is timed, files are written by the dumper thread behind it
+  AsyncDumpOptions options;
+  options.enable = true;
+  options.step_interval = 10;
+  AsyncDataDumper dumper;
+  Status init_ret = dumper.Init("./perf_async_dump/", options, ops);
+  recorder.Run("dump_on", [&](PerfResult &result) -> Status {
+    if (init_ret != SUCCESS) {
+      return init_ret;
+    }
+    AsyncDumpStats stats;
+    dumper.GetStats(stats);
+    uint64_t sampled_count = stats.sampled_count + stats.dropped_count;
+    for (int64_t iteration = 0; iteration < iteration_num; ++iteration) {
+      Status ret = dumper.DumpIteration(static_cast<uint64_t>(iteration), nullptr);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    }
+    dumper.GetStats(stats);
+    result.metrics["sampled_num"] = static_cast<int64_t>(stats.sampled_count + stats.dropped_count - sampled_count);
+    return SUCCESS;
+  });
+  dumper.Finalize();
+}
+// Size taken by a variable in var memory, the same as MemResource::AssignVarMem
+uint64_t GetVarMemSize(uint64_t size) {
+  const uint64_t kVarAlignSize = 512;
+  return (size + kVarAlignSize - 1) / kVarAlignSize * kVarAlignSize + kVarAlignSize * 2;
+}
+
+void RunTransVarData(int64_t var_num, StageRecorder &recorder) {
+  const uint32_t kThreadNum = 16;
+  std::vector<int64_t> elem_nums;
+  uint64_t total_size = 0;
+  for (int64_t i = 0; i < var_num; ++i) {
+    // Mostly small variables like bias, with some large weights
+    int64_t elem_num = (i % 100 == 0) ? 256 * 1024 : ((i % 10 == 0) ? 16 * 1024 : 64 * (i % 7 + 1));
+    elem_nums.push_back(elem_num);
+    total_size += GetVarMemSize(elem_num * sizeof(float));
+  }
+
+  // Variables are laid out like var memory, each is rounded up and followed by padding
+  std::vector<uint8_t> src_mem(total_size, 0);
+  std::vector<uint8_t> dst_mem(total_size, 0);
+  std::vector<VarTransRoad> roads(elem_nums.size());
+  std::vector<VarTransTask> tasks(elem_nums.size());
+  uint64_t offset = 0;
+  for (size_t i = 0; i < elem_nums.size(); ++i) {
+    TransNodeInfo trans_info;
+    trans_info.node_type = CAST;
+    trans_info.input = GeTensorDesc(GeShape({elem_nums[i]}), FORMAT_ND, DT_FLOAT);
+    trans_info.output = GeTensorDesc(GeShape({elem_nums[i]}), FORMAT_ND, DT_FLOAT16);
+    roads[i] = {trans_info};
+    tasks[i].var_name = "var_" + std::to_string(i);
+    tasks[i].trans_road = &roads[i];
+    tasks[i].src_size = elem_nums[i] * sizeof(float);
+    tasks[i].src_addr = src_mem.data() + offset;
+    tasks[i].dst_size = elem_nums[i] * sizeof(uint16_t);
+    tasks[i].dst_addr = dst_mem.data() + offset;
+    offset += GetVarMemSize(tasks[i].src_size);
+  }
+
+  // One variable in a thread each time, with two copies of its own
+  recorder.Run("per_var", [&](PerfResult &result) -> Status {
+    ThreadPool executor(kThreadNum);
+    std::vector<std::future<Status>> futures;
+    for (const auto &task : tasks) {
+      futures.push_back(executor.commit([&task]() -> Status {
+        std::unique_ptr<uint8_t[]> var_data(new (std::nothrow) uint8_t[task.src_size]);
+        GE_CHECK_NOTNULL(var_data);
+        GE_CHK_RT_RET(rtMemcpy(var_data.get(), task.src_size, task.src_addr, task.src_size, RT_MEMCPY_DEVICE_TO_HOST));
+        formats::TransResult trans_result;
+        GE_CHK_STATUS_RET(TransVarDataUtils::TransVarOnHost(var_data.get(), *task.trans_road, trans_result));
+        GE_CHK_RT_RET(rtMemcpy(task.dst_addr, trans_result.length, trans_result.data.get(), trans_result.length,
+                               RT_MEMCPY_HOST_TO_DEVICE));
+        return SUCCESS;
+      }));
+    }
+    Status ret = SUCCESS;
+    for (auto &future : futures) {
+      Status task_ret = future.get();
+      ret = (ret == SUCCESS) ? task_ret : ret;
+    }
+    result.metrics["copy_num"] = static_cast<int64_t>(tasks.size() * 2);
+    return ret;
+  });
+
+  recorder.Run("batch", [&](PerfResult &result) -> Status {
+    VarTransStats stats;
+    Status ret = TransVarDataUtils::TransVarDataBatch(tasks, kThreadNum, stats);
+    result.metrics["copy_num"] = stats.copy_num;
+    result.metrics["batch_num"] = stats.batch_num;
+    return ret;
+  });
+}
+void RunBuildTrace(int64_t scope_num, StageRecorder &recorder) {
+  // Scopes are left in build code, so the cost with the tracer stopped is paid by every build
+  recorder.Run("disabled", [scope_num](PerfResult &result) -> Status {
+    for (int64_t i = 0; i < scope_num; ++i) {
+      GE_TRACE_SCOPE(Pass, "ConstantFoldingPass");
+      GE_TRACE_ARG(Pass, "node_num", i);
+    }
+    result.metrics["event_num"] = static_cast<int64_t>(BuildTracer::Instance().GetEventNum());
+    return SUCCESS;
+  });
+
+  recorder.Run("enabled", [scope_num](PerfResult &result) -> Status {
+    BuildTracer::Instance().Start("");
+    for (int64_t i = 0; i < scope_num; ++i) {
+      GE_TRACE_SCOPE(Pass, "ConstantFoldingPass");
+      GE_TRACE_ARG(Pass, "node_num", i);
+    }
+    result.metrics["event_num"] = static_cast<int64_t>(BuildTracer::Instance().GetEventNum());
+    Status ret = BuildTracer::Instance().Stop();
+    BuildTracer::Instance().Clear();
+    return ret;
+  });
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  BenchmarkOptions options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::cerr << kUsage;
+    return 2;
+  }
+
+  std::ofstream ofs;
+  if (!options.output.empty()) {
+    ofs.open(options.output, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+      std::cerr << "Open output file " << options.output << " failed." << std::endl;
+      return 2;
+    }
+  }
+  std::ostream &out = options.output.empty() ? std::cout : ofs;
+
+  std::vector<PerfResult> results;
+  auto flush = [&out, &results](const StageRecorder &recorder) {
+    for (const auto &result : recorder.GetResults()) {
+      out << ToJson(result) << std::endl;
+      results.push_back(result);
+    }
+  };
+  for (GraphKind kind : options.graphs) {
+    for (int64_t node_num : options.sizes) {
+      StageRecorder recorder(GetGraphKindName(kind), node_num);
+      for (int i = 0; i < options.repeat; ++i) {
+        RunGraphStages(kind, node_num, recorder);
+      }
+      flush(recorder);
+    }
+  }
+  if (options.dispatch_num > 0) {
+    StageRecorder recorder("single_op", 1);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunSingleOpDispatch(options.dispatch_num, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.kernel_num > 0) {
+    StageRecorder recorder("kernel_store", options.kernel_num);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunKernelLoad(options.kernel_num, options.load_threads, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.batch_requests > 0) {
+    StageRecorder recorder("dynamic_batch", options.batch_requests);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunDynamicBatch(options.batch_requests, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.arena_nodes > 0) {
+    StageRecorder recorder("graph_arena", options.arena_nodes);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunArenaBuild(options.arena_nodes, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.profiling_runs > 0) {
+    StageRecorder recorder("profiling", options.profiling_runs);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunProfilingReport(options.profiling_runs, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.buffer_steps > 0) {
+    StageRecorder recorder("step_buffers", options.buffer_steps);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunStepBuffers(options.buffer_steps, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.dump_iterations > 0) {
+    StageRecorder recorder("async_dump", options.dump_iterations);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunAsyncDump(options.dump_iterations, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.trans_vars > 0) {
+    StageRecorder recorder("trans_var_data", options.trans_vars);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunTransVarData(options.trans_vars, recorder);
+    }
+    flush(recorder);
+  }
+
+  if (options.trace_scopes > 0) {
+    StageRecorder recorder("build_trace", options.trace_scopes);
+    for (int i = 0; i < options.repeat; ++i) {
+      RunBuildTrace(options.trace_scopes, recorder);
+    }
+    flush(recorder);
+  }
+
+  size_t fail_num = 0;
+  for (const auto &result : results) {
+    fail_num += (result.status != SUCCESS) ? 1 : 0;
+  }
+  if (!options.baseline.empty()) {
+    std::vector<PerfResult> baseline;
+    if (!LoadResults(options.baseline, baseline)) {
+      return 2;
+    }
+    size_t regression_num = CompareWithBaseline(results, baseline, options.tolerance);
+    std::cerr << regression_num << " regressions against " << options.baseline << std::endl;
+    return ((regression_num > 0) || (fail_num > 0)) ? 1 : 0;
+  }
+  return (fail_num > 0) ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "perf_result.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace ge {
+namespace perf {
+namespace {
+// Smaller time changes are treated as noise whatever the tolerance is
+const int64_t kMinTimeDiffUs = 1000;
+
+void AppendMember(const std::string &key, const std::string &value, bool quoted, std::string &json) {
+  if (json.size() > 1) {
+    json += ',';
+  }
+  json += "\"" + key + "\":";
+  json += quoted ? ("\"" + value + "\"") : value;
+}
+
+void SkipSpace(const std::string &line, size_t &pos) {
+  while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+    pos++;
+  }
+}
+
+bool ParseString(const std::string &line, size_t &pos, std::string &str) {
+  SkipSpace(line, pos);
+  if (pos >= line.size() || line[pos] != '"') {
+    return false;
+  }
+  size_t end = line.find('"', pos + 1);
+  if (end == std::string::npos) {
+    return false;
+  }
+  str = line.substr(pos + 1, end - pos - 1);
+  pos = end + 1;
+  return true;
+}
+
+bool ParseInt(const std::string &line, size_t &pos, int64_t &value) {
+  SkipSpace(line, pos);
+  const char *begin = line.c_str() + pos;
+  char *end = nullptr;
+  value = strtoll(begin, &end, 10);
+  if (end == begin) {
+    return false;
+  }
+  pos += static_cast<size_t>(end - begin);
+  return true;
+}
+
+bool ExpectChar(const std::string &line, size_t &pos, char c) {
+  SkipSpace(line, pos);
+  if (pos >= line.size() || line[pos] != c) {
+    return false;
+  }
+  pos++;
+  return true;
+}
+
+bool IsTimeRegressed(int64_t time_us, int64_t base_time_us, double tolerance) {
+  return (time_us - base_time_us > kMinTimeDiffUs) && (time_us > base_time_us * (1.0 + tolerance));
+}
+}  // namespace
+
+std::string ToJson(const PerfResult &result) {
+  std::string json = "{";
+  AppendMember("graph", result.graph, true, json);
+  AppendMember("node_num", std::to_string(result.node_num), false, json);
+  AppendMember("stage", result.stage, true, json);
+  AppendMember("status", std::to_string(result.status), false, json);
+  AppendMember("time_us", std::to_string(result.time_us), false, json);
+  AppendMember("peak_rss_kb", std::to_string(result.peak_rss_kb), false, json);
+  for (const auto &metric : result.metrics) {
+    AppendMember(metric.first, std::to_string(metric.second), false, json);
+  }
+  json += "}";
+  return json;
+}
+
+bool ParseJson(const std::string &line, PerfResult &result) {
+  size_t pos = 0;
+  if (!ExpectChar(line, pos, '{')) {
+    return false;
+  }
+  result = PerfResult();
+  bool first = true;
+  while (!ExpectChar(line, pos, '}')) {
+    if (!first && !ExpectChar(line, pos, ',')) {
+      return false;
+    }
+    first = false;
+    std::string key;
+    if (!ParseString(line, pos, key) || !ExpectChar(line, pos, ':')) {
+      return false;
+    }
+    if (key == "graph" || key == "stage") {
+      std::string value;
+      if (!ParseString(line, pos, value)) {
+        return false;
+      }
+      (key == "graph" ? result.graph : result.stage) = value;
+      continue;
+    }
+    int64_t value = 0;
+    if (!ParseInt(line, pos, value)) {
+      return false;
+    }
+    if (key == "node_num") {
+      result.node_num = value;
+    } else if (key == "status") {
+      result.status = value;
+    } else if (key == "time_us") {
+      result.time_us = value;
+    } else if (key == "peak_rss_kb") {
+      result.peak_rss_kb = value;
+    } else {
+      result.metrics[key] = value;
+    }
+  }
+  return !result.graph.empty() && !result.stage.empty();
+}
+
+bool LoadResults(const std::string &file, std::vector<PerfResult> &results) {
+  std::ifstream ifs(file);
+  if (!ifs.is_open()) {
+    std::cerr << "Open result file " << file << " failed." << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(ifs, line)) {
+    PerfResult result;
+    if (ParseJson(line, result)) {
+      results.push_back(result);
+    }
+  }
+  return true;
+}
+
+size_t CompareWithBaseline(const std::vector<PerfResult> &results, const std::vector<PerfResult> &baseline,
+                           double tolerance) {
+  std::map<std::string, const PerfResult *> base_results;
+  for (const auto &base : baseline) {
+    base_results[base.GetKey()] = &base;
+  }
+
+  size_t regression_num = 0;
+  auto report = [&regression_num](const PerfResult &result, const std::string &item, int64_t base_value,
+                                  int64_t value) {
+    std::cerr << "REGRESSION " << result.GetKey() << " " << item << ": " << base_value << " -> " << value
+              << std::endl;
+    regression_num++;
+  };
+  for (const auto &result : results) {
+    auto iter = base_results.find(result.GetKey());
+    if (iter == base_results.end()) {
+      continue;
+    }
+    const PerfResult &base = *iter->second;
+    if (result.status != 0 && base.status == 0) {
+      report(result, "status", base.status, result.status);
+      continue;
+    }
+    if (IsTimeRegressed(result.time_us, base.time_us, tolerance)) {
+      report(result, "time_us", base.time_us, result.time_us);
+    }
+    if (result.peak_rss_kb > base.peak_rss_kb * (1.0 + tolerance)) {
+      report(result, "peak_rss_kb", base.peak_rss_kb, result.peak_rss_kb);
+    }
+    for (const auto &metric : result.metrics) {
+      auto base_metric = base.metrics.find(metric.first);
+      if (base_metric != base.metrics.end() && metric.second > base_metric->second) {
+        report(result, metric.first, base_metric->second, metric.second);
+      }
+    }
+  }
+  return regression_num;
+}
+
+void ResetPeakRss() {
+  // Writing 5 to clear_refs resets VmHWM to the current rss, since linux 4.0
+  FILE *file = fopen("/proc/self/clear_refs", "w");
+  if (file != nullptr) {
+    (void)fputs("5", file);
+    (void)fclose(file);
+  }
+}
+
+int64_t GetPeakRssKb() {
+  std::ifstream ifs("/proc/self/status");
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return strtoll(line.c_str() + 6, nullptr, 10);
+    }
+  }
+  return 0;
+}
+}  // namespace perf
+}  // namespace ge
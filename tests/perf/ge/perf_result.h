@@ -0,0 +1,66 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PERF_GE_PERF_RESULT_H_
+#define PERF_GE_PERF_RESULT_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ge {
+namespace perf {
+struct PerfResult {
+  std::string graph;
+  int64_t node_num = 0;
+  std::string stage;
+  int64_t status = 0;
+  int64_t time_us = 0;
+  int64_t peak_rss_kb = 0;
+  // Deterministic outputs of the stage, e.g. mem_bytes, stream_num and event_num
+  std::map<std::string, int64_t> metrics;
+
+  std::string GetKey() const { return graph + "/" + std::to_string(node_num) + "/" + stage; }
+};
+
+///
+/// @brief render a result as one line of flat json
+///        {"graph":"resnet","node_num":10000,"stage":"mem_assign","status":0,"time_us":1234,"peak_rss_kb":5678,...}
+///
+std::string ToJson(const PerfResult &result);
+
+// Parse a line written by ToJson, lines of other content are rejected
+bool ParseJson(const std::string &line, PerfResult &result);
+
+bool LoadResults(const std::string &file, std::vector<PerfResult> &results);
+
+///
+/// @brief compare results with a baseline, regressions are printed to stderr
+/// @param [in] tolerance allowed relative increase of time and peak rss
+/// @return number of regressions, metrics regress on any increase, and a stage failing but passed in baseline
+///         regresses too. Stages not in baseline are skipped.
+///
+size_t CompareWithBaseline(const std::vector<PerfResult> &results, const std::vector<PerfResult> &baseline,
+                           double tolerance);
+
+// Peak rss is reset so that the next GetPeakRssKb only covers work after this call
+void ResetPeakRss();
+int64_t GetPeakRssKb();
+}  // namespace perf
+}  // namespace ge
+
+#endif  // PERF_GE_PERF_RESULT_H_
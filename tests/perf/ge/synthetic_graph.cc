@@ -0,0 +1,194 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "synthetic_graph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "common/types.h"
+#include "graph/passes/graph_builder_utils.h"
+#include "graph/utils/tensor_utils.h"
+
+namespace ge {
+namespace perf {
+namespace {
+const int64_t kFeatureMapSize = 802816;  // 1 x 64 x 56 x 56 float
+const int64_t kWeightSize = 147456;      // 64 x 64 x 3 x 3 float
+const int64_t kHiddenSize = 393216;      // 128 tokens x 768 float
+const int64_t kAttentionSize = 786432;   // 12 heads x 128 x 128 float
+
+const char *const kGraphKindNames[] = {"chain", "wide", "resnet", "transformer"};
+
+class SyntheticBuilder {
+ public:
+  explicit SyntheticBuilder(const std::string &name) : builder_(name) {}
+
+  NodePtr AddOp(const std::string &type, int in_cnt, int64_t out_size, int64_t stream_id = 0) {
+    NodePtr node = builder_.AddNode(type + "_" + std::to_string(node_num_), type, in_cnt, 1, FORMAT_NCHW, DT_FLOAT,
+                                    {1, out_size / static_cast<int64_t>(sizeof(float))});
+    node_num_++;
+    OpDescPtr op_desc = node->GetOpDesc();
+    TensorUtils::SetSize(*op_desc->MutableOutputDesc(0), out_size);
+    op_desc->SetStreamId(stream_id);
+    return node;
+  }
+
+  // Op with its first input linked to src, and weight inputs from new const nodes
+  NodePtr AddOpAfter(const std::string &type, NodePtr &src, int weight_num, int64_t out_size, int64_t stream_id = 0) {
+    NodePtr node = AddOp(type, 1 + weight_num, out_size, stream_id);
+    Link(src, node, 0);
+    for (int i = 0; i < weight_num; ++i) {
+      NodePtr weight = AddOp(CONSTANT, 0, kWeightSize, stream_id);
+      Link(weight, node, i + 1);
+    }
+    return node;
+  }
+
+  NodePtr AddBinaryOp(const std::string &type, NodePtr &src0, NodePtr &src1, int64_t out_size, int64_t stream_id = 0) {
+    NodePtr node = AddOp(type, 2, out_size, stream_id);
+    Link(src0, node, 0);
+    Link(src1, node, 1);
+    return node;
+  }
+
+  void Link(NodePtr &src, NodePtr &dst, int dst_idx) {
+    builder_.AddDataEdge(src, 0, dst, dst_idx);
+    TensorUtils::SetSize(*dst->GetOpDesc()->MutableInputDesc(dst_idx),
+                         src->GetOpDesc()->GetOutputDesc(0).GetShape().GetShapeSize() * sizeof(float));
+  }
+
+  ComputeGraphPtr Finish(NodePtr &last) {
+    NodePtr net_output = AddOp(NETOUTPUT, 1, kFeatureMapSize);
+    Link(last, net_output, 0);
+    return builder_.GetGraph();
+  }
+
+  size_t GetNodeNum() const { return node_num_; }
+
+ private:
+  ut::GraphBuilder builder_;
+  size_t node_num_ = 0;
+};
+
+ComputeGraphPtr BuildChain(size_t node_num) {
+  SyntheticBuilder builder("chain");
+  NodePtr last = builder.AddOp(DATA, 0, kFeatureMapSize);
+  while (builder.GetNodeNum() + 1 < node_num) {
+    // Alternating sizes, so blocks of different size are reused
+    int64_t size = (builder.GetNodeNum() % 2 == 0) ? kFeatureMapSize : kFeatureMapSize / 2;
+    last = builder.AddOpAfter(RELU, last, 0, size);
+  }
+  return builder.Finish(last);
+}
+
+ComputeGraphPtr BuildWide(size_t node_num) {
+  SyntheticBuilder builder("wide");
+  NodePtr last = builder.AddOp(DATA, 0, kFeatureMapSize);
+  // Branches of a layer are as many as nodes of each branch
+  const int branch_num = std::max(2, static_cast<int>(std::sqrt(static_cast<double>(node_num)) / 2));
+  const int branch_len = branch_num / 2;
+  while (builder.GetNodeNum() + 1 < node_num) {
+    std::vector<NodePtr> branch_outs;
+    for (int i = 0; i < branch_num; ++i) {
+      NodePtr out = last;
+      for (int j = 0; j < branch_len; ++j) {
+        out = builder.AddOpAfter(RELU, out, 0, kFeatureMapSize / 4, i % kSyntheticStreamNum);
+      }
+      branch_outs.push_back(out);
+    }
+    NodePtr add_n = builder.AddOp(ADDN, branch_num, kFeatureMapSize);
+    for (int i = 0; i < branch_num; ++i) {
+      builder.Link(branch_outs[i], add_n, i);
+    }
+    last = add_n;
+  }
+  return builder.Finish(last);
+}
+
+ComputeGraphPtr BuildResNet(size_t node_num) {
+  SyntheticBuilder builder("resnet");
+  NodePtr last = builder.AddOp(DATA, 0, kFeatureMapSize);
+  for (size_t block = 0; builder.GetNodeNum() + 1 < node_num; ++block) {
+    NodePtr conv1 = builder.AddOpAfter(CONV2D, last, 1, kFeatureMapSize);
+    NodePtr bn1 = builder.AddOpAfter(FUSEDBATCHNORM, conv1, 2, kFeatureMapSize);
+    NodePtr relu1 = builder.AddOpAfter(RELU, bn1, 0, kFeatureMapSize);
+    NodePtr conv2 = builder.AddOpAfter(CONV2D, relu1, 1, kFeatureMapSize);
+    NodePtr bn2 = builder.AddOpAfter(FUSEDBATCHNORM, conv2, 2, kFeatureMapSize);
+    NodePtr shortcut = last;
+    if (block % 4 == 0) {
+      // Projection shortcut of a stage runs in parallel with the main path
+      NodePtr proj = builder.AddOpAfter(CONV2D, last, 1, kFeatureMapSize, 1);
+      shortcut = builder.AddOpAfter(FUSEDBATCHNORM, proj, 2, kFeatureMapSize, 1);
+    }
+    NodePtr add = builder.AddBinaryOp(ADD, bn2, shortcut, kFeatureMapSize);
+    last = builder.AddOpAfter(RELU, add, 0, kFeatureMapSize);
+  }
+  return builder.Finish(last);
+}
+
+ComputeGraphPtr BuildTransformer(size_t node_num) {
+  SyntheticBuilder builder("transformer");
+  NodePtr last = builder.AddOp(DATA, 0, kHiddenSize);
+  while (builder.GetNodeNum() + 1 < node_num) {
+    NodePtr norm1 = builder.AddOpAfter(LAYERNORM, last, 2, kHiddenSize);
+    NodePtr query = builder.AddOpAfter(MATMUL, norm1, 1, kHiddenSize, 1);
+    NodePtr key = builder.AddOpAfter(MATMUL, norm1, 1, kHiddenSize, 2);
+    NodePtr value = builder.AddOpAfter(MATMUL, norm1, 1, kHiddenSize, 3);
+    NodePtr score = builder.AddBinaryOp(BATCHMATMUL, query, key, kAttentionSize);
+    NodePtr prob = builder.AddOpAfter(SOFTMAX, score, 0, kAttentionSize);
+    NodePtr context = builder.AddBinaryOp(BATCHMATMUL, prob, value, kHiddenSize);
+    NodePtr proj = builder.AddOpAfter(MATMUL, context, 1, kHiddenSize);
+    NodePtr add1 = builder.AddBinaryOp(ADD, proj, last, kHiddenSize);
+    NodePtr norm2 = builder.AddOpAfter(LAYERNORM, add1, 2, kHiddenSize);
+    NodePtr ffn1 = builder.AddOpAfter(MATMUL, norm2, 1, kHiddenSize * 4);
+    NodePtr gelu = builder.AddOpAfter("Gelu", ffn1, 0, kHiddenSize * 4);
+    NodePtr ffn2 = builder.AddOpAfter(MATMUL, gelu, 1, kHiddenSize);
+    last = builder.AddBinaryOp(ADD, ffn2, add1, kHiddenSize);
+  }
+  return builder.Finish(last);
+}
+}  // namespace
+
+bool ParseGraphKind(const std::string &name, GraphKind &kind) {
+  for (int i = kChainGraph; i <= kTransformerGraph; ++i) {
+    if (name == kGraphKindNames[i]) {
+      kind = static_cast<GraphKind>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *GetGraphKindName(GraphKind kind) { return kGraphKindNames[kind]; }
+
+ComputeGraphPtr BuildSyntheticGraph(GraphKind kind, size_t node_num) {
+  switch (kind) {
+    case kChainGraph:
+      return BuildChain(node_num);
+    case kWideGraph:
+      return BuildWide(node_num);
+    case kResNetGraph:
+      return BuildResNet(node_num);
+    case kTransformerGraph:
+      return BuildTransformer(node_num);
+    default:
+      return nullptr;
+  }
+}
+}  // namespace perf
+}  // namespace ge
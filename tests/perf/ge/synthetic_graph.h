@@ -0,0 +1,53 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PERF_GE_SYNTHETIC_GRAPH_H_
+#define PERF_GE_SYNTHETIC_GRAPH_H_
+
+#include <string>
+
+#include "graph/compute_graph.h"
+
+namespace ge {
+namespace perf {
+enum GraphKind {
+  kChainGraph = 0,
+  kWideGraph,
+  kResNetGraph,
+  kTransformerGraph,
+};
+
+// Number of streams nodes of parallel branches are spread over
+const int64_t kSyntheticStreamNum = 4;
+
+bool ParseGraphKind(const std::string &name, GraphKind &kind);
+const char *GetGraphKindName(GraphKind kind);
+
+///
+/// @brief build a graph of about node_num nodes, every output has its size set for memory assignment, and nodes of
+///        parallel branches are on different streams
+/// @param [in] kind shape of graph
+///        chain: one op after another
+///        wide: branches fanned out from one input and joined by AddN
+///        resnet: conv, bn and relu blocks with shortcuts, projection shortcuts are on another stream
+///        transformer: attention and feed forward layers, q, k and v projections are on their own streams
+/// @param [in] node_num number of nodes
+///
+ComputeGraphPtr BuildSyntheticGraph(GraphKind kind, size_t node_num);
+}  // namespace perf
+}  // namespace ge
+
+#endif  // PERF_GE_SYNTHETIC_GRAPH_H_
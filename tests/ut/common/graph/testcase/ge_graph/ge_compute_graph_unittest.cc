@@ -0,0 +1,354 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "external/ge/ge_api_types.h"
+#include "graph/compute_graph.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/ge_local_context.h"
+#include "graph/model_serialize.h"
+#include "graph/operator_factory_impl.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph_builder_utils.h"
+
+using namespace std;
+using namespace ge;
+
+namespace {
+const char *const kInferAddType = "UtInferAdd";
+const char *const kInferConcatType = "UtInferConcat";
+const char *const kNoInferType = "UtNoInfer";
+
+// output dims are the sum of all input dims, plus one on the first dim
+graphStatus InferAdd(Operator &op) {
+  std::vector<int64_t> dims;
+  for (size_t i = 0; i < op.GetInputsSize(); ++i) {
+    auto input_dims = op.GetInputDesc(i).GetShape().GetDims();
+    dims.resize(std::max(dims.size(), input_dims.size()), 0);
+    for (size_t j = 0; j < input_dims.size(); ++j) {
+      dims[j] += input_dims[j];
+    }
+  }
+  if (!dims.empty()) {
+    dims[0] += 1;
+  }
+  TensorDesc output_desc = op.GetOutputDesc("0");
+  output_desc.SetShape(Shape(dims));
+  return op.UpdateOutputDesc("0", output_desc);
+}
+
+void RegisterInferFuncs() {
+  (void)OperatorFactoryImpl::RegisterInferShapeFunc(kInferAddType, InferAdd);
+  (void)OperatorFactoryImpl::RegisterInferShapeFunc(kInferConcatType, InferAdd);
+}
+
+///   data -> branch_0: add_0_0 -> add_0_1 -> add_0_2 \
+///        -> branch_1: add_1_0 -> add_1_1 -> add_1_2  -> concat -> add_out
+///        -> ...                                     /
+ComputeGraphPtr BuildWideGraph(size_t branch_num, size_t branch_len, bool with_no_infer_node) {
+  ut::GraphBuilder builder("wide_graph");
+  auto data = builder.AddNode("data", "Data", 0, 1, FORMAT_ND, DT_FLOAT, {1, 2});
+  auto concat = builder.AddNode("concat", kInferConcatType, branch_num, 1, FORMAT_ND, DT_FLOAT, {1, 2});
+  for (size_t i = 0; i < branch_num; ++i) {
+    NodePtr pre_node = data;
+    for (size_t j = 0; j < branch_len; ++j) {
+      string type = (with_no_infer_node && i == branch_num / 2 && j == 1) ? kNoInferType : kInferAddType;
+      auto node = builder.AddNode("add_" + to_string(i) + "_" + to_string(j), type, 1, 1, FORMAT_ND, DT_FLOAT, {1, 2});
+      builder.AddDataEdge(pre_node, 0, node, 0);
+      pre_node = node;
+    }
+    builder.AddDataEdge(pre_node, 0, concat, static_cast<int>(i));
+  }
+  auto add_out = builder.AddNode("add_out", kInferAddType, 1, 1, FORMAT_ND, DT_FLOAT, {1, 2});
+  builder.AddDataEdge(concat, 0, add_out, 0);
+
+  auto graph = builder.GetGraph();
+  for (const auto &node : graph->GetDirectNode()) {
+    if (node->GetType() != "Data") {
+      (void)AttrUtils::SetBool(node->GetOpDesc(), NEED_INFER, true);
+    }
+  }
+  return graph;
+}
+
+void SetInferShapeThreadNum(const string &thread_num) {
+  map<string, string> options = {{INFER_SHAPE_THREAD_NUM, thread_num}};
+  GetThreadLocalContext().SetGraphOption(options);
+}
+
+void ExpectSameShapes(const ComputeGraphPtr &l_graph, const ComputeGraphPtr &r_graph) {
+  ASSERT_EQ(l_graph->GetDirectNodesSize(), r_graph->GetDirectNodesSize());
+  for (const auto &l_node : l_graph->GetDirectNode()) {
+    auto r_node = r_graph->FindNode(l_node->GetName());
+    ASSERT_NE(r_node, nullptr);
+    auto l_op_desc = l_node->GetOpDesc();
+    auto r_op_desc = r_node->GetOpDesc();
+    for (size_t i = 0; i < l_op_desc->GetInputsSize(); ++i) {
+      EXPECT_EQ(l_op_desc->GetInputDesc(i).GetShape().GetDims(), r_op_desc->GetInputDesc(i).GetShape().GetDims());
+    }
+    for (size_t i = 0; i < l_op_desc->GetOutputsSize(); ++i) {
+      EXPECT_EQ(l_op_desc->GetOutputDesc(i).GetShape().GetDims(), r_op_desc->GetOutputDesc(i).GetShape().GetDims());
+    }
+  }
+}
+
+// data -> node_1 -> ... -> node_{num - 1}
+ComputeGraphPtr BuildChainGraph(size_t node_num) {
+  ut::GraphBuilder builder("chain_graph");
+  NodePtr pre_node = builder.AddNode("data", "Data", 0, 1);
+  for (size_t i = 1; i < node_num; ++i) {
+    auto node = builder.AddNode("node_" + to_string(i), "Relu", 1, 1);
+    builder.AddDataEdge(pre_node, 0, node, 0);
+    pre_node = node;
+  }
+  return builder.GetGraph();
+}
+
+void SetRunMode(const string &run_mode) {
+  map<string, string> options = {{OPTION_GRAPH_RUN_MODE, run_mode}};
+  GetThreadLocalContext().SetGraphOption(options);
+}
+
+vector<string> GetNodeNames(const ComputeGraphPtr &graph) {
+  vector<string> names;
+  for (const auto &node : graph->GetDirectNode()) {
+    names.push_back(node->GetName());
+  }
+  return names;
+}
+
+// every edge points from a node to a later one, and ids are the positions
+void ExpectTopoOrder(const ComputeGraphPtr &graph) {
+  int64_t position = 0;
+  for (const auto &node : graph->GetDirectNode()) {
+    ASSERT_EQ(node->GetOpDesc()->GetId(), position++);
+    for (const auto &out_node : node->GetOutAllNodes()) {
+      EXPECT_GT(out_node->GetOpDesc()->GetId(), node->GetOpDesc()->GetId());
+    }
+  }
+}
+
+NodePtr AddCastNode(const ComputeGraphPtr &graph, const string &name) {
+  auto op_desc = std::make_shared<OpDesc>(name, "Cast");
+  op_desc->AddInputDesc(GeTensorDesc());
+  op_desc->AddOutputDesc(GeTensorDesc());
+  return graph->AddNode(op_desc);
+}
+}  // namespace
+
+class UtestGeComputeGraph : public testing::Test {
+ protected:
+  void SetUp() { RegisterInferFuncs(); }
+
+  void TearDown() { SetInferShapeThreadNum("1"); }
+};
+
+TEST_F(UtestGeComputeGraph, infer_shape_in_levels_same_as_serial) {
+  auto serial_graph = BuildWideGraph(16, 3, false);
+  SetInferShapeThreadNum("1");
+  EXPECT_EQ(serial_graph->InferShapeInNeed(), GRAPH_SUCCESS);
+
+  auto parallel_graph = BuildWideGraph(16, 3, false);
+  SetInferShapeThreadNum("4");
+  EXPECT_EQ(parallel_graph->InferShapeInNeed(), GRAPH_SUCCESS);
+
+  ExpectSameShapes(serial_graph, parallel_graph);
+  auto add_out = parallel_graph->FindNode("add_out");
+  ASSERT_NE(add_out, nullptr);
+  // every branch adds 3 to dim 0, concat sums 16 branches and adds 1, add_out adds 1
+  EXPECT_EQ(add_out->GetOpDesc()->GetOutputDesc(0).GetShape().GetDims(), vector<int64_t>({16 * 4 + 2, 32}));
+}
+
+TEST_F(UtestGeComputeGraph, infer_shape_in_levels_stop_at_no_infer_func) {
+  auto serial_graph = BuildWideGraph(8, 3, true);
+  SetInferShapeThreadNum("1");
+  EXPECT_EQ(serial_graph->InferShapeInNeed(), GRAPH_SUCCESS);
+
+  auto parallel_graph = BuildWideGraph(8, 3, true);
+  SetInferShapeThreadNum("4");
+  EXPECT_EQ(parallel_graph->InferShapeInNeed(), GRAPH_SUCCESS);
+
+  ExpectSameShapes(serial_graph, parallel_graph);
+}
+
+TEST_F(UtestGeComputeGraph, find_node_by_index) {
+  auto graph = BuildChainGraph(5);
+  auto node_2 = graph->FindNode("node_2");
+  ASSERT_NE(node_2, nullptr);
+  EXPECT_EQ(graph->FindNodeById(node_2->GetOpDesc()->GetId()), node_2);
+  EXPECT_EQ(graph->FindNode("not_exist"), nullptr);
+  EXPECT_EQ(graph->FindNodeById(100), nullptr);
+
+  // renamed after indexed
+  node_2->GetOpDesc()->SetName("renamed");
+  EXPECT_EQ(graph->FindNode("node_2"), nullptr);
+  EXPECT_EQ(graph->FindNode("renamed"), node_2);
+
+  // the front one of duplicated names is found, as a linear scan does
+  auto front = graph->AddNodeFront(std::make_shared<OpDesc>("node_3", "Relu"));
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(graph->FindNode("node_3"), front);
+  EXPECT_EQ(graph->RemoveNode(front), GRAPH_SUCCESS);
+  auto node_3 = graph->FindNode("node_3");
+  ASSERT_NE(node_3, nullptr);
+  EXPECT_NE(node_3, front);
+
+  auto node_4 = graph->FindNode("node_4");
+  ASSERT_NE(node_4, nullptr);
+  EXPECT_EQ(GraphUtils::RemoveJustNode(graph, node_4), GRAPH_SUCCESS);
+  EXPECT_EQ(graph->FindNode("node_4"), nullptr);
+
+  // ids are reassigned by sorting
+  EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+  for (const auto &node : graph->GetDirectNode()) {
+    EXPECT_EQ(graph->FindNode(node->GetName()), node);
+    EXPECT_EQ(graph->FindNodeById(node->GetOpDesc()->GetId()), node);
+  }
+}
+
+TEST_F(UtestGeComputeGraph, node_index_follows_op_changes) {
+  auto graph = BuildChainGraph(5);
+  auto node_1 = graph->FindNode("node_1");
+  auto node_3 = graph->FindNode("node_3");
+  ASSERT_NE(node_1, nullptr);
+  ASSERT_NE(node_3, nullptr);
+
+  // renamed to the name of a node behind it, the renamed one is found first
+  node_1->GetOpDesc()->SetName("node_3");
+  EXPECT_EQ(graph->FindNode("node_3"), node_1);
+  EXPECT_EQ(graph->FindNode("node_1"), nullptr);
+  node_1->GetOpDesc()->SetName("node_1");
+  EXPECT_EQ(graph->FindNode("node_3"), node_3);
+
+  node_3->GetOpDesc()->SetId(100);
+  EXPECT_EQ(graph->FindNodeById(100), node_3);
+  EXPECT_EQ(graph->FindNodeById(3), nullptr);
+
+  // op desc replaced
+  auto op_desc = AttrUtils::CopyOpDesc(node_3->GetOpDesc());
+  ASSERT_NE(op_desc, nullptr);
+  op_desc->SetName("replaced");
+  op_desc->SetId(7);
+  EXPECT_EQ(node_3->UpdateOpDesc(op_desc), GRAPH_SUCCESS);
+  EXPECT_EQ(graph->FindNode("replaced"), node_3);
+  EXPECT_EQ(graph->FindNode("node_3"), nullptr);
+  EXPECT_EQ(graph->FindNodeById(7), node_3);
+  EXPECT_EQ(graph->FindNodeById(100), nullptr);
+
+  // the op outlives the graph
+  auto node_1_op = node_1->GetOpDesc();
+  node_1.reset();
+  node_3.reset();
+  graph.reset();
+  node_1_op->SetName("no_graph");
+  node_1_op->SetId(200);
+  EXPECT_EQ(node_1_op->GetName(), "no_graph");
+}
+
+TEST_F(UtestGeComputeGraph, node_index_of_ops_shared_by_graphs) {
+  auto graph = BuildChainGraph(5);
+  auto node_2 = graph->FindNode("node_2");
+  ASSERT_NE(node_2, nullptr);
+  // a sub graph takes the op of node_2, as graph partition does
+  auto sub_graph = std::make_shared<ComputeGraph>("sub_graph");
+  auto sub_node = sub_graph->AddNode(node_2->GetOpDesc());
+  ASSERT_NE(sub_node, nullptr);
+  EXPECT_EQ(sub_graph->FindNode("node_2"), sub_node);
+  EXPECT_EQ(graph->FindNode("node_2"), node_2);
+  // the id is reassigned by the sub graph, the first node of id 0 is still found
+  EXPECT_EQ(graph->FindNodeById(2), nullptr);
+  EXPECT_EQ(graph->FindNodeById(0), graph->FindNode("data"));
+
+  // renamed and re-numbered through the sub graph
+  sub_node->GetOpDesc()->SetName("shared");
+  sub_node->GetOpDesc()->SetId(9);
+  EXPECT_EQ(graph->FindNode("shared"), node_2);
+  EXPECT_EQ(graph->FindNode("node_2"), nullptr);
+  EXPECT_EQ(graph->FindNodeById(9), node_2);
+  EXPECT_EQ(sub_graph->FindNodeById(9), sub_node);
+
+  // the op outlives the sub graph
+  sub_node.reset();
+  sub_graph.reset();
+  node_2->GetOpDesc()->SetName("node_2");
+  EXPECT_EQ(graph->FindNode("node_2"), node_2);
+}
+
+TEST_F(UtestGeComputeGraph, topological_sorting_dfs_and_bfs) {
+  ut::GraphBuilder builder("topo_graph");
+  auto data = builder.AddNode("data", "Data", 0, 1);
+  auto node_a = builder.AddNode("a", "Relu", 1, 1);
+  auto node_b = builder.AddNode("b", "Relu", 1, 1);
+  auto node_c = builder.AddNode("c", "Relu", 1, 1);
+  auto node_out = builder.AddNode("out", "AddN", 3, 1);
+  builder.AddDataEdge(data, 0, node_a, 0);
+  builder.AddDataEdge(data, 0, node_c, 0);
+  builder.AddDataEdge(data, 0, node_b, 0);
+  builder.AddDataEdge(node_a, 0, node_out, 0);
+  builder.AddDataEdge(node_b, 0, node_out, 1);
+  builder.AddDataEdge(node_c, 0, node_out, 2);
+  builder.AddControlEdge(node_c, node_b);
+  auto graph = builder.GetGraph();
+
+  // depth first, the last ready successor is taken first
+  SetRunMode("0");
+  EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+  EXPECT_EQ(GetNodeNames(graph), vector<string>({"data", "c", "b", "a", "out"}));
+  ExpectTopoOrder(graph);
+
+  // breadth first, successors ready at the same time are taken by names
+  SetRunMode("1");
+  EXPECT_EQ(graph->TopologicalSorting(), GRAPH_SUCCESS);
+  EXPECT_EQ(GetNodeNames(graph), vector<string>({"data", "a", "c", "b", "out"}));
+  ExpectTopoOrder(graph);
+  SetRunMode("");
+}
+
+TEST_F(UtestGeComputeGraph, incremental_topological_sorting) {
+  auto graph = BuildChainGraph(6);
+  EXPECT_EQ(graph->IncrementalTopologicalSorting({}), GRAPH_SUCCESS);
+  EXPECT_EQ(GetNodeNames(graph), vector<string>({"data", "node_1", "node_2", "node_3", "node_4", "node_5"}));
+
+  // the inserted node is appended, only nodes from node_3 on are moved
+  auto node_2 = graph->FindNode("node_2");
+  auto node_3 = graph->FindNode("node_3");
+  auto inserted = AddCastNode(graph, "inserted");
+  ASSERT_NE(inserted, nullptr);
+  ASSERT_EQ(GraphUtils::InsertNodeBetweenDataAnchors(node_2->GetOutDataAnchor(0), node_3->GetInDataAnchor(0), inserted),
+            GRAPH_SUCCESS);
+  EXPECT_EQ(graph->IncrementalTopologicalSorting({inserted}), GRAPH_SUCCESS);
+  EXPECT_EQ(GetNodeNames(graph),
+            vector<string>({"data", "node_1", "node_2", "inserted", "node_3", "node_4", "node_5"}));
+  ExpectTopoOrder(graph);
+  EXPECT_EQ(graph->FindNodeById(3), inserted);
+
+  // ids no longer match positions after a removal, the graph is sorted fully
+  auto node_1 = graph->FindNode("node_1");
+  auto node_4 = graph->FindNode("node_4");
+  auto node_5 = graph->FindNode("node_5");
+  ASSERT_EQ(GraphUtils::AddEdge(node_1->GetOutControlAnchor(), node_5->GetInControlAnchor()), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::IsolateNode(node_4, {0}), GRAPH_SUCCESS);
+  ASSERT_EQ(GraphUtils::RemoveNodeWithoutRelink(graph, node_4), GRAPH_SUCCESS);
+  EXPECT_EQ(graph->IncrementalTopologicalSorting({node_5}), GRAPH_SUCCESS);
+  EXPECT_EQ(GetNodeNames(graph), vector<string>({"data", "node_1", "node_2", "inserted", "node_3", "node_5"}));
+  EXPECT_EQ(graph->FindNodeById(5), node_5);
+
+  // closed loop
+  ASSERT_EQ(GraphUtils::AddEdge(node_5->GetOutControlAnchor(), node_1->GetInControlAnchor()), GRAPH_SUCCESS);
+  EXPECT_EQ(graph->IncrementalTopologicalSorting({node_5}), GRAPH_FAILED);
+}
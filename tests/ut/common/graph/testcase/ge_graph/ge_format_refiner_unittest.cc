@@ -19,6 +19,9 @@
 #include <iostream>
 #include <unordered_map>
 
+#include "external/ge/ge_api_types.h"
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
 #include "graph_builder_utils.h"
 
 #define private public
@@ -452,6 +455,88 @@ ut::GraphBuilder BuildGraph8() {
   FormatRefiner::SetInferOrigineFormatFlag(true);
   return builder;
 }
+
+void SetNodeFormat(const NodePtr &node, Format format) {
+  for (const auto &input_desc : node->GetOpDesc()->GetAllInputsDescPtr()) {
+    input_desc->SetFormat(format);
+  }
+  for (const auto &output_desc : node->GetOpDesc()->GetAllOutputsDescPtr()) {
+    output_desc->SetFormat(format);
+  }
+}
+
+///
+///   var1_0 var2_0          var1_1 var2_1   var2_{n-1}
+///       \   /                 \   /           \
+///      conv_0 vars of bn     conv_1            ...          data_0 ... data_{n-1}
+///         \   /               /  \                             |          |
+///         bn_0              ...  ...                        square_0   square_{n-1}
+///          |                                                      \      /
+///        relu_0                                                  netoutput
+///          |
+///        pool_0 ---(when chained, to input 0 of conv_1 instead of var1_1)
+///
+/// Blocks are a region each when not chained, and data nodes are in one region. Chained blocks share nodes processed
+/// by each of them, so they are kept in one region
+///
+ComputeGraphPtr BuildRegionsGraph(size_t block_num, bool is_chained = false) {
+  auto builder = ut::GraphBuilder("regions");
+  auto netoutput = builder.AddNDNode("netoutput", "NetOutput", block_num, 0);
+  NodePtr pre_node = builder.AddNDNode("var1_0", "Variable", 0, 1);
+  for (size_t i = 0; i < block_num; ++i) {
+    std::string suffix = "_" + std::to_string(i);
+    Format format = (i % 2 == 0) ? FORMAT_NCHW : FORMAT_NHWC;
+    if (i > 0 && !is_chained) {
+      pre_node = builder.AddNDNode("var1" + suffix, "Variable", 0, 1);
+    }
+    auto weight = builder.AddNDNode("var2" + suffix, "Variable", 0, 1);
+    auto conv = builder.AddNDNode("conv" + suffix, "Conv2D", 2, 1);
+    SetNodeFormat(conv, format);
+    conv->GetOpDesc()->MutableInputDesc(1)->SetFormat(FORMAT_HWCN);
+    builder.AddDataEdge(pre_node, 0, conv, 0);
+    builder.AddDataEdge(weight, 0, conv, 1);
+    auto bn = builder.AddNDNode("bn" + suffix, "BatchNorm", 5, 1);
+    builder.AddDataEdge(conv, 0, bn, 0);
+    for (int j = 1; j < 5; ++j) {
+      auto var = builder.AddNDNode("var" + std::to_string(j + 2) + suffix, "Variable", 0, 1);
+      builder.AddDataEdge(var, 0, bn, j);
+    }
+    auto relu = builder.AddNDNode("relu" + suffix, "Relu", 1, 1);
+    builder.AddDataEdge(bn, 0, relu, 0);
+    pre_node = builder.AddNDNode("pool" + suffix, "Pooling", 1, 1);
+    SetNodeFormat(pre_node, format);
+    builder.AddDataEdge(relu, 0, pre_node, 0);
+
+    auto data = builder.AddNDNode("data" + suffix, "Data", 1, 1);
+    auto square = builder.AddNDNode("square" + suffix, "Square", 1, 1);
+    builder.AddDataEdge(data, 0, square, 0);
+    builder.AddDataEdge(square, 0, netoutput, static_cast<int>(i));
+  }
+  return builder.GetGraph();
+}
+
+void SetFormatPassThreadNum(const std::string &thread_num) {
+  std::map<std::string, std::string> options = {{FORMAT_PASS_THREAD_NUM, thread_num}};
+  GetThreadLocalContext().SetGraphOption(options);
+}
+
+void ExpectSameFormats(const ComputeGraphPtr &l_graph, const ComputeGraphPtr &r_graph) {
+  ASSERT_EQ(l_graph->GetDirectNodesSize(), r_graph->GetDirectNodesSize());
+  for (const auto &l_node : l_graph->GetDirectNode()) {
+    auto r_node = r_graph->FindNode(l_node->GetName());
+    ASSERT_NE(r_node, nullptr);
+    auto l_op_desc = l_node->GetOpDesc();
+    auto r_op_desc = r_node->GetOpDesc();
+    for (size_t i = 0; i < l_op_desc->GetInputsSize(); ++i) {
+      EXPECT_EQ(l_op_desc->GetInputDesc(i).GetOriginFormat(), r_op_desc->GetInputDesc(i).GetOriginFormat());
+      EXPECT_EQ(l_op_desc->GetInputDesc(i).GetFormat(), r_op_desc->GetInputDesc(i).GetFormat());
+    }
+    for (size_t i = 0; i < l_op_desc->GetOutputsSize(); ++i) {
+      EXPECT_EQ(l_op_desc->GetOutputDesc(i).GetOriginFormat(), r_op_desc->GetOutputDesc(i).GetOriginFormat());
+      EXPECT_EQ(l_op_desc->GetOutputDesc(i).GetFormat(), r_op_desc->GetOutputDesc(i).GetFormat());
+    }
+  }
+}
 }  // namespace
 
 TEST_F(UtestFormatRefiner, data_format) {
@@ -658,4 +743,69 @@ TEST_F(UtestFormatRefiner, save_format) {
   EXPECT_EQ(save_format, FORMAT_NHWC);
   graph->SaveDataFormat(FORMAT_ND);
 }
-}  // namespace ge
\ No newline at end of file
+TEST_F(UtestFormatRefiner, infer_in_regions_same_as_serial) {
+  const size_t block_num = 6;
+  auto serial_graph = BuildRegionsGraph(block_num);
+  serial_graph->SaveDataFormat(FORMAT_NHWC);
+  FormatRefiner::SetInferOrigineFormatFlag(false);
+  SetFormatPassThreadNum("1");
+  EXPECT_EQ(FormatRefiner::InferOrigineFormat(serial_graph), GRAPH_SUCCESS);
+
+  auto parallel_graph = BuildRegionsGraph(block_num);
+  parallel_graph->SaveDataFormat(FORMAT_NHWC);
+  FormatRefiner::SetInferOrigineFormatFlag(false);
+  SetFormatPassThreadNum("4");
+  EXPECT_EQ(FormatRefiner::InferOrigineFormat(parallel_graph), GRAPH_SUCCESS);
+  SetFormatPassThreadNum("1");
+  FormatRefiner::SetInferOrigineFormatFlag(true);
+
+  ExpectSameFormats(serial_graph, parallel_graph);
+  auto relu = parallel_graph->FindNode("relu_1");
+  EXPECT_EQ(relu->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NHWC);
+  auto var = parallel_graph->FindNode("var3_2");
+  EXPECT_EQ(var->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NCHW);
+  auto data = parallel_graph->FindNode("data_0");
+  EXPECT_EQ(data->GetOpDesc()->GetOutputDesc(0).GetOriginFormat(), FORMAT_NHWC);
+}
+
+TEST_F(UtestFormatRefiner, infer_chained_blocks_in_regions_same_as_serial) {
+  const size_t block_num = 6;
+  auto serial_graph = BuildRegionsGraph(block_num, true);
+  FormatRefiner::SetInferOrigineFormatFlag(false);
+  SetFormatPassThreadNum("1");
+  EXPECT_EQ(FormatRefiner::InferOrigineFormat(serial_graph), GRAPH_SUCCESS);
+
+  auto parallel_graph = BuildRegionsGraph(block_num, true);
+  FormatRefiner::SetInferOrigineFormatFlag(false);
+  SetFormatPassThreadNum("4");
+  EXPECT_EQ(FormatRefiner::InferOrigineFormat(parallel_graph), GRAPH_SUCCESS);
+  SetFormatPassThreadNum("1");
+  FormatRefiner::SetInferOrigineFormatFlag(true);
+
+  ExpectSameFormats(serial_graph, parallel_graph);
+  auto conv = parallel_graph->FindNode("conv_1");
+  EXPECT_EQ(conv->GetOpDesc()->GetInputDesc(0).GetOriginFormat(), FORMAT_NHWC);
+}
+
+TEST_F(UtestFormatRefiner, format_pass_thread_num) {
+  SetFormatPassThreadNum("");
+  EXPECT_EQ(GetContext().FormatPassThreadNum(), 1);
+  SetFormatPassThreadNum("-2");
+  EXPECT_EQ(GetContext().FormatPassThreadNum(), 1);
+  SetFormatPassThreadNum("8");
+  EXPECT_EQ(GetContext().FormatPassThreadNum(), 8);
+  SetFormatPassThreadNum("1000");
+  EXPECT_EQ(GetContext().FormatPassThreadNum(), 64);
+  SetFormatPassThreadNum("1");
+}
+
+TEST_F(UtestFormatRefiner, infer_in_regions_failed) {
+  auto graph = BuildRegionsGraph(4);
+  auto relu = graph->FindNode("relu_2");
+  relu->GetOpDesc()->AddInferFormatFunc([](Operator &op) { return GRAPH_FAILED; });
+  SetFormatPassThreadNum("4");
+  EXPECT_EQ(FormatRefiner::InferOrigineFormat(graph), GRAPH_FAILED);
+  SetFormatPassThreadNum("1");
+  FormatRefiner::SetInferOrigineFormatFlag(true);
+}
+}  // namespace ge
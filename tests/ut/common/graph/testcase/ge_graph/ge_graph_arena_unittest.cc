@@ -0,0 +1,164 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "graph/compute_graph.h"
+#include "graph/graph_arena.h"
+#include "graph/model_serialize.h"
+
+using namespace std;
+using namespace ge;
+
+namespace {
+OpDescPtr CreateOpDesc(const string &name, size_t input_num, size_t output_num) {
+  auto op_desc = std::make_shared<OpDesc>(name, "Relu");
+  for (size_t i = 0; i < input_num; ++i) {
+    op_desc->AddInputDesc(GeTensorDesc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT));
+  }
+  for (size_t i = 0; i < output_num; ++i) {
+    op_desc->AddOutputDesc(GeTensorDesc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT));
+  }
+  return op_desc;
+}
+
+// data -> node_1 -> ... -> node_{num - 1}
+ComputeGraphPtr BuildChainGraph(size_t node_num) {
+  auto graph = std::make_shared<ComputeGraph>("chain");
+  NodePtr prev = graph->AddNode(CreateOpDesc("data", 0, 1));
+  for (size_t i = 1; i < node_num; ++i) {
+    NodePtr node = graph->AddNode(CreateOpDesc("node_" + std::to_string(i), 1, 1));
+    (void)prev->GetOutDataAnchor(0)->LinkTo(node->GetInDataAnchor(0));
+    prev = node;
+  }
+  return graph;
+}
+}  // namespace
+
+class UtestGraphArena : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestGraphArena, release_blocks_with_arena) {
+  GraphArena arena(4096);
+  void *block1 = arena.Allocate(40);
+  void *block2 = arena.Allocate(33);
+  ASSERT_NE(block1, nullptr);
+  ASSERT_NE(block2, nullptr);
+  // Blocks are aligned to 16 bytes and carved one after another.
+  EXPECT_EQ(static_cast<uint8_t *>(block2), static_cast<uint8_t *>(block1) + 48);
+  EXPECT_EQ(arena.GetUsedSize(), 96);
+  arena.Deallocate(block1, 40);
+  // Freed blocks are not reused, they are released with the arena.
+  void *block3 = arena.Allocate(40);
+  EXPECT_EQ(static_cast<uint8_t *>(block3), static_cast<uint8_t *>(block2) + 48);
+
+  void *large = arena.Allocate(4096);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(arena.GetChunkCount(), 2);
+  arena.Deallocate(large, 4096);
+  arena.Deallocate(block2, 33);
+  arena.Deallocate(block3, 40);
+  EXPECT_EQ(arena.GetUsedSize(), 0);
+  EXPECT_EQ(arena.GetAllocCount(), 4);
+}
+
+TEST_F(UtestGraphArena, chunk_per_thread) {
+  const size_t kThreadNum = 4;
+  const size_t kBlockNum = 10;
+  GraphArena arena(4096);
+  std::vector<std::vector<uint8_t *>> blocks(kThreadNum);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&arena, &blocks, i]() {
+      for (size_t j = 0; j < kBlockNum; ++j) {
+        blocks[i].push_back(static_cast<uint8_t *>(arena.Allocate(32)));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(arena.GetChunkCount(), kThreadNum);
+  EXPECT_EQ(arena.GetAllocCount(), kThreadNum * kBlockNum);
+  for (const auto &thread_blocks : blocks) {
+    ASSERT_EQ(thread_blocks.size(), kBlockNum);
+    for (size_t j = 1; j < kBlockNum; ++j) {
+      EXPECT_EQ(thread_blocks[j], thread_blocks[j - 1] + 32);
+    }
+  }
+
+  // Another arena used by this thread gets a chunk of its own.
+  GraphArena other_arena(4096);
+  EXPECT_NE(other_arena.Allocate(32), nullptr);
+  EXPECT_NE(arena.Allocate(32), nullptr);
+  EXPECT_EQ(other_arena.GetChunkCount(), 1);
+  EXPECT_EQ(arena.GetChunkCount(), kThreadNum + 1);
+}
+
+TEST_F(UtestGraphArena, graph_nodes_in_arena) {
+  auto arena = std::make_shared<GraphArena>();
+  NodePtr kept_node = nullptr;
+  {
+    GraphArenaScope scope(arena);
+    auto graph = BuildChainGraph(10);
+    EXPECT_EQ(graph->GetArena(), arena);
+    EXPECT_EQ(graph->GetDirectNodesSize(), 10);
+    // node, control block and 4 anchors of each node, and tensor descs
+    EXPECT_GE(arena->GetAllocCount(), 10 * 6);
+    kept_node = graph->FindNode("node_5");
+  }
+  EXPECT_TRUE(GraphArena::Current() == nullptr);
+
+  // Objects outlive the graph and the arena keeps their memory.
+  ASSERT_NE(kept_node, nullptr);
+  EXPECT_EQ(kept_node->GetName(), "node_5");
+  EXPECT_EQ(kept_node->GetAllInDataAnchors().size(), 1);
+  EXPECT_GT(arena->GetUsedSize(), 0);
+  kept_node = nullptr;
+
+  // A graph created without scope keeps using the heap.
+  auto heap_graph = std::make_shared<ComputeGraph>("heap");
+  EXPECT_TRUE(heap_graph->GetArena() == nullptr);
+}
+
+TEST_F(UtestGraphArena, unserialize_in_arena) {
+  auto graph = BuildChainGraph(5);
+  ModelSerialize serialize;
+  Buffer buffer = serialize.SerializeGraph(graph);
+  ASSERT_GT(buffer.GetSize(), 0);
+
+  auto arena = std::make_shared<GraphArena>();
+  ComputeGraphPtr copied_graph = nullptr;
+  {
+    GraphArenaScope scope(arena);
+    copied_graph = serialize.UnserializeGraph(buffer.GetData(), buffer.GetSize());
+  }
+  ASSERT_NE(copied_graph, nullptr);
+  EXPECT_EQ(copied_graph->GetArena(), arena);
+  EXPECT_EQ(copied_graph->GetDirectNodesSize(), 5);
+  auto node = copied_graph->FindNode("node_4");
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->GetOpDesc()->GetInputDesc(0).GetShape().GetDims(), std::vector<int64_t>({1, 16}));
+  EXPECT_NE(node->GetInDataAnchor(0)->GetPeerOutAnchor(), nullptr);
+}
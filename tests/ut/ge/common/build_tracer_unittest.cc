@@ -0,0 +1,119 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "framework/common/debug/ge_log.h"
+
+#define private public
+#include "common/build_tracer.h"
+#undef private
+
+namespace ge {
+class UtestBuildTracer : public testing::Test {
+ protected:
+  void SetUp() { BuildTracer::Instance().Clear(); }
+  void TearDown() {
+    (void)BuildTracer::Instance().Stop();
+    BuildTracer::Instance().Clear();
+  }
+};
+
+namespace {
+size_t CountOf(const std::string &str, const std::string &sub) {
+  size_t count = 0;
+  for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size())) {
+    count++;
+  }
+  return count;
+}
+}  // namespace
+
+TEST_F(UtestBuildTracer, nested_spans_and_counters) {
+  BuildTracer::Instance().Start("");
+  {
+    GE_TRACE_SCOPE(Outer, "GraphManager::PreRun");
+    GE_TRACE_ARG(Outer, "graph", std::string("graph\"1\""));
+    {
+      GE_TRACE_SCOPE(Inner, "ModelBuilder::AssignMemory");
+      GE_TRACE_ARG(Inner, "node_num", static_cast<int64_t>(3));
+    }
+    GE_TIMESTAMP_START(Stage);
+    GE_TIMESTAMP_END(Stage, "GraphBuilder::Build");
+    GE_TRACE_COUNTER("feature_map_bytes", static_cast<int64_t>(1024));
+  }
+  EXPECT_EQ(BuildTracer::Instance().Stop(), SUCCESS);
+
+  // Nothing is recorded after stop
+  {
+    GE_TRACE_SCOPE(Stopped, "StreamAllocator::RefreshRealStream");
+  }
+  ASSERT_EQ(BuildTracer::Instance().events_.size(), 4);
+  // Inner spans end first
+  const auto &inner = BuildTracer::Instance().events_[0];
+  const auto &outer = BuildTracer::Instance().events_[3];
+  EXPECT_EQ(inner.name, "ModelBuilder::AssignMemory");
+  EXPECT_EQ(outer.name, "GraphManager::PreRun");
+  EXPECT_GE(inner.timestamp, outer.timestamp);
+  EXPECT_LE(inner.timestamp + inner.duration, outer.timestamp + outer.duration);
+  EXPECT_EQ(inner.tid, outer.tid);
+
+  std::string json;
+  BuildTracer::Instance().ToJson(json);
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+  EXPECT_NE(json.find("\"name\":\"GraphBuilder::Build\",\"cat\":\"ge\",\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"node_num\":3}"), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"graph\":\"graph\\\"1\\\"\"}"), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"C\""), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"value\":1024}"), std::string::npos);
+  EXPECT_EQ(CountOf(json, "{"), CountOf(json, "}"));
+}
+
+TEST_F(UtestBuildTracer, spans_of_threads_saved_to_file) {
+  const std::string file = "./build_trace_ut.json";
+  BuildTracer::Instance().Start(file);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([]() {
+      GE_TRACE_SCOPE(OptimizeSubGraph, "GraphOptimize::OptimizeSubGraph");
+      GE_TRACE_ARG(OptimizeSubGraph, "engine", std::string("AIcoreEngine"));
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(BuildTracer::Instance().Stop(), SUCCESS);
+
+  std::ifstream ifs(file);
+  ASSERT_TRUE(ifs.is_open());
+  std::stringstream content;
+  content << ifs.rdbuf();
+  EXPECT_EQ(CountOf(content.str(), "GraphOptimize::OptimizeSubGraph"), 4);
+  std::set<int32_t> tids;
+  for (const auto &event : BuildTracer::Instance().events_) {
+    tids.insert(event.tid);
+  }
+  EXPECT_EQ(tids.size(), 4);
+  (void)remove(file.c_str());
+}
+}  // namespace ge
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/ge/content_hash.h"
+
+namespace ge {
+class UtestContentHash : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+TEST_F(UtestContentHash, hash64_known_values) {
+  EXPECT_EQ(ContentHash::Hash64(nullptr, 0), 0xEF46DB3751D8E999ULL);
+
+  std::string short_str = "abc";
+  EXPECT_EQ(ContentHash::Hash64(reinterpret_cast<const uint8_t *>(short_str.data()), short_str.size()),
+            0x44BC2CF5AD770999ULL);
+
+  // longer than one stripe of 32 bytes
+  std::string long_str = "Nobody inspects the spammish repetition";
+  EXPECT_EQ(ContentHash::Hash64(reinterpret_cast<const uint8_t *>(long_str.data()), long_str.size()),
+            0xFBCEA83C8A378BF1ULL);
+}
+
+TEST_F(UtestContentHash, digest_same_content) {
+  std::vector<uint8_t> data1(1000);
+  for (size_t i = 0; i < data1.size(); ++i) {
+    data1[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> data2 = data1;
+
+  ContentDigest digest1 = ContentHash::Digest(data1.data(), data1.size());
+  ContentDigest digest2 = ContentHash::Digest(data2.data(), data2.size());
+  EXPECT_EQ(digest1, digest2);
+  EXPECT_EQ(digest1.size, 1000);
+  EXPECT_NE(digest1.hash, digest1.check);
+
+  data2[999] ^= 1;
+  EXPECT_NE(digest1, ContentHash::Digest(data2.data(), data2.size()));
+  EXPECT_NE(digest1, ContentHash::Digest(data1.data(), data1.size() - 1));
+}
+}  // namespace ge
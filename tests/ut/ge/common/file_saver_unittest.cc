@@ -0,0 +1,103 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define protected public
+#define private public
+#include "common/auth/file_saver.h"
+#undef protected
+#undef private
+
+namespace ge {
+class UtestFileSaver : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() { (void)remove(kFilePath); }
+
+  static std::vector<uint8_t> ReadFile() {
+    std::ifstream ifs(kFilePath, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  }
+
+  static constexpr const char *kFilePath = "./ut_file_saver.om";
+};
+
+TEST_F(UtestFileSaver, save_partitions_with_header_and_table) {
+  std::vector<uint8_t> model_def(100, 1);
+  std::vector<uint8_t> weights(3000);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = static_cast<uint8_t>(i % 251);
+  }
+  std::vector<uint8_t> task_info(7, 3);
+  std::vector<ModelPartition> partitions(3);
+  partitions[0].type = ModelPartitionType::MODEL_DEF;
+  partitions[0].data = model_def.data();
+  partitions[0].size = 100;
+  partitions[1].type = ModelPartitionType::WEIGHTS_DATA;
+  partitions[1].data = weights.data();
+  partitions[1].size = 3000;
+  partitions[2].type = ModelPartitionType::TASK_INFO;
+  partitions[2].data = task_info.data();
+  partitions[2].size = 7;
+
+  std::vector<char> table_buffer(sizeof(ModelPartitionTable) + sizeof(ModelPartitionMemInfo) * partitions.size());
+  auto table = reinterpret_cast<ModelPartitionTable *>(table_buffer.data());
+  table->num = static_cast<uint32_t>(partitions.size());
+  uint32_t mem_offset = 0;
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    table->partition[i] = {partitions[i].type, mem_offset, partitions[i].size};
+    mem_offset += partitions[i].size;
+  }
+  ModelFileHeader header;
+  header.length = SIZE_OF_MODEL_PARTITION_TABLE(*table) + mem_offset;
+
+  EXPECT_EQ(FileSaver::SaveToFile(kFilePath, header, *table, partitions), SUCCESS);
+
+  std::vector<uint8_t> file = ReadFile();
+  size_t table_size = SIZE_OF_MODEL_PARTITION_TABLE(*table);
+  ASSERT_EQ(file.size(), sizeof(ModelFileHeader) + table_size + mem_offset);
+  EXPECT_EQ(memcmp(file.data(), &header, sizeof(ModelFileHeader)), 0);
+  EXPECT_EQ(memcmp(file.data() + sizeof(ModelFileHeader), table, table_size), 0);
+  size_t offset = sizeof(ModelFileHeader) + table_size;
+  for (const auto &partition : partitions) {
+    EXPECT_EQ(memcmp(file.data() + offset, partition.data, partition.size), 0);
+    offset += partition.size;
+  }
+}
+
+TEST_F(UtestFileSaver, write_data_at_offset) {
+  int32_t fd = 0;
+  ASSERT_EQ(FileSaver::OpenFile(fd, kFilePath), SUCCESS);
+  std::string tail = "world";
+  std::string head = "hello";
+  EXPECT_EQ(FileSaver::WriteDataAt(tail.data(), tail.size(), 5, fd), SUCCESS);
+  EXPECT_EQ(FileSaver::WriteDataAt(head.data(), head.size(), 0, fd), SUCCESS);
+  EXPECT_NE(FileSaver::WriteDataAt(nullptr, 1, 0, fd), SUCCESS);
+  EXPECT_NE(FileSaver::WriteDataAt(head.data(), head.size(), -1, fd), SUCCESS);
+  EXPECT_EQ(mmClose(fd), EN_OK);
+
+  std::vector<uint8_t> file = ReadFile();
+  EXPECT_EQ(std::string(file.begin(), file.end()), "helloworld");
+}
+}  // namespace ge
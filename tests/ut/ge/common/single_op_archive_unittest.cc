@@ -0,0 +1,95 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "common/single_op_archive.h"
+
+namespace ge {
+class UtestSingleOpArchive : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() { (void)remove(kFilePath); }
+
+  static std::vector<uint8_t> ReadFile() {
+    std::ifstream ifs(kFilePath, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  }
+
+  static constexpr const char *kFilePath = "./ut_single_op_archive.bin";
+};
+
+TEST_F(UtestSingleOpArchive, save_and_load_shared_models) {
+  SingleOpArchive archive;
+  size_t first = archive.AddModel(std::vector<uint8_t>(13, 1));
+  size_t second = archive.AddModel(std::vector<uint8_t>(5, 2));
+  EXPECT_EQ(archive.AddKey("add_0", first), SUCCESS);
+  EXPECT_EQ(archive.AddKey("add_1", first), SUCCESS);
+  EXPECT_EQ(archive.AddKey("mul_0", second), SUCCESS);
+  EXPECT_NE(archive.AddKey("mul_0", second), SUCCESS);
+  EXPECT_NE(archive.AddKey("sub_0", 2), SUCCESS);
+  ASSERT_EQ(archive.Save(kFilePath), SUCCESS);
+
+  std::vector<uint8_t> data = ReadFile();
+  SingleOpArchive loaded;
+  ASSERT_EQ(loaded.Load(data.data(), data.size()), SUCCESS);
+  EXPECT_EQ(loaded.GetKeyNum(), 3);
+
+  ModelData add_0;
+  ModelData add_1;
+  ModelData mul_0;
+  ASSERT_EQ(loaded.FindModel("add_0", add_0), SUCCESS);
+  ASSERT_EQ(loaded.FindModel("add_1", add_1), SUCCESS);
+  ASSERT_EQ(loaded.FindModel("mul_0", mul_0), SUCCESS);
+  EXPECT_EQ(add_0.model_data, add_1.model_data);
+  EXPECT_EQ(add_0.model_len, 13);
+  EXPECT_EQ(mul_0.model_len, 5);
+  EXPECT_EQ(static_cast<uint8_t *>(mul_0.model_data)[4], 2);
+
+  ModelData missing;
+  EXPECT_NE(loaded.FindModel("sub_0", missing), SUCCESS);
+}
+
+TEST_F(UtestSingleOpArchive, load_invalid_data) {
+  SingleOpArchive archive;
+  std::vector<uint8_t> data(64, 0);
+  EXPECT_NE(archive.Load(nullptr, 0), SUCCESS);
+  EXPECT_NE(archive.Load(data.data(), data.size()), SUCCESS);
+}
+
+TEST_F(UtestSingleOpArchive, load_too_many_models) {
+  SingleOpArchive archive;
+  ASSERT_EQ(archive.AddKey("add_0", archive.AddModel(std::vector<uint8_t>(8, 1))), SUCCESS);
+  ASSERT_EQ(archive.Save(kFilePath), SUCCESS);
+  std::vector<uint8_t> data = ReadFile();
+  // model num of archive head is after magic and version
+  const size_t model_num_offset = 8;
+  ASSERT_GT(data.size(), model_num_offset + sizeof(uint32_t));
+  uint32_t model_num = UINT32_MAX;
+  memcpy(data.data() + model_num_offset, &model_num, sizeof(model_num));
+
+  SingleOpArchive loaded;
+  EXPECT_EQ(loaded.Load(data.data(), data.size()), PARAM_INVALID);
+}
+}  // namespace ge
@@ -0,0 +1,160 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/opskernel/ops_kernel_info_store.h"
+#include "common/types.h"
+#include "graph/op_desc.h"
+#include "graph/utils/attr_utils.h"
+
+#define protected public
+#define private public
+#include "engine_manager/dnnengine_manager.h"
+#include "opskernel_manager/ops_kernel_manager.h"
+#undef protected
+#undef private
+
+namespace ge {
+namespace {
+// Supports ops whose names are not rejected, and counts CheckSupported calls
+class FakeOpsKernelInfoStore : public OpsKernelInfoStore {
+ public:
+  Status Initialize(const map<string, string> &options) override { return SUCCESS; }
+  Status Finalize() override { return SUCCESS; }
+  void GetAllOpsKernelInfo(map<string, OpInfo> &infos) const override {}
+  bool CheckSupported(const OpDescPtr &op_desc, std::string &un_supported_reason) const override {
+    ++check_num;
+    if (rejected_names.count(op_desc->GetName()) > 0) {
+      un_supported_reason = "rejected";
+      return false;
+    }
+    return true;
+  }
+  Status CalcOpRunningParam(Node &node) override { return SUCCESS; }
+  Status GenerateTask(const Node &node, RunContext &context, std::vector<domi::TaskDef> &tasks) override {
+    return SUCCESS;
+  }
+
+  mutable size_t check_num = 0;
+  std::set<std::string> rejected_names;
+};
+
+OpDescPtr CreateOpDesc(const std::string &name, const std::string &type) {
+  auto op_desc = std::make_shared<OpDesc>(name, type);
+  GeTensorDesc tensor_desc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT);
+  op_desc->AddInputDesc(tensor_desc);
+  op_desc->AddOutputDesc(tensor_desc);
+  return op_desc;
+}
+}  // namespace
+
+class UtestDNNEngineManager : public testing::Test {
+ protected:
+  void SetUp() {
+    first_store_ = std::make_shared<FakeOpsKernelInfoStore>();
+    second_store_ = std::make_shared<FakeOpsKernelInfoStore>();
+    ops_kernel_manager_.ops_kernel_store_ = {{"FirstLib", first_store_}, {"SecondLib", second_store_}};
+    OpInfo first_info;
+    first_info.engine = "FirstEngine";
+    first_info.opKernelLib = "FirstLib";
+    OpInfo second_info;
+    second_info.engine = "SecondEngine";
+    second_info.opKernelLib = "SecondLib";
+    ops_kernel_manager_.ops_kernel_info_[RELU] = {first_info, second_info};
+  }
+
+  void TearDown() {}
+
+  OpsKernelManager ops_kernel_manager_;
+  DNNEngineManager engine_manager_;
+  std::shared_ptr<FakeOpsKernelInfoStore> first_store_;
+  std::shared_ptr<FakeOpsKernelInfoStore> second_store_;
+};
+
+TEST_F(UtestDNNEngineManager, place_same_ops_once) {
+  std::vector<OpDescPtr> op_descs = {CreateOpDesc("relu1", RELU), CreateOpDesc("relu2", RELU),
+                                     CreateOpDesc("relu3", RELU)};
+  std::vector<std::string> engine_names;
+  EXPECT_EQ(engine_manager_.PlaceOps(ops_kernel_manager_, op_descs, engine_names), SUCCESS);
+  EXPECT_EQ(first_store_->check_num, 1);
+  ASSERT_EQ(engine_names.size(), 3);
+  for (size_t i = 0; i < op_descs.size(); ++i) {
+    EXPECT_EQ(engine_names[i], "FirstEngine");
+    EXPECT_EQ(op_descs[i]->GetOpEngineName(), "FirstEngine");
+    EXPECT_EQ(op_descs[i]->GetOpKernelLibName(), "FirstLib");
+  }
+}
+
+TEST_F(UtestDNNEngineManager, place_ops_of_different_attrs_separately) {
+  std::vector<OpDescPtr> op_descs = {CreateOpDesc("relu1", RELU), CreateOpDesc("relu2", RELU)};
+  // private attrs are part of the signature too
+  (void)AttrUtils::SetBool(op_descs[1], "_custom_op_flag", true);
+  first_store_->rejected_names = {"relu2"};
+  std::vector<std::string> engine_names;
+  EXPECT_NE(engine_manager_.PlaceOps(ops_kernel_manager_, op_descs, engine_names), SUCCESS);
+  EXPECT_EQ(first_store_->check_num, 2);
+  // custom op is not placed on next candidate once check support failed
+  EXPECT_EQ(second_store_->check_num, 0);
+  EXPECT_EQ(engine_names[0], "FirstEngine");
+  EXPECT_EQ(engine_names[1], "");
+}
+
+TEST_F(UtestDNNEngineManager, place_ops_of_different_origin_descs_separately) {
+  std::vector<OpDescPtr> op_descs = {CreateOpDesc("relu1", RELU), CreateOpDesc("relu2", RELU),
+                                     CreateOpDesc("relu3", RELU)};
+  op_descs[1]->MutableInputDesc(0)->SetOriginShape(GeShape({16}));
+  op_descs[2]->MutableInputDesc(0)->SetOriginDataType(DT_FLOAT16);
+  first_store_->rejected_names = {"relu2", "relu3"};
+  std::vector<std::string> engine_names;
+  EXPECT_EQ(engine_manager_.PlaceOps(ops_kernel_manager_, op_descs, engine_names), SUCCESS);
+  EXPECT_EQ(first_store_->check_num, 3);
+  EXPECT_EQ(engine_names[0], "FirstEngine");
+  EXPECT_EQ(engine_names[1], "SecondEngine");
+  EXPECT_EQ(engine_names[2], "SecondEngine");
+}
+
+TEST_F(UtestDNNEngineManager, place_on_next_candidate) {
+  std::vector<OpDescPtr> op_descs = {CreateOpDesc("relu1", RELU)};
+  first_store_->rejected_names = {"relu1"};
+  std::vector<std::string> engine_names;
+  EXPECT_EQ(engine_manager_.PlaceOps(ops_kernel_manager_, op_descs, engine_names), SUCCESS);
+  EXPECT_EQ(engine_names[0], "SecondEngine");
+  EXPECT_EQ(op_descs[0]->GetOpKernelLibName(), "SecondLib");
+}
+
+TEST_F(UtestDNNEngineManager, placement_not_kept_across_calls) {
+  std::vector<std::string> engine_names;
+  EXPECT_EQ(engine_manager_.PlaceOps(ops_kernel_manager_, {CreateOpDesc("relu1", RELU)}, engine_names), SUCCESS);
+  first_store_->rejected_names = {"relu2"};
+  EXPECT_EQ(engine_manager_.PlaceOps(ops_kernel_manager_, {CreateOpDesc("relu2", RELU)}, engine_names), SUCCESS);
+  EXPECT_EQ(first_store_->check_num, 2);
+  EXPECT_EQ(engine_names[0], "SecondEngine");
+}
+
+TEST_F(UtestDNNEngineManager, place_unknown_op_failed) {
+  std::vector<OpDescPtr> op_descs = {CreateOpDesc("unknown", "UnknownType")};
+  std::vector<std::string> engine_names;
+  EXPECT_NE(engine_manager_.PlaceOps(ops_kernel_manager_, op_descs, engine_names), SUCCESS);
+  EXPECT_EQ(engine_names[0], "");
+}
+}  // namespace ge
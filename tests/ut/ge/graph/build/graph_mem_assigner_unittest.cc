@@ -0,0 +1,289 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "omg/omg_inner_types.h"
+
+#define protected public
+#define private public
+#include "graph/build/memory/graph_mem_assigner.h"
+#undef protected
+#undef private
+
+using namespace std;
+using namespace testing;
+using namespace ge;
+
+class UtestGraphMemAssigner : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+
+  NodePtr AddNode(ComputeGraphPtr &graph, const string &name, const string &type, int in_num, int out_num) {
+    OpDescPtr op_desc = make_shared<OpDesc>(name, type);
+    GeTensorDesc tensor_desc;
+    TensorUtils::SetSize(tensor_desc, kTensorSize);
+    for (int i = 0; i < in_num; ++i) {
+      op_desc->AddInputDesc(tensor_desc);
+    }
+    for (int i = 0; i < out_num; ++i) {
+      op_desc->AddOutputDesc(tensor_desc);
+    }
+    op_desc->SetOutputOffset(vector<int64_t>(out_num, 0));
+    return graph->AddNode(op_desc);
+  }
+
+  NodePtr AddHcomNode(ComputeGraphPtr &graph, const string &name, bool is_atomic, NodePtr &input) {
+    NodePtr node = AddNode(graph, name, HCOMALLREDUCE, 1, 1);
+    (void)AttrUtils::SetBool(node->GetOpDesc(), ATTR_NAME_CONTINUOUS_INPUT, true);
+    if (is_atomic) {
+      (void)AttrUtils::SetListInt(node->GetOpDesc(), ATOMIC_ATTR_INPUT_INDEX, vector<int64_t>({-1}));
+    }
+    (void)GraphUtils::AddEdge(input->GetOutDataAnchor(0), node->GetInDataAnchor(0));
+    return node;
+  }
+
+  // Atomic node with a read output, an output never read and a workspace
+  NodePtr AddAtomicNode(ComputeGraphPtr &graph, const string &name, NodePtr &reader) {
+    NodePtr node = AddNode(graph, name, "ReduceSum", 0, 2);
+    OpDescPtr op_desc = node->GetOpDesc();
+    (void)AttrUtils::SetBool(op_desc, ATOMIC_ATTR_IS_ATOMIC_NODE, true);
+    (void)AttrUtils::SetListInt(op_desc, ATOMIC_ATTR_OUTPUT_INDEX, vector<int64_t>({0, 1}));
+    op_desc->SetWorkspace({0});
+    op_desc->SetWorkspaceBytes({kWorkspaceSize});
+    map<string, map<int64_t, int64_t>> workspace_info = {{name, {{0, kWorkspaceSize}}}};
+    (void)op_desc->SetExtAttr(EXT_ATTR_ATOMIC_WORKSPACE_INFO, workspace_info);
+    (void)GraphUtils::AddEdge(node->GetOutDataAnchor(0), reader->GetInDataAnchor(0));
+    return node;
+  }
+
+  void GetCleanRanges(const NodePtr &clean_node, vector<int64_t> &starts, vector<int64_t> &sizes) {
+    (void)AttrUtils::GetListInt(clean_node->GetOpDesc(), ATTR_NAME_AUTOMIC_ADD_START, starts);
+    (void)AttrUtils::GetListInt(clean_node->GetOpDesc(), ATTR_NAME_AUTOMIC_ADD_MEM_SIZE, sizes);
+  }
+
+  const int64_t kTensorSize = 1024;
+  const int64_t kWorkspaceSize = 512;
+};
+
+TEST_F(UtestGraphMemAssigner, coalesce_atomic_clean_ranges) {
+  ComputeGraphPtr graph = make_shared<ComputeGraph>("graph");
+  NodePtr clean = AddNode(graph, "atomic_addr_clean", ATOMICADDRCLEAN, 0, 0);
+  NodePtr input1 = AddNode(graph, "input1", "Relu", 0, 1);
+  NodePtr input2 = AddNode(graph, "input2", "Relu", 0, 1);
+  NodePtr input3 = AddNode(graph, "input3", "Relu", 0, 1);
+  // Continuous input of the concat is between the two allreduce, which are cleaned
+  (void)AddHcomNode(graph, "allreduce1", true, input1);
+  (void)AddHcomNode(graph, "concat", false, input2);
+  (void)AddHcomNode(graph, "allreduce2", true, input3);
+  NodePtr reader = AddNode(graph, "reader", "Relu", 1, 1);
+  NodePtr atomic = AddAtomicNode(graph, "reduce", reader);
+
+  GraphMemoryAssigner assigner(graph);
+  assigner.memory_offset_.emplace_back(RT_MEMORY_HBM, 0);
+  EXPECT_EQ(assigner.ReAssignContinuousMemory(false), SUCCESS);
+  EXPECT_EQ(assigner.ReAssignAtomicMemory(false), SUCCESS);
+  EXPECT_EQ(assigner.SetAtomicCleanAttrs(), SUCCESS);
+
+  // concat input at 0, allreduce inputs at 1536 and 3072, atomic memory from 4608
+  EXPECT_EQ(input2->GetOpDesc()->GetOutputOffset()[0], 0);
+  EXPECT_EQ(input1->GetOpDesc()->GetOutputOffset()[0], 1536);
+  EXPECT_EQ(input3->GetOpDesc()->GetOutputOffset()[0], 3072);
+  EXPECT_EQ(atomic->GetOpDesc()->GetOutputOffset()[0], 4608);
+  EXPECT_EQ(atomic->GetOpDesc()->GetWorkspace()[0], 5632);
+  // Output never read is after the clean span
+  EXPECT_EQ(atomic->GetOpDesc()->GetOutputOffset()[1], 6144);
+
+  vector<int64_t> starts;
+  vector<int64_t> sizes;
+  GetCleanRanges(clean, starts, sizes);
+  EXPECT_EQ(starts, vector<int64_t>({1536}));
+  EXPECT_EQ(sizes, vector<int64_t>({4608}));
+  EXPECT_EQ(clean->GetOpDesc()->GetWorkspaceBytes(), vector<int64_t>({4608}));
+
+  EXPECT_EQ(assigner.GetAtomicCleanStatBefore().range_num, 3);
+  EXPECT_EQ(assigner.GetAtomicCleanStatBefore().clean_size, 5632);
+  EXPECT_EQ(assigner.GetAtomicCleanStatAfter().range_num, 1);
+  EXPECT_EQ(assigner.GetAtomicCleanStatAfter().clean_size, 4608);
+}
+
+TEST_F(UtestGraphMemAssigner, loop_graph_clean_range_of_each_node) {
+  ComputeGraphPtr graph = make_shared<ComputeGraph>("loop_graph");
+  NodePtr clean1 = AddNode(graph, "atomic_addr_clean1", ATOMICADDRCLEAN, 0, 0);
+  NodePtr clean2 = AddNode(graph, "atomic_addr_clean2", ATOMICADDRCLEAN, 0, 0);
+  NodePtr reader1 = AddNode(graph, "reader1", "Relu", 1, 1);
+  NodePtr reader2 = AddNode(graph, "reader2", "Relu", 1, 1);
+  NodePtr atomic1 = AddAtomicNode(graph, "reduce1", reader1);
+  NodePtr atomic2 = AddAtomicNode(graph, "reduce2", reader2);
+  (void)GraphUtils::AddEdge(clean1->GetOutControlAnchor(), atomic1->GetInControlAnchor());
+  (void)GraphUtils::AddEdge(clean2->GetOutControlAnchor(), atomic2->GetInControlAnchor());
+  // Output 1 of reduce2 is output of graph
+  domi::GetContext().out_nodes_map["reduce2"] = {1};
+
+  GraphMemoryAssigner assigner(graph);
+  assigner.memory_offset_.emplace_back(RT_MEMORY_HBM, 0);
+  EXPECT_EQ(assigner.ReAssignAtomicMemory(true), SUCCESS);
+  EXPECT_EQ(assigner.SetAtomicCleanAttrs(), SUCCESS);
+  domi::GetContext().out_nodes_map.clear();
+
+  vector<int64_t> starts;
+  vector<int64_t> sizes;
+  GetCleanRanges(clean1, starts, sizes);
+  EXPECT_EQ(starts, vector<int64_t>({0}));
+  EXPECT_EQ(sizes, vector<int64_t>({1536}));
+  EXPECT_EQ(atomic1->GetOpDesc()->GetOutputOffset()[1], 1536);
+
+  GetCleanRanges(clean2, starts, sizes);
+  EXPECT_EQ(starts, vector<int64_t>({2560}));
+  EXPECT_EQ(sizes, vector<int64_t>({2560}));
+  EXPECT_EQ(atomic2->GetOpDesc()->GetOutputOffset()[1], 3584);
+  EXPECT_EQ(assigner.memory_offset_[0].mem_offset_, 5120);
+
+  EXPECT_EQ(assigner.GetAtomicCleanStatBefore().range_num, 2);
+  EXPECT_EQ(assigner.GetAtomicCleanStatBefore().clean_size, 5120);
+  EXPECT_EQ(assigner.GetAtomicCleanStatAfter().range_num, 2);
+  EXPECT_EQ(assigner.GetAtomicCleanStatAfter().clean_size, 4096);
+}
+
+TEST_F(UtestGraphMemAssigner, virtual_split_outputs_are_views_of_input) {
+  ComputeGraphPtr graph = make_shared<ComputeGraph>("graph");
+  NodePtr input = AddNode(graph, "input", "Relu", 0, 1);
+  input->GetOpDesc()->MutableOutputDesc(0)->SetShape(GeShape({1, 4, 16, 16}));
+  NodePtr split_dim = AddNode(graph, "split_dim", "Const", 0, 1);
+  NodePtr split = AddNode(graph, "split", SPLIT, 2, 2);
+  OpDescPtr split_desc = split->GetOpDesc();
+  split_desc->MutableInputDesc(1)->SetShape(GeShape({1, 4, 16, 16}));
+  split_desc->MutableOutputDesc(0)->SetShape(GeShape({1, 1, 16, 16}));
+  split_desc->MutableOutputDesc(1)->SetShape(GeShape({1, 3, 16, 16}));
+  (void)AttrUtils::SetInt(split_desc, "fusion_virtual_op", 1);
+  NodePtr reader1 = AddNode(graph, "reader1", "Relu", 1, 1);
+  NodePtr reader2 = AddNode(graph, "reader2", "Relu", 1, 1);
+  // Data input of Split is the second one
+  (void)GraphUtils::AddEdge(split_dim->GetOutDataAnchor(0), split->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(input->GetOutDataAnchor(0), split->GetInDataAnchor(1));
+  (void)GraphUtils::AddEdge(split->GetOutDataAnchor(0), reader1->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(split->GetOutDataAnchor(1), reader2->GetInDataAnchor(0));
+
+  GraphMemoryAssigner assigner(graph);
+  assigner.memory_offset_.emplace_back(RT_MEMORY_HBM, 512);
+  EXPECT_EQ(assigner.ReAssignVirtualSplitMemory(), SUCCESS);
+  // Second slice starts after the 1024 bytes of the first one
+  EXPECT_EQ(input->GetOpDesc()->GetOutputOffset()[0], 512);
+  EXPECT_EQ(split_desc->GetOutputOffset(), vector<int64_t>({512, 1536}));
+  EXPECT_EQ(assigner.memory_offset_[0].mem_offset_, 2560);
+  EXPECT_EQ(assigner.GetVirtualSplitSize(), 2048);
+
+  // Slices along the second axis are not contiguous if the first dim is not 1
+  input->GetOpDesc()->MutableOutputDesc(0)->SetShape(GeShape({2, 4, 16, 16}));
+  split_desc->MutableInputDesc(1)->SetShape(GeShape({2, 4, 16, 16}));
+  split_desc->MutableOutputDesc(0)->SetShape(GeShape({2, 1, 16, 16}));
+  split_desc->MutableOutputDesc(1)->SetShape(GeShape({2, 3, 16, 16}));
+  EXPECT_EQ(assigner.ReAssignVirtualSplitMemory(), PARAM_INVALID);
+}
+
+TEST_F(UtestGraphMemAssigner, virtual_split_rejects_unaligned_slices) {
+  ComputeGraphPtr graph = make_shared<ComputeGraph>("graph");
+  NodePtr input = AddNode(graph, "input", "Relu", 0, 1);
+  input->GetOpDesc()->MutableOutputDesc(0)->SetShape(GeShape({1, 4, 2, 2}));
+  NodePtr split_dim = AddNode(graph, "split_dim", "Const", 0, 1);
+  NodePtr split = AddNode(graph, "split", SPLIT, 2, 2);
+  OpDescPtr split_desc = split->GetOpDesc();
+  split_desc->MutableInputDesc(1)->SetShape(GeShape({1, 4, 2, 2}));
+  split_desc->MutableOutputDesc(0)->SetShape(GeShape({1, 1, 2, 2}));
+  split_desc->MutableOutputDesc(1)->SetShape(GeShape({1, 3, 2, 2}));
+  (void)AttrUtils::SetInt(split_desc, "fusion_virtual_op", 1);
+  NodePtr reader1 = AddNode(graph, "reader1", "Relu", 1, 1);
+  NodePtr reader2 = AddNode(graph, "reader2", "Relu", 1, 1);
+  (void)GraphUtils::AddEdge(split_dim->GetOutDataAnchor(0), split->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(input->GetOutDataAnchor(0), split->GetInDataAnchor(1));
+  (void)GraphUtils::AddEdge(split->GetOutDataAnchor(0), reader1->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(split->GetOutDataAnchor(1), reader2->GetInDataAnchor(0));
+
+  // Second slice would start 16 bytes after the first one
+  GraphMemoryAssigner assigner(graph);
+  assigner.memory_offset_.emplace_back(RT_MEMORY_HBM, 512);
+  EXPECT_EQ(assigner.ReAssignVirtualSplitMemory(), PARAM_INVALID);
+  // Nothing is assigned for the rejected split
+  EXPECT_EQ(input->GetOpDesc()->GetOutputOffset()[0], 0);
+  EXPECT_EQ(split_desc->GetOutputOffset(), vector<int64_t>({0, 0}));
+  EXPECT_EQ(assigner.memory_offset_[0].mem_offset_, 512);
+}
+
+TEST_F(UtestGraphMemAssigner, virtual_split_data_input_by_name_or_index) {
+  ComputeGraphPtr graph = make_shared<ComputeGraph>("graph");
+  NodePtr input = AddNode(graph, "input", "Relu", 0, 1);
+  input->GetOpDesc()->MutableOutputDesc(0)->SetShape(GeShape({1, 4, 16, 16}));
+  NodePtr size_splits = AddNode(graph, "size_splits", "Const", 0, 1);
+  NodePtr split_dim = AddNode(graph, "split_dim", "Const", 0, 1);
+  NodePtr split = AddNode(graph, "split", SPLITV, 3, 2);
+  OpDescPtr split_desc = split->GetOpDesc();
+  split_desc->MutableInputDesc(0)->SetShape(GeShape({1, 4, 16, 16}));
+  // Data input of SplitV is the first one, even if others are larger
+  split_desc->MutableInputDesc(1)->SetShape(GeShape({4096}));
+  split_desc->MutableOutputDesc(0)->SetShape(GeShape({1, 1, 16, 16}));
+  split_desc->MutableOutputDesc(1)->SetShape(GeShape({1, 3, 16, 16}));
+  (void)AttrUtils::SetInt(split_desc, "fusion_virtual_op", 1);
+  NodePtr reader1 = AddNode(graph, "reader1", "Relu", 1, 1);
+  NodePtr reader2 = AddNode(graph, "reader2", "Relu", 1, 1);
+  (void)GraphUtils::AddEdge(input->GetOutDataAnchor(0), split->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(size_splits->GetOutDataAnchor(0), split->GetInDataAnchor(1));
+  (void)GraphUtils::AddEdge(split_dim->GetOutDataAnchor(0), split->GetInDataAnchor(2));
+  (void)GraphUtils::AddEdge(split->GetOutDataAnchor(0), reader1->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(split->GetOutDataAnchor(1), reader2->GetInDataAnchor(0));
+
+  GraphMemoryAssigner assigner(graph);
+  assigner.memory_offset_.emplace_back(RT_MEMORY_HBM, 512);
+  EXPECT_EQ(assigner.ReAssignVirtualSplitMemory(), SUCCESS);
+  EXPECT_EQ(input->GetOpDesc()->GetOutputOffset()[0], 512);
+  EXPECT_EQ(size_splits->GetOpDesc()->GetOutputOffset()[0], 0);
+  EXPECT_EQ(split_desc->GetOutputOffset(), vector<int64_t>({512, 1536}));
+
+  // Input named x is the data input wherever it is
+  ComputeGraphPtr named_graph = make_shared<ComputeGraph>("named_graph");
+  NodePtr named_input = AddNode(named_graph, "input", "Relu", 0, 1);
+  named_input->GetOpDesc()->MutableOutputDesc(0)->SetShape(GeShape({1, 4, 16, 16}));
+  NodePtr named_split_dim = AddNode(named_graph, "split_dim", "Const", 0, 1);
+  OpDescPtr named_desc = make_shared<OpDesc>("split", SPLIT);
+  GeTensorDesc tensor_desc(GeShape({1, 4, 16, 16}));
+  (void)named_desc->AddInputDesc("x", tensor_desc);
+  (void)named_desc->AddInputDesc("split_dim", GeTensorDesc());
+  tensor_desc.SetShape(GeShape({1, 2, 16, 16}));
+  (void)named_desc->AddOutputDesc(tensor_desc);
+  (void)named_desc->AddOutputDesc(tensor_desc);
+  named_desc->SetOutputOffset(vector<int64_t>(2, 0));
+  (void)AttrUtils::SetInt(named_desc, "fusion_virtual_op", 1);
+  NodePtr named_split = named_graph->AddNode(named_desc);
+  NodePtr named_reader = AddNode(named_graph, "reader", "Relu", 1, 1);
+  (void)GraphUtils::AddEdge(named_input->GetOutDataAnchor(0), named_split->GetInDataAnchor(0));
+  (void)GraphUtils::AddEdge(named_split_dim->GetOutDataAnchor(0), named_split->GetInDataAnchor(1));
+  (void)GraphUtils::AddEdge(named_split->GetOutDataAnchor(0), named_reader->GetInDataAnchor(0));
+
+  GraphMemoryAssigner named_assigner(named_graph);
+  named_assigner.memory_offset_.emplace_back(RT_MEMORY_HBM, 512);
+  EXPECT_EQ(named_assigner.ReAssignVirtualSplitMemory(), SUCCESS);
+  EXPECT_EQ(named_input->GetOpDesc()->GetOutputOffset()[0], 512);
+  EXPECT_EQ(named_desc->GetOutputOffset(), vector<int64_t>({512, 2560}));
+}
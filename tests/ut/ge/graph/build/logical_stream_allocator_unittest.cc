@@ -28,8 +28,10 @@
 
 #include "common/types.h"
 #include "common/util.h"
+#include "ge/ge_api_types.h"
 
 #include "graph/compute_graph.h"
+#include "graph/ge_local_context.h"
 #include "graph/utils/attr_utils.h"
 #include "graph/utils/graph_utils.h"
 
@@ -148,6 +150,19 @@ class UtestLogicalStreamAllocator : public testing::Test {
     return subgraph;
   }
 
+  SubGraphInfoPtr CreateSubgraphWithCost(const string &name, const string &engine, int64_t element_num,
+                                         int in_num = 1, int out_num = 1) {
+    ComputeGraphPtr compute_graph = make_shared<ComputeGraph>(name);
+    OpDescPtr op_desc = std::make_shared<OpDesc>(name + "_relu", "Relu");
+    op_desc->AddInputDesc(GeTensorDesc());
+    op_desc->AddOutputDesc(GeTensorDesc(GeShape({element_num})));
+    compute_graph->AddNode(op_desc);
+
+    SubGraphInfoPtr subgraph = BuildSubGraph(compute_graph, engine);
+    AddPlaceHolderAndEnd(subgraph, in_num, out_num);
+    return subgraph;
+  }
+
   SubGraphInfoPtr CreateSubgraph(const string &engine, const string &stream_label = "", int in_num = 1,
                                  int out_num = 1) {
     return CreateSubgraphWithName("graph", engine, stream_label, in_num, out_num);
@@ -848,6 +863,76 @@ TEST_F(UtestLogicalStreamAllocator, test_reassign_stream) {
   EXPECT_EQ(GetStream(subgraph3), 0);
 }
 
+///                 -> B1 -> B2 -> B3 (long)
+///  A(aicore)      -> C (short)
+///                 -> D1 -> D2 (long)
+/// With two streams, dependency heuristic puts both long branches on the same stream.
+TEST_F(UtestLogicalStreamAllocator, test_assign_by_cost_model) {
+  auto build_and_assign = [this](bool enable_cost_model, vector<SubGraphInfoPtr> &subgraphs) {
+    auto a = CreateSubgraphWithCost("a", "aicore", 1024, 0, 3);
+    auto b1 = CreateSubgraphWithCost("b1", "aicore", 100 * 1024);
+    auto b2 = CreateSubgraphWithCost("b2", "aicore", 100 * 1024);
+    auto b3 = CreateSubgraphWithCost("b3", "aicore", 100 * 1024);
+    auto c = CreateSubgraphWithCost("c", "aicore", 1024);
+    auto d1 = CreateSubgraphWithCost("d1", "aicore", 100 * 1024);
+    auto d2 = CreateSubgraphWithCost("d2", "aicore", 100 * 1024);
+    LinkSubGraph(a, "end1", b1, "placeholder");
+    LinkSubGraph(a, "end2", c, "placeholder");
+    LinkSubGraph(a, "end3", d1, "placeholder");
+    LinkSubGraph(b1, "end", b2, "placeholder");
+    LinkSubGraph(b2, "end", b3, "placeholder");
+    LinkSubGraph(d1, "end", d2, "placeholder");
+    subgraphs = {a, b1, c, d1, b2, b3, d2};
+
+    map<string, string> options = {{STREAM_COST_MODEL, enable_cost_model ? "1" : "0"}};
+    GetThreadLocalContext().SetGraphOption(options);
+    std::map<std::string, int> max_parallel_num = {{"aicore", 2}};
+    return AssignLogicalStreams(subgraphs, max_parallel_num);
+  };
+
+  vector<SubGraphInfoPtr> subgraphs;
+  EXPECT_EQ(build_and_assign(false, subgraphs), SUCCESS);
+  EXPECT_EQ(GetStream(subgraphs[1]), GetStream(subgraphs[3]));
+
+  EXPECT_EQ(build_and_assign(true, subgraphs), SUCCESS);
+  EXPECT_EQ(GetStream(subgraphs[1]), GetStream(subgraphs[4]));
+  EXPECT_EQ(GetStream(subgraphs[4]), GetStream(subgraphs[5]));
+  EXPECT_EQ(GetStream(subgraphs[3]), GetStream(subgraphs[6]));
+  EXPECT_NE(GetStream(subgraphs[1]), GetStream(subgraphs[3]));
+
+  map<string, string> options = {{STREAM_COST_MODEL, "0"}};
+  GetThreadLocalContext().SetGraphOption(options);
+}
+
+TEST_F(UtestLogicalStreamAllocator, test_makespan_simulator) {
+  vector<StreamSimTask> tasks(3);
+  tasks[0].cost = 10;
+  tasks[1].cost = 20;
+  tasks[1].preds = {0};
+  tasks[2].cost = 30;
+  tasks[2].preds = {0};
+
+  // All tasks on one stream run serially.
+  for (auto &task : tasks) {
+    task.stream_id = 0;
+  }
+  StreamSimResult result;
+  EXPECT_EQ(StreamMakespanSimulator::Simulate(tasks, result), SUCCESS);
+  EXPECT_EQ(result.makespan, 60);
+  EXPECT_EQ(result.event_num, 0);
+  EXPECT_EQ(result.stream_num, 1);
+
+  // Branches on two streams overlap, with the cost of one event.
+  tasks[2].stream_id = 1;
+  EXPECT_EQ(StreamMakespanSimulator::Simulate(tasks, result), SUCCESS);
+  EXPECT_EQ(result.makespan, 10 + StreamMakespanSimulator::kEventCost + 30);
+  EXPECT_EQ(result.event_num, 1);
+  EXPECT_EQ(result.stream_num, 2);
+
+  tasks[0].preds = {2};
+  EXPECT_EQ(StreamMakespanSimulator::Simulate(tasks, result), PARAM_INVALID);
+}
+
 TEST_F(UtestLogicalStreamAllocator, test_all_reduce_parallel_pass) {
   graphStatus ret = GRAPH_SUCCESS;
 
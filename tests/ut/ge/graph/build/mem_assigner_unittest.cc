@@ -173,6 +173,31 @@ class MockBlockMemAssigner : public BlockMemAssigner {
 };
 }  // namespace ge
 
+TEST_F(UtestMemoryAssignerTest, elementwise_output_written_over_input_dying_at_it) {
+  ge::ComputeGraphPtr graph = make_shared<ge::ComputeGraph>("");
+  ge::NodePtr node_a = graph->AddNode(createOpWithWsSize("A", 0));
+  ge::NodePtr node_relu = graph->AddNode(createOpWithWsSize("relu", 0, RELU));
+  ge::NodePtr node_b = graph->AddNode(createOpWithWsSize("B", 0));
+  ge::GraphUtils::AddEdge(node_a->GetOutDataAnchor(0), node_relu->GetInDataAnchor(0));
+  ge::GraphUtils::AddEdge(node_relu->GetOutDataAnchor(0), node_b->GetInDataAnchor(0));
+  graph->TopologicalSorting();
+
+  HybridMemAssigner assigner(graph);
+  EXPECT_EQ(assigner.Assign(), SUCCESS);
+  EXPECT_EQ(node_relu->GetOpDesc()->GetOutputOffset()[0], node_a->GetOpDesc()->GetOutputOffset()[0]);
+  EXPECT_NE(node_b->GetOpDesc()->GetOutputOffset()[0], node_a->GetOpDesc()->GetOutputOffset()[0]);
+  EXPECT_EQ(assigner.GetMemOffset(), 2048);
+
+  // Output of A is still read by C after relu
+  ge::NodePtr node_c = graph->AddNode(createOpWithWsSize("C", 0));
+  ge::GraphUtils::AddEdge(node_a->GetOutDataAnchor(0), node_c->GetInDataAnchor(0));
+  graph->TopologicalSorting();
+  BinaryBlockMemAssigner binary_assigner(graph);
+  EXPECT_EQ(binary_assigner.Assign(), SUCCESS);
+  EXPECT_EQ(binary_assigner.GetInPlaceSize(), 0);
+  EXPECT_NE(node_relu->GetOpDesc()->GetOutputOffset()[0], node_a->GetOpDesc()->GetOutputOffset()[0]);
+}
+
 // when check GetMemoryRanges return fail, Assign return fail
 TEST_F(UtestMemoryAssignerTest, Mock_block_mem_assigner_failed) {
   ge::ComputeGraphPtr graph = make_shared<ge::ComputeGraph>("");
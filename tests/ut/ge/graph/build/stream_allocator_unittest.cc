@@ -0,0 +1,174 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+#include "graph/compute_graph.h"
+#include "graph/passes/graph_builder_utils.h"
+
+#define protected public
+#define private public
+#include "graph/build/stream_allocator.h"
+#undef protected
+#undef private
+
+namespace ge {
+class UtestStreamAllocator : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+namespace {
+// Nodes are added in topological order, each on the given stream
+NodePtr AddStreamNode(ut::GraphBuilder &builder, const std::string &name, int64_t stream_id) {
+  NodePtr node = builder.AddNode(name, RELU, 1, 1);
+  node->GetOpDesc()->SetStreamId(stream_id);
+  return node;
+}
+
+void AddEvent(StreamAllocator &allocator, const NodePtr &send_node, const NodePtr &recv_node) {
+  allocator.AddSendEventId(send_node, allocator.event_num_);
+  allocator.AddRecvEventId(recv_node, allocator.event_num_);
+  allocator.event_num_++;
+}
+
+bool HasEvent(StreamAllocator &allocator, uint32_t event_id) {
+  return allocator.GetNodeFromSendEventId(event_id) != nullptr;
+}
+}  // namespace
+
+///
+/// Stream0    Stream1
+///   a1 -e0->   b1
+///   a2 -e1->   b2
+///   a1 -e2->   b3    (covered by e1)
+///
+TEST_F(UtestStreamAllocator, remove_event_covered_on_same_stream) {
+  ut::GraphBuilder builder("graph");
+  NodePtr a1 = AddStreamNode(builder, "a1", 0);
+  NodePtr b1 = AddStreamNode(builder, "b1", 1);
+  NodePtr a2 = AddStreamNode(builder, "a2", 0);
+  NodePtr b2 = AddStreamNode(builder, "b2", 1);
+  NodePtr b3 = AddStreamNode(builder, "b3", 1);
+  std::vector<SubGraphInfoPtr> subgraphs;
+  StreamAllocator allocator(builder.GetGraph(), subgraphs);
+  allocator.stream_num_ = 2;
+  AddEvent(allocator, a1, b1);
+  AddEvent(allocator, a2, b2);
+  AddEvent(allocator, a1, b3);
+
+  EXPECT_EQ(allocator.OptimizeByVectorClock(), SUCCESS);
+  EXPECT_TRUE(HasEvent(allocator, 0));
+  EXPECT_TRUE(HasEvent(allocator, 1));
+  EXPECT_FALSE(HasEvent(allocator, 2));
+  EXPECT_TRUE(allocator.node_to_recv_events_[b3].empty());
+  EXPECT_EQ(allocator.GetValidEventNum(), 2);
+}
+
+///
+/// Stream0    Stream1    Stream2
+///   a  -e0->   b  -e1->   c
+///   a  - - - - e2 - - - > c    (covered by the chain of e0 and e1)
+///
+TEST_F(UtestStreamAllocator, remove_event_covered_by_cross_stream_chain) {
+  ut::GraphBuilder builder("graph");
+  NodePtr a = AddStreamNode(builder, "a", 0);
+  NodePtr b = AddStreamNode(builder, "b", 1);
+  NodePtr c = AddStreamNode(builder, "c", 2);
+  std::vector<SubGraphInfoPtr> subgraphs;
+  StreamAllocator allocator(builder.GetGraph(), subgraphs);
+  allocator.stream_num_ = 3;
+  AddEvent(allocator, a, b);
+  AddEvent(allocator, b, c);
+  AddEvent(allocator, a, c);
+
+  EXPECT_EQ(allocator.OptimizeByVectorClock(), SUCCESS);
+  EXPECT_TRUE(HasEvent(allocator, 0));
+  EXPECT_TRUE(HasEvent(allocator, 1));
+  EXPECT_FALSE(HasEvent(allocator, 2));
+  EXPECT_EQ(allocator.node_to_recv_events_[c], std::vector<uint32_t>({1}));
+}
+
+///
+/// Stream0    Stream1
+///   a1 -e0->   b1
+///   a2 <-e1-   b2
+///   a3 -e2->   b3    (not covered, a3 is after the last sync from stream0)
+///
+TEST_F(UtestStreamAllocator, keep_events_not_covered) {
+  ut::GraphBuilder builder("graph");
+  NodePtr a1 = AddStreamNode(builder, "a1", 0);
+  NodePtr b1 = AddStreamNode(builder, "b1", 1);
+  NodePtr b2 = AddStreamNode(builder, "b2", 1);
+  NodePtr a2 = AddStreamNode(builder, "a2", 0);
+  NodePtr a3 = AddStreamNode(builder, "a3", 0);
+  NodePtr b3 = AddStreamNode(builder, "b3", 1);
+  std::vector<SubGraphInfoPtr> subgraphs;
+  StreamAllocator allocator(builder.GetGraph(), subgraphs);
+  allocator.stream_num_ = 2;
+  AddEvent(allocator, a1, b1);
+  AddEvent(allocator, b2, a2);
+  AddEvent(allocator, a3, b3);
+
+  EXPECT_EQ(allocator.OptimizeByVectorClock(), SUCCESS);
+  EXPECT_EQ(allocator.GetValidEventNum(), 3);
+}
+
+///
+/// Stream0    Stream1
+///   a1 -e0->   b1
+///   a2 <-e1-   b1
+///   a2 -e2->   b1    (loop back edge, a2 runs after b1, kept)
+///   a1 -e3->   b2    (covered by e0)
+///
+TEST_F(UtestStreamAllocator, keep_loop_back_event) {
+  ut::GraphBuilder builder("graph");
+  NodePtr a1 = AddStreamNode(builder, "a1", 0);
+  NodePtr b1 = AddStreamNode(builder, "b1", 1);
+  NodePtr a2 = AddStreamNode(builder, "a2", 0);
+  NodePtr b2 = AddStreamNode(builder, "b2", 1);
+  std::vector<SubGraphInfoPtr> subgraphs;
+  StreamAllocator allocator(builder.GetGraph(), subgraphs);
+  allocator.stream_num_ = 2;
+  AddEvent(allocator, a1, b1);
+  AddEvent(allocator, b1, a2);
+  AddEvent(allocator, a2, b1);
+  AddEvent(allocator, a1, b2);
+
+  EXPECT_EQ(allocator.OptimizeByVectorClock(), SUCCESS);
+  EXPECT_TRUE(HasEvent(allocator, 0));
+  EXPECT_TRUE(HasEvent(allocator, 1));
+  EXPECT_TRUE(HasEvent(allocator, 2));
+  EXPECT_FALSE(HasEvent(allocator, 3));
+}
+
+TEST_F(UtestStreamAllocator, invalid_stream_id) {
+  ut::GraphBuilder builder("graph");
+  NodePtr a = AddStreamNode(builder, "a", 0);
+  NodePtr b = AddStreamNode(builder, "b", 5);
+  std::vector<SubGraphInfoPtr> subgraphs;
+  StreamAllocator allocator(builder.GetGraph(), subgraphs);
+  allocator.stream_num_ = 2;
+  AddEvent(allocator, a, b);
+  EXPECT_EQ(allocator.OptimizeByVectorClock(), FAILED);
+}
+}  // namespace ge
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/opskernel/ops_kernel_info_store.h"
+#include "common/types.h"
+#include "external/ge/ge_api_types.h"
+#include "graph/compute_graph.h"
+#include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
+#include "graph/passes/graph_builder_utils.h"
+
+#define protected public
+#define private public
+#include "graph/build/task_generator.h"
+#undef protected
+#undef private
+
+namespace ge {
+namespace {
+const char *const kSessionTagOption = "ge.test.sessionTag";
+
+// Generates one task per node, stream id of task is set to the node id, and task type is set to 1
+// when the session tag of the caller's thread local context is seen
+class FakeOpsKernelInfoStore : public OpsKernelInfoStore {
+ public:
+  Status Initialize(const map<string, string> &options) override { return SUCCESS; }
+  Status Finalize() override { return SUCCESS; }
+  void GetAllOpsKernelInfo(map<string, OpInfo> &infos) const override {}
+  bool CheckSupported(const OpDescPtr &op_desc, std::string &un_supported_reason) const override { return true; }
+  Status CalcOpRunningParam(Node &node) override { return SUCCESS; }
+  Status GenerateTask(const Node &node, RunContext &context, std::vector<domi::TaskDef> &tasks) override {
+    std::string session_tag;
+    (void)GetContext().GetOption(kSessionTagOption, session_tag);
+    domi::TaskDef task;
+    task.set_stream_id(static_cast<uint32_t>(node.GetOpDesc()->GetId()));
+    task.set_type(session_tag == "tag" ? 1 : 0);
+    tasks.emplace_back(task);
+    return SUCCESS;
+  }
+};
+
+void SetTaskGenOptions(const std::string &thread_safe_libs) {
+  std::map<std::string, std::string> options = {{TASK_GEN_THREAD_SAFE_LIBS, thread_safe_libs},
+                                                {kSessionTagOption, "tag"}};
+  GetThreadLocalContext().SetGraphOption(options);
+}
+
+std::vector<TaskGenJob> BuildJobs(const std::vector<std::string> &lib_names) {
+  ut::GraphBuilder builder("g");
+  std::vector<TaskGenJob> jobs;
+  auto store = std::make_shared<FakeOpsKernelInfoStore>();
+  for (size_t i = 0; i < lib_names.size(); ++i) {
+    auto node = builder.AddNode("node" + std::to_string(i), RELU, 1, 1);
+    node->GetOpDesc()->SetId(static_cast<int64_t>(i));
+    TaskGenJob job;
+    job.node = node;
+    job.kernel_info_store = store;
+    job.op_kernel_lib_name = lib_names[i];
+    job.node_index = static_cast<uint32_t>(i);
+    jobs.emplace_back(std::move(job));
+  }
+  return jobs;
+}
+}  // namespace
+
+class UtestTaskGenerator : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() { SetTaskGenOptions(""); }
+};
+
+TEST_F(UtestTaskGenerator, generate_task_in_parallel_for_thread_safe_libs) {
+  SetTaskGenOptions("LibA,LibC");
+  std::vector<TaskGenJob> jobs = BuildJobs({"LibA", "LibB", "LibA", "LibC", "LibB", "LibA"});
+  RunContext run_context;
+  run_context.graphStreamList.emplace_back(nullptr);
+
+  TaskGenerator task_generator;
+  EXPECT_EQ(task_generator.GenerateTaskInParallel(run_context, 4, jobs), SUCCESS);
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (jobs[i].op_kernel_lib_name == "LibB") {
+      EXPECT_FALSE(jobs[i].generated);
+      EXPECT_TRUE(jobs[i].tasks.empty());
+      continue;
+    }
+    EXPECT_TRUE(jobs[i].generated);
+    ASSERT_EQ(jobs[i].tasks.size(), 1);
+    EXPECT_EQ(jobs[i].tasks[0].stream_id(), i);
+    // options of the caller are seen by the workers
+    EXPECT_EQ(jobs[i].tasks[0].type(), 1);
+  }
+}
+
+TEST_F(UtestTaskGenerator, no_thread_safe_libs_by_default) {
+  SetTaskGenOptions("");
+  std::vector<TaskGenJob> jobs = BuildJobs({"LibA", "LibB", "LibA", "LibB"});
+  RunContext run_context;
+  run_context.graphStreamList.emplace_back(nullptr);
+
+  TaskGenerator task_generator;
+  EXPECT_EQ(task_generator.GenerateTaskInParallel(run_context, 4, jobs), SUCCESS);
+  for (const auto &job : jobs) {
+    EXPECT_FALSE(job.generated);
+    EXPECT_TRUE(job.tasks.empty());
+  }
+}
+}  // namespace ge
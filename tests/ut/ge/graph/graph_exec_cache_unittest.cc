@@ -0,0 +1,209 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "passes/graph_builder_utils.h"
+
+#define private public
+#include "graph/manager/graph_exec_cache.h"
+#undef private
+
+namespace ge {
+class UtestGraphExecCache : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+ComputeGraphPtr BuildGraph() {
+  auto builder = ut::GraphBuilder("test");
+  auto data = builder.AddNode("data", "Data", 1, 1);
+  auto relu = builder.AddNode("relu", "Relu", 1, 1);
+  auto netoutput = builder.AddNode("netoutput", "NetOutput", 1, 0);
+  builder.AddDataEdge(data, 0, relu, 0);
+  builder.AddDataEdge(relu, 0, netoutput, 0);
+  return builder.GetGraph();
+}
+
+GeTensor MakeTensor(const std::vector<int64_t> &dims) {
+  GeTensorDesc desc(GeShape(dims), FORMAT_ND, DT_INT32);
+  std::vector<int32_t> values(GeShape(dims).GetShapeSize());
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int32_t>(i + 1);
+  }
+  return GeTensor(desc, reinterpret_cast<uint8_t *>(values.data()), values.size() * sizeof(int32_t));
+}
+
+const int32_t *GetValues(const GeTensor &tensor) {
+  return reinterpret_cast<const int32_t *>(tensor.GetData().GetData());
+}
+}  // namespace
+
+TEST_F(UtestGraphExecCache, bucket_shapes) {
+  ShapeBucketer bucketer;
+  EXPECT_NE(bucketer.Init("0:0:8,4"), SUCCESS);
+  EXPECT_NE(bucketer.Init("0:x:4"), SUCCESS);
+  ASSERT_EQ(bucketer.Init("0:0:1,4,8;0:1:16"), SUCCESS);
+
+  std::vector<std::vector<int64_t>> shapes;
+  bucketer.GetBucketShapes({MakeTensor({3, 10}), MakeTensor({3, 10})}, shapes);
+  EXPECT_EQ(shapes[0], std::vector<int64_t>({4, 16}));
+  EXPECT_EQ(shapes[1], std::vector<int64_t>({3, 10}));
+
+  // Dims over the largest boundary are kept.
+  bucketer.GetBucketShapes({MakeTensor({9, 16})}, shapes);
+  EXPECT_EQ(shapes[0], std::vector<int64_t>({9, 16}));
+
+  std::vector<std::vector<int64_t>> next_shapes;
+  EXPECT_TRUE(bucketer.GetNextBucketShapes({{4, 16}}, next_shapes));
+  EXPECT_EQ(next_shapes[0], std::vector<int64_t>({8, 16}));
+  EXPECT_FALSE(bucketer.GetNextBucketShapes({{8, 16}}, next_shapes));
+}
+
+TEST_F(UtestGraphExecCache, pad_and_slice) {
+  GeTensor src = MakeTensor({2, 3});
+  GeTensor padded;
+  ASSERT_EQ(ShapeBucketer::PadTensor(src, {4, 4}, padded), SUCCESS);
+  EXPECT_EQ(padded.GetTensorDesc().GetShape().GetDims(), std::vector<int64_t>({4, 4}));
+  const int32_t expect[] = {1, 2, 3, 0, 4, 5, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  ASSERT_EQ(padded.GetData().GetSize(), sizeof(expect));
+  EXPECT_EQ(memcmp(GetValues(padded), expect, sizeof(expect)), 0);
+  EXPECT_NE(ShapeBucketer::PadTensor(src, {1, 4}, padded), SUCCESS);
+
+  GeTensor sliced;
+  ASSERT_EQ(ShapeBucketer::SliceTensor(padded, {2, 3}, sliced), SUCCESS);
+  ASSERT_EQ(sliced.GetData().GetSize(), src.GetData().GetSize());
+  EXPECT_EQ(memcmp(GetValues(sliced), GetValues(src), src.GetData().GetSize()), 0);
+}
+
+TEST_F(UtestGraphExecCache, unpad_outputs_by_output_dims) {
+  GeTensor src = MakeTensor({2, 3});
+  GeTensor padded;
+  ASSERT_EQ(ShapeBucketer::PadTensor(src, {4, 4}, padded), SUCCESS);
+  auto compiler = [](const GraphNodePtr &, const std::vector<GeTensor> &, bool) { return SUCCESS; };
+  auto unloader = [](const GraphNodePtr &) {};
+
+  // Outputs of padded inputs are refused without output dims.
+  GraphExecCacheOptions options;
+  options.buckets = "0:0:4;0:1:4";
+  GraphExecCache no_dims_cache(1, options, compiler, unloader);
+  ASSERT_EQ(no_dims_cache.Init(BuildGraph(), {}), SUCCESS);
+  std::vector<GeTensor> outputs;
+  EXPECT_EQ(no_dims_cache.UnpadOutputs({src}, {padded}, {padded}, outputs), PARAM_INVALID);
+  // Outputs of inputs which are not padded are kept.
+  ASSERT_EQ(no_dims_cache.UnpadOutputs({src}, {src}, {src}, outputs), SUCCESS);
+  EXPECT_EQ(outputs[0].GetTensorDesc().GetShape().GetDims(), std::vector<int64_t>({2, 3}));
+
+  options.output_dims = "0:0:0:0;0:1:0:1;1:1:0:0";
+  GraphExecCache cache(1, options, compiler, unloader);
+  ASSERT_EQ(cache.Init(BuildGraph(), {}), SUCCESS);
+  // Dim 0 of output 2 equals a padded dim, but it does not follow any input.
+  ASSERT_EQ(cache.UnpadOutputs({src}, {padded}, {padded, MakeTensor({5, 4}), MakeTensor({4})}, outputs), SUCCESS);
+  ASSERT_EQ(outputs.size(), 3);
+  EXPECT_EQ(outputs[0].GetTensorDesc().GetShape().GetDims(), std::vector<int64_t>({2, 3}));
+  EXPECT_EQ(memcmp(GetValues(outputs[0]), GetValues(src), src.GetData().GetSize()), 0);
+  EXPECT_EQ(outputs[1].GetTensorDesc().GetShape().GetDims(), std::vector<int64_t>({5, 2}));
+  EXPECT_EQ(outputs[2].GetTensorDesc().GetShape().GetDims(), std::vector<int64_t>({4}));
+
+  // Output dim which does not match the padded input dim is refused.
+  EXPECT_EQ(cache.UnpadOutputs({src}, {padded}, {MakeTensor({3, 4})}, outputs), PARAM_INVALID);
+
+  options.output_dims = "0:0:x:0";
+  GraphExecCache invalid_cache(1, options, compiler, unloader);
+  EXPECT_EQ(invalid_cache.Init(BuildGraph(), {}), PARAM_INVALID);
+}
+
+TEST_F(UtestGraphExecCache, lru_evict) {
+  std::vector<std::vector<int64_t>> built_shapes;
+  uint32_t unload_count = 0;
+  auto compiler = [&built_shapes](const GraphNodePtr &node, const std::vector<GeTensor> &inputs,
+                                  bool is_precompile) -> Status {
+    EXPECT_FALSE(is_precompile);
+    built_shapes.push_back(inputs[0].GetTensorDesc().GetShape().GetDims());
+    auto ge_model = MakeShared<GeModel>();
+    (void)AttrUtils::SetInt(ge_model, ATTR_MODEL_MEMORY_SIZE, 100);
+    node->SetGeModel(ge_model);
+    return SUCCESS;
+  };
+  auto unloader = [&unload_count](const GraphNodePtr &node) { ++unload_count; };
+
+  GraphExecCacheOptions options;
+  options.buckets = "0:0:2,4,8";
+  options.mem_limit = 250;
+  GraphExecCache cache(1, options, compiler, unloader);
+  ASSERT_EQ(cache.Init(BuildGraph(), {}), SUCCESS);
+
+  std::vector<GeTensor> padded_inputs;
+  GraphNodePtr node_a = nullptr;
+  ASSERT_EQ(cache.Acquire({MakeTensor({1, 2})}, padded_inputs, node_a), SUCCESS);
+  EXPECT_EQ(padded_inputs[0].GetTensorDesc().GetShape().GetDims(), std::vector<int64_t>({2, 2}));
+  GraphNodePtr node = nullptr;
+  ASSERT_EQ(cache.Acquire({MakeTensor({2, 2})}, padded_inputs, node), SUCCESS);
+  EXPECT_EQ(node, node_a);
+  ASSERT_EQ(cache.Acquire({MakeTensor({3, 2})}, padded_inputs, node), SUCCESS);
+  // Bucket 2 is the least recently used one when bucket 8 is built.
+  ASSERT_EQ(cache.Acquire({MakeTensor({8, 2})}, padded_inputs, node), SUCCESS);
+
+  GraphExecCacheStats stats;
+  cache.GetStats(stats);
+  EXPECT_EQ(stats.hit_count, 1);
+  EXPECT_EQ(stats.miss_count, 3);
+  EXPECT_EQ(stats.evict_count, 1);
+  EXPECT_EQ(unload_count, 1);
+  EXPECT_EQ(built_shapes.size(), 3);
+  EXPECT_EQ(cache.entries_.count(cache.active_signature_), 1);
+
+  cache.Clear();
+  EXPECT_EQ(unload_count, 3);
+}
+
+TEST_F(UtestGraphExecCache, precompile_next_bucket) {
+  std::mutex mutex;
+  std::vector<std::vector<int64_t>> built_shapes;
+  std::vector<bool> precompiled;
+  auto compiler = [&](const GraphNodePtr &node, const std::vector<GeTensor> &inputs, bool is_precompile) -> Status {
+    std::lock_guard<std::mutex> lock(mutex);
+    built_shapes.push_back(inputs[0].GetTensorDesc().GetShape().GetDims());
+    precompiled.push_back(is_precompile);
+    return SUCCESS;
+  };
+  GraphExecCacheOptions options;
+  options.buckets = "0:0:2,4";
+  options.precompile = true;
+  GraphExecCache cache(1, options, compiler, [](const GraphNodePtr &) {});
+  ASSERT_EQ(cache.Init(BuildGraph(), {}), SUCCESS);
+
+  std::vector<GeTensor> padded_inputs;
+  GraphNodePtr node = nullptr;
+  ASSERT_EQ(cache.Acquire({MakeTensor({1, 2})}, padded_inputs, node), SUCCESS);
+  ASSERT_EQ(cache.Acquire({MakeTensor({3, 2})}, padded_inputs, node), SUCCESS);
+
+  GraphExecCacheStats stats;
+  cache.GetStats(stats);
+  EXPECT_EQ(stats.miss_count, 1);
+  EXPECT_EQ(stats.hit_count, 1);
+  EXPECT_EQ(stats.precompile_count, 1);
+  EXPECT_EQ(stats.precompile_hit_count, 1);
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(built_shapes.size(), 2);
+  EXPECT_EQ(built_shapes[1], std::vector<int64_t>({4, 2}));
+  EXPECT_EQ(precompiled, std::vector<bool>({false, true}));
+}
+}  // namespace ge
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#define private public
+#include "graph/execute/graph_execute.h"
+#include "graph/manager/host_mem_pool.h"
+#undef private
+
+namespace ge {
+class UtestHostMemPool : public testing::Test {
+ protected:
+  void SetUp() { HostMemPool::Instance().Release(); }
+  void TearDown() { HostMemPool::Instance().Release(); }
+};
+
+TEST_F(UtestHostMemPool, block_size) {
+  EXPECT_EQ(HostMemPool::GetBlockSize(0), 4096);
+  EXPECT_EQ(HostMemPool::GetBlockSize(4096), 4096);
+  EXPECT_EQ(HostMemPool::GetBlockSize(4097), 5120);
+  EXPECT_EQ(HostMemPool::GetBlockSize(8192), 8192);
+  EXPECT_EQ(HostMemPool::GetBlockSize(8193), 10240);
+  EXPECT_EQ(HostMemPool::GetBlockSize(1000000), 1048576);
+  EXPECT_EQ(HostMemPool::GetBlockSize(1048577), 1310720);
+}
+
+TEST_F(UtestHostMemPool, reuse_and_idle_limit) {
+  HostMemPoolStats stats;
+  HostMemPool::Instance().GetStats(stats);
+  uint64_t malloc_count = stats.malloc_count;
+  uint64_t free_count = stats.free_count;
+  {
+    HostBufferPtr buffer = HostMemPool::Instance().Malloc(5000);
+    ASSERT_NE(buffer, nullptr);
+    buffer.get()[4999] = 1;
+    HostMemPool::Instance().GetStats(stats);
+    EXPECT_EQ(stats.in_use_bytes, 5120);
+  }
+  HostMemPool::Instance().GetStats(stats);
+  EXPECT_EQ(stats.in_use_bytes, 0);
+  EXPECT_EQ(stats.idle_bytes, 5120);
+
+  // Same size class
+  HostBufferPtr buffer = HostMemPool::Instance().Malloc(5100);
+  HostBufferPtr other_buffer = HostMemPool::Instance().Malloc(5100);
+  HostMemPool::Instance().GetStats(stats);
+  EXPECT_EQ(stats.malloc_count - malloc_count, 2);
+  EXPECT_EQ(stats.reuse_count > 0, true);
+  EXPECT_EQ(stats.idle_bytes, 0);
+
+  HostMemPool::Instance().SetIdleLimit(6000);
+  buffer = nullptr;
+  other_buffer = nullptr;
+  HostMemPool::Instance().GetStats(stats);
+  EXPECT_EQ(stats.idle_bytes, 5120);
+  EXPECT_EQ(stats.free_count - free_count, 1);
+  HostMemPool::Instance().SetIdleLimit(256ULL * 1024 * 1024);
+}
+
+TEST_F(UtestHostMemPool, one_off_buffer_freed) {
+  HostMemPoolStats stats;
+  HostMemPool::Instance().GetStats(stats);
+  uint64_t free_count = stats.free_count;
+  HostBufferPtr buffer = HostMemPool::Instance().Malloc(5000, false);
+  ASSERT_NE(buffer, nullptr);
+  buffer = nullptr;
+  HostMemPool::Instance().GetStats(stats);
+  EXPECT_EQ(stats.in_use_bytes, 0);
+  EXPECT_EQ(stats.idle_bytes, 0);
+  EXPECT_EQ(stats.free_count - free_count, 1);
+}
+
+TEST_F(UtestHostMemPool, shared_by_graph_executors) {
+  std::vector<uint32_t> sizes = {1000, 70000};
+  std::vector<void *> addrs;
+  GraphExecutor executor;
+  EXPECT_EQ(executor.MallocInOutBuffer(sizes, addrs), SUCCESS);
+  EXPECT_EQ(addrs.size(), 2);
+  std::vector<void *> same_addrs;
+  EXPECT_EQ(executor.MallocInOutBuffer(sizes, same_addrs), SUCCESS);
+  EXPECT_EQ(same_addrs, addrs);
+  EXPECT_EQ(executor.FreeInOutBuffer(), SUCCESS);
+
+  HostMemPoolStats stats;
+  HostMemPool::Instance().GetStats(stats);
+  uint64_t malloc_count = stats.malloc_count;
+  // Executor of another graph takes the buffers back
+  GraphExecutor other_executor;
+  std::vector<void *> other_addrs;
+  EXPECT_EQ(other_executor.MallocInOutBuffer({900, 69000}, other_addrs), SUCCESS);
+  HostMemPool::Instance().GetStats(stats);
+  EXPECT_EQ(stats.malloc_count, malloc_count);
+  EXPECT_EQ(stats.in_use_bytes, 4096 + 81920);
+}
+}  // namespace ge
@@ -16,10 +16,14 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <limits>
+
 #define private public
 #define protected public
 #include "graph/load/new_model_manager/data_dumper.h"
 #include "graph/load/new_model_manager/davinci_model.h"
+#include "graph/load/new_model_manager/async_data_dumper.h"
 #undef private
 #undef protected
 
@@ -33,6 +37,26 @@ class UtestDataDumper : public testing::Test {
   void TearDown() {}
 };
 
+namespace {
+const char *const kAsyncDumpPath = "./async_dump_ut/";
+
+std::vector<AsyncDumpOp> BuildDumpOps(size_t op_num, std::vector<float> &dev_mem) {
+  dev_mem.assign(op_num * 16, 1.0f);
+  std::vector<AsyncDumpOp> ops(op_num);
+  for (size_t i = 0; i < op_num; ++i) {
+    ops[i].task.set_task_id(static_cast<uint32_t>(i));
+    ops[i].task.mutable_op()->set_op_name("scope_" + std::to_string(i % 2) + "/op_" + std::to_string(i));
+    ops[i].task.mutable_op()->set_op_type("Add");
+    aicpu::dump::Output *output = ops[i].task.add_output();
+    output->set_data_type(DT_FLOAT);
+    output->set_address(reinterpret_cast<uintptr_t>(&dev_mem[i * 16]));
+    ops[i].output_sizes.push_back(16 * sizeof(float));
+    ops[i].output_data_types.push_back(DT_FLOAT);
+  }
+  return ops;
+}
+}  // namespace
+
 std::vector<void *> stub_get_output_addrs(const RuntimeParam &model_param, ConstOpDescPtr op_desc) {
   std::vector<void *> res;
   res.emplace_back(reinterpret_cast<void *>(23333));
@@ -60,4 +84,91 @@ TEST_F(UtestDataDumper, UnloadDumpInfo_success) {
   Status ret = data_dumper.UnloadDumpInfo();
   EXPECT_EQ(ret, SUCCESS);
 }
+
+TEST_F(UtestDataDumper, AsyncDataDumper_sample_and_filter) {
+  std::vector<float> dev_mem;
+  AsyncDumpOptions options;
+  options.enable = true;
+  options.step_interval = 3;
+  options.op_filters = {"scope_0/", "scope_1/op_1"};
+  options.buffer_num = 4;
+  AsyncDataDumper dumper;
+  EXPECT_EQ(dumper.Init(kAsyncDumpPath, options, BuildDumpOps(6, dev_mem)), SUCCESS);
+  ASSERT_TRUE(dumper.IsInited());
+  // op_0, op_2 and op_4 in scope_0, and op_1
+  EXPECT_EQ(dumper.ops_.size(), 4);
+
+  for (uint64_t iteration = 0; iteration < 9; ++iteration) {
+    EXPECT_EQ(dumper.DumpIteration(iteration, nullptr), SUCCESS);
+  }
+  dumper.Finalize();
+  AsyncDumpStats stats;
+  dumper.GetStats(stats);
+  EXPECT_EQ(stats.sampled_count + stats.dropped_count, 3);
+  EXPECT_EQ(stats.written_count, stats.sampled_count);
+  EXPECT_EQ(stats.written_bytes, stats.written_count * 4 * 16 * sizeof(float));
+  EXPECT_FALSE(dumper.IsInited());
+  EXPECT_EQ(dumper.DumpIteration(9, nullptr), SUCCESS);
+}
+
+TEST_F(UtestDataDumper, AsyncDataDumper_nan_inf_only) {
+  std::vector<float> data(16, 1.0f);
+  const uint8_t *addr = reinterpret_cast<const uint8_t *>(data.data());
+  EXPECT_FALSE(AsyncDataDumper::HasNanOrInf(DT_FLOAT, addr, data.size() * sizeof(float)));
+  data[7] = std::numeric_limits<float>::infinity();
+  EXPECT_TRUE(AsyncDataDumper::HasNanOrInf(DT_FLOAT, addr, data.size() * sizeof(float)));
+  data[7] = std::nanf("");
+  EXPECT_TRUE(AsyncDataDumper::HasNanOrInf(DT_FLOAT, addr, data.size() * sizeof(float)));
+  EXPECT_FALSE(AsyncDataDumper::HasNanOrInf(DT_INT32, addr, data.size() * sizeof(float)));
+  // fp16 1.0, inf and nan
+  std::vector<uint16_t> fp16_data = {0x3C00, 0x3C00};
+  const uint8_t *fp16_addr = reinterpret_cast<const uint8_t *>(fp16_data.data());
+  EXPECT_FALSE(AsyncDataDumper::HasNanOrInf(DT_FLOAT16, fp16_addr, fp16_data.size() * sizeof(uint16_t)));
+  fp16_data[1] = 0x7C00;
+  EXPECT_TRUE(AsyncDataDumper::HasNanOrInf(DT_FLOAT16, fp16_addr, fp16_data.size() * sizeof(uint16_t)));
+  fp16_data[1] = 0xFE00;
+  EXPECT_TRUE(AsyncDataDumper::HasNanOrInf(DT_FLOAT16, fp16_addr, fp16_data.size() * sizeof(uint16_t)));
+
+  // copies are not done by stub runtime, so host buffers are filled here
+  std::vector<float> dev_mem;
+  AsyncDumpOptions options;
+  options.enable = true;
+  options.nan_inf_only = true;
+  options.buffer_num = 1;
+  AsyncDataDumper dumper;
+  EXPECT_EQ(dumper.Init(kAsyncDumpPath, options, BuildDumpOps(2, dev_mem)), SUCCESS);
+  ASSERT_TRUE(dumper.IsInited());
+  {
+    std::unique_lock<std::mutex> lock(dumper.mutex_);
+    dumper.is_stopped_ = true;
+  }
+  dumper.cond_.notify_all();
+  dumper.thread_.join();
+  auto &buffer = dumper.buffers_[0];
+  std::vector<float> host_data(32, 1.0f);
+  (void)memcpy(buffer.host_addr, host_data.data(), 16 * sizeof(float));
+  (void)memcpy(buffer.host_addr + dumper.offsets_[1][0], host_data.data(), 16 * sizeof(float));
+  bool is_skipped = false;
+  EXPECT_EQ(dumper.WriteBuffer(buffer, is_skipped), SUCCESS);
+  EXPECT_TRUE(is_skipped);
+  host_data[3] = std::nanf("");
+  (void)memcpy(buffer.host_addr + dumper.offsets_[1][0], host_data.data(), 16 * sizeof(float));
+  is_skipped = false;
+  EXPECT_EQ(dumper.WriteBuffer(buffer, is_skipped), SUCCESS);
+  EXPECT_FALSE(is_skipped);
+
+  // written as an op dump of host, with output data
+  dump::OpDump op_dump;
+  dumper.FillOpDump(1, buffer, op_dump);
+  std::string proto_str;
+  ASSERT_TRUE(op_dump.SerializeToString(&proto_str));
+  op_dump.Clear();
+  ASSERT_TRUE(op_dump.ParseFromString(proto_str));
+  EXPECT_EQ(op_dump.op_name(), "scope_1/op_1");
+  EXPECT_EQ(op_dump.iteration(), buffer.iteration);
+  ASSERT_EQ(op_dump.output_size(), 1);
+  EXPECT_EQ(op_dump.output(0).data_type(), DT_FLOAT);
+  ASSERT_EQ(op_dump.output(0).data().size(), 16 * sizeof(float));
+  EXPECT_TRUE(std::isnan(reinterpret_cast<const float *>(op_dump.output(0).data().data())[3]));
+}
 }  // namespace ge
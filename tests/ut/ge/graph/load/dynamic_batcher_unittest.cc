@@ -0,0 +1,248 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "graph/load/new_model_manager/dynamic_batcher.h"
+
+namespace ge {
+namespace {
+const uint32_t kSampleSize = 16;
+
+// Counts finished requests and waits for them.
+class RequestWaiter {
+ public:
+  DynamicBatcher::DoneCallback Callback() {
+    return [this](Status status) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      statuses_.push_back(status);
+      cond_.notify_all();
+    };
+  }
+
+  bool Wait(size_t count, int64_t timeout_ms = 5000) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return statuses_.size() >= count; });
+  }
+
+  std::vector<Status> Statuses() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statuses_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<Status> statuses_;
+};
+
+// Records the batches it runs, and takes base_us + per_sample_us * batch_size to run one.
+struct FakeModel {
+  FakeModel(int64_t base_us = 0, int64_t per_sample_us = 0) : base_us(base_us), per_sample_us(per_sample_us) {}
+
+  DynamicBatcher::Dispatcher Dispatcher() {
+    return [this](const InputData &input_data, OutputData &output_data) -> Status {
+      uint32_t batch_size = input_data.blobs[0].length / kSampleSize;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch_sizes.push_back(batch_size);
+        input_blobs.push_back(input_data.blobs);
+      }
+      if (base_us + per_sample_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(base_us + per_sample_us * batch_size));
+      }
+      return SUCCESS;
+    };
+  }
+
+  int64_t base_us;
+  int64_t per_sample_us;
+  std::mutex mutex;
+  std::vector<uint32_t> batch_sizes;
+  std::vector<std::vector<DataBuffer>> input_blobs;
+};
+}  // namespace
+
+class UtestDynamicBatcher : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestDynamicBatcher, coalesce_to_best_fit_batch_size) {
+  FakeModel model;
+  DynamicBatchOptions options;
+  options.batch_sizes = {8, 1, 4, 2};
+  options.max_delay_us = 20000;
+  DynamicBatcher batcher(1, options, model.Dispatcher());
+  ASSERT_EQ(batcher.Init(), SUCCESS);
+
+  std::vector<std::vector<uint8_t>> inputs(3, std::vector<uint8_t>(kSampleSize));
+  std::vector<std::vector<uint8_t>> outputs(3, std::vector<uint8_t>(kSampleSize));
+  RequestWaiter waiter;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(batcher.Submit({DataBuffer(inputs[i].data(), kSampleSize, false)},
+                             {DataBuffer(outputs[i].data(), kSampleSize, false)}, waiter.Callback()),
+              SUCCESS);
+  }
+  ASSERT_TRUE(waiter.Wait(3));
+  batcher.Finalize();
+
+  ASSERT_EQ(model.batch_sizes.size(), 1);
+  EXPECT_EQ(model.batch_sizes[0], 4);
+  // Batch shape input is appended after the inputs.
+  EXPECT_EQ(model.input_blobs[0].size(), 2);
+  EXPECT_EQ(model.input_blobs[0][1].length, sizeof(int64_t));
+  for (Status status : waiter.Statuses()) {
+    EXPECT_EQ(status, SUCCESS);
+  }
+
+  DynamicBatchStats stats;
+  batcher.GetStats(stats);
+  EXPECT_EQ(stats.request_count, 3);
+  EXPECT_EQ(stats.batch_count, 1);
+  EXPECT_EQ(stats.padded_count, 1);
+  EXPECT_EQ(stats.zero_copy_count, 0);
+}
+
+TEST_F(UtestDynamicBatcher, full_batch_dispatched_before_deadline) {
+  FakeModel model;
+  DynamicBatchOptions options;
+  options.batch_sizes = {2, 4};
+  options.max_delay_us = 60 * 1000 * 1000;
+  DynamicBatcher batcher(1, options, model.Dispatcher());
+  ASSERT_EQ(batcher.Init(), SUCCESS);
+
+  std::vector<uint8_t> input(kSampleSize * 4);
+  std::vector<uint8_t> output(kSampleSize * 4);
+  RequestWaiter waiter;
+  for (size_t i = 0; i < 4; ++i) {
+    // Outputs are not contiguous, so the batch is gathered.
+    size_t output_offset = (3 - i) * kSampleSize;
+    EXPECT_EQ(batcher.Submit({DataBuffer(input.data() + i * kSampleSize, kSampleSize, false)},
+                             {DataBuffer(output.data() + output_offset, kSampleSize, false)}, waiter.Callback()),
+              SUCCESS);
+  }
+  ASSERT_TRUE(waiter.Wait(4));
+  batcher.Finalize();
+
+  ASSERT_EQ(model.batch_sizes.size(), 1);
+  EXPECT_EQ(model.batch_sizes[0], 4);
+  EXPECT_NE(model.input_blobs[0][0].data, input.data());
+}
+
+TEST_F(UtestDynamicBatcher, contiguous_requests_zero_copy) {
+  FakeModel model;
+  DynamicBatchOptions options;
+  options.batch_sizes = {2};
+  options.has_batch_shape_input = false;
+  DynamicBatcher batcher(1, options, model.Dispatcher());
+  ASSERT_EQ(batcher.Init(), SUCCESS);
+
+  std::vector<uint8_t> input(kSampleSize * 2);
+  std::vector<uint8_t> output(kSampleSize * 2);
+  RequestWaiter waiter;
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(batcher.Submit({DataBuffer(input.data() + i * kSampleSize, kSampleSize, false)},
+                             {DataBuffer(output.data() + i * kSampleSize, kSampleSize, false)}, waiter.Callback()),
+              SUCCESS);
+  }
+  ASSERT_TRUE(waiter.Wait(2));
+  batcher.Finalize();
+
+  ASSERT_EQ(model.input_blobs.size(), 1);
+  EXPECT_EQ(model.input_blobs[0].size(), 1);
+  EXPECT_EQ(model.input_blobs[0][0].data, input.data());
+  DynamicBatchStats stats;
+  batcher.GetStats(stats);
+  EXPECT_EQ(stats.zero_copy_count, 1);
+}
+
+TEST_F(UtestDynamicBatcher, invalid_requests_and_finalize) {
+  FakeModel model;
+  DynamicBatchOptions options;
+  EXPECT_EQ(DynamicBatcher(1, options, model.Dispatcher()).Init(), PARAM_INVALID);
+
+  options.batch_sizes = {4};
+  options.max_delay_us = 60 * 1000 * 1000;
+  DynamicBatcher batcher(1, options, model.Dispatcher());
+  ASSERT_EQ(batcher.Init(), SUCCESS);
+
+  std::vector<uint8_t> buffer(kSampleSize * 2);
+  RequestWaiter waiter;
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize, false)}, {}, waiter.Callback()), SUCCESS);
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize * 2, false)}, {}, waiter.Callback()),
+            PARAM_INVALID);
+  EXPECT_EQ(batcher.Submit({}, {}, waiter.Callback()), PARAM_INVALID);
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize, false)}, {}, nullptr), PARAM_INVALID);
+
+  // The queued request fails as batcher stops.
+  batcher.Finalize();
+  ASSERT_TRUE(waiter.Wait(1));
+  EXPECT_EQ(waiter.Statuses()[0], FAILED);
+  EXPECT_TRUE(model.batch_sizes.empty());
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize, false)}, {}, waiter.Callback()), FAILED);
+}
+
+TEST_F(UtestDynamicBatcher, too_large_batch_rejected) {
+  FakeModel model;
+  DynamicBatchOptions options;
+  options.batch_sizes = {1, 2};
+  DynamicBatcher batcher(1, options, model.Dispatcher());
+  ASSERT_EQ(batcher.Init(), SUCCESS);
+
+  // Batch of 2 samples overflows uint32 length, the data is never accessed.
+  std::vector<uint8_t> buffer(kSampleSize);
+  uint32_t sample_len = 0x80000000U;
+  RequestWaiter waiter;
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), sample_len, false)}, {}, waiter.Callback()), PARAM_INVALID);
+  EXPECT_EQ(batcher.Submit({}, {DataBuffer(buffer.data(), sample_len, false)}, waiter.Callback()), PARAM_INVALID);
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize, false)}, {}, waiter.Callback()), SUCCESS);
+  ASSERT_TRUE(waiter.Wait(1));
+  batcher.Finalize();
+}
+
+TEST_F(UtestDynamicBatcher, finalize_in_callback_rejected) {
+  FakeModel model;
+  DynamicBatchOptions options;
+  options.batch_sizes = {1};
+  DynamicBatcher batcher(1, options, model.Dispatcher());
+  ASSERT_EQ(batcher.Init(), SUCCESS);
+  EXPECT_FALSE(batcher.IsDispatchThread());
+
+  std::vector<uint8_t> buffer(kSampleSize);
+  RequestWaiter waiter;
+  bool is_dispatch_thread = false;
+  auto done = [&batcher, &waiter, &is_dispatch_thread](Status status) {
+    is_dispatch_thread = batcher.IsDispatchThread();
+    // Returns without joining the thread itself.
+    batcher.Finalize();
+    waiter.Callback()(status);
+  };
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize, false)}, {}, done), SUCCESS);
+  ASSERT_TRUE(waiter.Wait(1));
+  EXPECT_TRUE(is_dispatch_thread);
+  EXPECT_EQ(batcher.Submit({DataBuffer(buffer.data(), kSampleSize, false)}, {}, waiter.Callback()), SUCCESS);
+  ASSERT_TRUE(waiter.Wait(2));
+  batcher.Finalize();
+}
+}  // namespace ge
@@ -27,6 +27,7 @@
 #define protected public
 #include "graph/load/new_model_manager/model_manager.h"
 
+#include "common/helper/model_helper.h"
 #include "common/helper/om_file_helper.h"
 #include "common/op/ge_op_utils.h"
 #include "graph/load/graph_loader.h"
@@ -95,6 +96,30 @@ class UtestModelManagerModelManager : public testing::Test {
     header->length = 10;  // encrypt_len;
   }
 
+  // Serializes a model without tasks, which needs feature map and weight memory
+  void GenGroupModelData(std::vector<uint8_t> &om_buffer, ge::ModelData &data) {
+    auto ge_model = ge::MakeShared<ge::GeModel>();
+    ge_model->SetName("group_model");
+    auto compute_graph = std::make_shared<ge::ComputeGraph>("graph");
+    ge_model->SetGraph(ge::GraphUtils::CreateGraphFromComputeGraph(compute_graph));
+    ge::AttrUtils::SetInt(ge_model.get(), ge::ATTR_MODEL_MEMORY_SIZE, 1024);
+    ge::AttrUtils::SetInt(ge_model.get(), ge::ATTR_MODEL_WEIGHT_SIZE, 512);
+    ge::AttrUtils::SetInt(ge_model.get(), ge::ATTR_MODEL_STREAM_NUM, 1);
+    ge::AttrUtils::SetInt(ge_model.get(), ge::ATTR_MODEL_EVENT_NUM, 0);
+    std::vector<uint8_t> weight(512, 0);
+    ge_model->SetWeight(ge::Buffer::CopyFrom(weight.data(), weight.size()));
+    auto model_task_def = ge::MakeShared<domi::ModelTaskDef>();
+    model_task_def->set_memory_size(1024);
+    model_task_def->set_weight_size(512);
+    model_task_def->set_stream_num(1);
+    ge_model->SetModelTaskDef(model_task_def);
+
+    ge::ModelHelper model_helper;
+    ASSERT_EQ(model_helper.SaveToOmBuffer(ge_model, om_buffer), ge::SUCCESS);
+    data.model_data = om_buffer.data();
+    data.model_len = static_cast<uint32_t>(om_buffer.size());
+  }
+
   void LoadStandardModelData(ge::ModelData &data) {
     static const std::string STANDARD_MODEL_DATA_PATH =
         "llt/framework/domi/ut/ome/test/data/standard_partition_model.txt";
@@ -441,4 +466,68 @@ TEST_F(UtestModelManagerModelManager, destroy_aicpu_session) {
   manager.DestroyAicpuSession(0);
 }
 
+TEST_F(UtestModelManagerModelManager, load_model_group_invalid_param) {
+  ModelManager manager;
+  uint32_t group_id = 0;
+  std::vector<uint32_t> model_ids;
+  EXPECT_EQ(ge::PARAM_INVALID, manager.LoadModelGroup(group_id, {}, 0, model_ids));
+
+  ge::ModelData data;
+  GenUnencryptModelData(data);
+  EXPECT_NE(ge::SUCCESS, manager.LoadModelGroup(group_id, {data}, 0, model_ids));
+  EXPECT_TRUE(model_ids.empty());
+  EXPECT_TRUE(manager.model_groups_.empty());
+  delete[](uint8_t *) data.model_data;
+
+  ModelGroupInfo info;
+  EXPECT_EQ(ge::PARAM_INVALID, manager.GetModelGroupInfo(1, info));
+  EXPECT_EQ(ge::PARAM_INVALID, manager.UnloadModelGroup(1));
+}
+
+TEST_F(UtestModelManagerModelManager, load_model_group_and_execute) {
+  std::vector<uint8_t> first_buffer;
+  std::vector<uint8_t> second_buffer;
+  ge::ModelData first_data;
+  ge::ModelData second_data;
+  GenGroupModelData(first_buffer, first_data);
+  GenGroupModelData(second_buffer, second_data);
+
+  ModelManager manager;
+  uint32_t group_id = 0;
+  std::vector<uint32_t> model_ids;
+  ASSERT_EQ(ge::SUCCESS, manager.LoadModelGroup(group_id, {first_data, second_data}, 0, model_ids));
+  ASSERT_EQ(model_ids.size(), 2);
+
+  ModelGroupInfo info;
+  EXPECT_EQ(ge::SUCCESS, manager.GetModelGroupInfo(group_id, info));
+  EXPECT_EQ(info.model_num, 2);
+  EXPECT_EQ(info.feature_map_size, 1024);
+  EXPECT_GT(info.saved_size, 0);
+
+  // Executed on the inner stream of each model, which the group waits for before running the next one
+  InputData input_data;
+  OutputData output_data;
+  for (uint32_t model_id : model_ids) {
+    EXPECT_EQ(ge::SUCCESS, manager.ExecuteModel(model_id, nullptr, false, input_data, output_data));
+    auto davinci_model = manager.GetModel(model_id);
+    ASSERT_NE(davinci_model, nullptr);
+    EXPECT_NE(davinci_model->GetRtModelStream(), nullptr);
+  }
+  EXPECT_EQ(ge::SUCCESS, manager.GetModelGroupInfo(group_id, info));
+  EXPECT_EQ(info.run_count, 2);
+
+  EXPECT_EQ(ge::SUCCESS, manager.UnloadModelGroup(group_id));
+  EXPECT_TRUE(manager.model_groups_.empty());
+  EXPECT_TRUE(manager.grouped_models_.empty());
+  EXPECT_EQ(manager.GetModel(model_ids[0]), nullptr);
+}
+
+TEST_F(UtestModelManagerModelManager, grouped_model_unloaded_with_group) {
+  ModelManager manager;
+  manager.model_map_[3] = nullptr;
+  manager.grouped_models_[3] = 1;
+  EXPECT_EQ(ge::PARAM_INVALID, manager.Unload(3));
+  EXPECT_EQ(manager.model_map_.count(3), 1);
+}
+
 }  // namespace ge
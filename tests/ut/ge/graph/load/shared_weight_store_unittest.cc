@@ -0,0 +1,136 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#define protected public
+#define private public
+#include "graph/load/new_model_manager/shared_weight_store.h"
+#include "graph/manager/graph_mem_allocator.h"
+#undef protected
+#undef private
+
+namespace ge {
+class UtestSharedWeightStore : public testing::Test {
+ protected:
+  void SetUp() {
+    MemManager::Instance().Initialize(std::vector<rtMemType_t>({RT_MEMORY_HBM}));
+    SharedWeightStore::GetInstance().weights_.clear();
+  }
+
+  void TearDown() { SharedWeightStore::GetInstance().weights_.clear(); }
+};
+
+TEST_F(UtestSharedWeightStore, share_same_weights) {
+  SharedWeightStore &weight_store = SharedWeightStore::GetInstance();
+  uint64_t dedup_bytes = weight_store.GetDedupBytes();
+
+  std::vector<uint8_t> weights1(64, 1);
+  std::vector<uint8_t> weights2(64, 1);
+  std::vector<uint8_t> weights3(64, 2);
+  ContentDigest digest1 = ContentHash::Digest(weights1.data(), weights1.size());
+  ContentDigest digest2 = ContentHash::Digest(weights2.data(), weights2.size());
+  ContentDigest digest3 = ContentHash::Digest(weights3.data(), weights3.size());
+
+  uint8_t *addr1 = nullptr;
+  uint8_t *addr2 = nullptr;
+  uint8_t *addr3 = nullptr;
+  EXPECT_EQ(weight_store.Acquire(0, digest1, weights1.data(), addr1), SUCCESS);
+  EXPECT_EQ(weight_store.Acquire(0, digest2, weights2.data(), addr2), SUCCESS);
+  EXPECT_EQ(weight_store.Acquire(0, digest3, weights3.data(), addr3), SUCCESS);
+  EXPECT_NE(addr1, nullptr);
+  EXPECT_EQ(addr1, addr2);
+  EXPECT_NE(addr1, addr3);
+  EXPECT_EQ(weight_store.GetDedupBytes(), dedup_bytes + 64);
+  EXPECT_EQ(weight_store.weights_[0].size(), 2);
+  EXPECT_EQ(weight_store.weights_[0][digest1].ref_count, 2);
+
+  EXPECT_EQ(weight_store.Release(0, digest1), SUCCESS);
+  EXPECT_EQ(weight_store.weights_[0][digest1].ref_count, 1);
+  EXPECT_EQ(weight_store.Release(0, digest2), SUCCESS);
+  EXPECT_EQ(weight_store.Release(0, digest3), SUCCESS);
+  EXPECT_TRUE(weight_store.weights_.empty());
+  EXPECT_NE(weight_store.Release(0, digest1), SUCCESS);
+}
+
+TEST_F(UtestSharedWeightStore, not_share_across_devices) {
+  SharedWeightStore &weight_store = SharedWeightStore::GetInstance();
+  std::vector<uint8_t> weights(32, 3);
+  ContentDigest digest = ContentHash::Digest(weights.data(), weights.size());
+
+  uint8_t *addr0 = nullptr;
+  uint8_t *addr1 = nullptr;
+  EXPECT_EQ(weight_store.Acquire(0, digest, weights.data(), addr0), SUCCESS);
+  EXPECT_EQ(weight_store.Acquire(1, digest, weights.data(), addr1), SUCCESS);
+  EXPECT_NE(addr0, addr1);
+  EXPECT_EQ(weight_store.weights_.size(), 2);
+
+  EXPECT_EQ(weight_store.Release(0, digest), SUCCESS);
+  EXPECT_EQ(weight_store.Release(1, digest), SUCCESS);
+  EXPECT_TRUE(weight_store.weights_.empty());
+}
+
+TEST_F(UtestSharedWeightStore, not_share_different_weights_of_same_digest) {
+  SharedWeightStore &weight_store = SharedWeightStore::GetInstance();
+  uint64_t dedup_bytes = weight_store.GetDedupBytes();
+  std::vector<uint8_t> weights1(64, 1);
+  std::vector<uint8_t> weights2(64, 2);
+  ContentDigest digest = ContentHash::Digest(weights1.data(), weights1.size());
+
+  uint8_t *addr1 = nullptr;
+  uint8_t *addr2 = nullptr;
+  EXPECT_EQ(weight_store.Acquire(0, digest, weights1.data(), addr1), SUCCESS);
+  EXPECT_EQ(weight_store.Acquire(0, digest, weights2.data(), addr2), SUCCESS);
+  EXPECT_NE(addr1, nullptr);
+  EXPECT_EQ(addr2, nullptr);
+  EXPECT_EQ(weight_store.weights_[0][digest].ref_count, 1);
+  EXPECT_EQ(weight_store.GetDedupBytes(), dedup_bytes);
+
+  EXPECT_EQ(weight_store.Release(0, digest), SUCCESS);
+  EXPECT_TRUE(weight_store.weights_.empty());
+}
+
+TEST_F(UtestSharedWeightStore, share_weights_acquired_concurrently) {
+  SharedWeightStore &weight_store = SharedWeightStore::GetInstance();
+  const size_t thread_num = 8;
+  std::vector<uint8_t> weights(128, 5);
+  ContentDigest digest = ContentHash::Digest(weights.data(), weights.size());
+
+  std::vector<uint8_t *> addrs(thread_num, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&, i]() { (void)weight_store.Acquire(0, digest, weights.data(), addrs[i]); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_NE(addrs[0], nullptr);
+  for (uint8_t *addr : addrs) {
+    EXPECT_EQ(addr, addrs[0]);
+  }
+  EXPECT_EQ(weight_store.weights_[0].size(), 1);
+  EXPECT_EQ(weight_store.weights_[0][digest].ref_count, thread_num);
+
+  for (size_t i = 0; i < thread_num; ++i) {
+    EXPECT_EQ(weight_store.Release(0, digest), SUCCESS);
+  }
+  EXPECT_TRUE(weight_store.weights_.empty());
+}
+}  // namespace ge
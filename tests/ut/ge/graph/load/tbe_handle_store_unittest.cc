@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #define protected public
 #define private public
 #include "graph/load/new_model_manager/tbe_handle_store.h"
@@ -24,17 +28,34 @@
 #undef private
 
 namespace ge {
-class UtestTBEHandleStore : public testing::Test {
- protected:
-  void SetUp() {
-    TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
-    kernel_store.kernels_.clear();
+namespace {
+void ClearKernels() {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  for (auto &shard : kernel_store.shards_) {
+    shard.kernels = std::make_shared<const TBEHandleStore::HandleMap>();
   }
+}
 
-  void TearDown() {
-    TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
-    kernel_store.kernels_.clear();
+size_t GetKernelNum() {
+  size_t kernel_num = 0;
+  for (const auto &shard : TBEHandleStore::GetInstance().shards_) {
+    kernel_num += shard.kernels->size();
   }
+  return kernel_num;
+}
+
+std::shared_ptr<TbeHandleInfo> GetKernel(const std::string &name) {
+  const auto &kernels = *TBEHandleStore::GetInstance().GetShard(name).kernels;
+  auto it = kernels.find(name);
+  return (it == kernels.end()) ? nullptr : it->second;
+}
+}  // namespace
+
+class UtestTBEHandleStore : public testing::Test {
+ protected:
+  void SetUp() { ClearKernels(); }
+
+  void TearDown() { ClearKernels(); }
 };
 
 TEST_F(UtestTBEHandleStore, test_store_tbe_handle) {
@@ -51,72 +72,155 @@ TEST_F(UtestTBEHandleStore, test_store_tbe_handle) {
   void *tbe_handle1 = (void *)0x12345678;
   std::shared_ptr<OpKernelBin> tbe_kernel = std::shared_ptr<OpKernelBin>();
   kernel_store.StoreTBEHandle(tbe_name1, tbe_handle1, tbe_kernel);
-  EXPECT_EQ(kernel_store.kernels_.size(), 1);
+  EXPECT_EQ(GetKernelNum(), 1);
 
   EXPECT_TRUE(kernel_store.FindTBEHandle(tbe_name1, handle));
   EXPECT_EQ(handle, tbe_handle1);
 
-  auto it = kernel_store.kernels_.find(tbe_name1);
-  EXPECT_NE(it, kernel_store.kernels_.end());
-  TbeHandleInfo &info1 = it->second;
-  EXPECT_EQ(info1.handle(), tbe_handle1);
-  EXPECT_EQ(info1.used_num(), 1);
+  auto info1 = GetKernel(tbe_name1);
+  ASSERT_NE(info1, nullptr);
+  EXPECT_EQ(info1->handle(), tbe_handle1);
+  EXPECT_EQ(info1->used_num(), 1);
 
   // store second, size is 1, num is 2.
   kernel_store.StoreTBEHandle(tbe_name1, tbe_handle1, tbe_kernel);
-  EXPECT_EQ(kernel_store.kernels_.size(), 1);
+  EXPECT_EQ(GetKernelNum(), 1);
 
   EXPECT_TRUE(kernel_store.FindTBEHandle(tbe_name1, handle));
   EXPECT_EQ(handle, tbe_handle1);
 
-  it = kernel_store.kernels_.find(tbe_name1);
-  EXPECT_NE(it, kernel_store.kernels_.end());
-  TbeHandleInfo &info2 = it->second;
-  EXPECT_EQ(info2.handle(), tbe_handle1);
-  EXPECT_EQ(info2.used_num(), 2);
+  auto info2 = GetKernel(tbe_name1);
+  ASSERT_NE(info2, nullptr);
+  EXPECT_EQ(info2->handle(), tbe_handle1);
+  EXPECT_EQ(info2->used_num(), 2);
 
   // store other, size is 2, num is 2, num is 1.
   std::string tbe_name2("tbe_kernel_key2");
   void *tbe_handle2 = (void *)0x22345678;
   kernel_store.StoreTBEHandle(tbe_name2, tbe_handle2, tbe_kernel);
-  EXPECT_EQ(kernel_store.kernels_.size(), 2);
+  EXPECT_EQ(GetKernelNum(), 2);
 
   EXPECT_TRUE(kernel_store.FindTBEHandle(tbe_name2, handle));
   EXPECT_EQ(handle, tbe_handle2);
   EXPECT_TRUE(kernel_store.FindTBEHandle(tbe_name1, handle));
   EXPECT_EQ(handle, tbe_handle1);
 
-  it = kernel_store.kernels_.find(tbe_name1);
-  EXPECT_NE(it, kernel_store.kernels_.end());
-  TbeHandleInfo &info3 = it->second;
-  EXPECT_EQ(info3.handle(), tbe_handle1);
-  EXPECT_EQ(info3.used_num(), 2);
+  auto info3 = GetKernel(tbe_name1);
+  ASSERT_NE(info3, nullptr);
+  EXPECT_EQ(info3->handle(), tbe_handle1);
+  EXPECT_EQ(info3->used_num(), 2);
 
-  it = kernel_store.kernels_.find(tbe_name2);
-  EXPECT_NE(it, kernel_store.kernels_.end());
-  TbeHandleInfo &info4 = it->second;
-  EXPECT_EQ(info4.handle(), tbe_handle2);
-  EXPECT_EQ(info4.used_num(), 1);
+  auto info4 = GetKernel(tbe_name2);
+  ASSERT_NE(info4, nullptr);
+  EXPECT_EQ(info4->handle(), tbe_handle2);
+  EXPECT_EQ(info4->used_num(), 1);
 
   // For Refer
   kernel_store.ReferTBEHandle(tbe_name0);
-  EXPECT_EQ(kernel_store.kernels_.size(), 2);
+  EXPECT_EQ(GetKernelNum(), 2);
 
   kernel_store.ReferTBEHandle(tbe_name1);
-  EXPECT_EQ(kernel_store.kernels_.size(), 2);
+  EXPECT_EQ(GetKernelNum(), 2);
 
   // For Erase.
   std::map<std::string, uint32_t> names0 = {{tbe_name0, 1}};
   kernel_store.EraseTBEHandle(names0);
-  EXPECT_EQ(kernel_store.kernels_.size(), 2);
+  EXPECT_EQ(GetKernelNum(), 2);
 
   std::map<std::string, uint32_t> names1 = {{tbe_name1, 1}};
   kernel_store.EraseTBEHandle(names1);
-  EXPECT_EQ(kernel_store.kernels_.size(), 2);
+  EXPECT_EQ(GetKernelNum(), 2);
 
   std::map<std::string, uint32_t> names2 = {{tbe_name1, 2}, {tbe_name2, 1}};
   kernel_store.EraseTBEHandle(names2);
-  EXPECT_EQ(kernel_store.kernels_.size(), 0);
+  EXPECT_EQ(GetKernelNum(), 0);
+}
+
+TEST_F(UtestTBEHandleStore, test_refer_tbe_handles) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  std::shared_ptr<OpKernelBin> tbe_kernel = std::shared_ptr<OpKernelBin>();
+  std::vector<std::pair<std::string, std::shared_ptr<OpKernelBin>>> kernels = {
+    {"tbe_kernel_key0", tbe_kernel}, {"tbe_kernel_key1", tbe_kernel},
+    {"tbe_kernel_key0", tbe_kernel}, {"tbe_kernel_key2", tbe_kernel}};
+
+  // key0 is registered once and referred twice, key2 is left unregistered.
+  std::vector<size_t> registered;
+  auto prepare = [&registered](size_t index, void *&handle) -> Status {
+    if (handle == nullptr && index != 3) {
+      handle = reinterpret_cast<void *>(0x1000 + index);
+      registered.push_back(index);
+    }
+    return SUCCESS;
+  };
+  EXPECT_EQ(kernel_store.ReferTBEHandles(kernels, prepare), SUCCESS);
+  EXPECT_EQ(registered.size(), 2);
+  EXPECT_EQ(GetKernelNum(), 2);
+  ASSERT_NE(GetKernel("tbe_kernel_key0"), nullptr);
+  EXPECT_EQ(GetKernel("tbe_kernel_key0")->used_num(), 2);
+  EXPECT_EQ(GetKernel("tbe_kernel_key1")->used_num(), 1);
+  EXPECT_EQ(GetKernel("tbe_kernel_key2"), nullptr);
+
+  void *handle = nullptr;
+  EXPECT_TRUE(kernel_store.FindTBEHandle("tbe_kernel_key0", handle));
+  EXPECT_EQ(handle, reinterpret_cast<void *>(0x1000));
+
+  // Failed kernel is not referred.
+  auto fail = [](size_t index, void *&handle) -> Status { return FAILED; };
+  EXPECT_EQ(kernel_store.ReferTBEHandles({{"tbe_kernel_key3", tbe_kernel}}, fail), FAILED);
+  EXPECT_EQ(GetKernel("tbe_kernel_key3"), nullptr);
+
+  std::map<std::string, uint32_t> names = {{"tbe_kernel_key0", 2}, {"tbe_kernel_key1", 1}};
+  kernel_store.EraseTBEHandle(names);
+  EXPECT_EQ(GetKernelNum(), 0);
+  EXPECT_FALSE(kernel_store.FindTBEHandle("tbe_kernel_key0", handle));
+}
+
+TEST_F(UtestTBEHandleStore, test_refer_tbe_handles_in_threads) {
+  const size_t kThreadNum = 8;
+  const size_t kLoadNum = 100;
+  const size_t kKernelNum = 64;
+  std::shared_ptr<OpKernelBin> tbe_kernel = std::shared_ptr<OpKernelBin>();
+  std::vector<std::pair<std::string, std::shared_ptr<OpKernelBin>>> kernels;
+  std::map<std::string, uint32_t> names;
+  for (size_t i = 0; i < kKernelNum; ++i) {
+    kernels.emplace_back("tbe_kernel_key" + std::to_string(i), tbe_kernel);
+    names[kernels.back().first] = 1;
+  }
+
+  // Every thread loads and unloads a model with the same kernels.
+  std::atomic<size_t> register_num(0);
+  std::atomic<bool> failed(false);
+  auto load = [&]() {
+    TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+    for (size_t i = 0; i < kLoadNum; ++i) {
+      auto prepare = [&register_num](size_t index, void *&handle) -> Status {
+        if (handle == nullptr) {
+          handle = reinterpret_cast<void *>(0x1000 + index);
+          register_num++;
+        }
+        return SUCCESS;
+      };
+      if (kernel_store.ReferTBEHandles(kernels, prepare) != SUCCESS) {
+        failed = true;
+      }
+      void *handle = nullptr;
+      if (!kernel_store.FindTBEHandle(kernels[i % kKernelNum].first, handle) ||
+          handle != reinterpret_cast<void *>(0x1000 + i % kKernelNum)) {
+        failed = true;
+      }
+      kernel_store.EraseTBEHandle(names);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back(load);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed);
+  EXPECT_GE(register_num, kKernelNum);
+  EXPECT_EQ(GetKernelNum(), 0);
 }
 
 TEST_F(UtestTBEHandleStore, test_tbe_handle_info) {
@@ -16,14 +16,19 @@
 
 #include "graph/passes/constant_folding_pass.h"
 
+#include <map>
 #include <string>
 #include <vector>
 #include <gtest/gtest.h>
 
 #include "common/types.h"
+#include "external/ge/ge_api_types.h"
 #include "ge/common/ge/ge_util.h"
+#include "graph/ge_local_context.h"
 #include "graph/passes/base_pass.h"
+#include "graph/passes/constant_folding_engine.h"
 #include "graph/passes/dimension_compute_pass.h"
+#include "graph/utils/op_desc_utils.h"
 #include "graph_builder_utils.h"
 #include "inc/kernel.h"
 #include "inc/kernel_factory.h"
@@ -527,6 +532,16 @@ ComputeGraphPtr BuildWrongGraph6() {
   builder.AddDataEdge(op, 0, conv, 0);
   return builder.GetGraph();
 }
+
+void SetConstWeights(const ComputeGraphPtr &graph) {
+  for (const auto &node : graph->GetDirectNode()) {
+    if (node->GetType() == CONSTANT) {
+      std::vector<uint8_t> data{1, 2, 3};
+      auto weight = std::make_shared<GeTensor>(GeTensorDesc(GeShape({3}), FORMAT_ND, DT_UINT8), data);
+      OpDescUtils::SetWeights(node, {weight});
+    }
+  }
+}
 }  // namespace
 
 TEST_F(UtestGraphPassesConstantFoldingPass, folding_addn) {
@@ -774,4 +789,71 @@ TEST_F(UtestGraphPassesConstantFoldingPass, unlikely6) {
     delete name_to_pass.second;
   }
 }
+
+TEST_F(UtestGraphPassesConstantFoldingPass, folding_engine_continues_fold) {
+  auto graph = BuildGraph6();
+  SetConstWeights(graph);
+  ConstantFoldingEngine folding_engine(2);
+  EXPECT_EQ(folding_engine.Run(graph), SUCCESS);
+  EXPECT_EQ(folding_engine.GetEvaluatedNum(), 2);
+
+  NamesToPass names_to_pass;
+  names_to_pass.push_back({"Test", new ConstantFoldingPass(&folding_engine)});
+  GEPass pass(graph);
+  EXPECT_EQ(pass.Run(names_to_pass), SUCCESS);
+  EXPECT_EQ(folding_engine.GetTakenNum(), 2);
+  EXPECT_EQ(graph->GetAllNodes().size(), 3);
+  auto shape1 = graph->FindNode("shape1");
+  EXPECT_NE(shape1, nullptr);
+  EXPECT_EQ(shape1->GetInNodes().size(), 1);
+
+  auto folded_const = shape1->GetInDataNodes().at(0);
+  EXPECT_EQ(folded_const->GetType(), CONSTANT);
+  auto tensor = folded_const->GetOpDesc()->GetOutputDesc(0);
+  EXPECT_EQ(tensor.GetDataType(), DT_UINT8);
+  EXPECT_EQ(tensor.GetShape().GetDims(), std::vector<int64_t>({5}));
+
+  for (auto &name_to_pass : names_to_pass) {
+    delete name_to_pass.second;
+  }
+}
+
+TEST_F(UtestGraphPassesConstantFoldingPass, folding_engine_thread_num_option) {
+  std::map<std::string, std::string> options = {{CONSTANT_FOLDING_THREAD_NUM, "4"}};
+  GetThreadLocalContext().SetGraphOption(options);
+  auto graph = BuildGraph6();
+  SetConstWeights(graph);
+  ConstantFoldingEngine folding_engine;
+  EXPECT_EQ(folding_engine.Run(graph), SUCCESS);
+  EXPECT_EQ(folding_engine.GetEvaluatedNum(), 2);
+
+  options[CONSTANT_FOLDING_THREAD_NUM] = "";
+  GetThreadLocalContext().SetGraphOption(options);
+}
+
+TEST_F(UtestGraphPassesConstantFoldingPass, folding_engine_skip_not_const) {
+  auto graph = BuildGraph1();
+  SetConstWeights(graph);
+  ConstantFoldingEngine folding_engine;
+  EXPECT_EQ(folding_engine.Run(graph), SUCCESS);
+  EXPECT_EQ(folding_engine.GetEvaluatedNum(), 1);
+
+  // the cached outputs must not be taken if inputs differ from the evaluated ones
+  auto addn1 = graph->FindNode("addn1");
+  std::vector<ConstGeTensorPtr> inputs;
+  std::vector<GeTensorPtr> outputs;
+  EXPECT_FALSE(folding_engine.TakeOutputs(addn1, inputs, outputs));
+  EXPECT_FALSE(folding_engine.TakeOutputs(graph->FindNode("shape1"), inputs, outputs));
+  EXPECT_EQ(folding_engine.GetTakenNum(), 0);
+
+  NamesToPass names_to_pass;
+  names_to_pass.push_back({"Test", new ConstantFoldingPass(&folding_engine)});
+  GEPass pass(graph);
+  EXPECT_EQ(pass.Run(names_to_pass), SUCCESS);
+  EXPECT_EQ(graph->GetAllNodes().size(), 3);
+
+  for (auto &name_to_pass : names_to_pass) {
+    delete name_to_pass.second;
+  }
+}
 }  // namespace ge
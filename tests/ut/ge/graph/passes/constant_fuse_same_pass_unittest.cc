@@ -0,0 +1,133 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "graph/passes/constant_fuse_same_pass.h"
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "common/types.h"
+#include "graph/utils/op_desc_utils.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+class UtestGraphPassesConstantFuseSamePass : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+namespace {
+NodePtr AddConst(ut::GraphBuilder &builder, const std::string &name, const std::vector<float> &data) {
+  auto node = builder.AddNode(name, CONSTANT, 0, 1, FORMAT_ND, DT_FLOAT, {static_cast<int64_t>(data.size())});
+  GeTensorDesc weight_desc(GeShape({static_cast<int64_t>(data.size())}), FORMAT_ND, DT_FLOAT);
+  auto weight = std::make_shared<GeTensor>(weight_desc, reinterpret_cast<const uint8_t *>(data.data()),
+                                           data.size() * sizeof(float));
+  OpDescUtils::SetWeights(node, {weight});
+  return node;
+}
+
+// Reference ops are told by an input having the same name as an output.
+NodePtr AddNamedNode(ut::GraphBuilder &builder, const std::string &name, const std::string &type,
+                     const std::vector<std::string> &input_names, const std::string &output_name) {
+  auto op_desc = std::make_shared<OpDesc>(name, type);
+  for (const auto &input_name : input_names) {
+    op_desc->AddInputDesc(input_name, GeTensorDesc());
+  }
+  op_desc->AddOutputDesc(output_name, GeTensorDesc());
+  return builder.GetGraph()->AddNode(op_desc);
+}
+
+///   add1     add2      add3
+///   /  \     /  \     /  \
+/// const1 const2 const3 const4
+/// const1, const2 and const4 are the same, const3 is different
+ComputeGraphPtr BuildGraph1() {
+  auto builder = ut::GraphBuilder("test");
+  auto const1 = AddConst(builder, "const1", {1, 2, 3, 4});
+  auto const2 = AddConst(builder, "const2", {1, 2, 3, 4});
+  auto const3 = AddConst(builder, "const3", {1, 2, 3, 5});
+  auto const4 = AddConst(builder, "const4", {1, 2, 3, 4});
+  auto add1 = AddNamedNode(builder, "add1", ADD, {"x1", "x2"}, "y");
+  auto add2 = AddNamedNode(builder, "add2", ADD, {"x1", "x2"}, "y");
+  auto add3 = AddNamedNode(builder, "add3", ADD, {"x1", "x2"}, "y");
+  builder.AddDataEdge(const1, 0, add1, 0);
+  builder.AddDataEdge(const2, 0, add1, 1);
+  builder.AddDataEdge(const3, 0, add2, 0);
+  builder.AddDataEdge(const4, 0, add2, 1);
+  builder.AddDataEdge(const4, 0, add3, 0);
+  builder.AddDataEdge(const3, 0, add3, 1);
+  return builder.GetGraph();
+}
+
+///   assign    add1
+///   /    \   /   \
+/// const1  const2  const3
+/// const1 is written by assign
+ComputeGraphPtr BuildGraph2() {
+  auto builder = ut::GraphBuilder("test");
+  auto const1 = AddConst(builder, "const1", {1, 2});
+  auto const2 = AddConst(builder, "const2", {1, 2});
+  auto const3 = AddConst(builder, "const3", {1, 2});
+  auto assign = AddNamedNode(builder, "assign", ASSIGN, {"ref", "value"}, "ref");
+  auto add1 = AddNamedNode(builder, "add1", ADD, {"x1", "x2"}, "y");
+  builder.AddDataEdge(const1, 0, assign, 0);
+  builder.AddDataEdge(const2, 0, assign, 1);
+  builder.AddDataEdge(const2, 0, add1, 0);
+  builder.AddDataEdge(const3, 0, add1, 1);
+  return builder.GetGraph();
+}
+}  // namespace
+
+TEST_F(UtestGraphPassesConstantFuseSamePass, fuse_same_weights) {
+  auto graph = BuildGraph1();
+  ConstantFuseSamePass pass;
+  EXPECT_EQ(pass.Run(graph), SUCCESS);
+
+  EXPECT_NE(graph->FindNode("const1"), nullptr);
+  EXPECT_EQ(graph->FindNode("const2"), nullptr);
+  EXPECT_NE(graph->FindNode("const3"), nullptr);
+  EXPECT_EQ(graph->FindNode("const4"), nullptr);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 5);
+
+  auto const1 = graph->FindNode("const1");
+  EXPECT_EQ(const1->GetOutDataAnchor(0)->GetPeerInDataAnchors().size(), 4);
+  auto add1 = graph->FindNode("add1");
+  EXPECT_EQ(add1->GetInDataAnchor(0)->GetPeerOutAnchor()->GetOwnerNode(), const1);
+  EXPECT_EQ(add1->GetInDataAnchor(1)->GetPeerOutAnchor()->GetOwnerNode(), const1);
+  auto add2 = graph->FindNode("add2");
+  EXPECT_EQ(add2->GetInDataAnchor(1)->GetPeerOutAnchor()->GetOwnerNode(), const1);
+  auto add3 = graph->FindNode("add3");
+  EXPECT_EQ(add3->GetInDataAnchor(0)->GetPeerOutAnchor()->GetOwnerNode(), const1);
+  EXPECT_EQ(add3->GetInDataAnchor(1)->GetPeerOutAnchor()->GetOwnerNode()->GetName(), "const3");
+}
+
+TEST_F(UtestGraphPassesConstantFuseSamePass, skip_const_written_by_reference_node) {
+  auto graph = BuildGraph2();
+  ConstantFuseSamePass pass;
+  EXPECT_EQ(pass.Run(graph), SUCCESS);
+
+  EXPECT_NE(graph->FindNode("const1"), nullptr);
+  EXPECT_NE(graph->FindNode("const2"), nullptr);
+  EXPECT_EQ(graph->FindNode("const3"), nullptr);
+  EXPECT_EQ(graph->GetDirectNodesSize(), 4);
+  auto assign = graph->FindNode("assign");
+  EXPECT_EQ(assign->GetInDataAnchor(0)->GetPeerOutAnchor()->GetOwnerNode()->GetName(), "const1");
+}
+}  // namespace ge
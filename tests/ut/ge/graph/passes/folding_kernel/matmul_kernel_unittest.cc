@@ -0,0 +1,124 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#define protected public
+#define private public
+#include "graph/passes/folding_kernel/matmul_kernel.h"
+
+#include "common/debug/log.h"
+#include "common/types.h"
+#include "graph/types.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "inc/kernel_factory.h"
+#undef protected
+#undef private
+
+using namespace testing;
+using namespace ge;
+
+class UtestGraphPassesFoldingKernelMatMulKernel : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+namespace {
+template <typename T>
+ConstGeTensorPtr BuildTensor(const vector<int64_t> &dims, const vector<T> &data, DataType data_type) {
+  GeTensorDesc tensor_desc(GeShape(dims), FORMAT_ND, data_type);
+  return std::make_shared<GeTensor>(tensor_desc, (uint8_t *)data.data(), data.size() * sizeof(T));
+}
+}  // namespace
+
+TEST_F(UtestGraphPassesFoldingKernelMatMulKernel, FloatSuccess) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("MatMul", MATMUL);
+  // [[1, 2, 3], [4, 5, 6]] x [[1, 0], [0, 1], [1, 1]]
+  vector<ConstGeTensorPtr> input = {BuildTensor<float>({2, 3}, {1, 2, 3, 4, 5, 6}, DT_FLOAT),
+                                    BuildTensor<float>({3, 2}, {1, 0, 0, 1, 1, 1}, DT_FLOAT)};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(MATMUL);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(outputs[0]->GetTensorDesc().GetShape().GetDims(), vector<int64_t>({2, 2}));
+  float *out_data = (float *)outputs[0]->GetData().data();
+  EXPECT_FLOAT_EQ(out_data[0], 4);
+  EXPECT_FLOAT_EQ(out_data[1], 5);
+  EXPECT_FLOAT_EQ(out_data[2], 10);
+  EXPECT_FLOAT_EQ(out_data[3], 11);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelMatMulKernel, TransposeWithBias) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("MatMul", MATMUL);
+  AttrUtils::SetBool(op_desc_ptr, "transpose_a", true);
+  AttrUtils::SetBool(op_desc_ptr, "transpose_b", true);
+  // transpose([[1, 4], [2, 5], [3, 6]]) x transpose([[1, 0, 1], [0, 1, 1]]) + [10, 20]
+  vector<ConstGeTensorPtr> input = {BuildTensor<float>({3, 2}, {1, 4, 2, 5, 3, 6}, DT_FLOAT),
+                                    BuildTensor<float>({2, 3}, {1, 0, 1, 0, 1, 1}, DT_FLOAT),
+                                    BuildTensor<float>({2}, {10, 20}, DT_FLOAT)};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(MATMUL);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(outputs[0]->GetTensorDesc().GetShape().GetDims(), vector<int64_t>({2, 2}));
+  float *out_data = (float *)outputs[0]->GetData().data();
+  EXPECT_FLOAT_EQ(out_data[0], 14);
+  EXPECT_FLOAT_EQ(out_data[1], 25);
+  EXPECT_FLOAT_EQ(out_data[2], 20);
+  EXPECT_FLOAT_EQ(out_data[3], 31);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelMatMulKernel, Int32Success) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("MatMul", MATMUL);
+  vector<ConstGeTensorPtr> input = {BuildTensor<int32_t>({1, 2}, {2, -3}, DT_INT32),
+                                    BuildTensor<int32_t>({2, 1}, {4, 5}, DT_INT32)};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(MATMUL);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(*(int32_t *)outputs[0]->GetData().data(), -7);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelMatMulKernel, ShapeMismatchNotChanged) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("MatMul", MATMUL);
+  vector<ConstGeTensorPtr> input = {BuildTensor<float>({2, 3}, {1, 2, 3, 4, 5, 6}, DT_FLOAT),
+                                    BuildTensor<float>({2, 3}, {1, 2, 3, 4, 5, 6}, DT_FLOAT)};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(MATMUL);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+  EXPECT_EQ(NOT_CHANGED, status);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelMatMulKernel, MixedTypeNotChanged) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("MatMul", MATMUL);
+  vector<ConstGeTensorPtr> input = {BuildTensor<float>({1, 1}, {1}, DT_FLOAT),
+                                    BuildTensor<int32_t>({1, 1}, {1}, DT_INT32)};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(MATMUL);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+  EXPECT_EQ(NOT_CHANGED, status);
+}
@@ -0,0 +1,149 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#define protected public
+#define private public
+#include "graph/passes/folding_kernel/reduce_sum_kernel.h"
+
+#include "common/debug/log.h"
+#include "common/types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/passes/folding_kernel/reduce_mean_kernel.h"
+#include "graph/types.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/tensor_utils.h"
+#include "inc/kernel_factory.h"
+#undef protected
+#undef private
+
+using namespace testing;
+using namespace ge;
+
+class UtestGraphPassesFoldingKernelReduceSumKernel : public testing::Test {
+ protected:
+  void SetUp() {}
+
+  void TearDown() {}
+};
+
+namespace {
+///  [[1, 2, 3],
+///   [4, 5, 6]]
+ConstGeTensorPtr BuildFloatData() {
+  vector<int64_t> dims_vec = {2, 3};
+  vector<float> data_vec = {1, 2, 3, 4, 5, 6};
+  GeTensorDesc tensor_desc(GeShape(dims_vec), FORMAT_NCHW, DT_FLOAT);
+  return std::make_shared<GeTensor>(tensor_desc, (uint8_t *)data_vec.data(), data_vec.size() * sizeof(float));
+}
+
+ConstGeTensorPtr BuildAxis(const vector<int32_t> &axes) {
+  vector<int64_t> dims_vec = {static_cast<int64_t>(axes.size())};
+  GeTensorDesc tensor_desc(GeShape(dims_vec), FORMAT_NCHW, DT_INT32);
+  return std::make_shared<GeTensor>(tensor_desc, (uint8_t *)axes.data(), axes.size() * sizeof(int32_t));
+}
+}  // namespace
+
+TEST_F(UtestGraphPassesFoldingKernelReduceSumKernel, FloatSuccess) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("ReduceSum", REDUCESUM);
+  vector<ConstGeTensorPtr> input = {BuildFloatData(), BuildAxis({0})};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(REDUCESUM);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(outputs[0]->GetTensorDesc().GetShape().GetDims(), vector<int64_t>({3}));
+  float *out_data = (float *)outputs[0]->GetData().data();
+  EXPECT_FLOAT_EQ(out_data[0], 5);
+  EXPECT_FLOAT_EQ(out_data[1], 7);
+  EXPECT_FLOAT_EQ(out_data[2], 9);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelReduceSumKernel, NegativeAxisKeepDims) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("ReduceSum", REDUCESUM);
+  AttrUtils::SetBool(op_desc_ptr, SUM_ATTR_KEEP_DIMS, true);
+  vector<ConstGeTensorPtr> input = {BuildFloatData(), BuildAxis({-1})};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(REDUCESUM);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(outputs[0]->GetTensorDesc().GetShape().GetDims(), vector<int64_t>({2, 1}));
+  float *out_data = (float *)outputs[0]->GetData().data();
+  EXPECT_FLOAT_EQ(out_data[0], 6);
+  EXPECT_FLOAT_EQ(out_data[1], 15);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelReduceSumKernel, Int32AllAxes) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("ReduceSum", REDUCESUM);
+  vector<int64_t> dims_vec = {2, 2};
+  vector<int32_t> data_vec = {1, -2, 3, 4};
+  GeTensorDesc tensor_desc(GeShape(dims_vec), FORMAT_NCHW, DT_INT32);
+  ConstGeTensorPtr tensor =
+      std::make_shared<GeTensor>(tensor_desc, (uint8_t *)data_vec.data(), data_vec.size() * sizeof(int32_t));
+  vector<ConstGeTensorPtr> input = {tensor, BuildAxis({0, 1})};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(REDUCESUM);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(outputs[0]->GetData().size(), sizeof(int32_t));
+  EXPECT_EQ(*(int32_t *)outputs[0]->GetData().data(), 6);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelReduceSumKernel, MeanSuccess) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("ReduceMean", REDUCEMEAN);
+  vector<ConstGeTensorPtr> input = {BuildFloatData(), BuildAxis({1})};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(REDUCEMEAN);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+
+  EXPECT_EQ(SUCCESS, status);
+  EXPECT_EQ(outputs[0]->GetTensorDesc().GetShape().GetDims(), vector<int64_t>({2}));
+  float *out_data = (float *)outputs[0]->GetData().data();
+  EXPECT_FLOAT_EQ(out_data[0], 2);
+  EXPECT_FLOAT_EQ(out_data[1], 5);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelReduceSumKernel, AxisOutOfRangeNotChanged) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("ReduceSum", REDUCESUM);
+  vector<ConstGeTensorPtr> input = {BuildFloatData(), BuildAxis({2})};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(REDUCESUM);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+  EXPECT_EQ(NOT_CHANGED, status);
+}
+
+TEST_F(UtestGraphPassesFoldingKernelReduceSumKernel, DoubleNotChanged) {
+  OpDescPtr op_desc_ptr = std::make_shared<OpDesc>("ReduceSum", REDUCESUM);
+  vector<int64_t> dims_vec = {2};
+  vector<double> data_vec = {1, 2};
+  GeTensorDesc tensor_desc(GeShape(dims_vec), FORMAT_NCHW, DT_DOUBLE);
+  ConstGeTensorPtr tensor =
+      std::make_shared<GeTensor>(tensor_desc, (uint8_t *)data_vec.data(), data_vec.size() * sizeof(double));
+  vector<ConstGeTensorPtr> input = {tensor, BuildAxis({0})};
+  vector<GeTensorPtr> outputs;
+
+  shared_ptr<Kernel> kernel = KernelFactory::Instance().Create(REDUCESUM);
+  Status status = kernel->Compute(op_desc_ptr, input, outputs);
+  EXPECT_EQ(NOT_CHANGED, status);
+}
@@ -175,3 +175,23 @@ TEST_F(UtestGraphPassesPassUtils, null_input) {
   std::vector<NodePtr> end_nodes;
   EXPECT_NE(PassUtils::RemoveInactiveBranchToMerge(nullptr, deleted_nodes, end_nodes), 0);
 }
+
+TEST_F(UtestGraphPassesPassUtils, filter_nodes_keep_order) {
+  ge::ComputeGraphPtr graph = std::make_shared<ComputeGraph>("test");
+  std::vector<NodePtr> nodes;
+  for (int i = 0; i < 2000; ++i) {
+    nodes.push_back(NodeBuilder("node" + std::to_string(i), (i % 3 == 0) ? CAST : RELU)
+                        .AddInputDesc({2, 2, 2, 2}, FORMAT_NCHW, DT_FLOAT)
+                        .AddOutputDesc({2, 2, 2, 2}, FORMAT_NCHW, DT_FLOAT)
+                        .Build(graph));
+  }
+  auto is_cast = [](const NodePtr &node) { return node->GetType() == CAST; };
+
+  std::vector<NodePtr> serial_nodes = nodes;
+  EXPECT_EQ(PassUtils::FilterNodes(1, is_cast, serial_nodes), SUCCESS);
+  std::vector<NodePtr> parallel_nodes = nodes;
+  EXPECT_EQ(PassUtils::FilterNodes(4, is_cast, parallel_nodes), SUCCESS);
+  ASSERT_EQ(serial_nodes.size(), 667);
+  EXPECT_EQ(serial_nodes, parallel_nodes);
+  EXPECT_EQ(parallel_nodes[1]->GetName(), "node3");
+}
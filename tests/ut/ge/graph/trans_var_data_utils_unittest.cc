@@ -0,0 +1,134 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "common/types.h"
+
+#include "graph/manager/host_mem_pool.h"
+#include "graph/manager/trans_var_data_utils.h"
+
+namespace ge {
+class UtestTransVarDataUtils : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+const uint64_t kVarAlignSize = 512;
+
+// Road casting float to float16 of elem_num elements
+VarTransRoad BuildCastRoad(int64_t elem_num) {
+  TransNodeInfo trans_info;
+  trans_info.node_type = CAST;
+  trans_info.input = GeTensorDesc(GeShape({elem_num}), FORMAT_ND, DT_FLOAT);
+  trans_info.output = GeTensorDesc(GeShape({elem_num}), FORMAT_ND, DT_FLOAT16);
+  return {trans_info};
+}
+
+// Size taken by a variable in var memory, the same as MemResource::AssignVarMem
+uint64_t GetVarMemSize(uint64_t size) {
+  return (size + kVarAlignSize - 1) / kVarAlignSize * kVarAlignSize + kVarAlignSize * 2;
+}
+
+// Lay variables out like var memory, each is rounded up and followed by padding
+class VarMemory {
+ public:
+  explicit VarMemory(uint64_t size) : mem_(size, 0) {}
+
+  uint8_t *Assign(uint64_t size) {
+    uint8_t *addr = mem_.data() + offset_;
+    offset_ += GetVarMemSize(size);
+    return addr;
+  }
+
+ private:
+  std::vector<uint8_t> mem_;
+  uint64_t offset_ = 0;
+};
+
+void BuildTasks(const std::vector<int64_t> &elem_nums, VarMemory &src_mem, VarMemory &dst_mem,
+                std::vector<VarTransRoad> &roads, std::vector<VarTransTask> &tasks) {
+  roads.clear();
+  tasks.clear();
+  for (auto elem_num : elem_nums) {
+    roads.push_back(BuildCastRoad(elem_num));
+  }
+  for (size_t i = 0; i < elem_nums.size(); ++i) {
+    VarTransTask task;
+    task.var_name = "var_" + std::to_string(i);
+    task.trans_road = &roads[i];
+    task.src_size = elem_nums[i] * sizeof(float);
+    task.src_addr = src_mem.Assign(task.src_size);
+    task.dst_size = elem_nums[i] * sizeof(uint16_t);
+    task.dst_addr = dst_mem.Assign(task.dst_size);
+    tasks.push_back(task);
+  }
+}
+}  // namespace
+
+TEST_F(UtestTransVarDataUtils, trans_var_data_batch) {
+  VarMemory src_mem(1024 * 1024);
+  VarMemory dst_mem(1024 * 1024);
+  std::vector<VarTransRoad> roads;
+  std::vector<VarTransTask> tasks;
+  // Sizes 400, 4000, 40000, 400 and 4000 bytes
+  BuildTasks({100, 1000, 10000, 100, 1000}, src_mem, dst_mem, roads, tasks);
+
+  // Padding between variables is copied together, so they are copied in one range each direction
+  HostMemPoolStats pool_stats;
+  HostMemPool::Instance().GetStats(pool_stats);
+  uint64_t idle_bytes = pool_stats.idle_bytes;
+  VarTransStats stats;
+  EXPECT_EQ(TransVarDataUtils::TransVarDataBatch(tasks, 4, stats), SUCCESS);
+  EXPECT_EQ(stats.batch_num, 1);
+  EXPECT_EQ(stats.copy_num, 2);
+  // Staging buffers are not kept by the pool
+  HostMemPool::Instance().GetStats(pool_stats);
+  EXPECT_EQ(pool_stats.idle_bytes, idle_bytes);
+  EXPECT_EQ(pool_stats.in_use_bytes, 0);
+
+  // The large one is in a batch alone
+  stats = VarTransStats();
+  EXPECT_EQ(TransVarDataUtils::TransVarDataBatch(tasks, 4, stats, 8192), SUCCESS);
+  EXPECT_EQ(stats.batch_num, 3);
+  EXPECT_EQ(stats.copy_num, 6);
+
+  // Gaps of other variables are not copied
+  stats = VarTransStats();
+  EXPECT_EQ(TransVarDataUtils::TransVarDataBatch({tasks[0], tasks[2], tasks[4]}, 4, stats), SUCCESS);
+  EXPECT_EQ(stats.batch_num, 1);
+  EXPECT_EQ(stats.copy_num, 6);
+}
+
+TEST_F(UtestTransVarDataUtils, trans_var_data_batch_overlapped) {
+  VarMemory src_mem(1024 * 1024);
+  VarMemory dst_mem(1024 * 1024);
+  std::vector<VarTransRoad> roads;
+  std::vector<VarTransTask> tasks;
+  BuildTasks({100, 1000, 10000, 100, 1000}, src_mem, dst_mem, roads, tasks);
+
+  // Dst is written before src of next batches is read
+  VarTransStats stats;
+  tasks[0].dst_addr = tasks[4].src_addr;
+  EXPECT_EQ(TransVarDataUtils::TransVarDataBatch(tasks, 4, stats), PARAM_INVALID);
+  tasks[0].dst_addr = tasks[0].src_addr;
+  EXPECT_EQ(TransVarDataUtils::TransVarDataBatch(tasks, 4, stats), SUCCESS);
+  tasks[0].trans_road = nullptr;
+  EXPECT_EQ(TransVarDataUtils::TransVarDataBatch(tasks, 4, stats), PARAM_INVALID);
+}
+}  // namespace ge
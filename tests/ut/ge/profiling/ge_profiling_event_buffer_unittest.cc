@@ -0,0 +1,186 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/profiling/profiling_event_buffer.h"
+
+using namespace ge;
+using namespace std;
+
+class UtestGeProfilingEventBuffer : public testing::Test {
+ protected:
+  void SetUp() override {}
+
+  void TearDown() override {}
+};
+
+namespace {
+vector<ProfEventRecord> BuildRecords(ProfilingEventBuffer &buffer, const map<uint32_t, string> &op_task_id_map) {
+  vector<ProfEventRecord> records;
+  for (const auto &op_task : op_task_id_map) {
+    ProfEventRecord record;
+    record.model_name_id = buffer.InternName("model");
+    record.op_name_id = buffer.InternName(op_task.second);
+    record.task_id = op_task.first;
+    records.push_back(record);
+  }
+  return records;
+}
+}  // namespace
+
+TEST_F(UtestGeProfilingEventBuffer, export_as_text) {
+  ProfilingEventBuffer buffer;
+  map<uint32_t, string> op_task_id_map = {{0, "conv"}, {1, "mul"}, {5, "conv"}};
+  vector<ProfEventRecord> records = BuildRecords(buffer, op_task_id_map);
+  EXPECT_EQ(buffer.InternName("conv"), records[2].op_name_id);
+
+  // Records are kept until the sink is set
+  buffer.Record(records.data(), records.size());
+  string text;
+  uint64_t chunk_num = 0;
+  auto sink = [&text, &chunk_num](const string &data) -> int {
+    text += data;
+    chunk_num++;
+    return 0;
+  };
+  EXPECT_EQ(buffer.Start(sink, 1000), SUCCESS);
+  buffer.Record(records.data(), records.size());
+  EXPECT_EQ(buffer.Flush(), SUCCESS);
+  // The same text as reported for each op before
+  EXPECT_EQ(text, "conv 0;mul 1;conv 5;conv 0;mul 1;conv 5;");
+  EXPECT_EQ(chunk_num, 1);
+
+  buffer.Record(records.data(), records.size());
+  buffer.Stop();
+  EXPECT_EQ(text, "conv 0;mul 1;conv 5;conv 0;mul 1;conv 5;conv 0;mul 1;conv 5;");
+
+  ProfEventStats stats;
+  buffer.GetStats(stats);
+  EXPECT_EQ(stats.recorded_num, 9);
+  EXPECT_EQ(stats.exported_num, 9);
+  EXPECT_EQ(stats.exported_bytes, text.size());
+  EXPECT_EQ(stats.dropped_num, 0);
+}
+
+TEST_F(UtestGeProfilingEventBuffer, export_failed) {
+  ProfilingEventBuffer buffer;
+  vector<ProfEventRecord> records = BuildRecords(buffer, {{0, "conv"}, {1, "relu"}});
+  bool is_failed = true;
+  string text;
+  EXPECT_EQ(buffer.Start(
+              [&is_failed, &text](const string &data) -> int {
+                if (is_failed) {
+                  return -1;
+                }
+                text += data;
+                return 0;
+              },
+              1000),
+            SUCCESS);
+  buffer.Record(records.data(), records.size());
+  EXPECT_EQ(buffer.Flush(), FAILED);
+
+  // Names of records exported later are still resolved after a failed export
+  is_failed = false;
+  buffer.Record(records.data(), records.size());
+  EXPECT_EQ(buffer.Flush(), SUCCESS);
+  buffer.Stop();
+  EXPECT_EQ(text, "conv 0;relu 1;");
+
+  ProfEventStats stats;
+  buffer.GetStats(stats);
+  EXPECT_EQ(stats.recorded_num, 4);
+  EXPECT_EQ(stats.exported_num, 2);
+  EXPECT_EQ(stats.export_failed_num, 1);
+}
+
+TEST_F(UtestGeProfilingEventBuffer, sample_and_drop) {
+  ProfilingEventBuffer buffer(8);
+  vector<ProfEventRecord> records = BuildRecords(buffer, {{0, "conv"}, {1, "relu"}, {2, "add"}});
+
+  // Iterations 0, 3 and 6 are recorded, the last one is dropped as the ring is full
+  buffer.SetSampleInterval(3);
+  for (int i = 0; i < 9; ++i) {
+    buffer.Record(records.data(), records.size());
+  }
+  ProfEventStats stats;
+  buffer.GetStats(stats);
+  EXPECT_EQ(stats.sampled_out_num, 6);
+  EXPECT_EQ(stats.recorded_num, 6);
+  EXPECT_EQ(stats.dropped_num, 3);
+
+  ProfEventRing ring(5);
+  EXPECT_EQ(ring.Capacity(), 8);
+  EXPECT_EQ(ring.Push(records.data(), records.size(), 7, 100), true);
+  vector<ProfEventRecord> out;
+  EXPECT_EQ(ring.Pop(out), 3);
+  EXPECT_EQ(out[2].task_id, 2);
+  EXPECT_EQ(out[2].iteration, 7);
+  EXPECT_EQ(out[2].timestamp, 100);
+  EXPECT_EQ(ring.Size(), 0);
+}
+
+TEST_F(UtestGeProfilingEventBuffer, record_from_threads) {
+  const int kThreadNum = 4;
+  const int kIterNum = 2000;
+  ProfilingEventBuffer buffer(1024);
+  map<uint32_t, string> op_task_id_map;
+  for (uint32_t i = 0; i < 10; ++i) {
+    op_task_id_map[i] = "op_" + to_string(i);
+  }
+  vector<ProfEventRecord> records = BuildRecords(buffer, op_task_id_map);
+
+  uint64_t chunk_num = 0;
+  string text;
+  EXPECT_EQ(buffer.Start(
+              [&](const string &data) -> int {
+                chunk_num++;
+                text += data;
+                return 0;
+              },
+              1),
+            SUCCESS);
+  vector<thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&buffer, &records]() {
+      for (int j = 0; j < kIterNum; ++j) {
+        buffer.Record(records.data(), records.size());
+        if (j % 100 == 0) {
+          this_thread::sleep_for(chrono::milliseconds(1));
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  buffer.Stop();
+
+  ProfEventStats stats;
+  buffer.GetStats(stats);
+  EXPECT_EQ(stats.recorded_num + stats.dropped_num, kThreadNum * kIterNum * records.size());
+  EXPECT_EQ(stats.exported_num, stats.recorded_num);
+  EXPECT_EQ(static_cast<uint64_t>(count(text.begin(), text.end(), ';')), stats.exported_num);
+  EXPECT_LT(chunk_num, stats.exported_num / records.size());
+}
@@ -15,9 +15,13 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <vector>
 
 #include "cce/taskdown_common.hpp"
+#include "common/single_op_archive.h"
 #include "runtime/rt.h"
 
 #define protected public
@@ -92,4 +96,38 @@ TEST_F(UtestSingleOpManager, get_resource_failed) {
   auto &instance = SingleOpManager::GetInstance();
 
   ASSERT_EQ(instance.GetOpFromModel("model", model_data, stream, &single_op), FAILED);
-}
\ No newline at end of file
+}
+
+TEST_F(UtestSingleOpManager, load_and_unload_archive) {
+  const char *file_path = "./ut_single_op_manager_archive.bin";
+  SingleOpArchive archive;
+  ASSERT_EQ(archive.AddKey("add_0", archive.AddModel(vector<uint8_t>(16, 1))), SUCCESS);
+  ASSERT_EQ(archive.Save(file_path), SUCCESS);
+  ifstream ifs(file_path, ios::binary);
+  vector<uint8_t> data((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+  (void)remove(file_path);
+
+  ModelData archive_data;
+  archive_data.model_data = data.data();
+  archive_data.model_len = data.size();
+  auto &instance = SingleOpManager::GetInstance();
+  uint64_t first_id = 0;
+  uint64_t second_id = 0;
+  ASSERT_EQ(instance.LoadArchive(archive_data, first_id), SUCCESS);
+  ASSERT_EQ(instance.LoadArchive(archive_data, second_id), SUCCESS);
+  // the same data loaded twice gets two archives
+  EXPECT_NE(first_id, second_id);
+
+  auto stream = (rtStream_t)0x1;
+  SingleOp *single_op = nullptr;
+  EXPECT_EQ(instance.GetOpFromArchive("sub_0", first_id, stream, &single_op), PARAM_INVALID);
+  EXPECT_EQ(instance.UnloadArchive(first_id), SUCCESS);
+  EXPECT_EQ(instance.UnloadArchive(first_id), PARAM_INVALID);
+  EXPECT_EQ(instance.GetOpFromArchive("add_0", first_id, stream, &single_op), PARAM_INVALID);
+  EXPECT_EQ(instance.archives_.count(second_id), 1);
+  EXPECT_EQ(instance.UnloadArchive(second_id), SUCCESS);
+  EXPECT_TRUE(instance.archives_.empty());
+
+  ModelData null_data;
+  EXPECT_EQ(instance.LoadArchive(null_data, first_id), PARAM_INVALID);
+}